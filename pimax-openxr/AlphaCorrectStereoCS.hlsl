@@ -0,0 +1,43 @@
+// MIT License
+//
+// Copyright(c) 2022-2023 Matthieu Bucchianeri
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this softwareand associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright noticeand this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+// Compute shader for correcting alpha channel, for both slices of a stereo texture array at once.
+
+#include "AlphaCorrect.hlsli"
+
+Texture2DArray in_texture_array : register(t0);
+RWTexture2D<float4> out_texture_slice1 : register(u1);
+
+[numthreads(8, 8, 1)]
+void main(uint3 pos : SV_DispatchThreadID)
+{
+    uint2 pixel;
+    if (!getPixelInRegion(pos, pixel)) {
+        return;
+    }
+    const float4 color = processAlpha(in_texture_array[uint3(pixel, pos.z)]);
+    if (pos.z == 0) {
+        out_texture[pixel] = color;
+    } else {
+        out_texture_slice1[pixel] = color;
+    }
+}
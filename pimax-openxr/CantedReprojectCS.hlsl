@@ -0,0 +1,52 @@
+// MIT License
+//
+// Copyright(c) 2022-2023 Matthieu Bucchianeri
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this softwareand associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright noticeand this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+// Compute shader for reprojecting a parallel projection view onto the canted view of the panel.
+
+#include "AlphaCorrect.hlsli"
+
+Texture2DArray in_texture : register(t0);
+SamplerState in_sampler : register(s0);
+
+cbuffer canted : register(b1) {
+    float2 cantedScale; // Pixel in the region to tangent in the canted view.
+    float2 cantedBias;
+    float2 parallelScale; // Tangent in the parallel view to UV in the texture.
+    float2 parallelBias;
+    float sinAngle; // Rotation from the canted view to the parallel view.
+    float cosAngle;
+};
+
+[numthreads(8, 8, 1)]
+void main(uint2 pos : SV_DispatchThreadID)
+{
+    uint2 pixel;
+    if (!getPixelInRegion(pos, pixel)) {
+        return;
+    }
+
+    // Same homography as the visibility mask reprojection, for each pixel of the canted view.
+    const float2 v = (float2(pos) + 0.5) * cantedScale + cantedBias;
+    const float w = v.x * sinAngle + cosAngle;
+    const float2 p = float2(v.x * cosAngle - sinAngle, v.y) / w;
+    const float2 uv = p * parallelScale + parallelBias;
+    out_texture[pixel] = processAlpha(in_texture.SampleLevel(in_sampler, float3(uv, 0), 0));
+}
@@ -0,0 +1,46 @@
+// MIT License
+//
+// Copyright(c) 2022-2023 Matthieu Bucchianeri
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this softwareand associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright noticeand this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+// Compute shader for converting multisampled D32_S8 or D32 to D32 depth formats, for both slices of a stereo texture
+// array at once.
+// Only keep the depth component of the first sample.
+
+#include "Region.hlsli"
+
+Texture2DMSArray<float2> in_texture_array : register(t0);
+RWTexture2D<float> out_texture : register(u0);
+RWTexture2D<float> out_texture_slice1 : register(u1);
+
+[numthreads(8, 8, 1)]
+void main(uint3 pos : SV_DispatchThreadID)
+{
+    uint2 pixel;
+    if (!getPixelInRegion(pos, pixel)) {
+        return;
+    }
+    const float depth = in_texture_array.Load(uint3(pixel, pos.z), 0).x;
+    if (pos.z == 0) {
+        out_texture[pixel] = depth;
+    } else {
+        out_texture_slice1[pixel] = depth;
+    }
+}
@@ -0,0 +1,79 @@
+// MIT License
+//
+// Copyright(c) 2022-2023 Matthieu Bucchianeri
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this softwareand associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright noticeand this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+// Compute shader for compositing coplanar quad layers into a single quad.
+
+#include "Region.hlsli"
+
+#define MAX_QUADS 8
+
+Texture2DArray in_textures[MAX_QUADS] : register(t0);
+SamplerState quad_sampler : register(s0);
+RWTexture2D<float4> out_texture : register(u0);
+
+struct Quad {
+    float2 scale; // UV in the flattened quad to UV in the quad.
+    float2 bias;
+    float2 texScale; // UV in the quad to UV in its texture.
+    float2 texBias;
+    uint quadMode; // bit 0 = clear alpha, bit 1 = premultiply alpha.
+};
+
+cbuffer quads : register(b1) {
+    Quad quads[MAX_QUADS];
+    uint quadCount;
+};
+
+[numthreads(8, 8, 1)]
+void main(uint2 pos : SV_DispatchThreadID)
+{
+    uint2 pixel;
+    if (!getPixelInRegion(pos, pixel)) {
+        return;
+    }
+
+    // Blend the quads back to front, like the compositor would, and output premultiplied alpha.
+    const float2 uv = (float2(pos) + 0.5) / float2(extent);
+    float4 color = 0;
+    [unroll]
+    for (uint i = 0; i < MAX_QUADS; i++) {
+        if (i >= quadCount) {
+            break;
+        }
+
+        const float2 quadUv = uv * quads[i].scale + quads[i].bias;
+        if (any(quadUv < 0) || any(quadUv > 1)) {
+            continue;
+        }
+
+        const float2 texUv = quadUv * quads[i].texScale + quads[i].texBias;
+        float4 input = in_textures[i].SampleLevel(quad_sampler, float3(texUv, 0), 0);
+        if (quads[i].quadMode & 1) {
+            input.a = 1;
+        }
+        if (quads[i].quadMode & 2) {
+            input.rgb = input.rgb * input.a;
+        }
+        color = input + (1 - input.a) * color;
+    }
+    out_texture[pixel] = color;
+}
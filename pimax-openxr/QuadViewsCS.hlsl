@@ -0,0 +1,56 @@
+// MIT License
+//
+// Copyright(c) 2022-2023 Matthieu Bucchianeri
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this softwareand associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright noticeand this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+// Compute shader for compositing a focus view into its context view.
+
+#include "AlphaCorrect.hlsli"
+
+Texture2DArray in_texture : register(t0);
+Texture2DArray in_focus_texture : register(t1);
+SamplerState focus_sampler : register(s0);
+
+cbuffer focus : register(b1) {
+    float2 focusScale; // Pixel in the region to UV in the focus view.
+    float2 focusBias;
+    float2 focusTexScale; // UV in the focus view to UV in the focus texture.
+    float2 focusTexBias;
+    float blendWidth; // Width of the blend at the edges of the focus view, in UV.
+};
+
+[numthreads(8, 8, 1)]
+void main(uint2 pos : SV_DispatchThreadID)
+{
+    uint2 pixel;
+    if (!getPixelInRegion(pos, pixel)) {
+        return;
+    }
+
+    float4 color = in_texture[uint3(pixel, 0)];
+    const float2 uv = (float2(pos) + 0.5) * focusScale + focusBias;
+    const float2 edge = min(uv, 1 - uv);
+    const float weight = saturate(min(edge.x, edge.y) / blendWidth);
+    if (weight > 0) {
+        const float4 focus = in_focus_texture.SampleLevel(focus_sampler, float3(uv * focusTexScale + focusTexBias, 0), 0);
+        color = lerp(color, focus, weight);
+    }
+    out_texture[pixel] = processAlpha(color);
+}
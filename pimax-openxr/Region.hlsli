@@ -0,0 +1,48 @@
+// MIT License
+//
+// Copyright(c) 2022-2023 Matthieu Bucchianeri
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this softwareand associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright noticeand this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+// Common code for processing only the region of the image submitted by the application.
+
+cbuffer config : register(b0) {
+    int2 offset;
+    int2 extent;
+    int mode; // Only used for alpha correction.
+    uint tileMask; // 0 when disabled, otherwise 1 + the slice of tile_mask for the first slice processed.
+};
+
+// One texel per 8x8 tile of the region, 0 when the tile is entirely hidden by the lenses.
+Texture2DArray<uint> tile_mask : register(t8);
+
+// Returns false if the thread is outside of the region to process, or within a hidden tile.
+bool getPixelInRegion(uint3 pos, out uint2 pixel)
+{
+    pixel = pos.xy + uint2(offset);
+    if (tileMask && !tile_mask[uint3(pos.xy / 8, tileMask - 1 + pos.z)]) {
+        return false;
+    }
+    return all(pos.xy < uint2(extent));
+}
+
+bool getPixelInRegion(uint2 pos, out uint2 pixel)
+{
+    return getPixelInRegion(uint3(pos, 0), pixel);
+}
@@ -43,6 +43,17 @@ namespace pimax_openxr {
             }
             return true;
         }
+        // Translate a pointer into the live input state to the same field of an input snapshot.
+        template <typename T>
+        const T* relocateToSnapshot(const T* pointer, const pvrInputState& live, const pvrInputState& snapshot) {
+            if (!pointer) {
+                return nullptr;
+            }
+            return reinterpret_cast<const T*>(reinterpret_cast<const uint8_t*>(&snapshot) +
+                                              (reinterpret_cast<const uint8_t*>(pointer) -
+                                               reinterpret_cast<const uint8_t*>(&live)));
+        }
+
         bool validatePath(std::string path) {
             if (path.size() < 2 || path[0] != '/' || path[path.size() - 1] == '/') {
                 return false;
@@ -82,22 +93,13 @@ namespace pimax_openxr {
 
         std::string_view str(pathString);
 
-        bool found = false;
-        for (auto entry : m_strings) {
-            if (entry.second == str) {
-                *path = entry.first;
-                found = true;
-                break;
-            }
-        }
-
-        if (!found) {
+        *path = m_strings.find(str);
+        if (*path == XR_NULL_PATH) {
             if (str.length() >= XR_MAX_PATH_LENGTH || !validatePath(pathString)) {
                 return XR_ERROR_PATH_FORMAT_INVALID;
             }
 
-            *path = (XrPath)++m_stringIndex;
-            m_strings.insert_or_assign(*path, str);
+            *path = m_strings.insert(str);
         }
 
         TraceLoggingWrite(g_traceProvider, "xrStringToPath", TLArg(*path, "Path"));
@@ -118,12 +120,12 @@ namespace pimax_openxr {
             return XR_ERROR_HANDLE_INVALID;
         }
 
-        const auto it = m_strings.find(path);
-        if (it == m_strings.cend()) {
+        const auto entry = m_strings.get(path);
+        if (!entry) {
             return XR_ERROR_PATH_INVALID;
         }
 
-        const auto& str = it->second;
+        const auto& str = *entry;
         if (bufferCapacityInput && bufferCapacityInput < str.length()) {
             return XR_ERROR_SIZE_INSUFFICIENT;
         }
@@ -173,7 +175,7 @@ namespace pimax_openxr {
         }
 
         for (const auto& entry : m_actionSets) {
-            const ActionSet& xrActionSet = *(ActionSet*)entry;
+            const ActionSet& xrActionSet = *m_actionSets.get(entry);
 
             if (xrActionSet.name == name) {
                 return XR_ERROR_NAME_DUPLICATED;
@@ -190,10 +192,8 @@ namespace pimax_openxr {
         xrActionSet.name = name;
         xrActionSet.localizedName = localizedName;
 
-        *actionSet = (XrActionSet)&xrActionSet;
-
         // Maintain a list of known actionsets for validation.
-        m_actionSets.insert(*actionSet);
+        *actionSet = m_actionSets.insert(&xrActionSet);
 
         TraceLoggingWrite(g_traceProvider, "xrCreateActionSet", TLXArg(*actionSet, "ActionSet"));
 
@@ -204,12 +204,16 @@ namespace pimax_openxr {
     XrResult OpenXrRuntime::xrDestroyActionSet(XrActionSet actionSet) {
         TraceLoggingWrite(g_traceProvider, "xrDestroyActionSet", TLXArg(actionSet, "ActionSet"));
 
-        if (!m_actionSets.count(actionSet)) {
+        if (!m_actionSets.contains(actionSet)) {
             return XR_ERROR_HANDLE_INVALID;
         }
 
-        ActionSet* xrActionSet = (ActionSet*)actionSet;
+        ActionSet* xrActionSet = m_actionSets.get(actionSet);
 
+        InputSnapshot* snapshot = xrActionSet->inputSnapshot.load();
+        if (snapshot) {
+            snapshot->references--;
+        }
         delete xrActionSet;
         m_actionSets.erase(actionSet);
         m_activeActionSets.erase(actionSet);
@@ -245,7 +249,7 @@ namespace pimax_openxr {
             return XR_ERROR_VALIDATION_FAILURE;
         }
 
-        if (!m_actionSets.count(actionSet)) {
+        if (!m_actionSets.contains(actionSet)) {
             return XR_ERROR_HANDLE_INVALID;
         }
 
@@ -268,7 +272,7 @@ namespace pimax_openxr {
         }
 
         for (const auto& entry : m_actions) {
-            const Action& xrAction = *(Action*)entry;
+            const Action& xrAction = *m_actions.get(entry);
 
             if (xrAction.actionSet != actionSet) {
                 continue;
@@ -284,7 +288,8 @@ namespace pimax_openxr {
 
         for (uint32_t i = 0; i < createInfo->countSubactionPaths; i++) {
             const std::string& subactionPath = getXrPath(createInfo->subactionPaths[i]);
-            if (subactionPath != "/user/hand/left" && subactionPath != "/user/hand/right") {
+            if (subactionPath != "/user/hand/left" && subactionPath != "/user/hand/right" &&
+                (!has_XR_EXT_eye_gaze_interaction || subactionPath != "/user/eyes_ext")) {
                 return XR_ERROR_PATH_UNSUPPORTED;
             }
         }
@@ -299,11 +304,9 @@ namespace pimax_openxr {
             xrAction.subactionPaths.insert(createInfo->subactionPaths[i]);
         }
 
-        *action = (XrAction)&xrAction;
-
         // Maintain a list of known actions for validation.
-        m_actions.insert(*action);
-        m_actionsForCleanup.insert(*action);
+        *action = m_actions.insert(&xrAction);
+        m_actionsForCleanup.push_back(&xrAction);
 
         TraceLoggingWrite(g_traceProvider, "xrCreateAction", TLXArg(*action, "Action"));
 
@@ -314,7 +317,7 @@ namespace pimax_openxr {
     XrResult OpenXrRuntime::xrDestroyAction(XrAction action) {
         TraceLoggingWrite(g_traceProvider, "xrDestroyAction", TLXArg(action, "Action"));
 
-        if (!m_actions.count(action)) {
+        if (!m_actions.contains(action)) {
             return XR_ERROR_HANDLE_INVALID;
         }
 
@@ -358,7 +361,9 @@ namespace pimax_openxr {
 
         const auto checkValidPathIt =
             m_controllerValidPathsTable.find(getXrPath(suggestedBindings->interactionProfile));
-        if (checkValidPathIt == m_controllerValidPathsTable.cend()) {
+        if (checkValidPathIt == m_controllerValidPathsTable.cend() ||
+            (!has_XR_EXT_eye_gaze_interaction &&
+             checkValidPathIt->first == "/interaction_profiles/ext/eye_gaze_interaction")) {
             return XR_ERROR_PATH_UNSUPPORTED;
         }
 
@@ -403,7 +408,7 @@ namespace pimax_openxr {
         }
 
         for (uint32_t i = 0; i < attachInfo->countActionSets; i++) {
-            if (!m_actionSets.count(attachInfo->actionSets[i])) {
+            if (!m_actionSets.contains(attachInfo->actionSets[i])) {
                 return XR_ERROR_HANDLE_INVALID;
             }
         }
@@ -411,16 +416,47 @@ namespace pimax_openxr {
         for (uint32_t i = 0; i < attachInfo->countActionSets; i++) {
             m_activeActionSets.insert(attachInfo->actionSets[i]);
 
-            ActionSet& xrActionSet = *(ActionSet*)attachInfo->actionSets[i];
+            ActionSet& xrActionSet = *m_actionSets.get(attachInfo->actionSets[i]);
 
             // Identify all valid subaction paths for the actionset.
             for (const auto& entry : m_actions) {
-                const Action& xrAction = *(Action*)entry;
+                const Action& xrAction = *m_actions.get(entry);
 
                 xrActionSet.subactionPaths.insert(xrAction.subactionPaths.begin(), xrAction.subactionPaths.end());
             }
         }
 
+        // The eye gaze does not depend on a physical controller being connected, so it is bound once upon attaching.
+        const auto eyeGazeBindings = m_suggestedBindings.find("/interaction_profiles/ext/eye_gaze_interaction");
+        if (m_isEyeTrackingAvailable && eyeGazeBindings != m_suggestedBindings.cend()) {
+            for (const auto& binding : eyeGazeBindings->second) {
+                if (!m_actions.contains(binding.action)) {
+                    continue;
+                }
+
+                Action& xrAction = *m_actions.get(binding.action);
+                if (xrAction.type == XR_ACTION_TYPE_POSE_INPUT && m_activeActionSets.count(xrAction.actionSet)) {
+                    TraceLoggingWrite(g_traceProvider,
+                                      "xrAttachSessionActionSets_MapEyeGaze",
+                                      TLXArg(binding.action, "Action"),
+                                      TLXArg(xrAction.actionSet, "ActionSet"));
+                    xrAction.hasEyeGazePose = true;
+                }
+            }
+
+            CHECK_XRCMD(xrStringToPath(XR_NULL_HANDLE, eyeGazeBindings->first.c_str(), &m_eyeGazeInteractionProfile));
+            m_currentInteractionProfileDirty = true;
+            LOG_TELEMETRY_ONCE(logFeature("EyeGazeInteraction"));
+
+            std::unique_lock lock(m_actionBindingsLock);
+            for (const auto& space : m_spaces) {
+                Space& xrSpace = *m_spaces.get(space);
+                if (xrSpace.action) {
+                    resolveActionSpace(xrSpace);
+                }
+            }
+        }
+
         return XR_SUCCESS;
     }
 
@@ -458,6 +494,8 @@ namespace pimax_openxr {
         interactionProfile->interactionProfile = XR_NULL_PATH;
         if (side == 0 || side == 1) {
             interactionProfile->interactionProfile = m_currentInteractionProfile[side];
+        } else if (topLevelUserPath == m_eyesPath) {
+            interactionProfile->interactionProfile = m_eyeGazeInteractionProfile;
         }
 
         TraceLoggingWrite(g_traceProvider,
@@ -485,11 +523,11 @@ namespace pimax_openxr {
             return XR_ERROR_HANDLE_INVALID;
         }
 
-        if (!m_actions.count(getInfo->action)) {
+        if (!m_actions.contains(getInfo->action)) {
             return XR_ERROR_HANDLE_INVALID;
         }
 
-        Action& xrAction = *(Action*)getInfo->action;
+        Action& xrAction = *m_actions.get(getInfo->action);
 
         if (xrAction.type != XR_ACTION_TYPE_BOOLEAN_INPUT) {
             return XR_ERROR_ACTION_TYPE_MISMATCH;
@@ -500,7 +538,7 @@ namespace pimax_openxr {
         }
 
         if (getInfo->subactionPath != XR_NULL_PATH) {
-            if (m_strings.find(getInfo->subactionPath) == m_strings.cend()) {
+            if (!m_strings.contains(getInfo->subactionPath)) {
                 return XR_ERROR_PATH_INVALID;
             }
             if (!xrAction.subactionPaths.count(getInfo->subactionPath)) {
@@ -508,31 +546,31 @@ namespace pimax_openxr {
             }
         }
 
+        const ActionSet& xrActionSet = *m_actionSets.get(xrAction.actionSet);
+        const InputSnapshotReader snapshot(xrActionSet);
+        const pvrInputState& input = snapshot.state();
+        const Action::Bindings& bindings = xrAction.bindings.get();
+
         std::optional<bool> combinedState;
-        const std::string& subActionPath = getXrPath(getInfo->subactionPath);
-        const int subActionSide = std::max(0, getActionSide(subActionPath));
-        for (const auto& source : xrAction.actionSources) {
-            if (!startsWith(source.first, subActionPath)) {
-                continue;
-            }
+        const auto [firstSide, lastSide] = getSubactionSideRange(getInfo->subactionPath);
+        const int subActionSide = getInfo->subactionPath == m_handPaths[1] ? 1 : 0;
+        for (int side = firstSide; side < lastSide; side++) {
+            for (const auto& source : bindings.boundSources[side]) {
+                const auto& value = *source.source;
+                const auto buttonMap = relocateToSnapshot(value.buttonMap, m_cachedInputState, input);
+                const auto floatValue = relocateToSnapshot(value.floatValue, m_cachedInputState, input);
+                const bool isBound = buttonMap != nullptr || floatValue != nullptr;
+                TraceLoggingWrite(g_traceProvider,
+                                  "xrGetActionStateBoolean",
+                                  TLArg(source.path->c_str(), "ActionSourcePath"),
+                                  TLArg(isBound, "Bound"));
 
-            const std::string& fullPath = source.first;
-            const auto& value = source.second;
-            const bool isBound = value.buttonMap != nullptr || value.floatValue != nullptr;
-            TraceLoggingWrite(g_traceProvider,
-                              "xrGetActionStateBoolean",
-                              TLArg(fullPath.c_str(), "ActionSourcePath"),
-                              TLArg(isBound, "Bound"));
-
-            // We only support hands paths, not gamepad etc.
-            const int side = getActionSide(fullPath);
-            if (isBound && side >= 0) {
-                if (m_isControllerActive[side]) {
+                if (isBound && m_isControllerActive[side]) {
                     // Per spec, the combined state is the OR of all values.
-                    if (value.buttonMap) {
-                        combinedState = combinedState.value_or(false) || value.buttonMap[side] & value.buttonType;
+                    if (buttonMap) {
+                        combinedState = combinedState.value_or(false) || buttonMap[side] & value.buttonType;
                     } else {
-                        combinedState = combinedState.value_or(false) || value.floatValue[side] > 0.99f;
+                        combinedState = combinedState.value_or(false) || floatValue[side] > 0.99f;
                     }
                 }
             }
@@ -541,18 +579,17 @@ namespace pimax_openxr {
         state->isActive = combinedState ? XR_TRUE : XR_FALSE;
         if (combinedState) {
             state->currentState = combinedState.value();
-            state->changedSinceLastSync = !!state->currentState != xrAction.lastBoolValue[subActionSide];
+            state->changedSinceLastSync = !!state->currentState != xrAction.lastBoolValue[subActionSide].load();
 
-            const ActionSet& xrActionSet = *(ActionSet*)xrAction.actionSet;
             state->lastChangeTime = state->changedSinceLastSync
-                                        ? pvrTimeToXrTime(xrActionSet.cachedInputState.TimeInSeconds)
-                                        : xrAction.lastBoolValueChangedTime[subActionSide];
+                                        ? pvrTimeToXrTime(input.TimeInSeconds)
+                                        : xrAction.lastBoolValueChangedTime[subActionSide].load();
         } else {
             state->currentState = state->changedSinceLastSync = XR_FALSE;
             state->lastChangeTime = 0;
         }
 
-        xrAction.lastBoolValue[subActionSide] = state->currentState;
+        xrAction.lastBoolValue[subActionSide] = !!state->currentState;
         xrAction.lastBoolValueChangedTime[subActionSide] = state->lastChangeTime;
 
         TraceLoggingWrite(g_traceProvider,
@@ -583,11 +620,11 @@ namespace pimax_openxr {
             return XR_ERROR_HANDLE_INVALID;
         }
 
-        if (!m_actions.count(getInfo->action)) {
+        if (!m_actions.contains(getInfo->action)) {
             return XR_ERROR_HANDLE_INVALID;
         }
 
-        Action& xrAction = *(Action*)getInfo->action;
+        Action& xrAction = *m_actions.get(getInfo->action);
 
         if (xrAction.type != XR_ACTION_TYPE_FLOAT_INPUT) {
             return XR_ERROR_ACTION_TYPE_MISMATCH;
@@ -598,7 +635,7 @@ namespace pimax_openxr {
         }
 
         if (getInfo->subactionPath != XR_NULL_PATH) {
-            if (m_strings.find(getInfo->subactionPath) == m_strings.cend()) {
+            if (!m_strings.contains(getInfo->subactionPath)) {
                 return XR_ERROR_PATH_INVALID;
             }
             if (!xrAction.subactionPaths.count(getInfo->subactionPath)) {
@@ -606,40 +643,40 @@ namespace pimax_openxr {
             }
         }
 
+        const ActionSet& xrActionSet = *m_actionSets.get(xrAction.actionSet);
+        const InputSnapshotReader snapshot(xrActionSet);
+        const pvrInputState& input = snapshot.state();
+        const Action::Bindings& bindings = xrAction.bindings.get();
+
         std::optional<float> combinedState;
-        const std::string& subActionPath = getXrPath(getInfo->subactionPath);
-        const int subActionSide = std::max(0, getActionSide(subActionPath));
-        for (const auto& source : xrAction.actionSources) {
-            if (!startsWith(source.first, subActionPath)) {
-                continue;
-            }
+        const auto [firstSide, lastSide] = getSubactionSideRange(getInfo->subactionPath);
+        const int subActionSide = getInfo->subactionPath == m_handPaths[1] ? 1 : 0;
+        for (int side = firstSide; side < lastSide; side++) {
+            for (const auto& source : bindings.boundSources[side]) {
+                const auto& value = *source.source;
+                const auto floatValue = relocateToSnapshot(value.floatValue, m_cachedInputState, input);
+                const auto vector2fValue = relocateToSnapshot(value.vector2fValue, m_cachedInputState, input);
+                const auto buttonMap = relocateToSnapshot(value.buttonMap, m_cachedInputState, input);
+                const bool isBound = floatValue != nullptr || (vector2fValue != nullptr && value.vector2fIndex >= 0) ||
+                                     buttonMap != nullptr;
+                TraceLoggingWrite(g_traceProvider,
+                                  "xrGetActionStateFloat",
+                                  TLArg(source.path->c_str(), "ActionSourcePath"),
+                                  TLArg(isBound, "Bound"));
 
-            const std::string& fullPath = source.first;
-            const auto& value = source.second;
-            const bool isBound = value.floatValue != nullptr ||
-                                 (value.vector2fValue != nullptr && value.vector2fIndex >= 0) ||
-                                 value.buttonMap != nullptr;
-            TraceLoggingWrite(g_traceProvider,
-                              "xrGetActionStateFloat",
-                              TLArg(fullPath.c_str(), "ActionSourcePath"),
-                              TLArg(isBound, "Bound"));
-
-            // We only support hands paths, not gamepad etc.
-            const int side = getActionSide(fullPath);
-            if (isBound && side >= 0) {
-                if (m_isControllerActive[side]) {
+                if (isBound && m_isControllerActive[side]) {
                     // Per spec, the combined state is the absolute maximum of all values.
-                    if (value.floatValue) {
+                    if (floatValue) {
                         combinedState = std::max(combinedState.value_or(-std::numeric_limits<float>::infinity()),
-                                                 value.floatValue[side]);
-                    } else if (value.buttonMap) {
+                                                 floatValue[side]);
+                    } else if (buttonMap) {
                         combinedState = std::max(combinedState.value_or(-std::numeric_limits<float>::infinity()),
-                                                 value.buttonMap[side] & value.buttonType ? 1.f : 0.f);
+                                                 buttonMap[side] & value.buttonType ? 1.f : 0.f);
                     } else {
-                        const XrVector2f vector2fValue = handleJoystickDeadzone(value.vector2fValue[side]);
+                        const XrVector2f deadzonedValue = handleJoystickDeadzone(vector2fValue[side]);
 
                         combinedState = std::max(combinedState.value_or(-std::numeric_limits<float>::infinity()),
-                                                 value.vector2fIndex == 0 ? vector2fValue.x : vector2fValue.y);
+                                                 value.vector2fIndex == 0 ? deadzonedValue.x : deadzonedValue.y);
                     }
                 }
             }
@@ -648,12 +685,11 @@ namespace pimax_openxr {
         state->isActive = combinedState ? XR_TRUE : XR_FALSE;
         if (combinedState) {
             state->currentState = combinedState.value();
-            state->changedSinceLastSync = state->currentState != xrAction.lastFloatValue[subActionSide];
+            state->changedSinceLastSync = state->currentState != xrAction.lastFloatValue[subActionSide].load();
 
-            const ActionSet& xrActionSet = *(ActionSet*)xrAction.actionSet;
             state->lastChangeTime = state->changedSinceLastSync
-                                        ? pvrTimeToXrTime(xrActionSet.cachedInputState.TimeInSeconds)
-                                        : xrAction.lastFloatValueChangedTime[subActionSide];
+                                        ? pvrTimeToXrTime(input.TimeInSeconds)
+                                        : xrAction.lastFloatValueChangedTime[subActionSide].load();
         } else {
             state->currentState = 0.0f;
             state->changedSinceLastSync = XR_FALSE;
@@ -691,11 +727,11 @@ namespace pimax_openxr {
             return XR_ERROR_HANDLE_INVALID;
         }
 
-        if (!m_actions.count(getInfo->action)) {
+        if (!m_actions.contains(getInfo->action)) {
             return XR_ERROR_HANDLE_INVALID;
         }
 
-        Action& xrAction = *(Action*)getInfo->action;
+        Action& xrAction = *m_actions.get(getInfo->action);
 
         if (xrAction.type != XR_ACTION_TYPE_VECTOR2F_INPUT) {
             return XR_ERROR_ACTION_TYPE_MISMATCH;
@@ -706,7 +742,7 @@ namespace pimax_openxr {
         }
 
         if (getInfo->subactionPath != XR_NULL_PATH) {
-            if (m_strings.find(getInfo->subactionPath) == m_strings.cend()) {
+            if (!m_strings.contains(getInfo->subactionPath)) {
                 return XR_ERROR_PATH_INVALID;
             }
             if (!xrAction.subactionPaths.count(getInfo->subactionPath)) {
@@ -714,27 +750,25 @@ namespace pimax_openxr {
             }
         }
 
-        std::optional<XrVector2f> combinedState;
-        const std::string& subActionPath = getXrPath(getInfo->subactionPath);
-        const int subActionSide = std::max(0, getActionSide(subActionPath));
-        for (const auto& source : xrAction.actionSources) {
-            if (!startsWith(source.first, subActionPath)) {
-                continue;
-            }
+        const ActionSet& xrActionSet = *m_actionSets.get(xrAction.actionSet);
+        const InputSnapshotReader snapshot(xrActionSet);
+        const pvrInputState& input = snapshot.state();
+        const Action::Bindings& bindings = xrAction.bindings.get();
 
-            const std::string& fullPath = source.first;
-            const auto& value = source.second;
-            const bool isBound = value.vector2fValue != nullptr;
-            TraceLoggingWrite(g_traceProvider,
-                              "xrGetActionStateVector2f",
-                              TLArg(fullPath.c_str(), "ActionSourcePath"),
-                              TLArg(isBound, "Bound"));
+        std::optional<XrVector2f> combinedState;
+        const auto [firstSide, lastSide] = getSubactionSideRange(getInfo->subactionPath);
+        const int subActionSide = getInfo->subactionPath == m_handPaths[1] ? 1 : 0;
+        for (int side = firstSide; side < lastSide; side++) {
+            for (const auto& source : bindings.boundSources[side]) {
+                const auto rawValue = relocateToSnapshot(source.source->vector2fValue, m_cachedInputState, input);
+                const bool isBound = rawValue != nullptr;
+                TraceLoggingWrite(g_traceProvider,
+                                  "xrGetActionStateVector2f",
+                                  TLArg(source.path->c_str(), "ActionSourcePath"),
+                                  TLArg(isBound, "Bound"));
 
-            // We only support hands paths, not gamepad etc.
-            const int side = getActionSide(fullPath);
-            if (isBound && side >= 0) {
-                if (m_isControllerActive[side]) {
-                    const XrVector2f vector2fValue = handleJoystickDeadzone(value.vector2fValue[side]);
+                if (isBound && m_isControllerActive[side]) {
+                    const XrVector2f vector2fValue = handleJoystickDeadzone(rawValue[side]);
 
                     // Per spec, the combined state if the one of the vector with the longest length.
                     const float l1 = combinedState ? sqrt(combinedState.value().x * combinedState.value().x +
@@ -752,13 +786,12 @@ namespace pimax_openxr {
         if (combinedState) {
             state->currentState = combinedState.value();
 
-            state->changedSinceLastSync = state->currentState.x != xrAction.lastVector2fValue[subActionSide].x ||
-                                          state->currentState.y != xrAction.lastVector2fValue[subActionSide].y;
+            const XrVector2f lastValue = xrAction.lastVector2fValue[subActionSide].load();
+            state->changedSinceLastSync = state->currentState.x != lastValue.x || state->currentState.y != lastValue.y;
 
-            const ActionSet& xrActionSet = *(ActionSet*)xrAction.actionSet;
             state->lastChangeTime = state->changedSinceLastSync
-                                        ? pvrTimeToXrTime(xrActionSet.cachedInputState.TimeInSeconds)
-                                        : xrAction.lastVector2fValueChangedTime[subActionSide];
+                                        ? pvrTimeToXrTime(input.TimeInSeconds)
+                                        : xrAction.lastVector2fValueChangedTime[subActionSide].load();
         } else {
             state->currentState = {0.0f, 0.0f};
             state->changedSinceLastSync = XR_FALSE;
@@ -797,11 +830,11 @@ namespace pimax_openxr {
             return XR_ERROR_HANDLE_INVALID;
         }
 
-        if (!m_actions.count(getInfo->action)) {
+        if (!m_actions.contains(getInfo->action)) {
             return XR_ERROR_HANDLE_INVALID;
         }
 
-        Action& xrAction = *(Action*)getInfo->action;
+        Action& xrAction = *m_actions.get(getInfo->action);
 
         if (xrAction.type != XR_ACTION_TYPE_POSE_INPUT) {
             return XR_ERROR_ACTION_TYPE_MISMATCH;
@@ -812,7 +845,7 @@ namespace pimax_openxr {
         }
 
         if (getInfo->subactionPath != XR_NULL_PATH) {
-            if (m_strings.find(getInfo->subactionPath) == m_strings.cend()) {
+            if (!m_strings.contains(getInfo->subactionPath)) {
                 return XR_ERROR_PATH_INVALID;
             }
             if (!xrAction.subactionPaths.count(getInfo->subactionPath)) {
@@ -820,25 +853,32 @@ namespace pimax_openxr {
             }
         }
 
-        const std::string& subActionPath = getXrPath(getInfo->subactionPath);
-        for (const auto& source : xrAction.actionSources) {
-            if (!startsWith(source.first, subActionPath)) {
-                continue;
-            }
-
-            const std::string& fullPath = source.first;
-            TraceLoggingWrite(g_traceProvider, "xrGetActionStatePose", TLArg(fullPath.c_str(), "ActionSourcePath"));
+        // Per spec we must consistently pick one source. We pick the first one.
+        const Action::Bindings& bindings = xrAction.bindings.get();
+        bool hasControllerSource = false;
+        const auto [firstSide, lastSide] = getSubactionSideRange(getInfo->subactionPath);
+        for (int side = firstSide; side < lastSide; side++) {
+            if (!bindings.boundSources[side].empty()) {
+                TraceLoggingWrite(g_traceProvider,
+                                  "xrGetActionStatePose",
+                                  TLArg(bindings.boundSources[side][0].path->c_str(), "ActionSourcePath"));
 
-            // We only support hands paths, not gamepad etc.
-            const int side = getActionSide(fullPath);
-            if (side >= 0) {
                 state->isActive = m_isControllerActive[side] ? XR_TRUE : XR_FALSE;
-
-                // Per spec we must consistently pick one source. We pick the first one.
+                hasControllerSource = true;
                 break;
             }
         }
 
+        // Like resolveActionSpace(), the eye gaze is only picked when no controller source is bound.
+        if (!hasControllerSource && xrAction.hasEyeGazePose &&
+            (getInfo->subactionPath == XR_NULL_PATH || getInfo->subactionPath == m_eyesPath)) {
+            TraceLoggingWrite(g_traceProvider,
+                              "xrGetActionStatePose",
+                              TLArg("/user/eyes_ext/input/gaze_ext/pose", "ActionSourcePath"));
+
+            state->isActive = XR_TRUE;
+        }
+
         TraceLoggingWrite(g_traceProvider, "xrGetActionStatePose", TLArg(!!state->isActive, "Active"));
 
         return XR_SUCCESS;
@@ -871,7 +911,7 @@ namespace pimax_openxr {
             if (syncInfo->activeActionSets[i].subactionPath == XR_NULL_PATH) {
                 doSide[0] = doSide[1] = true;
             } else {
-                const ActionSet& xrActionSet = *(ActionSet*)syncInfo->activeActionSets[i].actionSet;
+                const ActionSet& xrActionSet = *m_actionSets.get(syncInfo->activeActionSets[i].actionSet);
 
                 if (!xrActionSet.subactionPaths.count(syncInfo->activeActionSets[i].subactionPath)) {
                     return XR_ERROR_PATH_UNSUPPORTED;
@@ -889,7 +929,15 @@ namespace pimax_openxr {
         }
 
         // Latch the state of all inputs, and we will let the further calls to xrGetActionState*() do the triage.
-        CHECK_PVRCMD(pvr_getInputState(m_pvrSession, &m_cachedInputState));
+        {
+            std::unique_lock pvrLock(m_pvrLock);
+            CHECK_PVRCMD(pvr_getInputState(m_pvrSession, &m_cachedInputState));
+        }
+        if (doSide[0] || doSide[1]) {
+            updateInputSnapshot(*syncInfo);
+        }
+
+        const RuntimeSettings& settings = currentSettings();
         bool wasRecenteringPressed = false;
         for (uint32_t side = 0; side < 2; side++) {
             if (!doSide[side]) {
@@ -918,38 +966,20 @@ namespace pimax_openxr {
                 TLArg(m_cachedInputState.fingerRing[side], "RingFinger"),
                 TLArg(m_cachedInputState.fingerPinky[side], "PinkyFinger"));
 
-            // Propagate the input state to the entire action state.
-            for (uint32_t i = 0; i < syncInfo->countActiveActionSets; i++) {
-                ActionSet& xrActionSet = *(ActionSet*)syncInfo->activeActionSets[i].actionSet;
-
-                xrActionSet.cachedInputState = m_cachedInputState;
-            }
-
             // Look for changes in controller/interaction profiles.
+            // The controller type is only re-read when the watcher thread published a change.
             const auto lastControllerType = m_cachedControllerType[side];
-            const int size = pvr_getTrackedDeviceStringProperty(m_pvrSession,
-                                                                side == 0 ? pvrTrackedDevice_LeftController
-                                                                          : pvrTrackedDevice_RightController,
-                                                                pvrTrackedDeviceProp_ControllerType_String,
-                                                                nullptr,
-                                                                0);
-            m_isControllerActive[side] = size > 0;
-            if (m_isControllerActive[side]) {
-                m_cachedControllerType[side].resize(size, 0);
-                pvr_getTrackedDeviceStringProperty(m_pvrSession,
-                                                   side == 0 ? pvrTrackedDevice_LeftController
-                                                             : pvrTrackedDevice_RightController,
-                                                   pvrTrackedDeviceProp_ControllerType_String,
-                                                   m_cachedControllerType[side].data(),
-                                                   (int)m_cachedControllerType[side].size() + 1);
-                // Remove trailing 0.
-                m_cachedControllerType[side].resize(size - 1, 0);
-            } else {
-                m_cachedControllerType[side].clear();
+            const uint64_t controllerTypeGeneration = m_controllerTypeGeneration.load();
+            if (controllerTypeGeneration != m_lastControllerTypeGeneration[side]) {
+                std::unique_lock lock(m_controllerWatcherLock);
+                m_cachedControllerType[side] = m_detectedControllerType[side];
+                m_lastControllerTypeGeneration[side] = controllerTypeGeneration;
             }
+            m_isControllerActive[side] = !m_cachedControllerType[side].empty();
 
-            if (lastControllerType != m_cachedControllerType[side] ||
-                m_forcedInteractionProfile != m_lastForcedInteractionProfile) {
+            const bool rebindRequested = m_controllerRebindRequested[side].exchange(false);
+            if (lastControllerType != m_cachedControllerType[side] || rebindRequested ||
+                settings.forcedInteractionProfile != m_lastForcedInteractionProfile) {
                 if (!m_cachedControllerType[side].empty()) {
                     Log("Detected controller: %s (%s)\n",
                         m_cachedControllerType[side].c_str(),
@@ -968,7 +998,7 @@ namespace pimax_openxr {
                                            (m_cachedInputState.HandButtons[side] & pvrButton_ApplicationMenu)) &&
                                           (m_cachedInputState.HandButtons[side] & pvrButton_Trigger));
         }
-        m_lastForcedInteractionProfile = m_forcedInteractionProfile;
+        m_lastForcedInteractionProfile = settings.forcedInteractionProfile;
 
         // Execute built-in actions.
         handleBuiltinActions(wasRecenteringPressed);
@@ -997,27 +1027,28 @@ namespace pimax_openxr {
             return XR_ERROR_HANDLE_INVALID;
         }
 
-        if (!m_actions.count(enumerateInfo->action)) {
+        if (!m_actions.contains(enumerateInfo->action)) {
             return XR_ERROR_HANDLE_INVALID;
         }
 
-        Action& xrAction = *(Action*)enumerateInfo->action;
+        Action& xrAction = *m_actions.get(enumerateInfo->action);
 
         if (!m_activeActionSets.count(xrAction.actionSet)) {
             return XR_ERROR_ACTIONSET_NOT_ATTACHED;
         }
 
-        if (sourceCapacityInput && sourceCapacityInput < xrAction.actionSources.size()) {
+        const Action::Bindings& bindings = xrAction.bindings.get();
+        if (sourceCapacityInput && sourceCapacityInput < bindings.actionSources.size()) {
             return XR_ERROR_SIZE_INSUFFICIENT;
         }
 
-        *sourceCountOutput = (uint32_t)xrAction.actionSources.size();
+        *sourceCountOutput = (uint32_t)bindings.actionSources.size();
         TraceLoggingWrite(
             g_traceProvider, "xrEnumerateBoundSourcesForAction", TLArg(*sourceCountOutput, "SourceCountOutput"));
 
         if (sourceCapacityInput && sources) {
             uint32_t i = 0;
-            for (const auto& source : xrAction.actionSources) {
+            for (const auto& source : bindings.actionSources) {
                 CHECK_XRCMD(xrStringToPath(XR_NULL_HANDLE, source.second.realPath.c_str(), &sources[i]));
                 TraceLoggingWrite(g_traceProvider,
                                   "xrEnumerateBoundSourcesForAction",
@@ -1134,11 +1165,11 @@ namespace pimax_openxr {
             return XR_ERROR_HANDLE_INVALID;
         }
 
-        if (!m_actions.count(hapticActionInfo->action)) {
+        if (!m_actions.contains(hapticActionInfo->action)) {
             return XR_ERROR_HANDLE_INVALID;
         }
 
-        Action& xrAction = *(Action*)hapticActionInfo->action;
+        Action& xrAction = *m_actions.get(hapticActionInfo->action);
 
         if (xrAction.type != XR_ACTION_TYPE_VIBRATION_OUTPUT) {
             return XR_ERROR_ACTION_TYPE_MISMATCH;
@@ -1153,7 +1184,7 @@ namespace pimax_openxr {
         }
 
         if (hapticActionInfo->subactionPath != XR_NULL_PATH) {
-            if (m_strings.find(hapticActionInfo->subactionPath) == m_strings.cend()) {
+            if (!m_strings.contains(hapticActionInfo->subactionPath)) {
                 return XR_ERROR_PATH_INVALID;
             }
             if (!xrAction.subactionPaths.count(hapticActionInfo->subactionPath)) {
@@ -1161,44 +1192,34 @@ namespace pimax_openxr {
             }
         }
 
-        const std::string& subActionPath = getXrPath(hapticActionInfo->subactionPath);
-        for (const auto& source : xrAction.actionSources) {
-            if (!startsWith(source.first, subActionPath)) {
+        // We only support hands paths, not gamepad etc.
+        const auto [firstSide, lastSide] = getSubactionSideRange(hapticActionInfo->subactionPath);
+        for (int side = firstSide; side < lastSide; side++) {
+            if (!xrAction.bindings.get().hasHapticOutput[side]) {
                 continue;
             }
 
-            const std::string& fullPath = source.first;
-            const bool isOutput = endsWith(fullPath, "/output/haptic");
-            TraceLoggingWrite(g_traceProvider, "xrApplyHapticFeedback", TLArg(fullPath.c_str(), "ActionSourcePath"));
-
-            // We only support hands paths, not gamepad etc.
-            const int side = getActionSide(fullPath);
-            if (isOutput && side >= 0) {
-                const XrHapticBaseHeader* entry = reinterpret_cast<const XrHapticBaseHeader*>(hapticFeedback);
-                while (entry) {
-                    if (entry->type == XR_TYPE_HAPTIC_VIBRATION) {
-                        const XrHapticVibration* vibration = reinterpret_cast<const XrHapticVibration*>(entry);
-
-                        TraceLoggingWrite(g_traceProvider,
-                                          "xrApplyHapticFeedback",
-                                          TLArg(vibration->amplitude, "Amplitude"),
-                                          TLArg(vibration->frequency, "Frequency"),
-                                          TLArg(vibration->duration, "Duration"));
-
-                        // NOTE: PVR only supports pulses, so there is nothing we can do with the
-                        // frequency/duration? OpenComposite seems to pass an amplitude of 0 sometimes, which is not
-                        // supported.
-                        if (vibration->amplitude > 0) {
-                            CHECK_PVRCMD(pvr_triggerHapticPulse(m_pvrSession,
-                                                                side == 0 ? pvrTrackedDevice_LeftController
-                                                                          : pvrTrackedDevice_RightController,
-                                                                vibration->amplitude));
-                        }
-                        break;
+            const XrHapticBaseHeader* entry = reinterpret_cast<const XrHapticBaseHeader*>(hapticFeedback);
+            while (entry) {
+                if (entry->type == XR_TYPE_HAPTIC_VIBRATION) {
+                    const XrHapticVibration* vibration = reinterpret_cast<const XrHapticVibration*>(entry);
+
+                    TraceLoggingWrite(g_traceProvider,
+                                      "xrApplyHapticFeedback",
+                                      TLArg(side == 0 ? "Left" : "Right", "Side"),
+                                      TLArg(vibration->amplitude, "Amplitude"),
+                                      TLArg(vibration->frequency, "Frequency"),
+                                      TLArg(vibration->duration, "Duration"));
+
+                    // NOTE: PVR only supports pulses, so there is nothing we can do with the frequency/duration?
+                    // OpenComposite seems to pass an amplitude of 0 sometimes, which is not supported.
+                    if (vibration->amplitude > 0) {
+                        queueHapticPulse(side, vibration->amplitude);
                     }
-
-                    entry = reinterpret_cast<const XrHapticBaseHeader*>(entry->next);
+                    break;
                 }
+
+                entry = reinterpret_cast<const XrHapticBaseHeader*>(entry->next);
             }
         }
 
@@ -1221,11 +1242,11 @@ namespace pimax_openxr {
             return XR_ERROR_HANDLE_INVALID;
         }
 
-        if (!m_actions.count(hapticActionInfo->action)) {
+        if (!m_actions.contains(hapticActionInfo->action)) {
             return XR_ERROR_HANDLE_INVALID;
         }
 
-        Action& xrAction = *(Action*)hapticActionInfo->action;
+        Action& xrAction = *m_actions.get(hapticActionInfo->action);
 
         if (xrAction.type != XR_ACTION_TYPE_VIBRATION_OUTPUT) {
             return XR_ERROR_ACTION_TYPE_MISMATCH;
@@ -1236,7 +1257,7 @@ namespace pimax_openxr {
         }
 
         if (hapticActionInfo->subactionPath != XR_NULL_PATH) {
-            if (m_strings.find(hapticActionInfo->subactionPath) == m_strings.cend()) {
+            if (!m_strings.contains(hapticActionInfo->subactionPath)) {
                 return XR_ERROR_PATH_INVALID;
             }
             if (!xrAction.subactionPaths.count(hapticActionInfo->subactionPath)) {
@@ -1244,20 +1265,13 @@ namespace pimax_openxr {
             }
         }
 
-        const std::string& subActionPath = getXrPath(hapticActionInfo->subactionPath);
-        for (const auto& source : xrAction.actionSources) {
-            if (!startsWith(source.first, subActionPath)) {
-                continue;
-            }
-
-            const std::string& fullPath = source.first;
-            const bool isOutput = endsWith(fullPath, "/output/haptic");
-            TraceLoggingWrite(g_traceProvider, "xrStopHapticFeedback", TLArg(fullPath.c_str(), "ActionSourcePath"));
-
-            // We only support hands paths, not gamepad etc.
-            const int side = getActionSide(fullPath);
-            if (isOutput && side >= 0) {
-                // Nothing to do here.
+        // PVR pulses cannot be interrupted, but we can drop the ones that did not go out yet.
+        const auto [firstSide, lastSide] = getSubactionSideRange(hapticActionInfo->subactionPath);
+        for (int side = firstSide; side < lastSide; side++) {
+            if (xrAction.bindings.get().hasHapticOutput[side]) {
+                TraceLoggingWrite(
+                    g_traceProvider, "xrStopHapticFeedback", TLArg(side == 0 ? "Left" : "Right", "Side"));
+                cancelHapticPulse(side);
             }
         }
 
@@ -1270,22 +1284,218 @@ namespace pimax_openxr {
     }
 
     // Update all actions with the appropriate bindings for the controller.
+    // Share one copy of the input state between all the actionsets being synced.
+    void OpenXrRuntime::updateInputSnapshot(const XrActionsSyncInfo& syncInfo) {
+        InputSnapshot* snapshot = nullptr;
+        for (const auto& entry : m_inputSnapshots) {
+            // A snapshot without references cannot gain new readers, see InputSnapshotReader.
+            if (!entry->references && !entry->readers) {
+                snapshot = entry.get();
+                break;
+            }
+        }
+        if (!snapshot) {
+            m_inputSnapshots.push_back(std::make_unique<InputSnapshot>());
+            snapshot = m_inputSnapshots.back().get();
+        }
+        snapshot->state = m_cachedInputState;
+
+        for (uint32_t i = 0; i < syncInfo.countActiveActionSets; i++) {
+            ActionSet& xrActionSet = *m_actionSets.get(syncInfo.activeActionSets[i].actionSet);
+
+            InputSnapshot* previous = xrActionSet.inputSnapshot.load();
+            if (previous == snapshot) {
+                continue;
+            }
+            if (previous) {
+                previous->references--;
+            }
+            snapshot->references++;
+            xrActionSet.inputSnapshot.store(snapshot, std::memory_order_release);
+        }
+    }
+
+    // Query the controller types from PVR and publish them if they changed.
+    void OpenXrRuntime::pollControllerTypes() {
+        std::string controllerType[2];
+        for (uint32_t side = 0; side < 2; side++) {
+            const auto device = side == 0 ? pvrTrackedDevice_LeftController : pvrTrackedDevice_RightController;
+            std::unique_lock pvrLock(m_pvrLock);
+            const int size = pvr_getTrackedDeviceStringProperty(
+                m_pvrSession, device, pvrTrackedDeviceProp_ControllerType_String, nullptr, 0);
+            if (size > 0) {
+                controllerType[side].resize(size, 0);
+                pvr_getTrackedDeviceStringProperty(m_pvrSession,
+                                                   device,
+                                                   pvrTrackedDeviceProp_ControllerType_String,
+                                                   controllerType[side].data(),
+                                                   (int)controllerType[side].size() + 1);
+                // Remove trailing 0.
+                controllerType[side].resize(size - 1, 0);
+            }
+        }
+
+        std::unique_lock lock(m_controllerWatcherLock);
+        if (controllerType[0] != m_detectedControllerType[0] || controllerType[1] != m_detectedControllerType[1]) {
+            m_detectedControllerType[0] = controllerType[0];
+            m_detectedControllerType[1] = controllerType[1];
+            m_controllerTypeGeneration++;
+        }
+    }
+
+    void OpenXrRuntime::startControllerWatcherThread() {
+        {
+            std::unique_lock lock(m_controllerWatcherLock);
+            m_detectedControllerType[0].clear();
+            m_detectedControllerType[1].clear();
+            m_stopControllerWatcherThread = false;
+        }
+        m_lastControllerTypeGeneration[0] = m_lastControllerTypeGeneration[1] = m_controllerTypeGeneration.load();
+
+        // Do a first query synchronously so that controllers are visible from the first xrSyncActions().
+        pollControllerTypes();
+
+        m_controllerWatcherThread = std::thread([&]() {
+            TraceLoggingWrite(g_traceProvider, "ControllerWatcherThread", TLArg("Started", "State"));
+
+            while (true) {
+                {
+                    std::unique_lock lock(m_controllerWatcherLock);
+                    m_controllerWatcherCondVar.wait_for(lock, 250ms, [&] { return m_stopControllerWatcherThread; });
+                    if (m_stopControllerWatcherThread) {
+                        break;
+                    }
+                }
+
+                pollControllerTypes();
+            }
+
+            TraceLoggingWrite(g_traceProvider, "ControllerWatcherThread", TLArg("Stopped", "State"));
+        });
+    }
+
+    void OpenXrRuntime::stopControllerWatcherThread() {
+        if (!m_controllerWatcherThread.joinable()) {
+            return;
+        }
+
+        {
+            std::unique_lock lock(m_controllerWatcherLock);
+            m_stopControllerWatcherThread = true;
+            m_controllerWatcherCondVar.notify_all();
+        }
+        m_controllerWatcherThread.join();
+    }
+
+    // Haptic pulses are posted to a single-entry mailbox per side, packing the frame they were requested in with
+    // their amplitude. Pulses requested during the same frame are merged by keeping the strongest, and pulses from an
+    // older frame are superseded by newer ones.
+    void OpenXrRuntime::queueHapticPulse(int side, float amplitude) {
+        const uint64_t frame = m_frameBegun & 0xffffffff;
+        uint32_t amplitudeBits;
+        static_assert(sizeof(amplitudeBits) == sizeof(amplitude));
+        memcpy(&amplitudeBits, &amplitude, sizeof(amplitude));
+        const uint64_t pulse = (frame << 32) | amplitudeBits;
+
+        uint64_t pending = m_pendingHapticPulse[side].load();
+        while (true) {
+            if (pending && (pending >> 32) == frame && (uint32_t)pending >= amplitudeBits) {
+                // A stronger pulse is already queued for this frame. Positive floats order like their bits.
+                return;
+            }
+            if (m_pendingHapticPulse[side].compare_exchange_weak(pending, pulse)) {
+                break;
+            }
+        }
+
+        m_hapticsRequests++;
+    }
+
+    void OpenXrRuntime::cancelHapticPulse(int side) {
+        m_pendingHapticPulse[side].store(0);
+    }
+
+    void OpenXrRuntime::startHapticsThread() {
+        m_pendingHapticPulse[0] = m_pendingHapticPulse[1] = 0;
+        m_stopHapticsThread = false;
+
+        m_hapticsThread = std::thread([&, lastRequest = (uint64_t)m_hapticsRequests]() mutable {
+            TraceLoggingWrite(g_traceProvider, "HapticsThread", TLArg("Started", "State"));
+
+            uint64_t lastPulse[2]{0, 0};
+            while (true) {
+                m_hapticsRequests.waitFor([&](uint64_t value) { return value != lastRequest; });
+                lastRequest = m_hapticsRequests;
+                if (m_stopHapticsThread) {
+                    break;
+                }
+
+                for (int side = 0; side < 2; side++) {
+                    const uint64_t pulse = m_pendingHapticPulse[side].exchange(0);
+                    // Drop pulses that are no stronger than the one already sent during the same frame.
+                    if (!pulse || ((pulse >> 32) == (lastPulse[side] >> 32) &&
+                                   (uint32_t)pulse <= (uint32_t)lastPulse[side])) {
+                        continue;
+                    }
+                    lastPulse[side] = pulse;
+
+                    float amplitude;
+                    const uint32_t amplitudeBits = (uint32_t)pulse;
+                    memcpy(&amplitude, &amplitudeBits, sizeof(amplitude));
+
+                    TraceLoggingWrite(g_traceProvider,
+                                      "HapticsThread_TriggerHapticPulse",
+                                      TLArg(side == 0 ? "Left" : "Right", "Side"),
+                                      TLArg(amplitude, "Amplitude"));
+
+                    // Errors cannot be reported to the application from here.
+                    pvrResult result;
+                    {
+                        std::unique_lock pvrLock(m_pvrLock);
+                        result = pvr_triggerHapticPulse(
+                            m_pvrSession,
+                            side == 0 ? pvrTrackedDevice_LeftController : pvrTrackedDevice_RightController,
+                            amplitude);
+                    }
+                    if (result != pvr_success) {
+                        ErrorLog("pvr_triggerHapticPulse() failed with code: %s\n", xr::ToString(result).c_str());
+                    }
+                }
+            }
+
+            TraceLoggingWrite(g_traceProvider, "HapticsThread", TLArg("Stopped", "State"));
+        });
+    }
+
+    void OpenXrRuntime::stopHapticsThread() {
+        if (!m_hapticsThread.joinable()) {
+            return;
+        }
+
+        m_stopHapticsThread = true;
+        m_hapticsRequests++;
+        m_hapticsThread.join();
+    }
+
     void OpenXrRuntime::rebindControllerActions(int side) {
+        std::unique_lock lock(m_actionBindingsLock);
+
+        const RuntimeSettings& settings = currentSettings();
         std::string preferredInteractionProfile;
         std::string actualInteractionProfile;
         XrPosef gripPose = Pose::Identity();
         XrPosef aimPose = Pose::Identity();
         XrPosef handPose = Pose::Identity();
 
-        // Remove all old bindings for this controller.
+        // Start from the current bindings, without the old bindings for this controller. The queries keep using the
+        // current bindings until the new ones are published.
         for (const auto& action : m_actions) {
-            Action& xrAction = *(Action*)action;
+            Action& xrAction = *m_actions.get(action);
 
-            for (auto it = xrAction.actionSources.begin(); it != xrAction.actionSources.end();) {
-                if (getActionSide(it->first) == side) {
-                    it = xrAction.actionSources.erase(it);
-                } else {
-                    it++;
+            xrAction.pendingBindings = std::make_unique<Action::Bindings>();
+            for (const auto& source : xrAction.bindings.get().actionSources) {
+                if (getActionSide(source.first) != side) {
+                    xrAction.pendingBindings->actionSources.insert(source);
                 }
             }
         }
@@ -1319,7 +1529,7 @@ namespace pimax_openxr {
             if (bindings != m_suggestedBindings.cend()) {
                 actualInteractionProfile = preferredInteractionProfile;
             }
-            if (bindings == m_suggestedBindings.cend() || m_forcedInteractionProfile) {
+            if (bindings == m_suggestedBindings.cend() || settings.forcedInteractionProfile) {
                 const bool hasOculusTouchControllerProfile =
                     m_suggestedBindings.find("/interaction_profiles/oculus/touch_controller") !=
                     m_suggestedBindings.cend();
@@ -1328,12 +1538,10 @@ namespace pimax_openxr {
                     m_suggestedBindings.cend();
 
                 // In order of preference.
-                if (m_forcedInteractionProfile &&
-                    m_forcedInteractionProfile.value() == ForcedInteractionProfile::OculusTouchController &&
+                if (settings.forcedInteractionProfile == ForcedInteractionProfile::OculusTouchController &&
                     hasOculusTouchControllerProfile) {
                     actualInteractionProfile = "/interaction_profiles/oculus/touch_controller";
-                } else if (m_forcedInteractionProfile &&
-                           m_forcedInteractionProfile.value() == ForcedInteractionProfile::MicrosoftMotionController &&
+                } else if (settings.forcedInteractionProfile == ForcedInteractionProfile::MicrosoftMotionController &&
                            hasMicrosoftMotionControllerProfile) {
                     actualInteractionProfile = "/interaction_profiles/microsoft/motion_controller";
                 } else if (hasOculusTouchControllerProfile) {
@@ -1351,11 +1559,9 @@ namespace pimax_openxr {
 
             // Map all possible actions sources for this controller.
             if (bindings != m_suggestedBindings.cend()) {
-                const auto& mapping = m_controllerMappingTable
-                                          .find(std::make_pair(actualInteractionProfile, preferredInteractionProfile))
-                                          ->second;
+                const auto mapping = findControllerMapping(actualInteractionProfile, preferredInteractionProfile);
                 for (const auto& binding : bindings->second) {
-                    if (!m_actions.count(binding.action)) {
+                    if (!m_actions.contains(binding.action)) {
                         continue;
                     }
 
@@ -1364,14 +1570,20 @@ namespace pimax_openxr {
                         continue;
                     }
 
-                    Action& xrAction = *(Action*)binding.action;
+                    Action& xrAction = *m_actions.get(binding.action);
+                    if (!xrAction.pendingBindings) {
+                        // The action was created after we started.
+                        continue;
+                    }
+                    auto& actionSources = xrAction.pendingBindings->actionSources;
 
                     // Map to the PVR input state.
                     ActionSource newSource{};
-                    if (mapping(xrAction, binding.binding, newSource)) {
+                    if (mapping &&
+                        mapBindingToInputState(mapping.value(), side, xrAction, binding.binding, newSource)) {
                         // Avoid duplicates.
                         bool duplicated = false;
-                        for (const auto& source : xrAction.actionSources) {
+                        for (const auto& source : actionSources) {
                             if (source.second.realPath == newSource.realPath) {
                                 duplicated = true;
                                 break;
@@ -1389,24 +1601,33 @@ namespace pimax_openxr {
                                               TLArg(!!newSource.floatValue, "IsFloat"),
                                               TLArg(!!newSource.vector2fValue, "IsVector2"));
 
-                            // Relocate the pointers to the copy of the input state within the actionset.
-                            const ActionSet& xrActionSet = *(ActionSet*)xrAction.actionSet;
-                            const auto relocatePointer = [&](void* pointer) {
-                                uint8_t* p = (uint8_t*)pointer;
-                                uint8_t* oldBase = (uint8_t*)&m_cachedInputState;
-                                uint8_t* newBase = (uint8_t*)&xrActionSet.cachedInputState;
+                            // The pointers reference the live input state, and they are relocated to the
+                            // actionset's input snapshot by the xrGetActionState*() functions.
+                            actionSources.insert_or_assign(sourcePath, newSource);
+                        }
+                    }
+                }
+            }
+        }
 
-                                return newBase + (p - oldBase);
-                            };
-                            newSource.buttonMap = (uint32_t*)relocatePointer((void*)newSource.buttonMap);
-                            newSource.floatValue = (float*)relocatePointer((void*)newSource.floatValue);
-                            newSource.vector2fValue = (pvrVector2f*)relocatePointer((void*)newSource.vector2fValue);
+        // Compile the flat lists of sources for both controllers, since they reference the new map, and publish them.
+        for (const auto& action : m_actions) {
+            Action& xrAction = *m_actions.get(action);
+            if (!xrAction.pendingBindings) {
+                continue;
+            }
 
-                            xrAction.actionSources.insert_or_assign(sourcePath, newSource);
-                        }
+            auto& bindings = *xrAction.pendingBindings;
+            for (const auto& source : bindings.actionSources) {
+                const int sourceSide = getActionSide(source.first);
+                if (sourceSide >= 0) {
+                    bindings.boundSources[sourceSide].push_back({&source.first, &source.second});
+                    if (endsWith(source.first, "/output/haptic")) {
+                        bindings.hasHapticOutput[sourceSide] = true;
                     }
                 }
             }
+            xrAction.bindings.publish(std::move(xrAction.pendingBindings));
         }
 
         TraceLoggingWrite(g_traceProvider,
@@ -1419,9 +1640,9 @@ namespace pimax_openxr {
             CHECK_XRCMD(
                 xrStringToPath(XR_NULL_HANDLE, actualInteractionProfile.c_str(), &m_currentInteractionProfile[side]));
 
-            auto adjustedGripPose = Pose::Multiply(m_controllerGripOffset, gripPose);
-            auto adjustedAimPose = Pose::Multiply(m_controllerAimOffset, aimPose);
-            auto adjustedHandPose = Pose::Multiply(m_controllerHandOffset, handPose);
+            auto adjustedGripPose = Pose::Multiply(settings.controllerGripOffset, gripPose);
+            auto adjustedAimPose = Pose::Multiply(settings.controllerAimOffset, aimPose);
+            auto adjustedHandPose = Pose::Multiply(settings.controllerHandOffset, handPose);
             if (side == 1) {
                 const auto flipHandedness = [&](XrPosef& pose) {
                     // Mirror pose along the X axis.
@@ -1446,19 +1667,44 @@ namespace pimax_openxr {
         m_currentInteractionProfileDirty =
             m_currentInteractionProfileDirty ||
             (m_currentInteractionProfile[side] != prevInterationProfile && !m_activeActionSets.empty());
+
+        // Resolve the action spaces against the new bindings.
+        for (const auto& space : m_spaces) {
+            Space& xrSpace = *m_spaces.get(space);
+            if (xrSpace.action) {
+                resolveActionSpace(xrSpace);
+            }
+        }
     }
 
-    std::string OpenXrRuntime::getXrPath(XrPath path) const {
+    const std::string& OpenXrRuntime::getXrPath(XrPath path) const {
+        static const std::string empty;
+        static const std::string unknown = "<unknown>";
+
         if (path == XR_NULL_PATH) {
-            return "";
+            return empty;
         }
 
-        const auto it = m_strings.find(path);
-        if (it == m_strings.cend()) {
-            return "<unknown>";
+        const auto entry = m_strings.get(path);
+        if (!entry) {
+            return unknown;
+        }
+
+        return *entry;
+    }
+
+    // Returns the [first, last) range of hands covered by a subaction path.
+    std::pair<int, int> OpenXrRuntime::getSubactionSideRange(XrPath subactionPath) const {
+        if (subactionPath == XR_NULL_PATH) {
+            return {0, 2};
+        } else if (subactionPath == m_handPaths[0]) {
+            return {0, 1};
+        } else if (subactionPath == m_handPaths[1]) {
+            return {1, 2};
         }
 
-        return it->second;
+        // We only support hands paths, not gamepad etc.
+        return {0, 0};
     }
 
     int OpenXrRuntime::getActionSide(const std::string& fullPath, bool allowExtraPaths) const {
@@ -1466,7 +1712,8 @@ namespace pimax_openxr {
             return 0;
         } else if (startsWith(fullPath, "/user/hand/right")) {
             return 1;
-        } else if (allowExtraPaths && (startsWith(fullPath, "/user/head") || startsWith(fullPath, "/user/gamepad"))) {
+        } else if (allowExtraPaths && (startsWith(fullPath, "/user/head") || startsWith(fullPath, "/user/gamepad") ||
+                                       startsWith(fullPath, "/user/eyes_ext"))) {
             return 2;
         }
 
@@ -1474,12 +1721,13 @@ namespace pimax_openxr {
     }
 
     XrVector2f OpenXrRuntime::handleJoystickDeadzone(pvrVector2f raw) const {
+        const float deadzone = currentSettings().joystickDeadzone;
         const float length = std::sqrt(raw.x * raw.x + raw.y * raw.y);
-        if (length < m_joystickDeadzone) {
+        if (length < deadzone) {
             return {0, 0};
         }
         XrVector2f normalizedInput{raw.x / length, raw.y / length};
-        const float scaling = (length - m_joystickDeadzone) / (1 - m_joystickDeadzone);
+        const float scaling = (length - deadzone) / (1 - deadzone);
         return {normalizedInput.x * scaling, normalizedInput.y * scaling};
     }
 
@@ -1493,7 +1741,7 @@ namespace pimax_openxr {
                 // Requires a 3 seconds press.
                 if (now - m_isRecenteringPressed.value() > 2.f) {
                     // Recenter view.
-                    CHECK_PVRCMD(pvr_recenterTrackingOrigin(m_pvrSession));
+                    recenterTrackingOrigin();
                 }
             } else {
                 m_isRecenteringPressed = now;
@@ -94,19 +94,21 @@ namespace pimax_openxr::appinsights {
     }
 
     AppInsights::~AppInsights() {
-        // Wait for all transactions to complete before cleanup.
-        int tries = 20;
-        while (tries && !m_inflight.empty()) {
-            tick();
-            std::this_thread::sleep_for(100ms);
-            tries--;
+        if (m_workerThread.joinable()) {
+            m_stopping = true;
+            curl_multi_wakeup(m_multiHandle);
+            m_workerThread.join();
         }
 
-        while (!m_pool.empty()) {
-            CURL* handle = m_pool.front();
-            m_pool.pop_front();
+        Event* event = m_pendingEvents.exchange(nullptr);
+        while (event) {
+            Event* next = event->next;
+            delete event;
+            event = next;
+        }
 
-            curl_easy_cleanup(handle);
+        if (m_handle) {
+            curl_easy_cleanup(m_handle);
         }
 
         if (m_headers) {
@@ -124,33 +126,46 @@ namespace pimax_openxr::appinsights {
         m_headers = curl_slist_append(m_headers, "Expect:");
         m_headers = curl_slist_append(m_headers, "Content-Type: application/json");
 
-        for (int i = 0; i < 10; i++) {
-            CURL* handle = curl_easy_init();
-            if (handle) {
-                // Initialize the common parameters for the transaction.
-                curl_easy_setopt(handle, CURLOPT_URL, appInsightsUrl.c_str());
-                curl_easy_setopt(handle, CURLOPT_HTTPHEADER, m_headers);
-                curl_easy_setopt(handle, CURLOPT_CONNECTTIMEOUT, 5);
-                curl_easy_setopt(handle, CURLOPT_TIMEOUT, 5);
+        m_handle = curl_easy_init();
+        if (!m_multiHandle || !m_handle) {
+            return;
+        }
+
+        // Initialize the common parameters for the transactions.
+        curl_easy_setopt(m_handle, CURLOPT_URL, appInsightsUrl.c_str());
+        curl_easy_setopt(m_handle, CURLOPT_HTTPHEADER, m_headers);
+        curl_easy_setopt(m_handle, CURLOPT_CONNECTTIMEOUT, 5);
+        curl_easy_setopt(m_handle, CURLOPT_TIMEOUT, 5);
 
 #ifdef _DEBUG
-                curl_easy_setopt(handle, CURLOPT_DEBUGFUNCTION, curlTrace);
+        curl_easy_setopt(m_handle, CURLOPT_DEBUGFUNCTION, curlTrace);
 #endif
 
-                m_pool.push_back(handle);
-            }
-        }
-
         m_machineUuid = getMachineUuid();
+
+        // All network I/O (including DNS resolution and TLS handshakes) happens on the worker thread.
+        m_workerThread = std::thread([&]() { workerThread(); });
+        m_initialized = true;
     }
 
     void AppInsights::transact(const std::string& messageType, const std::string& data) {
+        if (!m_initialized) {
+            return;
+        }
+
+        // Drop the event when the worker is falling behind.
+        if (m_pendingEventsCount.fetch_add(1) >= k_maxPendingEvents) {
+            m_pendingEventsCount--;
+            return;
+        }
+
         // Format the message for Application Insights.
         const std::time_t now = std::time(nullptr);
         char iso8601[sizeof("0000-00-00T00:00:00Z")];
         strftime(iso8601, sizeof(iso8601), "%FT%TZ", gmtime(&now));
 
-        const auto document = fmt::format(R"_({{
+        Event* event = new Event;
+        event->document = fmt::format(R"_({{
   "name": "{}",
   "time": "{}",
   "iKey": "{}",
@@ -161,33 +176,92 @@ namespace pimax_openxr::appinsights {
     }}
   }}
 }})_",
-                                          messageType,
-                                          iso8601,
-                                          iKey,
-                                          messageType,
-                                          data);
-
-        {
-            std::unique_lock lock(m_poolLock);
-
-            // Try to get a transaction handle from the pool.
-            if (m_pool.empty()) {
-                // We drop this transaction.
-                return;
-            }
+                                      messageType,
+                                      iso8601,
+                                      iKey,
+                                      messageType,
+                                      data);
+
+        // Hand the event over to the worker thread.
+        event->next = m_pendingEvents.load();
+        while (!m_pendingEvents.compare_exchange_weak(event->next, event)) {
+        }
+    }
 
-            CURL* handle = m_pool.front();
-            m_pool.pop_front();
+    void AppInsights::workerThread() {
+        auto lastBatchTime = std::chrono::steady_clock::now() - k_batchInterval;
+        std::optional<std::chrono::steady_clock::time_point> stopDeadline;
+        while (true) {
+            const auto now = std::chrono::steady_clock::now();
 
-            curl_easy_setopt(handle, CURLOPT_COPYPOSTFIELDS, document.c_str());
+            // Upon shutdown, flush the pending events and give the last transaction a chance to complete.
+            if (m_stopping && !stopDeadline) {
+                stopDeadline = now + 2s;
+            }
 
-            // Submit the transaction.
-            curl_multi_add_handle(m_multiHandle, handle);
+            // Process completion of the transaction.
             int running;
             curl_multi_perform(m_multiHandle, &running);
+            int msgLeft;
+            while (auto m = curl_multi_info_read(m_multiHandle, &msgLeft)) {
+                if (m && (m->msg == CURLMSG_DONE)) {
+                    DebugLog("Application Insight transaction result: %d\n", m->data.result);
+                    curl_multi_remove_handle(m_multiHandle, m->easy_handle);
+                    m_isInflight = false;
+                }
+            }
+
+            if (!m_isInflight && (stopDeadline || now - lastBatchTime >= k_batchInterval)) {
+                if (sendBatch()) {
+                    lastBatchTime = now;
+                } else if (stopDeadline) {
+                    break;
+                }
+            }
+
+            if (stopDeadline && now >= *stopDeadline) {
+                break;
+            }
 
-            m_inflight.insert(handle);
+            curl_multi_poll(m_multiHandle, nullptr, 0, 1000, nullptr);
         }
+
+        if (m_isInflight) {
+            curl_multi_remove_handle(m_multiHandle, m_handle);
+        }
+    }
+
+    // Submit all the pending events in a single request. Returns false when there was nothing to send.
+    bool AppInsights::sendBatch() {
+        Event* event = m_pendingEvents.exchange(nullptr);
+        if (!event) {
+            return false;
+        }
+
+        // The stack holds the most recent events first.
+        std::vector<std::string> documents;
+        while (event) {
+            Event* next = event->next;
+            documents.push_back(std::move(event->document));
+            delete event;
+            event = next;
+            m_pendingEventsCount--;
+        }
+
+        std::string batch = "[";
+        for (auto it = documents.rbegin(); it != documents.rend(); it++) {
+            if (it != documents.rbegin()) {
+                batch += ",";
+            }
+            batch += *it;
+        }
+        batch += "]";
+
+        curl_easy_setopt(m_handle, CURLOPT_COPYPOSTFIELDS, batch.c_str());
+        curl_multi_add_handle(m_multiHandle, m_handle);
+        m_isInflight = true;
+
+        return true;
     }
 
     void AppInsights::logMetric(const std::string& metric, double value) {
@@ -317,24 +391,6 @@ namespace pimax_openxr::appinsights {
         transact("MessageData", data);
     }
 
-    void AppInsights::tick() {
-        // Process completion of transactions.
-        std::unique_lock lock(m_poolLock);
-
-        int running;
-        curl_multi_perform(m_multiHandle, &running);
-        curl_multi_poll(m_multiHandle, NULL, 0, 0, NULL);
-
-        int msgLeft;
-        while (auto m = curl_multi_info_read(m_multiHandle, &msgLeft)) {
-            if (m && (m->msg == CURLMSG_DONE)) {
-                DebugLog("Application Insight transaction result: %d\n", m->data.result);
-                m_inflight.erase(m->easy_handle);
-                m_pool.push_back(m->easy_handle);
-            }
-        }
-    }
-
 #else
 
     AppInsights::AppInsights() {
@@ -374,9 +430,6 @@ namespace pimax_openxr::appinsights {
     void AppInsights::logError(const std::string& error) {
     }
 
-    void AppInsights::tick() {
-    }
-
 #endif
 
 } // namespace pimax_openxr::appinsights
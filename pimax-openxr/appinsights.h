@@ -44,18 +44,32 @@ namespace pimax_openxr::appinsights {
         void logProduct(const std::string& product);
         void logError(const std::string& error);
 
-        void tick();
-
       private:
 #ifndef NOCURL
+        // An event waiting to be sent by the worker thread, linked into a lock-free stack.
+        struct Event {
+            Event* next;
+            std::string document;
+        };
+
         void transact(const std::string& messageType, const std::string& data);
+        void workerThread();
+        bool sendBatch();
 
-        CURLM* m_multiHandle{nullptr};
-        
-        std::mutex m_poolLock;
-        std::deque<CURL*> m_pool;
-        std::set<CURL*> m_inflight;
+        // Events are batched into a single request, at most once per interval.
+        static constexpr auto k_batchInterval = 10s;
+        static constexpr uint32_t k_maxPendingEvents = 100;
 
+        std::atomic<bool> m_initialized{false};
+        std::atomic<bool> m_stopping{false};
+        std::atomic<Event*> m_pendingEvents{nullptr};
+        std::atomic<uint32_t> m_pendingEventsCount{0};
+        std::thread m_workerThread;
+
+        // Owned by the worker thread.
+        CURLM* m_multiHandle{nullptr};
+        CURL* m_handle{nullptr};
+        bool m_isInflight{false};
         struct curl_slist* m_headers{nullptr};
 
         std::string m_applicationName;
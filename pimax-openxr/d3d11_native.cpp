@@ -26,68 +26,73 @@
 #include "runtime.h"
 #include "utils.h"
 
+// Precompiled compute shaders.
+#include "AlphaCorrectArrayCS.h"
+#include "AlphaCorrectCS.h"
+#include "AlphaCorrectStereoCS.h"
+#include "CantedReprojectCS.h"
+#include "DepthConvertArrayCS.h"
+#include "DepthConvertArrayMSCS.h"
+#include "DepthConvertCS.h"
+#include "DepthConvertMSCS.h"
+#include "DepthConvertStereoCS.h"
+#include "DepthConvertStereoMSCS.h"
+#include "FlattenQuadsCS.h"
+#include "QuadViewsCS.h"
+
 // Implements native support to submit swapchains to PVR.
 // Implements the necessary support for the XR_KHR_D3D11_enable extension:
 // https://www.khronos.org/registry/OpenXR/specs/1.0/html/xrspec.html#XR_KHR_D3D11_enable
 
 namespace {
 
-    // Compute shaders for converting D32_S8 to D32 depth formats.
-    // Only keep the depth component.
-    const std::string_view DepthConvertShaderHlsl =
-        R"_(
-Texture2D in_texture : register(t0);
-Texture2DArray in_texture_array : register(t0);
-RWTexture2D<float> out_texture : register(u0);
-
-[numthreads(8, 8, 1)]
-void main(uint2 pos : SV_DispatchThreadID)
-{
-    out_texture[pos] = in_texture[pos].x;
-}
-
-[numthreads(8, 8, 1)]
-void mainForArray(uint2 pos : SV_DispatchThreadID)
-{
-    out_texture[pos] = in_texture_array[float3(pos, 0)].x;
-}
-    )_";
-
-    // Compute shaders for correcting alpha channel.
-    // Clear the alpha channel or premultiply each component.
-    const std::string_view AlphaCorrectShaderHlsl =
-        R"_(
-cbuffer config : register(b0) {
-    int mode; // bit 0 = clear alpha, bit 1 = premultiply alpha.
-};
-Texture2D in_texture : register(t0);
-Texture2DArray in_texture_array : register(t0);
-RWTexture2D<float4> out_texture : register(u0);
-
-float4 processAlpha(float4 input)
-{
-    float4 output = input;
-    if (mode & 1) {
-      output.a = 1;
-    }
-    if (mode & 2) {
-      output.rgb = output.rgb * output.a;
-    }
-    return output;
-}
-
-[numthreads(8, 8, 1)]
-void main(uint2 pos : SV_DispatchThreadID)
-{
-    out_texture[pos] = processAlpha(in_texture[pos]);
-}
-
-[numthreads(8, 8, 1)]
-void mainForArray(uint2 pos : SV_DispatchThreadID)
-{
-    out_texture[pos] = processAlpha(in_texture_array[float3(pos, 0)]);
-}
-    )_";
+    // Must match the layout of the config cbuffer in Region.hlsli.
+    struct ConvertConstants {
+        int32_t offset[2];
+        int32_t extent[2];
+        uint32_t mode;
+        uint32_t tileMask;
+        uint32_t padding[2];
+    };
+    static_assert(sizeof(ConvertConstants) % 16 == 0);
+
+    // Must match the layout of the focus cbuffer in QuadViewsCS.hlsl.
+    struct QuadViewsConstants {
+        float focusScale[2];
+        float focusBias[2];
+        float focusTexScale[2];
+        float focusTexBias[2];
+        float blendWidth;
+        float padding[3];
+    };
+    static_assert(sizeof(QuadViewsConstants) % 16 == 0);
+
+    // Must match the layout of the canted cbuffer in CantedReprojectCS.hlsl.
+    struct CantedReprojectionConstants {
+        float cantedScale[2];
+        float cantedBias[2];
+        float parallelScale[2];
+        float parallelBias[2];
+        float sinAngle;
+        float cosAngle;
+        float padding[2];
+    };
+    static_assert(sizeof(CantedReprojectionConstants) % 16 == 0);
+
+    // Must match the layout of the quads cbuffer in FlattenQuadsCS.hlsl.
+    struct FlattenQuadsConstants {
+        struct {
+            float scale[2];
+            float bias[2];
+            float texScale[2];
+            float texBias[2];
+            uint32_t mode;
+            uint32_t padding[3];
+        } quads[8];
+        uint32_t quadCount;
+        uint32_t padding[3];
+    };
+    static_assert(sizeof(FlattenQuadsConstants) % 16 == 0);
 
     DXGI_FORMAT getTypelessFormat(DXGI_FORMAT format) {
         switch (format) {
@@ -205,15 +210,42 @@ namespace pimax_openxr {
         d3dBindings.device->GetImmediateContext(deviceContext.ReleaseAndGetAddressOf());
         CHECK_HRCMD(deviceContext->QueryInterface(m_d3d11Context.ReleaseAndGetAddressOf()));
 
+        // Optionally hand the application device to PVR directly, which requires the device to allow multithreaded
+        // access.
+        m_useSingleDeviceSubmission = getSetting("single_device_submission").value_or(0);
+        if (m_useSingleDeviceSubmission && (m_d3d11Device->GetCreationFlags() & D3D11_CREATE_DEVICE_SINGLETHREADED)) {
+            Log("Single-device submission is not possible with a single-threaded device\n");
+            m_useSingleDeviceSubmission = false;
+        }
+        if (m_useSingleDeviceSubmission && currentSettings().useMirrorWindow) {
+            Log("The mirror window is disabled with single-device submission\n");
+        }
+
         // Create the resources that PVR will be using.
         initializeSubmissionDevice("D3D11");
 
-        // We will use a shared fence to synchronize between the application context and the PVR (submission) context
-        // context.
-        wil::unique_handle fenceHandle;
-        CHECK_HRCMD(m_pvrSubmissionFence->CreateSharedHandle(nullptr, GENERIC_ALL, nullptr, fenceHandle.put()));
-        CHECK_HRCMD(
-            m_d3d11Device->OpenSharedFence(fenceHandle.get(), IID_PPV_ARGS(m_d3d11Fence.ReleaseAndGetAddressOf())));
+        if (!m_useSingleDeviceSubmission) {
+            // We will use a shared fence to synchronize between the application context and the PVR (submission)
+            // context.
+            wil::unique_handle fenceHandle;
+            CHECK_HRCMD(m_pvrSubmissionFence->CreateSharedHandle(nullptr, GENERIC_ALL, nullptr, fenceHandle.put()));
+            CHECK_HRCMD(m_d3d11Device->OpenSharedFence(fenceHandle.get(),
+                                                       IID_PPV_ARGS(m_d3d11Fence.ReleaseAndGetAddressOf())));
+        } else {
+            // Both contexts are the same, and so is the fence.
+            m_d3d11Fence = m_pvrSubmissionFence;
+
+            // The runtime uses its own pipeline state, so that the state of the application context is preserved
+            // through xrEndFrame().
+            const D3D_FEATURE_LEVEL featureLevel = m_d3d11Device->GetFeatureLevel();
+            CHECK_HRCMD(m_d3d11Device->CreateDeviceContextState(0,
+                                                                &featureLevel,
+                                                                1,
+                                                                D3D11_SDK_VERSION,
+                                                                __uuidof(ID3D11Device1),
+                                                                nullptr,
+                                                                m_submissionContextState.ReleaseAndGetAddressOf()));
+        }
 
         // Frame timers.
         for (uint32_t i = 0; i < k_numGpuTimers; i++) {
@@ -253,77 +285,150 @@ namespace pimax_openxr {
             }
         }
 
-        // Create the submission device that PVR will be using.
-        ComPtr<ID3D11Device> device;
-        ComPtr<ID3D11DeviceContext> deviceContext;
-        D3D_FEATURE_LEVEL featureLevel = D3D_FEATURE_LEVEL_11_0;
-        UINT flags = D3D11_CREATE_DEVICE_BGRA_SUPPORT;
+        if (!m_useSingleDeviceSubmission) {
+            // Create the submission device that PVR will be using.
+            ComPtr<ID3D11Device> device;
+            ComPtr<ID3D11DeviceContext> deviceContext;
+            D3D_FEATURE_LEVEL featureLevel = D3D_FEATURE_LEVEL_11_0;
+            UINT flags = D3D11_CREATE_DEVICE_BGRA_SUPPORT;
 #ifdef _DEBUG
-        flags |= D3D11_CREATE_DEVICE_DEBUG;
+            flags |= D3D11_CREATE_DEVICE_DEBUG;
 #endif
-        CHECK_HRCMD(D3D11CreateDevice(dxgiAdapter.Get(),
-                                      D3D_DRIVER_TYPE_UNKNOWN,
-                                      0,
-                                      flags,
-                                      &featureLevel,
-                                      1,
-                                      D3D11_SDK_VERSION,
-                                      device.ReleaseAndGetAddressOf(),
-                                      nullptr,
-                                      deviceContext.ReleaseAndGetAddressOf()));
-
-        // Query the necessary flavors of device & device context, which will let use use fences.
-        CHECK_HRCMD(device->QueryInterface(m_pvrSubmissionDevice.ReleaseAndGetAddressOf()));
-        CHECK_HRCMD(deviceContext->QueryInterface(m_pvrSubmissionContext.ReleaseAndGetAddressOf()));
+            CHECK_HRCMD(D3D11CreateDevice(dxgiAdapter.Get(),
+                                          D3D_DRIVER_TYPE_UNKNOWN,
+                                          0,
+                                          flags,
+                                          &featureLevel,
+                                          1,
+                                          D3D11_SDK_VERSION,
+                                          device.ReleaseAndGetAddressOf(),
+                                          nullptr,
+                                          deviceContext.ReleaseAndGetAddressOf()));
+
+            // Query the necessary flavors of device & device context, which will let use use fences.
+            CHECK_HRCMD(device->QueryInterface(m_pvrSubmissionDevice.ReleaseAndGetAddressOf()));
+            CHECK_HRCMD(deviceContext->QueryInterface(m_pvrSubmissionContext.ReleaseAndGetAddressOf()));
+        } else {
+            // Submit directly on the application device.
+            m_pvrSubmissionDevice = m_d3d11Device;
+            m_pvrSubmissionContext = m_d3d11Context;
+            Log("Using single-device submission\n");
+        }
 
         ComPtr<IDXGIDevice> dxgiDevice;
-        CHECK_HRCMD(device->QueryInterface(IID_PPV_ARGS(dxgiDevice.ReleaseAndGetAddressOf())));
+        CHECK_HRCMD(m_pvrSubmissionDevice->QueryInterface(IID_PPV_ARGS(dxgiDevice.ReleaseAndGetAddressOf())));
 
         // Create the synchronization fence to serialize work between the application device and submission device.
+        // With single-device submission, it is only used by the flush*() methods and to retire swapchains.
         CHECK_HRCMD(m_pvrSubmissionDevice->CreateFence(
             0, D3D11_FENCE_FLAG_SHARED, IID_PPV_ARGS(m_pvrSubmissionFence.ReleaseAndGetAddressOf())));
         m_fenceValue = 0;
 
-        // Create the resources for depth conversion and alpha correction.
-        const auto compileShader =
-            [&](const std::string_view& code, const std::string_view& entry, ID3D11ComputeShader** shader) {
-                ComPtr<ID3DBlob> shaderBytes;
-                ComPtr<ID3DBlob> errMsgs;
-                DWORD flags = D3DCOMPILE_ENABLE_STRICTNESS | D3DCOMPILE_WARNINGS_ARE_ERRORS;
-#ifdef _DEBUG
-                flags |= D3DCOMPILE_SKIP_OPTIMIZATION | D3DCOMPILE_DEBUG;
-#else
-                flags |= D3DCOMPILE_OPTIMIZATION_LEVEL3;
-#endif
+        // The event used by the flush*() methods to wait for the fence on the CPU.
+        *m_fenceEvent.put() = CreateEventEx(nullptr, L"Flush Fence", 0, EVENT_MODIFY_STATE | SYNCHRONIZE);
+        CHECK_MSG(m_fenceEvent, "Failed to CreateEventEx()");
 
-                const HRESULT hr = D3DCompile(code.data(),
-                                              code.size(),
-                                              nullptr,
-                                              nullptr,
-                                              nullptr,
-                                              entry.data(),
-                                              "cs_5_0",
-                                              flags,
-                                              0,
-                                              shaderBytes.ReleaseAndGetAddressOf(),
-                                              errMsgs.ReleaseAndGetAddressOf());
-                if (FAILED(hr)) {
-                    std::string errMsg((const char*)errMsgs->GetBufferPointer(), errMsgs->GetBufferSize());
-                    ErrorLog("D3DCompile failed %X: %s\n", hr, errMsg.c_str());
-                    CHECK_HRESULT(hr, "D3DCompile failed");
-                }
-                CHECK_HRCMD(m_pvrSubmissionDevice->CreateComputeShader(
-                    shaderBytes->GetBufferPointer(), shaderBytes->GetBufferSize(), nullptr, shader));
-            };
-
-        compileShader(DepthConvertShaderHlsl, "main", m_depthConvertShader[0].ReleaseAndGetAddressOf());
+        // Create the resources for depth conversion and alpha correction.
+        // 0: shader for Tex2D, 1: shader for Tex2DArray, 2: shader for both slices of a stereo Tex2DArray.
+        // For depth conversion, 3-5: same as 0-2 for multisampled textures (resolving the depth).
+        CHECK_HRCMD(m_pvrSubmissionDevice->CreateComputeShader(
+            g_DepthConvertCS, sizeof(g_DepthConvertCS), nullptr, m_depthConvertShader[0].ReleaseAndGetAddressOf()));
         setDebugName(m_depthConvertShader[0].Get(), "DepthConvert CS");
-        compileShader(DepthConvertShaderHlsl, "main", m_depthConvertShader[1].ReleaseAndGetAddressOf());
-        setDebugName(m_depthConvertShader[1].Get(), "DepthConvert CS");
-        compileShader(AlphaCorrectShaderHlsl, "mainForArray", m_alphaCorrectShader[0].ReleaseAndGetAddressOf());
+        CHECK_HRCMD(m_pvrSubmissionDevice->CreateComputeShader(g_DepthConvertArrayCS,
+                                                               sizeof(g_DepthConvertArrayCS),
+                                                               nullptr,
+                                                               m_depthConvertShader[1].ReleaseAndGetAddressOf()));
+        setDebugName(m_depthConvertShader[1].Get(), "DepthConvert Array CS");
+        CHECK_HRCMD(m_pvrSubmissionDevice->CreateComputeShader(g_DepthConvertStereoCS,
+                                                               sizeof(g_DepthConvertStereoCS),
+                                                               nullptr,
+                                                               m_depthConvertShader[2].ReleaseAndGetAddressOf()));
+        setDebugName(m_depthConvertShader[2].Get(), "DepthConvert Stereo CS");
+        CHECK_HRCMD(m_pvrSubmissionDevice->CreateComputeShader(
+            g_DepthConvertMSCS, sizeof(g_DepthConvertMSCS), nullptr, m_depthConvertShader[3].ReleaseAndGetAddressOf()));
+        setDebugName(m_depthConvertShader[3].Get(), "DepthConvert MS CS");
+        CHECK_HRCMD(m_pvrSubmissionDevice->CreateComputeShader(g_DepthConvertArrayMSCS,
+                                                               sizeof(g_DepthConvertArrayMSCS),
+                                                               nullptr,
+                                                               m_depthConvertShader[4].ReleaseAndGetAddressOf()));
+        setDebugName(m_depthConvertShader[4].Get(), "DepthConvert Array MS CS");
+        CHECK_HRCMD(m_pvrSubmissionDevice->CreateComputeShader(g_DepthConvertStereoMSCS,
+                                                               sizeof(g_DepthConvertStereoMSCS),
+                                                               nullptr,
+                                                               m_depthConvertShader[5].ReleaseAndGetAddressOf()));
+        setDebugName(m_depthConvertShader[5].Get(), "DepthConvert Stereo MS CS");
+        CHECK_HRCMD(m_pvrSubmissionDevice->CreateComputeShader(
+            g_AlphaCorrectCS, sizeof(g_AlphaCorrectCS), nullptr, m_alphaCorrectShader[0].ReleaseAndGetAddressOf()));
         setDebugName(m_alphaCorrectShader[0].Get(), "AlphaCorrect CS");
-        compileShader(AlphaCorrectShaderHlsl, "mainForArray", m_alphaCorrectShader[1].ReleaseAndGetAddressOf());
-        setDebugName(m_alphaCorrectShader[1].Get(), "AlphaCorrect CS");
+        CHECK_HRCMD(m_pvrSubmissionDevice->CreateComputeShader(g_AlphaCorrectArrayCS,
+                                                               sizeof(g_AlphaCorrectArrayCS),
+                                                               nullptr,
+                                                               m_alphaCorrectShader[1].ReleaseAndGetAddressOf()));
+        setDebugName(m_alphaCorrectShader[1].Get(), "AlphaCorrect Array CS");
+        CHECK_HRCMD(m_pvrSubmissionDevice->CreateComputeShader(g_AlphaCorrectStereoCS,
+                                                               sizeof(g_AlphaCorrectStereoCS),
+                                                               nullptr,
+                                                               m_alphaCorrectShader[2].ReleaseAndGetAddressOf()));
+        setDebugName(m_alphaCorrectShader[2].Get(), "AlphaCorrect Stereo CS");
+
+        // Create the resources for compositing quad views.
+        CHECK_HRCMD(m_pvrSubmissionDevice->CreateComputeShader(
+            g_QuadViewsCS, sizeof(g_QuadViewsCS), nullptr, m_quadViewsShader.ReleaseAndGetAddressOf()));
+        setDebugName(m_quadViewsShader.Get(), "QuadViews CS");
+        {
+            D3D11_SAMPLER_DESC desc{};
+            desc.Filter = D3D11_FILTER_MIN_MAG_MIP_LINEAR;
+            desc.AddressU = desc.AddressV = desc.AddressW = D3D11_TEXTURE_ADDRESS_CLAMP;
+            desc.MaxLOD = D3D11_FLOAT32_MAX;
+            CHECK_HRCMD(
+                m_pvrSubmissionDevice->CreateSamplerState(&desc, m_linearClampSampler.ReleaseAndGetAddressOf()));
+            setDebugName(m_linearClampSampler.Get(), "Linear Clamp Sampler");
+        }
+        {
+            const UINT sizes[] = {sizeof(ConvertConstants), sizeof(QuadViewsConstants)};
+            for (uint32_t i = 0; i < ARRAYSIZE(m_quadViewsConstants); i++) {
+                D3D11_BUFFER_DESC desc{};
+                desc.ByteWidth = sizes[i];
+                desc.BindFlags = D3D11_BIND_CONSTANT_BUFFER;
+                desc.Usage = D3D11_USAGE_DYNAMIC;
+                desc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+                CHECK_HRCMD(m_pvrSubmissionDevice->CreateBuffer(
+                    &desc, nullptr, m_quadViewsConstants[i].ReleaseAndGetAddressOf()));
+                setDebugName(m_quadViewsConstants[i].Get(), fmt::format("QuadViews Constants[{}]", i));
+            }
+        }
+
+        // Create the resources for flattening quad layers.
+        CHECK_HRCMD(m_pvrSubmissionDevice->CreateComputeShader(
+            g_FlattenQuadsCS, sizeof(g_FlattenQuadsCS), nullptr, m_flattenQuadsShader.ReleaseAndGetAddressOf()));
+        setDebugName(m_flattenQuadsShader.Get(), "FlattenQuads CS");
+        {
+            D3D11_BUFFER_DESC desc{};
+            desc.ByteWidth = sizeof(FlattenQuadsConstants);
+            desc.BindFlags = D3D11_BIND_CONSTANT_BUFFER;
+            desc.Usage = D3D11_USAGE_DYNAMIC;
+            desc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+            CHECK_HRCMD(
+                m_pvrSubmissionDevice->CreateBuffer(&desc, nullptr, m_flattenQuadsConstants.ReleaseAndGetAddressOf()));
+            setDebugName(m_flattenQuadsConstants.Get(), "FlattenQuads Constants");
+        }
+
+        // Create the resources for reprojecting parallel projection views onto the canted views.
+        CHECK_HRCMD(m_pvrSubmissionDevice->CreateComputeShader(g_CantedReprojectCS,
+                                                               sizeof(g_CantedReprojectCS),
+                                                               nullptr,
+                                                               m_cantedReprojectionShader.ReleaseAndGetAddressOf()));
+        setDebugName(m_cantedReprojectionShader.Get(), "CantedReproject CS");
+        {
+            D3D11_BUFFER_DESC desc{};
+            desc.ByteWidth = sizeof(CantedReprojectionConstants);
+            desc.BindFlags = D3D11_BIND_CONSTANT_BUFFER;
+            desc.Usage = D3D11_USAGE_DYNAMIC;
+            desc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+            CHECK_HRCMD(m_pvrSubmissionDevice->CreateBuffer(
+                &desc, nullptr, m_cantedReprojectionConstants.ReleaseAndGetAddressOf()));
+            setDebugName(m_cantedReprojectionConstants.Get(), "CantedReprojection Constants");
+        }
 
         for (uint32_t i = 0; i < k_numGpuTimers; i++) {
             m_gpuTimerPrecomposition[i] =
@@ -362,8 +467,12 @@ namespace pimax_openxr {
             m_gpuTimerApp[i].reset();
         }
 
+        m_d3d11Fence.Reset();
+        m_savedAppContextState.Reset();
+        m_submissionContextState.Reset();
         m_d3d11Context.Reset();
         m_d3d11Device.Reset();
+        m_useSingleDeviceSubmission = false;
     }
 
     void OpenXrRuntime::cleanupSubmissionDevice() {
@@ -376,28 +485,54 @@ namespace pimax_openxr {
         m_dxgiSwapchain.Reset();
         for (int i = 0; i < ARRAYSIZE(m_depthConvertShader); i++) {
             m_depthConvertShader[i].Reset();
+        }
+        for (int i = 0; i < ARRAYSIZE(m_alphaCorrectShader); i++) {
             m_alphaCorrectShader[i].Reset();
         }
+        m_quadViewsShader.Reset();
+        m_linearClampSampler.Reset();
+        for (int i = 0; i < ARRAYSIZE(m_quadViewsConstants); i++) {
+            m_quadViewsConstants[i].Reset();
+        }
+        m_flattenQuadsShader.Reset();
+        m_flattenQuadsConstants.Reset();
+        m_cantedReprojectionShader.Reset();
+        m_cantedReprojectionConstants.Reset();
+        m_tileMaskResourceView.Reset();
+        m_tileMaskTexture.Reset();
+        for (uint32_t i = 0; i < xr::StereoView::Count; i++) {
+            m_tileMasks[i].valid = false;
+        }
 
         m_pvrSubmissionFence.Reset();
+        m_fenceEvent.reset();
         m_pvrSubmissionContext.Reset();
         m_pvrSubmissionDevice.Reset();
     }
 
+    // Whether the submission device can do typed UAV stores to a texture of the given format.
+    bool OpenXrRuntime::isUnorderedAccessSupported(DXGI_FORMAT format) const {
+        D3D11_FEATURE_DATA_FORMAT_SUPPORT2 formatSupport{};
+        formatSupport.InFormat = getNonSRGBFormat(format);
+        if (FAILED(m_pvrSubmissionDevice->CheckFeatureSupport(
+                D3D11_FEATURE_FORMAT_SUPPORT2, &formatSupport, sizeof(formatSupport)))) {
+            return false;
+        }
+        return formatSupport.OutFormatSupport2 & D3D11_FORMAT_SUPPORT2_UAV_TYPED_STORE;
+    }
+
     // Retrieve generic handles to the swapchain images to import into the application device.
     std::vector<HANDLE> OpenXrRuntime::getSwapchainImages(Swapchain& xrSwapchain) {
         // Detect whether this is the first call for this swapchain.
         const bool initialized = !xrSwapchain.slices[0].empty();
 
-        // PVR does not properly support certain depth format, and we will need an intermediate texture for the
-        // app to use, then perform additional conversion steps during xrEndFrame().
+        // PVR does not properly support certain depth format nor multisampling, and we will need an intermediate
+        // texture for the app to use, then perform additional conversion or resolve steps during xrEndFrame().
+        const bool useIntermediate = xrSwapchain.needDepthConvert || xrSwapchain.needDownsample;
         D3D11_TEXTURE2D_DESC desc{};
-        if (!initialized && xrSwapchain.needDepthConvert) {
-            // FIXME: Today we only do convert from D32_FLOAT_S8X24 to D32_FLOAT, so we hard-code the
-            // corresponding formats below.
-
+        if (!initialized && useIntermediate) {
             desc.ArraySize = xrSwapchain.xrDesc.arraySize;
-            desc.Format = DXGI_FORMAT_R32G8X24_TYPELESS;
+            desc.Format = getTypelessFormat(xrSwapchain.dxgiFormatForSubmission);
             desc.Width = xrSwapchain.xrDesc.width;
             desc.Height = xrSwapchain.xrDesc.height;
             desc.MipLevels = xrSwapchain.xrDesc.mipCount;
@@ -427,8 +562,11 @@ namespace pimax_openxr {
         for (int i = 0; i < xrSwapchain.pvrSwapchainLength; i++) {
             if (!initialized) {
                 ID3D11Texture2D* swapchainTexture;
-                CHECK_PVRCMD(pvr_getTextureSwapChainBufferDX(
-                    m_pvrSession, xrSwapchain.pvrSwapchain[0], i, IID_PPV_ARGS(&swapchainTexture)));
+                {
+                    std::unique_lock pvrLock(m_pvrLock);
+                    CHECK_PVRCMD(pvr_getTextureSwapChainBufferDX(
+                        m_pvrSession, xrSwapchain.pvrSwapchain[0], i, IID_PPV_ARGS(&swapchainTexture)));
+                }
                 setDebugName(swapchainTexture, fmt::format("PVR Swapchain Texture[{}, {}]", i, (void*)&xrSwapchain));
 
                 xrSwapchain.slices[0].push_back(swapchainTexture);
@@ -451,7 +589,7 @@ namespace pimax_openxr {
                                       TLArg(desc.MiscFlags, "MiscFlags"));
                 }
 
-                if (xrSwapchain.needDepthConvert) {
+                if (useIntermediate) {
                     // Create the intermediate texture if needed.
                     ComPtr<ID3D11Texture2D> intermediateTexture;
                     CHECK_HRCMD(m_pvrSubmissionDevice->CreateTexture2D(
@@ -465,10 +603,16 @@ namespace pimax_openxr {
                 for (uint32_t i = 0; i < xrSwapchain.xrDesc.arraySize; i++) {
                     xrSwapchain.imagesResourceView[i].push_back({});
                 }
+                xrSwapchain.imagesStereoResourceView.push_back({});
+            }
+
+            // With single-device submission, the application uses the textures directly.
+            if (m_useSingleDeviceSubmission) {
+                continue;
             }
 
             // Export the HANDLE.
-            const auto texture = !xrSwapchain.needDepthConvert ? xrSwapchain.slices[0][i] : xrSwapchain.images[i].Get();
+            const auto texture = !useIntermediate ? xrSwapchain.slices[0][i] : xrSwapchain.images[i].Get();
 
             ComPtr<IDXGIResource1> dxgiResource;
             CHECK_HRCMD(texture->QueryInterface(IID_PPV_ARGS(dxgiResource.ReleaseAndGetAddressOf())));
@@ -501,7 +645,12 @@ namespace pimax_openxr {
                 return XR_ERROR_VALIDATION_FAILURE;
             }
 
-            if (!initialized) {
+            if (!initialized && m_useSingleDeviceSubmission) {
+                // The submission device is the application device: there is nothing to import.
+                const bool useIntermediate = xrSwapchain.needDepthConvert || xrSwapchain.needDownsample;
+                xrSwapchain.d3d11Images.push_back(useIntermediate ? xrSwapchain.images[i].Get()
+                                                                  : xrSwapchain.slices[0][i]);
+            } else if (!initialized) {
                 // Create an imported texture on the application device.
                 ComPtr<ID3D11Texture2D> d3d11Texture;
                 CHECK_HRCMD(m_d3d11Device->OpenSharedResource(textureHandles[i],
@@ -547,50 +696,110 @@ namespace pimax_openxr {
                                                   uint32_t layerIndex,
                                                   uint32_t slice,
                                                   XrCompositionLayerFlags compositionFlags,
-                                                  std::set<std::pair<pvrTextureSwapChain, uint32_t>>& committed) const {
+                                                  const SwapchainRegions& regions,
+                                                  CommittedSwapchainImages& committed) {
         // If the texture was never used or already committed, do nothing.
         if (xrSwapchain.slices[0].empty() || committed.count(std::make_pair(xrSwapchain.pvrSwapchain[0], slice))) {
             return;
         }
 
-        // Ensure necessary resources for texture arrays: lazily create a second swapchain for this slice of the array.
-        if (!xrSwapchain.pvrSwapchain[slice]) {
-            auto desc = xrSwapchain.pvrDesc;
-            desc.ArraySize = 1;
-            CHECK_PVRCMD(pvr_createTextureSwapChainDX(
-                m_pvrSession, m_pvrSubmissionDevice.Get(), &desc, &xrSwapchain.pvrSwapchain[slice]));
-
-            int count = -1;
-            CHECK_PVRCMD(pvr_getTextureSwapChainLength(m_pvrSession, xrSwapchain.pvrSwapchain[slice], &count));
-            if (count != xrSwapchain.slices[0].size()) {
-                throw std::runtime_error("Swapchain image count mismatch");
-            }
-
-            // Query the textures for the swapchain.
-            for (int i = 0; i < count; i++) {
-                ID3D11Texture2D* texture = nullptr;
-                CHECK_PVRCMD(pvr_getTextureSwapChainBufferDX(
-                    m_pvrSession, xrSwapchain.pvrSwapchain[slice], i, IID_PPV_ARGS(&texture)));
-                setDebugName(texture, fmt::format("Runtime Sliced Texture[{}, {}, {}]", slice, i, (void*)&xrSwapchain));
-
-                xrSwapchain.slices[slice].push_back(texture);
+        const auto getRegion = [&](uint32_t s) -> const SwapchainRegion* {
+            for (const auto& region : regions) {
+                if (region.swapchain == &xrSwapchain && region.slice == s) {
+                    return &region;
+                }
             }
-        }
+            return nullptr;
+        };
 
-        int pvrDestIndex = -1;
-        CHECK_PVRCMD(pvr_getTextureSwapChainCurrentIndex(m_pvrSession, xrSwapchain.pvrSwapchain[slice], &pvrDestIndex));
         const int lastReleasedIndex = xrSwapchain.lastReleasedIndex;
 
-        const bool needCopy = xrSwapchain.lastProcessedIndex == lastReleasedIndex;
+        // Multisampled images are resolved again rather than copied, since only the application's image is guaranteed
+        // to hold the content of the last released image.
+        const bool needCopy = !xrSwapchain.needDownsample && xrSwapchain.lastProcessedIndex == lastReleasedIndex;
         const bool needClearAlpha =
             layerIndex > 0 && !(compositionFlags & XR_COMPOSITION_LAYER_BLEND_TEXTURE_SOURCE_ALPHA_BIT);
         const bool needPremultiplyAlpha = (compositionFlags & XR_COMPOSITION_LAYER_UNPREMULTIPLIED_ALPHA_BIT);
+        const bool needProcessing = xrSwapchain.needDepthConvert || needClearAlpha || needPremultiplyAlpha;
+
+        // For stereo texture arrays where both slices are used this frame, process both slices with a single dispatch.
+        // This requires the second slice to be written directly, so that only slice 0 may need the resolved texture.
+        const uint32_t otherSlice = slice ^ 1;
+        const bool processStereo = !needCopy && needProcessing && xrSwapchain.xrDesc.arraySize == 2 &&
+                                   xrSwapchain.canWriteDirectly && getRegion(otherSlice) &&
+                                   !committed.count(std::make_pair(xrSwapchain.pvrSwapchain[0], otherSlice));
+        const uint32_t firstSlice = processStereo ? 0 : slice;
+        const uint32_t sliceCount = processStereo ? 2 : 1;
+
+        int pvrDestIndex[2] = {-1, -1};
+        for (uint32_t i = 0; i < sliceCount; i++) {
+            const uint32_t s = firstSlice + i;
+
+            // Ensure necessary resources for texture arrays: lazily create a second swapchain for this slice of the
+            // array.
+            if (!xrSwapchain.pvrSwapchain[s]) {
+                auto desc = xrSwapchain.pvrDesc;
+                desc.ArraySize = 1;
+                if (xrSwapchain.canWriteDirectly) {
+                    desc.BindFlags |= pvrTextureBind_DX_UnorderedAccess;
+                }
+                int count = -1;
+                {
+                    std::unique_lock pvrLock(m_pvrLock);
+                    CHECK_PVRCMD(pvr_createTextureSwapChainDX(
+                        m_pvrSession, m_pvrSubmissionDevice.Get(), &desc, &xrSwapchain.pvrSwapchain[s]));
+                    CHECK_PVRCMD(pvr_getTextureSwapChainLength(m_pvrSession, xrSwapchain.pvrSwapchain[s], &count));
+                }
+                if (count != xrSwapchain.slices[0].size()) {
+                    throw std::runtime_error("Swapchain image count mismatch");
+                }
+
+                // Query the textures for the swapchain.
+                for (int j = 0; j < count; j++) {
+                    ID3D11Texture2D* texture = nullptr;
+                    {
+                        std::unique_lock pvrLock(m_pvrLock);
+                        CHECK_PVRCMD(pvr_getTextureSwapChainBufferDX(
+                            m_pvrSession, xrSwapchain.pvrSwapchain[s], j, IID_PPV_ARGS(&texture)));
+                    }
+                    setDebugName(texture, fmt::format("Runtime Sliced Texture[{}, {}, {}]", s, j, (void*)&xrSwapchain));
+
+                    xrSwapchain.slices[s].push_back(texture);
+                }
+            }
+
+            {
+                std::unique_lock pvrLock(m_pvrLock);
+                CHECK_PVRCMD(
+                    pvr_getTextureSwapChainCurrentIndex(m_pvrSession, xrSwapchain.pvrSwapchain[s], &pvrDestIndex[i]));
+            }
+        }
+
+        // Track the content of each PVR image, so that we can skip the copy when the image we are given already holds
+        // the last released image, from an earlier lap around the swapchain or for swapchains that are not updated.
+        if (xrSwapchain.slicesVersion.empty()) {
+            xrSwapchain.slicesVersion.resize(xrSwapchain.xrDesc.arraySize);
+        }
+        bool isCurrent = true;
+        for (uint32_t i = 0; i < sliceCount; i++) {
+            auto& versions = xrSwapchain.slicesVersion[firstSlice + i];
+            if (versions.empty()) {
+                versions.resize(xrSwapchain.slices[0].size(), 0);
+            }
+            isCurrent = isCurrent && versions[pvrDestIndex[i]] == xrSwapchain.releasedVersion;
+        }
 
-        if (needCopy) {
+        if (isCurrent) {
+            TraceLoggingWrite(g_traceProvider,
+                              "PrepareSwapchainImage_Current",
+                              TLPArg(&xrSwapchain, "Swapchain"),
+                              TLArg(slice, "Slice"),
+                              TLArg(pvrDestIndex[0], "Index"));
+        } else if (needCopy) {
             // The app may render to certain swapchains (eg: quad layers) at a lower frame rate. We must perform a copy
             // to the current PVR swapchain image. All the processing needed (eg: depth conversion or alpha correction)
             // was done during initial processing (the first time we saw the last released image).
-            m_pvrSubmissionContext->CopySubresourceRegion(xrSwapchain.slices[slice][pvrDestIndex],
+            m_pvrSubmissionContext->CopySubresourceRegion(xrSwapchain.slices[slice][pvrDestIndex[0]],
                                                           0,
                                                           0,
                                                           0,
@@ -598,157 +807,759 @@ namespace pimax_openxr {
                                                           xrSwapchain.slices[0][lastReleasedIndex],
                                                           slice,
                                                           nullptr);
-        } else if (xrSwapchain.needDepthConvert || needClearAlpha || needPremultiplyAlpha) {
+        } else if (xrSwapchain.needDownsample && !needProcessing) {
+            // Resolve the multisampled image straight into the PVR texture.
+            m_pvrSubmissionContext->ResolveSubresource(
+                xrSwapchain.slices[slice][pvrDestIndex[0]],
+                0,
+                xrSwapchain.images[lastReleasedIndex].Get(),
+                D3D11CalcSubresource(0, slice, xrSwapchain.xrDesc.mipCount),
+                xrSwapchain.dxgiFormatForSubmission);
+        } else if (needProcessing) {
             // Circumvent some of PVR's limitations:
             // - For texture arrays, we must do a copy to slice 0 into another swapchain.
             // - For unsupported depth format, we must do a conversion.
             // - For alpha-blended layers, we must pre-process the alpha channel.
+            // - For multisampled images, we must resolve. Depth is resolved by the conversion shader, while color is
+            //   resolved beforehand for the alpha correction shader to read.
             // For unsupported depth formats or alpha-blended with texture arrays, we must do both!
 
-            // FIXME: Today we only do convert from D32_FLOAT_S8X24 to D32_FLOAT, so we hard-code the
-            // corresponding formats below.
-            //
+            // FIXME: Today we only do convert from D32_FLOAT_S8X24 or multisampled D32_FLOAT to D32_FLOAT, so we
+            // hard-code the corresponding formats below.
+            D3D11_UNORDERED_ACCESS_VIEW_DESC uavDesc{};
+            uavDesc.ViewDimension = D3D11_UAV_DIMENSION_TEXTURE2D;
+            uavDesc.Format = !xrSwapchain.needDepthConvert ? getNonSRGBFormat(xrSwapchain.dxgiFormatForSubmission)
+                                                           : DXGI_FORMAT_R32_FLOAT;
+            uavDesc.Texture2D.MipSlice = 0;
+
             // Lazily create our intermediate buffer and compute shader resources.
-            if (!xrSwapchain.resolved) {
-                {
+            if (!xrSwapchain.convertConstants) {
+                D3D11_BUFFER_DESC desc{};
+                desc.ByteWidth = sizeof(ConvertConstants);
+                desc.BindFlags = D3D11_BIND_CONSTANT_BUFFER;
+                desc.Usage = D3D11_USAGE_DYNAMIC;
+                desc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+
+                CHECK_HRCMD(m_pvrSubmissionDevice->CreateBuffer(
+                    &desc, nullptr, xrSwapchain.convertConstants.ReleaseAndGetAddressOf()));
+                setDebugName(xrSwapchain.convertConstants.Get(),
+                             fmt::format("Convert Constants[{}]", (void*)&xrSwapchain));
+            }
+
+            ID3D11UnorderedAccessView* accessViews[2]{};
+            bool needResolve = false;
+            for (uint32_t i = 0; i < sliceCount; i++) {
+                const uint32_t s = firstSlice + i;
+
+                // When the PVR texture is not the one the application rendered to (depth conversion or other slices
+                // of an array), the shader writes directly into it, and we skip the intermediate texture and the copy.
+                const bool writeDirectly = xrSwapchain.canWriteDirectly && (xrSwapchain.needDepthConvert || s > 0);
+                if (!writeDirectly) {
+                    if (!xrSwapchain.resolved) {
+                        {
+                            D3D11_TEXTURE2D_DESC desc{};
+                            desc.ArraySize = 1;
+                            desc.Format = !xrSwapchain.needDepthConvert
+                                              ? getTypelessFormat(xrSwapchain.dxgiFormatForSubmission)
+                                              : DXGI_FORMAT_R32_TYPELESS;
+                            desc.Width = xrSwapchain.xrDesc.width;
+                            desc.Height = xrSwapchain.xrDesc.height;
+                            desc.MipLevels = xrSwapchain.xrDesc.mipCount;
+                            desc.SampleDesc.Count = 1;
+                            desc.BindFlags = D3D11_BIND_UNORDERED_ACCESS;
+
+                            CHECK_HRCMD(m_pvrSubmissionDevice->CreateTexture2D(
+                                &desc, nullptr, xrSwapchain.resolved.ReleaseAndGetAddressOf()));
+                            setDebugName(xrSwapchain.resolved.Get(),
+                                         fmt::format("Resolved Texture[{}]", (void*)&xrSwapchain));
+                        }
+                        {
+                            CHECK_HRCMD(m_pvrSubmissionDevice->CreateUnorderedAccessView(
+                                xrSwapchain.resolved.Get(),
+                                &uavDesc,
+                                xrSwapchain.convertAccessView.ReleaseAndGetAddressOf()));
+                            setDebugName(xrSwapchain.convertAccessView.Get(),
+                                         fmt::format("Convert UAV[{}]", (void*)&xrSwapchain));
+                        }
+                    }
+                    accessViews[i] = xrSwapchain.convertAccessView.Get();
+                    needResolve = true;
+                } else {
+                    auto& sliceAccessViews = xrSwapchain.slicesAccessView[s];
+                    if (sliceAccessViews.empty()) {
+                        sliceAccessViews.resize(xrSwapchain.slices[s].size());
+                    }
+                    auto& accessView = sliceAccessViews[pvrDestIndex[i]];
+                    if (!accessView) {
+                        CHECK_HRCMD(m_pvrSubmissionDevice->CreateUnorderedAccessView(
+                            xrSwapchain.slices[s][pvrDestIndex[i]], &uavDesc, accessView.ReleaseAndGetAddressOf()));
+                        setDebugName(
+                            accessView.Get(),
+                            fmt::format("Runtime Texture UAV[{}, {}, {}]", s, pvrDestIndex[i], (void*)&xrSwapchain));
+                    }
+                    accessViews[i] = accessView.Get();
+                }
+            }
+
+            // Resolve multisampled color images into a single-sampled texture for the shader to read.
+            const bool readDownsampled = xrSwapchain.needDownsample && !xrSwapchain.needDepthConvert;
+            if (readDownsampled) {
+                if (!xrSwapchain.downsampled) {
                     D3D11_TEXTURE2D_DESC desc{};
-                    desc.ArraySize = 1;
-                    desc.Format = !xrSwapchain.needDepthConvert ? getTypelessFormat(xrSwapchain.dxgiFormatForSubmission)
-                                                                : DXGI_FORMAT_R32_TYPELESS;
+                    desc.ArraySize = xrSwapchain.xrDesc.arraySize;
+                    desc.Format = getTypelessFormat(xrSwapchain.dxgiFormatForSubmission);
                     desc.Width = xrSwapchain.xrDesc.width;
                     desc.Height = xrSwapchain.xrDesc.height;
-                    desc.MipLevels = xrSwapchain.xrDesc.mipCount;
-                    desc.SampleDesc.Count = xrSwapchain.xrDesc.sampleCount;
-                    desc.BindFlags = D3D11_BIND_UNORDERED_ACCESS;
+                    desc.MipLevels = 1;
+                    desc.SampleDesc.Count = 1;
+                    desc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
 
                     CHECK_HRCMD(m_pvrSubmissionDevice->CreateTexture2D(
-                        &desc, nullptr, xrSwapchain.resolved.ReleaseAndGetAddressOf()));
-                    setDebugName(xrSwapchain.resolved.Get(), fmt::format("Resolved Texture[{}]", (void*)&xrSwapchain));
-                }
-                {
-                    D3D11_BUFFER_DESC desc{};
-                    desc.ByteWidth = 16; // Minimal size. We we only use 4 bytes.
-                    desc.BindFlags = D3D11_BIND_CONSTANT_BUFFER;
-                    desc.Usage = D3D11_USAGE_DYNAMIC;
-                    desc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
-
-                    CHECK_HRCMD(m_pvrSubmissionDevice->CreateBuffer(
-                        &desc, nullptr, xrSwapchain.convertConstants.ReleaseAndGetAddressOf()));
-                    setDebugName(xrSwapchain.convertConstants.Get(),
-                                 fmt::format("Convert Constants[{}]", (void*)&xrSwapchain));
-                }
-                {
-                    D3D11_UNORDERED_ACCESS_VIEW_DESC desc{};
-
-                    desc.ViewDimension = D3D11_UAV_DIMENSION_TEXTURE2D;
-                    desc.Format = !xrSwapchain.needDepthConvert ? getNonSRGBFormat(xrSwapchain.dxgiFormatForSubmission)
-                                                                : DXGI_FORMAT_R32_FLOAT;
-                    desc.Texture2D.MipSlice = 0;
+                        &desc, nullptr, xrSwapchain.downsampled.ReleaseAndGetAddressOf()));
+                    setDebugName(xrSwapchain.downsampled.Get(),
+                                 fmt::format("Downsampled Texture[{}]", (void*)&xrSwapchain));
 
-                    CHECK_HRCMD(m_pvrSubmissionDevice->CreateUnorderedAccessView(
-                        xrSwapchain.resolved.Get(), &desc, xrSwapchain.convertAccessView.ReleaseAndGetAddressOf()));
-                    setDebugName(xrSwapchain.convertAccessView.Get(),
-                                 fmt::format("Convert UAV[{}]", (void*)&xrSwapchain));
+                    // One view per slice, and one for both slices of a stereo texture array.
+                    xrSwapchain.downsampledResourceView.resize(xrSwapchain.xrDesc.arraySize + 1);
+                }
+                for (uint32_t i = 0; i < sliceCount; i++) {
+                    const uint32_t s = firstSlice + i;
+                    m_pvrSubmissionContext->ResolveSubresource(
+                        xrSwapchain.downsampled.Get(),
+                        D3D11CalcSubresource(0, s, 1),
+                        xrSwapchain.images[lastReleasedIndex].Get(),
+                        D3D11CalcSubresource(0, s, xrSwapchain.xrDesc.mipCount),
+                        xrSwapchain.dxgiFormatForSubmission);
                 }
             }
 
-            // Lazily create SRV/UAV.
-            if (!xrSwapchain.imagesResourceView[slice][lastReleasedIndex]) {
+            // Lazily create SRV.
+            const uint32_t downsampledViewIndex = processStereo ? xrSwapchain.xrDesc.arraySize : slice;
+            auto& resourceView = readDownsampled ? xrSwapchain.downsampledResourceView[downsampledViewIndex]
+                                 : processStereo ? xrSwapchain.imagesStereoResourceView[lastReleasedIndex]
+                                                 : xrSwapchain.imagesResourceView[slice][lastReleasedIndex];
+            if (!resourceView) {
                 D3D11_SHADER_RESOURCE_VIEW_DESC desc{};
 
-                desc.ViewDimension = xrSwapchain.xrDesc.arraySize == 1 ? D3D11_SRV_DIMENSION_TEXTURE2D
-                                                                       : D3D11_SRV_DIMENSION_TEXTURE2DARRAY;
-                desc.Format = !xrSwapchain.needDepthConvert ? xrSwapchain.dxgiFormatForSubmission
-                                                            : DXGI_FORMAT_R32_FLOAT_X8X24_TYPELESS;
-                desc.Texture2DArray.ArraySize = 1;
-                desc.Texture2DArray.MipLevels = xrSwapchain.xrDesc.mipCount;
-                desc.Texture2DArray.FirstArraySlice = D3D11CalcSubresource(0, slice, desc.Texture2DArray.MipLevels);
+                const bool isMultisampled = xrSwapchain.needDownsample && !readDownsampled;
+                if (!isMultisampled) {
+                    desc.ViewDimension = xrSwapchain.xrDesc.arraySize == 1 ? D3D11_SRV_DIMENSION_TEXTURE2D
+                                                                           : D3D11_SRV_DIMENSION_TEXTURE2DARRAY;
+                    desc.Texture2DArray.ArraySize = sliceCount;
+                    desc.Texture2DArray.MipLevels = readDownsampled ? 1 : xrSwapchain.xrDesc.mipCount;
+                    desc.Texture2DArray.FirstArraySlice =
+                        D3D11CalcSubresource(0, firstSlice, desc.Texture2DArray.MipLevels);
+                } else {
+                    desc.ViewDimension = xrSwapchain.xrDesc.arraySize == 1 ? D3D11_SRV_DIMENSION_TEXTURE2DMS
+                                                                           : D3D11_SRV_DIMENSION_TEXTURE2DMSARRAY;
+                    desc.Texture2DMSArray.ArraySize = sliceCount;
+                    desc.Texture2DMSArray.FirstArraySlice = firstSlice;
+                }
+                if (!xrSwapchain.needDepthConvert) {
+                    desc.Format = xrSwapchain.dxgiFormatForSubmission;
+                } else {
+                    desc.Format = xrSwapchain.dxgiFormatForSubmission == DXGI_FORMAT_D32_FLOAT_S8X24_UINT
+                                      ? DXGI_FORMAT_R32_FLOAT_X8X24_TYPELESS
+                                      : DXGI_FORMAT_R32_FLOAT;
+                }
 
                 CHECK_HRCMD(m_pvrSubmissionDevice->CreateShaderResourceView(
-                    xrSwapchain.images[lastReleasedIndex].Get(),
+                    readDownsampled ? xrSwapchain.downsampled.Get() : xrSwapchain.images[lastReleasedIndex].Get(),
                     &desc,
-                    xrSwapchain.imagesResourceView[slice][lastReleasedIndex].ReleaseAndGetAddressOf()));
-                setDebugName(xrSwapchain.imagesResourceView[slice][lastReleasedIndex].Get(),
-                             fmt::format("Convert SRV[{}, {}, {}]", slice, lastReleasedIndex, (void*)&xrSwapchain));
+                    resourceView.ReleaseAndGetAddressOf()));
+                setDebugName(resourceView.Get(),
+                             fmt::format("Convert SRV[{}-{}, {}, {}]",
+                                         firstSlice,
+                                         firstSlice + sliceCount - 1,
+                                         lastReleasedIndex,
+                                         (void*)&xrSwapchain));
             }
 
-            // 0: shader for Tex2D, 1: shader for Tex2DArray.
-            const int shaderToUse = xrSwapchain.xrDesc.arraySize == 1 ? 0 : 1;
-            if (xrSwapchain.needDepthConvert) {
-                m_pvrSubmissionContext->CSSetShader(m_depthConvertShader[shaderToUse].Get(), nullptr, 0);
-            } else {
+            // Only process the region of the image that is referenced by the layers.
+            XrRect2Di rect{{0, 0}, {(int32_t)xrSwapchain.xrDesc.width, (int32_t)xrSwapchain.xrDesc.height}};
+            uint32_t tileMask = 0;
+            if (const auto region = getRegion(slice)) {
+                rect = region->rect;
+
+                // Skip the tiles hidden by the lenses for the views of projection layers. For stereo processing, the
+                // slices must map to the eyes with the same region, since the dispatch covers both.
+                const SwapchainRegion* otherRegion = processStereo ? getRegion(otherSlice) : nullptr;
+                const bool canUseTileMask =
+                    region->eye >= 0 &&
+                    (!processStereo || (region->eye == (int)firstSlice && otherRegion->eye == (int)otherSlice &&
+                                        otherRegion->rect.offset.x == rect.offset.x &&
+                                        otherRegion->rect.offset.y == rect.offset.y &&
+                                        otherRegion->rect.extent.width == rect.extent.width &&
+                                        otherRegion->rect.extent.height == rect.extent.height));
+                if (canUseTileMask) {
+                    bool hasHiddenTiles = updateTileMask(region->eye, region->fov, rect.extent);
+                    if (processStereo) {
+                        hasHiddenTiles = updateTileMask(otherRegion->eye, otherRegion->fov, rect.extent) &&
+                                         hasHiddenTiles;
+                    }
+                    if (hasHiddenTiles) {
+                        tileMask = 1 + (processStereo ? 0 : region->eye);
+                    }
+                }
+
+                if (processStereo) {
+                    const auto otherRect = otherRegion->rect;
+                    const auto right = std::max(rect.offset.x + rect.extent.width,
+                                                otherRect.offset.x + otherRect.extent.width);
+                    const auto bottom = std::max(rect.offset.y + rect.extent.height,
+                                                 otherRect.offset.y + otherRect.extent.height);
+                    rect.offset.x = std::min(rect.offset.x, otherRect.offset.x);
+                    rect.offset.y = std::min(rect.offset.y, otherRect.offset.y);
+                    rect.extent.width = right - rect.offset.x;
+                    rect.extent.height = bottom - rect.offset.y;
+                }
+            }
+
+            {
                 D3D11_MAPPED_SUBRESOURCE mappedResources;
                 CHECK_HRCMD(m_pvrSubmissionContext->Map(
                     xrSwapchain.convertConstants.Get(), 0, D3D11_MAP_WRITE_DISCARD, 0, &mappedResources));
-                *(uint32_t*)mappedResources.pData = (needClearAlpha ? 1 : 0) | (needPremultiplyAlpha ? 2 : 0);
+                ConvertConstants& constants = *(ConvertConstants*)mappedResources.pData;
+                constants = {};
+                constants.offset[0] = rect.offset.x;
+                constants.offset[1] = rect.offset.y;
+                constants.extent[0] = rect.extent.width;
+                constants.extent[1] = rect.extent.height;
+                constants.mode = (needClearAlpha ? 1 : 0) | (needPremultiplyAlpha ? 2 : 0);
+                constants.tileMask = tileMask;
                 m_pvrSubmissionContext->Unmap(xrSwapchain.convertConstants.Get(), 0);
                 m_pvrSubmissionContext->CSSetConstantBuffers(0, 1, xrSwapchain.convertConstants.GetAddressOf());
+            }
+            if (tileMask) {
+                m_pvrSubmissionContext->CSSetShaderResources(8, 1, m_tileMaskResourceView.GetAddressOf());
+            }
 
+            // 0: shader for Tex2D, 1: shader for Tex2DArray, 2: shader for both slices of a stereo Tex2DArray.
+            const int shaderToUse = processStereo ? 2 : xrSwapchain.xrDesc.arraySize == 1 ? 0 : 1;
+            if (xrSwapchain.needDepthConvert) {
+                m_pvrSubmissionContext->CSSetShader(
+                    m_depthConvertShader[shaderToUse + (xrSwapchain.needDownsample ? 3 : 0)].Get(), nullptr, 0);
+            } else {
                 m_pvrSubmissionContext->CSSetShader(m_alphaCorrectShader[shaderToUse].Get(), nullptr, 0);
             }
 
-            m_pvrSubmissionContext->CSSetShaderResources(
-                0, 1, xrSwapchain.imagesResourceView[slice][lastReleasedIndex].GetAddressOf());
-            m_pvrSubmissionContext->CSSetUnorderedAccessViews(
-                0, 1, xrSwapchain.convertAccessView.GetAddressOf(), nullptr);
+            m_pvrSubmissionContext->CSSetShaderResources(0, 1, resourceView.GetAddressOf());
+            m_pvrSubmissionContext->CSSetUnorderedAccessViews(0, sliceCount, accessViews, nullptr);
 
-            m_pvrSubmissionContext->Dispatch((unsigned int)std::ceil(xrSwapchain.xrDesc.width / 8),
-                                             (unsigned int)std::ceil(xrSwapchain.xrDesc.height / 8),
-                                             1);
+            m_pvrSubmissionContext->Dispatch((rect.extent.width + 7) / 8, (rect.extent.height + 7) / 8, sliceCount);
 
             // Unbind all resources to avoid D3D validation errors.
             {
                 m_pvrSubmissionContext->CSSetShader(nullptr, nullptr, 0);
                 ID3D11Buffer* nullCBV[] = {nullptr};
                 m_pvrSubmissionContext->CSSetConstantBuffers(0, 1, nullCBV);
-                ID3D11UnorderedAccessView* nullUAV[] = {nullptr};
-                m_pvrSubmissionContext->CSSetUnorderedAccessViews(0, 1, nullUAV, nullptr);
+                ID3D11UnorderedAccessView* nullUAV[] = {nullptr, nullptr};
+                m_pvrSubmissionContext->CSSetUnorderedAccessViews(0, sliceCount, nullUAV, nullptr);
                 ID3D11ShaderResourceView* nullSRV[] = {nullptr};
                 m_pvrSubmissionContext->CSSetShaderResources(0, 1, nullSRV);
+                if (tileMask) {
+                    m_pvrSubmissionContext->CSSetShaderResources(8, 1, nullSRV);
+                }
             }
 
-            // Final copy into the PVR texture.
-            m_pvrSubmissionContext->CopySubresourceRegion(
-                xrSwapchain.slices[slice][pvrDestIndex], 0, 0, 0, 0, xrSwapchain.resolved.Get(), 0, nullptr);
+            // Final copy into the PVR texture. Only the first slice processed may need it.
+            if (needResolve) {
+                D3D11_BOX box{};
+                box.left = rect.offset.x;
+                box.top = rect.offset.y;
+                box.right = rect.offset.x + rect.extent.width;
+                box.bottom = rect.offset.y + rect.extent.height;
+                box.back = 1;
+                m_pvrSubmissionContext->CopySubresourceRegion(xrSwapchain.slices[firstSlice][pvrDestIndex[0]],
+                                                              0,
+                                                              rect.offset.x,
+                                                              rect.offset.y,
+                                                              0,
+                                                              xrSwapchain.resolved.Get(),
+                                                              0,
+                                                              &box);
+            }
         }
 
         xrSwapchain.lastProcessedIndex = lastReleasedIndex;
 
-        // Commit the texture to PVR.
-        CHECK_PVRCMD(pvr_commitTextureSwapChain(m_pvrSession, xrSwapchain.pvrSwapchain[slice]));
-        committed.insert(std::make_pair(xrSwapchain.pvrSwapchain[0], slice));
+        // Commit the texture(s) to PVR.
+        for (uint32_t i = 0; i < sliceCount; i++) {
+            xrSwapchain.slicesVersion[firstSlice + i][pvrDestIndex[i]] = xrSwapchain.releasedVersion;
+            {
+                std::unique_lock pvrLock(m_pvrLock);
+                CHECK_PVRCMD(pvr_commitTextureSwapChain(m_pvrSession, xrSwapchain.pvrSwapchain[firstSlice + i]));
+            }
+            committed.insert(std::make_pair(xrSwapchain.pvrSwapchain[0], firstSlice + i));
+        }
+    }
+
+    // Get a view of the last released image of a swapchain, for reading without sRGB conversion.
+    ID3D11ShaderResourceView* OpenXrRuntime::getRawResourceView(Swapchain& xrSwapchain, uint32_t slice) {
+        if (xrSwapchain.imagesRawResourceView.empty()) {
+            xrSwapchain.imagesRawResourceView.resize(xrSwapchain.xrDesc.arraySize);
+        }
+        auto& resourceViews = xrSwapchain.imagesRawResourceView[slice];
+        if (resourceViews.empty()) {
+            resourceViews.resize(xrSwapchain.images.size());
+        }
+        auto& resourceView = resourceViews[xrSwapchain.lastReleasedIndex];
+        if (!resourceView) {
+            D3D11_SHADER_RESOURCE_VIEW_DESC desc{};
+            desc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2DARRAY;
+            desc.Format = getNonSRGBFormat(xrSwapchain.dxgiFormatForSubmission);
+            desc.Texture2DArray.MipLevels = xrSwapchain.xrDesc.mipCount;
+            desc.Texture2DArray.FirstArraySlice = slice;
+            desc.Texture2DArray.ArraySize = 1;
+            CHECK_HRCMD(m_pvrSubmissionDevice->CreateShaderResourceView(
+                xrSwapchain.images[xrSwapchain.lastReleasedIndex].Get(), &desc, resourceView.ReleaseAndGetAddressOf()));
+            setDebugName(
+                resourceView.Get(),
+                fmt::format("Raw SRV[{}, {}, {}]", slice, xrSwapchain.lastReleasedIndex, (void*)&xrSwapchain));
+        }
+        return resourceView.Get();
+    }
+
+    // Get the current image of a composition target, (re)creating the target to match the format of the swapchain and
+    // to fit the requested size. The target only ever grows, and the passes render into its top-left corner, so that
+    // apps changing their resolution every frame do not cause PVR swapchains to be reallocated.
+    // Returns nullptr when the format cannot be written by our shaders.
+    ID3D11UnorderedAccessView* OpenXrRuntime::acquireCompositionTarget(CompositionTarget& target,
+                                                                       const Swapchain& formatSwapchain,
+                                                                       uint32_t width,
+                                                                       uint32_t height,
+                                                                       const std::string& debugName) {
+        if (!target.pvrSwapchain || target.pvrDesc.Format != formatSwapchain.pvrDesc.Format ||
+            target.pvrDesc.Width < (int)width || target.pvrDesc.Height < (int)height) {
+            if (!isUnorderedAccessSupported(formatSwapchain.dxgiFormatForSubmission)) {
+                return nullptr;
+            }
+
+            // Keep the largest size requested so far.
+            const bool isSameFormat = target.pvrSwapchain && target.pvrDesc.Format == formatSwapchain.pvrDesc.Format;
+            if (isSameFormat) {
+                width = std::max(width, (uint32_t)target.pvrDesc.Width);
+                height = std::max(height, (uint32_t)target.pvrDesc.Height);
+            }
+
+            if (target.pvrSwapchain) {
+                // The previous target may still be referenced by the submission in flight.
+                waitForPendingSubmission();
+                std::unique_lock pvrLock(m_pvrLock);
+                pvr_destroyTextureSwapChain(m_pvrSession, target.pvrSwapchain);
+            }
+            target = {};
+
+            target.pvrDesc.Type = pvrTexture_2D;
+            target.pvrDesc.Format = formatSwapchain.pvrDesc.Format;
+            target.pvrDesc.ArraySize = 1;
+            target.pvrDesc.Width = width;
+            target.pvrDesc.Height = height;
+            target.pvrDesc.MipLevels = 1;
+            target.pvrDesc.SampleCount = 1;
+            target.pvrDesc.MiscFlags = pvrTextureMisc_DX_Typeless;
+            target.pvrDesc.BindFlags = pvrTextureBind_DX_UnorderedAccess;
+            int count = -1;
+            {
+                std::unique_lock pvrLock(m_pvrLock);
+                CHECK_PVRCMD(pvr_createTextureSwapChainDX(
+                    m_pvrSession, m_pvrSubmissionDevice.Get(), &target.pvrDesc, &target.pvrSwapchain));
+                CHECK_PVRCMD(pvr_getTextureSwapChainLength(m_pvrSession, target.pvrSwapchain, &count));
+            }
+            for (int i = 0; i < count; i++) {
+                ID3D11Texture2D* texture = nullptr;
+                {
+                    std::unique_lock pvrLock(m_pvrLock);
+                    CHECK_PVRCMD(
+                        pvr_getTextureSwapChainBufferDX(m_pvrSession, target.pvrSwapchain, i, IID_PPV_ARGS(&texture)));
+                }
+                setDebugName(texture, fmt::format("Runtime {} Texture[{}]", debugName, i));
+
+                target.textures.push_back(texture);
+            }
+            target.accessViews.resize(count);
+        }
+
+        int pvrDestIndex = -1;
+        {
+            std::unique_lock pvrLock(m_pvrLock);
+            CHECK_PVRCMD(pvr_getTextureSwapChainCurrentIndex(m_pvrSession, target.pvrSwapchain, &pvrDestIndex));
+        }
+        auto& accessView = target.accessViews[pvrDestIndex];
+        if (!accessView) {
+            D3D11_UNORDERED_ACCESS_VIEW_DESC desc{};
+            desc.ViewDimension = D3D11_UAV_DIMENSION_TEXTURE2D;
+            desc.Format = getNonSRGBFormat(formatSwapchain.dxgiFormatForSubmission);
+            desc.Texture2D.MipSlice = 0;
+            CHECK_HRCMD(m_pvrSubmissionDevice->CreateUnorderedAccessView(
+                target.textures[pvrDestIndex], &desc, accessView.ReleaseAndGetAddressOf()));
+            setDebugName(accessView.Get(), fmt::format("Runtime {} UAV[{}]", debugName, pvrDestIndex));
+        }
+
+        return accessView.Get();
+    }
+
+    // Composite the focus view of a quad views projection into its context view, and commit the result to PVR.
+    // Returns nullptr when the swapchains cannot be composited, in which case only the context view is submitted.
+    pvrTextureSwapChain OpenXrRuntime::compositeFocusView(uint32_t eye,
+                                                          const XrCompositionLayerProjectionView& contextView,
+                                                          const XrCompositionLayerProjectionView& focusView,
+                                                          uint32_t layerIndex,
+                                                          XrCompositionLayerFlags compositionFlags) {
+        Swapchain& contextSwapchain = *m_swapchains.get(contextView.subImage.swapchain);
+        Swapchain& focusSwapchain = *m_swapchains.get(focusView.subImage.swapchain);
+        if (contextSwapchain.slices[0].empty() || focusSwapchain.slices[0].empty() ||
+            contextSwapchain.needDepthConvert || focusSwapchain.needDepthConvert || contextSwapchain.needDownsample ||
+            focusSwapchain.needDownsample) {
+            return nullptr;
+        }
+
+        // The composited image is written to a PVR swapchain of our own, matching the context swapchain.
+        CompositionTarget& target = m_focusViewTargets[eye];
+        ID3D11UnorderedAccessView* accessView = acquireCompositionTarget(target,
+                                                                         contextSwapchain,
+                                                                         contextSwapchain.pvrDesc.Width,
+                                                                         contextSwapchain.pvrDesc.Height,
+                                                                         fmt::format("Focus[{}]", eye));
+        if (!accessView) {
+            return nullptr;
+        }
+
+        const XrRect2Di& rect = contextView.subImage.imageRect;
+        const XrRect2Di& focusRect = focusView.subImage.imageRect;
+        {
+            D3D11_MAPPED_SUBRESOURCE mappedResources;
+            CHECK_HRCMD(m_pvrSubmissionContext->Map(
+                m_quadViewsConstants[0].Get(), 0, D3D11_MAP_WRITE_DISCARD, 0, &mappedResources));
+            ConvertConstants& constants = *(ConvertConstants*)mappedResources.pData;
+            constants = {};
+            constants.offset[0] = rect.offset.x;
+            constants.offset[1] = rect.offset.y;
+            constants.extent[0] = rect.extent.width;
+            constants.extent[1] = rect.extent.height;
+            const bool needClearAlpha =
+                layerIndex > 0 && !(compositionFlags & XR_COMPOSITION_LAYER_BLEND_TEXTURE_SOURCE_ALPHA_BIT);
+            const bool needPremultiplyAlpha = (compositionFlags & XR_COMPOSITION_LAYER_UNPREMULTIPLIED_ALPHA_BIT);
+            constants.mode = (needClearAlpha ? 1 : 0) | (needPremultiplyAlpha ? 2 : 0);
+            m_pvrSubmissionContext->Unmap(m_quadViewsConstants[0].Get(), 0);
+        }
+        {
+            // Both views share the same pose, so a pixel of the context view maps linearly to the focus view in
+            // tangent space.
+            const float l = tan(contextView.fov.angleLeft);
+            const float r = tan(contextView.fov.angleRight);
+            const float u = tan(contextView.fov.angleUp);
+            const float d = tan(contextView.fov.angleDown);
+            const float fl = tan(focusView.fov.angleLeft);
+            const float fr = tan(focusView.fov.angleRight);
+            const float fu = tan(focusView.fov.angleUp);
+            const float fd = tan(focusView.fov.angleDown);
+
+            D3D11_MAPPED_SUBRESOURCE mappedResources;
+            CHECK_HRCMD(m_pvrSubmissionContext->Map(
+                m_quadViewsConstants[1].Get(), 0, D3D11_MAP_WRITE_DISCARD, 0, &mappedResources));
+            QuadViewsConstants& constants = *(QuadViewsConstants*)mappedResources.pData;
+            constants = {};
+            constants.focusScale[0] = (r - l) / (rect.extent.width * (fr - fl));
+            constants.focusScale[1] = (u - d) / (rect.extent.height * (fu - fd));
+            constants.focusBias[0] = (l - fl) / (fr - fl);
+            // OpenGL images are stored bottom-up.
+            constants.focusBias[1] = !isOpenGLSession() ? (fu - u) / (fu - fd) : (d - fd) / (fu - fd);
+            constants.focusTexScale[0] = (float)focusRect.extent.width / focusSwapchain.xrDesc.width;
+            constants.focusTexScale[1] = (float)focusRect.extent.height / focusSwapchain.xrDesc.height;
+            constants.focusTexBias[0] = (float)focusRect.offset.x / focusSwapchain.xrDesc.width;
+            constants.focusTexBias[1] = (float)focusRect.offset.y / focusSwapchain.xrDesc.height;
+            constants.blendWidth = 0.05f;
+            m_pvrSubmissionContext->Unmap(m_quadViewsConstants[1].Get(), 0);
+        }
+
+        ID3D11Buffer* constantBuffers[] = {m_quadViewsConstants[0].Get(), m_quadViewsConstants[1].Get()};
+        ID3D11ShaderResourceView* resourceViews[] = {
+            getRawResourceView(contextSwapchain, contextView.subImage.imageArrayIndex),
+            getRawResourceView(focusSwapchain, focusView.subImage.imageArrayIndex)};
+        m_pvrSubmissionContext->CSSetShader(m_quadViewsShader.Get(), nullptr, 0);
+        m_pvrSubmissionContext->CSSetConstantBuffers(0, 2, constantBuffers);
+        m_pvrSubmissionContext->CSSetSamplers(0, 1, m_linearClampSampler.GetAddressOf());
+        m_pvrSubmissionContext->CSSetShaderResources(0, 2, resourceViews);
+        m_pvrSubmissionContext->CSSetUnorderedAccessViews(0, 1, &accessView, nullptr);
+
+        m_pvrSubmissionContext->Dispatch((rect.extent.width + 7) / 8, (rect.extent.height + 7) / 8, 1);
+
+        // Unbind all resources to avoid D3D validation errors.
+        {
+            m_pvrSubmissionContext->CSSetShader(nullptr, nullptr, 0);
+            ID3D11Buffer* nullCBV[] = {nullptr, nullptr};
+            m_pvrSubmissionContext->CSSetConstantBuffers(0, 2, nullCBV);
+            ID3D11SamplerState* nullSampler[] = {nullptr};
+            m_pvrSubmissionContext->CSSetSamplers(0, 1, nullSampler);
+            ID3D11UnorderedAccessView* nullUAV[] = {nullptr};
+            m_pvrSubmissionContext->CSSetUnorderedAccessViews(0, 1, nullUAV, nullptr);
+            ID3D11ShaderResourceView* nullSRV[] = {nullptr, nullptr};
+            m_pvrSubmissionContext->CSSetShaderResources(0, 2, nullSRV);
+        }
+
+        {
+            std::unique_lock pvrLock(m_pvrLock);
+            CHECK_PVRCMD(pvr_commitTextureSwapChain(m_pvrSession, target.pvrSwapchain));
+        }
+
+        return target.pvrSwapchain;
+    }
+
+    // Reproject a stereo view rendered with parallel projection onto the canted view of the panel, and commit the
+    // result to PVR. Returns nullptr when the swapchain cannot be reprojected, in which case the parallel view is
+    // submitted as-is.
+    pvrTextureSwapChain OpenXrRuntime::reprojectCantedView(uint32_t eye,
+                                                           const XrCompositionLayerProjectionView& view,
+                                                           uint32_t layerIndex,
+                                                           XrCompositionLayerFlags compositionFlags) {
+        Swapchain& xrSwapchain = *m_swapchains.get(view.subImage.swapchain);
+        if (xrSwapchain.slices[0].empty() || xrSwapchain.needDepthConvert || xrSwapchain.needDownsample) {
+            return nullptr;
+        }
+
+        // The canted image is written to a PVR swapchain of our own, with the same resolution as the parallel view.
+        // The target is sized after the swapchain rather than the image rectangle, which may change every frame.
+        const XrRect2Di& rect = view.subImage.imageRect;
+        CompositionTarget& target = m_cantedViewTargets[eye];
+        ID3D11UnorderedAccessView* accessView = acquireCompositionTarget(
+            target, xrSwapchain, xrSwapchain.xrDesc.width, xrSwapchain.xrDesc.height, fmt::format("Canted[{}]", eye));
+        if (!accessView) {
+            return nullptr;
+        }
+
+        {
+            D3D11_MAPPED_SUBRESOURCE mappedResources;
+            CHECK_HRCMD(m_pvrSubmissionContext->Map(
+                m_quadViewsConstants[0].Get(), 0, D3D11_MAP_WRITE_DISCARD, 0, &mappedResources));
+            ConvertConstants& constants = *(ConvertConstants*)mappedResources.pData;
+            constants = {};
+            constants.extent[0] = rect.extent.width;
+            constants.extent[1] = rect.extent.height;
+            const bool needClearAlpha =
+                layerIndex > 0 && !(compositionFlags & XR_COMPOSITION_LAYER_BLEND_TEXTURE_SOURCE_ALPHA_BIT);
+            const bool needPremultiplyAlpha = (compositionFlags & XR_COMPOSITION_LAYER_UNPREMULTIPLIED_ALPHA_BIT);
+            constants.mode = (needClearAlpha ? 1 : 0) | (needPremultiplyAlpha ? 2 : 0);
+            m_pvrSubmissionContext->Unmap(m_quadViewsConstants[0].Get(), 0);
+        }
+        {
+            // Both views share the same position, so a pixel of the canted view maps to the parallel view through the
+            // rotation by the canting angle (see buildVisibilityMasks()).
+            const pvrFovPort& canted = m_cachedEyeInfo[eye].Fov;
+            const float l = tan(view.fov.angleLeft);
+            const float r = tan(view.fov.angleRight);
+            const float u = tan(view.fov.angleUp);
+            const float d = tan(view.fov.angleDown);
+            const float angle = !eye ? m_cantingAngle : -m_cantingAngle;
+
+            D3D11_MAPPED_SUBRESOURCE mappedResources;
+            CHECK_HRCMD(m_pvrSubmissionContext->Map(
+                m_cantedReprojectionConstants.Get(), 0, D3D11_MAP_WRITE_DISCARD, 0, &mappedResources));
+            CantedReprojectionConstants& constants = *(CantedReprojectionConstants*)mappedResources.pData;
+            constants = {};
+            constants.cantedScale[0] = (canted.LeftTan + canted.RightTan) / rect.extent.width;
+            constants.cantedBias[0] = -canted.LeftTan;
+            constants.parallelScale[0] = rect.extent.width / ((r - l) * xrSwapchain.xrDesc.width);
+            constants.parallelBias[0] = (rect.offset.x - l * rect.extent.width / (r - l)) / xrSwapchain.xrDesc.width;
+            // OpenGL images are stored bottom-up.
+            const float textureHeight = (float)xrSwapchain.xrDesc.height;
+            if (!isOpenGLSession()) {
+                constants.cantedScale[1] = -(canted.UpTan + canted.DownTan) / rect.extent.height;
+                constants.cantedBias[1] = canted.UpTan;
+                constants.parallelScale[1] = -rect.extent.height / ((u - d) * textureHeight);
+                constants.parallelBias[1] = (rect.offset.y + u * rect.extent.height / (u - d)) / textureHeight;
+            } else {
+                constants.cantedScale[1] = (canted.UpTan + canted.DownTan) / rect.extent.height;
+                constants.cantedBias[1] = -canted.DownTan;
+                constants.parallelScale[1] = rect.extent.height / ((u - d) * textureHeight);
+                constants.parallelBias[1] = (rect.offset.y - d * rect.extent.height / (u - d)) / textureHeight;
+            }
+            constants.sinAngle = sin(angle);
+            constants.cosAngle = cos(angle);
+            m_pvrSubmissionContext->Unmap(m_cantedReprojectionConstants.Get(), 0);
+        }
+
+        ID3D11Buffer* constantBuffers[] = {m_quadViewsConstants[0].Get(), m_cantedReprojectionConstants.Get()};
+        ID3D11ShaderResourceView* resourceView = getRawResourceView(xrSwapchain, view.subImage.imageArrayIndex);
+        m_pvrSubmissionContext->CSSetShader(m_cantedReprojectionShader.Get(), nullptr, 0);
+        m_pvrSubmissionContext->CSSetConstantBuffers(0, 2, constantBuffers);
+        m_pvrSubmissionContext->CSSetSamplers(0, 1, m_linearClampSampler.GetAddressOf());
+        m_pvrSubmissionContext->CSSetShaderResources(0, 1, &resourceView);
+        m_pvrSubmissionContext->CSSetUnorderedAccessViews(0, 1, &accessView, nullptr);
+
+        m_pvrSubmissionContext->Dispatch((rect.extent.width + 7) / 8, (rect.extent.height + 7) / 8, 1);
+
+        // Unbind all resources to avoid D3D validation errors.
+        {
+            m_pvrSubmissionContext->CSSetShader(nullptr, nullptr, 0);
+            ID3D11Buffer* nullCBV[] = {nullptr, nullptr};
+            m_pvrSubmissionContext->CSSetConstantBuffers(0, 2, nullCBV);
+            ID3D11SamplerState* nullSampler[] = {nullptr};
+            m_pvrSubmissionContext->CSSetSamplers(0, 1, nullSampler);
+            ID3D11UnorderedAccessView* nullUAV[] = {nullptr};
+            m_pvrSubmissionContext->CSSetUnorderedAccessViews(0, 1, nullUAV, nullptr);
+            ID3D11ShaderResourceView* nullSRV[] = {nullptr};
+            m_pvrSubmissionContext->CSSetShaderResources(0, 1, nullSRV);
+        }
+
+        {
+            std::unique_lock pvrLock(m_pvrLock);
+            CHECK_PVRCMD(pvr_commitTextureSwapChain(m_pvrSession, target.pvrSwapchain));
+        }
+
+        return target.pvrSwapchain;
+    }
+
+    // Composite a run of coplanar quad layers into a single quad texture, and commit the result to PVR.
+    pvrTextureSwapChain OpenXrRuntime::flattenQuadLayers(const XrFrameEndInfo* frameEndInfo,
+                                                         const FlattenedLayers& flattenedLayers,
+                                                         uint32_t index) {
+        const auto getQuad = [&](uint32_t i) {
+            return reinterpret_cast<const XrCompositionLayerQuad*>(
+                frameEndInfo->layers[flattenedLayers.firstLayer + i]);
+        };
+
+        // planLayerFlattening() only groups quads with the same format.
+        CompositionTarget& target = m_flattenedLayersTargets[index];
+        const Swapchain& leaderSwapchain = *m_swapchains.get(getQuad(0)->subImage.swapchain);
+        ID3D11UnorderedAccessView* accessView = acquireCompositionTarget(target,
+                                                                         leaderSwapchain,
+                                                                         flattenedLayers.extent.width,
+                                                                         flattenedLayers.extent.height,
+                                                                         fmt::format("Flattened Layers[{}]", index));
+        CHECK_MSG(accessView, "Flattened layers format is not supported");
+
+        {
+            D3D11_MAPPED_SUBRESOURCE mappedResources;
+            CHECK_HRCMD(m_pvrSubmissionContext->Map(
+                m_quadViewsConstants[0].Get(), 0, D3D11_MAP_WRITE_DISCARD, 0, &mappedResources));
+            ConvertConstants& constants = *(ConvertConstants*)mappedResources.pData;
+            constants = {};
+            constants.extent[0] = flattenedLayers.extent.width;
+            constants.extent[1] = flattenedLayers.extent.height;
+            m_pvrSubmissionContext->Unmap(m_quadViewsConstants[0].Get(), 0);
+        }
+
+        ID3D11ShaderResourceView* resourceViews[k_maxFlattenedLayers]{};
+        {
+            D3D11_MAPPED_SUBRESOURCE mappedResources;
+            CHECK_HRCMD(m_pvrSubmissionContext->Map(
+                m_flattenQuadsConstants.Get(), 0, D3D11_MAP_WRITE_DISCARD, 0, &mappedResources));
+            FlattenQuadsConstants& constants = *(FlattenQuadsConstants*)mappedResources.pData;
+            constants = {};
+            constants.quadCount = flattenedLayers.layerCount;
+            for (uint32_t i = 0; i < flattenedLayers.layerCount; i++) {
+                const XrCompositionLayerQuad* quad = getQuad(i);
+                Swapchain& xrSwapchain = *m_swapchains.get(quad->subImage.swapchain);
+                const XrRect2Df& rect = flattenedLayers.rects[i];
+                const XrRect2Di& imageRect = quad->subImage.imageRect;
+
+                // The rectangles are Y-up, while the images are stored top-down (or bottom-up with OpenGL).
+                const float top = flattenedLayers.size.height - (rect.offset.y + rect.extent.height);
+                constants.quads[i].scale[0] = flattenedLayers.size.width / rect.extent.width;
+                constants.quads[i].scale[1] = flattenedLayers.size.height / rect.extent.height;
+                constants.quads[i].bias[0] = -rect.offset.x / rect.extent.width;
+                constants.quads[i].bias[1] = !isOpenGLSession() ? -top / rect.extent.height
+                                                                : -rect.offset.y / rect.extent.height;
+                constants.quads[i].texScale[0] = (float)imageRect.extent.width / xrSwapchain.xrDesc.width;
+                constants.quads[i].texScale[1] = (float)imageRect.extent.height / xrSwapchain.xrDesc.height;
+                constants.quads[i].texBias[0] = (float)imageRect.offset.x / xrSwapchain.xrDesc.width;
+                constants.quads[i].texBias[1] = (float)imageRect.offset.y / xrSwapchain.xrDesc.height;
+
+                // Same alpha rules as prepareAndCommitSwapchainImage(), since the quads are blended over each other
+                // before reaching the compositor.
+                const bool needClearAlpha = flattenedLayers.firstLayer + i > 0 &&
+                                            !(quad->layerFlags & XR_COMPOSITION_LAYER_BLEND_TEXTURE_SOURCE_ALPHA_BIT);
+                const bool needPremultiplyAlpha = quad->layerFlags & XR_COMPOSITION_LAYER_UNPREMULTIPLIED_ALPHA_BIT;
+                constants.quads[i].mode = (needClearAlpha ? 1 : 0) | (needPremultiplyAlpha ? 2 : 0);
+
+                resourceViews[i] = getRawResourceView(xrSwapchain, quad->subImage.imageArrayIndex);
+            }
+            m_pvrSubmissionContext->Unmap(m_flattenQuadsConstants.Get(), 0);
+        }
+
+        ID3D11Buffer* constantBuffers[] = {m_quadViewsConstants[0].Get(), m_flattenQuadsConstants.Get()};
+        m_pvrSubmissionContext->CSSetShader(m_flattenQuadsShader.Get(), nullptr, 0);
+        m_pvrSubmissionContext->CSSetConstantBuffers(0, 2, constantBuffers);
+        m_pvrSubmissionContext->CSSetSamplers(0, 1, m_linearClampSampler.GetAddressOf());
+        m_pvrSubmissionContext->CSSetShaderResources(0, k_maxFlattenedLayers, resourceViews);
+        m_pvrSubmissionContext->CSSetUnorderedAccessViews(0, 1, &accessView, nullptr);
+
+        m_pvrSubmissionContext->Dispatch(
+            (flattenedLayers.extent.width + 7) / 8, (flattenedLayers.extent.height + 7) / 8, 1);
+
+        // Unbind all resources to avoid D3D validation errors.
+        {
+            m_pvrSubmissionContext->CSSetShader(nullptr, nullptr, 0);
+            ID3D11Buffer* nullCBV[] = {nullptr, nullptr};
+            m_pvrSubmissionContext->CSSetConstantBuffers(0, 2, nullCBV);
+            ID3D11SamplerState* nullSampler[] = {nullptr};
+            m_pvrSubmissionContext->CSSetSamplers(0, 1, nullSampler);
+            ID3D11UnorderedAccessView* nullUAV[] = {nullptr};
+            m_pvrSubmissionContext->CSSetUnorderedAccessViews(0, 1, nullUAV, nullptr);
+            ID3D11ShaderResourceView* nullSRV[k_maxFlattenedLayers]{};
+            m_pvrSubmissionContext->CSSetShaderResources(0, k_maxFlattenedLayers, nullSRV);
+        }
+
+        {
+            std::unique_lock pvrLock(m_pvrLock);
+            CHECK_PVRCMD(pvr_commitTextureSwapChain(m_pvrSession, target.pvrSwapchain));
+        }
+
+        return target.pvrSwapchain;
+    }
+
+    void OpenXrRuntime::destroyCompositionTargets() {
+        // The targets may still be referenced by the submission in flight.
+        waitForPendingSubmission();
+
+        const auto destroyTarget = [&](CompositionTarget& target) {
+            if (target.pvrSwapchain) {
+                std::unique_lock pvrLock(m_pvrLock);
+                pvr_destroyTextureSwapChain(m_pvrSession, target.pvrSwapchain);
+            }
+            target = {};
+        };
+        for (auto& target : m_focusViewTargets) {
+            destroyTarget(target);
+        }
+        for (auto& target : m_flattenedLayersTargets) {
+            destroyTarget(target);
+        }
+        for (auto& target : m_cantedViewTargets) {
+            destroyTarget(target);
+        }
     }
 
     // Flush any pending work in the app context.
     void OpenXrRuntime::flushD3D11Context() {
         if (m_d3d11Context && m_d3d11Fence) {
-            wil::unique_handle eventHandle;
             m_fenceValue++;
             TraceLoggingWrite(
                 g_traceProvider, "FlushContext_Wait", TLArg("D3D11", "Api"), TLArg(m_fenceValue, "FenceValue"));
             m_d3d11Context->Signal(m_d3d11Fence.Get(), m_fenceValue);
-            *eventHandle.put() = CreateEventEx(nullptr, L"Flush Fence", 0, EVENT_ALL_ACCESS);
-            CHECK_HRCMD(m_d3d11Fence->SetEventOnCompletion(m_fenceValue, eventHandle.get()));
-            WaitForSingleObject(eventHandle.get(), INFINITE);
-            ResetEvent(eventHandle.get());
+            CHECK_HRCMD(m_d3d11Fence->SetEventOnCompletion(m_fenceValue, m_fenceEvent.get()));
+            WaitForSingleObject(m_fenceEvent.get(), INFINITE);
         }
     }
 
     // Flush any pending work in the submission context.
     void OpenXrRuntime::flushSubmissionContext() {
-        wil::unique_handle eventHandle;
         m_fenceValue++;
         TraceLoggingWrite(
             g_traceProvider, "FlushContext_Wait", TLArg("D3D11", "Api"), TLArg(m_fenceValue, "FenceValue"));
         m_pvrSubmissionContext->Signal(m_pvrSubmissionFence.Get(), m_fenceValue);
-        *eventHandle.put() = CreateEventEx(nullptr, L"Flush Fence", 0, EVENT_ALL_ACCESS);
-        CHECK_HRCMD(m_pvrSubmissionFence->SetEventOnCompletion(m_fenceValue, eventHandle.get()));
-        WaitForSingleObject(eventHandle.get(), INFINITE);
-        ResetEvent(eventHandle.get());
+        CHECK_HRCMD(m_pvrSubmissionFence->SetEventOnCompletion(m_fenceValue, m_fenceEvent.get()));
+        WaitForSingleObject(m_fenceEvent.get(), INFINITE);
     }
 
     // Serialize commands from the D3D12 queue to the D3D11 context used by PVR.
     void OpenXrRuntime::serializeD3D11Frame() {
+        if (m_useSingleDeviceSubmission) {
+            // The application and submission work are already ordered on the same context.
+            return;
+        }
+
         m_fenceValue++;
         TraceLoggingWrite(g_traceProvider, "xrEndFrame_Sync", TLArg("D3D11", "Api"), TLArg(m_fenceValue, "FenceValue"));
         CHECK_HRCMD(m_d3d11Context->Signal(m_d3d11Fence.Get(), m_fenceValue));
@@ -760,4 +1571,20 @@ namespace pimax_openxr {
         CHECK_HRCMD(m_pvrSubmissionContext->Wait(m_pvrSubmissionFence.Get(), m_fenceValue));
     }
 
+    // With single-device submission, swap out the pipeline state of the application context for our own.
+    void OpenXrRuntime::enterSubmissionContextState() {
+        if (m_useSingleDeviceSubmission && !m_savedAppContextState) {
+            m_pvrSubmissionContext->SwapDeviceContextState(m_submissionContextState.Get(),
+                                                           m_savedAppContextState.ReleaseAndGetAddressOf());
+        }
+    }
+
+    // Restore the pipeline state of the application context.
+    void OpenXrRuntime::leaveSubmissionContextState() {
+        if (m_savedAppContextState) {
+            m_pvrSubmissionContext->SwapDeviceContextState(m_savedAppContextState.Get(), nullptr);
+            m_savedAppContextState.Reset();
+        }
+    }
+
 } // namespace pimax_openxr
@@ -128,21 +128,9 @@ namespace pimax_openxr {
         CHECK_HRCMD(
             m_d3d12Device->OpenSharedHandle(fenceHandle.get(), IID_PPV_ARGS(m_d3d12Fence.ReleaseAndGetAddressOf())));
 
-        // We will need command lists to perform layout transitions.
-        for (uint32_t i = 0; i < 2; i++) {
-            CHECK_HRCMD(m_d3d12Device->CreateCommandAllocator(
-                D3D12_COMMAND_LIST_TYPE_DIRECT, IID_PPV_ARGS(m_d3d12CommandAllocator[i].ReleaseAndGetAddressOf())));
-            CHECK_HRCMD(m_d3d12Device->CreateCommandList(0,
-                                                         D3D12_COMMAND_LIST_TYPE_DIRECT,
-                                                         m_d3d12CommandAllocator[i].Get(),
-                                                         nullptr,
-                                                         IID_PPV_ARGS(m_d3d12CommandList[i].ReleaseAndGetAddressOf())));
-            CHECK_HRCMD(m_d3d12CommandList[i]->Close());
-        }
-
         // Frame timers.
         for (uint32_t i = 0; i < k_numGpuTimers; i++) {
-            // TODO: m_gpuTimerApp[i] = std::make_unique<GpuTimer>(...);
+            m_gpuTimerApp[i] = std::make_unique<D3D12GpuTimer>(m_d3d12Device.Get(), m_d3d12CommandQueue.Get());
         }
 
         return XR_SUCCESS;
@@ -154,10 +142,7 @@ namespace pimax_openxr {
         for (uint32_t i = 0; i < k_numGpuTimers; i++) {
             m_gpuTimerApp[i].reset();
         }
-        for (uint32_t i = 0; i < 2; i++) {
-            m_d3d12CommandList[i].Reset();
-            m_d3d12CommandAllocator[i].Reset();
-        }
+        m_d3d12PendingTransitions.clear();
         m_d3d12Fence.Reset();
         m_d3d12CommandQueue.Reset();
         m_d3d12Device.Reset();
@@ -194,6 +179,39 @@ namespace pimax_openxr {
                 setDebugName(d3d12Resource.Get(), fmt::format("App Swapchain Texture[{}, {}]", i, (void*)&xrSwapchain));
 
                 xrSwapchain.d3d12Images.push_back(d3d12Resource);
+
+                // Record the transitions for acquire and release once, so that we only need to submit them later.
+                if (xrSwapchain.xrDesc.usageFlags &
+                    (XR_SWAPCHAIN_USAGE_COLOR_ATTACHMENT_BIT | XR_SWAPCHAIN_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT)) {
+                    if (!xrSwapchain.d3d12CommandAllocator) {
+                        CHECK_HRCMD(m_d3d12Device->CreateCommandAllocator(
+                            D3D12_COMMAND_LIST_TYPE_DIRECT,
+                            IID_PPV_ARGS(xrSwapchain.d3d12CommandAllocator.ReleaseAndGetAddressOf())));
+                    }
+
+                    const auto appState = xrSwapchain.xrDesc.usageFlags & XR_SWAPCHAIN_USAGE_COLOR_ATTACHMENT_BIT
+                                              ? D3D12_RESOURCE_STATE_RENDER_TARGET
+                                              : D3D12_RESOURCE_STATE_DEPTH_WRITE;
+                    for (const bool acquire : {true, false}) {
+                        ComPtr<ID3D12GraphicsCommandList> list;
+                        CHECK_HRCMD(m_d3d12Device->CreateCommandList(0,
+                                                                     D3D12_COMMAND_LIST_TYPE_DIRECT,
+                                                                     xrSwapchain.d3d12CommandAllocator.Get(),
+                                                                     nullptr,
+                                                                     IID_PPV_ARGS(list.ReleaseAndGetAddressOf())));
+                        D3D12_RESOURCE_BARRIER barrier{};
+                        barrier.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
+                        barrier.Transition.pResource = d3d12Resource.Get();
+                        barrier.Transition.Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES;
+                        barrier.Transition.StateBefore = acquire ? D3D12_RESOURCE_STATE_COMMON : appState;
+                        barrier.Transition.StateAfter = acquire ? appState : D3D12_RESOURCE_STATE_COMMON;
+                        list->ResourceBarrier(1, &barrier);
+                        CHECK_HRCMD(list->Close());
+
+                        (acquire ? xrSwapchain.d3d12AcquireCommandLists : xrSwapchain.d3d12ReleaseCommandLists)
+                            .push_back(list);
+                    }
+                }
             }
 
             d3d12Images[i].texture = xrSwapchain.d3d12Images[i].Get();
@@ -225,54 +243,54 @@ namespace pimax_openxr {
 
     // Transition a swapchain image to the appropriate layout.
     void OpenXrRuntime::transitionImageD3D12(Swapchain& xrSwapchain, uint32_t index, bool acquire) {
-        if (!(xrSwapchain.xrDesc.usageFlags &
-              (XR_SWAPCHAIN_USAGE_COLOR_ATTACHMENT_BIT | XR_SWAPCHAIN_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT))) {
+        if (xrSwapchain.d3d12AcquireCommandLists.empty()) {
             return;
         }
 
-        CHECK_HRCMD(m_d3d12CommandList[m_currentAllocatorIndex]->Reset(
-            m_d3d12CommandAllocator[m_currentAllocatorIndex].Get(), nullptr));
-        D3D12_RESOURCE_BARRIER barrier{};
-        barrier.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
-        barrier.Transition.pResource = xrSwapchain.d3d12Images[index].Get();
-        barrier.Transition.Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES;
-        barrier.Transition.StateBefore = D3D12_RESOURCE_STATE_COMMON;
-        barrier.Transition.StateAfter = xrSwapchain.xrDesc.usageFlags & XR_SWAPCHAIN_USAGE_COLOR_ATTACHMENT_BIT
-                                            ? D3D12_RESOURCE_STATE_RENDER_TARGET
-                                            : D3D12_RESOURCE_STATE_DEPTH_WRITE;
-        m_d3d12CommandList[m_currentAllocatorIndex]->ResourceBarrier(1, &barrier);
-        CHECK_HRCMD(m_d3d12CommandList[m_currentAllocatorIndex]->Close());
-
-        m_d3d12CommandQueue->ExecuteCommandLists(
-            1, reinterpret_cast<ID3D12CommandList**>(m_d3d12CommandList[m_currentAllocatorIndex].GetAddressOf()));
+        if (acquire) {
+            // The application is about to render: submit now, along with any release transition still pending.
+            m_d3d12PendingTransitions.push_back(xrSwapchain.d3d12AcquireCommandLists[index].Get());
+            submitPendingTransitionsD3D12();
+        } else {
+            // Defer until the next submission.
+            m_d3d12PendingTransitions.push_back(xrSwapchain.d3d12ReleaseCommandLists[index].Get());
+        }
+    }
+
+    // Submit all the transitions that were deferred.
+    void OpenXrRuntime::submitPendingTransitionsD3D12() {
+        if (m_d3d12PendingTransitions.empty()) {
+            return;
+        }
+
+        m_d3d12CommandQueue->ExecuteCommandLists((UINT)m_d3d12PendingTransitions.size(),
+                                                 m_d3d12PendingTransitions.data());
+        m_d3d12PendingTransitions.clear();
     }
 
     // Wait for all pending commands to finish.
     void OpenXrRuntime::flushD3D12CommandQueue() {
         if (m_d3d12CommandQueue && m_d3d12Fence) {
-            wil::unique_handle eventHandle;
+            submitPendingTransitionsD3D12();
+
             m_fenceValue++;
             TraceLoggingWrite(
                 g_traceProvider, "FlushContext_Wait", TLArg("D3D12", "Api"), TLArg(m_fenceValue, "FenceValue"));
             m_d3d12CommandQueue->Signal(m_d3d12Fence.Get(), m_fenceValue);
-            *eventHandle.put() = CreateEventEx(nullptr, L"Flush Fence", 0, EVENT_ALL_ACCESS);
-            CHECK_HRCMD(m_d3d12Fence->SetEventOnCompletion(m_fenceValue, eventHandle.get()));
-            WaitForSingleObject(eventHandle.get(), INFINITE);
-            ResetEvent(eventHandle.get());
+            CHECK_HRCMD(m_d3d12Fence->SetEventOnCompletion(m_fenceValue, m_fenceEvent.get()));
+            WaitForSingleObject(m_fenceEvent.get(), INFINITE);
         }
     }
 
     // Serialize commands from the D3D12 queue to the D3D11 context used by PVR.
     void OpenXrRuntime::serializeD3D12Frame() {
+        submitPendingTransitionsD3D12();
+
         m_fenceValue++;
         TraceLoggingWrite(g_traceProvider, "xrEndFrame_Sync", TLArg("D3D12", "Api"), TLArg(m_fenceValue, "FenceValue"));
         CHECK_HRCMD(m_d3d12CommandQueue->Signal(m_d3d12Fence.Get(), m_fenceValue));
 
         waitOnSubmissionDevice();
-
-        // We also use this opportunity to switch command list.
-        m_currentAllocatorIndex ^= 1;
-        m_d3d12CommandAllocator[m_currentAllocatorIndex]->Reset();
     }
 
 } // namespace pimax_openxr
@@ -26,7 +26,7 @@
 #include "runtime.h"
 #include "utils.h"
 
-// Implements the mock support for the XR_FB_display_refresh_rate extension:
+// Implements the support for the XR_FB_display_refresh_rate extension:
 // https://www.khronos.org/registry/OpenXR/specs/1.0/html/xrspec.html#XR_FB_display_refresh_rate
 
 namespace pimax_openxr {
@@ -34,6 +34,19 @@ namespace pimax_openxr {
     using namespace pimax_openxr::log;
     using namespace pimax_openxr::utils;
 
+    // PVR does not let us change the refresh rate of the panel. Lower refresh rates are offered by pacing the app at an
+    // integer fraction of the native refresh rate.
+    std::vector<float> OpenXrRuntime::getSupportedDisplayRefreshRates() const {
+        std::vector<float> refreshRates;
+        for (uint32_t divisor = k_maxRefreshRateDivisor; divisor >= 1; divisor--) {
+            const float refreshRate = m_displayRefreshRate / divisor;
+            if (refreshRate >= k_minRefreshRate || divisor == 1) {
+                refreshRates.push_back(refreshRate);
+            }
+        }
+        return refreshRates;
+    }
+
     XrResult OpenXrRuntime::xrEnumerateDisplayRefreshRatesFB(XrSession session,
                                                              uint32_t displayRefreshRateCapacityInput,
                                                              uint32_t* displayRefreshRateCountOutput,
@@ -51,20 +64,27 @@ namespace pimax_openxr {
             return XR_ERROR_HANDLE_INVALID;
         }
 
-        if (displayRefreshRateCapacityInput && displayRefreshRateCapacityInput < 1) {
+        std::vector<float> refreshRates;
+        {
+            std::unique_lock lock(m_frameLock);
+            refreshRates = getSupportedDisplayRefreshRates();
+        }
+        if (displayRefreshRateCapacityInput && displayRefreshRateCapacityInput < refreshRates.size()) {
             return XR_ERROR_SIZE_INSUFFICIENT;
         }
 
-        *displayRefreshRateCountOutput = 1;
+        *displayRefreshRateCountOutput = (uint32_t)refreshRates.size();
         TraceLoggingWrite(g_traceProvider,
                           "xrEnumerateDisplayRefreshRatesFB",
                           TLArg(*displayRefreshRateCountOutput, "DisplayRefreshRateCountOutput"));
 
         if (displayRefreshRateCapacityInput && displayRefreshRates) {
-            displayRefreshRates[0] = m_displayRefreshRate;
-            TraceLoggingWrite(g_traceProvider,
-                              "xrEnumerateDisplayRefreshRatesFB",
-                              TLArg(displayRefreshRates[0], "DisplayRefreshRate"));
+            for (uint32_t i = 0; i < *displayRefreshRateCountOutput; i++) {
+                displayRefreshRates[i] = refreshRates[i];
+                TraceLoggingWrite(g_traceProvider,
+                                  "xrEnumerateDisplayRefreshRatesFB",
+                                  TLArg(displayRefreshRates[i], "DisplayRefreshRate"));
+            }
         }
 
         return XR_SUCCESS;
@@ -81,7 +101,10 @@ namespace pimax_openxr {
             return XR_ERROR_HANDLE_INVALID;
         }
 
-        *displayRefreshRate = m_displayRefreshRate;
+        {
+            std::unique_lock lock(m_frameLock);
+            *displayRefreshRate = m_displayRefreshRate / m_refreshRateDivisor;
+        }
 
         TraceLoggingWrite(
             g_traceProvider, "xrGetDisplayRefreshRateFB", TLArg(*displayRefreshRate, "DisplayRefreshRate"));
@@ -103,8 +126,30 @@ namespace pimax_openxr {
             return XR_ERROR_HANDLE_INVALID;
         }
 
-        if (std::abs(displayRefreshRate - m_displayRefreshRate) > FLT_EPSILON) {
-            return XR_ERROR_DISPLAY_REFRESH_RATE_UNSUPPORTED_FB;
+        std::unique_lock lock(m_frameLock);
+
+        // Per spec, 0 lets the runtime pick the refresh rate.
+        uint32_t divisor = 1;
+        if (displayRefreshRate != 0.f) {
+            const std::vector<float> refreshRates = getSupportedDisplayRefreshRates();
+            const auto it = std::find_if(refreshRates.cbegin(), refreshRates.cend(), [&](float refreshRate) {
+                return std::abs(displayRefreshRate - refreshRate) < 0.01f;
+            });
+            if (it == refreshRates.cend()) {
+                return XR_ERROR_DISPLAY_REFRESH_RATE_UNSUPPORTED_FB;
+            }
+            divisor = (uint32_t)std::round(m_displayRefreshRate / *it);
+        }
+
+        if (divisor != m_refreshRateDivisor) {
+            const float previousRefreshRate = m_displayRefreshRate / m_refreshRateDivisor;
+            m_refreshRateDivisor = divisor;
+            {
+                std::unique_lock eventsLock(m_refreshRateChangedEventsLock);
+                m_refreshRateChangedEvents.push_back(
+                    {previousRefreshRate, m_displayRefreshRate / m_refreshRateDivisor});
+            }
+            Log("Display refresh rate set to %.1fHz\n", m_displayRefreshRate / m_refreshRateDivisor);
         }
 
         return XR_SUCCESS;
@@ -23,6 +23,7 @@
 #include "pch.h"
 
 #include "log.h"
+#include "perf_stats.h"
 #include "runtime.h"
 #include "utils.h"
 
@@ -53,7 +54,10 @@ namespace pimax_openxr {
         }
 
         // Check for user presence and exit conditions.
-        CHECK_PVRCMD(pvr_getHmdStatus(m_pvrSession, &m_hmdStatus));
+        {
+            std::unique_lock pvrLock(m_pvrLock);
+            CHECK_PVRCMD(pvr_getHmdStatus(m_pvrSession, &m_hmdStatus));
+        }
         TraceLoggingWrite(g_traceProvider,
                           "PVR_HmdStatus",
                           TLArg(!!m_hmdStatus.ServiceReady, "ServiceReady"),
@@ -72,35 +76,43 @@ namespace pimax_openxr {
             (!m_sessionStopping && !m_sessionExiting && !m_sessionLossPending && m_hmdStatus.IsVisible) ? XR_TRUE
                                                                                                         : XR_FALSE;
 
-        // Critical section.
         {
             CpuTimer waitTimer;
             if (IsTraceEnabled()) {
                 waitTimer.start();
             }
 
-            std::unique_lock lock(m_frameLock);
+            {
+                std::unique_lock lock(m_frameLock);
 
-            m_frameTimerApp.stop();
-            m_lastCpuFrameTimeUs = m_frameTimerApp.query();
+                m_frameTimerApp.stop();
+                m_lastCpuFrameTimeUs = m_frameTimerApp.query();
 
-            TraceLoggingWrite(g_traceProvider,
-                              "App_Statistics",
-                              TLArg(m_frameCompleted, "FrameId"),
-                              TLArg(m_lastCpuFrameTimeUs, "AppFrameCpuTime"));
+                TraceLoggingWrite(g_traceProvider,
+                                  "App_Statistics",
+                                  TLArg((uint64_t)m_frameCompleted, "FrameId"),
+                                  TLArg(m_lastCpuFrameTimeUs, "AppFrameCpuTime"));
+            }
 
             // Wait for a call to xrBeginFrame() to match the previous call to xrWaitFrame().
             {
                 TraceLocalActivity(waitBeginFrame);
                 TraceLoggingWriteStart(waitBeginFrame,
                                        "WaitBeginFrame",
-                                       TLArg(m_frameWaited, "FrameWaited"),
-                                       TLArg(m_frameBegun, "FrameBegun"),
-                                       TLArg(m_frameCompleted, "FrameCompleted"));
-                m_frameCondVar.wait(lock, [&] { return m_frameBegun == m_frameWaited; });
+                                       TLArg((uint64_t)m_frameWaited, "FrameWaited"),
+                                       TLArg((uint64_t)m_frameBegun, "FrameBegun"),
+                                       TLArg((uint64_t)m_frameCompleted, "FrameCompleted"));
+                const uint64_t frameWaited = m_frameWaited;
+                m_frameBegun.waitFor([&](uint64_t frameBegun) { return frameBegun == frameWaited; });
                 TraceLoggingWriteStop(waitBeginFrame, "WaitBeginFrame");
             }
 
+            std::unique_lock lock(m_frameLock);
+
+            // pvr_waitToBeginFrame() is not called under the PVR lock (see m_pvrLock), so the submission thread must be
+            // out of pvr_endFrame() before we call it.
+            waitForPendingSubmission();
+
             // Workaround: PVR cannot wait for a frame without having a device. If no swapchain was created up to this
             // point, we must create one to initialize PVR.
             if (!m_pvrSession->envh->pvr_dxgl_interface) {
@@ -114,6 +126,7 @@ namespace pimax_openxr {
                 desc.SampleCount = 1;
                 desc.Format = PVR_FORMAT_B8G8R8A8_UNORM;
 
+                std::unique_lock pvrLock(m_pvrLock);
                 pvrTextureSwapChain tempSwapchain;
                 CHECK_PVRCMD(
                     pvr_createTextureSwapChainDX(m_pvrSession, m_pvrSubmissionDevice.Get(), &desc, &tempSwapchain));
@@ -131,7 +144,10 @@ namespace pimax_openxr {
                 // message:
                 //   [PVR] wait rendering complete event failed:258
                 // Let's ignore this for now and hope for the best.
+                LARGE_INTEGER waitStart;
+                QueryPerformanceCounter(&waitStart);
                 const auto result = pvr_waitToBeginFrame(m_pvrSession, pvrFrameId);
+                stats::RecordFramePhase(stats::FramePhase::WaitToBegin, stats::ElapsedUs(waitStart));
                 if (result != pvr_success) {
                     ErrorLog("pvr_waitToBeginFrame() failed with code: %s\n", xr::ToString(result).c_str());
                 }
@@ -139,12 +155,74 @@ namespace pimax_openxr {
                     waitToBeginFrame, "PVR_WaitToBeginFrame", TLArg(xr::ToString(result).c_str(), "Result"));
             }
 
+            double predictedDisplayTime;
+            {
+                std::unique_lock pvrLock(m_pvrLock);
+                predictedDisplayTime = pvr_getPredictedDisplayTime(m_pvrSession, pvrFrameId);
+            }
+
+            // The other frame functions are not blocked while we pace the app.
+            const auto sleepFor = [&](double duration) {
+                lock.unlock();
+                if (!m_waitFrameTimer) {
+                    *m_waitFrameTimer.put() = CreateWaitableTimerEx(
+                        nullptr, nullptr, CREATE_WAITABLE_TIMER_HIGH_RESOLUTION, TIMER_MODIFY_STATE | SYNCHRONIZE);
+                }
+                if (m_waitFrameTimer) {
+                    LARGE_INTEGER dueTime;
+                    dueTime.QuadPart = -(LONGLONG)(duration * 1e7);
+                    SetWaitableTimer(m_waitFrameTimer.get(), &dueTime, 0, nullptr, nullptr, FALSE);
+                    WaitForSingleObject(m_waitFrameTimer.get(), INFINITE);
+                } else {
+                    std::this_thread::sleep_for(std::chrono::microseconds((int64_t)(duration * 1e6)));
+                }
+                lock.lock();
+            };
+
+            // With application space warp or a lower refresh rate requested by the app, let refreshes go by (during
+            // which PVR repeats or reprojects the previous frame), in order to give the app a multiple of the frame
+            // time.
+            const uint32_t framePacing = getFramePacing();
+            if (framePacing > 1) {
+                sleepFor(m_frameDuration * (framePacing - 1));
+                predictedDisplayTime += m_frameDuration * (framePacing - 1);
+            } else if (m_useLowLatencyWake && m_frameDuration > 0) {
+                // PVR becomes ready once per refresh when the previous frame made it in time. Any longer interval
+                // means that a frame was missed, and that we must leave more room to the app.
+                const double frameReadyTime = pvr_getTimeSeconds(m_pvr);
+                const bool missedFrame =
+                    m_lastFrameReadyTime && frameReadyTime - m_lastFrameReadyTime > 1.5 * m_frameDuration;
+                m_lastFrameReadyTime = frameReadyTime;
+                m_wakeMargin = missedFrame ? std::min(m_wakeMargin * 2, m_frameDuration / 2)
+                                           : std::max(m_wakeMargin * 0.99, k_minWakeMargin);
+
+                // The app frame time is bound by the slowest of the CPU and GPU, over the last few frames.
+                m_wakeFrameTimesUs.push_back(std::max(m_lastCpuFrameTimeUs, m_lastGpuFrameTimeUs));
+                while (m_wakeFrameTimesUs.size() > k_wakeFrameTimesLength) {
+                    m_wakeFrameTimesUs.pop_front();
+                }
+                const double frameTime =
+                    *std::max_element(m_wakeFrameTimesUs.cbegin(), m_wakeFrameTimesUs.cend()) / 1e6;
+
+                // Wake the app as late as it can afford, and never after it missed a frame.
+                const double wakeDelay =
+                    missedFrame ? 0.0 : std::clamp(m_frameDuration - frameTime - m_wakeMargin, 0.0, m_frameDuration);
+                TraceLoggingWrite(g_traceProvider,
+                                  "WaitFrame_LowLatency",
+                                  TLArg(missedFrame, "MissedFrame"),
+                                  TLArg(frameTime, "FrameTime"),
+                                  TLArg(m_wakeMargin, "Margin"),
+                                  TLArg(wakeDelay, "WakeDelay"));
+                if (wakeDelay > 0) {
+                    sleepFor(wakeDelay);
+                }
+            }
+
             if (IsTraceEnabled()) {
                 waitTimer.stop();
             }
 
             const double now = pvr_getTimeSeconds(m_pvr);
-            double predictedDisplayTime = pvr_getPredictedDisplayTime(m_pvrSession, pvrFrameId);
             TraceLoggingWrite(g_traceProvider,
                               "WaitFrame",
                               TLArg(now, "Now"),
@@ -161,8 +239,21 @@ namespace pimax_openxr {
             }
             m_lastPredictedDisplayTime = frameState->predictedDisplayTime;
 
-            // We always use the native frame duration, regardless of Smart Smoothing.
-            frameState->predictedDisplayPeriod = pvrTimeToXrTime(m_frameDuration);
+            // Poses queried during the previous frame are now stale.
+            invalidatePoseCache();
+
+            // Start the timestamps of the frame. Poses queried since the previous call belong to the previous frame.
+            if (pvrFrameId > 0) {
+                m_frameTimestamps[(pvrFrameId - 1) % k_frameTimestampsCount].firstPoseQuery =
+                    m_firstPoseQueryTime.exchange(0);
+            }
+            FrameTimestamps& timestamps = m_frameTimestamps[pvrFrameId % k_frameTimestampsCount];
+            timestamps = {};
+            timestamps.waitFrameReturn = now;
+            timestamps.displayTime = predictedDisplayTime;
+
+            // We always use the native frame duration, regardless of Smart Smoothing, unless we are pacing the app.
+            frameState->predictedDisplayPeriod = pvrTimeToXrTime(m_frameDuration * framePacing);
 
             m_frameTimerApp.start();
 
@@ -170,13 +261,11 @@ namespace pimax_openxr {
 
             TraceLoggingWrite(g_traceProvider,
                               "WaitFrame_State",
-                              TLArg(m_frameWaited, "FrameWaited"),
-                              TLArg(m_frameBegun, "FrameBegun"),
-                              TLArg(m_frameCompleted, "FrameCompleted"));
+                              TLArg((uint64_t)m_frameWaited, "FrameWaited"),
+                              TLArg((uint64_t)m_frameBegun, "FrameBegun"),
+                              TLArg((uint64_t)m_frameCompleted, "FrameCompleted"));
         }
 
-        m_telemetry.tick();
-
         TraceLoggingWrite(g_traceProvider,
                           "xrWaitFrame",
                           TLArg(!!frameState->shouldRender, "ShouldRender"),
@@ -204,7 +293,6 @@ namespace pimax_openxr {
 
         bool frameDiscarded = false;
 
-        // Critical section.
         {
             CpuTimer waitTimer;
             if (IsTraceEnabled()) {
@@ -213,6 +301,7 @@ namespace pimax_openxr {
 
             std::unique_lock lock(m_frameLock);
 
+            // xrWaitFrame() cannot advance m_frameWaited until we advance m_frameBegun below.
             if (m_frameWaited == m_frameCompleted || m_frameBegun == m_frameWaited) {
                 return XR_ERROR_CALL_ORDER_INVALID;
             }
@@ -223,16 +312,23 @@ namespace pimax_openxr {
                     TraceLocalActivity(waitEndFrame);
                     TraceLoggingWriteStart(waitEndFrame,
                                            "WaitEndFrame",
-                                           TLArg(m_frameWaited, "FrameWaited"),
-                                           TLArg(m_frameBegun, "FrameBegun"),
-                                           TLArg(m_frameCompleted, "FrameCompleted"));
-                    m_frameCondVar.wait(lock, [&] { return m_frameCompleted == m_frameBegun; });
+                                           TLArg((uint64_t)m_frameWaited, "FrameWaited"),
+                                           TLArg((uint64_t)m_frameBegun, "FrameBegun"),
+                                           TLArg((uint64_t)m_frameCompleted, "FrameCompleted"));
+                    // xrEndFrame() needs the frame lock to complete.
+                    const uint64_t frameBegun = m_frameBegun;
+                    lock.unlock();
+                    m_frameCompleted.waitFor([&](uint64_t frameCompleted) { return frameCompleted == frameBegun; });
+                    lock.lock();
                     TraceLoggingWriteStop(waitEndFrame, "WaitEndFrame");
                 }
             } else {
                 frameDiscarded = true;
             }
 
+            // PVR expects the previous frame to be submitted before the next one begins.
+            waitForPendingSubmission();
+
             // Tell PVR we are about to begin the frame.
             const long long pvrFrameId = m_frameWaited - 1;
             {
@@ -242,7 +338,11 @@ namespace pimax_openxr {
                 // message:
                 //   [PVR] wait rendering complete event failed:258
                 // Let's ignore this for now and hope for the best.
-                const auto result = pvr_beginFrame(m_pvrSession, pvrFrameId);
+                pvrResult result;
+                {
+                    std::unique_lock pvrLock(m_pvrLock);
+                    result = pvr_beginFrame(m_pvrSession, pvrFrameId);
+                }
                 if (result != pvr_success) {
                     ErrorLog("pvr_beginFrame() failed with code: %s\n", xr::ToString(result).c_str());
                 }
@@ -253,7 +353,7 @@ namespace pimax_openxr {
             // success code XR_FRAME_DISCARDED being returned from xrBeginFrame. In this case it is assumed that the
             // xrBeginFrame refers to the next frame and the previously begun frame is forfeited by the application."
             // Therefore, we always advance m_frameBegun even upon discard.
-            m_frameBegun = m_frameWaited;
+            // This is deferred until after the statistics below, since it signals xrWaitFrame().
 
             if (IsTraceEnabled()) {
                 waitTimer.stop();
@@ -265,7 +365,7 @@ namespace pimax_openxr {
                               TLArg(waitTimer.query(), "WaitDurationUs"));
 
             // Statistics for the previous frame.
-            if (m_useFrameTimingOverride || IsTraceEnabled()) {
+            if (m_measureAppGpuTime || IsTraceEnabled()) {
                 // Our principle is to always query() a timer before we start() it. This means that we get measurements
                 // with k_numGpuTimers frames latency.
                 m_lastGpuFrameTimeUs =
@@ -273,7 +373,7 @@ namespace pimax_openxr {
 
                 TraceLoggingWrite(g_traceProvider,
                                   "App_Statistics",
-                                  TLArg(m_frameCompleted, "FrameId"),
+                                  TLArg((uint64_t)m_frameCompleted, "FrameId"),
                                   TLArg(m_renderTimerApp.query(), "AppRenderCpuTime"));
 
                 if (m_frameCompleted >= k_numGpuTimers) {
@@ -283,6 +383,10 @@ namespace pimax_openxr {
                                       TLArg(m_lastGpuFrameTimeUs, "AppRenderGpuTime"));
                 }
 
+                if (has_XR_META_recommended_layer_resolution) {
+                    updateResolutionScale();
+                }
+
                 // Start app timers.
                 m_renderTimerApp.start();
                 if (m_gpuTimerApp[m_currentTimerIndex]) {
@@ -290,21 +394,61 @@ namespace pimax_openxr {
                 }
             }
 
+            // Only the reprojection (Smart Smoothing or Compulsive Smoothing) consumes the depth buffers. The settings
+            // can be changed from the Pitool UI at any time, so we poll them.
+            const double now = pvr_getTimeSeconds(m_pvr);
+            if (now - m_lastPvrConfigPollTime >= 1.0) {
+                m_lastPvrConfigPollTime = now;
+                const bool wasDepthConsumedByPvr = m_isDepthConsumedByPvr;
+                pvrDisplayInfo info{};
+                pvrResult displayInfoResult;
+                {
+                    std::unique_lock pvrLock(m_pvrLock);
+                    m_isDepthConsumedByPvr = pvr_getIntConfig(m_pvrSession, "dbg_asw_enable", 0) ||
+                                             pvr_getIntConfig(m_pvrSession, "dbg_force_framerate_divide_by", 1) > 1;
+                    displayInfoResult = pvr_getEyeDisplayInfo(m_pvrSession, pvrEye_Left, &info);
+                }
+                if (m_isDepthConsumedByPvr != wasDepthConsumedByPvr) {
+                    TraceLoggingWrite(
+                        g_traceProvider, "PVR_DepthConsumed", TLArg(m_isDepthConsumedByPvr, "DepthConsumed"));
+                }
+
+                // The refresh rate of the panel can also be changed from the Pitool UI. This must happen before we
+                // signal xrWaitFrame(), which reads the frame duration.
+                if (displayInfoResult == pvr_success && info.refresh_rate > 0 &&
+                    std::abs(info.refresh_rate - m_displayRefreshRate) > 0.01f) {
+                    const float previousRefreshRate = m_displayRefreshRate / m_refreshRateDivisor;
+                    Log("Display refresh rate changed to %.1fHz\n", info.refresh_rate);
+                    m_displayRefreshRate = info.refresh_rate;
+                    m_frameDuration = 1.0 / info.refresh_rate;
+                    m_refreshRateDivisor = 1;
+                    if (has_XR_FB_display_refresh_rate) {
+                        std::unique_lock eventsLock(m_refreshRateChangedEventsLock);
+                        m_refreshRateChangedEvents.push_back({previousRefreshRate, m_displayRefreshRate});
+                    }
+                }
+            }
+
             // Signal xrWaitFrame().
+            m_frameBegun = m_frameWaited;
+            QueryPerformanceCounter(&m_beginFrameTime);
             TraceLoggingWrite(g_traceProvider,
                               "BeginFrame_Signal",
-                              TLArg(m_frameWaited, "FrameWaited"),
-                              TLArg(m_frameBegun, "FrameBegun"),
-                              TLArg(m_frameCompleted, "FrameCompleted"));
-            m_frameCondVar.notify_one();
+                              TLArg((uint64_t)m_frameWaited, "FrameWaited"),
+                              TLArg((uint64_t)m_frameBegun, "FrameBegun"),
+                              TLArg((uint64_t)m_frameCompleted, "FrameCompleted"));
 
-            TraceLoggingWrite(
-                g_traceProvider,
-                "PVR_Status",
-                TLArg(!!pvr_getIntConfig(m_pvrSession, "dbg_asw_enable", 0), "EnableSmartSmoothing"),
-                TLArg(pvr_getIntConfig(m_pvrSession, "dbg_force_framerate_divide_by", 1), "CompulsiveSmoothingRate"),
-                TLArg(!!pvr_getIntConfig(m_pvrSession, "asw_available", 0), "SmartSmoothingAvailable"),
-                TLArg(!!pvr_getIntConfig(m_pvrSession, "asw_active", 0), "SmartSmoothingActive"));
+            if (IsTraceEnabled()) {
+                std::unique_lock pvrLock(m_pvrLock);
+                TraceLoggingWrite(
+                    g_traceProvider,
+                    "PVR_Status",
+                    TLArg(!!pvr_getIntConfig(m_pvrSession, "dbg_asw_enable", 0), "EnableSmartSmoothing"),
+                    TLArg(pvr_getIntConfig(m_pvrSession, "dbg_force_framerate_divide_by", 1),
+                          "CompulsiveSmoothingRate"),
+                    TLArg(!!pvr_getIntConfig(m_pvrSession, "asw_available", 0), "SmartSmoothingAvailable"),
+                    TLArg(!!pvr_getIntConfig(m_pvrSession, "asw_active", 0), "SmartSmoothingActive"));
+            }
         }
 
         return !frameDiscarded ? XR_SUCCESS : XR_FRAME_DISCARDED;
@@ -350,8 +494,22 @@ namespace pimax_openxr {
             if (m_frameBegun == m_frameCompleted) {
                 return XR_ERROR_CALL_ORDER_INVALID;
             }
+            stats::RecordFramePhase(stats::FramePhase::BeginToEnd, stats::ElapsedUs(m_beginFrameTime));
+            {
+                const long long pvrFrameId = m_frameBegun - 1;
+                FrameTimestamps& timestamps = m_frameTimestamps[pvrFrameId % k_frameTimestampsCount];
+                timestamps.endFrameEntry = pvr_getTimeSeconds(m_pvr);
+                if (pvrFrameId + 1 == (long long)m_frameWaited) {
+                    timestamps.firstPoseQuery = m_firstPoseQueryTime.load();
+                }
+            }
+
+            // The submission context cannot be shared with the submission thread.
+            waitForPendingSubmission();
 
-            if (m_useFrameTimingOverride || IsTraceEnabled()) {
+            collectRetiredSwapchains();
+
+            if (m_measureAppGpuTime || IsTraceEnabled()) {
                 m_renderTimerApp.stop();
                 if (m_gpuTimerApp[m_currentTimerIndex]) {
                     m_gpuTimerApp[m_currentTimerIndex]->stop();
@@ -369,29 +527,58 @@ namespace pimax_openxr {
                 serializeD3D11Frame();
             }
 
+            // With single-device submission, the precomposition work must not disturb the application context.
+            enterSubmissionContextState();
+            auto restoreAppContextState = wil::scope_exit([&] { leaveSubmissionContextState(); });
+
             // Handle recentering via keyboard input when the app does not poll for motion controllers.
             if (!m_actionsSyncedThisFrame) {
                 handleBuiltinActions();
             }
             m_actionsSyncedThisFrame = false;
 
+            const RuntimeSettings& settings = currentSettings();
+
+            // Skip the depth conversion and submission when nothing will consume the depth.
+            const bool submitDepthToPvr =
+                settings.depthSubmission == DepthSubmission::Always ||
+                (settings.depthSubmission == DepthSubmission::Auto && m_isDepthConsumedByPvr);
+
+            // The precomposition timer is cheap enough to always run for the performance statistics.
+            const bool measurePrecomposition = m_useFrameTimingOverride || IsTraceEnabled() || stats::g_sharedStats;
             const auto lastPrecompositionTime = m_gpuTimerPrecomposition[m_currentTimerIndex]->query();
-            if (IsTraceEnabled()) {
+            if (lastPrecompositionTime) {
+                stats::RecordFramePhase(stats::FramePhase::PrecompositionGpu, lastPrecompositionTime);
+                m_frameTimestamps[(m_frameBegun - 1) % k_frameTimestampsCount].precompositionGpuUs =
+                    lastPrecompositionTime;
+            }
+            if (measurePrecomposition) {
                 m_gpuTimerPrecomposition[m_currentTimerIndex]->start();
             }
 
-            std::set<std::pair<pvrTextureSwapChain, uint32_t>> committedSwapchainImages;
+            // The arena is not in use by the submission thread, since we waited for any pending submission above.
+            auto& committedSwapchainImages = m_frameArena.committedSwapchainImages;
+            committedSwapchainImages.clear();
+            auto& swapchainRegions = m_frameArena.swapchainRegions;
+            collectSwapchainRegions(frameEndInfo, swapchainRegions);
+
+            // Merge coplanar quads where possible.
+            auto& flattenedLayers = m_frameArena.flattenedLayers;
+            planLayerFlattening(frameEndInfo, flattenedLayers);
+            uint32_t nextFlattenedLayers = 0;
 
             // Construct the list of layers.
-            std::vector<pvrLayer_Union> layersAllocator(frameEndInfo->layerCount + 1);
-            std::vector<pvrLayerHeader*> layers;
+            auto& layersAllocator = m_frameArena.layersAllocator;
+            auto& layers = m_frameArena.layers;
+            layers.clear();
+            bool hasSpaceWarp = false;
             for (uint32_t i = 0; i < frameEndInfo->layerCount; i++) {
                 if (!frameEndInfo->layers[i]) {
                     return XR_ERROR_LAYER_INVALID;
                 }
 
                 auto& layer = layersAllocator[i];
-                layer.Header.Flags = 0;
+                layer = {};
 
                 // OpenGL needs to flip the texture vertically, which PVR can conveniently do for us.
                 if (isOpenGLSession()) {
@@ -408,7 +595,7 @@ namespace pimax_openxr {
                                       TLArg(proj->layerFlags, "Flags"),
                                       TLXArg(proj->space, "Space"));
 
-                    if (proj->viewCount != xr::StereoView::Count) {
+                    if (proj->viewCount != getViewConfigurationViewCount(m_primaryViewConfigurationType)) {
                         return XR_ERROR_VALIDATION_FAILURE;
                     }
 
@@ -441,11 +628,11 @@ namespace pimax_openxr {
                             return XR_ERROR_POSE_INVALID;
                         }
 
-                        if (!m_swapchains.count(proj->views[eye].subImage.swapchain)) {
+                        if (!m_swapchains.contains(proj->views[eye].subImage.swapchain)) {
                             return XR_ERROR_HANDLE_INVALID;
                         }
 
-                        Swapchain& xrSwapchain = *(Swapchain*)proj->views[eye].subImage.swapchain;
+                        Swapchain& xrSwapchain = *m_swapchains.get(proj->views[eye].subImage.swapchain);
 
                         if (xrSwapchain.lastReleasedIndex == -1) {
                             return XR_ERROR_LAYER_INVALID;
@@ -455,39 +642,160 @@ namespace pimax_openxr {
                             return XR_ERROR_VALIDATION_FAILURE;
                         }
 
-                        // Fill out color buffer information.
-                        prepareAndCommitSwapchainImage(xrSwapchain,
-                                                       i,
-                                                       proj->views[eye].subImage.imageArrayIndex,
-                                                       frameEndInfo->layers[i]->layerFlags,
-                                                       committedSwapchainImages);
-                        layer.EyeFov.ColorTexture[eye] =
-                            xrSwapchain.pvrSwapchain[proj->views[eye].subImage.imageArrayIndex];
-
                         if (!isValidSwapchainRect(xrSwapchain.pvrDesc, proj->views[eye].subImage.imageRect)) {
                             return XR_ERROR_SWAPCHAIN_RECT_INVALID;
                         }
-                        layer.EyeFov.Viewport[eye].x = proj->views[eye].subImage.imageRect.offset.x;
-                        layer.EyeFov.Viewport[eye].y = proj->views[eye].subImage.imageRect.offset.y;
+
+                        // With quad views, the focus view is composited into the context view.
+                        pvrTextureSwapChain compositedTexture = nullptr;
+                        if (proj->viewCount == k_quadViewCount) {
+                            const XrCompositionLayerProjectionView& focusView =
+                                proj->views[eye + xr::StereoView::Count];
+                            TraceLoggingWrite(g_traceProvider,
+                                              "xrEndFrame_View",
+                                              TLArg("Focus", "Type"),
+                                              TLArg(eye, "Index"),
+                                              TLXArg(focusView.subImage.swapchain, "Swapchain"),
+                                              TLArg(focusView.subImage.imageArrayIndex, "ImageArrayIndex"),
+                                              TLArg(xr::ToString(focusView.subImage.imageRect).c_str(), "ImageRect"),
+                                              TLArg(xr::ToString(focusView.fov).c_str(), "Fov"));
+
+                            if (!Quaternion::IsNormalized(focusView.pose.orientation)) {
+                                return XR_ERROR_POSE_INVALID;
+                            }
+
+                            if (!m_swapchains.contains(focusView.subImage.swapchain)) {
+                                return XR_ERROR_HANDLE_INVALID;
+                            }
+
+                            Swapchain& xrFocusSwapchain = *m_swapchains.get(focusView.subImage.swapchain);
+
+                            if (xrFocusSwapchain.lastReleasedIndex == -1) {
+                                return XR_ERROR_LAYER_INVALID;
+                            }
+
+                            if (focusView.subImage.imageArrayIndex >= xrFocusSwapchain.xrDesc.arraySize) {
+                                return XR_ERROR_VALIDATION_FAILURE;
+                            }
+
+                            if (!isValidSwapchainRect(xrFocusSwapchain.pvrDesc, focusView.subImage.imageRect)) {
+                                return XR_ERROR_SWAPCHAIN_RECT_INVALID;
+                            }
+
+                            compositedTexture = compositeFocusView(
+                                eye, proj->views[eye], focusView, i, frameEndInfo->layers[i]->layerFlags);
+                            if (!compositedTexture && !m_loggedFocusViewFallback) {
+                                Log("Focus views cannot be composited, only submitting context views\n");
+                                m_loggedFocusViewFallback = true;
+                            }
+                        }
+
+                        // With canted reprojection, the parallel view is resampled onto the canted view of the panel.
+                        bool isReprojected = false;
+                        if (proj->viewCount == xr::StereoView::Count && isCantedReprojectionEnabled()) {
+                            compositedTexture =
+                                reprojectCantedView(eye, proj->views[eye], i, frameEndInfo->layers[i]->layerFlags);
+                            isReprojected = compositedTexture != nullptr;
+                            if (!isReprojected && !m_loggedCantedReprojectionFallback) {
+                                Log("Views cannot be reprojected, submitting parallel projection views\n");
+                                m_loggedCantedReprojectionFallback = true;
+                            }
+                        }
+
+                        // Fill out color buffer information.
+                        if (compositedTexture) {
+                            layer.EyeFov.ColorTexture[eye] = compositedTexture;
+                        } else {
+                            prepareAndCommitSwapchainImage(xrSwapchain,
+                                                           i,
+                                                           proj->views[eye].subImage.imageArrayIndex,
+                                                           frameEndInfo->layers[i]->layerFlags,
+                                                           swapchainRegions,
+                                                           committedSwapchainImages);
+                            layer.EyeFov.ColorTexture[eye] =
+                                xrSwapchain.pvrSwapchain[proj->views[eye].subImage.imageArrayIndex];
+                        }
+                        // The reprojected view is at the origin of our own swapchain.
+                        const XrOffset2Di viewportOffset =
+                            !isReprojected ? proj->views[eye].subImage.imageRect.offset : XrOffset2Di{};
+                        layer.EyeFov.Viewport[eye].x = viewportOffset.x;
+                        layer.EyeFov.Viewport[eye].y = viewportOffset.y;
                         layer.EyeFov.Viewport[eye].width = proj->views[eye].subImage.imageRect.extent.width;
                         layer.EyeFov.Viewport[eye].height = proj->views[eye].subImage.imageRect.extent.height;
 
                         // Fill out pose and FOV information.
                         XrSpaceLocation location{XR_TYPE_SPACE_LOCATION};
                         CHECK_XRCMD(xrLocateSpace(proj->space, m_originSpace, frameEndInfo->displayTime, &location));
-                        layer.EyeFov.RenderPose[eye] =
-                            xrPoseToPvrPose(Pose::Multiply(proj->views[eye].pose, location.pose));
-
-                        layer.EyeFov.Fov[eye].DownTan = -tan(proj->views[eye].fov.angleDown);
-                        layer.EyeFov.Fov[eye].UpTan = tan(proj->views[eye].fov.angleUp);
-                        layer.EyeFov.Fov[eye].LeftTan = -tan(proj->views[eye].fov.angleLeft);
-                        layer.EyeFov.Fov[eye].RightTan = tan(proj->views[eye].fov.angleRight);
+                        if (!isReprojected) {
+                            layer.EyeFov.RenderPose[eye] =
+                                xrPoseToPvrPose(Pose::Multiply(proj->views[eye].pose, location.pose));
+
+                            layer.EyeFov.Fov[eye].DownTan = -tan(proj->views[eye].fov.angleDown);
+                            layer.EyeFov.Fov[eye].UpTan = tan(proj->views[eye].fov.angleUp);
+                            layer.EyeFov.Fov[eye].LeftTan = -tan(proj->views[eye].fov.angleLeft);
+                            layer.EyeFov.Fov[eye].RightTan = tan(proj->views[eye].fov.angleRight);
+                        } else {
+                            // Restore the canting of the view, that was eliminated by parallel projection.
+                            const float angle = !eye ? m_cantingAngle : -m_cantingAngle;
+                            const XrPosef canting =
+                                Pose::MakePose(Quaternion::RotationRollPitchYaw({0.f, angle, 0.f}), XrVector3f{});
+                            layer.EyeFov.RenderPose[eye] = xrPoseToPvrPose(
+                                Pose::Multiply(Pose::Multiply(canting, proj->views[eye].pose), location.pose));
+
+                            layer.EyeFov.Fov[eye] = m_cachedEyeInfo[eye].Fov;
+                        }
 
                         // Other applications (eg: SteamVR) always pass 0, and I am observing strange flickering when
                         // passing any other value. Let's follow what SteamVR does.
                         layer.EyeFov.SensorSampleTime = 0;
 
-                        // Submit depth.
+                        // Submit depth, either from the depth extension or from the space warp information.
+                        const auto submitDepth =
+                            [&](const XrSwapchainSubImage& subImage, float nearZ, float farZ) -> XrResult {
+                            if (!m_swapchains.contains(subImage.swapchain)) {
+                                return XR_ERROR_HANDLE_INVALID;
+                            }
+
+                            Swapchain& xrDepthSwapchain = *m_swapchains.get(subImage.swapchain);
+
+                            if (xrDepthSwapchain.lastReleasedIndex == -1) {
+                                return XR_ERROR_LAYER_INVALID;
+                            }
+
+                            if (subImage.imageArrayIndex >= xrDepthSwapchain.xrDesc.arraySize) {
+                                return XR_ERROR_VALIDATION_FAILURE;
+                            }
+
+                            if (!isValidSwapchainRect(xrDepthSwapchain.pvrDesc, subImage.imageRect)) {
+                                return XR_ERROR_SWAPCHAIN_RECT_INVALID;
+                            }
+
+                            // The depth buffer is not reprojected along with the color of canted views.
+                            if (!submitDepthToPvr || isReprojected) {
+                                return XR_SUCCESS;
+                            }
+
+                            layer.Header.Type = pvrLayerType_EyeFovDepth;
+
+                            // Fill out depth buffer information.
+                            prepareAndCommitSwapchainImage(xrDepthSwapchain,
+                                                           i,
+                                                           subImage.imageArrayIndex,
+                                                           0,
+                                                           swapchainRegions,
+                                                           committedSwapchainImages);
+                            layer.EyeFovDepth.DepthTexture[eye] =
+                                xrDepthSwapchain.pvrSwapchain[subImage.imageArrayIndex];
+
+                            // Fill out projection information.
+                            layer.EyeFovDepth.DepthProjectionDesc.Projection22 = farZ / (nearZ - farZ);
+                            layer.EyeFovDepth.DepthProjectionDesc.Projection23 = (farZ * nearZ) / (nearZ - farZ);
+                            layer.EyeFovDepth.DepthProjectionDesc.Projection32 = -1.f;
+
+                            return XR_SUCCESS;
+                        };
+
+                        bool hasDepth = false;
                         if (has_XR_KHR_composition_layer_depth) {
                             const XrBaseInStructure* entry =
                                 reinterpret_cast<const XrBaseInStructure*>(proj->views[eye].next);
@@ -496,8 +804,6 @@ namespace pimax_openxr {
                                     const XrCompositionLayerDepthInfoKHR* depth =
                                         reinterpret_cast<const XrCompositionLayerDepthInfoKHR*>(entry);
 
-                                    layer.Header.Type = pvrLayerType_EyeFovDepth;
-
                                     TraceLoggingWrite(
                                         g_traceProvider,
                                         "xrEndFrame_View",
@@ -512,39 +818,76 @@ namespace pimax_openxr {
                                         TLArg(depth->maxDepth, "MaxDepth"));
                                     LOG_TELEMETRY_ONCE(logFeature("Depth"));
 
-                                    if (!m_swapchains.count(depth->subImage.swapchain)) {
+                                    const auto result = submitDepth(depth->subImage, depth->nearZ, depth->farZ);
+                                    if (XR_FAILED(result)) {
+                                        return result;
+                                    }
+                                    hasDepth = true;
+
+                                    break;
+                                }
+                                entry = entry->next;
+                            }
+                        }
+
+                        // PVR has no use for the motion vectors, but its reprojection consumes the depth.
+                        if (has_XR_FB_space_warp) {
+                            const XrBaseInStructure* entry =
+                                reinterpret_cast<const XrBaseInStructure*>(proj->views[eye].next);
+                            while (entry) {
+                                if (entry->type == XR_TYPE_COMPOSITION_LAYER_SPACE_WARP_INFO_FB) {
+                                    const XrCompositionLayerSpaceWarpInfoFB* spaceWarp =
+                                        reinterpret_cast<const XrCompositionLayerSpaceWarpInfoFB*>(entry);
+
+                                    TraceLoggingWrite(
+                                        g_traceProvider,
+                                        "xrEndFrame_View",
+                                        TLArg("SpaceWarp", "Type"),
+                                        TLArg(eye, "Index"),
+                                        TLArg(spaceWarp->layerFlags, "Flags"),
+                                        TLXArg(spaceWarp->motionVectorSubImage.swapchain, "MotionVectorSwapchain"),
+                                        TLXArg(spaceWarp->depthSubImage.swapchain, "DepthSwapchain"),
+                                        TLArg(spaceWarp->nearZ, "Near"),
+                                        TLArg(spaceWarp->farZ, "Far"));
+                                    LOG_TELEMETRY_ONCE(logFeature("SpaceWarp"));
+
+                                    if (!Quaternion::IsNormalized(spaceWarp->appSpaceDeltaPose.orientation)) {
+                                        return XR_ERROR_POSE_INVALID;
+                                    }
+
+                                    if (!m_swapchains.contains(spaceWarp->motionVectorSubImage.swapchain)) {
                                         return XR_ERROR_HANDLE_INVALID;
                                     }
 
-                                    Swapchain& xrDepthSwapchain = *(Swapchain*)depth->subImage.swapchain;
+                                    const Swapchain& xrMotionVectorSwapchain =
+                                        *m_swapchains.get(spaceWarp->motionVectorSubImage.swapchain);
 
-                                    if (xrDepthSwapchain.lastReleasedIndex == -1) {
+                                    if (xrMotionVectorSwapchain.lastReleasedIndex == -1) {
                                         return XR_ERROR_LAYER_INVALID;
                                     }
 
-                                    if (depth->subImage.imageArrayIndex >= xrDepthSwapchain.xrDesc.arraySize) {
+                                    if (spaceWarp->motionVectorSubImage.imageArrayIndex >=
+                                        xrMotionVectorSwapchain.xrDesc.arraySize) {
                                         return XR_ERROR_VALIDATION_FAILURE;
                                     }
 
-                                    // Fill out depth buffer information.
-                                    prepareAndCommitSwapchainImage(xrDepthSwapchain,
-                                                                   i,
-                                                                   depth->subImage.imageArrayIndex,
-                                                                   0,
-                                                                   committedSwapchainImages);
-                                    layer.EyeFovDepth.DepthTexture[eye] =
-                                        xrDepthSwapchain.pvrSwapchain[depth->subImage.imageArrayIndex];
-
-                                    if (!isValidSwapchainRect(xrDepthSwapchain.pvrDesc, depth->subImage.imageRect)) {
+                                    if (!isValidSwapchainRect(xrMotionVectorSwapchain.pvrDesc,
+                                                              spaceWarp->motionVectorSubImage.imageRect)) {
                                         return XR_ERROR_SWAPCHAIN_RECT_INVALID;
                                     }
 
-                                    // Fill out projection information.
-                                    layer.EyeFovDepth.DepthProjectionDesc.Projection22 =
-                                        depth->farZ / (depth->nearZ - depth->farZ);
-                                    layer.EyeFovDepth.DepthProjectionDesc.Projection23 =
-                                        (depth->farZ * depth->nearZ) / (depth->nearZ - depth->farZ);
-                                    layer.EyeFovDepth.DepthProjectionDesc.Projection32 = -1.f;
+                                    const bool isFrameSkipped =
+                                        spaceWarp->layerFlags & XR_COMPOSITION_LAYER_SPACE_WARP_INFO_FRAME_SKIP_BIT_FB;
+                                    if (!isFrameSkipped) {
+                                        if (!hasDepth) {
+                                            const auto result = submitDepth(
+                                                spaceWarp->depthSubImage, spaceWarp->nearZ, spaceWarp->farZ);
+                                            if (XR_FAILED(result)) {
+                                                return result;
+                                            }
+                                        }
+                                        hasSpaceWarp = true;
+                                    }
 
                                     break;
                                 }
@@ -578,11 +921,11 @@ namespace pimax_openxr {
                         return XR_ERROR_POSE_INVALID;
                     }
 
-                    if (!m_swapchains.count(quad->subImage.swapchain)) {
+                    if (!m_swapchains.contains(quad->subImage.swapchain)) {
                         return XR_ERROR_HANDLE_INVALID;
                     }
 
-                    Swapchain& xrSwapchain = *(Swapchain*)quad->subImage.swapchain;
+                    Swapchain& xrSwapchain = *m_swapchains.get(quad->subImage.swapchain);
 
                     if (xrSwapchain.lastReleasedIndex == -1) {
                         return XR_ERROR_LAYER_INVALID;
@@ -598,11 +941,34 @@ namespace pimax_openxr {
                         return XR_ERROR_VALIDATION_FAILURE;
                     }
 
+                    // Merged quads are submitted as a single layer in place of the last quad of their group.
+                    if (nextFlattenedLayers < flattenedLayers.size() &&
+                        i >= flattenedLayers[nextFlattenedLayers].firstLayer) {
+                        const FlattenedLayers& group = flattenedLayers[nextFlattenedLayers];
+                        if (i + 1 < group.firstLayer + group.layerCount) {
+                            continue;
+                        }
+
+                        layer.Quad.ColorTexture = flattenQuadLayers(frameEndInfo, group, nextFlattenedLayers);
+                        layer.Quad.Viewport.x = layer.Quad.Viewport.y = 0;
+                        layer.Quad.Viewport.width = group.extent.width;
+                        layer.Quad.Viewport.height = group.extent.height;
+                        layer.Header.Flags |= pvrLayerFlag_HeadLocked;
+                        layer.Quad.QuadPoseCenter = xrPoseToPvrPose(group.pose);
+                        layer.Quad.QuadSize.x = group.size.width;
+                        layer.Quad.QuadSize.y = group.size.height;
+
+                        nextFlattenedLayers++;
+                        layers.push_back(&layer.Header);
+                        continue;
+                    }
+
                     // Fill out color buffer information.
                     prepareAndCommitSwapchainImage(xrSwapchain,
                                                    i,
                                                    quad->subImage.imageArrayIndex,
                                                    frameEndInfo->layers[i]->layerFlags,
+                                                   swapchainRegions,
                                                    committedSwapchainImages);
                     layer.Quad.ColorTexture = xrSwapchain.pvrSwapchain[quad->subImage.imageArrayIndex];
 
@@ -614,10 +980,10 @@ namespace pimax_openxr {
                     layer.Quad.Viewport.width = quad->subImage.imageRect.extent.width;
                     layer.Quad.Viewport.height = quad->subImage.imageRect.extent.height;
 
-                    if (!m_spaces.count(quad->space)) {
+                    if (!m_spaces.contains(quad->space)) {
                         return XR_ERROR_HANDLE_INVALID;
                     }
-                    Space& xrSpace = *(Space*)quad->space;
+                    Space& xrSpace = *m_spaces.get(quad->space);
 
                     // Fill out pose and quad information.
                     if (xrSpace.referenceType != XR_REFERENCE_SPACE_TYPE_VIEW) {
@@ -640,12 +1006,11 @@ namespace pimax_openxr {
                 layers.push_back(&layer.Header);
             }
 
-            {
-                // Defer initialization of guardian resources until they are first needed.
-                if (m_guardianSpace == XR_NULL_HANDLE) {
-                    initializeGuardianResources();
-                }
-
+            // The guardian texture is loaded asynchronously when the session begins.
+            if (m_guardianReady && m_guardianTexture) {
+                createGuardianSwapchain();
+            }
+            if (m_guardianReady && m_guardianSwapchain) {
                 // Measure the floor distance between the center of the guardian and the headset.
                 XrSpaceLocation viewToBase{XR_TYPE_SPACE_LOCATION};
                 CHECK_XRCMD(xrLocateSpace(m_viewSpace, m_originSpace, frameEndInfo->displayTime, &viewToBase));
@@ -654,9 +1019,10 @@ namespace pimax_openxr {
                 if (Pose::IsPoseValid(viewToBase.locationFlags) && Pose::IsPoseValid(guardianToBase.locationFlags) &&
                     Length(XrVector3f{guardianToBase.pose.position.x, 0.f, guardianToBase.pose.position.z} -
                            XrVector3f{viewToBase.pose.position.x, 0.f, viewToBase.pose.position.z}) >
-                        m_guardianThreshold) {
+                        settings.guardianThreshold) {
                     // Draw the guardian on top of everything.
                     auto& layer = layersAllocator[layers.size()];
+                    layer = {};
                     layer.Header.Type = pvrLayerType_Quad;
                     layer.Header.Flags = pvrLayerFlag_HeadLocked;
                     layer.Quad.ColorTexture = m_guardianSwapchain;
@@ -667,7 +1033,7 @@ namespace pimax_openxr {
                     // Place the guardian in 3D space as a 2D overlay.
                     layer.Quad.QuadPoseCenter =
                         xrPoseToPvrPose(Pose::Multiply(guardianToBase.pose, Pose::Invert(viewToBase.pose)));
-                    layer.Quad.QuadSize.x = layer.Quad.QuadSize.y = m_guardianRadius * 2;
+                    layer.Quad.QuadSize.x = layer.Quad.QuadSize.y = settings.guardianRadius * 2;
 
                     // If there are too many layer, prioritize the guardian to be safe.
                     if (layers.size() < pvrMaxLayerCount) {
@@ -678,10 +1044,14 @@ namespace pimax_openxr {
                 }
             }
 
-            if (IsTraceEnabled()) {
+            if (measurePrecomposition) {
                 m_gpuTimerPrecomposition[m_currentTimerIndex]->stop();
             }
 
+            // When opted in, apps submitting space warp information are paced at half the refresh rate, and PVR
+            // reprojects the skipped frames. PVR does not consume the motion vectors, hence this is off by default.
+            m_isSpaceWarpHalfRate = hasSpaceWarp && m_useSpaceWarpHalfRate;
+
             // Update the FPS counter.
             const auto now = pvr_getTimeSeconds(m_pvr);
             m_frameTimes.push_back(now);
@@ -690,38 +1060,71 @@ namespace pimax_openxr {
             }
 
             // Add a dummy layer so we can still call pvr_endFrame() for timing purposes.
-            pvrLayerHeader dummyLayer{};
             if (layers.empty()) {
-                dummyLayer.Type = pvrLayerType_Disabled;
-                layers.push_back(&dummyLayer);
+                auto& dummyLayer = layersAllocator[0];
+                dummyLayer = {};
+                dummyLayer.Header.Type = pvrLayerType_Disabled;
+                layers.push_back(&dummyLayer.Header);
             }
 
             // Submit the layers to PVR.
             if (m_useFrameTimingOverride) {
+                // Multiplier is a percentage. Convert to milliseconds (*10) then convert the whole expression
+                // (including frame duration) from milliseconds to microseconds.
+                const double appFrameDuration = m_frameDuration * getFramePacing();
+                const uint64_t frameTimeOverrideUs =
+                    (uint64_t)(settings.frameTimeOverrideMultiplier * 10.f * appFrameDuration * 1000.f);
+
                 float renderMs = 0.f;
-                if (!m_frameTimeOverrideUs) {
+                if (!frameTimeOverrideUs && settings.frameTimePredictorType == FrameTimePredictorType::Adaptive) {
+                    m_frameTimeFilterCount = 0;
+
+                    // The frame time is bound by either the app CPU time or the GPU time (including our own
+                    // composition work).
+                    const auto latestFrameTimeUs =
+                        std::max(m_lastCpuFrameTimeUs, m_lastGpuFrameTimeUs + lastPrecompositionTime);
+                    const auto predictedFrameTimeUs = m_frameTimePredictor.update((double)latestFrameTimeUs);
+                    TraceLoggingWrite(g_traceProvider,
+                                      "FrameTimePredictor",
+                                      TLArg(latestFrameTimeUs, "LatestFrameTimeUs"),
+                                      TLArg(predictedFrameTimeUs, "PredictedFrameTimeUs"));
+
+                    renderMs = std::max(0ll, (int64_t)predictedFrameTimeUs + settings.frameTimeOverrideOffsetUs) / 1e3f;
+                } else if (!frameTimeOverrideUs) {
+                    m_frameTimePredictor.reset();
+
                     // No inherent biasing today. Might change in the future.
-                    // TODO: We should account for m_lastCpuFrameTimeUs here.
-                    const auto biasedCpuFrameTimeUs = 0ll;
+                    // An app bound by its CPU time must not be hinted its (shorter) GPU time.
+                    const auto biasedCpuFrameTimeUs = (int64_t)m_lastCpuFrameTimeUs + 0;
                     const auto biasedGpuFrameTimeUs = (int64_t)m_lastGpuFrameTimeUs + 0;
 
                     const auto latestFrameTimeUs = std::max(
-                        0ll, std::max(biasedCpuFrameTimeUs, biasedGpuFrameTimeUs) + m_frameTimeOverrideOffsetUs);
+                        0ll, std::max(biasedCpuFrameTimeUs, biasedGpuFrameTimeUs) + settings.frameTimeOverrideOffsetUs);
 
                     // Simple median filter to smooth out the values.
-                    m_frameTimeFilter.push_back(latestFrameTimeUs);
-                    while (m_frameTimeFilter.size() > m_frameTimeFilterLength) {
-                        m_frameTimeFilter.pop_front();
+                    m_frameTimeFilter[m_frameTimeFilterIndex] = latestFrameTimeUs;
+                    m_frameTimeFilterIndex = (m_frameTimeFilterIndex + 1) % k_maxFrameTimeFilterLength;
+                    m_frameTimeFilterCount = std::min(m_frameTimeFilterCount + 1, k_maxFrameTimeFilterLength);
+
+                    // Only consider the most recent values.
+                    const size_t filterLength = std::min(settings.frameTimeFilterLength, m_frameTimeFilterCount);
+                    std::array<uint64_t, k_maxFrameTimeFilterLength> sortedFrameTimes;
+                    for (size_t i = 0; i < filterLength; i++) {
+                        sortedFrameTimes[i] = m_frameTimeFilter[(m_frameTimeFilterIndex + k_maxFrameTimeFilterLength -
+                                                                 1 - i) %
+                                                                k_maxFrameTimeFilterLength];
                     }
-                    auto sortedFrameTimes = m_frameTimeFilter;
-                    std::sort(sortedFrameTimes.begin(), sortedFrameTimes.end());
+                    std::nth_element(sortedFrameTimes.begin(),
+                                     sortedFrameTimes.begin() + filterLength / 2,
+                                     sortedFrameTimes.begin() + filterLength);
 
-                    const auto filteredFrameTimeUs = sortedFrameTimes[sortedFrameTimes.size() / 2];
+                    const auto filteredFrameTimeUs = sortedFrameTimes[filterLength / 2];
                     renderMs = filteredFrameTimeUs / 1e3f;
                 } else {
-                    m_frameTimeFilter.clear();
+                    m_frameTimeFilterCount = 0;
+                    m_frameTimePredictor.reset();
 
-                    renderMs = std::max(0ll, (int64_t)m_frameTimeOverrideUs + m_frameTimeOverrideOffsetUs) / 1e3f;
+                    renderMs = std::max(0ll, (int64_t)frameTimeOverrideUs + settings.frameTimeOverrideOffsetUs) / 1e3f;
                 }
 
                 TraceLoggingWrite(g_traceProvider, "PVR_ClientRenderMs", TLArg(renderMs, "RenderMs"));
@@ -729,50 +1132,417 @@ namespace pimax_openxr {
                 // pi_server requires to set this config value to hint the frame time of the application. This call
                 // always seems to fail, in spite of having side effects.
                 // According to Pimax, this value must be set to the last GPU frame time.
+                std::unique_lock pvrLock(m_pvrLock);
                 pvr_setFloatConfig(m_pvrSession, "openvr_client_render_ms", renderMs);
             }
 
             const long long pvrFrameId = m_frameBegun - 1;
-            TraceLocalActivity(endFrame);
+            if (!m_useAsyncSubmission) {
+                submitLayers(
+                    pvrFrameId, layers.data(), (unsigned int)layers.size(), m_frameTimes.size(), lastPrecompositionTime);
+            } else {
+                // Hand off the layers to the submission thread. The frame arena remains untouched until the next call
+                // to xrEndFrame(), which waits for the submission to complete.
+                std::unique_lock lock(m_submissionLock);
+                m_pendingSubmission.frameId = pvrFrameId;
+                m_pendingSubmission.measuredFps = m_frameTimes.size();
+                m_pendingSubmission.lastPrecompositionTime = lastPrecompositionTime;
+                m_submissionPending = true;
+                m_submissionCondVar.notify_all();
+            }
+
+            m_currentTimerIndex = (m_currentTimerIndex + 1) % k_numGpuTimers;
+
+            m_sessionTotalFrameCount++;
+
+            // Signal xrBeginFrame().
+            m_frameCompleted = m_frameBegun;
+            updateSessionState();
+            TraceLoggingWrite(g_traceProvider,
+                              "EndFrame_Signal",
+                              TLArg((uint64_t)m_frameWaited, "FrameWaited"),
+                              TLArg((uint64_t)m_frameBegun, "FrameBegun"),
+                              TLArg((uint64_t)m_frameCompleted, "FrameCompleted"));
+        }
+
+        return XR_SUCCESS;
+    }
+
+    // Submit the layers to PVR and present the mirror window.
+    void OpenXrRuntime::submitLayers(long long pvrFrameId,
+                                     pvrLayerHeader* const* layers,
+                                     unsigned int layerCount,
+                                     size_t measuredFps,
+                                     uint64_t lastPrecompositionTime) {
+        TraceLocalActivity(endFrame);
+        {
+            std::unique_lock pvrLock(m_pvrLock);
             TraceLoggingWriteStart(endFrame,
                                    "PVR_EndFrame",
                                    TLArg(pvrFrameId, "FrameIndex"),
-                                   TLArg(layers.size(), "NumLayers"),
-                                   TLArg(m_frameTimes.size(), "MeasuredFps"),
+                                   TLArg(layerCount, "NumLayers"),
+                                   TLArg(measuredFps, "MeasuredFps"),
                                    TLArg(pvr_getFloatConfig(m_pvrSession, "client_fps", 0), "ClientFps"),
                                    TLArg(lastPrecompositionTime, "LastPrecompositionTimeUs"));
-            CHECK_PVRCMD(pvr_endFrame(m_pvrSession, pvrFrameId, layers.data(), (unsigned int)layers.size()));
-            TraceLoggingWriteStop(endFrame, "PVR_EndFrame");
+            LARGE_INTEGER endFrameStart;
+            QueryPerformanceCounter(&endFrameStart);
+            CHECK_PVRCMD(pvr_endFrame(m_pvrSession, pvrFrameId, layers, layerCount));
+            stats::RecordFramePhase(stats::FramePhase::PvrEndFrame, stats::ElapsedUs(endFrameStart));
+        }
+        TraceLoggingWriteStop(endFrame, "PVR_EndFrame");
+        recordFrameLatency(pvrFrameId);
+
+        // Defer initialization of mirror window resources until they are first needed. The mirror window thread would
+        // use the application context behind its back with single-device submission, so it is not offered then.
+        const RuntimeSettings& settings = currentSettings();
+        if (settings.useMirrorWindow && !m_useSingleDeviceSubmission && !m_mirrorWindowThread.joinable()) {
+            createMirrorWindow();
+        }
+
+        // Presentation happens on the mirror window thread, at its own cadence.
+        if (m_mirrorWindowNewFrame) {
+            SetEvent(m_mirrorWindowNewFrame.get());
+        }
 
-            // Defer initialization of mirror window resources until they are first needed.
-            if (m_useMirrorWindow && !m_mirrorWindowThread.joinable()) {
-                createMirrorWindow();
+        if (settings.useMirrorTexture) {
+            if (!m_sharedMirrorTexture) {
+                createMirrorTexture();
             }
-            updateMirrorWindow();
+            double predictedDisplayTime;
+            {
+                std::unique_lock pvrLock(m_pvrLock);
+                predictedDisplayTime = pvr_getPredictedDisplayTime(m_pvrSession, pvrFrameId);
+            }
+            updateMirrorTexture(predictedDisplayTime);
+        }
+
+        // When using RenderDoc, signal a frame through the dummy swapchain.
+        if (m_dxgiSwapchain) {
+            m_dxgiSwapchain->Present(0, 0);
+            m_pvrSubmissionContext->Flush();
+        }
+    }
+
+    void OpenXrRuntime::startSubmissionThread() {
+        m_submissionPending = false;
+        m_stopSubmissionThread = false;
+        m_submissionError = nullptr;
+        m_submissionThread = std::thread([&]() {
+            TraceLoggingWrite(g_traceProvider, "SubmissionThread", TLArg("Started", "State"));
+
+            std::unique_lock lock(m_submissionLock);
+            while (true) {
+                m_submissionCondVar.wait(lock, [&] { return m_submissionPending || m_stopSubmissionThread; });
+                if (!m_submissionPending) {
+                    break;
+                }
+
+                try {
+                    submitLayers(m_pendingSubmission.frameId,
+                                 m_frameArena.layers.data(),
+                                 (unsigned int)m_frameArena.layers.size(),
+                                 m_pendingSubmission.measuredFps,
+                                 m_pendingSubmission.lastPrecompositionTime);
+                } catch (...) {
+                    // Forward the error to the application thread.
+                    m_submissionError = std::current_exception();
+                }
 
-            // When using RenderDoc, signal a frame through the dummy swapchain.
-            if (m_dxgiSwapchain) {
-                m_dxgiSwapchain->Present(0, 0);
-                m_pvrSubmissionContext->Flush();
+                m_submissionPending = false;
+                m_submissionCondVar.notify_all();
             }
 
-            m_frameCompleted = m_frameBegun;
-            updateSessionState();
+            TraceLoggingWrite(g_traceProvider, "SubmissionThread", TLArg("Stopped", "State"));
+        });
+    }
 
-            m_currentTimerIndex = (m_currentTimerIndex + 1) % k_numGpuTimers;
+    void OpenXrRuntime::stopSubmissionThread() {
+        if (!m_submissionThread.joinable()) {
+            return;
+        }
 
-            m_sessionTotalFrameCount++;
+        {
+            std::unique_lock lock(m_submissionLock);
+            m_stopSubmissionThread = true;
+            m_submissionCondVar.notify_all();
+        }
+        m_submissionThread.join();
+        m_submissionError = nullptr;
+    }
+
+    // Wait for the submission thread to be done with the submission context.
+    void OpenXrRuntime::waitForPendingSubmission() {
+        if (!m_submissionThread.joinable()) {
+            return;
+        }
+
+        std::unique_lock lock(m_submissionLock);
+        if (m_submissionPending) {
+            TraceLocalActivity(waitSubmission);
+            TraceLoggingWriteStart(waitSubmission, "WaitSubmission");
+            m_submissionCondVar.wait(lock, [&] { return !m_submissionPending; });
+            TraceLoggingWriteStop(waitSubmission, "WaitSubmission");
+        }
+
+        if (m_submissionError) {
+            std::exception_ptr error;
+            std::swap(error, m_submissionError);
+            std::rethrow_exception(error);
+        }
+    }
+
+    // Derive the latencies of a frame from its timestamps, once it is submitted to PVR. The slot of the frame is not
+    // reused before the next k_frameTimestampsCount - 1 frames are waited, which cannot happen while it is in flight.
+    void OpenXrRuntime::recordFrameLatency(long long pvrFrameId) {
+        FrameTimestamps& timestamps = m_frameTimestamps[pvrFrameId % k_frameTimestampsCount];
+        timestamps.endFrameReturn = pvr_getTimeSeconds(m_pvr);
+
+        const auto toUs = [](double duration) { return (uint64_t)std::max(duration * 1e6, 0.0); };
+        const double poseTime = timestamps.firstPoseQuery ? timestamps.firstPoseQuery : timestamps.waitFrameReturn;
+        const uint64_t latenciesUs[] = {toUs(timestamps.endFrameEntry - timestamps.waitFrameReturn),
+                                        toUs(timestamps.displayTime - poseTime),
+                                        toUs(timestamps.displayTime - timestamps.endFrameReturn)};
+        static_assert(ARRAYSIZE(latenciesUs) == (uint32_t)stats::FrameLatency::Count);
+        for (uint32_t i = 0; i < ARRAYSIZE(latenciesUs); i++) {
+            stats::RecordFrameLatency((stats::FrameLatency)i, latenciesUs[i]);
+            m_frameLatencies[i].record(latenciesUs[i]);
+        }
+
+        TraceLoggingWrite(g_traceProvider,
+                          "FrameLatency",
+                          TLArg(pvrFrameId, "FrameId"),
+                          TLArg(latenciesUs[(uint32_t)stats::FrameLatency::App], "AppLatencyUs"),
+                          TLArg(latenciesUs[(uint32_t)stats::FrameLatency::PoseToDisplay], "PoseToDisplayUs"),
+                          TLArg(latenciesUs[(uint32_t)stats::FrameLatency::SubmitToDisplay], "SubmitToDisplayUs"),
+                          TLArg(timestamps.precompositionGpuUs, "PrecompositionGpuUs"));
+    }
+
+    // The number of refreshes of the panel per app frame.
+    uint32_t OpenXrRuntime::getFramePacing() const {
+        return std::max(m_refreshRateDivisor, m_isSpaceWarpHalfRate ? 2u : 1u);
+    }
+
+    // Steer the recommended resolution so that the app GPU time stays within its budget. The GPU time scales roughly
+    // with the pixel count, hence with the square of the resolution scale.
+    void OpenXrRuntime::updateResolutionScale() {
+        if (!m_lastGpuFrameTimeUs) {
+            return;
+        }
+
+        const double budgetUs = m_frameDuration * getFramePacing() * 1e6 * m_resolutionGpuBudget;
+        const float targetScale = std::clamp(m_resolutionScale * (float)std::sqrt(budgetUs / m_lastGpuFrameTimeUs),
+                                             m_minResolutionScale,
+                                             1.f);
+
+        // The GPU timers lag by k_numGpuTimers frames, so we converge gradually, and recover slower than we back off to
+        // avoid oscillating around the budget.
+        const float rate = targetScale < m_resolutionScale ? 0.2f : 0.05f;
+        m_resolutionScale += (targetScale - m_resolutionScale) * rate;
+
+        TraceLoggingWrite(g_traceProvider,
+                          "ResolutionScale",
+                          TLArg(m_lastGpuFrameTimeUs, "AppRenderGpuTime"),
+                          TLArg(budgetUs, "BudgetUs"),
+                          TLArg(m_resolutionScale, "Scale"));
+    }
+
+    // Find runs of consecutive coplanar quad layers that can be composited into a single quad before submission, to
+    // reduce the number of layers the PVR compositor has to process.
+    void OpenXrRuntime::planLayerFlattening(const XrFrameEndInfo* frameEndInfo, FlattenedLayersList& flattenedLayers) {
+        flattenedLayers.clear();
+        if (!m_useLayerFlattening) {
+            return;
+        }
+
+        // Quads are submitted head-locked, so they are compared in view space.
+        const auto getQuadPoseInView = [&](const XrCompositionLayerQuad* quad, XrPosef& pose) {
+            if (!m_spaces.contains(quad->space)) {
+                return false;
+            }
+            Space& xrSpace = *m_spaces.get(quad->space);
+            if (xrSpace.referenceType != XR_REFERENCE_SPACE_TYPE_VIEW) {
+                XrSpaceLocation location{XR_TYPE_SPACE_LOCATION};
+                CHECK_XRCMD(xrLocateSpace(quad->space, m_viewSpace, frameEndInfo->displayTime, &location));
+                pose = Pose::Multiply(quad->pose, location.pose);
+            } else {
+                pose = Pose::Multiply(quad->pose, xrSpace.poseInSpace);
+            }
+            return true;
+        };
+
+        const auto isFlattenable = [&](const XrCompositionLayerBaseHeader* header) {
+            if (!header || header->type != XR_TYPE_COMPOSITION_LAYER_QUAD) {
+                return false;
+            }
+            const XrCompositionLayerQuad* quad = reinterpret_cast<const XrCompositionLayerQuad*>(header);
+            if (!Quaternion::IsNormalized(quad->pose.orientation) || quad->size.width <= 0.f ||
+                quad->size.height <= 0.f || !m_swapchains.contains(quad->subImage.swapchain)) {
+                return false;
+            }
+            const Swapchain& xrSwapchain = *m_swapchains.get(quad->subImage.swapchain);
+            return xrSwapchain.lastReleasedIndex != -1 &&
+                   quad->subImage.imageArrayIndex < xrSwapchain.xrDesc.arraySize &&
+                   isValidSwapchainRect(xrSwapchain.pvrDesc, quad->subImage.imageRect) &&
+                   !xrSwapchain.needDepthConvert && !xrSwapchain.needDownsample && !xrSwapchain.slices[0].empty() &&
+                   isUnorderedAccessSupported(xrSwapchain.dxgiFormatForSubmission);
+        };
+
+        uint32_t i = 0;
+        while (i < frameEndInfo->layerCount && flattenedLayers.size() < pvrMaxLayerCount / 2) {
+            XrPosef leaderPose;
+            if (!isFlattenable(frameEndInfo->layers[i]) ||
+                !getQuadPoseInView(reinterpret_cast<const XrCompositionLayerQuad*>(frameEndInfo->layers[i]),
+                                   leaderPose)) {
+                i++;
+                continue;
+            }
+            const XrCompositionLayerQuad* leader =
+                reinterpret_cast<const XrCompositionLayerQuad*>(frameEndInfo->layers[i]);
+            const Swapchain& leaderSwapchain = *m_swapchains.get(leader->subImage.swapchain);
+
+            // Extend the run with the following quads sharing the plane and properties of the first one.
+            XrPosef relativePoses[k_maxFlattenedLayers];
+            relativePoses[0] = Pose::Identity();
+            uint32_t count = 1;
+            while (count < k_maxFlattenedLayers && i + count < frameEndInfo->layerCount) {
+                const XrCompositionLayerBaseHeader* header = frameEndInfo->layers[i + count];
+                XrPosef pose;
+                if (!isFlattenable(header) ||
+                    !getQuadPoseInView(reinterpret_cast<const XrCompositionLayerQuad*>(header), pose)) {
+                    break;
+                }
+                const XrCompositionLayerQuad* quad = reinterpret_cast<const XrCompositionLayerQuad*>(header);
+                const Swapchain& xrSwapchain = *m_swapchains.get(quad->subImage.swapchain);
+                if (xrSwapchain.dxgiFormatForSubmission != leaderSwapchain.dxgiFormatForSubmission ||
+                    quad->eyeVisibility != leader->eyeVisibility) {
+                    break;
+                }
+
+                // Only quads facing the same way and in the same plane (within 1mm) can be merged without
+                // changing their appearance.
+                const XrPosef relative = Pose::Multiply(pose, Pose::Invert(leaderPose));
+                if (std::abs(relative.orientation.w) < 0.99999f || std::abs(relative.position.z) >= 0.001f) {
+                    break;
+                }
+                relativePoses[count++] = relative;
+            }
+
+            if (count < 2) {
+                i++;
+                continue;
+            }
+
+            FlattenedLayers group{};
+            group.firstLayer = i;
+            group.layerCount = count;
+
+            // Compute the bounding box of the quads in the plane of the first quad.
+            float minX = FLT_MAX, minY = FLT_MAX, maxX = -FLT_MAX, maxY = -FLT_MAX;
+            float pixelsPerMeter = 0.f;
+            for (uint32_t j = 0; j < count; j++) {
+                const XrCompositionLayerQuad* quad =
+                    reinterpret_cast<const XrCompositionLayerQuad*>(frameEndInfo->layers[i + j]);
+                XrRect2Df& rect = group.rects[j];
+                rect.offset.x = relativePoses[j].position.x - quad->size.width / 2;
+                rect.offset.y = relativePoses[j].position.y - quad->size.height / 2;
+                rect.extent = quad->size;
+                minX = std::min(minX, rect.offset.x);
+                minY = std::min(minY, rect.offset.y);
+                maxX = std::max(maxX, rect.offset.x + rect.extent.width);
+                maxY = std::max(maxY, rect.offset.y + rect.extent.height);
+
+                // Preserve the resolution of the sharpest quad.
+                pixelsPerMeter = std::max({pixelsPerMeter,
+                                           quad->subImage.imageRect.extent.width / quad->size.width,
+                                           quad->subImage.imageRect.extent.height / quad->size.height});
+            }
+            for (uint32_t j = 0; j < count; j++) {
+                group.rects[j].offset.x -= minX;
+                group.rects[j].offset.y -= minY;
+            }
+            group.size = {maxX - minX, maxY - minY};
+            group.pose =
+                Pose::Multiply(Pose::Translation({(minX + maxX) / 2, (minY + maxY) / 2, 0.f}), leaderPose);
+            group.extent.width = std::clamp((int)std::ceil(group.size.width * pixelsPerMeter), 1, 4096);
+            group.extent.height = std::clamp((int)std::ceil(group.size.height * pixelsPerMeter), 1, 4096);
 
-            // Signal xrBeginFrame().
             TraceLoggingWrite(g_traceProvider,
-                              "EndFrame_Signal",
-                              TLArg(m_frameWaited, "FrameWaited"),
-                              TLArg(m_frameBegun, "FrameBegun"),
-                              TLArg(m_frameCompleted, "FrameCompleted"));
-            m_frameCondVar.notify_one();
+                              "FlattenLayers",
+                              TLArg(group.firstLayer, "FirstLayer"),
+                              TLArg(group.layerCount, "LayerCount"),
+                              TLArg(group.extent.width, "Width"),
+                              TLArg(group.extent.height, "Height"));
+
+            flattenedLayers.push_back(group);
+            i += count;
         }
+    }
 
-        return XR_SUCCESS;
+    // Compute the region of each swapchain image that the layers are referencing, so we only process what is needed.
+    // Invalid layers are ignored here, and are rejected later when constructing the PVR layers.
+    void OpenXrRuntime::collectSwapchainRegions(const XrFrameEndInfo* frameEndInfo, SwapchainRegions& regions) const {
+        regions.clear();
+
+        const auto addRegion = [&](const XrSwapchainSubImage& subImage, int eye = -1, const XrFovf& fov = {}) {
+            if (!m_swapchains.contains(subImage.swapchain)) {
+                return;
+            }
+
+            const Swapchain& xrSwapchain = *m_swapchains.get(subImage.swapchain);
+            if (subImage.imageArrayIndex >= xrSwapchain.xrDesc.arraySize ||
+                !isValidSwapchainRect(xrSwapchain.pvrDesc, subImage.imageRect)) {
+                return;
+            }
+
+            for (auto& region : regions) {
+                if (region.swapchain == &xrSwapchain && region.slice == subImage.imageArrayIndex) {
+                    const auto right = std::max(region.rect.offset.x + region.rect.extent.width,
+                                                subImage.imageRect.offset.x + subImage.imageRect.extent.width);
+                    const auto bottom = std::max(region.rect.offset.y + region.rect.extent.height,
+                                                 subImage.imageRect.offset.y + subImage.imageRect.extent.height);
+                    region.rect.offset.x = std::min(region.rect.offset.x, subImage.imageRect.offset.x);
+                    region.rect.offset.y = std::min(region.rect.offset.y, subImage.imageRect.offset.y);
+                    region.rect.extent.width = right - region.rect.offset.x;
+                    region.rect.extent.height = bottom - region.rect.offset.y;
+                    if (region.eye != eye) {
+                        region.eye = -1;
+                    }
+                    return;
+                }
+            }
+
+            regions.push_back({&xrSwapchain, subImage.imageArrayIndex, subImage.imageRect, eye, fov});
+        };
+
+        for (uint32_t i = 0; i < frameEndInfo->layerCount; i++) {
+            if (!frameEndInfo->layers[i]) {
+                continue;
+            }
+
+            if (frameEndInfo->layers[i]->type == XR_TYPE_COMPOSITION_LAYER_PROJECTION) {
+                const XrCompositionLayerProjection* proj =
+                    reinterpret_cast<const XrCompositionLayerProjection*>(frameEndInfo->layers[i]);
+                for (uint32_t eye = 0; eye < std::min(proj->viewCount, (uint32_t)xr::StereoView::Count); eye++) {
+                    const XrFovf& fov = proj->views[eye].fov;
+                    addRegion(proj->views[eye].subImage, eye, fov);
+
+                    const XrBaseInStructure* entry = reinterpret_cast<const XrBaseInStructure*>(proj->views[eye].next);
+                    while (entry) {
+                        if (entry->type == XR_TYPE_COMPOSITION_LAYER_DEPTH_INFO_KHR) {
+                            addRegion(
+                                reinterpret_cast<const XrCompositionLayerDepthInfoKHR*>(entry)->subImage, eye, fov);
+                        } else if (entry->type == XR_TYPE_COMPOSITION_LAYER_SPACE_WARP_INFO_FB) {
+                            addRegion(reinterpret_cast<const XrCompositionLayerSpaceWarpInfoFB*>(entry)->depthSubImage,
+                                      eye,
+                                      fov);
+                        }
+                        entry = entry->next;
+                    }
+                }
+            } else if (frameEndInfo->layers[i]->type == XR_TYPE_COMPOSITION_LAYER_QUAD) {
+                addRegion(reinterpret_cast<const XrCompositionLayerQuad*>(frameEndInfo->layers[i])->subImage);
+            }
+        }
     }
 
 } // namespace pimax_openxr
@@ -27,6 +27,7 @@
 
 #include "dispatch.h"
 #include "log.h"
+#include "perf_stats.h"
 
 #ifndef RUNTIME_NAMESPACE
 #error Must define RUNTIME_NAMESPACE
@@ -36,9 +37,90 @@ namespace RUNTIME_NAMESPACE {
     using namespace RUNTIME_NAMESPACE::log;
 
 
+	// Auto-generated names of the APIs, indexed like the performance statistics.
+	const char* const g_apiNames[] = {
+		"xrEnumerateInstanceExtensionProperties",
+		"xrCreateInstance",
+		"xrGetInstanceProperties",
+		"xrPollEvent",
+		"xrResultToString",
+		"xrStructureTypeToString",
+		"xrGetSystem",
+		"xrGetSystemProperties",
+		"xrEnumerateEnvironmentBlendModes",
+		"xrCreateSession",
+		"xrDestroySession",
+		"xrEnumerateReferenceSpaces",
+		"xrCreateReferenceSpace",
+		"xrGetReferenceSpaceBoundsRect",
+		"xrCreateActionSpace",
+		"xrLocateSpace",
+		"xrDestroySpace",
+		"xrEnumerateViewConfigurations",
+		"xrGetViewConfigurationProperties",
+		"xrEnumerateViewConfigurationViews",
+		"xrEnumerateSwapchainFormats",
+		"xrCreateSwapchain",
+		"xrDestroySwapchain",
+		"xrEnumerateSwapchainImages",
+		"xrAcquireSwapchainImage",
+		"xrWaitSwapchainImage",
+		"xrReleaseSwapchainImage",
+		"xrBeginSession",
+		"xrEndSession",
+		"xrRequestExitSession",
+		"xrWaitFrame",
+		"xrBeginFrame",
+		"xrEndFrame",
+		"xrLocateViews",
+		"xrStringToPath",
+		"xrPathToString",
+		"xrCreateActionSet",
+		"xrDestroyActionSet",
+		"xrCreateAction",
+		"xrDestroyAction",
+		"xrSuggestInteractionProfileBindings",
+		"xrAttachSessionActionSets",
+		"xrGetCurrentInteractionProfile",
+		"xrGetActionStateBoolean",
+		"xrGetActionStateFloat",
+		"xrGetActionStateVector2f",
+		"xrGetActionStatePose",
+		"xrSyncActions",
+		"xrEnumerateBoundSourcesForAction",
+		"xrGetInputSourceLocalizedName",
+		"xrApplyHapticFeedback",
+		"xrStopHapticFeedback",
+		"xrGetOpenGLGraphicsRequirementsKHR",
+		"xrGetVulkanInstanceExtensionsKHR",
+		"xrGetVulkanDeviceExtensionsKHR",
+		"xrGetVulkanGraphicsDeviceKHR",
+		"xrGetVulkanGraphicsRequirementsKHR",
+		"xrGetD3D11GraphicsRequirementsKHR",
+		"xrGetD3D12GraphicsRequirementsKHR",
+		"xrGetVisibilityMaskKHR",
+		"xrConvertWin32PerformanceCounterToTimeKHR",
+		"xrConvertTimeToWin32PerformanceCounterKHR",
+		"xrCreateVulkanInstanceKHR",
+		"xrCreateVulkanDeviceKHR",
+		"xrGetVulkanGraphicsDevice2KHR",
+		"xrGetVulkanGraphicsRequirements2KHR",
+		"xrCreateHandTrackerEXT",
+		"xrDestroyHandTrackerEXT",
+		"xrLocateHandJointsEXT",
+		"xrEnumerateDisplayRefreshRatesFB",
+		"xrGetDisplayRefreshRateFB",
+		"xrRequestDisplayRefreshRateFB",
+		"xrLocateSpacesKHR",
+		"xrGetRecommendedLayerResolutionMETA",
+	};
+	const uint32_t g_apiCount = (uint32_t)std::size(g_apiNames);
+
 	// Auto-generated wrappers for the APIs.
 
 	XrResult XRAPI_CALL xrEnumerateInstanceExtensionProperties(const char* layerName, uint32_t propertyCapacityInput, uint32_t* propertyCountOutput, XrExtensionProperties* properties) {
+		stats::ApiCallTimer apiCallTimer(0);
+
 		TraceLocalActivity(local);
 		TraceLoggingWriteStart(local, "xrEnumerateInstanceExtensionProperties");
 
@@ -60,6 +142,8 @@ namespace RUNTIME_NAMESPACE {
 	}
 
 	XrResult XRAPI_CALL xrCreateInstance(const XrInstanceCreateInfo* createInfo, XrInstance* instance) {
+		stats::ApiCallTimer apiCallTimer(1);
+
 		TraceLocalActivity(local);
 		TraceLoggingWriteStart(local, "xrCreateInstance");
 
@@ -81,6 +165,8 @@ namespace RUNTIME_NAMESPACE {
 	}
 
 	XrResult XRAPI_CALL xrGetInstanceProperties(XrInstance instance, XrInstanceProperties* instanceProperties) {
+		stats::ApiCallTimer apiCallTimer(2);
+
 		TraceLocalActivity(local);
 		TraceLoggingWriteStart(local, "xrGetInstanceProperties");
 
@@ -102,6 +188,8 @@ namespace RUNTIME_NAMESPACE {
 	}
 
 	XrResult XRAPI_CALL xrPollEvent(XrInstance instance, XrEventDataBuffer* eventData) {
+		stats::ApiCallTimer apiCallTimer(3);
+
 		TraceLocalActivity(local);
 		TraceLoggingWriteStart(local, "xrPollEvent");
 
@@ -123,6 +211,8 @@ namespace RUNTIME_NAMESPACE {
 	}
 
 	XrResult XRAPI_CALL xrResultToString(XrInstance instance, XrResult value, char buffer[XR_MAX_RESULT_STRING_SIZE]) {
+		stats::ApiCallTimer apiCallTimer(4);
+
 		TraceLocalActivity(local);
 		TraceLoggingWriteStart(local, "xrResultToString");
 
@@ -144,6 +234,8 @@ namespace RUNTIME_NAMESPACE {
 	}
 
 	XrResult XRAPI_CALL xrStructureTypeToString(XrInstance instance, XrStructureType value, char buffer[XR_MAX_STRUCTURE_NAME_SIZE]) {
+		stats::ApiCallTimer apiCallTimer(5);
+
 		TraceLocalActivity(local);
 		TraceLoggingWriteStart(local, "xrStructureTypeToString");
 
@@ -165,6 +257,8 @@ namespace RUNTIME_NAMESPACE {
 	}
 
 	XrResult XRAPI_CALL xrGetSystem(XrInstance instance, const XrSystemGetInfo* getInfo, XrSystemId* systemId) {
+		stats::ApiCallTimer apiCallTimer(6);
+
 		TraceLocalActivity(local);
 		TraceLoggingWriteStart(local, "xrGetSystem");
 
@@ -186,6 +280,8 @@ namespace RUNTIME_NAMESPACE {
 	}
 
 	XrResult XRAPI_CALL xrGetSystemProperties(XrInstance instance, XrSystemId systemId, XrSystemProperties* properties) {
+		stats::ApiCallTimer apiCallTimer(7);
+
 		TraceLocalActivity(local);
 		TraceLoggingWriteStart(local, "xrGetSystemProperties");
 
@@ -207,6 +303,8 @@ namespace RUNTIME_NAMESPACE {
 	}
 
 	XrResult XRAPI_CALL xrEnumerateEnvironmentBlendModes(XrInstance instance, XrSystemId systemId, XrViewConfigurationType viewConfigurationType, uint32_t environmentBlendModeCapacityInput, uint32_t* environmentBlendModeCountOutput, XrEnvironmentBlendMode* environmentBlendModes) {
+		stats::ApiCallTimer apiCallTimer(8);
+
 		TraceLocalActivity(local);
 		TraceLoggingWriteStart(local, "xrEnumerateEnvironmentBlendModes");
 
@@ -228,6 +326,8 @@ namespace RUNTIME_NAMESPACE {
 	}
 
 	XrResult XRAPI_CALL xrCreateSession(XrInstance instance, const XrSessionCreateInfo* createInfo, XrSession* session) {
+		stats::ApiCallTimer apiCallTimer(9);
+
 		TraceLocalActivity(local);
 		TraceLoggingWriteStart(local, "xrCreateSession");
 
@@ -249,6 +349,8 @@ namespace RUNTIME_NAMESPACE {
 	}
 
 	XrResult XRAPI_CALL xrDestroySession(XrSession session) {
+		stats::ApiCallTimer apiCallTimer(10);
+
 		TraceLocalActivity(local);
 		TraceLoggingWriteStart(local, "xrDestroySession");
 
@@ -270,6 +372,8 @@ namespace RUNTIME_NAMESPACE {
 	}
 
 	XrResult XRAPI_CALL xrEnumerateReferenceSpaces(XrSession session, uint32_t spaceCapacityInput, uint32_t* spaceCountOutput, XrReferenceSpaceType* spaces) {
+		stats::ApiCallTimer apiCallTimer(11);
+
 		TraceLocalActivity(local);
 		TraceLoggingWriteStart(local, "xrEnumerateReferenceSpaces");
 
@@ -291,6 +395,8 @@ namespace RUNTIME_NAMESPACE {
 	}
 
 	XrResult XRAPI_CALL xrCreateReferenceSpace(XrSession session, const XrReferenceSpaceCreateInfo* createInfo, XrSpace* space) {
+		stats::ApiCallTimer apiCallTimer(12);
+
 		TraceLocalActivity(local);
 		TraceLoggingWriteStart(local, "xrCreateReferenceSpace");
 
@@ -312,6 +418,8 @@ namespace RUNTIME_NAMESPACE {
 	}
 
 	XrResult XRAPI_CALL xrGetReferenceSpaceBoundsRect(XrSession session, XrReferenceSpaceType referenceSpaceType, XrExtent2Df* bounds) {
+		stats::ApiCallTimer apiCallTimer(13);
+
 		TraceLocalActivity(local);
 		TraceLoggingWriteStart(local, "xrGetReferenceSpaceBoundsRect");
 
@@ -333,6 +441,8 @@ namespace RUNTIME_NAMESPACE {
 	}
 
 	XrResult XRAPI_CALL xrCreateActionSpace(XrSession session, const XrActionSpaceCreateInfo* createInfo, XrSpace* space) {
+		stats::ApiCallTimer apiCallTimer(14);
+
 		TraceLocalActivity(local);
 		TraceLoggingWriteStart(local, "xrCreateActionSpace");
 
@@ -354,6 +464,22 @@ namespace RUNTIME_NAMESPACE {
 	}
 
 	XrResult XRAPI_CALL xrLocateSpace(XrSpace space, XrSpace baseSpace, XrTime time, XrSpaceLocation* location) {
+		stats::ApiCallTimer apiCallTimer(15);
+
+		// Hot function: avoid the cost of the trace activity when nobody is listening.
+		if (!IsTraceEnabled()) {
+			try {
+				const XrResult result = RUNTIME_NAMESPACE::GetInstance()->xrLocateSpace(space, baseSpace, time, location);
+				if (XR_FAILED(result)) {
+					ErrorLog("xrLocateSpace failed with %s\n", xr::ToCString(result));
+				}
+				return result;
+			} catch (std::exception& exc) {
+				ErrorLog("xrLocateSpace: %s\n", exc.what());
+				return XR_ERROR_RUNTIME_FAILURE;
+			}
+		}
+
 		TraceLocalActivity(local);
 		TraceLoggingWriteStart(local, "xrLocateSpace");
 
@@ -375,6 +501,8 @@ namespace RUNTIME_NAMESPACE {
 	}
 
 	XrResult XRAPI_CALL xrDestroySpace(XrSpace space) {
+		stats::ApiCallTimer apiCallTimer(16);
+
 		TraceLocalActivity(local);
 		TraceLoggingWriteStart(local, "xrDestroySpace");
 
@@ -396,6 +524,8 @@ namespace RUNTIME_NAMESPACE {
 	}
 
 	XrResult XRAPI_CALL xrEnumerateViewConfigurations(XrInstance instance, XrSystemId systemId, uint32_t viewConfigurationTypeCapacityInput, uint32_t* viewConfigurationTypeCountOutput, XrViewConfigurationType* viewConfigurationTypes) {
+		stats::ApiCallTimer apiCallTimer(17);
+
 		TraceLocalActivity(local);
 		TraceLoggingWriteStart(local, "xrEnumerateViewConfigurations");
 
@@ -417,6 +547,8 @@ namespace RUNTIME_NAMESPACE {
 	}
 
 	XrResult XRAPI_CALL xrGetViewConfigurationProperties(XrInstance instance, XrSystemId systemId, XrViewConfigurationType viewConfigurationType, XrViewConfigurationProperties* configurationProperties) {
+		stats::ApiCallTimer apiCallTimer(18);
+
 		TraceLocalActivity(local);
 		TraceLoggingWriteStart(local, "xrGetViewConfigurationProperties");
 
@@ -438,6 +570,8 @@ namespace RUNTIME_NAMESPACE {
 	}
 
 	XrResult XRAPI_CALL xrEnumerateViewConfigurationViews(XrInstance instance, XrSystemId systemId, XrViewConfigurationType viewConfigurationType, uint32_t viewCapacityInput, uint32_t* viewCountOutput, XrViewConfigurationView* views) {
+		stats::ApiCallTimer apiCallTimer(19);
+
 		TraceLocalActivity(local);
 		TraceLoggingWriteStart(local, "xrEnumerateViewConfigurationViews");
 
@@ -459,6 +593,8 @@ namespace RUNTIME_NAMESPACE {
 	}
 
 	XrResult XRAPI_CALL xrEnumerateSwapchainFormats(XrSession session, uint32_t formatCapacityInput, uint32_t* formatCountOutput, int64_t* formats) {
+		stats::ApiCallTimer apiCallTimer(20);
+
 		TraceLocalActivity(local);
 		TraceLoggingWriteStart(local, "xrEnumerateSwapchainFormats");
 
@@ -480,6 +616,8 @@ namespace RUNTIME_NAMESPACE {
 	}
 
 	XrResult XRAPI_CALL xrCreateSwapchain(XrSession session, const XrSwapchainCreateInfo* createInfo, XrSwapchain* swapchain) {
+		stats::ApiCallTimer apiCallTimer(21);
+
 		TraceLocalActivity(local);
 		TraceLoggingWriteStart(local, "xrCreateSwapchain");
 
@@ -501,6 +639,8 @@ namespace RUNTIME_NAMESPACE {
 	}
 
 	XrResult XRAPI_CALL xrDestroySwapchain(XrSwapchain swapchain) {
+		stats::ApiCallTimer apiCallTimer(22);
+
 		TraceLocalActivity(local);
 		TraceLoggingWriteStart(local, "xrDestroySwapchain");
 
@@ -522,6 +662,8 @@ namespace RUNTIME_NAMESPACE {
 	}
 
 	XrResult XRAPI_CALL xrEnumerateSwapchainImages(XrSwapchain swapchain, uint32_t imageCapacityInput, uint32_t* imageCountOutput, XrSwapchainImageBaseHeader* images) {
+		stats::ApiCallTimer apiCallTimer(23);
+
 		TraceLocalActivity(local);
 		TraceLoggingWriteStart(local, "xrEnumerateSwapchainImages");
 
@@ -543,6 +685,8 @@ namespace RUNTIME_NAMESPACE {
 	}
 
 	XrResult XRAPI_CALL xrAcquireSwapchainImage(XrSwapchain swapchain, const XrSwapchainImageAcquireInfo* acquireInfo, uint32_t* index) {
+		stats::ApiCallTimer apiCallTimer(24);
+
 		TraceLocalActivity(local);
 		TraceLoggingWriteStart(local, "xrAcquireSwapchainImage");
 
@@ -564,6 +708,8 @@ namespace RUNTIME_NAMESPACE {
 	}
 
 	XrResult XRAPI_CALL xrWaitSwapchainImage(XrSwapchain swapchain, const XrSwapchainImageWaitInfo* waitInfo) {
+		stats::ApiCallTimer apiCallTimer(25);
+
 		TraceLocalActivity(local);
 		TraceLoggingWriteStart(local, "xrWaitSwapchainImage");
 
@@ -585,6 +731,8 @@ namespace RUNTIME_NAMESPACE {
 	}
 
 	XrResult XRAPI_CALL xrReleaseSwapchainImage(XrSwapchain swapchain, const XrSwapchainImageReleaseInfo* releaseInfo) {
+		stats::ApiCallTimer apiCallTimer(26);
+
 		TraceLocalActivity(local);
 		TraceLoggingWriteStart(local, "xrReleaseSwapchainImage");
 
@@ -606,6 +754,8 @@ namespace RUNTIME_NAMESPACE {
 	}
 
 	XrResult XRAPI_CALL xrBeginSession(XrSession session, const XrSessionBeginInfo* beginInfo) {
+		stats::ApiCallTimer apiCallTimer(27);
+
 		TraceLocalActivity(local);
 		TraceLoggingWriteStart(local, "xrBeginSession");
 
@@ -627,6 +777,8 @@ namespace RUNTIME_NAMESPACE {
 	}
 
 	XrResult XRAPI_CALL xrEndSession(XrSession session) {
+		stats::ApiCallTimer apiCallTimer(28);
+
 		TraceLocalActivity(local);
 		TraceLoggingWriteStart(local, "xrEndSession");
 
@@ -648,6 +800,8 @@ namespace RUNTIME_NAMESPACE {
 	}
 
 	XrResult XRAPI_CALL xrRequestExitSession(XrSession session) {
+		stats::ApiCallTimer apiCallTimer(29);
+
 		TraceLocalActivity(local);
 		TraceLoggingWriteStart(local, "xrRequestExitSession");
 
@@ -669,6 +823,8 @@ namespace RUNTIME_NAMESPACE {
 	}
 
 	XrResult XRAPI_CALL xrWaitFrame(XrSession session, const XrFrameWaitInfo* frameWaitInfo, XrFrameState* frameState) {
+		stats::ApiCallTimer apiCallTimer(30);
+
 		TraceLocalActivity(local);
 		TraceLoggingWriteStart(local, "xrWaitFrame");
 
@@ -690,6 +846,8 @@ namespace RUNTIME_NAMESPACE {
 	}
 
 	XrResult XRAPI_CALL xrBeginFrame(XrSession session, const XrFrameBeginInfo* frameBeginInfo) {
+		stats::ApiCallTimer apiCallTimer(31);
+
 		TraceLocalActivity(local);
 		TraceLoggingWriteStart(local, "xrBeginFrame");
 
@@ -711,6 +869,8 @@ namespace RUNTIME_NAMESPACE {
 	}
 
 	XrResult XRAPI_CALL xrEndFrame(XrSession session, const XrFrameEndInfo* frameEndInfo) {
+		stats::ApiCallTimer apiCallTimer(32);
+
 		TraceLocalActivity(local);
 		TraceLoggingWriteStart(local, "xrEndFrame");
 
@@ -732,6 +892,22 @@ namespace RUNTIME_NAMESPACE {
 	}
 
 	XrResult XRAPI_CALL xrLocateViews(XrSession session, const XrViewLocateInfo* viewLocateInfo, XrViewState* viewState, uint32_t viewCapacityInput, uint32_t* viewCountOutput, XrView* views) {
+		stats::ApiCallTimer apiCallTimer(33);
+
+		// Hot function: avoid the cost of the trace activity when nobody is listening.
+		if (!IsTraceEnabled()) {
+			try {
+				const XrResult result = RUNTIME_NAMESPACE::GetInstance()->xrLocateViews(session, viewLocateInfo, viewState, viewCapacityInput, viewCountOutput, views);
+				if (XR_FAILED(result)) {
+					ErrorLog("xrLocateViews failed with %s\n", xr::ToCString(result));
+				}
+				return result;
+			} catch (std::exception& exc) {
+				ErrorLog("xrLocateViews: %s\n", exc.what());
+				return XR_ERROR_RUNTIME_FAILURE;
+			}
+		}
+
 		TraceLocalActivity(local);
 		TraceLoggingWriteStart(local, "xrLocateViews");
 
@@ -753,6 +929,8 @@ namespace RUNTIME_NAMESPACE {
 	}
 
 	XrResult XRAPI_CALL xrStringToPath(XrInstance instance, const char* pathString, XrPath* path) {
+		stats::ApiCallTimer apiCallTimer(34);
+
 		TraceLocalActivity(local);
 		TraceLoggingWriteStart(local, "xrStringToPath");
 
@@ -774,6 +952,8 @@ namespace RUNTIME_NAMESPACE {
 	}
 
 	XrResult XRAPI_CALL xrPathToString(XrInstance instance, XrPath path, uint32_t bufferCapacityInput, uint32_t* bufferCountOutput, char* buffer) {
+		stats::ApiCallTimer apiCallTimer(35);
+
 		TraceLocalActivity(local);
 		TraceLoggingWriteStart(local, "xrPathToString");
 
@@ -795,6 +975,8 @@ namespace RUNTIME_NAMESPACE {
 	}
 
 	XrResult XRAPI_CALL xrCreateActionSet(XrInstance instance, const XrActionSetCreateInfo* createInfo, XrActionSet* actionSet) {
+		stats::ApiCallTimer apiCallTimer(36);
+
 		TraceLocalActivity(local);
 		TraceLoggingWriteStart(local, "xrCreateActionSet");
 
@@ -816,6 +998,8 @@ namespace RUNTIME_NAMESPACE {
 	}
 
 	XrResult XRAPI_CALL xrDestroyActionSet(XrActionSet actionSet) {
+		stats::ApiCallTimer apiCallTimer(37);
+
 		TraceLocalActivity(local);
 		TraceLoggingWriteStart(local, "xrDestroyActionSet");
 
@@ -837,6 +1021,8 @@ namespace RUNTIME_NAMESPACE {
 	}
 
 	XrResult XRAPI_CALL xrCreateAction(XrActionSet actionSet, const XrActionCreateInfo* createInfo, XrAction* action) {
+		stats::ApiCallTimer apiCallTimer(38);
+
 		TraceLocalActivity(local);
 		TraceLoggingWriteStart(local, "xrCreateAction");
 
@@ -858,6 +1044,8 @@ namespace RUNTIME_NAMESPACE {
 	}
 
 	XrResult XRAPI_CALL xrDestroyAction(XrAction action) {
+		stats::ApiCallTimer apiCallTimer(39);
+
 		TraceLocalActivity(local);
 		TraceLoggingWriteStart(local, "xrDestroyAction");
 
@@ -879,6 +1067,8 @@ namespace RUNTIME_NAMESPACE {
 	}
 
 	XrResult XRAPI_CALL xrSuggestInteractionProfileBindings(XrInstance instance, const XrInteractionProfileSuggestedBinding* suggestedBindings) {
+		stats::ApiCallTimer apiCallTimer(40);
+
 		TraceLocalActivity(local);
 		TraceLoggingWriteStart(local, "xrSuggestInteractionProfileBindings");
 
@@ -900,6 +1090,8 @@ namespace RUNTIME_NAMESPACE {
 	}
 
 	XrResult XRAPI_CALL xrAttachSessionActionSets(XrSession session, const XrSessionActionSetsAttachInfo* attachInfo) {
+		stats::ApiCallTimer apiCallTimer(41);
+
 		TraceLocalActivity(local);
 		TraceLoggingWriteStart(local, "xrAttachSessionActionSets");
 
@@ -921,6 +1113,8 @@ namespace RUNTIME_NAMESPACE {
 	}
 
 	XrResult XRAPI_CALL xrGetCurrentInteractionProfile(XrSession session, XrPath topLevelUserPath, XrInteractionProfileState* interactionProfile) {
+		stats::ApiCallTimer apiCallTimer(42);
+
 		TraceLocalActivity(local);
 		TraceLoggingWriteStart(local, "xrGetCurrentInteractionProfile");
 
@@ -942,6 +1136,22 @@ namespace RUNTIME_NAMESPACE {
 	}
 
 	XrResult XRAPI_CALL xrGetActionStateBoolean(XrSession session, const XrActionStateGetInfo* getInfo, XrActionStateBoolean* state) {
+		stats::ApiCallTimer apiCallTimer(43);
+
+		// Hot function: avoid the cost of the trace activity when nobody is listening.
+		if (!IsTraceEnabled()) {
+			try {
+				const XrResult result = RUNTIME_NAMESPACE::GetInstance()->xrGetActionStateBoolean(session, getInfo, state);
+				if (XR_FAILED(result)) {
+					ErrorLog("xrGetActionStateBoolean failed with %s\n", xr::ToCString(result));
+				}
+				return result;
+			} catch (std::exception& exc) {
+				ErrorLog("xrGetActionStateBoolean: %s\n", exc.what());
+				return XR_ERROR_RUNTIME_FAILURE;
+			}
+		}
+
 		TraceLocalActivity(local);
 		TraceLoggingWriteStart(local, "xrGetActionStateBoolean");
 
@@ -963,6 +1173,22 @@ namespace RUNTIME_NAMESPACE {
 	}
 
 	XrResult XRAPI_CALL xrGetActionStateFloat(XrSession session, const XrActionStateGetInfo* getInfo, XrActionStateFloat* state) {
+		stats::ApiCallTimer apiCallTimer(44);
+
+		// Hot function: avoid the cost of the trace activity when nobody is listening.
+		if (!IsTraceEnabled()) {
+			try {
+				const XrResult result = RUNTIME_NAMESPACE::GetInstance()->xrGetActionStateFloat(session, getInfo, state);
+				if (XR_FAILED(result)) {
+					ErrorLog("xrGetActionStateFloat failed with %s\n", xr::ToCString(result));
+				}
+				return result;
+			} catch (std::exception& exc) {
+				ErrorLog("xrGetActionStateFloat: %s\n", exc.what());
+				return XR_ERROR_RUNTIME_FAILURE;
+			}
+		}
+
 		TraceLocalActivity(local);
 		TraceLoggingWriteStart(local, "xrGetActionStateFloat");
 
@@ -984,6 +1210,22 @@ namespace RUNTIME_NAMESPACE {
 	}
 
 	XrResult XRAPI_CALL xrGetActionStateVector2f(XrSession session, const XrActionStateGetInfo* getInfo, XrActionStateVector2f* state) {
+		stats::ApiCallTimer apiCallTimer(45);
+
+		// Hot function: avoid the cost of the trace activity when nobody is listening.
+		if (!IsTraceEnabled()) {
+			try {
+				const XrResult result = RUNTIME_NAMESPACE::GetInstance()->xrGetActionStateVector2f(session, getInfo, state);
+				if (XR_FAILED(result)) {
+					ErrorLog("xrGetActionStateVector2f failed with %s\n", xr::ToCString(result));
+				}
+				return result;
+			} catch (std::exception& exc) {
+				ErrorLog("xrGetActionStateVector2f: %s\n", exc.what());
+				return XR_ERROR_RUNTIME_FAILURE;
+			}
+		}
+
 		TraceLocalActivity(local);
 		TraceLoggingWriteStart(local, "xrGetActionStateVector2f");
 
@@ -1005,6 +1247,22 @@ namespace RUNTIME_NAMESPACE {
 	}
 
 	XrResult XRAPI_CALL xrGetActionStatePose(XrSession session, const XrActionStateGetInfo* getInfo, XrActionStatePose* state) {
+		stats::ApiCallTimer apiCallTimer(46);
+
+		// Hot function: avoid the cost of the trace activity when nobody is listening.
+		if (!IsTraceEnabled()) {
+			try {
+				const XrResult result = RUNTIME_NAMESPACE::GetInstance()->xrGetActionStatePose(session, getInfo, state);
+				if (XR_FAILED(result)) {
+					ErrorLog("xrGetActionStatePose failed with %s\n", xr::ToCString(result));
+				}
+				return result;
+			} catch (std::exception& exc) {
+				ErrorLog("xrGetActionStatePose: %s\n", exc.what());
+				return XR_ERROR_RUNTIME_FAILURE;
+			}
+		}
+
 		TraceLocalActivity(local);
 		TraceLoggingWriteStart(local, "xrGetActionStatePose");
 
@@ -1026,6 +1284,8 @@ namespace RUNTIME_NAMESPACE {
 	}
 
 	XrResult XRAPI_CALL xrSyncActions(XrSession session, const XrActionsSyncInfo* syncInfo) {
+		stats::ApiCallTimer apiCallTimer(47);
+
 		TraceLocalActivity(local);
 		TraceLoggingWriteStart(local, "xrSyncActions");
 
@@ -1047,6 +1307,8 @@ namespace RUNTIME_NAMESPACE {
 	}
 
 	XrResult XRAPI_CALL xrEnumerateBoundSourcesForAction(XrSession session, const XrBoundSourcesForActionEnumerateInfo* enumerateInfo, uint32_t sourceCapacityInput, uint32_t* sourceCountOutput, XrPath* sources) {
+		stats::ApiCallTimer apiCallTimer(48);
+
 		TraceLocalActivity(local);
 		TraceLoggingWriteStart(local, "xrEnumerateBoundSourcesForAction");
 
@@ -1068,6 +1330,8 @@ namespace RUNTIME_NAMESPACE {
 	}
 
 	XrResult XRAPI_CALL xrGetInputSourceLocalizedName(XrSession session, const XrInputSourceLocalizedNameGetInfo* getInfo, uint32_t bufferCapacityInput, uint32_t* bufferCountOutput, char* buffer) {
+		stats::ApiCallTimer apiCallTimer(49);
+
 		TraceLocalActivity(local);
 		TraceLoggingWriteStart(local, "xrGetInputSourceLocalizedName");
 
@@ -1089,6 +1353,8 @@ namespace RUNTIME_NAMESPACE {
 	}
 
 	XrResult XRAPI_CALL xrApplyHapticFeedback(XrSession session, const XrHapticActionInfo* hapticActionInfo, const XrHapticBaseHeader* hapticFeedback) {
+		stats::ApiCallTimer apiCallTimer(50);
+
 		TraceLocalActivity(local);
 		TraceLoggingWriteStart(local, "xrApplyHapticFeedback");
 
@@ -1110,6 +1376,8 @@ namespace RUNTIME_NAMESPACE {
 	}
 
 	XrResult XRAPI_CALL xrStopHapticFeedback(XrSession session, const XrHapticActionInfo* hapticActionInfo) {
+		stats::ApiCallTimer apiCallTimer(51);
+
 		TraceLocalActivity(local);
 		TraceLoggingWriteStart(local, "xrStopHapticFeedback");
 
@@ -1131,6 +1399,8 @@ namespace RUNTIME_NAMESPACE {
 	}
 
 	XrResult XRAPI_CALL xrGetOpenGLGraphicsRequirementsKHR(XrInstance instance, XrSystemId systemId, XrGraphicsRequirementsOpenGLKHR* graphicsRequirements) {
+		stats::ApiCallTimer apiCallTimer(52);
+
 		TraceLocalActivity(local);
 		TraceLoggingWriteStart(local, "xrGetOpenGLGraphicsRequirementsKHR");
 
@@ -1152,6 +1422,8 @@ namespace RUNTIME_NAMESPACE {
 	}
 
 	XrResult XRAPI_CALL xrGetVulkanInstanceExtensionsKHR(XrInstance instance, XrSystemId systemId, uint32_t bufferCapacityInput, uint32_t* bufferCountOutput, char* buffer) {
+		stats::ApiCallTimer apiCallTimer(53);
+
 		TraceLocalActivity(local);
 		TraceLoggingWriteStart(local, "xrGetVulkanInstanceExtensionsKHR");
 
@@ -1173,6 +1445,8 @@ namespace RUNTIME_NAMESPACE {
 	}
 
 	XrResult XRAPI_CALL xrGetVulkanDeviceExtensionsKHR(XrInstance instance, XrSystemId systemId, uint32_t bufferCapacityInput, uint32_t* bufferCountOutput, char* buffer) {
+		stats::ApiCallTimer apiCallTimer(54);
+
 		TraceLocalActivity(local);
 		TraceLoggingWriteStart(local, "xrGetVulkanDeviceExtensionsKHR");
 
@@ -1194,6 +1468,8 @@ namespace RUNTIME_NAMESPACE {
 	}
 
 	XrResult XRAPI_CALL xrGetVulkanGraphicsDeviceKHR(XrInstance instance, XrSystemId systemId, VkInstance vkInstance, VkPhysicalDevice* vkPhysicalDevice) {
+		stats::ApiCallTimer apiCallTimer(55);
+
 		TraceLocalActivity(local);
 		TraceLoggingWriteStart(local, "xrGetVulkanGraphicsDeviceKHR");
 
@@ -1215,6 +1491,8 @@ namespace RUNTIME_NAMESPACE {
 	}
 
 	XrResult XRAPI_CALL xrGetVulkanGraphicsRequirementsKHR(XrInstance instance, XrSystemId systemId, XrGraphicsRequirementsVulkanKHR* graphicsRequirements) {
+		stats::ApiCallTimer apiCallTimer(56);
+
 		TraceLocalActivity(local);
 		TraceLoggingWriteStart(local, "xrGetVulkanGraphicsRequirementsKHR");
 
@@ -1236,6 +1514,8 @@ namespace RUNTIME_NAMESPACE {
 	}
 
 	XrResult XRAPI_CALL xrGetD3D11GraphicsRequirementsKHR(XrInstance instance, XrSystemId systemId, XrGraphicsRequirementsD3D11KHR* graphicsRequirements) {
+		stats::ApiCallTimer apiCallTimer(57);
+
 		TraceLocalActivity(local);
 		TraceLoggingWriteStart(local, "xrGetD3D11GraphicsRequirementsKHR");
 
@@ -1257,6 +1537,8 @@ namespace RUNTIME_NAMESPACE {
 	}
 
 	XrResult XRAPI_CALL xrGetD3D12GraphicsRequirementsKHR(XrInstance instance, XrSystemId systemId, XrGraphicsRequirementsD3D12KHR* graphicsRequirements) {
+		stats::ApiCallTimer apiCallTimer(58);
+
 		TraceLocalActivity(local);
 		TraceLoggingWriteStart(local, "xrGetD3D12GraphicsRequirementsKHR");
 
@@ -1278,6 +1560,8 @@ namespace RUNTIME_NAMESPACE {
 	}
 
 	XrResult XRAPI_CALL xrGetVisibilityMaskKHR(XrSession session, XrViewConfigurationType viewConfigurationType, uint32_t viewIndex, XrVisibilityMaskTypeKHR visibilityMaskType, XrVisibilityMaskKHR* visibilityMask) {
+		stats::ApiCallTimer apiCallTimer(59);
+
 		TraceLocalActivity(local);
 		TraceLoggingWriteStart(local, "xrGetVisibilityMaskKHR");
 
@@ -1299,6 +1583,8 @@ namespace RUNTIME_NAMESPACE {
 	}
 
 	XrResult XRAPI_CALL xrConvertWin32PerformanceCounterToTimeKHR(XrInstance instance, const LARGE_INTEGER* performanceCounter, XrTime* time) {
+		stats::ApiCallTimer apiCallTimer(60);
+
 		TraceLocalActivity(local);
 		TraceLoggingWriteStart(local, "xrConvertWin32PerformanceCounterToTimeKHR");
 
@@ -1320,6 +1606,8 @@ namespace RUNTIME_NAMESPACE {
 	}
 
 	XrResult XRAPI_CALL xrConvertTimeToWin32PerformanceCounterKHR(XrInstance instance, XrTime time, LARGE_INTEGER* performanceCounter) {
+		stats::ApiCallTimer apiCallTimer(61);
+
 		TraceLocalActivity(local);
 		TraceLoggingWriteStart(local, "xrConvertTimeToWin32PerformanceCounterKHR");
 
@@ -1341,6 +1629,8 @@ namespace RUNTIME_NAMESPACE {
 	}
 
 	XrResult XRAPI_CALL xrCreateVulkanInstanceKHR(XrInstance instance, const XrVulkanInstanceCreateInfoKHR* createInfo, VkInstance* vulkanInstance, VkResult* vulkanResult) {
+		stats::ApiCallTimer apiCallTimer(62);
+
 		TraceLocalActivity(local);
 		TraceLoggingWriteStart(local, "xrCreateVulkanInstanceKHR");
 
@@ -1362,6 +1652,8 @@ namespace RUNTIME_NAMESPACE {
 	}
 
 	XrResult XRAPI_CALL xrCreateVulkanDeviceKHR(XrInstance instance, const XrVulkanDeviceCreateInfoKHR* createInfo, VkDevice* vulkanDevice, VkResult* vulkanResult) {
+		stats::ApiCallTimer apiCallTimer(63);
+
 		TraceLocalActivity(local);
 		TraceLoggingWriteStart(local, "xrCreateVulkanDeviceKHR");
 
@@ -1383,6 +1675,8 @@ namespace RUNTIME_NAMESPACE {
 	}
 
 	XrResult XRAPI_CALL xrGetVulkanGraphicsDevice2KHR(XrInstance instance, const XrVulkanGraphicsDeviceGetInfoKHR* getInfo, VkPhysicalDevice* vulkanPhysicalDevice) {
+		stats::ApiCallTimer apiCallTimer(64);
+
 		TraceLocalActivity(local);
 		TraceLoggingWriteStart(local, "xrGetVulkanGraphicsDevice2KHR");
 
@@ -1404,6 +1698,8 @@ namespace RUNTIME_NAMESPACE {
 	}
 
 	XrResult XRAPI_CALL xrGetVulkanGraphicsRequirements2KHR(XrInstance instance, XrSystemId systemId, XrGraphicsRequirementsVulkanKHR* graphicsRequirements) {
+		stats::ApiCallTimer apiCallTimer(65);
+
 		TraceLocalActivity(local);
 		TraceLoggingWriteStart(local, "xrGetVulkanGraphicsRequirements2KHR");
 
@@ -1425,6 +1721,8 @@ namespace RUNTIME_NAMESPACE {
 	}
 
 	XrResult XRAPI_CALL xrCreateHandTrackerEXT(XrSession session, const XrHandTrackerCreateInfoEXT* createInfo, XrHandTrackerEXT* handTracker) {
+		stats::ApiCallTimer apiCallTimer(66);
+
 		TraceLocalActivity(local);
 		TraceLoggingWriteStart(local, "xrCreateHandTrackerEXT");
 
@@ -1446,6 +1744,8 @@ namespace RUNTIME_NAMESPACE {
 	}
 
 	XrResult XRAPI_CALL xrDestroyHandTrackerEXT(XrHandTrackerEXT handTracker) {
+		stats::ApiCallTimer apiCallTimer(67);
+
 		TraceLocalActivity(local);
 		TraceLoggingWriteStart(local, "xrDestroyHandTrackerEXT");
 
@@ -1467,6 +1767,22 @@ namespace RUNTIME_NAMESPACE {
 	}
 
 	XrResult XRAPI_CALL xrLocateHandJointsEXT(XrHandTrackerEXT handTracker, const XrHandJointsLocateInfoEXT* locateInfo, XrHandJointLocationsEXT* locations) {
+		stats::ApiCallTimer apiCallTimer(68);
+
+		// Hot function: avoid the cost of the trace activity when nobody is listening.
+		if (!IsTraceEnabled()) {
+			try {
+				const XrResult result = RUNTIME_NAMESPACE::GetInstance()->xrLocateHandJointsEXT(handTracker, locateInfo, locations);
+				if (XR_FAILED(result)) {
+					ErrorLog("xrLocateHandJointsEXT failed with %s\n", xr::ToCString(result));
+				}
+				return result;
+			} catch (std::exception& exc) {
+				ErrorLog("xrLocateHandJointsEXT: %s\n", exc.what());
+				return XR_ERROR_RUNTIME_FAILURE;
+			}
+		}
+
 		TraceLocalActivity(local);
 		TraceLoggingWriteStart(local, "xrLocateHandJointsEXT");
 
@@ -1488,6 +1804,8 @@ namespace RUNTIME_NAMESPACE {
 	}
 
 	XrResult XRAPI_CALL xrEnumerateDisplayRefreshRatesFB(XrSession session, uint32_t displayRefreshRateCapacityInput, uint32_t* displayRefreshRateCountOutput, float* displayRefreshRates) {
+		stats::ApiCallTimer apiCallTimer(69);
+
 		TraceLocalActivity(local);
 		TraceLoggingWriteStart(local, "xrEnumerateDisplayRefreshRatesFB");
 
@@ -1509,6 +1827,8 @@ namespace RUNTIME_NAMESPACE {
 	}
 
 	XrResult XRAPI_CALL xrGetDisplayRefreshRateFB(XrSession session, float* displayRefreshRate) {
+		stats::ApiCallTimer apiCallTimer(70);
+
 		TraceLocalActivity(local);
 		TraceLoggingWriteStart(local, "xrGetDisplayRefreshRateFB");
 
@@ -1530,6 +1850,8 @@ namespace RUNTIME_NAMESPACE {
 	}
 
 	XrResult XRAPI_CALL xrRequestDisplayRefreshRateFB(XrSession session, float displayRefreshRate) {
+		stats::ApiCallTimer apiCallTimer(71);
+
 		TraceLocalActivity(local);
 		TraceLoggingWriteStart(local, "xrRequestDisplayRefreshRateFB");
 
@@ -1550,237 +1872,291 @@ namespace RUNTIME_NAMESPACE {
 		return result;
 	}
 
+	XrResult XRAPI_CALL xrLocateSpacesKHR(XrSession session, const XrSpacesLocateInfoKHR* locateInfo, XrSpaceLocationsKHR* spaceLocations) {
+		stats::ApiCallTimer apiCallTimer(72);
 
-	// Auto-generated dispatcher handler.
-	XrResult OpenXrApi::xrGetInstanceProcAddr(XrInstance instance, const char* name, PFN_xrVoidFunction* function) {
-		const std::string apiName(name);
-
-		if (apiName == "xrGetInstanceProcAddr") {
-			*function = reinterpret_cast<PFN_xrVoidFunction>(RUNTIME_NAMESPACE::xrGetInstanceProcAddr);
-		}
-		else if (apiName == "xrEnumerateInstanceExtensionProperties") {
-			*function = reinterpret_cast<PFN_xrVoidFunction>(RUNTIME_NAMESPACE::xrEnumerateInstanceExtensionProperties);
-		}
-		else if (apiName == "xrCreateInstance") {
-			*function = reinterpret_cast<PFN_xrVoidFunction>(RUNTIME_NAMESPACE::xrCreateInstance);
-		}
-		else if (apiName == "xrDestroyInstance") {
-			*function = reinterpret_cast<PFN_xrVoidFunction>(RUNTIME_NAMESPACE::xrDestroyInstance);
-		}
-		else if (apiName == "xrGetInstanceProperties") {
-			*function = reinterpret_cast<PFN_xrVoidFunction>(RUNTIME_NAMESPACE::xrGetInstanceProperties);
-		}
-		else if (apiName == "xrPollEvent") {
-			*function = reinterpret_cast<PFN_xrVoidFunction>(RUNTIME_NAMESPACE::xrPollEvent);
-		}
-		else if (apiName == "xrResultToString") {
-			*function = reinterpret_cast<PFN_xrVoidFunction>(RUNTIME_NAMESPACE::xrResultToString);
-		}
-		else if (apiName == "xrStructureTypeToString") {
-			*function = reinterpret_cast<PFN_xrVoidFunction>(RUNTIME_NAMESPACE::xrStructureTypeToString);
+		// Hot function: avoid the cost of the trace activity when nobody is listening.
+		if (!IsTraceEnabled()) {
+			try {
+				const XrResult result = RUNTIME_NAMESPACE::GetInstance()->xrLocateSpacesKHR(session, locateInfo, spaceLocations);
+				if (XR_FAILED(result)) {
+					ErrorLog("xrLocateSpacesKHR failed with %s\n", xr::ToCString(result));
+				}
+				return result;
+			} catch (std::exception& exc) {
+				ErrorLog("xrLocateSpacesKHR: %s\n", exc.what());
+				return XR_ERROR_RUNTIME_FAILURE;
+			}
 		}
-		else if (apiName == "xrGetSystem") {
-			*function = reinterpret_cast<PFN_xrVoidFunction>(RUNTIME_NAMESPACE::xrGetSystem);
-		}
-		else if (apiName == "xrGetSystemProperties") {
-			*function = reinterpret_cast<PFN_xrVoidFunction>(RUNTIME_NAMESPACE::xrGetSystemProperties);
-		}
-		else if (apiName == "xrEnumerateEnvironmentBlendModes") {
-			*function = reinterpret_cast<PFN_xrVoidFunction>(RUNTIME_NAMESPACE::xrEnumerateEnvironmentBlendModes);
-		}
-		else if (apiName == "xrCreateSession") {
-			*function = reinterpret_cast<PFN_xrVoidFunction>(RUNTIME_NAMESPACE::xrCreateSession);
-		}
-		else if (apiName == "xrDestroySession") {
-			*function = reinterpret_cast<PFN_xrVoidFunction>(RUNTIME_NAMESPACE::xrDestroySession);
-		}
-		else if (apiName == "xrEnumerateReferenceSpaces") {
-			*function = reinterpret_cast<PFN_xrVoidFunction>(RUNTIME_NAMESPACE::xrEnumerateReferenceSpaces);
-		}
-		else if (apiName == "xrCreateReferenceSpace") {
-			*function = reinterpret_cast<PFN_xrVoidFunction>(RUNTIME_NAMESPACE::xrCreateReferenceSpace);
-		}
-		else if (apiName == "xrGetReferenceSpaceBoundsRect") {
-			*function = reinterpret_cast<PFN_xrVoidFunction>(RUNTIME_NAMESPACE::xrGetReferenceSpaceBoundsRect);
-		}
-		else if (apiName == "xrCreateActionSpace") {
-			*function = reinterpret_cast<PFN_xrVoidFunction>(RUNTIME_NAMESPACE::xrCreateActionSpace);
-		}
-		else if (apiName == "xrLocateSpace") {
-			*function = reinterpret_cast<PFN_xrVoidFunction>(RUNTIME_NAMESPACE::xrLocateSpace);
-		}
-		else if (apiName == "xrDestroySpace") {
-			*function = reinterpret_cast<PFN_xrVoidFunction>(RUNTIME_NAMESPACE::xrDestroySpace);
-		}
-		else if (apiName == "xrEnumerateViewConfigurations") {
-			*function = reinterpret_cast<PFN_xrVoidFunction>(RUNTIME_NAMESPACE::xrEnumerateViewConfigurations);
-		}
-		else if (apiName == "xrGetViewConfigurationProperties") {
-			*function = reinterpret_cast<PFN_xrVoidFunction>(RUNTIME_NAMESPACE::xrGetViewConfigurationProperties);
-		}
-		else if (apiName == "xrEnumerateViewConfigurationViews") {
-			*function = reinterpret_cast<PFN_xrVoidFunction>(RUNTIME_NAMESPACE::xrEnumerateViewConfigurationViews);
-		}
-		else if (apiName == "xrEnumerateSwapchainFormats") {
-			*function = reinterpret_cast<PFN_xrVoidFunction>(RUNTIME_NAMESPACE::xrEnumerateSwapchainFormats);
-		}
-		else if (apiName == "xrCreateSwapchain") {
-			*function = reinterpret_cast<PFN_xrVoidFunction>(RUNTIME_NAMESPACE::xrCreateSwapchain);
-		}
-		else if (apiName == "xrDestroySwapchain") {
-			*function = reinterpret_cast<PFN_xrVoidFunction>(RUNTIME_NAMESPACE::xrDestroySwapchain);
-		}
-		else if (apiName == "xrEnumerateSwapchainImages") {
-			*function = reinterpret_cast<PFN_xrVoidFunction>(RUNTIME_NAMESPACE::xrEnumerateSwapchainImages);
-		}
-		else if (apiName == "xrAcquireSwapchainImage") {
-			*function = reinterpret_cast<PFN_xrVoidFunction>(RUNTIME_NAMESPACE::xrAcquireSwapchainImage);
-		}
-		else if (apiName == "xrWaitSwapchainImage") {
-			*function = reinterpret_cast<PFN_xrVoidFunction>(RUNTIME_NAMESPACE::xrWaitSwapchainImage);
-		}
-		else if (apiName == "xrReleaseSwapchainImage") {
-			*function = reinterpret_cast<PFN_xrVoidFunction>(RUNTIME_NAMESPACE::xrReleaseSwapchainImage);
-		}
-		else if (apiName == "xrBeginSession") {
-			*function = reinterpret_cast<PFN_xrVoidFunction>(RUNTIME_NAMESPACE::xrBeginSession);
-		}
-		else if (apiName == "xrEndSession") {
-			*function = reinterpret_cast<PFN_xrVoidFunction>(RUNTIME_NAMESPACE::xrEndSession);
-		}
-		else if (apiName == "xrRequestExitSession") {
-			*function = reinterpret_cast<PFN_xrVoidFunction>(RUNTIME_NAMESPACE::xrRequestExitSession);
-		}
-		else if (apiName == "xrWaitFrame") {
-			*function = reinterpret_cast<PFN_xrVoidFunction>(RUNTIME_NAMESPACE::xrWaitFrame);
-		}
-		else if (apiName == "xrBeginFrame") {
-			*function = reinterpret_cast<PFN_xrVoidFunction>(RUNTIME_NAMESPACE::xrBeginFrame);
-		}
-		else if (apiName == "xrEndFrame") {
-			*function = reinterpret_cast<PFN_xrVoidFunction>(RUNTIME_NAMESPACE::xrEndFrame);
-		}
-		else if (apiName == "xrLocateViews") {
-			*function = reinterpret_cast<PFN_xrVoidFunction>(RUNTIME_NAMESPACE::xrLocateViews);
-		}
-		else if (apiName == "xrStringToPath") {
-			*function = reinterpret_cast<PFN_xrVoidFunction>(RUNTIME_NAMESPACE::xrStringToPath);
-		}
-		else if (apiName == "xrPathToString") {
-			*function = reinterpret_cast<PFN_xrVoidFunction>(RUNTIME_NAMESPACE::xrPathToString);
-		}
-		else if (apiName == "xrCreateActionSet") {
-			*function = reinterpret_cast<PFN_xrVoidFunction>(RUNTIME_NAMESPACE::xrCreateActionSet);
-		}
-		else if (apiName == "xrDestroyActionSet") {
-			*function = reinterpret_cast<PFN_xrVoidFunction>(RUNTIME_NAMESPACE::xrDestroyActionSet);
-		}
-		else if (apiName == "xrCreateAction") {
-			*function = reinterpret_cast<PFN_xrVoidFunction>(RUNTIME_NAMESPACE::xrCreateAction);
-		}
-		else if (apiName == "xrDestroyAction") {
-			*function = reinterpret_cast<PFN_xrVoidFunction>(RUNTIME_NAMESPACE::xrDestroyAction);
-		}
-		else if (apiName == "xrSuggestInteractionProfileBindings") {
-			*function = reinterpret_cast<PFN_xrVoidFunction>(RUNTIME_NAMESPACE::xrSuggestInteractionProfileBindings);
-		}
-		else if (apiName == "xrAttachSessionActionSets") {
-			*function = reinterpret_cast<PFN_xrVoidFunction>(RUNTIME_NAMESPACE::xrAttachSessionActionSets);
-		}
-		else if (apiName == "xrGetCurrentInteractionProfile") {
-			*function = reinterpret_cast<PFN_xrVoidFunction>(RUNTIME_NAMESPACE::xrGetCurrentInteractionProfile);
-		}
-		else if (apiName == "xrGetActionStateBoolean") {
-			*function = reinterpret_cast<PFN_xrVoidFunction>(RUNTIME_NAMESPACE::xrGetActionStateBoolean);
-		}
-		else if (apiName == "xrGetActionStateFloat") {
-			*function = reinterpret_cast<PFN_xrVoidFunction>(RUNTIME_NAMESPACE::xrGetActionStateFloat);
-		}
-		else if (apiName == "xrGetActionStateVector2f") {
-			*function = reinterpret_cast<PFN_xrVoidFunction>(RUNTIME_NAMESPACE::xrGetActionStateVector2f);
-		}
-		else if (apiName == "xrGetActionStatePose") {
-			*function = reinterpret_cast<PFN_xrVoidFunction>(RUNTIME_NAMESPACE::xrGetActionStatePose);
-		}
-		else if (apiName == "xrSyncActions") {
-			*function = reinterpret_cast<PFN_xrVoidFunction>(RUNTIME_NAMESPACE::xrSyncActions);
-		}
-		else if (apiName == "xrEnumerateBoundSourcesForAction") {
-			*function = reinterpret_cast<PFN_xrVoidFunction>(RUNTIME_NAMESPACE::xrEnumerateBoundSourcesForAction);
-		}
-		else if (apiName == "xrGetInputSourceLocalizedName") {
-			*function = reinterpret_cast<PFN_xrVoidFunction>(RUNTIME_NAMESPACE::xrGetInputSourceLocalizedName);
-		}
-		else if (apiName == "xrApplyHapticFeedback") {
-			*function = reinterpret_cast<PFN_xrVoidFunction>(RUNTIME_NAMESPACE::xrApplyHapticFeedback);
-		}
-		else if (apiName == "xrStopHapticFeedback") {
-			*function = reinterpret_cast<PFN_xrVoidFunction>(RUNTIME_NAMESPACE::xrStopHapticFeedback);
-		}
-		else if (has_XR_KHR_opengl_enable && apiName == "xrGetOpenGLGraphicsRequirementsKHR") {
-			*function = reinterpret_cast<PFN_xrVoidFunction>(RUNTIME_NAMESPACE::xrGetOpenGLGraphicsRequirementsKHR);
-		}
-		else if (has_XR_KHR_vulkan_enable && apiName == "xrGetVulkanInstanceExtensionsKHR") {
-			*function = reinterpret_cast<PFN_xrVoidFunction>(RUNTIME_NAMESPACE::xrGetVulkanInstanceExtensionsKHR);
-		}
-		else if (has_XR_KHR_vulkan_enable && apiName == "xrGetVulkanDeviceExtensionsKHR") {
-			*function = reinterpret_cast<PFN_xrVoidFunction>(RUNTIME_NAMESPACE::xrGetVulkanDeviceExtensionsKHR);
-		}
-		else if (has_XR_KHR_vulkan_enable && apiName == "xrGetVulkanGraphicsDeviceKHR") {
-			*function = reinterpret_cast<PFN_xrVoidFunction>(RUNTIME_NAMESPACE::xrGetVulkanGraphicsDeviceKHR);
-		}
-		else if (has_XR_KHR_vulkan_enable && apiName == "xrGetVulkanGraphicsRequirementsKHR") {
-			*function = reinterpret_cast<PFN_xrVoidFunction>(RUNTIME_NAMESPACE::xrGetVulkanGraphicsRequirementsKHR);
-		}
-		else if (has_XR_KHR_D3D11_enable && apiName == "xrGetD3D11GraphicsRequirementsKHR") {
-			*function = reinterpret_cast<PFN_xrVoidFunction>(RUNTIME_NAMESPACE::xrGetD3D11GraphicsRequirementsKHR);
-		}
-		else if (has_XR_KHR_D3D12_enable && apiName == "xrGetD3D12GraphicsRequirementsKHR") {
-			*function = reinterpret_cast<PFN_xrVoidFunction>(RUNTIME_NAMESPACE::xrGetD3D12GraphicsRequirementsKHR);
-		}
-		else if (has_XR_KHR_visibility_mask && apiName == "xrGetVisibilityMaskKHR") {
-			*function = reinterpret_cast<PFN_xrVoidFunction>(RUNTIME_NAMESPACE::xrGetVisibilityMaskKHR);
-		}
-		else if (has_XR_KHR_win32_convert_performance_counter_time && apiName == "xrConvertWin32PerformanceCounterToTimeKHR") {
-			*function = reinterpret_cast<PFN_xrVoidFunction>(RUNTIME_NAMESPACE::xrConvertWin32PerformanceCounterToTimeKHR);
-		}
-		else if (has_XR_KHR_win32_convert_performance_counter_time && apiName == "xrConvertTimeToWin32PerformanceCounterKHR") {
-			*function = reinterpret_cast<PFN_xrVoidFunction>(RUNTIME_NAMESPACE::xrConvertTimeToWin32PerformanceCounterKHR);
-		}
-		else if (has_XR_KHR_vulkan_enable2 && apiName == "xrCreateVulkanInstanceKHR") {
-			*function = reinterpret_cast<PFN_xrVoidFunction>(RUNTIME_NAMESPACE::xrCreateVulkanInstanceKHR);
-		}
-		else if (has_XR_KHR_vulkan_enable2 && apiName == "xrCreateVulkanDeviceKHR") {
-			*function = reinterpret_cast<PFN_xrVoidFunction>(RUNTIME_NAMESPACE::xrCreateVulkanDeviceKHR);
-		}
-		else if (has_XR_KHR_vulkan_enable2 && apiName == "xrGetVulkanGraphicsDevice2KHR") {
-			*function = reinterpret_cast<PFN_xrVoidFunction>(RUNTIME_NAMESPACE::xrGetVulkanGraphicsDevice2KHR);
-		}
-		else if (has_XR_KHR_vulkan_enable2 && apiName == "xrGetVulkanGraphicsRequirements2KHR") {
-			*function = reinterpret_cast<PFN_xrVoidFunction>(RUNTIME_NAMESPACE::xrGetVulkanGraphicsRequirements2KHR);
-		}
-		else if (has_XR_EXT_hand_tracking && apiName == "xrCreateHandTrackerEXT") {
-			*function = reinterpret_cast<PFN_xrVoidFunction>(RUNTIME_NAMESPACE::xrCreateHandTrackerEXT);
-		}
-		else if (has_XR_EXT_hand_tracking && apiName == "xrDestroyHandTrackerEXT") {
-			*function = reinterpret_cast<PFN_xrVoidFunction>(RUNTIME_NAMESPACE::xrDestroyHandTrackerEXT);
+
+		TraceLocalActivity(local);
+		TraceLoggingWriteStart(local, "xrLocateSpacesKHR");
+
+		XrResult result;
+		try {
+			result = RUNTIME_NAMESPACE::GetInstance()->xrLocateSpacesKHR(session, locateInfo, spaceLocations);
+		} catch (std::exception& exc) {
+			TraceLoggingWriteTagged(local, "xrLocateSpacesKHR_Error", TLArg(exc.what(), "Error"));
+			ErrorLog("xrLocateSpacesKHR: %s\n", exc.what());
+			result = XR_ERROR_RUNTIME_FAILURE;
 		}
-		else if (has_XR_EXT_hand_tracking && apiName == "xrLocateHandJointsEXT") {
-			*function = reinterpret_cast<PFN_xrVoidFunction>(RUNTIME_NAMESPACE::xrLocateHandJointsEXT);
+
+		TraceLoggingWriteStop(local, "xrLocateSpacesKHR", TLArg(xr::ToCString(result), "Result"));
+		if (XR_FAILED(result)) {
+			ErrorLog("xrLocateSpacesKHR failed with %s\n", xr::ToCString(result));
 		}
-		else if (has_XR_FB_display_refresh_rate && apiName == "xrEnumerateDisplayRefreshRatesFB") {
-			*function = reinterpret_cast<PFN_xrVoidFunction>(RUNTIME_NAMESPACE::xrEnumerateDisplayRefreshRatesFB);
+
+		return result;
+	}
+
+	XrResult XRAPI_CALL xrGetRecommendedLayerResolutionMETA(XrSession session, const XrRecommendedLayerResolutionGetInfoMETA* info, XrRecommendedLayerResolutionMETA* resolution) {
+		stats::ApiCallTimer apiCallTimer(73);
+
+		TraceLocalActivity(local);
+		TraceLoggingWriteStart(local, "xrGetRecommendedLayerResolutionMETA");
+
+		XrResult result;
+		try {
+			result = RUNTIME_NAMESPACE::GetInstance()->xrGetRecommendedLayerResolutionMETA(session, info, resolution);
+		} catch (std::exception& exc) {
+			TraceLoggingWriteTagged(local, "xrGetRecommendedLayerResolutionMETA_Error", TLArg(exc.what(), "Error"));
+			ErrorLog("xrGetRecommendedLayerResolutionMETA: %s\n", exc.what());
+			result = XR_ERROR_RUNTIME_FAILURE;
 		}
-		else if (has_XR_FB_display_refresh_rate && apiName == "xrGetDisplayRefreshRateFB") {
-			*function = reinterpret_cast<PFN_xrVoidFunction>(RUNTIME_NAMESPACE::xrGetDisplayRefreshRateFB);
+
+		TraceLoggingWriteStop(local, "xrGetRecommendedLayerResolutionMETA", TLArg(xr::ToCString(result), "Result"));
+		if (XR_FAILED(result)) {
+			ErrorLog("xrGetRecommendedLayerResolutionMETA failed with %s\n", xr::ToCString(result));
 		}
-		else if (has_XR_FB_display_refresh_rate && apiName == "xrRequestDisplayRefreshRateFB") {
-			*function = reinterpret_cast<PFN_xrVoidFunction>(RUNTIME_NAMESPACE::xrRequestDisplayRefreshRateFB);
+
+		return result;
+	}
+
+
+	// Auto-generated dispatcher handler.
+	namespace {
+		// FNV-1a hash of the function name.
+		uint32_t hashApiName(const char* name) {
+			uint32_t hash = 2166136261u;
+			while (*name) {
+				hash = (hash ^ (uint8_t)*name++) * 16777619u;
+			}
+			return hash;
 		}
-		else {
+	} // namespace
+
+	XrResult OpenXrApi::xrGetInstanceProcAddr(XrInstance instance, const char* name, PFN_xrVoidFunction* function) {
+		// Auto-generated perfect hash of the function names.
+		static const uint32_t displacements[] = {
+			3u,
+			0u,
+			1u,
+			1u,
+			2u,
+			2u,
+			2u,
+			0u,
+			0u,
+			1u,
+			1u,
+			2u,
+			1u,
+			1u,
+			6u,
+			0u,
+			0u,
+			1u,
+			2u,
+			0u,
+			2u,
+			2u,
+			0u,
+			1u,
+			1u,
+			2u,
+			1u,
+			1u,
+			1u,
+			1u,
+			0u,
+			0u,
+			4u,
+			2u,
+			1u,
+			2u,
+			4u,
+			1u,
+			0u,
+			2u,
+			1u,
+			3u,
+			1u,
+			2u,
+			0u,
+			3u,
+			0u,
+			0u,
+			0u,
+			6u,
+			3u,
+			1u,
+			3u,
+			5u,
+			0u,
+			2u,
+			1u,
+			3u,
+			1u,
+			2u,
+			4u,
+			1u,
+			0u,
+			3u
+		};
+		static const struct {
+			const char* name;
+			PFN_xrVoidFunction function;
+			bool (*isAvailable)(const OpenXrApi& api);
+		} entries[] = {
+			{nullptr, nullptr, nullptr},
+			{"xrCreateActionSpace", reinterpret_cast<PFN_xrVoidFunction>(RUNTIME_NAMESPACE::xrCreateActionSpace), nullptr},
+			{"xrGetDisplayRefreshRateFB", reinterpret_cast<PFN_xrVoidFunction>(RUNTIME_NAMESPACE::xrGetDisplayRefreshRateFB), [](const OpenXrApi& api) { return api.has_XR_FB_display_refresh_rate; }},
+			{"xrResultToString", reinterpret_cast<PFN_xrVoidFunction>(RUNTIME_NAMESPACE::xrResultToString), nullptr},
+			{"xrBeginFrame", reinterpret_cast<PFN_xrVoidFunction>(RUNTIME_NAMESPACE::xrBeginFrame), nullptr},
+			{"xrApplyHapticFeedback", reinterpret_cast<PFN_xrVoidFunction>(RUNTIME_NAMESPACE::xrApplyHapticFeedback), nullptr},
+			{"xrGetSystem", reinterpret_cast<PFN_xrVoidFunction>(RUNTIME_NAMESPACE::xrGetSystem), nullptr},
+			{"xrStructureTypeToString", reinterpret_cast<PFN_xrVoidFunction>(RUNTIME_NAMESPACE::xrStructureTypeToString), nullptr},
+			{"xrGetReferenceSpaceBoundsRect", reinterpret_cast<PFN_xrVoidFunction>(RUNTIME_NAMESPACE::xrGetReferenceSpaceBoundsRect), nullptr},
+			{nullptr, nullptr, nullptr},
+			{"xrLocateSpacesKHR", reinterpret_cast<PFN_xrVoidFunction>(RUNTIME_NAMESPACE::xrLocateSpacesKHR), [](const OpenXrApi& api) { return api.has_XR_KHR_locate_spaces; }},
+			{"xrGetVulkanGraphicsRequirements2KHR", reinterpret_cast<PFN_xrVoidFunction>(RUNTIME_NAMESPACE::xrGetVulkanGraphicsRequirements2KHR), [](const OpenXrApi& api) { return api.has_XR_KHR_vulkan_enable2; }},
+			{"xrWaitFrame", reinterpret_cast<PFN_xrVoidFunction>(RUNTIME_NAMESPACE::xrWaitFrame), nullptr},
+			{"xrGetVisibilityMaskKHR", reinterpret_cast<PFN_xrVoidFunction>(RUNTIME_NAMESPACE::xrGetVisibilityMaskKHR), [](const OpenXrApi& api) { return api.has_XR_KHR_visibility_mask; }},
+			{"xrCreateReferenceSpace", reinterpret_cast<PFN_xrVoidFunction>(RUNTIME_NAMESPACE::xrCreateReferenceSpace), nullptr},
+			{"xrGetOpenGLGraphicsRequirementsKHR", reinterpret_cast<PFN_xrVoidFunction>(RUNTIME_NAMESPACE::xrGetOpenGLGraphicsRequirementsKHR), [](const OpenXrApi& api) { return api.has_XR_KHR_opengl_enable; }},
+			{nullptr, nullptr, nullptr},
+			{nullptr, nullptr, nullptr},
+			{"xrGetD3D12GraphicsRequirementsKHR", reinterpret_cast<PFN_xrVoidFunction>(RUNTIME_NAMESPACE::xrGetD3D12GraphicsRequirementsKHR), [](const OpenXrApi& api) { return api.has_XR_KHR_D3D12_enable; }},
+			{nullptr, nullptr, nullptr},
+			{"xrDestroyAction", reinterpret_cast<PFN_xrVoidFunction>(RUNTIME_NAMESPACE::xrDestroyAction), nullptr},
+			{nullptr, nullptr, nullptr},
+			{"xrDestroySession", reinterpret_cast<PFN_xrVoidFunction>(RUNTIME_NAMESPACE::xrDestroySession), nullptr},
+			{"xrDestroyActionSet", reinterpret_cast<PFN_xrVoidFunction>(RUNTIME_NAMESPACE::xrDestroyActionSet), nullptr},
+			{nullptr, nullptr, nullptr},
+			{"xrEnumerateBoundSourcesForAction", reinterpret_cast<PFN_xrVoidFunction>(RUNTIME_NAMESPACE::xrEnumerateBoundSourcesForAction), nullptr},
+			{"xrGetActionStateFloat", reinterpret_cast<PFN_xrVoidFunction>(RUNTIME_NAMESPACE::xrGetActionStateFloat), nullptr},
+			{nullptr, nullptr, nullptr},
+			{"xrDestroyInstance", reinterpret_cast<PFN_xrVoidFunction>(RUNTIME_NAMESPACE::xrDestroyInstance), nullptr},
+			{nullptr, nullptr, nullptr},
+			{"xrCreateVulkanDeviceKHR", reinterpret_cast<PFN_xrVoidFunction>(RUNTIME_NAMESPACE::xrCreateVulkanDeviceKHR), [](const OpenXrApi& api) { return api.has_XR_KHR_vulkan_enable2; }},
+			{nullptr, nullptr, nullptr},
+			{"xrGetInstanceProcAddr", reinterpret_cast<PFN_xrVoidFunction>(RUNTIME_NAMESPACE::xrGetInstanceProcAddr), nullptr},
+			{"xrConvertTimeToWin32PerformanceCounterKHR", reinterpret_cast<PFN_xrVoidFunction>(RUNTIME_NAMESPACE::xrConvertTimeToWin32PerformanceCounterKHR), [](const OpenXrApi& api) { return api.has_XR_KHR_win32_convert_performance_counter_time; }},
+			{"xrRequestExitSession", reinterpret_cast<PFN_xrVoidFunction>(RUNTIME_NAMESPACE::xrRequestExitSession), nullptr},
+			{nullptr, nullptr, nullptr},
+			{nullptr, nullptr, nullptr},
+			{"xrStopHapticFeedback", reinterpret_cast<PFN_xrVoidFunction>(RUNTIME_NAMESPACE::xrStopHapticFeedback), nullptr},
+			{"xrSyncActions", reinterpret_cast<PFN_xrVoidFunction>(RUNTIME_NAMESPACE::xrSyncActions), nullptr},
+			{"xrSuggestInteractionProfileBindings", reinterpret_cast<PFN_xrVoidFunction>(RUNTIME_NAMESPACE::xrSuggestInteractionProfileBindings), nullptr},
+			{nullptr, nullptr, nullptr},
+			{"xrEnumerateEnvironmentBlendModes", reinterpret_cast<PFN_xrVoidFunction>(RUNTIME_NAMESPACE::xrEnumerateEnvironmentBlendModes), nullptr},
+			{nullptr, nullptr, nullptr},
+			{"xrReleaseSwapchainImage", reinterpret_cast<PFN_xrVoidFunction>(RUNTIME_NAMESPACE::xrReleaseSwapchainImage), nullptr},
+			{"xrDestroyHandTrackerEXT", reinterpret_cast<PFN_xrVoidFunction>(RUNTIME_NAMESPACE::xrDestroyHandTrackerEXT), [](const OpenXrApi& api) { return api.has_XR_EXT_hand_tracking; }},
+			{"xrCreateHandTrackerEXT", reinterpret_cast<PFN_xrVoidFunction>(RUNTIME_NAMESPACE::xrCreateHandTrackerEXT), [](const OpenXrApi& api) { return api.has_XR_EXT_hand_tracking; }},
+			{nullptr, nullptr, nullptr},
+			{nullptr, nullptr, nullptr},
+			{nullptr, nullptr, nullptr},
+			{"xrCreateSession", reinterpret_cast<PFN_xrVoidFunction>(RUNTIME_NAMESPACE::xrCreateSession), nullptr},
+			{"xrLocateHandJointsEXT", reinterpret_cast<PFN_xrVoidFunction>(RUNTIME_NAMESPACE::xrLocateHandJointsEXT), [](const OpenXrApi& api) { return api.has_XR_EXT_hand_tracking; }},
+			{nullptr, nullptr, nullptr},
+			{nullptr, nullptr, nullptr},
+			{"xrEndFrame", reinterpret_cast<PFN_xrVoidFunction>(RUNTIME_NAMESPACE::xrEndFrame), nullptr},
+			{nullptr, nullptr, nullptr},
+			{"xrCreateActionSet", reinterpret_cast<PFN_xrVoidFunction>(RUNTIME_NAMESPACE::xrCreateActionSet), nullptr},
+			{nullptr, nullptr, nullptr},
+			{"xrEnumerateReferenceSpaces", reinterpret_cast<PFN_xrVoidFunction>(RUNTIME_NAMESPACE::xrEnumerateReferenceSpaces), nullptr},
+			{"xrGetActionStateVector2f", reinterpret_cast<PFN_xrVoidFunction>(RUNTIME_NAMESPACE::xrGetActionStateVector2f), nullptr},
+			{nullptr, nullptr, nullptr},
+			{"xrDestroySpace", reinterpret_cast<PFN_xrVoidFunction>(RUNTIME_NAMESPACE::xrDestroySpace), nullptr},
+			{"xrPollEvent", reinterpret_cast<PFN_xrVoidFunction>(RUNTIME_NAMESPACE::xrPollEvent), nullptr},
+			{"xrGetVulkanDeviceExtensionsKHR", reinterpret_cast<PFN_xrVoidFunction>(RUNTIME_NAMESPACE::xrGetVulkanDeviceExtensionsKHR), [](const OpenXrApi& api) { return api.has_XR_KHR_vulkan_enable; }},
+			{"xrGetSystemProperties", reinterpret_cast<PFN_xrVoidFunction>(RUNTIME_NAMESPACE::xrGetSystemProperties), nullptr},
+			{"xrBeginSession", reinterpret_cast<PFN_xrVoidFunction>(RUNTIME_NAMESPACE::xrBeginSession), nullptr},
+			{"xrAcquireSwapchainImage", reinterpret_cast<PFN_xrVoidFunction>(RUNTIME_NAMESPACE::xrAcquireSwapchainImage), nullptr},
+			{nullptr, nullptr, nullptr},
+			{nullptr, nullptr, nullptr},
+			{"xrStringToPath", reinterpret_cast<PFN_xrVoidFunction>(RUNTIME_NAMESPACE::xrStringToPath), nullptr},
+			{"xrCreateSwapchain", reinterpret_cast<PFN_xrVoidFunction>(RUNTIME_NAMESPACE::xrCreateSwapchain), nullptr},
+			{nullptr, nullptr, nullptr},
+			{"xrLocateViews", reinterpret_cast<PFN_xrVoidFunction>(RUNTIME_NAMESPACE::xrLocateViews), nullptr},
+			{nullptr, nullptr, nullptr},
+			{nullptr, nullptr, nullptr},
+			{nullptr, nullptr, nullptr},
+			{"xrRequestDisplayRefreshRateFB", reinterpret_cast<PFN_xrVoidFunction>(RUNTIME_NAMESPACE::xrRequestDisplayRefreshRateFB), [](const OpenXrApi& api) { return api.has_XR_FB_display_refresh_rate; }},
+			{nullptr, nullptr, nullptr},
+			{nullptr, nullptr, nullptr},
+			{nullptr, nullptr, nullptr},
+			{"xrDestroySwapchain", reinterpret_cast<PFN_xrVoidFunction>(RUNTIME_NAMESPACE::xrDestroySwapchain), nullptr},
+			{"xrGetActionStateBoolean", reinterpret_cast<PFN_xrVoidFunction>(RUNTIME_NAMESPACE::xrGetActionStateBoolean), nullptr},
+			{"xrGetRecommendedLayerResolutionMETA", reinterpret_cast<PFN_xrVoidFunction>(RUNTIME_NAMESPACE::xrGetRecommendedLayerResolutionMETA), [](const OpenXrApi& api) { return api.has_XR_META_recommended_layer_resolution; }},
+			{"xrEnumerateSwapchainImages", reinterpret_cast<PFN_xrVoidFunction>(RUNTIME_NAMESPACE::xrEnumerateSwapchainImages), nullptr},
+			{nullptr, nullptr, nullptr},
+			{"xrConvertWin32PerformanceCounterToTimeKHR", reinterpret_cast<PFN_xrVoidFunction>(RUNTIME_NAMESPACE::xrConvertWin32PerformanceCounterToTimeKHR), [](const OpenXrApi& api) { return api.has_XR_KHR_win32_convert_performance_counter_time; }},
+			{nullptr, nullptr, nullptr},
+			{"xrAttachSessionActionSets", reinterpret_cast<PFN_xrVoidFunction>(RUNTIME_NAMESPACE::xrAttachSessionActionSets), nullptr},
+			{"xrCreateVulkanInstanceKHR", reinterpret_cast<PFN_xrVoidFunction>(RUNTIME_NAMESPACE::xrCreateVulkanInstanceKHR), [](const OpenXrApi& api) { return api.has_XR_KHR_vulkan_enable2; }},
+			{nullptr, nullptr, nullptr},
+			{nullptr, nullptr, nullptr},
+			{nullptr, nullptr, nullptr},
+			{"xrLocateSpace", reinterpret_cast<PFN_xrVoidFunction>(RUNTIME_NAMESPACE::xrLocateSpace), nullptr},
+			{nullptr, nullptr, nullptr},
+			{"xrGetVulkanGraphicsDevice2KHR", reinterpret_cast<PFN_xrVoidFunction>(RUNTIME_NAMESPACE::xrGetVulkanGraphicsDevice2KHR), [](const OpenXrApi& api) { return api.has_XR_KHR_vulkan_enable2; }},
+			{nullptr, nullptr, nullptr},
+			{nullptr, nullptr, nullptr},
+			{nullptr, nullptr, nullptr},
+			{"xrGetInputSourceLocalizedName", reinterpret_cast<PFN_xrVoidFunction>(RUNTIME_NAMESPACE::xrGetInputSourceLocalizedName), nullptr},
+			{"xrGetViewConfigurationProperties", reinterpret_cast<PFN_xrVoidFunction>(RUNTIME_NAMESPACE::xrGetViewConfigurationProperties), nullptr},
+			{"xrEnumerateInstanceExtensionProperties", reinterpret_cast<PFN_xrVoidFunction>(RUNTIME_NAMESPACE::xrEnumerateInstanceExtensionProperties), nullptr},
+			{"xrCreateInstance", reinterpret_cast<PFN_xrVoidFunction>(RUNTIME_NAMESPACE::xrCreateInstance), nullptr},
+			{nullptr, nullptr, nullptr},
+			{"xrEndSession", reinterpret_cast<PFN_xrVoidFunction>(RUNTIME_NAMESPACE::xrEndSession), nullptr},
+			{"xrEnumerateDisplayRefreshRatesFB", reinterpret_cast<PFN_xrVoidFunction>(RUNTIME_NAMESPACE::xrEnumerateDisplayRefreshRatesFB), [](const OpenXrApi& api) { return api.has_XR_FB_display_refresh_rate; }},
+			{"xrGetD3D11GraphicsRequirementsKHR", reinterpret_cast<PFN_xrVoidFunction>(RUNTIME_NAMESPACE::xrGetD3D11GraphicsRequirementsKHR), [](const OpenXrApi& api) { return api.has_XR_KHR_D3D11_enable; }},
+			{nullptr, nullptr, nullptr},
+			{"xrEnumerateViewConfigurations", reinterpret_cast<PFN_xrVoidFunction>(RUNTIME_NAMESPACE::xrEnumerateViewConfigurations), nullptr},
+			{nullptr, nullptr, nullptr},
+			{nullptr, nullptr, nullptr},
+			{nullptr, nullptr, nullptr},
+			{"xrCreateAction", reinterpret_cast<PFN_xrVoidFunction>(RUNTIME_NAMESPACE::xrCreateAction), nullptr},
+			{"xrGetVulkanGraphicsDeviceKHR", reinterpret_cast<PFN_xrVoidFunction>(RUNTIME_NAMESPACE::xrGetVulkanGraphicsDeviceKHR), [](const OpenXrApi& api) { return api.has_XR_KHR_vulkan_enable; }},
+			{nullptr, nullptr, nullptr},
+			{"xrPathToString", reinterpret_cast<PFN_xrVoidFunction>(RUNTIME_NAMESPACE::xrPathToString), nullptr},
+			{nullptr, nullptr, nullptr},
+			{"xrGetActionStatePose", reinterpret_cast<PFN_xrVoidFunction>(RUNTIME_NAMESPACE::xrGetActionStatePose), nullptr},
+			{"xrWaitSwapchainImage", reinterpret_cast<PFN_xrVoidFunction>(RUNTIME_NAMESPACE::xrWaitSwapchainImage), nullptr},
+			{nullptr, nullptr, nullptr},
+			{nullptr, nullptr, nullptr},
+			{nullptr, nullptr, nullptr},
+			{nullptr, nullptr, nullptr},
+			{"xrEnumerateViewConfigurationViews", reinterpret_cast<PFN_xrVoidFunction>(RUNTIME_NAMESPACE::xrEnumerateViewConfigurationViews), nullptr},
+			{"xrGetVulkanInstanceExtensionsKHR", reinterpret_cast<PFN_xrVoidFunction>(RUNTIME_NAMESPACE::xrGetVulkanInstanceExtensionsKHR), [](const OpenXrApi& api) { return api.has_XR_KHR_vulkan_enable; }},
+			{nullptr, nullptr, nullptr},
+			{"xrGetVulkanGraphicsRequirementsKHR", reinterpret_cast<PFN_xrVoidFunction>(RUNTIME_NAMESPACE::xrGetVulkanGraphicsRequirementsKHR), [](const OpenXrApi& api) { return api.has_XR_KHR_vulkan_enable; }},
+			{"xrEnumerateSwapchainFormats", reinterpret_cast<PFN_xrVoidFunction>(RUNTIME_NAMESPACE::xrEnumerateSwapchainFormats), nullptr},
+			{"xrGetCurrentInteractionProfile", reinterpret_cast<PFN_xrVoidFunction>(RUNTIME_NAMESPACE::xrGetCurrentInteractionProfile), nullptr},
+			{"xrGetInstanceProperties", reinterpret_cast<PFN_xrVoidFunction>(RUNTIME_NAMESPACE::xrGetInstanceProperties), nullptr},
+		};
+
+		const uint32_t hash = hashApiName(name);
+		const uint32_t displacement = displacements[hash % std::size(displacements)];
+		const auto& entry = entries[((hash ^ displacement) * 0x9e3779b1u) >> 25];
+		if (!entry.name || strcmp(entry.name, name) || (entry.isAvailable && !entry.isAvailable(*this))) {
 			return XR_ERROR_FUNCTION_UNSUPPORTED;
 		}
 
+		*function = entry.function;
+
 		return XR_SUCCESS;
 	}
 
@@ -1821,6 +2197,21 @@ namespace RUNTIME_NAMESPACE {
 		else if (extensionName == "XR_EXT_hand_joints_motion_range") {
 			has_XR_EXT_hand_joints_motion_range = true;
 		}
+		else if (extensionName == "XR_KHR_locate_spaces") {
+			has_XR_KHR_locate_spaces = true;
+		}
+		else if (extensionName == "XR_VARJO_quad_views") {
+			has_XR_VARJO_quad_views = true;
+		}
+		else if (extensionName == "XR_EXT_eye_gaze_interaction") {
+			has_XR_EXT_eye_gaze_interaction = true;
+		}
+		else if (extensionName == "XR_META_recommended_layer_resolution") {
+			has_XR_META_recommended_layer_resolution = true;
+		}
+		else if (extensionName == "XR_FB_space_warp") {
+			has_XR_FB_space_warp = true;
+		}
 
 	}
 
@@ -114,6 +114,8 @@ namespace RUNTIME_NAMESPACE {
 		virtual XrResult xrEnumerateDisplayRefreshRatesFB(XrSession session, uint32_t displayRefreshRateCapacityInput, uint32_t* displayRefreshRateCountOutput, float* displayRefreshRates) = 0;
 		virtual XrResult xrGetDisplayRefreshRateFB(XrSession session, float* displayRefreshRate) = 0;
 		virtual XrResult xrRequestDisplayRefreshRateFB(XrSession session, float displayRefreshRate) = 0;
+		virtual XrResult xrLocateSpacesKHR(XrSession session, const XrSpacesLocateInfoKHR* locateInfo, XrSpaceLocationsKHR* spaceLocations) = 0;
+		virtual XrResult xrGetRecommendedLayerResolutionMETA(XrSession session, const XrRecommendedLayerResolutionGetInfoMETA* info, XrRecommendedLayerResolutionMETA* resolution) = 0;
 
 
 	protected:
@@ -132,6 +134,11 @@ namespace RUNTIME_NAMESPACE {
 		bool has_XR_FB_display_refresh_rate{false};
 		bool has_XR_EXT_hand_tracking{false};
 		bool has_XR_EXT_hand_joints_motion_range{false};
+		bool has_XR_KHR_locate_spaces{false};
+		bool has_XR_VARJO_quad_views{false};
+		bool has_XR_EXT_eye_gaze_interaction{false};
+		bool has_XR_META_recommended_layer_resolution{false};
+		bool has_XR_FB_space_warp{false};
 
 
 	};
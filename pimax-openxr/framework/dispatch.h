@@ -33,4 +33,8 @@ namespace RUNTIME_NAMESPACE {
                                    const char* name,
                                    PFN_xrVoidFunction* function);
 
+    // The names of the APIs wrapped by the dispatcher, indexed like the performance statistics.
+    extern const char* const g_apiNames[];
+    extern const uint32_t g_apiCount;
+
 } // namespace RUNTIME_NAMESPACE
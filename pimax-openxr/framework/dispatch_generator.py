@@ -40,7 +40,53 @@ from xrconventions import OpenXRConventions
 EXCLUDED_API = ['xrGetInstanceProcAddr', 'xrEnumerateApiLayerProperties']
 EXTENSIONS = ['XR_KHR_D3D11_enable', 'XR_KHR_D3D12_enable', 'XR_KHR_vulkan_enable', 'XR_KHR_vulkan_enable2', 'XR_KHR_opengl_enable',
               'XR_KHR_composition_layer_depth', 'XR_KHR_visibility_mask', 'XR_KHR_win32_convert_performance_counter_time', 'XR_FB_display_refresh_rate',
-              'XR_EXT_hand_tracking', 'XR_EXT_hand_joints_motion_range']
+              'XR_EXT_hand_tracking', 'XR_EXT_hand_joints_motion_range', 'XR_KHR_locate_spaces', 'XR_VARJO_quad_views',
+              'XR_EXT_eye_gaze_interaction', 'XR_META_recommended_layer_resolution',
+              'XR_FB_space_warp']
+
+# Functions called many times per frame, for which the wrapper skips tracing entirely when no trace session is active.
+HOT_API = ['xrLocateSpace', 'xrLocateSpacesKHR', 'xrLocateViews', 'xrGetActionStateBoolean', 'xrGetActionStateFloat',
+           'xrGetActionStateVector2f', 'xrGetActionStatePose', 'xrLocateHandJointsEXT']
+
+def hashApiName(name):
+    '''FNV-1a hash, must match hashApiName() in the generated code.'''
+    hash = 2166136261
+    for c in name.encode():
+        hash = ((hash ^ c) * 16777619) & 0xffffffff
+    return hash
+
+def displaceHash(hash, displacement, table_bits):
+    '''Multiplicative hash of the displaced hash, must match the generated lookup.'''
+    return (((hash ^ displacement) * 0x9e3779b1) & 0xffffffff) >> (32 - table_bits)
+
+def makePerfectHash(names):
+    '''Build a hash-and-displace perfect hash: each bucket of names gets a displacement placing all its names into free
+    slots of the table.'''
+    table_bits = max(1, (len(names) - 1).bit_length())
+    table_size = 1 << table_bits
+    bucket_count = max(1, table_size // 2)
+
+    buckets = [[] for _ in range(bucket_count)]
+    for name in names:
+        buckets[hashApiName(name) % bucket_count].append(name)
+
+    displacements = [0] * bucket_count
+    slots = [None] * table_size
+    for bucket_index in sorted(range(bucket_count), key=lambda i: -len(buckets[i])):
+        bucket = buckets[bucket_index]
+        if not bucket:
+            continue
+        displacement = 1
+        while True:
+            candidates = [displaceHash(hashApiName(name), displacement, table_bits) for name in bucket]
+            if len(set(candidates)) == len(candidates) and all(slots[c] is None for c in candidates):
+                break
+            displacement += 1
+        displacements[bucket_index] = displacement
+        for name, slot in zip(bucket, candidates):
+            slots[slot] = name
+
+    return table_bits, displacements, slots
 
 class DispatchGenOutputGenerator(AutomaticSourceOutputGenerator):
     '''Common generator utilities and formatting.'''
@@ -104,6 +150,7 @@ class DispatchGenCppOutputGenerator(DispatchGenOutputGenerator):
 
 #include "dispatch.h"
 #include "log.h"
+#include "perf_stats.h"
 
 #ifndef RUNTIME_NAMESPACE
 #error Must define RUNTIME_NAMESPACE
@@ -115,6 +162,7 @@ namespace RUNTIME_NAMESPACE {
         write(preamble, file=self.outFile)
 
     def endFile(self):
+        generated_api_names = self.genApiNames()
         generated_wrappers = self.genWrappers()
         generated_get_instance_proc_addr = self.genGetInstanceProcAddr()
         generated_register_instance_extension = self.genRegisterInstanceExtension()
@@ -123,6 +171,9 @@ namespace RUNTIME_NAMESPACE {
 '''
 
         contents = f'''
+	// Auto-generated names of the APIs, indexed like the performance statistics.
+{generated_api_names}
+
 	// Auto-generated wrappers for the APIs.
 {generated_wrappers}
 
@@ -137,17 +188,47 @@ namespace RUNTIME_NAMESPACE {
         write(contents, file=self.outFile)
         DispatchGenOutputGenerator.endFile(self)
 
+    def getWrappedCommands(self):
+        return [cur_cmd for cur_cmd in self.core_commands + self.ext_commands
+                if cur_cmd.name not in EXCLUDED_API + ['xrDestroyInstance']]
+
+    def genApiNames(self):
+        generated_names = "\n".join([f'''		"{cur_cmd.name}",''' for cur_cmd in self.getWrappedCommands()])
+
+        return f'''	const char* const g_apiNames[] = {{
+{generated_names}
+	}};
+	const uint32_t g_apiCount = (uint32_t)std::size(g_apiNames);'''
+
     def genWrappers(self):
         generated = ''
 
-        for cur_cmd in self.core_commands + self.ext_commands:
-            if cur_cmd.name not in EXCLUDED_API + ['xrDestroyInstance']:
-                parameters_list = self.makeParametersList(cur_cmd)
-                arguments_list = self.makeArgumentsList(cur_cmd)
-
-                if cur_cmd.return_type is not None:
-                    generated += f'''
+        for api_index, cur_cmd in enumerate(self.getWrappedCommands()):
+            parameters_list = self.makeParametersList(cur_cmd)
+            arguments_list = self.makeArgumentsList(cur_cmd)
+
+            if cur_cmd.return_type is not None:
+                fast_path = ''
+                if cur_cmd.name in HOT_API:
+                    fast_path = f'''
+		// Hot function: avoid the cost of the trace activity when nobody is listening.
+		if (!IsTraceEnabled()) {{
+			try {{
+				const XrResult result = RUNTIME_NAMESPACE::GetInstance()->{cur_cmd.name}({arguments_list});
+				if (XR_FAILED(result)) {{
+					ErrorLog("{cur_cmd.name} failed with %s\\n", xr::ToCString(result));
+				}}
+				return result;
+			}} catch (std::exception& exc) {{
+				ErrorLog("{cur_cmd.name}: %s\\n", exc.what());
+				return XR_ERROR_RUNTIME_FAILURE;
+			}}
+		}}
+'''
+                generated += f'''
 	XrResult XRAPI_CALL {cur_cmd.name}({parameters_list}) {{
+		stats::ApiCallTimer apiCallTimer({api_index});
+{fast_path}
 		TraceLocalActivity(local);
 		TraceLoggingWriteStart(local, "{cur_cmd.name}");
 
@@ -168,9 +249,11 @@ namespace RUNTIME_NAMESPACE {
 		return result;
 	}}
 '''
-                else:
-                    generated += f'''
+            else:
+                generated += f'''
 	void XRAPI_CALL {cur_cmd.name}({parameters_list}) {{
+		stats::ApiCallTimer apiCallTimer({api_index});
+
 		TraceLocalActivity(local);
 		TraceLoggingWriteStart(local, "{cur_cmd.name}");
 
@@ -184,37 +267,64 @@ namespace RUNTIME_NAMESPACE {
 		TraceLoggingWriteStop(local, "{cur_cmd.name}");
 	}}
 '''
-                
+            
         return generated
 
     def genGetInstanceProcAddr(self):
-        generated = '''	XrResult OpenXrApi::xrGetInstanceProcAddr(XrInstance instance, const char* name, PFN_xrVoidFunction* function) {
-		const std::string apiName(name);
-
-		if (apiName == "xrGetInstanceProcAddr") {
-			*function = reinterpret_cast<PFN_xrVoidFunction>(RUNTIME_NAMESPACE::xrGetInstanceProcAddr);
-		}
-'''
-
+        # The name of each function, and the condition for the function to be available.
+        entries = {'xrGetInstanceProcAddr': None}
         for cur_cmd in self.core_commands:
             if cur_cmd.name not in EXCLUDED_API:
-                generated += f'''		else if (apiName == "{cur_cmd.name}") {{
-			*function = reinterpret_cast<PFN_xrVoidFunction>(RUNTIME_NAMESPACE::{cur_cmd.name});
-		}}
-'''
-
+                entries[cur_cmd.name] = None
         for cur_cmd in self.ext_commands:
             if cur_cmd.name not in EXCLUDED_API:
-                requirements = " && ".join([f"has_{required_ext}" for required_ext in cur_cmd.required_exts])
-                generated += f'''		else if ({requirements} && apiName == "{cur_cmd.name}") {{
-			*function = reinterpret_cast<PFN_xrVoidFunction>(RUNTIME_NAMESPACE::{cur_cmd.name});
-		}}
+                entries[cur_cmd.name] = " && ".join([f"api.has_{required_ext}" for required_ext in cur_cmd.required_exts])
+
+        table_bits, displacements, slots = makePerfectHash(list(entries.keys()))
+
+        generated_displacements = ",\n".join([f"\t\t\t{displacement}u" for displacement in displacements])
+        generated_entries = ''
+        for name in slots:
+            if name is None:
+                generated_entries += '''			{nullptr, nullptr, nullptr},
+'''
+            else:
+                requirement = f"[](const OpenXrApi& api) {{ return {entries[name]}; }}" if entries[name] else "nullptr"
+                generated_entries += f'''			{{"{name}", reinterpret_cast<PFN_xrVoidFunction>(RUNTIME_NAMESPACE::{name}), {requirement}}},
 '''
 
-        generated += f'''		else {{
+        generated = f'''	namespace {{
+		// FNV-1a hash of the function name.
+		uint32_t hashApiName(const char* name) {{
+			uint32_t hash = 2166136261u;
+			while (*name) {{
+				hash = (hash ^ (uint8_t)*name++) * 16777619u;
+			}}
+			return hash;
+		}}
+	}} // namespace
+
+	XrResult OpenXrApi::xrGetInstanceProcAddr(XrInstance instance, const char* name, PFN_xrVoidFunction* function) {{
+		// Auto-generated perfect hash of the function names.
+		static const uint32_t displacements[] = {{
+{generated_displacements}
+		}};
+		static const struct {{
+			const char* name;
+			PFN_xrVoidFunction function;
+			bool (*isAvailable)(const OpenXrApi& api);
+		}} entries[] = {{
+{generated_entries}		}};
+
+		const uint32_t hash = hashApiName(name);
+		const uint32_t displacement = displacements[hash % std::size(displacements)];
+		const auto& entry = entries[((hash ^ displacement) * 0x9e3779b1u) >> {32 - table_bits}];
+		if (!entry.name || strcmp(entry.name, name) || (entry.isAvailable && !entry.isAvailable(*this))) {{
 			return XR_ERROR_FUNCTION_UNSUPPORTED;
 		}}
 
+		*function = entry.function;
+
 		return XR_SUCCESS;
 	}}'''
 
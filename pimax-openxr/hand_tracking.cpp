@@ -66,10 +66,8 @@ namespace pimax_openxr {
         HandTracker& xrHandTracker = *new HandTracker;
         xrHandTracker.side = createInfo->hand == XR_HAND_LEFT_EXT ? 0 : 1;
 
-        *handTracker = (XrHandTrackerEXT)&xrHandTracker;
-
         // Maintain a list of known trackers for validation.
-        m_handTrackers.insert(*handTracker);
+        *handTracker = m_handTrackers.insert(&xrHandTracker);
 
         TraceLoggingWrite(g_traceProvider, "xrCreateHandTrackerEXT", TLXArg(*handTracker, "HandTracker"));
 
@@ -84,11 +82,11 @@ namespace pimax_openxr {
             return XR_ERROR_FUNCTION_UNSUPPORTED;
         }
 
-        if (!m_handTrackers.count(handTracker)) {
+        if (!m_handTrackers.contains(handTracker)) {
             return XR_ERROR_HANDLE_INVALID;
         }
 
-        HandTracker* xrHandTracker = (HandTracker*)handTracker;
+        HandTracker* xrHandTracker = m_handTrackers.get(handTracker);
 
         delete xrHandTracker;
         m_handTrackers.erase(handTracker);
@@ -115,7 +113,7 @@ namespace pimax_openxr {
             return XR_ERROR_FUNCTION_UNSUPPORTED;
         }
 
-        if (!m_handTrackers.count(handTracker) || !m_spaces.count(locateInfo->baseSpace)) {
+        if (!m_handTrackers.contains(handTracker) || !m_spaces.contains(locateInfo->baseSpace)) {
             return XR_ERROR_HANDLE_INVALID;
         }
 
@@ -143,7 +141,7 @@ namespace pimax_openxr {
             return XR_ERROR_VALIDATION_FAILURE;
         }
 
-        HandTracker& xrHandTracker = *(HandTracker*)handTracker;
+        HandTracker& xrHandTracker = *m_handTrackers.get(handTracker);
 
         pvrSkeletalMotionRange range = pvrSkeletalMotionRange_WithoutController;
         if (motionRange) {
@@ -152,85 +150,22 @@ namespace pimax_openxr {
                         : pvrSkeletalMotionRange_WithController;
         }
 
-        Space& xrBaseSpace = *(Space*)locateInfo->baseSpace;
+        // PVR only gives us the latest skeleton, so we only need to query it again upon a new frame.
+        const uint64_t generation = m_poseCacheGeneration;
+        if (xrHandTracker.generation != generation || xrHandTracker.range != range) {
+            updateHandJoints(xrHandTracker, range);
+            xrHandTracker.generation = generation;
+            xrHandTracker.range = range;
+        }
+        locations->isActive = xrHandTracker.isActive ? XR_TRUE : XR_FALSE;
+
+        Space& xrBaseSpace = *m_spaces.get(locateInfo->baseSpace);
 
         XrPosef baseSpaceToVirtual = Pose::Identity();
         XrPosef basePose = Pose::Identity();
         const auto flags1 = locateSpaceToOrigin(xrBaseSpace, locateInfo->time, baseSpaceToVirtual, nullptr);
         const auto flags2 = getControllerPose(xrHandTracker.side, locateInfo->time, basePose, nullptr);
 
-        pvrSkeletalData skeletalData{};
-        const auto result = pvr_getSkeletalData(m_pvrSession,
-                                                xrHandTracker.side == 0 ? pvrTrackedDevice_LeftController
-                                                                        : pvrTrackedDevice_RightController,
-                                                range,
-                                                &skeletalData);
-        if (result == pvr_not_support || skeletalData.boneCount == 0) {
-            TraceLoggingWrite(g_traceProvider,
-                              "PVR_SkeletalData",
-                              TLArg(xrHandTracker.side == 0 ? "Left" : "Right", "Side"),
-                              TLArg(xr::ToString(result).c_str(), "Result"),
-                              TLArg(skeletalData.boneCount, "Count"));
-
-            // This is how we detect no hands presence.
-            locations->isActive = XR_FALSE;
-
-        } else {
-            CHECK_PVRCMD(result);
-
-            // We rely on PVR using the same definitions as SteamVR, which turn out to be share (almost) the same first
-            // 26 joints with the OpenXr definitions. https://github.com/ValveSoftware/openvr/wiki/Hand-Skeleton
-            TraceLoggingWrite(
-                g_traceProvider,
-                "PVR_SkeletalData",
-                TLArg(xrHandTracker.side == 0 ? "Left" : "Right", "Side"),
-                TLArg(skeletalData.boneCount, "Count"),
-                TLArg(xr::ToString(skeletalData.boneTransforms[0]).c_str(), "Root"),
-                TLArg(xr::ToString(skeletalData.boneTransforms[XR_HAND_JOINT_WRIST_EXT]).c_str(), "Wrist"),
-                TLArg(xr::ToString(skeletalData.boneTransforms[XR_HAND_JOINT_THUMB_METACARPAL_EXT]).c_str(),
-                      "ThumbMetacarpal"),
-                TLArg(xr::ToString(skeletalData.boneTransforms[XR_HAND_JOINT_THUMB_PROXIMAL_EXT]).c_str(),
-                      "ThumbProximal"),
-                TLArg(xr::ToString(skeletalData.boneTransforms[XR_HAND_JOINT_THUMB_DISTAL_EXT]).c_str(), "ThumbDistal"),
-                TLArg(xr::ToString(skeletalData.boneTransforms[XR_HAND_JOINT_THUMB_TIP_EXT]).c_str(), "ThumbTip"),
-                TLArg(xr::ToString(skeletalData.boneTransforms[XR_HAND_JOINT_INDEX_METACARPAL_EXT]).c_str(),
-                      "IndexMetacarpal"),
-                TLArg(xr::ToString(skeletalData.boneTransforms[XR_HAND_JOINT_INDEX_PROXIMAL_EXT]).c_str(),
-                      "IndexProximal"),
-                TLArg(xr::ToString(skeletalData.boneTransforms[XR_HAND_JOINT_INDEX_INTERMEDIATE_EXT]).c_str(),
-                      "IndexIntermediate"),
-                TLArg(xr::ToString(skeletalData.boneTransforms[XR_HAND_JOINT_INDEX_DISTAL_EXT]).c_str(), "IndexDistal"),
-                TLArg(xr::ToString(skeletalData.boneTransforms[XR_HAND_JOINT_INDEX_TIP_EXT]).c_str(), "IndexTip"),
-                TLArg(xr::ToString(skeletalData.boneTransforms[XR_HAND_JOINT_MIDDLE_METACARPAL_EXT]).c_str(),
-                      "MiddleMetacarpal"),
-                TLArg(xr::ToString(skeletalData.boneTransforms[XR_HAND_JOINT_MIDDLE_PROXIMAL_EXT]).c_str(),
-                      "MiddleProximal"),
-                TLArg(xr::ToString(skeletalData.boneTransforms[XR_HAND_JOINT_MIDDLE_INTERMEDIATE_EXT]).c_str(),
-                      "MiddleIntermediate"),
-                TLArg(xr::ToString(skeletalData.boneTransforms[XR_HAND_JOINT_MIDDLE_DISTAL_EXT]).c_str(),
-                      "MiddleDistal"),
-                TLArg(xr::ToString(skeletalData.boneTransforms[XR_HAND_JOINT_MIDDLE_TIP_EXT]).c_str(), "MiddleTip"),
-                TLArg(xr::ToString(skeletalData.boneTransforms[XR_HAND_JOINT_RING_METACARPAL_EXT]).c_str(),
-                      "RingMetacarpal"),
-                TLArg(xr::ToString(skeletalData.boneTransforms[XR_HAND_JOINT_RING_PROXIMAL_EXT]).c_str(),
-                      "RingProximal"),
-                TLArg(xr::ToString(skeletalData.boneTransforms[XR_HAND_JOINT_RING_INTERMEDIATE_EXT]).c_str(),
-                      "RingIntermediate"),
-                TLArg(xr::ToString(skeletalData.boneTransforms[XR_HAND_JOINT_RING_DISTAL_EXT]).c_str(), "RingDistal"),
-                TLArg(xr::ToString(skeletalData.boneTransforms[XR_HAND_JOINT_RING_TIP_EXT]).c_str(), "RingTip"),
-                TLArg(xr::ToString(skeletalData.boneTransforms[XR_HAND_JOINT_LITTLE_METACARPAL_EXT]).c_str(),
-                      "LittleMetacarpal"),
-                TLArg(xr::ToString(skeletalData.boneTransforms[XR_HAND_JOINT_LITTLE_PROXIMAL_EXT]).c_str(),
-                      "LittleProximal"),
-                TLArg(xr::ToString(skeletalData.boneTransforms[XR_HAND_JOINT_LITTLE_INTERMEDIATE_EXT]).c_str(),
-                      "LittleIntermediate"),
-                TLArg(xr::ToString(skeletalData.boneTransforms[XR_HAND_JOINT_LITTLE_DISTAL_EXT]).c_str(),
-                      "LittleDistal"),
-                TLArg(xr::ToString(skeletalData.boneTransforms[XR_HAND_JOINT_LITTLE_TIP_EXT]).c_str(), "LittleTip"));
-
-            locations->isActive = XR_TRUE;
-        }
-
         // If base space pose is not valid, we cannot locate.
         if (locations->isActive != XR_TRUE || !Pose::IsPoseValid(flags1) || !Pose::IsPoseValid(flags2)) {
             TraceLoggingWrite(g_traceProvider, "xrLocateHandJointsEXT", TLArg(0, "LocationFlags"));
@@ -248,41 +183,183 @@ namespace pimax_openxr {
             return XR_SUCCESS;
         }
 
+        // Transform all the joints at once, first to the virtual space, then to the base space.
+        const XrPosef handToVirtual = Pose::Multiply(m_controllerHandPose[xrHandTracker.side], basePose);
+        PoseArraySoA<XR_HAND_JOINT_COUNT_EXT> jointsInVirtual;
+        xrHandTracker.joints.transform(handToVirtual, jointsInVirtual);
+        PoseArraySoA<XR_HAND_JOINT_COUNT_EXT> jointsInBase;
+        jointsInVirtual.transform(Pose::Invert(baseSpaceToVirtual), jointsInBase);
+
+        for (uint32_t i = 0; i < locations->jointCount; i++) {
+            locations->jointLocations[i].radius = i != XR_HAND_JOINT_PALM_EXT ? 0.005f : 0.04f;
+            locations->jointLocations[i].pose = jointsInBase.get(i);
+            locations->jointLocations[i].locationFlags =
+                (XR_SPACE_LOCATION_ORIENTATION_VALID_BIT | XR_SPACE_LOCATION_ORIENTATION_TRACKED_BIT) | flags2;
+        }
+
+        // Keep the joints of the last two distinct times to differentiate them.
+        auto& history = xrHandTracker.history;
+        if (history[0].time != locateInfo->time) {
+            history[1] = history[0];
+            history[0].time = locateInfo->time;
+        }
+        history[0].joints = jointsInVirtual;
+
+        if (velocities) {
+            const double dt = (history[0].time - history[1].time) / 1e9;
+            const bool hasVelocities = history[1].time && dt > 0 && dt < 0.1;
+            const DirectX::XMVECTOR baseOrientation = LoadXrQuaternion(baseSpaceToVirtual.orientation);
+            for (uint32_t i = 0; i < velocities->jointCount; i++) {
+                auto& velocity = velocities->jointVelocities[i];
+                if (!hasVelocities) {
+                    velocity.angularVelocity = {};
+                    velocity.linearVelocity = {};
+                    velocity.velocityFlags = 0;
+                    continue;
+                }
+
+                const XrPosef current = history[0].joints.get(i);
+                const XrPosef previous = history[1].joints.get(i);
+
+                // Express the velocities along the axes of the base space.
+                const XrVector3f linearVelocity = (current.position - previous.position) / (float)dt;
+                StoreXrVector3(&velocity.linearVelocity,
+                               DirectX::XMVector3InverseRotate(LoadXrVector3(linearVelocity), baseOrientation));
+
+                DirectX::XMVECTOR axis;
+                float angle;
+                DirectX::XMQuaternionToAxisAngle(
+                    &axis,
+                    &angle,
+                    DirectX::XMQuaternionMultiply(
+                        DirectX::XMQuaternionInverse(LoadXrQuaternion(previous.orientation)),
+                        LoadXrQuaternion(current.orientation)));
+                if (angle > DirectX::XM_PI) {
+                    angle -= DirectX::XM_2PI;
+                }
+                velocity.angularVelocity = {};
+                if (std::abs(angle) > 1e-6f) {
+                    StoreXrVector3(&velocity.angularVelocity,
+                                   DirectX::XMVector3InverseRotate(
+                                       DirectX::XMVectorScale(DirectX::XMVector3Normalize(axis), angle / (float)dt),
+                                       baseOrientation));
+                }
+
+                velocity.velocityFlags = XR_SPACE_VELOCITY_LINEAR_VALID_BIT | XR_SPACE_VELOCITY_ANGULAR_VALID_BIT;
+            }
+        }
+
+        return XR_SUCCESS;
+    }
+
+    // Query the skeletal data and walk the bone hierarchy once, yielding the joints relative to the hand pose.
+    void OpenXrRuntime::updateHandJoints(HandTracker& xrHandTracker, pvrSkeletalMotionRange range) const {
+        pvrSkeletalData skeletalData{};
+        pvrResult result;
+        {
+            std::unique_lock pvrLock(m_pvrLock);
+            result = pvr_getSkeletalData(m_pvrSession,
+                                         xrHandTracker.side == 0 ? pvrTrackedDevice_LeftController
+                                                                 : pvrTrackedDevice_RightController,
+                                         range,
+                                         &skeletalData);
+        }
+        if (result == pvr_not_support || skeletalData.boneCount == 0) {
+            TraceLoggingWrite(g_traceProvider,
+                              "PVR_SkeletalData",
+                              TLArg(xrHandTracker.side == 0 ? "Left" : "Right", "Side"),
+                              TLArg(xr::ToString(result).c_str(), "Result"),
+                              TLArg(skeletalData.boneCount, "Count"));
+
+            // This is how we detect no hands presence.
+            xrHandTracker.isActive = false;
+            return;
+        }
+
+        CHECK_PVRCMD(result);
+
+        // We rely on PVR using the same definitions as SteamVR, which turn out to be share (almost) the same first
+        // 26 joints with the OpenXr definitions. https://github.com/ValveSoftware/openvr/wiki/Hand-Skeleton
+        TraceLoggingWrite(
+            g_traceProvider,
+            "PVR_SkeletalData",
+            TLArg(xrHandTracker.side == 0 ? "Left" : "Right", "Side"),
+            TLArg(skeletalData.boneCount, "Count"),
+            TLArg(xr::ToString(skeletalData.boneTransforms[0]).c_str(), "Root"),
+            TLArg(xr::ToString(skeletalData.boneTransforms[XR_HAND_JOINT_WRIST_EXT]).c_str(), "Wrist"),
+            TLArg(xr::ToString(skeletalData.boneTransforms[XR_HAND_JOINT_THUMB_METACARPAL_EXT]).c_str(),
+                  "ThumbMetacarpal"),
+            TLArg(xr::ToString(skeletalData.boneTransforms[XR_HAND_JOINT_THUMB_PROXIMAL_EXT]).c_str(),
+                  "ThumbProximal"),
+            TLArg(xr::ToString(skeletalData.boneTransforms[XR_HAND_JOINT_THUMB_DISTAL_EXT]).c_str(), "ThumbDistal"),
+            TLArg(xr::ToString(skeletalData.boneTransforms[XR_HAND_JOINT_THUMB_TIP_EXT]).c_str(), "ThumbTip"),
+            TLArg(xr::ToString(skeletalData.boneTransforms[XR_HAND_JOINT_INDEX_METACARPAL_EXT]).c_str(),
+                  "IndexMetacarpal"),
+            TLArg(xr::ToString(skeletalData.boneTransforms[XR_HAND_JOINT_INDEX_PROXIMAL_EXT]).c_str(),
+                  "IndexProximal"),
+            TLArg(xr::ToString(skeletalData.boneTransforms[XR_HAND_JOINT_INDEX_INTERMEDIATE_EXT]).c_str(),
+                  "IndexIntermediate"),
+            TLArg(xr::ToString(skeletalData.boneTransforms[XR_HAND_JOINT_INDEX_DISTAL_EXT]).c_str(), "IndexDistal"),
+            TLArg(xr::ToString(skeletalData.boneTransforms[XR_HAND_JOINT_INDEX_TIP_EXT]).c_str(), "IndexTip"),
+            TLArg(xr::ToString(skeletalData.boneTransforms[XR_HAND_JOINT_MIDDLE_METACARPAL_EXT]).c_str(),
+                  "MiddleMetacarpal"),
+            TLArg(xr::ToString(skeletalData.boneTransforms[XR_HAND_JOINT_MIDDLE_PROXIMAL_EXT]).c_str(),
+                  "MiddleProximal"),
+            TLArg(xr::ToString(skeletalData.boneTransforms[XR_HAND_JOINT_MIDDLE_INTERMEDIATE_EXT]).c_str(),
+                  "MiddleIntermediate"),
+            TLArg(xr::ToString(skeletalData.boneTransforms[XR_HAND_JOINT_MIDDLE_DISTAL_EXT]).c_str(),
+                  "MiddleDistal"),
+            TLArg(xr::ToString(skeletalData.boneTransforms[XR_HAND_JOINT_MIDDLE_TIP_EXT]).c_str(), "MiddleTip"),
+            TLArg(xr::ToString(skeletalData.boneTransforms[XR_HAND_JOINT_RING_METACARPAL_EXT]).c_str(),
+                  "RingMetacarpal"),
+            TLArg(xr::ToString(skeletalData.boneTransforms[XR_HAND_JOINT_RING_PROXIMAL_EXT]).c_str(),
+                  "RingProximal"),
+            TLArg(xr::ToString(skeletalData.boneTransforms[XR_HAND_JOINT_RING_INTERMEDIATE_EXT]).c_str(),
+                  "RingIntermediate"),
+            TLArg(xr::ToString(skeletalData.boneTransforms[XR_HAND_JOINT_RING_DISTAL_EXT]).c_str(), "RingDistal"),
+            TLArg(xr::ToString(skeletalData.boneTransforms[XR_HAND_JOINT_RING_TIP_EXT]).c_str(), "RingTip"),
+            TLArg(xr::ToString(skeletalData.boneTransforms[XR_HAND_JOINT_LITTLE_METACARPAL_EXT]).c_str(),
+                  "LittleMetacarpal"),
+            TLArg(xr::ToString(skeletalData.boneTransforms[XR_HAND_JOINT_LITTLE_PROXIMAL_EXT]).c_str(),
+                  "LittleProximal"),
+            TLArg(xr::ToString(skeletalData.boneTransforms[XR_HAND_JOINT_LITTLE_INTERMEDIATE_EXT]).c_str(),
+                  "LittleIntermediate"),
+            TLArg(xr::ToString(skeletalData.boneTransforms[XR_HAND_JOINT_LITTLE_DISTAL_EXT]).c_str(),
+                  "LittleDistal"),
+            TLArg(xr::ToString(skeletalData.boneTransforms[XR_HAND_JOINT_LITTLE_TIP_EXT]).c_str(), "LittleTip"));
+
+        xrHandTracker.isActive = true;
+
+        // We need extra rotations to convert from what SteamVR expects to what OpenXR expects.
+        const XrPosef wristCorrection = Pose::MakePose(
+            Quaternion::RotationRollPitchYaw({PVR::DegreeToRad(180.f),
+                                              PVR::DegreeToRad(0.f),
+                                              PVR::DegreeToRad(!xrHandTracker.side ? -90.f : 90.f)}),
+            XrVector3f{0, 0, 0});
+        const XrPosef jointCorrection = Pose::MakePose(
+            Quaternion::RotationRollPitchYaw({PVR::DegreeToRad(!xrHandTracker.side ? 0.f : 180.f),
+                                              PVR::DegreeToRad(-90.f),
+                                              PVR::DegreeToRad(180.f)}),
+            XrVector3f{0, 0, 0});
+
         // We must apply the transforms in order of the bone structure:
         // https://github.com/ValveSoftware/openvr/wiki/Hand-Skeleton#bone-structure
         XrVector3f barycenter{};
-        XrPosef accumulatedPose = Pose::Multiply(m_controllerHandPose[xrHandTracker.side], basePose);
-        XrPosef wristPose;
-        for (uint32_t i = 0; i < locations->jointCount; i++) {
+        XrPosef accumulatedPose = Pose::Identity();
+        XrPosef wristPose = Pose::Identity();
+        XrQuaternionf middleMetacarpalOrientation = Quaternion::Identity();
+        for (uint32_t i = 0; i < XR_HAND_JOINT_COUNT_EXT; i++) {
             accumulatedPose = Pose::Multiply(pvrPoseToXrPose(skeletalData.boneTransforms[i]), accumulatedPose);
 
             // Palm is estimated after this loop.
             if (i != XR_HAND_JOINT_PALM_EXT) {
-                locations->jointLocations[i].radius = 0.005f;
-
-                // We need extra rotations to convert from what SteamVR expects to what OpenXR expects.
-                XrPosef correctedPose;
-                if (i != XR_HAND_JOINT_WRIST_EXT) {
-                    correctedPose =
-                        Pose::Multiply(Pose::MakePose(Quaternion::RotationRollPitchYaw(
-                                                          {PVR::DegreeToRad(!xrHandTracker.side ? 0.f : 180.f),
-                                                           PVR::DegreeToRad(-90.f),
-                                                           PVR::DegreeToRad(180.f)}),
-                                                      XrVector3f{0, 0, 0}),
-                                       accumulatedPose);
-                } else {
-                    correctedPose =
-                        Pose::Multiply(Pose::MakePose(Quaternion::RotationRollPitchYaw(
-                                                          {PVR::DegreeToRad(180.f),
-                                                           PVR::DegreeToRad(0.f),
-                                                           PVR::DegreeToRad(!xrHandTracker.side ? -90.f : 90.f)}),
-                                                      XrVector3f{0, 0, 0}),
-                                       accumulatedPose);
+                const XrPosef correctedPose = Pose::Multiply(
+                    i != XR_HAND_JOINT_WRIST_EXT ? jointCorrection : wristCorrection, accumulatedPose);
+                xrHandTracker.joints.set(i, correctedPose);
+                if (i == XR_HAND_JOINT_MIDDLE_METACARPAL_EXT) {
+                    middleMetacarpalOrientation = correctedPose.orientation;
                 }
-                locations->jointLocations[i].pose = Pose::Multiply(correctedPose, Pose::Invert(baseSpaceToVirtual));
             }
-            locations->jointLocations[i].locationFlags =
-                (XR_SPACE_LOCATION_ORIENTATION_VALID_BIT | XR_SPACE_LOCATION_ORIENTATION_TRACKED_BIT) | flags2;
 
             switch (i) {
             case XR_HAND_JOINT_WRIST_EXT:
@@ -309,23 +386,12 @@ namespace pimax_openxr {
                 accumulatedPose = wristPose;
                 break;
             }
-
-            if (velocities) {
-                velocities->jointVelocities[i].angularVelocity = {};
-                velocities->jointVelocities[i].linearVelocity = {};
-                velocities->jointVelocities[i].velocityFlags = 0;
-            }
         }
 
         // SteamVR doesn't have palm, we compute the barycenter of the metacarpal and proximal for
         // index/middle/ring/little fingers.
         barycenter = barycenter / 8.0f;
-        locations->jointLocations[XR_HAND_JOINT_PALM_EXT].radius = 0.04f;
-        locations->jointLocations[XR_HAND_JOINT_PALM_EXT].pose = Pose::Multiply(
-            Pose::MakePose(locations->jointLocations[XR_HAND_JOINT_MIDDLE_METACARPAL_EXT].pose.orientation, barycenter),
-            Pose::Invert(baseSpaceToVirtual));
-
-        return XR_SUCCESS;
+        xrHandTracker.joints.set(XR_HAND_JOINT_PALM_EXT, Pose::MakePose(middleMetacarpalOrientation, barycenter));
     }
 
 } // namespace pimax_openxr
\ No newline at end of file
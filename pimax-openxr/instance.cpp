@@ -22,7 +22,9 @@
 
 #include "pch.h"
 
+#include "framework/dispatch.h"
 #include "log.h"
+#include "perf_stats.h"
 #include "runtime.h"
 #include "store.h"
 #include "utils.h"
@@ -131,9 +133,14 @@ namespace pimax_openxr {
     // CONFORMANCE: We do not handle multithreading properly. TODO: All functions must be thread-safe.
 
     OpenXrRuntime::OpenXrRuntime() {
+        StartLogWorker();
+
         if (getSetting("enable_telemetry").value_or(0)) {
             m_telemetry.initialize();
         }
+        if (getSetting("perf_stats").value_or(1)) {
+            stats::InitializeStats(g_apiNames, g_apiCount);
+        }
 
         const auto runtimeVersion =
             xr::ToString(XR_MAKE_VERSION(RuntimeVersionMajor, RuntimeVersionMinor, RuntimeVersionPatch));
@@ -181,18 +188,12 @@ namespace pimax_openxr {
 
         QueryPerformanceFrequency(&m_qpcFrequency);
 
-        // Calibrate the timestamp conversion.
-        m_pvrTimeFromQpcTimeOffset = INFINITY;
-        for (int i = 0; i < 100; i++) {
-            LARGE_INTEGER now;
-            QueryPerformanceCounter(&now);
-            const double qpcTime = (double)now.QuadPart / m_qpcFrequency.QuadPart;
-            m_pvrTimeFromQpcTimeOffset = std::min(m_pvrTimeFromQpcTimeOffset, pvr_getTimeSeconds(m_pvr) - qpcTime);
-        }
-        TraceLoggingWrite(
-            g_traceProvider, "ConvertTime", TLArg(m_pvrTimeFromQpcTimeOffset, "PvrTimeFromQpcTimeOffset"));
+        // Calibrate the timestamp conversion, and keep it up-to-date.
+        calibrateTimeConversion();
+        startTimeCalibrationThread();
 
-        // Watch for changes in the registry.
+        // Take the initial settings snapshot, then watch for changes in the registry.
+        refreshSettings();
         try {
             m_registryWatcher =
                 wil::make_registry_watcher(HKEY_LOCAL_MACHINE,
@@ -209,8 +210,7 @@ namespace pimax_openxr {
 
     OpenXrRuntime::~OpenXrRuntime() {
         // Destroy actionset and actions (tied to the instance).
-        for (auto action : m_actionsForCleanup) {
-            Action* xrAction = (Action*)action;
+        for (Action* xrAction : m_actionsForCleanup) {
             delete xrAction;
         }
         while (m_actionSets.size()) {
@@ -228,12 +228,15 @@ namespace pimax_openxr {
 
             pvr_destroySession(m_pvrSession);
         }
+        stopTimeCalibrationThread();
         pvr_shutdown(m_pvr);
 
         if (m_useFrameTimingOverride) {
             DetourDllDetach(
                 "kernel32.dll", "VerifyVersionInfoW", hooked_VerifyVersionInfoW, g_original_VerifyVersionInfoW);
         }
+
+        StopLogWorker();
     }
 
     // https://www.khronos.org/registry/OpenXR/specs/1.0/html/xrspec.html#xrGetInstanceProcAddr
@@ -345,6 +348,11 @@ namespace pimax_openxr {
         // part of xrGetSystem().
         m_useParallelProjection = !pvr_getIntConfig(m_pvrSession, "steamvr_use_native_fov", 0);
 
+        // Intern the hand paths upfront, so the action state queries can resolve subaction paths without strings.
+        CHECK_XRCMD(xrStringToPath(XR_NULL_HANDLE, "/user/hand/left", &m_handPaths[0]));
+        CHECK_XRCMD(xrStringToPath(XR_NULL_HANDLE, "/user/hand/right", &m_handPaths[1]));
+        CHECK_XRCMD(xrStringToPath(XR_NULL_HANDLE, "/user/eyes_ext", &m_eyesPath));
+
         m_instanceCreated = true;
         *instance = (XrInstance)1;
 
@@ -440,6 +448,51 @@ namespace pimax_openxr {
             return XR_SUCCESS;
         }
 
+        {
+            std::unique_lock lock(m_refreshRateChangedEventsLock);
+            if (m_sessionCreated && !m_refreshRateChangedEvents.empty()) {
+                XrEventDataDisplayRefreshRateChangedFB* const buffer =
+                    reinterpret_cast<XrEventDataDisplayRefreshRateChangedFB*>(eventData);
+                buffer->type = XR_TYPE_EVENT_DATA_DISPLAY_REFRESH_RATE_CHANGED_FB;
+                buffer->next = nullptr;
+                buffer->fromDisplayRefreshRate = m_refreshRateChangedEvents.front().first;
+                buffer->toDisplayRefreshRate = m_refreshRateChangedEvents.front().second;
+                m_refreshRateChangedEvents.pop_front();
+
+                TraceLoggingWrite(g_traceProvider,
+                                  "xrPollEvent",
+                                  TLArg("DisplayRefreshRateChanged", "Type"),
+                                  TLArg(buffer->fromDisplayRefreshRate, "FromDisplayRefreshRate"),
+                                  TLArg(buffer->toDisplayRefreshRate, "ToDisplayRefreshRate"));
+
+                return XR_SUCCESS;
+            }
+        }
+
+        {
+            std::unique_lock lock(m_visibilityMaskLock);
+            if (m_sessionCreated && m_visibilityMaskChangedViews) {
+                const uint32_t viewIndex = (m_visibilityMaskChangedViews & 1) ? 0 : 1;
+                m_visibilityMaskChangedViews &= ~(1u << viewIndex);
+
+                XrEventDataVisibilityMaskChangedKHR* const buffer =
+                    reinterpret_cast<XrEventDataVisibilityMaskChangedKHR*>(eventData);
+                buffer->type = XR_TYPE_EVENT_DATA_VISIBILITY_MASK_CHANGED_KHR;
+                buffer->next = nullptr;
+                buffer->session = (XrSession)1;
+                buffer->viewConfigurationType = m_primaryViewConfigurationType;
+                buffer->viewIndex = viewIndex;
+
+                TraceLoggingWrite(g_traceProvider,
+                                  "xrPollEvent",
+                                  TLArg("VisibilityMaskChanged", "Type"),
+                                  TLXArg(buffer->session, "Session"),
+                                  TLArg(buffer->viewIndex, "ViewIndex"));
+
+                return XR_SUCCESS;
+            }
+        }
+
         return XR_EVENT_UNAVAILABLE;
     }
 
@@ -521,6 +574,20 @@ namespace pimax_openxr {
         m_extensionsTable.push_back( // Hand tracking.
             {XR_EXT_HAND_JOINTS_MOTION_RANGE_EXTENSION_NAME, XR_EXT_hand_joints_motion_range_SPEC_VERSION});
 
+        m_extensionsTable.push_back( // Batched space location.
+            {XR_KHR_LOCATE_SPACES_EXTENSION_NAME, XR_KHR_locate_spaces_SPEC_VERSION});
+
+        m_extensionsTable.push_back( // Foveated rendering.
+            {XR_VARJO_QUAD_VIEWS_EXTENSION_NAME, XR_VARJO_quad_views_SPEC_VERSION});
+        m_extensionsTable.push_back( // Foveated rendering.
+            {XR_EXT_EYE_GAZE_INTERACTION_EXTENSION_NAME, XR_EXT_eye_gaze_interaction_SPEC_VERSION});
+
+        m_extensionsTable.push_back( // Dynamic resolution.
+            {XR_META_RECOMMENDED_LAYER_RESOLUTION_EXTENSION_NAME, XR_META_recommended_layer_resolution_SPEC_VERSION});
+
+        m_extensionsTable.push_back( // Application space warp.
+            {XR_FB_SPACE_WARP_EXTENSION_NAME, XR_FB_space_warp_SPEC_VERSION});
+
         // FIXME: Add new extensions here.
     }
 
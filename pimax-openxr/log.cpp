@@ -27,6 +27,32 @@
 namespace {
     constexpr uint32_t k_maxLoggedErrors = 100;
     uint32_t g_globalErrorCount = 0;
+
+    // Messages are queued into a preallocated ring buffer, and written to the file by a background thread.
+    constexpr uint64_t k_logRingSize = 256;
+    constexpr size_t k_maxMessageLength = 1024;
+    constexpr DWORD k_logFlushIntervalMs = 250;
+
+    struct LogEntry {
+        // Equals the position of the entry when free, and the position + 1 when ready to be written.
+        std::atomic<uint64_t> sequence;
+        std::time_t time;
+        char message[k_maxMessageLength];
+    };
+    LogEntry g_logRing[k_logRingSize];
+    std::atomic<uint64_t> g_logHead{0};
+    std::atomic<uint32_t> g_droppedMessages{0};
+
+    // The consumer side is guarded by the lock, and owned by the worker thread while it runs.
+    std::mutex g_logConsumerLock;
+    uint64_t g_logTail = 0;
+    bool g_isLogRingInitialized = false;
+
+    std::atomic<bool> g_isLogWorkerRunning{false};
+    std::atomic<bool> g_stopLogWorker{false};
+    std::thread g_logWorker;
+    wil::unique_handle g_logWorkerWakeEvent;
+
 } // namespace
 
 namespace pimax_openxr::log {
@@ -41,18 +67,90 @@ namespace pimax_openxr::log {
 
     namespace {
 
-        // Utility logging function.
-        void InternalLog(const char* fmt, va_list va, bool logTelemetry = false) {
-            const std::time_t now = std::time(nullptr);
-
-            char buf[1024];
-            size_t offset = std::strftime(buf, sizeof(buf), "%Y-%m-%d %H:%M:%S %z: ", std::localtime(&now));
-            vsnprintf_s(buf + offset, sizeof(buf) - offset, _TRUNCATE, fmt, va);
-            OutputDebugStringA(buf);
+        // Must be called with g_logConsumerLock held.
+        void WriteLogLine(std::time_t time, const char* message) {
+            char buf[k_maxMessageLength + 64];
+            size_t offset = std::strftime(buf, sizeof(buf), "%Y-%m-%d %H:%M:%S %z: ", std::localtime(&time));
+            strncpy_s(buf + offset, sizeof(buf) - offset, message, _TRUNCATE);
+            if (IsDebuggerPresent()) {
+                OutputDebugStringA(buf);
+            }
             if (logStream.is_open()) {
                 logStream << buf;
+            }
+        }
+
+        // Write out all the queued messages. Must be called with g_logConsumerLock held.
+        void DrainLogRing() {
+            bool hasWritten = false;
+            while (true) {
+                LogEntry& entry = g_logRing[g_logTail % k_logRingSize];
+                if (entry.sequence.load(std::memory_order_acquire) != g_logTail + 1) {
+                    break;
+                }
+
+                WriteLogLine(entry.time, entry.message);
+                entry.sequence.store(g_logTail + k_logRingSize, std::memory_order_release);
+                g_logTail++;
+                hasWritten = true;
+            }
+
+            if (const auto dropped = g_droppedMessages.exchange(0)) {
+                const auto message = fmt::format("{} messages were dropped\n", dropped);
+                WriteLogLine(std::time(nullptr), message.c_str());
+                hasWritten = true;
+            }
+
+            if (hasWritten && logStream.is_open()) {
                 logStream.flush();
             }
+        }
+
+        // Queue a message for the worker thread. Returns false if the ring buffer is full.
+        bool EnqueueLog(const char* message) {
+            uint64_t position = g_logHead.load(std::memory_order_relaxed);
+            LogEntry* entry;
+            while (true) {
+                entry = &g_logRing[position % k_logRingSize];
+                const uint64_t sequence = entry->sequence.load(std::memory_order_acquire);
+                if (sequence == position) {
+                    if (g_logHead.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                        break;
+                    }
+                } else if (sequence < position) {
+                    return false;
+                } else {
+                    position = g_logHead.load(std::memory_order_relaxed);
+                }
+            }
+
+            entry->time = std::time(nullptr);
+            strncpy_s(entry->message, message, _TRUNCATE);
+            entry->sequence.store(position + 1, std::memory_order_release);
+            return true;
+        }
+
+        // Utility logging function.
+        void InternalLog(const char* fmt, va_list va, bool logTelemetry = false) {
+            char buf[k_maxMessageLength];
+            vsnprintf_s(buf, sizeof(buf), _TRUNCATE, fmt, va);
+
+            if (g_isLogWorkerRunning) {
+                if (!EnqueueLog(buf)) {
+                    g_droppedMessages++;
+                }
+                // Errors are written out promptly, in case they precede a crash.
+                if (logTelemetry) {
+                    SetEvent(g_logWorkerWakeEvent.get());
+                }
+            } else {
+                std::unique_lock lock(g_logConsumerLock);
+                DrainLogRing();
+                WriteLogLine(std::time(nullptr), buf);
+                if (logStream.is_open()) {
+                    logStream.flush();
+                }
+            }
 
             if (logTelemetry) {
                 if (auto telemetry = pimax_openxr::GetTelemetry()) {
@@ -60,8 +158,74 @@ namespace pimax_openxr::log {
                 }
             }
         }
+
+        // Write out the messages when the process exits without stopping the worker. The worker thread may have been
+        // terminated while holding the lock.
+        void FlushLogAtExit() {
+            std::unique_lock lock(g_logConsumerLock, std::try_to_lock);
+            if (lock.owns_lock()) {
+                DrainLogRing();
+            }
+        }
+
     } // namespace
 
+    void StartLogWorker() {
+        if (g_isLogWorkerRunning) {
+            return;
+        }
+
+        {
+            std::unique_lock lock(g_logConsumerLock);
+            if (!g_isLogRingInitialized) {
+                for (uint64_t i = 0; i < k_logRingSize; i++) {
+                    g_logRing[i].sequence = i;
+                }
+                g_isLogRingInitialized = true;
+
+                // Registered after the file logger is constructed, so it runs before the file is closed.
+                std::atexit(FlushLogAtExit);
+            }
+        }
+
+        *g_logWorkerWakeEvent.put() = CreateEventEx(nullptr, nullptr, 0, EVENT_MODIFY_STATE | SYNCHRONIZE);
+        if (!g_logWorkerWakeEvent) {
+            return;
+        }
+
+        g_stopLogWorker = false;
+        g_logWorker = std::thread([]() {
+            // Flushing is batched on a timer, or happens sooner upon errors.
+            while (!g_stopLogWorker) {
+                WaitForSingleObject(g_logWorkerWakeEvent.get(), k_logFlushIntervalMs);
+
+                std::unique_lock lock(g_logConsumerLock);
+                DrainLogRing();
+            }
+        });
+        g_isLogWorkerRunning = true;
+    }
+
+    void StopLogWorker() {
+        if (!g_isLogWorkerRunning) {
+            return;
+        }
+
+        // Subsequent messages are written synchronously, after any remaining queued message.
+        g_isLogWorkerRunning = false;
+        g_stopLogWorker = true;
+        SetEvent(g_logWorkerWakeEvent.get());
+        g_logWorker.join();
+        g_logWorkerWakeEvent.reset();
+
+        FlushLog();
+    }
+
+    void FlushLog() {
+        std::unique_lock lock(g_logConsumerLock);
+        DrainLogRing();
+    }
+
     void Log(const char* fmt, ...) {
         va_list va;
         va_start(va, fmt);
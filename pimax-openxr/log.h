@@ -52,4 +52,12 @@ namespace pimax_openxr::log {
     // Error logging function. Goes silent after too many errors.
     void ErrorLog(const char* fmt, ...);
 
+    // Start and stop the background thread writing the log file. Messages are written synchronously when it is not
+    // running.
+    void StartLogWorker();
+    void StopLogWorker();
+
+    // Write out all the queued messages.
+    void FlushLog();
+
 } // namespace pimax_openxr::log
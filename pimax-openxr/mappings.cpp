@@ -27,126 +27,412 @@
 #include "utils.h"
 
 namespace {
-    std::string rreplace(const std::string& str, const std::string& from, const std::string& to) {
-        std::string copy(str);
-        const size_t start_pos = str.rfind(from);
-        copy.replace(start_pos, from.length(), to);
+    // The component paths of the controllers we support, relative to their top-level /user/hand/<side> path.
+    enum class Component : uint8_t {
+        SystemClick,
+        System,
+        SystemTouch,
+        MenuClick,
+        Menu,
+        SelectClick,
+        Select,
+        AClick,
+        A,
+        ATouch,
+        BClick,
+        B,
+        BTouch,
+        XClick,
+        X,
+        YClick,
+        Y,
+        SqueezeClick,
+        SqueezeValue,
+        SqueezeForce,
+        Squeeze,
+        TriggerClick,
+        TriggerValue,
+        TriggerTouch,
+        Trigger,
+        Thumbstick,
+        ThumbstickX,
+        ThumbstickY,
+        ThumbstickClick,
+        ThumbstickTouch,
+        Trackpad,
+        TrackpadX,
+        TrackpadY,
+        TrackpadClick,
+        TrackpadForce,
+        TrackpadTouch,
+        GripPose,
+        AimPose,
+        Haptic,
+
+        Count
+    };
+
+    // Must be in the same order as the enum above.
+    constexpr std::string_view ComponentPaths[] = {
+        "/input/system/click",     "/input/system",          "/input/system/touch",    "/input/menu/click",
+        "/input/menu",             "/input/select/click",    "/input/select",          "/input/a/click",
+        "/input/a",                "/input/a/touch",         "/input/b/click",         "/input/b",
+        "/input/b/touch",          "/input/x/click",         "/input/x",               "/input/y/click",
+        "/input/y",                "/input/squeeze/click",   "/input/squeeze/value",   "/input/squeeze/force",
+        "/input/squeeze",          "/input/trigger/click",   "/input/trigger/value",   "/input/trigger/touch",
+        "/input/trigger",          "/input/thumbstick",      "/input/thumbstick/x",    "/input/thumbstick/y",
+        "/input/thumbstick/click", "/input/thumbstick/touch", "/input/trackpad",       "/input/trackpad/x",
+        "/input/trackpad/y",       "/input/trackpad/click",  "/input/trackpad/force",  "/input/trackpad/touch",
+        "/input/grip/pose",        "/input/aim/pose",        "/output/haptic",
+    };
+    static_assert(std::size(ComponentPaths) == (size_t)Component::Count);
+
+    // A perfect hash of the component paths (FNV-1a, keeping the upper bits). The seed was picked so that no two
+    // paths above share a slot. When adding paths, the static_assert below tells whether a new seed is needed.
+    constexpr uint32_t ComponentHashSeed = 2166136261u ^ 4938u;
+    constexpr size_t ComponentHashSlots = 128;
+
+    constexpr size_t getComponentHashSlot(std::string_view path) {
+        uint32_t hash = ComponentHashSeed;
+        for (const char c : path) {
+            hash ^= (uint8_t)c;
+            hash *= 16777619u;
+        }
+        return hash >> 25;
+    }
 
-        return copy;
+    constexpr auto ComponentHashTable = [] {
+        std::array<uint8_t, ComponentHashSlots> table{};
+        for (auto& slot : table) {
+            slot = (uint8_t)Component::Count;
+        }
+        for (size_t i = 0; i < std::size(ComponentPaths); i++) {
+            table[getComponentHashSlot(ComponentPaths[i])] = (uint8_t)i;
+        }
+        return table;
+    }();
+
+    constexpr bool isComponentHashPerfect() {
+        for (size_t i = 0; i < std::size(ComponentPaths); i++) {
+            if (ComponentHashTable[getComponentHashSlot(ComponentPaths[i])] != i) {
+                return false;
+            }
+        }
+        return true;
     }
-} // namespace
+    static_assert(isComponentHashPerfect(), "Component paths collide, ComponentHashSeed must be changed");
 
-namespace pimax_openxr {
+    std::optional<Component> findComponent(std::string_view path) {
+        const auto index = ComponentHashTable[getComponentHashSlot(path)];
+        if (index == (uint8_t)Component::Count || ComponentPaths[index] != path) {
+            return {};
+        }
+        return (Component)index;
+    }
 
-    using namespace pimax_openxr::log;
-    using namespace pimax_openxr::utils;
+    // Remapping of a component from the interaction profile of the application to the one of the physical
+    // controller. The remapping can be restricted to one hand.
+    struct ComponentRemap {
+        Component from;
+        Component to;
+        int side{-1};
+    };
 
-    void OpenXrRuntime::initializeRemappingTables() {
+    constexpr ComponentRemap same(Component component) {
+        return {component, component};
+    }
+
+    constexpr ComponentRemap SimpleControllerToViveController[] = {
+        {Component::SelectClick, Component::TriggerClick},
+        {Component::Select, Component::Trigger},
+        same(Component::MenuClick),
+        same(Component::Menu),
+        same(Component::GripPose),
+        same(Component::AimPose),
+        same(Component::Haptic),
+    };
+
+    constexpr ComponentRemap OculusTouchControllerToViveController[] = {
+        {Component::Thumbstick, Component::Trackpad},
+        {Component::ThumbstickX, Component::TrackpadX},
+        {Component::ThumbstickY, Component::TrackpadY},
+        {Component::ThumbstickClick, Component::TrackpadClick},
+        {Component::ThumbstickTouch, Component::TrackpadTouch},
+        {Component::SqueezeValue, Component::SqueezeClick},
+        {Component::SqueezeForce, Component::SqueezeClick},
+        {Component::AClick, Component::MenuClick, 1},
+        {Component::A, Component::MenuClick, 1},
+        same(Component::SystemClick),
+        same(Component::System),
+        same(Component::MenuClick),
+        same(Component::Menu),
+        same(Component::SqueezeClick),
+        same(Component::Squeeze),
+        same(Component::TriggerClick),
+        same(Component::TriggerValue),
+        same(Component::Trigger),
+        same(Component::GripPose),
+        same(Component::AimPose),
+        same(Component::Haptic),
+    };
+
+    constexpr ComponentRemap MicrosoftMotionControllerToViveController[] = {
+        {Component::SqueezeValue, Component::SqueezeClick},
+        {Component::SqueezeForce, Component::SqueezeClick},
+        same(Component::MenuClick),
+        same(Component::Menu),
+        same(Component::SqueezeClick),
+        same(Component::Squeeze),
+        same(Component::TriggerClick),
+        same(Component::TriggerValue),
+        same(Component::Trigger),
+        same(Component::Trackpad),
+        same(Component::TrackpadX),
+        same(Component::TrackpadY),
+        same(Component::TrackpadClick),
+        same(Component::TrackpadForce),
+        same(Component::TrackpadTouch),
+        same(Component::GripPose),
+        same(Component::AimPose),
+        same(Component::Haptic),
+    };
+
+    constexpr ComponentRemap SimpleControllerToIndexController[] = {
+        {Component::SelectClick, Component::TriggerClick},
+        {Component::Select, Component::Trigger},
+        {Component::MenuClick, Component::AClick},
+        {Component::Menu, Component::A},
+        same(Component::GripPose),
+        same(Component::AimPose),
+        same(Component::Haptic),
+    };
+
+    constexpr ComponentRemap OculusTouchControllerToIndexController[] = {
+        {Component::XClick, Component::AClick},
+        {Component::X, Component::A},
+        {Component::YClick, Component::BClick},
+        {Component::Y, Component::B},
+        same(Component::SystemClick),
+        same(Component::System),
+        same(Component::MenuClick),
+        same(Component::Menu),
+        same(Component::AClick),
+        same(Component::A),
+        same(Component::BClick),
+        same(Component::B),
+        same(Component::SqueezeClick),
+        same(Component::SqueezeValue),
+        same(Component::SqueezeForce),
+        same(Component::Squeeze),
+        same(Component::TriggerClick),
+        same(Component::TriggerValue),
+        same(Component::Trigger),
+        same(Component::Thumbstick),
+        same(Component::ThumbstickX),
+        same(Component::ThumbstickY),
+        same(Component::ThumbstickClick),
+        same(Component::ThumbstickTouch),
+        same(Component::GripPose),
+        same(Component::AimPose),
+        same(Component::Haptic),
+    };
+
+    constexpr ComponentRemap MicrosoftMotionControllerToIndexController[] = {
+        same(Component::SqueezeClick),
+        same(Component::SqueezeValue),
+        same(Component::SqueezeForce),
+        same(Component::Squeeze),
+        same(Component::TriggerClick),
+        same(Component::TriggerValue),
+        same(Component::Trigger),
+        same(Component::Trackpad),
+        same(Component::TrackpadX),
+        same(Component::TrackpadY),
+        same(Component::TrackpadClick),
+        same(Component::TrackpadForce),
+        same(Component::TrackpadTouch),
+        same(Component::Thumbstick),
+        same(Component::ThumbstickX),
+        same(Component::ThumbstickY),
+        same(Component::ThumbstickClick),
+        same(Component::ThumbstickTouch),
+        same(Component::GripPose),
+        same(Component::AimPose),
+        same(Component::Haptic),
+    };
+
+    // Same for Oculus Touch and Microsoft Motion controllers.
+    constexpr ComponentRemap MotionControllerToSimpleController[] = {
+        {Component::TriggerClick, Component::SelectClick},
+        {Component::Trigger, Component::Select},
+        {Component::TriggerValue, Component::SelectClick},
+        same(Component::MenuClick),
+        same(Component::Menu),
+        same(Component::GripPose),
+        same(Component::AimPose),
+        same(Component::Haptic),
+    };
+
+    // Where a component of a physical controller is read from in the PVR input state. Poses and haptics have no
+    // input state. A binding can be restricted to one action type.
+    enum class InputField : uint8_t {
+        None,
+        Buttons,
+        Touches,
+        Trigger,
+        Grip,
+        GripForce,
+        TouchPadForce,
+        JoyStick,
+        TouchPad,
+    };
+
+    struct InputBinding {
+        Component component;
+        InputField field;
+        pvrButton button{};
+        int vector2fIndex{-1};
+        XrActionType actionType{XR_ACTION_TYPE_MAX_ENUM};
+    };
+
+    constexpr InputBinding ViveControllerBindings[] = {
+        {Component::SystemClick, InputField::Buttons, pvrButton_System},
+        {Component::System, InputField::Buttons, pvrButton_System},
+        {Component::SqueezeClick, InputField::Buttons, pvrButton_Grip},
+        {Component::SqueezeForce, InputField::Buttons, pvrButton_Grip},
+        {Component::Squeeze, InputField::Buttons, pvrButton_Grip},
+        {Component::MenuClick, InputField::Buttons, pvrButton_ApplicationMenu},
+        {Component::Menu, InputField::Buttons, pvrButton_ApplicationMenu},
+        {Component::TriggerClick, InputField::Buttons, pvrButton_Trigger},
+        {Component::Trigger, InputField::Buttons, pvrButton_Trigger, -1, XR_ACTION_TYPE_BOOLEAN_INPUT},
+        {Component::TriggerValue, InputField::Trigger},
+        {Component::Trigger, InputField::Trigger, {}, -1, XR_ACTION_TYPE_FLOAT_INPUT},
+        {Component::Trackpad, InputField::TouchPad, {}, -1},
+        {Component::TrackpadX, InputField::TouchPad, {}, 0},
+        {Component::TrackpadY, InputField::TouchPad, {}, 1},
+        {Component::TrackpadClick, InputField::Buttons, pvrButton_TouchPad},
+        {Component::TrackpadForce, InputField::Buttons, pvrButton_TouchPad},
+        {Component::TrackpadTouch, InputField::Touches, pvrButton_TouchPad},
+        {Component::GripPose, InputField::None},
+        {Component::AimPose, InputField::None},
+        {Component::Haptic, InputField::None},
+    };
+
+    constexpr InputBinding IndexControllerBindings[] = {
+        {Component::SystemClick, InputField::Buttons, pvrButton_System},
+        {Component::System, InputField::Buttons, pvrButton_System},
+        {Component::SystemTouch, InputField::Touches, pvrButton_System},
+        {Component::AClick, InputField::Buttons, pvrButton_A},
+        {Component::A, InputField::Buttons, pvrButton_A},
+        {Component::ATouch, InputField::Touches, pvrButton_A},
+        {Component::BClick, InputField::Buttons, pvrButton_B},
+        {Component::B, InputField::Buttons, pvrButton_B},
+        {Component::BTouch, InputField::Touches, pvrButton_B},
+        {Component::SqueezeValue, InputField::Grip},
+        {Component::Squeeze, InputField::Grip},
+        {Component::SqueezeForce, InputField::GripForce},
+        {Component::TriggerClick, InputField::Buttons, pvrButton_Trigger},
+        {Component::Trigger, InputField::Buttons, pvrButton_Trigger, -1, XR_ACTION_TYPE_BOOLEAN_INPUT},
+        {Component::TriggerValue, InputField::Trigger},
+        {Component::Trigger, InputField::Trigger, {}, -1, XR_ACTION_TYPE_FLOAT_INPUT},
+        {Component::TriggerTouch, InputField::Touches, pvrButton_Trigger},
+        {Component::Thumbstick, InputField::JoyStick, {}, -1},
+        {Component::ThumbstickX, InputField::JoyStick, {}, 0},
+        {Component::ThumbstickY, InputField::JoyStick, {}, 1},
+        {Component::ThumbstickClick, InputField::Buttons, pvrButton_JoyStick},
+        {Component::ThumbstickTouch, InputField::Touches, pvrButton_JoyStick},
+        {Component::Trackpad, InputField::TouchPad, {}, -1},
+        {Component::TrackpadX, InputField::TouchPad, {}, 0},
+        {Component::TrackpadY, InputField::TouchPad, {}, 1},
+        {Component::TrackpadForce, InputField::TouchPadForce},
+        {Component::TrackpadTouch, InputField::Touches, pvrButton_TouchPad},
+        {Component::GripPose, InputField::None},
+        {Component::AimPose, InputField::None},
+        {Component::Haptic, InputField::None},
+    };
+
+    constexpr InputBinding SimpleControllerBindings[] = {
+        {Component::SelectClick, InputField::Buttons, pvrButton_Trigger},
+        {Component::Select, InputField::Buttons, pvrButton_Trigger},
+        {Component::MenuClick, InputField::Buttons, pvrButton_ApplicationMenu},
+        {Component::Menu, InputField::Buttons, pvrButton_ApplicationMenu},
+        {Component::GripPose, InputField::None},
+        {Component::AimPose, InputField::None},
+        {Component::Haptic, InputField::None},
+    };
+
+    template <typename T, size_t N>
+    constexpr std::pair<const T*, size_t> table(const T (&entries)[N]) {
+        return {entries, N};
+    }
+
+    // The mapping from the interaction profile used by the application to the physical controller.
+    struct ControllerMapping {
+        std::string_view actualProfile;
+        std::string_view preferredProfile;
+        std::pair<const InputBinding*, size_t> bindings;
+        // No remapping means 1:1.
+        std::pair<const ComponentRemap*, size_t> remaps{nullptr, 0};
+    };
+
+    constexpr std::string_view ViveControllerProfile = "/interaction_profiles/htc/vive_controller";
+    constexpr std::string_view IndexControllerProfile = "/interaction_profiles/valve/index_controller";
+    constexpr std::string_view SimpleControllerProfile = "/interaction_profiles/khr/simple_controller";
+    constexpr std::string_view OculusTouchControllerProfile = "/interaction_profiles/oculus/touch_controller";
+    constexpr std::string_view MicrosoftMotionControllerProfile = "/interaction_profiles/microsoft/motion_controller";
+
+    constexpr ControllerMapping ControllerMappings[] = {
         // 1:1 mappings.
-        m_controllerMappingTable.insert_or_assign(
-            std::make_pair("/interaction_profiles/htc/vive_controller", "/interaction_profiles/htc/vive_controller"),
-            [&](const Action& xrAction, XrPath binding, ActionSource& source) {
-                return mapPathToViveControllerInputState(xrAction, getXrPath(binding), source);
-            });
-        m_controllerMappingTable.insert_or_assign(std::make_pair("/interaction_profiles/valve/index_controller",
-                                                                 "/interaction_profiles/valve/index_controller"),
-                                                  [&](const Action& xrAction, XrPath binding, ActionSource& source) {
-                                                      return mapPathToIndexControllerInputState(
-                                                          xrAction, getXrPath(binding), source);
-                                                  });
-        m_controllerMappingTable.insert_or_assign(std::make_pair("/interaction_profiles/khr/simple_controller",
-                                                                 "/interaction_profiles/khr/simple_controller"),
-                                                  [&](const Action& xrAction, XrPath binding, ActionSource& source) {
-                                                      return mapPathToSimpleControllerInputState(
-                                                          xrAction, getXrPath(binding), source);
-                                                  });
+        {ViveControllerProfile, ViveControllerProfile, table(ViveControllerBindings)},
+        {IndexControllerProfile, IndexControllerProfile, table(IndexControllerBindings)},
+        {SimpleControllerProfile, SimpleControllerProfile, table(SimpleControllerBindings)},
 
         // Virtual mappings to Vive controller.
-        m_controllerMappingTable.insert_or_assign(
-            std::make_pair("/interaction_profiles/oculus/touch_controller",
-                           "/interaction_profiles/htc/vive_controller"),
-            [&](const Action& xrAction, XrPath binding, ActionSource& source) {
-                const auto remapped = remapOculusTouchControllerToViveController(getXrPath(binding));
-                if (remapped.has_value()) {
-                    return mapPathToViveControllerInputState(xrAction, remapped.value(), source);
-                }
-                return false;
-            });
-        m_controllerMappingTable.insert_or_assign(
-            std::make_pair("/interaction_profiles/microsoft/motion_controller",
-                           "/interaction_profiles/htc/vive_controller"),
-            [&](const Action& xrAction, XrPath binding, ActionSource& source) {
-                const auto remapped = remapMicrosoftMotionControllerToViveController(getXrPath(binding));
-                if (remapped.has_value()) {
-                    return mapPathToViveControllerInputState(xrAction, remapped.value(), source);
-                }
-                return false;
-            });
-        m_controllerMappingTable.insert_or_assign(
-            std::make_pair("/interaction_profiles/khr/simple_controller", "/interaction_profiles/htc/vive_controller"),
-            [&](const Action& xrAction, XrPath binding, ActionSource& source) {
-                const auto remapped = remapSimpleControllerToViveController(getXrPath(binding));
-                if (remapped.has_value()) {
-                    return mapPathToViveControllerInputState(xrAction, remapped.value(), source);
-                }
-                return false;
-            });
+        {OculusTouchControllerProfile,
+         ViveControllerProfile,
+         table(ViveControllerBindings),
+         table(OculusTouchControllerToViveController)},
+        {MicrosoftMotionControllerProfile,
+         ViveControllerProfile,
+         table(ViveControllerBindings),
+         table(MicrosoftMotionControllerToViveController)},
+        {SimpleControllerProfile,
+         ViveControllerProfile,
+         table(ViveControllerBindings),
+         table(SimpleControllerToViveController)},
 
         // Virtual mappings to Index controller.
-        m_controllerMappingTable.insert_or_assign(
-            std::make_pair("/interaction_profiles/oculus/touch_controller",
-                           "/interaction_profiles/valve/index_controller"),
-            [&](const Action& xrAction, XrPath binding, ActionSource& source) {
-                const auto remapped = remapOculusTouchControllerToIndexController(getXrPath(binding));
-                if (remapped.has_value()) {
-                    return mapPathToIndexControllerInputState(xrAction, remapped.value(), source);
-                }
-                return false;
-            });
-        m_controllerMappingTable.insert_or_assign(
-            std::make_pair("/interaction_profiles/microsoft/motion_controller",
-                           "/interaction_profiles/valve/index_controller"),
-            [&](const Action& xrAction, XrPath binding, ActionSource& source) {
-                const auto remapped = remapMicrosoftMotionControllerToIndexController(getXrPath(binding));
-                if (remapped.has_value()) {
-                    return mapPathToIndexControllerInputState(xrAction, remapped.value(), source);
-                }
-                return false;
-            });
-        m_controllerMappingTable.insert_or_assign(
-            std::make_pair("/interaction_profiles/khr/simple_controller",
-                           "/interaction_profiles/valve/index_controller"),
-            [&](const Action& xrAction, XrPath binding, ActionSource& source) {
-                const auto remapped = remapSimpleControllerToIndexController(getXrPath(binding));
-                if (remapped.has_value()) {
-                    return mapPathToIndexControllerInputState(xrAction, remapped.value(), source);
-                }
-                return false;
-            });
+        {OculusTouchControllerProfile,
+         IndexControllerProfile,
+         table(IndexControllerBindings),
+         table(OculusTouchControllerToIndexController)},
+        {MicrosoftMotionControllerProfile,
+         IndexControllerProfile,
+         table(IndexControllerBindings),
+         table(MicrosoftMotionControllerToIndexController)},
+        {SimpleControllerProfile,
+         IndexControllerProfile,
+         table(IndexControllerBindings),
+         table(SimpleControllerToIndexController)},
 
         // Virtual mappings to Simple controller.
-        m_controllerMappingTable.insert_or_assign(
-            std::make_pair("/interaction_profiles/oculus/touch_controller",
-                           "/interaction_profiles/khr/simple_controller"),
-            [&](const Action& xrAction, XrPath binding, ActionSource& source) {
-                const auto remapped = remapOculusTouchControllerToSimpleController(getXrPath(binding));
-                if (remapped.has_value()) {
-                    return mapPathToSimpleControllerInputState(xrAction, remapped.value(), source);
-                }
-                return false;
-            });
-        m_controllerMappingTable.insert_or_assign(
-            std::make_pair("/interaction_profiles/microsoft/motion_controller",
-                           "/interaction_profiles/khr/simple_controller"),
-            [&](const Action& xrAction, XrPath binding, ActionSource& source) {
-                const auto remapped = remapMicrosoftMotionControllerToSimpleController(getXrPath(binding));
-                if (remapped.has_value()) {
-                    return mapPathToSimpleControllerInputState(xrAction, remapped.value(), source);
-                }
-                return false;
-            });
+        {OculusTouchControllerProfile,
+         SimpleControllerProfile,
+         table(SimpleControllerBindings),
+         table(MotionControllerToSimpleController)},
+        {MicrosoftMotionControllerProfile,
+         SimpleControllerProfile,
+         table(SimpleControllerBindings),
+         table(MotionControllerToSimpleController)},
+    };
+} // namespace
 
-        // Functions for validating paths.
+namespace pimax_openxr {
+
+    using namespace pimax_openxr::log;
+    using namespace pimax_openxr::utils;
+
+    void OpenXrRuntime::initializeRemappingTables() {
         m_controllerValidPathsTable.insert_or_assign(
             "/interaction_profiles/khr/simple_controller",
             [&](const std::string& path) { return getSimpleControllerLocalizedSourceName(path) != "<Unknown>"; });
@@ -267,164 +553,114 @@ namespace pimax_openxr {
                 }
                 return false;
             });
+        m_controllerValidPathsTable.insert_or_assign(
+            "/interaction_profiles/ext/eye_gaze_interaction", [](const std::string& path) {
+                return path == "/user/eyes_ext/input/gaze_ext/pose" || path == "/user/eyes_ext/input/gaze_ext";
+            });
+    }
+
+    std::optional<size_t> OpenXrRuntime::findControllerMapping(const std::string& actualProfile,
+                                                               const std::string& preferredProfile) const {
+        for (size_t i = 0; i < std::size(ControllerMappings); i++) {
+            if (ControllerMappings[i].actualProfile == actualProfile &&
+                ControllerMappings[i].preferredProfile == preferredProfile) {
+                return i;
+            }
+        }
+        return {};
     }
 
-    bool OpenXrRuntime::mapPathToViveControllerInputState(const Action& xrAction,
-                                                          const std::string& path,
-                                                          ActionSource& source) const {
+    bool OpenXrRuntime::mapBindingToInputState(
+        size_t mapping, int side, const Action& xrAction, XrPath binding, ActionSource& source) const {
+        const auto& controllerMapping = ControllerMappings[mapping];
+
         source.buttonMap = nullptr;
         source.floatValue = nullptr;
         source.vector2fValue = nullptr;
 
-        if (endsWith(path, "/input/system/click") || endsWith(path, "/input/system")) {
-            source.buttonMap = m_cachedInputState.HandButtons;
-            source.buttonType = pvrButton_System;
-        } else if (endsWith(path, "/input/squeeze/click") || endsWith(path, "/input/squeeze/force") ||
-                   endsWith(path, "/input/squeeze")) {
-            source.buttonMap = m_cachedInputState.HandButtons;
-            source.buttonType = pvrButton_Grip;
-        } else if (endsWith(path, "/input/menu/click") || endsWith(path, "/input/menu")) {
-            source.buttonMap = m_cachedInputState.HandButtons;
-            source.buttonType = pvrButton_ApplicationMenu;
-        } else if (endsWith(path, "/input/trigger/click") ||
-                   (xrAction.type == XR_ACTION_TYPE_BOOLEAN_INPUT && endsWith(path, "/input/trigger"))) {
-            source.buttonMap = m_cachedInputState.HandButtons;
-            source.buttonType = pvrButton_Trigger;
-        } else if (endsWith(path, "/input/trigger/value") ||
-                   (xrAction.type == XR_ACTION_TYPE_FLOAT_INPUT && endsWith(path, "/input/trigger"))) {
-            source.floatValue = m_cachedInputState.Trigger;
-        } else if (endsWith(path, "/input/trackpad")) {
-            source.vector2fValue = m_cachedInputState.TouchPad;
-            source.vector2fIndex = -1;
-        } else if (endsWith(path, "/input/trackpad/x")) {
-            source.vector2fValue = m_cachedInputState.TouchPad;
-            source.vector2fIndex = 0;
-        } else if (endsWith(path, "/input/trackpad/y")) {
-            source.vector2fValue = m_cachedInputState.TouchPad;
-            source.vector2fIndex = 1;
-        } else if (endsWith(path, "/input/trackpad/click") || endsWith(path, "/input/trackpad/force") ||
-                   endsWith(path, "/input/trackpad")) {
-            source.buttonMap = m_cachedInputState.HandButtons;
-            source.buttonType = pvrButton_TouchPad;
-        } else if (endsWith(path, "/input/trackpad/touch")) {
-            source.buttonMap = m_cachedInputState.HandTouches;
-            source.buttonType = pvrButton_TouchPad;
-        } else if (endsWith(path, "/input/grip/pose") || endsWith(path, "/input/aim/pose") ||
-                   endsWith(path, "/output/haptic")) {
-            // Do nothing.
+        // Split the top-level path from the component path.
+        const std::string_view path = getXrPath(binding);
+        auto componentStart = path.find("/input/");
+        if (componentStart == std::string_view::npos) {
+            componentStart = path.find("/output/");
+        }
+        if (componentStart == std::string_view::npos) {
+            return false;
+        }
+        const auto component = findComponent(path.substr(componentStart));
+        if (!component) {
+            return false;
+        }
+
+        // Remap the component to the physical controller.
+        std::optional<Component> remapped;
+        if (controllerMapping.remaps.first) {
+            for (size_t i = 0; i < controllerMapping.remaps.second; i++) {
+                const auto& remap = controllerMapping.remaps.first[i];
+                if (remap.from == component.value() && (remap.side < 0 || remap.side == side)) {
+                    remapped = remap.to;
+                    break;
+                }
+            }
         } else {
+            remapped = component;
+        }
+        if (!remapped) {
             // No possible binding.
             return false;
         }
 
-        source.realPath = path;
-
-        return true;
-    }
-
-    bool OpenXrRuntime::mapPathToIndexControllerInputState(const Action& xrAction,
-                                                           const std::string& path,
-                                                           ActionSource& source) const {
-        source.buttonMap = nullptr;
-        source.floatValue = nullptr;
-        source.vector2fValue = nullptr;
+        // Find where to read the component from.
+        const InputBinding* inputBinding = nullptr;
+        for (size_t i = 0; i < controllerMapping.bindings.second; i++) {
+            const auto& entry = controllerMapping.bindings.first[i];
+            if (entry.component == remapped.value() &&
+                (entry.actionType == XR_ACTION_TYPE_MAX_ENUM || entry.actionType == xrAction.type)) {
+                inputBinding = &entry;
+                break;
+            }
+        }
+        if (!inputBinding) {
+            // No possible binding.
+            return false;
+        }
 
-        if (endsWith(path, "/input/system/click") || endsWith(path, "/input/system")) {
-            source.buttonMap = m_cachedInputState.HandButtons;
-            source.buttonType = pvrButton_System;
-        } else if (endsWith(path, "/input/system/touch")) {
-            source.buttonMap = m_cachedInputState.HandTouches;
-            source.buttonType = pvrButton_System;
-        } else if (endsWith(path, "/input/a/click") || endsWith(path, "/input/a")) {
+        switch (inputBinding->field) {
+        case InputField::Buttons:
             source.buttonMap = m_cachedInputState.HandButtons;
-            source.buttonType = pvrButton_A;
-        } else if (endsWith(path, "/input/a/touch")) {
+            source.buttonType = inputBinding->button;
+            break;
+        case InputField::Touches:
             source.buttonMap = m_cachedInputState.HandTouches;
-            source.buttonType = pvrButton_A;
-        } else if (endsWith(path, "/input/b/click") || endsWith(path, "/input/b")) {
-            source.buttonMap = m_cachedInputState.HandButtons;
-            source.buttonType = pvrButton_B;
-        } else if (endsWith(path, "/input/b/touch")) {
-            source.buttonMap = m_cachedInputState.HandTouches;
-            source.buttonType = pvrButton_B;
-        } else if (endsWith(path, "/input/squeeze/value") || endsWith(path, "/input/squeeze")) {
+            source.buttonType = inputBinding->button;
+            break;
+        case InputField::Trigger:
+            source.floatValue = m_cachedInputState.Trigger;
+            break;
+        case InputField::Grip:
             source.floatValue = m_cachedInputState.Grip;
-        } else if (endsWith(path, "/input/squeeze/force")) {
+            break;
+        case InputField::GripForce:
             source.floatValue = m_cachedInputState.GripForce;
-        } else if (endsWith(path, "/input/trigger/click") ||
-                   (xrAction.type == XR_ACTION_TYPE_BOOLEAN_INPUT && endsWith(path, "/input/trigger"))) {
-            source.buttonMap = m_cachedInputState.HandButtons;
-            source.buttonType = pvrButton_Trigger;
-        } else if (endsWith(path, "/input/trigger/value") ||
-                   (xrAction.type == XR_ACTION_TYPE_FLOAT_INPUT && endsWith(path, "/input/trigger"))) {
-            source.floatValue = m_cachedInputState.Trigger;
-        } else if (endsWith(path, "/input/trigger/touch")) {
-            source.buttonMap = m_cachedInputState.HandTouches;
-            source.buttonType = pvrButton_Trigger;
-        } else if (endsWith(path, "/input/thumbstick")) {
-            source.vector2fValue = m_cachedInputState.JoyStick;
-            source.vector2fIndex = -1;
-        } else if (endsWith(path, "/input/thumbstick/x")) {
-            source.vector2fValue = m_cachedInputState.JoyStick;
-            source.vector2fIndex = 0;
-        } else if (endsWith(path, "/input/thumbstick/y")) {
+            break;
+        case InputField::TouchPadForce:
+            source.floatValue = m_cachedInputState.TouchPadForce;
+            break;
+        case InputField::JoyStick:
             source.vector2fValue = m_cachedInputState.JoyStick;
-            source.vector2fIndex = 1;
-        } else if (endsWith(path, "/input/thumbstick/click") || endsWith(path, "/input/thumbstick")) {
-            source.buttonMap = m_cachedInputState.HandButtons;
-            source.buttonType = pvrButton_JoyStick;
-        } else if (endsWith(path, "/input/thumbstick/touch")) {
-            source.buttonMap = m_cachedInputState.HandTouches;
-            source.buttonType = pvrButton_JoyStick;
-        } else if (endsWith(path, "/input/trackpad")) {
+            source.vector2fIndex = inputBinding->vector2fIndex;
+            break;
+        case InputField::TouchPad:
             source.vector2fValue = m_cachedInputState.TouchPad;
-            source.vector2fIndex = -1;
-        } else if (endsWith(path, "/input/trackpad/x")) {
-            source.vector2fValue = m_cachedInputState.TouchPad;
-            source.vector2fIndex = 0;
-        } else if (endsWith(path, "/input/trackpad/y")) {
-            source.vector2fValue = m_cachedInputState.TouchPad;
-            source.vector2fIndex = 1;
-        } else if (endsWith(path, "/input/trackpad/force")) {
-            source.floatValue = m_cachedInputState.TouchPadForce;
-        } else if (endsWith(path, "/input/trackpad/touch")) {
-            source.buttonMap = m_cachedInputState.HandTouches;
-            source.buttonType = pvrButton_TouchPad;
-        } else if (endsWith(path, "/input/grip/pose") || endsWith(path, "/input/aim/pose") ||
-                   endsWith(path, "/output/haptic")) {
-            // Do nothing.
-        } else {
-            // No possible binding.
-            return false;
-        }
-
-        source.realPath = path;
-
-        return true;
-    }
-
-    bool OpenXrRuntime::mapPathToSimpleControllerInputState(const Action& xrAction,
-                                                            const std::string& path,
-                                                            ActionSource& source) const {
-        source.buttonMap = nullptr;
-        source.floatValue = nullptr;
-        source.vector2fValue = nullptr;
-
-        if (endsWith(path, "/input/select/click") || endsWith(path, "/input/select")) {
-            source.buttonMap = m_cachedInputState.HandButtons;
-            source.buttonType = pvrButton_Trigger;
-        } else if (endsWith(path, "/input/menu/click") || endsWith(path, "/input/menu")) {
-            source.buttonMap = m_cachedInputState.HandButtons;
-            source.buttonType = pvrButton_ApplicationMenu;
-        } else if (endsWith(path, "/input/grip/pose") || endsWith(path, "/input/aim/pose") ||
-                   endsWith(path, "/output/haptic")) {
+            source.vector2fIndex = inputBinding->vector2fIndex;
+            break;
+        case InputField::None:
             // Do nothing.
-        } else {
-            // No possible binding.
-            return false;
+            break;
         }
 
-        source.realPath = path;
+        source.realPath = std::string(path.substr(0, componentStart));
+        source.realPath += ComponentPaths[(size_t)remapped.value()];
 
         return true;
     }
@@ -532,164 +768,4 @@ namespace pimax_openxr {
 
         return "<Unknown>";
     }
-
-    std::optional<std::string> OpenXrRuntime::remapSimpleControllerToViveController(const std::string& path) const {
-        if (endsWith(path, "/input/select/click") || endsWith(path, "/input/select")) {
-            return rreplace(path, "/input/select", "/input/trigger");
-        } else if (endsWith(path, "/input/menu/click") || endsWith(path, "/input/menu")) {
-            return path;
-        } else if (endsWith(path, "/input/grip/pose") || endsWith(path, "/input/aim/pose") ||
-                   endsWith(path, "/output/haptic")) {
-            return path;
-        }
-
-        // No possible binding.
-        return {};
-    }
-
-    std::optional<std::string>
-    OpenXrRuntime::remapOculusTouchControllerToViveController(const std::string& path) const {
-        if (endsWith(path, "/input/thumbstick") || endsWith(path, "/input/thumbstick/x") ||
-            endsWith(path, "/input/thumbstick/y") || endsWith(path, "/input/thumbstick/click") ||
-            endsWith(path, "/input/thumbstick/touch")) {
-            return rreplace(path, "/input/thumbstick", "/input/trackpad");
-        } else if (endsWith(path, "/input/squeeze/value")) {
-            return rreplace(path, "/input/squeeze/value", "/input/squeeze/click");
-        } else if (endsWith(path, "/input/squeeze/force")) {
-            return rreplace(path, "/input/squeeze/force", "/input/squeeze/click");
-        } else if (path == "/user/hand/right/input/a/click" || path == "/user/hand/right/input/a") {
-            return "/user/hand/right/input/menu/click";
-        } else if (endsWith(path, "/input/system/click") || endsWith(path, "/input/system") ||
-                   endsWith(path, "/input/menu/click") || endsWith(path, "/input/menu") ||
-                   endsWith(path, "/input/squeeze/click") || endsWith(path, "/input/squeeze") ||
-                   endsWith(path, "/input/trigger/click") || endsWith(path, "/input/trigger/value") ||
-                   endsWith(path, "/input/trigger")) {
-            return path;
-        } else if (endsWith(path, "/input/grip/pose") || endsWith(path, "/input/aim/pose") ||
-                   endsWith(path, "/output/haptic")) {
-            return path;
-        }
-
-        // No possible binding.
-        return {};
-    }
-
-    std::optional<std::string>
-    OpenXrRuntime::remapMicrosoftMotionControllerToViveController(const std::string& path) const {
-        if (endsWith(path, "/input/squeeze/value")) {
-            return rreplace(path, "/input/squeeze/value", "/input/squeeze/click");
-        } else if (endsWith(path, "/input/squeeze/force")) {
-            return rreplace(path, "/input/squeeze/force", "/input/squeeze/click");
-        } else if (endsWith(path, "/input/menu/click") || endsWith(path, "/input/menu") ||
-                   endsWith(path, "/input/squeeze/click") || endsWith(path, "/input/squeeze") ||
-                   endsWith(path, "/input/trigger/click") || endsWith(path, "/input/trigger/value") ||
-                   endsWith(path, "/input/trigger") || endsWith(path, "/input/trackpad") ||
-                   endsWith(path, "/input/trackpad/x") || endsWith(path, "/input/trackpad/y") ||
-                   endsWith(path, "/input/trackpad/click") || endsWith(path, "/input/trackpad/force") ||
-                   endsWith(path, "/input/trackpad/touch")) {
-            return path;
-        } else if (endsWith(path, "/input/grip/pose") || endsWith(path, "/input/aim/pose") ||
-                   endsWith(path, "/output/haptic")) {
-            return path;
-        }
-
-        // No possible binding.
-        return {};
-    }
-
-    std::optional<std::string> OpenXrRuntime::remapSimpleControllerToIndexController(const std::string& path) const {
-        if (endsWith(path, "/input/select/click") || endsWith(path, "/input/select")) {
-            return rreplace(path, "/input/select", "/input/trigger");
-        } else if (endsWith(path, "/input/menu/click") || endsWith(path, "/input/menu")) {
-            return rreplace(path, "/input/menu", "/input/a");
-        } else if (endsWith(path, "/input/grip/pose") || endsWith(path, "/input/aim/pose") ||
-                   endsWith(path, "/output/haptic")) {
-            return path;
-        }
-
-        // No possible binding.
-        return {};
-    }
-
-    std::optional<std::string>
-    OpenXrRuntime::remapOculusTouchControllerToIndexController(const std::string& path) const {
-        if (endsWith(path, "/input/x/click") || endsWith(path, "/input/x")) {
-            return rreplace(path, "/input/x", "/input/a");
-        } else if (endsWith(path, "/input/y/click") || endsWith(path, "/input/y")) {
-            return rreplace(path, "/input/y", "/input/b");
-        } else if (endsWith(path, "/input/system/click") || endsWith(path, "/input/system") ||
-                   endsWith(path, "/input/menu/click") || endsWith(path, "/input/menu") ||
-                   endsWith(path, "/input/a/click") || endsWith(path, "/input/a") || endsWith(path, "/input/b/click") ||
-                   endsWith(path, "/input/b") || endsWith(path, "/input/squeeze/click") ||
-                   endsWith(path, "/input/squeeze/value") || endsWith(path, "/input/squeeze/force") ||
-                   endsWith(path, "/input/squeeze") || endsWith(path, "/input/trigger/click") ||
-                   endsWith(path, "/input/trigger/value") || endsWith(path, "/input/trigger") ||
-                   endsWith(path, "/input/thumbstick") || endsWith(path, "/input/thumbstick/x") ||
-                   endsWith(path, "/input/thumbstick/y") || endsWith(path, "/input/thumbstick/click") ||
-                   endsWith(path, "/input/thumbstick/touch")) {
-            return path;
-        } else if (endsWith(path, "/input/grip/pose") || endsWith(path, "/input/aim/pose") ||
-                   endsWith(path, "/output/haptic")) {
-            return path;
-        }
-
-        // No possible binding.
-        return {};
-    }
-
-    std::optional<std::string>
-    OpenXrRuntime::remapMicrosoftMotionControllerToIndexController(const std::string& path) const {
-        if (endsWith(path, "/input/squeeze/click") || endsWith(path, "/input/squeeze/value") ||
-            endsWith(path, "/input/squeeze/force") || endsWith(path, "/input/squeeze") ||
-            endsWith(path, "/input/trigger/click") || endsWith(path, "/input/trigger/value") ||
-            endsWith(path, "/input/trigger") || endsWith(path, "/input/trackpad") ||
-            endsWith(path, "/input/trackpad/x") || endsWith(path, "/input/trackpad/y") ||
-            endsWith(path, "/input/trackpad/click") || endsWith(path, "/input/trackpad/force") ||
-            endsWith(path, "/input/trackpad/touch") || endsWith(path, "/input/thumbstick") ||
-            endsWith(path, "/input/thumbstick/x") || endsWith(path, "/input/thumbstick/y") ||
-            endsWith(path, "/input/thumbstick/click") || endsWith(path, "/input/thumbstick/touch")) {
-            return path;
-        } else if (endsWith(path, "/input/grip/pose") || endsWith(path, "/input/aim/pose") ||
-                   endsWith(path, "/output/haptic")) {
-            return path;
-        }
-
-        // No possible binding.
-        return {};
-    }
-
-    std::optional<std::string>
-    OpenXrRuntime::remapOculusTouchControllerToSimpleController(const std::string& path) const {
-        if (endsWith(path, "/input/trigger/click") || endsWith(path, "/input/trigger")) {
-            return rreplace(path, "/input/trigger", "/input/select");
-        } else if (endsWith(path, "/input/trigger/value")) {
-            return rreplace(path, "/input/trigger/value", "/input/select/click");
-        } else if (endsWith(path, "/input/menu/click") || endsWith(path, "/input/menu")) {
-            return path;
-        } else if (endsWith(path, "/input/grip/pose") || endsWith(path, "/input/aim/pose") ||
-                   endsWith(path, "/output/haptic")) {
-            return path;
-        }
-
-        // No possible binding.
-        return {};
-    }
-
-    std::optional<std::string>
-    OpenXrRuntime::remapMicrosoftMotionControllerToSimpleController(const std::string& path) const {
-        if (endsWith(path, "/input/trigger/click") || endsWith(path, "/input/trigger")) {
-            return rreplace(path, "/input/trigger", "/input/select");
-        } else if (endsWith(path, "/input/trigger/value")) {
-            return rreplace(path, "/input/trigger/value", "/input/select/click");
-        } else if (endsWith(path, "/input/menu/click") || endsWith(path, "/input/menu")) {
-            return path;
-        } else if (endsWith(path, "/input/grip/pose") || endsWith(path, "/input/aim/pose") ||
-                   endsWith(path, "/output/haptic")) {
-            return path;
-        }
-
-        // No possible binding.
-        return {};
-    }
-
 } // namespace pimax_openxr
\ No newline at end of file
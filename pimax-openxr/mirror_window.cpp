@@ -37,6 +37,20 @@ namespace pimax_openxr {
 
     void OpenXrRuntime::createMirrorWindow() {
         m_mirrorWindowReady = false;
+
+        // Presentation rate in Hz, or 0 to follow the desktop refresh. Only read when the window is created, since
+        // the thread below relies on it.
+        m_mirrorWindowRate = std::clamp(getSetting("mirror_window_rate").value_or(0), 0, 240);
+
+        // The mirror window thread shares the immediate context of the submission device.
+        {
+            ComPtr<ID3D11Multithread> multithread;
+            CHECK_HRCMD(m_pvrSubmissionContext->QueryInterface(IID_PPV_ARGS(multithread.ReleaseAndGetAddressOf())));
+            multithread->SetMultithreadProtected(TRUE);
+        }
+        *m_mirrorWindowNewFrame.put() = CreateEventEx(nullptr, nullptr, 0, EVENT_MODIFY_STATE | SYNCHRONIZE);
+        CHECK_MSG(m_mirrorWindowNewFrame, "Failed to CreateEventEx()");
+
         m_mirrorWindowThread = std::thread([&]() {
             // Create the window.
             WNDCLASSEX wndClassEx = {sizeof(wndClassEx)};
@@ -79,19 +93,34 @@ namespace pimax_openxr {
                 CHECK_HRCMD(dxgiAdapter->GetParent(IID_PPV_ARGS(dxgiFactory.ReleaseAndGetAddressOf())));
             }
 
+            // Tearing lets us present at our own cadence without waiting for the desktop refresh.
+            m_mirrorWindowAllowTearing = false;
+            if (m_mirrorWindowRate) {
+                ComPtr<IDXGIFactory5> dxgiFactory5;
+                BOOL allowTearing = FALSE;
+                if (SUCCEEDED(dxgiFactory->QueryInterface(IID_PPV_ARGS(dxgiFactory5.ReleaseAndGetAddressOf()))) &&
+                    SUCCEEDED(dxgiFactory5->CheckFeatureSupport(
+                        DXGI_FEATURE_PRESENT_ALLOW_TEARING, &allowTearing, sizeof(allowTearing)))) {
+                    m_mirrorWindowAllowTearing = allowTearing;
+                }
+            }
+
             RECT rect = {0, 0, defaultWidth, defaultHeight};
             AdjustWindowRect(&rect, WS_OVERLAPPEDWINDOW, false);
             const auto width = rect.right - rect.left;
             const auto height = rect.bottom - rect.top;
 
+            // Flip model does not accept sRGB formats, but the copy from the sRGB mirror texture preserves the encoded
+            // values.
             DXGI_SWAP_CHAIN_DESC1 swapchainDesc{};
             swapchainDesc.Width = width;
             swapchainDesc.Height = height;
-            swapchainDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM_SRGB;
+            swapchainDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
             swapchainDesc.SampleDesc.Count = 1;
             swapchainDesc.BufferUsage = DXGI_USAGE_RENDER_TARGET_OUTPUT;
             swapchainDesc.BufferCount = 2;
-            swapchainDesc.SwapEffect = DXGI_SWAP_EFFECT_DISCARD;
+            swapchainDesc.SwapEffect = DXGI_SWAP_EFFECT_FLIP_DISCARD;
+            swapchainDesc.Flags = getMirrorWindowSwapchainFlags();
             CHECK_HRCMD(dxgiFactory->CreateSwapChainForHwnd(m_pvrSubmissionDevice.Get(),
                                                             m_mirrorWindowHwnd,
                                                             &swapchainDesc,
@@ -99,35 +128,93 @@ namespace pimax_openxr {
                                                             nullptr,
                                                             m_mirrorWindowSwapchain.ReleaseAndGetAddressOf()));
 
+            wil::unique_handle frameLatencyWaitable;
+            {
+                ComPtr<IDXGISwapChain2> swapchain2;
+                CHECK_HRCMD(m_mirrorWindowSwapchain->QueryInterface(IID_PPV_ARGS(swapchain2.ReleaseAndGetAddressOf())));
+                CHECK_HRCMD(swapchain2->SetMaximumFrameLatency(1));
+                *frameLatencyWaitable.put() = swapchain2->GetFrameLatencyWaitableObject();
+            }
+
+            wil::unique_handle presentTimer;
+            if (m_mirrorWindowRate) {
+                *presentTimer.put() = CreateWaitableTimerEx(
+                    nullptr, nullptr, CREATE_WAITABLE_TIMER_HIGH_RESOLUTION, TIMER_MODIFY_STATE | SYNCHRONIZE);
+                CHECK_MSG(presentTimer, "Failed to CreateWaitableTimerEx()");
+            }
+
             ShowWindow(m_mirrorWindowHwnd, SW_SHOW);
             UpdateWindow(m_mirrorWindowHwnd);
 
-            // Service the window.
-            MSG msg;
-            while (GetMessage(&msg, m_mirrorWindowHwnd, 0, 0) > 0) {
-                TranslateMessage(&msg);
-                DispatchMessage(&msg);
+            // Service the window, and present whenever the swapchain can accept a frame, a new frame was submitted to
+            // PVR and the cadence allows it.
+            bool isBackBufferAvailable = false;
+            bool hasNewFrame = false;
+            bool isPresentDue = true;
+            bool isQuitting = false;
+            while (!isQuitting) {
+                HANDLE handles[3];
+                DWORD handleCount = 0;
+                if (!isBackBufferAvailable) {
+                    handles[handleCount++] = frameLatencyWaitable.get();
+                }
+                if (!hasNewFrame) {
+                    handles[handleCount++] = m_mirrorWindowNewFrame.get();
+                }
+                if (!isPresentDue) {
+                    handles[handleCount++] = presentTimer.get();
+                }
+                const DWORD result = MsgWaitForMultipleObjects(handleCount, handles, FALSE, INFINITE, QS_ALLINPUT);
+                if (result >= WAIT_OBJECT_0 && result < WAIT_OBJECT_0 + handleCount) {
+                    const HANDLE signaled = handles[result - WAIT_OBJECT_0];
+                    if (signaled == frameLatencyWaitable.get()) {
+                        isBackBufferAvailable = true;
+                    } else if (signaled == m_mirrorWindowNewFrame.get()) {
+                        hasNewFrame = true;
+                    } else {
+                        isPresentDue = true;
+                    }
+                }
+
+                MSG msg;
+                while (PeekMessage(&msg, nullptr, 0, 0, PM_REMOVE)) {
+                    if (msg.message == WM_QUIT) {
+                        isQuitting = true;
+                    }
+                    TranslateMessage(&msg);
+                    DispatchMessage(&msg);
+                }
+
+                if (!isQuitting && isBackBufferAvailable && hasNewFrame && isPresentDue) {
+                    // The back buffer remains available when the window is minimized.
+                    if (updateMirrorWindow()) {
+                        isBackBufferAvailable = false;
+                    }
+                    hasNewFrame = false;
+
+                    if (presentTimer) {
+                        LARGE_INTEGER dueTime;
+                        dueTime.QuadPart = -(LONGLONG)(1e7 / m_mirrorWindowRate);
+                        SetWaitableTimer(presentTimer.get(), &dueTime, 0, nullptr, nullptr, FALSE);
+                        isPresentDue = false;
+                    }
+                }
             }
 
             // Free resources ASAP.
-            {
-                std::unique_lock lock(m_mirrorWindowLock);
-                m_mirrorWindowSwapchain.Reset();
-                m_mirrorTexture.Reset();
+            m_mirrorWindowSwapchain.Reset();
+            m_mirrorTexture.Reset();
+            if (m_pvrMirrorSwapChain) {
+                std::unique_lock pvrLock(m_pvrLock);
                 pvr_destroyMirrorTexture(m_pvrSession, m_pvrMirrorSwapChain);
                 m_pvrMirrorSwapChain = nullptr;
-                m_mirrorWindowHwnd = nullptr;
             }
+            m_mirrorWindowHwnd = nullptr;
         });
     }
 
-    void OpenXrRuntime::updateMirrorWindow() {
-        std::unique_lock lock(m_mirrorWindowLock);
-
-        if (!m_mirrorWindowSwapchain) {
-            return;
-        }
-
+    // Called on the mirror window thread. Returns whether a frame was presented.
+    bool OpenXrRuntime::updateMirrorWindow() {
         RECT rect{};
         GetClientRect(m_mirrorWindowHwnd, &rect);
         AdjustWindowRect(&rect, WS_OVERLAPPEDWINDOW, false);
@@ -136,7 +223,7 @@ namespace pimax_openxr {
 
         // Check if visible.
         if (!width || !height) {
-            return;
+            return false;
         }
 
         // Check for resizing or initial creation.
@@ -147,11 +234,13 @@ namespace pimax_openxr {
         if (!m_mirrorTexture || mirrorDesc.Width != width || mirrorDesc.Height != height) {
             TraceLoggingWrite(g_traceProvider, "MirrorWindow", TLArg(width, "Width"), TLArg(height, "Height"));
 
-            CHECK_HRCMD(m_mirrorWindowSwapchain->ResizeBuffers(0, width, height, DXGI_FORMAT_UNKNOWN, 0));
+            CHECK_HRCMD(m_mirrorWindowSwapchain->ResizeBuffers(
+                0, width, height, DXGI_FORMAT_UNKNOWN, getMirrorWindowSwapchainFlags()));
 
             // Recreate a new PVR swapchain with the correct size.
             if (m_pvrMirrorSwapChain) {
                 m_mirrorTexture.Reset();
+                std::unique_lock pvrLock(m_pvrLock);
                 pvr_destroyMirrorTexture(m_pvrSession, m_pvrMirrorSwapChain);
             }
 
@@ -160,10 +249,13 @@ namespace pimax_openxr {
             mirrorDesc.Width = width;
             mirrorDesc.Height = height;
             mirrorDesc.SampleCount = 1;
-            CHECK_PVRCMD(pvr_createMirrorTextureDX(
-                m_pvrSession, m_pvrSubmissionDevice.Get(), &mirrorDesc, &m_pvrMirrorSwapChain));
-            CHECK_PVRCMD(pvr_getMirrorTextureBufferDX(
-                m_pvrSession, m_pvrMirrorSwapChain, IID_PPV_ARGS(m_mirrorTexture.ReleaseAndGetAddressOf())));
+            {
+                std::unique_lock pvrLock(m_pvrLock);
+                CHECK_PVRCMD(pvr_createMirrorTextureDX(
+                    m_pvrSession, m_pvrSubmissionDevice.Get(), &mirrorDesc, &m_pvrMirrorSwapChain));
+                CHECK_PVRCMD(pvr_getMirrorTextureBufferDX(
+                    m_pvrSession, m_pvrMirrorSwapChain, IID_PPV_ARGS(m_mirrorTexture.ReleaseAndGetAddressOf())));
+            }
         }
 
         TraceLocalActivity(presentMirrorWindow);
@@ -173,8 +265,106 @@ namespace pimax_openxr {
         ComPtr<ID3D11Texture2D> frameBuffer;
         m_mirrorWindowSwapchain->GetBuffer(0, IID_PPV_ARGS(frameBuffer.ReleaseAndGetAddressOf()));
         m_pvrSubmissionContext->CopyResource(frameBuffer.Get(), m_mirrorTexture.Get());
-        m_mirrorWindowSwapchain->Present(0, 0);
+        if (m_mirrorWindowRate) {
+            m_mirrorWindowSwapchain->Present(0, m_mirrorWindowAllowTearing ? DXGI_PRESENT_ALLOW_TEARING : 0);
+        } else {
+            m_mirrorWindowSwapchain->Present(1, 0);
+        }
         TraceLoggingWriteStop(presentMirrorWindow, "PresentMirrorWindow");
+
+        return true;
+    }
+
+    UINT OpenXrRuntime::getMirrorWindowSwapchainFlags() const {
+        return DXGI_SWAP_CHAIN_FLAG_FRAME_LATENCY_WAITABLE_OBJECT |
+               (m_mirrorWindowAllowTearing ? DXGI_SWAP_CHAIN_FLAG_ALLOW_TEARING : 0);
+    }
+
+    // Publish the mirror view as a shared texture that other processes can open by name, without a window.
+    void OpenXrRuntime::createMirrorTexture() {
+        const auto width = m_cachedEyeInfo[0].DistortedViewport.Size.w;
+        const auto height = m_cachedEyeInfo[0].DistortedViewport.Size.h / 2;
+
+        pvrMirrorTextureDesc mirrorDesc;
+        mirrorDesc.Format = pvrTextureFormat::PVR_FORMAT_R8G8B8A8_UNORM_SRGB;
+        mirrorDesc.Width = width;
+        mirrorDesc.Height = height;
+        mirrorDesc.SampleCount = 1;
+        {
+            std::unique_lock pvrLock(m_pvrLock);
+            CHECK_PVRCMD(pvr_createMirrorTextureDX(
+                m_pvrSession, m_pvrSubmissionDevice.Get(), &mirrorDesc, &m_pvrSharedMirrorSwapChain));
+            CHECK_PVRCMD(pvr_getMirrorTextureBufferDX(
+                m_pvrSession, m_pvrSharedMirrorSwapChain, IID_PPV_ARGS(m_sharedMirrorSource.ReleaseAndGetAddressOf())));
+        }
+
+        D3D11_TEXTURE2D_DESC desc{};
+        desc.Width = width;
+        desc.Height = height;
+        desc.MipLevels = 1;
+        desc.ArraySize = 1;
+        desc.Format = DXGI_FORMAT_R8G8B8A8_UNORM_SRGB;
+        desc.SampleDesc.Count = 1;
+        desc.BindFlags = D3D11_BIND_SHADER_RESOURCE | D3D11_BIND_RENDER_TARGET;
+        desc.MiscFlags = D3D11_RESOURCE_MISC_SHARED_NTHANDLE | D3D11_RESOURCE_MISC_SHARED_KEYEDMUTEX;
+        CHECK_HRCMD(
+            m_pvrSubmissionDevice->CreateTexture2D(&desc, nullptr, m_sharedMirrorTexture.ReleaseAndGetAddressOf()));
+        setDebugName(m_sharedMirrorTexture.Get(), "Shared Mirror Texture");
+        CHECK_HRCMD(m_sharedMirrorTexture->QueryInterface(IID_PPV_ARGS(m_sharedMirrorMutex.ReleaseAndGetAddressOf())));
+
+        ComPtr<IDXGIResource1> dxgiResource;
+        CHECK_HRCMD(m_sharedMirrorTexture->QueryInterface(IID_PPV_ARGS(dxgiResource.ReleaseAndGetAddressOf())));
+        CHECK_HRCMD(dxgiResource->CreateSharedHandle(nullptr,
+                                                     DXGI_SHARED_RESOURCE_READ | DXGI_SHARED_RESOURCE_WRITE,
+                                                     k_sharedMirrorTextureName,
+                                                     m_sharedMirrorTextureHandle.put()));
+
+        *m_sharedMirrorInfoMapping.put() = CreateFileMappingW(
+            INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE, 0, sizeof(SharedMirrorInfo), k_sharedMirrorInfoName);
+        CHECK_MSG(m_sharedMirrorInfoMapping, "Failed to CreateFileMappingW()");
+        m_sharedMirrorInfo.reset(reinterpret_cast<SharedMirrorInfo*>(
+            MapViewOfFile(m_sharedMirrorInfoMapping.get(), FILE_MAP_WRITE, 0, 0, sizeof(SharedMirrorInfo))));
+        CHECK_MSG(m_sharedMirrorInfo, "Failed to MapViewOfFile()");
+        m_sharedMirrorInfo->width = width;
+        m_sharedMirrorInfo->height = height;
+        m_sharedMirrorInfo->format = desc.Format;
+        m_sharedMirrorInfo->displayTime = 0;
+        InterlockedExchange64(&m_sharedMirrorInfo->frameIndex, 0);
+        m_sharedMirrorInfo->version = k_sharedMirrorInfoVersion;
+
+        TraceLoggingWrite(g_traceProvider, "MirrorTexture", TLArg(width, "Width"), TLArg(height, "Height"));
+        Log("Publishing mirror texture %dx%d\n", width, height);
+    }
+
+    // Called right after the frame is submitted to PVR.
+    void OpenXrRuntime::updateMirrorTexture(double displayTime) {
+        if (!m_sharedMirrorTexture) {
+            return;
+        }
+
+        // Never stall the submission: when a consumer holds the texture, this frame is simply not published.
+        if (m_sharedMirrorMutex->AcquireSync(0, 0) != S_OK) {
+            return;
+        }
+        m_pvrSubmissionContext->CopyResource(m_sharedMirrorTexture.Get(), m_sharedMirrorSource.Get());
+        m_sharedMirrorMutex->ReleaseSync(0);
+
+        m_sharedMirrorInfo->displayTime = displayTime;
+        InterlockedIncrement64(&m_sharedMirrorInfo->frameIndex);
+    }
+
+    void OpenXrRuntime::destroyMirrorTexture() {
+        m_sharedMirrorInfo.reset();
+        m_sharedMirrorInfoMapping.reset();
+        m_sharedMirrorTextureHandle.reset();
+        m_sharedMirrorMutex.Reset();
+        m_sharedMirrorTexture.Reset();
+        m_sharedMirrorSource.Reset();
+        if (m_pvrSharedMirrorSwapChain) {
+            std::unique_lock pvrLock(m_pvrLock);
+            pvr_destroyMirrorTexture(m_pvrSession, m_pvrSharedMirrorSwapChain);
+            m_pvrSharedMirrorSwapChain = nullptr;
+        }
     }
 
     LRESULT CALLBACK OpenXrRuntime::mirrorWindowProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam) {
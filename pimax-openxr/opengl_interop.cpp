@@ -35,6 +35,59 @@ namespace pimax_openxr {
     using namespace pimax_openxr::log;
     using namespace pimax_openxr::utils;
 
+    // A GPU asynchronous timer for the app's OpenGL context.
+    class OpenXrRuntime::OpenGLGpuTimer : public ITimer {
+      public:
+        OpenGLGpuTimer(const OpenXrRuntime& runtime) : m_runtime(runtime) {
+            GlContextSwitch context(m_runtime.m_glContext);
+            m_runtime.m_glDispatch.glGenQueries(2, m_queries);
+        }
+
+        // The context must be current.
+        ~OpenGLGpuTimer() override {
+            m_runtime.m_glDispatch.glDeleteQueries(2, m_queries);
+        }
+
+        void start() override {
+            GlContextSwitch context(m_runtime.m_glContext);
+            m_runtime.m_glDispatch.glQueryCounter(m_queries[0], GL_TIMESTAMP);
+        }
+
+        void stop() override {
+            GlContextSwitch context(m_runtime.m_glContext);
+            m_runtime.m_glDispatch.glQueryCounter(m_queries[1], GL_TIMESTAMP);
+            m_valid = true;
+        }
+
+        uint64_t query(bool reset = true) const override {
+            uint64_t duration = 0;
+            if (m_valid) {
+                GlContextSwitch context(m_runtime.m_glContext);
+
+                // Never block: if the GPU is not done yet, we just report no measurement.
+                GLint available = GL_FALSE;
+                m_runtime.m_glDispatch.glGetQueryObjectiv(m_queries[1], GL_QUERY_RESULT_AVAILABLE, &available);
+                if (available) {
+                    GLuint64 startTime = 0, endTime = 0;
+                    m_runtime.m_glDispatch.glGetQueryObjectui64v(m_queries[0], GL_QUERY_RESULT, &startTime);
+                    m_runtime.m_glDispatch.glGetQueryObjectui64v(m_queries[1], GL_QUERY_RESULT, &endTime);
+                    if (endTime > startTime) {
+                        duration = (endTime - startTime) / 1000;
+                    }
+                }
+                m_valid = !reset;
+            }
+            return duration;
+        }
+
+      private:
+        const OpenXrRuntime& m_runtime;
+        GLuint m_queries[2]{};
+
+        // Can the timer be queried (it might still only read 0).
+        mutable bool m_valid{false};
+    };
+
     // https://www.khronos.org/registry/OpenXR/specs/1.0/html/xrspec.html#xrGetOpenGLGraphicsRequirementsKHR
     XrResult OpenXrRuntime::xrGetOpenGLGraphicsRequirementsKHR(XrInstance instance,
                                                                XrSystemId systemId,
@@ -115,7 +168,7 @@ namespace pimax_openxr {
 
         // Frame timers.
         for (uint32_t i = 0; i < k_numGpuTimers; i++) {
-            // TODO: m_gpuTimerApp[i] = std::make_unique<GpuTimer>(...);
+            m_gpuTimerApp[i] = std::make_unique<OpenGLGpuTimer>(*this);
         }
 
         return XR_SUCCESS;
@@ -141,6 +194,11 @@ namespace pimax_openxr {
         GL_GET_PTR(glSignalSemaphoreEXT);
         GL_GET_PTR(glImportMemoryWin32HandleEXT);
         GL_GET_PTR(glImportSemaphoreWin32HandleEXT);
+        GL_GET_PTR(glGenQueries);
+        GL_GET_PTR(glDeleteQueries);
+        GL_GET_PTR(glQueryCounter);
+        GL_GET_PTR(glGetQueryObjectiv);
+        GL_GET_PTR(glGetQueryObjectui64v);
 
 #undef GL_GET_PTR
     }
@@ -149,7 +207,7 @@ namespace pimax_openxr {
         if (m_glContext.valid) {
             GlContextSwitch context(m_glContext);
 
-            glFinish();
+            flushOpenGLContext();
 
             for (uint32_t i = 0; i < k_numGpuTimers; i++) {
                 m_gpuTimerApp[i].reset();
@@ -264,10 +322,26 @@ namespace pimax_openxr {
     }
 
     // Flush any pending work.
+    // Rather than draining the whole pipeline with glFinish(), we signal the shared fence behind the commands
+    // submitted so far and only wait for that value on the CPU.
     void OpenXrRuntime::flushOpenGLContext() {
-        GlContextSwitch context(m_glContext);
+        if (!m_glSemaphore || !m_pvrSubmissionFence) {
+            return;
+        }
+
+        {
+            GlContextSwitch context(m_glContext);
+
+            m_fenceValue++;
+            TraceLoggingWrite(
+                g_traceProvider, "FlushContext_Wait", TLArg("OpenGL", "Api"), TLArg(m_fenceValue, "FenceValue"));
+            m_glDispatch.glSemaphoreParameterui64vEXT(m_glSemaphore, GL_D3D12_FENCE_VALUE_EXT, &m_fenceValue);
+            m_glDispatch.glSignalSemaphoreEXT(m_glSemaphore, 0, nullptr, 0, nullptr, nullptr);
+            glFlush();
+        }
 
-        glFinish();
+        CHECK_HRCMD(m_pvrSubmissionFence->SetEventOnCompletion(m_fenceValue, m_fenceEvent.get()));
+        WaitForSingleObject(m_fenceEvent.get(), INFINITE);
     }
 
     // Serialize commands from the OpenGL context to the D3D11 context used by PVR.
@@ -24,6 +24,8 @@
 
 // Standard library.
 #include <algorithm>
+#include <array>
+#include <atomic>
 #include <cctype>
 #include <chrono>
 #include <condition_variable>
@@ -65,7 +67,7 @@ using Microsoft::WRL::ComPtr;
 #include <d3d11_4.h>
 #include <d3d12.h>
 #include <dxgi1_2.h>
-#include <d3dcompiler.h>
+#include <dxgi1_5.h>
 #define VK_USE_PLATFORM_WIN32_KHR
 #include <vulkan/vulkan.h>
 #include <GL/GL.h>
@@ -51,10 +51,7 @@ namespace pimax_openxr {
             return XR_ERROR_HANDLE_INVALID;
         }
 
-        double pvrTime = (double)performanceCounter->QuadPart / m_qpcFrequency.QuadPart;
-        pvrTime += m_pvrTimeFromQpcTimeOffset;
-
-        *time = pvrTimeToXrTime(pvrTime);
+        *time = qpcTimeToXrTime(performanceCounter->QuadPart);
 
         TraceLoggingWrite(g_traceProvider, "xrConvertWin32PerformanceCounterToTimeKHR", TLArg(*time, "Time"));
 
@@ -82,10 +79,7 @@ namespace pimax_openxr {
             return XR_ERROR_TIME_INVALID;
         }
 
-        double pvrTime = xrTimeToPvrTime(time);
-        pvrTime -= m_pvrTimeFromQpcTimeOffset;
-
-        performanceCounter->QuadPart = (LONGLONG)(pvrTime * m_qpcFrequency.QuadPart);
+        performanceCounter->QuadPart = xrTimeToQpcTime(time);
 
         TraceLoggingWrite(g_traceProvider,
                           "xrConvertTimeToWin32PerformanceCounterKHR",
@@ -94,4 +88,166 @@ namespace pimax_openxr {
         return XR_SUCCESS;
     }
 
+    // Sample the PVR clock against QPC, then fit the offset and skew of the PVR clock over the recent samples.
+    void OpenXrRuntime::calibrateTimeConversion() {
+        // Keep the sample with the narrowest QPC window around the read of the PVR clock. The wider ones were likely
+        // preempted.
+        int64_t bestWindow = INT64_MAX;
+        int64_t sampleQpc = 0;
+        XrTime sampleTime = 0;
+        for (int i = 0; i < 16; i++) {
+            LARGE_INTEGER before, after;
+            QueryPerformanceCounter(&before);
+            const double pvrTime = pvr_getTimeSeconds(m_pvr);
+            QueryPerformanceCounter(&after);
+            const int64_t window = after.QuadPart - before.QuadPart;
+            if (window < bestWindow) {
+                bestWindow = window;
+                sampleQpc = before.QuadPart + window / 2;
+                sampleTime = pvrTimeToXrTime(pvrTime);
+            }
+        }
+        m_timeCalibrationHistory.push_back({sampleQpc, sampleTime});
+        while (m_timeCalibrationHistory.size() > k_timeCalibrationSamples) {
+            m_timeCalibrationHistory.pop_front();
+        }
+
+        // Least-squares fit of the PVR time against the QPC time, relative to the latest sample to preserve precision.
+        const double frequency = (double)m_qpcFrequency.QuadPart;
+        const auto toPoint = [&](const std::pair<int64_t, XrTime>& sample) -> std::pair<double, double> {
+            return {(sample.first - sampleQpc) / frequency, (double)(sample.second - sampleTime)};
+        };
+        std::vector<bool> isInlier(m_timeCalibrationHistory.size(), true);
+        double slope = 1e9;
+        double intercept = 0;
+        const auto fit = [&]() {
+            double count = 0, sumX = 0, sumY = 0, sumXX = 0, sumXY = 0;
+            for (size_t i = 0; i < m_timeCalibrationHistory.size(); i++) {
+                if (!isInlier[i]) {
+                    continue;
+                }
+                const auto [x, y] = toPoint(m_timeCalibrationHistory[i]);
+                count++;
+                sumX += x;
+                sumY += y;
+                sumXX += x * x;
+                sumXY += x * y;
+            }
+            const double denominator = count * sumXX - sumX * sumX;
+            if (count >= 2 && denominator > 0) {
+                slope = (count * sumXY - sumX * sumY) / denominator;
+                intercept = (sumY - slope * sumX) / count;
+            } else {
+                slope = 1e9;
+                intercept = 0;
+            }
+        };
+        fit();
+
+        // Reject the samples far off the fit (eg: PVR clock reads delayed by the service), then fit again.
+        if (m_timeCalibrationHistory.size() > 2) {
+            std::vector<double> residuals;
+            for (const auto& sample : m_timeCalibrationHistory) {
+                const auto [x, y] = toPoint(sample);
+                residuals.push_back(std::abs(y - (slope * x + intercept)));
+            }
+            std::vector<double> sortedResiduals = residuals;
+            std::nth_element(
+                sortedResiduals.begin(), sortedResiduals.begin() + sortedResiduals.size() / 2, sortedResiduals.end());
+            const double threshold = std::max(3 * sortedResiduals[sortedResiduals.size() / 2], 1000.0);
+            for (size_t i = 0; i < residuals.size(); i++) {
+                isInlier[i] = residuals[i] <= threshold;
+            }
+            fit();
+        }
+
+        // Clocks do not drift by more than a few hundred ppm. Anything beyond is a bad fit.
+        TimeCalibration calibration;
+        calibration.baseQpc = sampleQpc;
+        calibration.baseTime = sampleTime + (XrTime)std::round(intercept);
+        calibration.nanosecondsPerQpcSecond = (int64_t)std::round(std::clamp(slope, 1e9 - 1e6, 1e9 + 1e6));
+        calibration.qpcToTimeFraction =
+            ((uint64_t)calibration.nanosecondsPerQpcSecond << 32) / (uint64_t)m_qpcFrequency.QuadPart;
+        calibration.timeToQpcFraction =
+            ((uint64_t)m_qpcFrequency.QuadPart << 32) / (uint64_t)calibration.nanosecondsPerQpcSecond;
+
+        const uint32_t sequence = m_timeCalibrationSequence.load(std::memory_order_relaxed);
+        m_timeCalibrationSequence.store(sequence + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        m_timeCalibration = calibration;
+        m_timeCalibrationSequence.store(sequence + 2, std::memory_order_release);
+
+        TraceLoggingWrite(g_traceProvider,
+                          "ConvertTime",
+                          TLArg(calibration.baseQpc, "BaseQpc"),
+                          TLArg(calibration.baseTime, "BaseTime"),
+                          TLArg((calibration.nanosecondsPerQpcSecond - 1'000'000'000) / 1e3, "SkewPpm"),
+                          TLArg(std::count(isInlier.cbegin(), isInlier.cend(), true), "Inliers"),
+                          TLArg(bestWindow, "SampleWindow"));
+    }
+
+    void OpenXrRuntime::startTimeCalibrationThread() {
+        m_stopTimeCalibrationThread = false;
+        m_timeCalibrationThread = std::thread([&]() {
+            TraceLoggingWrite(g_traceProvider, "TimeCalibrationThread", TLArg("Started", "State"));
+
+            std::unique_lock lock(m_timeCalibrationLock);
+            while (!m_timeCalibrationCondVar.wait_for(
+                lock, k_timeCalibrationPeriod, [&]() { return m_stopTimeCalibrationThread; })) {
+                calibrateTimeConversion();
+            }
+
+            TraceLoggingWrite(g_traceProvider, "TimeCalibrationThread", TLArg("Stopped", "State"));
+        });
+    }
+
+    void OpenXrRuntime::stopTimeCalibrationThread() {
+        if (!m_timeCalibrationThread.joinable()) {
+            return;
+        }
+
+        {
+            std::unique_lock lock(m_timeCalibrationLock);
+            m_stopTimeCalibrationThread = true;
+            m_timeCalibrationCondVar.notify_all();
+        }
+        m_timeCalibrationThread.join();
+    }
+
+    OpenXrRuntime::TimeCalibration OpenXrRuntime::getTimeCalibration() const {
+        while (true) {
+            const uint32_t sequence = m_timeCalibrationSequence.load(std::memory_order_acquire);
+            if (sequence & 1) {
+                continue;
+            }
+            const TimeCalibration calibration = m_timeCalibration;
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (m_timeCalibrationSequence.load(std::memory_order_relaxed) == sequence) {
+                return calibration;
+            }
+        }
+    }
+
+    // The conversions split the interval from the base of the calibration into whole seconds and a remainder, so that
+    // the 64-bit products cannot overflow.
+    XrTime OpenXrRuntime::qpcTimeToXrTime(int64_t qpcTime) const {
+        const TimeCalibration calibration = getTimeCalibration();
+        const uint64_t frequency = (uint64_t)m_qpcFrequency.QuadPart;
+        const int64_t delta = qpcTime - calibration.baseQpc;
+        const uint64_t magnitude = delta < 0 ? (uint64_t)-delta : (uint64_t)delta;
+        const uint64_t nanoseconds = (magnitude / frequency) * calibration.nanosecondsPerQpcSecond +
+                                     (((magnitude % frequency) * calibration.qpcToTimeFraction) >> 32);
+        return calibration.baseTime + (delta < 0 ? -(int64_t)nanoseconds : (int64_t)nanoseconds);
+    }
+
+    int64_t OpenXrRuntime::xrTimeToQpcTime(XrTime time) const {
+        const TimeCalibration calibration = getTimeCalibration();
+        const uint64_t nanosecondsPerSecond = (uint64_t)calibration.nanosecondsPerQpcSecond;
+        const int64_t delta = time - calibration.baseTime;
+        const uint64_t magnitude = delta < 0 ? (uint64_t)-delta : (uint64_t)delta;
+        const uint64_t ticks = (magnitude / nanosecondsPerSecond) * m_qpcFrequency.QuadPart +
+                               (((magnitude % nanosecondsPerSecond) * calibration.timeToQpcFraction) >> 32);
+        return calibration.baseQpc + (delta < 0 ? -(int64_t)ticks : (int64_t)ticks);
+    }
+
 } // namespace pimax_openxr
@@ -0,0 +1,145 @@
+// MIT License
+//
+// Copyright(c) 2022-2023 Matthieu Bucchianeri
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this softwareand associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright noticeand this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+#include "pch.h"
+
+#include "log.h"
+#include "perf_stats.h"
+
+namespace {
+
+    wil::unique_handle g_sharedStatsMapping;
+    const LARGE_INTEGER g_qpcFrequency = []() {
+        LARGE_INTEGER frequency;
+        QueryPerformanceFrequency(&frequency);
+        return frequency;
+    }();
+
+    // Counters are updated without ordering: readers only need eventually consistent values.
+    void record(pimax_openxr::stats::Counters& counters, uint64_t durationUs) {
+        // The bucket is the number of significant bits of the duration.
+        uint32_t bucket = 0;
+        for (uint64_t value = durationUs; value; value >>= 1) {
+            bucket++;
+        }
+
+        InterlockedIncrementNoFence64(&counters.count);
+        InterlockedExchangeAddNoFence64(&counters.totalUs, (LONG64)durationUs);
+        InterlockedIncrementNoFence64(
+            &counters.histogram[std::min(bucket, pimax_openxr::stats::k_histogramBuckets - 1)]);
+    }
+
+} // namespace
+
+namespace pimax_openxr::stats {
+
+    using namespace pimax_openxr::log;
+
+    SharedStats* g_sharedStats = nullptr;
+
+    void InitializeStats(const char* const* apiNames, uint32_t apiCount) {
+        if (g_sharedStats) {
+            return;
+        }
+
+        *g_sharedStatsMapping.put() = CreateFileMappingW(
+            INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE, 0, sizeof(SharedStats), k_sharedStatsName);
+        if (!g_sharedStatsMapping) {
+            Log("Failed to create the performance statistics block: %d\n", GetLastError());
+            return;
+        }
+
+        // The view is intentionally never unmapped, since the dispatch layer may record until the DLL is unloaded.
+        auto stats = reinterpret_cast<SharedStats*>(
+            MapViewOfFile(g_sharedStatsMapping.get(), FILE_MAP_WRITE, 0, 0, sizeof(SharedStats)));
+        if (!stats) {
+            Log("Failed to map the performance statistics block: %d\n", GetLastError());
+            g_sharedStatsMapping.reset();
+            return;
+        }
+
+        // The block may be left over from a previous session of a reader keeping it open.
+        ZeroMemory(stats, sizeof(SharedStats));
+        stats->apiCount = std::min(apiCount, k_maxApis);
+        for (uint32_t i = 0; i < stats->apiCount; i++) {
+            strncpy_s(stats->apiNames[i], apiNames[i], _TRUNCATE);
+        }
+        stats->histogramBuckets = k_histogramBuckets;
+        stats->phaseCount = (uint32_t)FramePhase::Count;
+        stats->latencyCount = (uint32_t)FrameLatency::Count;
+        stats->version = k_sharedStatsVersion;
+
+        g_sharedStats = stats;
+    }
+
+    void RecordApiCall(uint32_t apiIndex, uint64_t durationUs) {
+        if (g_sharedStats && apiIndex < g_sharedStats->apiCount) {
+            record(g_sharedStats->apis[apiIndex], durationUs);
+        }
+    }
+
+    void RecordFramePhase(FramePhase phase, uint64_t durationUs) {
+        if (g_sharedStats) {
+            record(g_sharedStats->phases[(uint32_t)phase], durationUs);
+        }
+    }
+
+    void RecordFrameLatency(FrameLatency latency, uint64_t durationUs) {
+        if (g_sharedStats) {
+            record(g_sharedStats->latencies[(uint32_t)latency], durationUs);
+        }
+    }
+
+    uint64_t ElapsedUs(const LARGE_INTEGER& start) {
+        LARGE_INTEGER now;
+        QueryPerformanceCounter(&now);
+        return (uint64_t)((now.QuadPart - start.QuadPart) * 1000000 / g_qpcFrequency.QuadPart);
+    }
+
+    void LatencyDistribution::reset() {
+        *this = {};
+    }
+
+    void LatencyDistribution::record(uint64_t latencyUs) {
+        m_count++;
+        m_totalUs += latencyUs;
+        m_maxUs = std::max(m_maxUs, latencyUs);
+        m_histogram[std::min(latencyUs / k_bucketUs, (uint64_t)k_buckets - 1)]++;
+    }
+
+    double LatencyDistribution::meanUs() const {
+        return m_count ? (double)m_totalUs / m_count : 0.0;
+    }
+
+    // The upper bound of the bucket holding the percentile.
+    uint64_t LatencyDistribution::percentileUs(double percentile) const {
+        const uint64_t rank = (uint64_t)std::ceil(m_count * percentile / 100.0);
+        uint64_t cumulated = 0;
+        for (uint32_t i = 0; i < k_buckets; i++) {
+            cumulated += m_histogram[i];
+            if (cumulated >= rank && cumulated) {
+                return std::min((i + 1) * k_bucketUs, m_maxUs);
+            }
+        }
+        return m_maxUs;
+    }
+
+} // namespace pimax_openxr::stats
@@ -0,0 +1,135 @@
+// MIT License
+//
+// Copyright(c) 2022-2023 Matthieu Bucchianeri
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this softwareand associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright noticeand this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+#pragma once
+
+#include "pch.h"
+
+namespace pimax_openxr::stats {
+
+    // Layout of the shared memory block holding the always-on performance counters, for the companion app or external
+    // tools to read live. Latencies are in microseconds. Bucket 0 of the histograms counts the samples under 1us, and
+    // bucket i counts the samples in [2^(i-1), 2^i) microseconds. The last bucket counts all longer samples.
+    static constexpr wchar_t k_sharedStatsName[] = L"PimaxXR_PerfStats";
+    static constexpr uint32_t k_sharedStatsVersion = 2;
+    static constexpr uint32_t k_maxApis = 128;
+    static constexpr uint32_t k_maxApiNameLength = 64;
+    static constexpr uint32_t k_histogramBuckets = 24;
+
+    struct Counters {
+        volatile LONG64 count;
+        volatile LONG64 totalUs;
+        volatile LONG64 histogram[k_histogramBuckets];
+    };
+
+    enum class FramePhase : uint32_t {
+        WaitToBegin = 0,
+        BeginToEnd,
+        PvrEndFrame,
+        PrecompositionGpu,
+
+        Count
+    };
+
+    // Per-frame latencies: app = xrWaitFrame() return to xrEndFrame() entry, pose-to-display = first pose query (or
+    // xrWaitFrame() return) to the display time predicted by PVR, submit-to-display = pvr_endFrame() return to the
+    // display time.
+    enum class FrameLatency : uint32_t {
+        App = 0,
+        PoseToDisplay,
+        SubmitToDisplay,
+
+        Count
+    };
+    static constexpr const char* k_frameLatencyNames[] = {"App", "Pose-to-display", "Submit-to-display"};
+    static_assert(ARRAYSIZE(k_frameLatencyNames) == (uint32_t)FrameLatency::Count);
+
+    struct SharedStats {
+        uint32_t version;
+        uint32_t apiCount;
+        uint32_t histogramBuckets;
+        uint32_t phaseCount;
+        uint32_t latencyCount;
+        char apiNames[k_maxApis][k_maxApiNameLength];
+        Counters apis[k_maxApis];
+        Counters phases[(uint32_t)FramePhase::Count];
+        Counters latencies[(uint32_t)FrameLatency::Count];
+    };
+
+    // Null until InitializeStats() is called, in which case nothing is recorded.
+    extern SharedStats* g_sharedStats;
+
+    // Create the shared memory block.
+    void InitializeStats(const char* const* apiNames, uint32_t apiCount);
+
+    void RecordApiCall(uint32_t apiIndex, uint64_t durationUs);
+    void RecordFramePhase(FramePhase phase, uint64_t durationUs);
+    void RecordFrameLatency(FrameLatency latency, uint64_t durationUs);
+
+    uint64_t ElapsedUs(const LARGE_INTEGER& start);
+
+    // Record the duration of the scope of an API call.
+    class ApiCallTimer {
+      public:
+        explicit ApiCallTimer(uint32_t apiIndex) : m_apiIndex(apiIndex) {
+            if (g_sharedStats) {
+                QueryPerformanceCounter(&m_start);
+            }
+        }
+
+        ~ApiCallTimer() {
+            if (g_sharedStats) {
+                RecordApiCall(m_apiIndex, ElapsedUs(m_start));
+            }
+        }
+
+      private:
+        const uint32_t m_apiIndex;
+        LARGE_INTEGER m_start{};
+    };
+
+    // Finer distribution of a latency over a session, for the summary in the log. Latencies are bucketed by 100us up
+    // to 100ms.
+    class LatencyDistribution {
+      public:
+        void reset();
+        void record(uint64_t latencyUs);
+
+        uint64_t count() const {
+            return m_count;
+        }
+        double meanUs() const;
+        uint64_t maxUs() const {
+            return m_maxUs;
+        }
+        uint64_t percentileUs(double percentile) const;
+
+      private:
+        static constexpr uint64_t k_bucketUs = 100;
+        static constexpr uint32_t k_buckets = 1000;
+
+        uint64_t m_count{0};
+        uint64_t m_totalUs{0};
+        uint64_t m_maxUs{0};
+        uint32_t m_histogram[k_buckets]{};
+    };
+
+} // namespace pimax_openxr::stats
@@ -25,6 +25,7 @@
 #include "framework/dispatch.gen.h"
 
 #include "appinsights.h"
+#include "perf_stats.h"
 #include "utils.h"
 
 namespace pimax_openxr {
@@ -87,6 +88,9 @@ namespace pimax_openxr {
                                      const XrActionSpaceCreateInfo* createInfo,
                                      XrSpace* space) override;
         XrResult xrLocateSpace(XrSpace space, XrSpace baseSpace, XrTime time, XrSpaceLocation* location) override;
+        XrResult xrLocateSpacesKHR(XrSession session,
+                                   const XrSpacesLocateInfoKHR* locateInfo,
+                                   XrSpaceLocationsKHR* spaceLocations) override;
         XrResult xrDestroySpace(XrSpace space) override;
         XrResult xrEnumerateViewConfigurations(XrInstance instance,
                                                XrSystemId systemId,
@@ -103,6 +107,9 @@ namespace pimax_openxr {
                                                    uint32_t viewCapacityInput,
                                                    uint32_t* viewCountOutput,
                                                    XrViewConfigurationView* views) override;
+        XrResult xrGetRecommendedLayerResolutionMETA(XrSession session,
+                                                     const XrRecommendedLayerResolutionGetInfoMETA* info,
+                                                     XrRecommendedLayerResolutionMETA* resolution) override;
         XrResult xrEnumerateSwapchainFormats(XrSession session,
                                              uint32_t formatCapacityInput,
                                              uint32_t* formatCountOutput,
@@ -251,6 +258,51 @@ namespace pimax_openxr {
             MicrosoftMotionController,
         };
 
+        enum class FrameTimePredictorType {
+            Median,
+            Adaptive,
+        };
+
+        enum class DepthSubmission {
+            // Only when PVR's reprojection is enabled.
+            Auto,
+            Always,
+            Never,
+        };
+
+        // The settings that can be changed while a session is running. A new snapshot is parsed by refreshSettings()
+        // whenever the registry changes, and published atomically. Snapshots are immutable, so that they can be read
+        // from any thread without locking.
+        struct RuntimeSettings {
+            float joystickDeadzone{0.02f};
+            bool swapGripAimPoses{false};
+            std::optional<ForcedInteractionProfile> forcedInteractionProfile;
+            float guardianThreshold{1.1f};
+            float guardianRadius{1.6f};
+            XrPosef controllerAimOffset{Pose::Identity()};
+            XrPosef controllerGripOffset{Pose::Identity()};
+            XrPosef controllerHandOffset{Pose::Identity()};
+            int64_t frameTimeOverrideOffsetUs{0};
+            // Percentage of the frame duration, or 0 to predict the frame time.
+            int frameTimeOverrideMultiplier{0};
+            size_t frameTimeFilterLength{5};
+            FrameTimePredictorType frameTimePredictorType{FrameTimePredictorType::Median};
+            bool useMirrorWindow{false};
+            bool useMirrorTexture{false};
+            DepthSubmission depthSubmission{DepthSubmission::Auto};
+        };
+
+        // Conversion between QPC and XrTime in 64-bit fixed-point.
+        struct TimeCalibration {
+            int64_t baseQpc{0};
+            XrTime baseTime{0};
+            // Nanoseconds of PVR time per second of QPC time.
+            int64_t nanosecondsPerQpcSecond{1'000'000'000};
+            // The sub-second conversion factors, in 32.32 fixed-point.
+            uint64_t qpcToTimeFraction{0};
+            uint64_t timeToQpcFraction{0};
+        };
+
         struct Extension {
             const char* extensionName;
             uint32_t extensionVersion;
@@ -270,6 +322,11 @@ namespace pimax_openxr {
             int lastWaitedIndex{-1};
             int lastReleasedIndex{-1};
 
+            // A counter incremented with every released image, and the value of that counter for the content held by
+            // each PVR swapchain image of each slice (0 when unknown). Used to skip redundant copies.
+            uint64_t releasedVersion{0};
+            std::vector<std::vector<uint64_t>> slicesVersion;
+
             // Whether a static image swapchain has been acquired at least once.
             bool frozen{false};
 
@@ -282,17 +339,30 @@ namespace pimax_openxr {
             // Resources needed to resolve MSAA and/or format conversion or alpha correction.
             int lastProcessedIndex{-1};
             bool needDownsample{false};
+            ComPtr<ID3D11Texture2D> downsampled;
+            std::vector<ComPtr<ID3D11ShaderResourceView>> downsampledResourceView;
             std::vector<std::vector<ComPtr<ID3D11ShaderResourceView>>> imagesResourceView;
+            std::vector<ComPtr<ID3D11ShaderResourceView>> imagesStereoResourceView;
+            std::vector<std::vector<ComPtr<ID3D11ShaderResourceView>>> imagesRawResourceView;
             ComPtr<ID3D11Texture2D> resolved;
             ComPtr<ID3D11Buffer> convertConstants;
             ComPtr<ID3D11UnorderedAccessView> convertAccessView;
 
+            // When the PVR textures are only written by the runtime, and their format allows it, the compute shaders
+            // write directly into them without going through the resolved texture.
+            bool canWriteDirectly{false};
+            std::vector<std::vector<ComPtr<ID3D11UnorderedAccessView>>> slicesAccessView;
+
             // Resources needed for interop.
             std::vector<ComPtr<ID3D11Texture2D>> d3d11Images;
             std::vector<ComPtr<ID3D12Resource>> d3d12Images;
+            ComPtr<ID3D12CommandAllocator> d3d12CommandAllocator;
+            std::vector<ComPtr<ID3D12GraphicsCommandList>> d3d12AcquireCommandLists;
+            std::vector<ComPtr<ID3D12GraphicsCommandList>> d3d12ReleaseCommandLists;
             std::vector<VkDeviceMemory> vkDeviceMemory;
             std::vector<VkImage> vkImages;
-            VkCommandBuffer vkCmdBuffer{VK_NULL_HANDLE};
+            std::vector<VkCommandBuffer> vkAcquireCmdBuffers;
+            std::vector<VkCommandBuffer> vkReleaseCmdBuffers;
             std::vector<GLuint> glMemory;
             std::vector<GLuint> glImages;
 
@@ -300,14 +370,23 @@ namespace pimax_openxr {
             XrSwapchainCreateInfo xrDesc;
             DXGI_FORMAT dxgiFormatForSubmission{DXGI_FORMAT_UNKNOWN};
             pvrTextureSwapChainDesc pvrDesc;
+            uint64_t memorySize{0};
         };
 
         struct Space {
             // Information recorded at creation.
             XrReferenceSpaceType referenceType;
-            XrAction action{XR_NULL_HANDLE};
+            const Action* action{nullptr};
             XrPath subActionPath{XR_NULL_PATH};
             XrPosef poseInSpace;
+
+            // For action spaces, the controller (or 2 for the eye gaze) and the offset (including poseInSpace) to use.
+            // Resolved by resolveActionSpace() whenever the bindings change.
+            struct Binding {
+                int poseSide{-1};
+                XrPosef poseOffset{Pose::Identity()};
+            };
+            Published<Binding> binding;
         };
 
         struct ActionSource {
@@ -322,14 +401,61 @@ namespace pimax_openxr {
             std::string realPath;
         };
 
+        struct InputSnapshot {
+            pvrInputState state{};
+
+            // The actionsets using this snapshot (only touched by the app thread syncing the actions), and the queries
+            // currently reading it (from any thread).
+            uint32_t references{0};
+            std::atomic<uint32_t> readers{0};
+        };
+
         struct ActionSet {
             std::string name;
             std::string localizedName;
 
             std::set<XrPath> subactionPaths;
 
-            // A copy of the input state. This is to handle when xrSyncActions() does not update all actionsets at once.
-            pvrInputState cachedInputState;
+            // The input snapshot from the last xrSyncActions() of this actionset. This is to handle when
+            // xrSyncActions() does not update all actionsets at once. Null until the first sync.
+            std::atomic<InputSnapshot*> inputSnapshot{nullptr};
+        };
+
+        // Holds on to the input snapshot of an actionset for the duration of a query, so it is not reused meanwhile.
+        class InputSnapshotReader {
+          public:
+            explicit InputSnapshotReader(const ActionSet& xrActionSet) {
+                // The snapshot may be released and reused between loading it and registering as a reader, in which
+                // case the actionset no longer points to it.
+                InputSnapshot* snapshot = xrActionSet.inputSnapshot.load();
+                while (snapshot) {
+                    snapshot->readers++;
+                    InputSnapshot* const current = xrActionSet.inputSnapshot.load();
+                    if (current == snapshot) {
+                        break;
+                    }
+                    snapshot->readers--;
+                    snapshot = current;
+                }
+                m_snapshot = snapshot;
+            }
+
+            ~InputSnapshotReader() {
+                if (m_snapshot) {
+                    m_snapshot->readers--;
+                }
+            }
+
+            InputSnapshotReader(const InputSnapshotReader&) = delete;
+            InputSnapshotReader& operator=(const InputSnapshotReader&) = delete;
+
+            const pvrInputState& state() const {
+                static const pvrInputState empty{};
+                return m_snapshot ? m_snapshot->state : empty;
+            }
+
+          private:
+            InputSnapshot* m_snapshot{nullptr};
         };
 
         struct Action {
@@ -339,23 +465,133 @@ namespace pimax_openxr {
 
             XrActionSet actionSet{XR_NULL_HANDLE};
 
-            float lastFloatValue[2]{0.f, 0.f};
-            XrTime lastFloatValueChangedTime[2]{0, 0};
+            // Updated by the xrGetActionState*() functions, which may be called from any thread.
+            std::atomic<float> lastFloatValue[2]{0.f, 0.f};
+            std::atomic<XrTime> lastFloatValueChangedTime[2]{0, 0};
 
-            XrVector2f lastVector2fValue[2]{{0.f, 0.f}, {0.f, 0.f}};
-            XrTime lastVector2fValueChangedTime[2]{0, 0};
+            std::atomic<XrVector2f> lastVector2fValue[2]{XrVector2f{0.f, 0.f}, XrVector2f{0.f, 0.f}};
+            std::atomic<XrTime> lastVector2fValueChangedTime[2]{0, 0};
 
-            bool lastBoolValue[2]{false, false};
-            XrTime lastBoolValueChangedTime[2]{0, 0};
+            std::atomic<bool> lastBoolValue[2]{false, false};
+            std::atomic<XrTime> lastBoolValueChangedTime[2]{0, 0};
 
             std::set<XrPath> subactionPaths;
-            std::map<std::string, ActionSource> actionSources;
+
+            // The bindings are published by rebindControllerActions() as a whole, so that the queries never observe
+            // them partially updated.
+            struct Bindings {
+                std::map<std::string, ActionSource> actionSources;
+
+                // The entries of actionSources for each hand, compiled so that the xrGetActionState*() functions do
+                // not need any string processing.
+                struct BoundSource {
+                    const std::string* path;
+                    const ActionSource* source;
+                };
+                std::vector<BoundSource> boundSources[2];
+                bool hasHapticOutput[2]{false, false};
+            };
+            Published<Bindings> bindings;
+
+            // The bindings being compiled by rebindControllerActions().
+            std::unique_ptr<Bindings> pendingBindings;
+
+            // Whether the action is bound to /user/eyes_ext/input/gaze_ext/pose. Resolved upon attaching.
+            bool hasEyeGazePose{false};
         };
 
         struct HandTracker {
             int side;
+
+            // The skeletal data from PVR, chained and converted to OpenXR joints relative to the hand pose. Cached per
+            // frame and motion range, like the device poses.
+            uint64_t generation{0};
+            pvrSkeletalMotionRange range{};
+            bool isActive{false};
+            PoseArraySoA<XR_HAND_JOINT_COUNT_EXT> joints;
+
+            // The last two sets of joints located, in the virtual space, to derive velocities.
+            struct {
+                XrTime time{0};
+                PoseArraySoA<XR_HAND_JOINT_COUNT_EXT> joints;
+            } history[2];
+        };
+
+        // A pose sampled by the pose sampler thread.
+        struct HistoricalPose {
+            uint64_t index{0};
+            uint64_t epoch{0};
+            double time{0};
+            pvrPoseStatef state{};
+        };
+
+        // Each projection view may commit one color and one depth image.
+        using CommittedSwapchainImages =
+            FixedSet<std::pair<pvrTextureSwapChain, uint32_t>, pvrMaxLayerCount * xr::StereoView::Count * 2>;
+
+        // The union of all the image rects submitted for a slice of a swapchain during a frame.
+        struct SwapchainRegion {
+            const Swapchain* swapchain;
+            uint32_t slice;
+            XrRect2Di rect;
+
+            // For the views of projection layers, the eye and FOV that the region is rendered for, otherwise -1.
+            int eye{-1};
+            XrFovf fov{};
+        };
+        using SwapchainRegions = FixedVector<SwapchainRegion, pvrMaxLayerCount * xr::StereoView::Count * 2>;
+
+        // A run of consecutive quad layers lying in the same plane relative to the headset, submitted as a single quad.
+        static constexpr uint32_t k_maxFlattenedLayers = 8; // Must match MAX_QUADS in FlattenQuadsCS.hlsl.
+        struct FlattenedLayers {
+            uint32_t firstLayer;
+            uint32_t layerCount;
+
+            // The flattened quad, relative to the view space, and the rectangle of each quad within it.
+            XrPosef pose;
+            XrExtent2Df size;
+            XrRect2Df rects[k_maxFlattenedLayers];
+            XrExtent2Di extent;
+        };
+        using FlattenedLayersList = FixedVector<FlattenedLayers, pvrMaxLayerCount / 2>;
+
+        // Storage reused across frames to construct the layers in xrEndFrame() without heap allocations.
+        struct FrameArena {
+            // One extra entry for the guardian.
+            pvrLayer_Union layersAllocator[pvrMaxLayerCount + 1];
+            FixedVector<pvrLayerHeader*, pvrMaxLayerCount> layers;
+            CommittedSwapchainImages committedSwapchainImages;
+            SwapchainRegions swapchainRegions;
+            FlattenedLayersList flattenedLayers;
+        };
+
+        // A PVR swapchain written by the runtime's own composition passes.
+        struct CompositionTarget {
+            pvrTextureSwapChain pvrSwapchain{nullptr};
+            std::vector<ID3D11Texture2D*> textures;
+            std::vector<ComPtr<ID3D11UnorderedAccessView>> accessViews;
+            pvrTextureSwapChainDesc pvrDesc{};
+        };
+
+        // The metadata published next to the shared mirror texture, for capture tools to consume.
+        // The texture is opened with ID3D11Device1::OpenSharedResourceByName(k_sharedMirrorTextureName) and guarded
+        // by a keyed mutex using key 0. frameIndex is incremented after each new frame is copied into the texture.
+        static constexpr wchar_t k_sharedMirrorTextureName[] = L"PimaxXR_MirrorTexture";
+        static constexpr wchar_t k_sharedMirrorInfoName[] = L"PimaxXR_MirrorInfo";
+        static constexpr uint32_t k_sharedMirrorInfoVersion = 1;
+        struct SharedMirrorInfo {
+            uint32_t version;
+            uint32_t width;
+            uint32_t height;
+            uint32_t format; // DXGI_FORMAT
+            volatile LONG64 frameIndex;
+            double displayTime; // In seconds, on the PVR clock.
         };
 
+        // GPU timers for the app's Vulkan and OpenGL devices, defined in the interop files.
+        class VulkanGpuTimer;
+        class OpenGLGpuTimer;
+
         // instance.cpp
         void initializeExtensionsTable();
         std::optional<int> getSetting(const std::string& value) const;
@@ -363,64 +599,139 @@ namespace pimax_openxr {
         // system.cpp
         void updateEyeInfo();
         void fillDisplayDeviceInfo();
+        bool isCantedReprojectionEnabled() const;
+
+        // perf_counter.cpp
+        void calibrateTimeConversion();
+        void startTimeCalibrationThread();
+        void stopTimeCalibrationThread();
+        TimeCalibration getTimeCalibration() const;
+        XrTime qpcTimeToXrTime(int64_t qpcTime) const;
+        int64_t xrTimeToQpcTime(XrTime time) const;
+
+        // swapchain.cpp
+        uint32_t getViewConfigurationViewCount(XrViewConfigurationType viewConfigurationType) const;
+        pvrSizei getRecommendedViewSize(uint32_t viewIndex, uint32_t viewCount) const;
+        void destroySwapchainResources(Swapchain& xrSwapchain);
+        void retireSwapchain(Swapchain& xrSwapchain);
+        void collectRetiredSwapchains(bool waitForAll = false);
+        Swapchain* reusePooledSwapchain(const XrSwapchainCreateInfo& createInfo);
+        bool recycleSwapchain(Swapchain& xrSwapchain);
+        void flushSwapchainPool();
 
         // session.cpp
         void updateSessionState(bool forceSendEvent = false);
         void refreshSettings();
+        const RuntimeSettings& currentSettings() const {
+            return *m_settings.load(std::memory_order_acquire);
+        }
+        void startGuardianInitialization();
         void initializeGuardianResources();
+        void createGuardianSwapchain();
+        void stopGuardianInitialization();
 
         // action.cpp
         void rebindControllerActions(int side);
-        std::string getXrPath(XrPath path) const;
+        const std::string& getXrPath(XrPath path) const;
         int getActionSide(const std::string& fullPath, bool allowExtraPaths = false) const;
+        std::pair<int, int> getSubactionSideRange(XrPath subactionPath) const;
         XrVector2f handleJoystickDeadzone(pvrVector2f raw) const;
         void handleBuiltinActions(bool wasRecenteringPressed = false);
+        void updateInputSnapshot(const XrActionsSyncInfo& syncInfo);
+        void pollControllerTypes();
+        void startControllerWatcherThread();
+        void stopControllerWatcherThread();
+        void queueHapticPulse(int side, float amplitude);
+        void cancelHapticPulse(int side);
+        void startHapticsThread();
+        void stopHapticsThread();
 
         // mappings.cpp
         void initializeRemappingTables();
-        bool mapPathToViveControllerInputState(const Action& xrAction,
-                                               const std::string& path,
-                                               ActionSource& source) const;
-        bool mapPathToIndexControllerInputState(const Action& xrAction,
-                                                const std::string& path,
-                                                ActionSource& source) const;
-        bool mapPathToSimpleControllerInputState(const Action& xrAction,
-                                                 const std::string& path,
-                                                 ActionSource& source) const;
+        std::optional<size_t> findControllerMapping(const std::string& actualProfile,
+                                                    const std::string& preferredProfile) const;
+        bool mapBindingToInputState(
+            size_t mapping, int side, const Action& xrAction, XrPath binding, ActionSource& source) const;
         std::string getViveControllerLocalizedSourceName(const std::string& path) const;
         std::string getIndexControllerLocalizedSourceName(const std::string& path) const;
         std::string getSimpleControllerLocalizedSourceName(const std::string& path) const;
-        std::optional<std::string> remapSimpleControllerToViveController(const std::string& path) const;
-        std::optional<std::string> remapOculusTouchControllerToViveController(const std::string& path) const;
-        std::optional<std::string> remapMicrosoftMotionControllerToViveController(const std::string& path) const;
-        std::optional<std::string> remapSimpleControllerToIndexController(const std::string& path) const;
-        std::optional<std::string> remapOculusTouchControllerToIndexController(const std::string& path) const;
-        std::optional<std::string> remapMicrosoftMotionControllerToIndexController(const std::string& path) const;
-        std::optional<std::string> remapOculusTouchControllerToSimpleController(const std::string& path) const;
-        std::optional<std::string> remapMicrosoftMotionControllerToSimpleController(const std::string& path) const;
+
+        // hand_tracking.cpp
+        void updateHandJoints(HandTracker& xrHandTracker, pvrSkeletalMotionRange range) const;
 
         // space.cpp
         XrSpaceLocationFlags
         locateSpaceToOrigin(const Space& xrSpace, XrTime time, XrPosef& pose, XrSpaceVelocity* velocity) const;
         XrSpaceLocationFlags getHmdPose(XrTime time, XrPosef& pose, XrSpaceVelocity* velocity) const;
         XrSpaceLocationFlags getControllerPose(int side, XrTime time, XrPosef& pose, XrSpaceVelocity* velocity) const;
+        XrSpaceLocationFlags getEyeGazePose(XrTime time, XrPosef& pose, XrSpaceVelocity* velocity) const;
+        bool getEyeGaze(XrVector2f& gazeTan, XrTime* sampleTime = nullptr) const;
+        void getTrackedDevicePoseState(pvrTrackedDeviceType device, XrTime time, pvrPoseStatef& state) const;
+        void invalidatePoseCache();
+        void recenterTrackingOrigin();
+        void startPoseSamplerThread();
+        void stopPoseSamplerThread();
+        bool readPoseHistory(uint32_t deviceIndex, uint64_t index, HistoricalPose& sample) const;
+        bool getPoseFromHistory(uint32_t deviceIndex, double time, pvrPoseStatef& state) const;
+        void resolveActionSpace(Space& xrSpace) const;
+
+        // frame.cpp
+        void submitLayers(long long pvrFrameId,
+                          pvrLayerHeader* const* layers,
+                          unsigned int layerCount,
+                          size_t measuredFps,
+                          uint64_t lastPrecompositionTime);
+        void startSubmissionThread();
+        void stopSubmissionThread();
+        void waitForPendingSubmission();
+        void collectSwapchainRegions(const XrFrameEndInfo* frameEndInfo, SwapchainRegions& regions) const;
+        void planLayerFlattening(const XrFrameEndInfo* frameEndInfo, FlattenedLayersList& flattenedLayers);
+        void updateResolutionScale();
+        uint32_t getFramePacing() const;
+        void recordFrameLatency(long long pvrFrameId);
+
+        // display_refresh_rate.cpp
+        std::vector<float> getSupportedDisplayRefreshRates() const;
 
         // d3d11_native.cpp
         XrResult initializeD3D11(const XrGraphicsBindingD3D11KHR& d3dBindings);
         void cleanupD3D11();
         void initializeSubmissionDevice(const std::string& appGraphicsApi);
         void cleanupSubmissionDevice();
+        bool isUnorderedAccessSupported(DXGI_FORMAT format) const;
         std::vector<HANDLE> getSwapchainImages(Swapchain& xrSwapchain);
         XrResult getSwapchainImagesD3D11(Swapchain& xrSwapchain, XrSwapchainImageD3D11KHR* d3d11Images, uint32_t count);
         void prepareAndCommitSwapchainImage(Swapchain& xrSwapchain,
                                             uint32_t layerIndex,
                                             uint32_t slice,
                                             XrCompositionLayerFlags compositionFlags,
-                                            std::set<std::pair<pvrTextureSwapChain, uint32_t>>& committed) const;
+                                            const SwapchainRegions& regions,
+                                            CommittedSwapchainImages& committed);
+        ID3D11ShaderResourceView* getRawResourceView(Swapchain& xrSwapchain, uint32_t slice);
+        ID3D11UnorderedAccessView* acquireCompositionTarget(CompositionTarget& target,
+                                                            const Swapchain& formatSwapchain,
+                                                            uint32_t width,
+                                                            uint32_t height,
+                                                            const std::string& debugName);
+        pvrTextureSwapChain compositeFocusView(uint32_t eye,
+                                               const XrCompositionLayerProjectionView& contextView,
+                                               const XrCompositionLayerProjectionView& focusView,
+                                               uint32_t layerIndex,
+                                               XrCompositionLayerFlags compositionFlags);
+        pvrTextureSwapChain reprojectCantedView(uint32_t eye,
+                                                const XrCompositionLayerProjectionView& view,
+                                                uint32_t layerIndex,
+                                                XrCompositionLayerFlags compositionFlags);
+        pvrTextureSwapChain flattenQuadLayers(const XrFrameEndInfo* frameEndInfo,
+                                              const FlattenedLayers& flattenedLayers,
+                                              uint32_t index);
+        void destroyCompositionTargets();
         void flushD3D11Context();
         void flushSubmissionContext();
         void serializeD3D11Frame();
         void waitOnSubmissionDevice();
+        void enterSubmissionContextState();
+        void leaveSubmissionContextState();
 
         // d3d12_interop.cpp
         XrResult initializeD3D12(const XrGraphicsBindingD3D12KHR& d3dBindings);
@@ -428,6 +739,7 @@ namespace pimax_openxr {
         bool isD3D12Session() const;
         XrResult getSwapchainImagesD3D12(Swapchain& xrSwapchain, XrSwapchainImageD3D12KHR* d3d12Images, uint32_t count);
         void transitionImageD3D12(Swapchain& xrSwapchain, uint32_t index, bool acquire);
+        void submitPendingTransitionsD3D12();
         void flushD3D12CommandQueue();
         void serializeD3D12Frame();
 
@@ -437,7 +749,9 @@ namespace pimax_openxr {
         void cleanupVulkan();
         bool isVulkanSession() const;
         XrResult getSwapchainImagesVulkan(Swapchain& xrSwapchain, XrSwapchainImageVulkanKHR* vkImages, uint32_t count);
+        void recordTransitionsVulkan(Swapchain& xrSwapchain);
         void transitionImageVulkan(Swapchain& xrSwapchain, uint32_t index, bool acquire);
+        void submitVulkanCommands(const uint64_t* signalValue = nullptr);
         void flushVulkanCommandQueue();
         void serializeVulkanFrame();
 
@@ -451,6 +765,8 @@ namespace pimax_openxr {
         void serializeOpenGLFrame();
 
         // visibility_mask.cpp
+        void buildVisibilityMasks(uint32_t viewIndex);
+        bool updateTileMask(uint32_t eye, const XrFovf& fov, const XrExtent2Di& extent);
         void convertSteamVRToOpenXRHiddenMesh(const pvrFovPort& fov,
                                               XrVector2f* vertices,
                                               uint32_t* indices,
@@ -458,7 +774,11 @@ namespace pimax_openxr {
 
         // mirror_window.cpp
         void createMirrorWindow();
-        void updateMirrorWindow();
+        bool updateMirrorWindow();
+        UINT getMirrorWindowSwapchainFlags() const;
+        void createMirrorTexture();
+        void updateMirrorTexture(double displayTime);
+        void destroyMirrorTexture();
         LRESULT CALLBACK mirrorWindowProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam);
         friend LRESULT CALLBACK wndProcWrapper(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam);
 
@@ -473,23 +793,51 @@ namespace pimax_openxr {
         LUID m_adapterLuid{};
         float m_displayRefreshRate{0};
         double m_frameDuration{0};
+
+        // Refresh rates offered to the app, as integer fractions of the native refresh rate of the panel, and the
+        // pending XR_FB_display_refresh_rate events (from and to). The refresh rate is part of the frame timing state
+        // guarded by m_frameLock.
+        static constexpr uint32_t k_maxRefreshRateDivisor = 3;
+        static constexpr float k_minRefreshRate = 30.f;
+        uint32_t m_refreshRateDivisor{1};
+        std::deque<std::pair<float, float>> m_refreshRateChangedEvents;
+        std::mutex m_refreshRateChangedEventsLock;
         pvrHmdInfo m_cachedHmdInfo{};
         pvrEyeRenderInfo m_cachedEyeInfo[xr::StereoView::Count]{};
         float m_cantingAngle{0};
         float m_floorHeight{0.f};
         LARGE_INTEGER m_qpcFrequency{};
-        double m_pvrTimeFromQpcTimeOffset{0};
-        XrPath m_stringIndex{0};
-        std::map<XrPath, std::string> m_strings;
-        std::set<XrActionSet> m_actionSets;
-        std::set<XrAction> m_actions;
-        std::set<XrAction> m_actionsForCleanup;
-        std::set<XrHandTrackerEXT> m_handTrackers;
-        using MappingFunction = std::function<bool(const Action&, XrPath, ActionSource&)>;
+
+        // Conversion between QPC and XrTime, recalibrated periodically against the PVR clock to follow its offset and
+        // skew. A single writer bumps the sequence to odd while the calibration is updated.
+        static constexpr auto k_timeCalibrationPeriod = std::chrono::seconds(10);
+        static constexpr size_t k_timeCalibrationSamples = 30;
+        TimeCalibration m_timeCalibration;
+        std::atomic<uint32_t> m_timeCalibrationSequence{0};
+        std::deque<std::pair<int64_t, XrTime>> m_timeCalibrationHistory;
+        std::thread m_timeCalibrationThread;
+        std::mutex m_timeCalibrationLock;
+        std::condition_variable m_timeCalibrationCondVar;
+        bool m_stopTimeCalibrationThread{false};
+        PathTable m_strings;
+        XrPath m_handPaths[2]{XR_NULL_PATH, XR_NULL_PATH};
+        XrPath m_eyesPath{XR_NULL_PATH};
+        HandleTable<XrActionSet, ActionSet> m_actionSets;
+        HandleTable<XrAction, Action> m_actions;
+
+        // Serializes the changes of bindings (and the resolution of the action spaces). The queries do not take it.
+        std::mutex m_actionBindingsLock;
+        std::vector<Action*> m_actionsForCleanup;
+        HandleTable<XrHandTrackerEXT, HandTracker> m_handTrackers;
         using CheckValidPathFunction = std::function<bool(const std::string&)>;
-        std::map<std::pair<std::string, std::string>, MappingFunction> m_controllerMappingTable;
         std::map<std::string, CheckValidPathFunction> m_controllerValidPathsTable;
         wil::unique_registry_watcher m_registryWatcher;
+
+        // The current settings snapshot. Previous snapshots are retained until the instance is destroyed, since a
+        // reader may still be using them. Settings rarely change, so only a handful of snapshots ever exist.
+        std::atomic<const RuntimeSettings*> m_settings{nullptr};
+        std::vector<std::unique_ptr<const RuntimeSettings>> m_settingsSnapshots;
+        std::mutex m_settingsLock;
         bool m_loggedProductName{false};
         bool m_loggedResolution{false};
         std::string m_applicationName;
@@ -498,8 +846,17 @@ namespace pimax_openxr {
         ComPtr<ID3D11Device5> m_pvrSubmissionDevice;
         ComPtr<ID3D11DeviceContext4> m_pvrSubmissionContext;
         ComPtr<ID3D11Fence> m_pvrSubmissionFence;
-        ComPtr<ID3D11ComputeShader> m_depthConvertShader[2];
-        ComPtr<ID3D11ComputeShader> m_alphaCorrectShader[2];
+        ComPtr<ID3DDeviceContextState> m_submissionContextState;
+        ComPtr<ID3DDeviceContextState> m_savedAppContextState;
+        ComPtr<ID3D11ComputeShader> m_depthConvertShader[6];
+        ComPtr<ID3D11ComputeShader> m_alphaCorrectShader[3];
+        ComPtr<ID3D11ComputeShader> m_quadViewsShader;
+        ComPtr<ID3D11SamplerState> m_linearClampSampler;
+        ComPtr<ID3D11Buffer> m_quadViewsConstants[2];
+        ComPtr<ID3D11ComputeShader> m_flattenQuadsShader;
+        ComPtr<ID3D11Buffer> m_flattenQuadsConstants;
+        ComPtr<ID3D11ComputeShader> m_cantedReprojectionShader;
+        ComPtr<ID3D11Buffer> m_cantedReprojectionConstants;
         ComPtr<IDXGISwapChain1> m_dxgiSwapchain;
         bool m_sessionCreated{false};
         XrSessionState m_sessionState{XR_SESSION_STATE_UNKNOWN};
@@ -509,62 +866,138 @@ namespace pimax_openxr {
         bool m_sessionLossPending{false};
         bool m_sessionStopping{false};
         bool m_sessionExiting{false};
-        std::set<XrSwapchain> m_swapchains;
-        std::set<XrSpace> m_spaces;
+        HandleTable<XrSwapchain, Swapchain> m_swapchains;
+
+        // Swapchains destroyed by the application and kept for re-use, oldest first.
+        std::deque<Swapchain*> m_swapchainPool;
+        uint64_t m_swapchainPoolSize{0};
+        uint64_t m_swapchainPoolBudget{0};
+
+        // Swapchains destroyed by the application (or evicted from the pool), waiting for the GPU to be done with
+        // them. Each entry is tagged with the value of the shared fence signaled after its last use.
+        std::deque<std::pair<UINT64, Swapchain*>> m_retiredSwapchains;
+
+        HandleTable<XrSpace, Space> m_spaces;
         XrSpace m_originSpace{XR_NULL_HANDLE};
         XrSpace m_viewSpace{XR_NULL_HANDLE};
         bool m_useParallelProjection{false};
         XrFovf m_cachedEyeFov[xr::StereoView::Count];
-        float m_joystickDeadzone{0.f};
-        bool m_swapGripAimPoses{false};
+
+        // Parallel projection views reprojected by the runtime onto the canted views of the panels, so that the
+        // application only renders (and PVR only receives) the native canted resolution.
+        bool m_useCantedReprojection{false};
+        CompositionTarget m_cantedViewTargets[xr::StereoView::Count];
+        bool m_loggedCantedReprojectionFallback{false};
+
+        // Quad views, with the focus views following the context views.
+        static constexpr uint32_t k_quadViewCount = xr::StereoView::Count * 2;
+        XrViewConfigurationType m_primaryViewConfigurationType{XR_VIEW_CONFIGURATION_TYPE_PRIMARY_STEREO};
+        XrFovf m_cachedFocusFov[xr::StereoView::Count];
+        float m_focusFovScale{0.5f};
+        float m_peripheralDensity{0.5f};
+        CompositionTarget m_focusViewTargets[xr::StereoView::Count];
+        bool m_loggedFocusViewFallback{false};
+        bool m_useLayerFlattening{true};
+        CompositionTarget m_flattenedLayersTargets[pvrMaxLayerCount / 2];
         std::set<XrActionSet> m_activeActionSets;
         std::map<std::string, std::vector<XrActionSuggestedBinding>> m_suggestedBindings;
-        bool m_isControllerActive[2]{false, false};
+        std::atomic<bool> m_isControllerActive[2]{false, false};
         std::string m_cachedControllerType[2];
-        XrPosef m_controllerAimOffset;
-        XrPosef m_controllerGripOffset;
-        XrPosef m_controllerHandOffset;
         XrPosef m_controllerAimPose[2];
         XrPosef m_controllerGripPose[2];
         XrPosef m_controllerHandPose[2];
         std::string m_localizedControllerType[2];
         XrPath m_currentInteractionProfile[2]{XR_NULL_PATH, XR_NULL_PATH};
+        XrPath m_eyeGazeInteractionProfile{XR_NULL_PATH};
         bool m_currentInteractionProfileDirty{false};
-        std::optional<ForcedInteractionProfile> m_forcedInteractionProfile;
         std::optional<ForcedInteractionProfile> m_lastForcedInteractionProfile;
         std::optional<double> m_isRecenteringPressed;
-        int64_t m_frameTimeOverrideOffsetUs{0};
-        uint64_t m_frameTimeOverrideUs{0};
-        size_t m_frameTimeFilterLength{3};
-        std::deque<uint64_t> m_frameTimeFilter;
-        bool m_useMirrorWindow{false};
-        std::mutex m_mirrorWindowLock;
+
+        // Controller type detection. The types are polled on a background thread and published with a generation
+        // counter, so that xrSyncActions() only needs to look at them when they change.
+        std::thread m_controllerWatcherThread;
+        std::mutex m_controllerWatcherLock;
+        std::condition_variable m_controllerWatcherCondVar;
+        bool m_stopControllerWatcherThread{false};
+        std::string m_detectedControllerType[2];
+        std::atomic<uint64_t> m_controllerTypeGeneration{0};
+        uint64_t m_lastControllerTypeGeneration[2]{0, 0};
+        std::atomic<bool> m_controllerRebindRequested[2]{false, false};
+
+        // Haptics are sent to PVR from a worker thread, see queueHapticPulse().
+        std::thread m_hapticsThread;
+        FrameCounter m_hapticsRequests;
+        std::atomic<bool> m_stopHapticsThread{false};
+        std::atomic<uint64_t> m_pendingHapticPulse[2]{0, 0};
+        static constexpr size_t k_maxFrameTimeFilterLength = 32;
+        std::array<uint64_t, k_maxFrameTimeFilterLength> m_frameTimeFilter{};
+        size_t m_frameTimeFilterCount{0};
+        size_t m_frameTimeFilterIndex{0};
+        FrameTimePredictor m_frameTimePredictor;
+        int m_mirrorWindowRate{0};
+        bool m_mirrorWindowAllowTearing{false};
+        wil::unique_handle m_mirrorWindowNewFrame;
         HWND m_mirrorWindowHwnd{nullptr};
         bool m_mirrorWindowReady{false};
         std::thread m_mirrorWindowThread;
         ComPtr<IDXGISwapChain1> m_mirrorWindowSwapchain;
         pvrMirrorTexture m_pvrMirrorSwapChain{nullptr};
         ComPtr<ID3D11Texture2D> m_mirrorTexture;
+        pvrMirrorTexture m_pvrSharedMirrorSwapChain{nullptr};
+        ComPtr<ID3D11Texture2D> m_sharedMirrorSource;
+        ComPtr<ID3D11Texture2D> m_sharedMirrorTexture;
+        ComPtr<IDXGIKeyedMutex> m_sharedMirrorMutex;
+        wil::unique_handle m_sharedMirrorTextureHandle;
+        wil::unique_handle m_sharedMirrorInfoMapping;
+        wil::unique_mapview_ptr<SharedMirrorInfo> m_sharedMirrorInfo;
 
         // Synchronization. Locks must be acquired in this order.
+        // The frame lock serializes the PVR frame calls and the frame timing state. It is never held while waiting on
+        // the frame counters.
         std::mutex m_swapchainsLock;
         std::mutex m_frameLock;
 
-        // Guardian state.
+        // PVR is not thread-safe, and the app threads, the submission thread and our worker threads all call into it.
+        // Once a session exists, every call taking the PVR session is made under this lock, which is always the
+        // innermost lock and is held for the duration of the call only. The exception is pvr_waitToBeginFrame(), which
+        // blocks for up to a frame: xrWaitFrame() instead waits for the pending submission before calling it, and the
+        // frame lock keeps it apart from the other frame calls.
+        mutable std::mutex m_pvrLock;
+
+        // Asynchronous submission. When enabled, the submission thread owns the submission context between the
+        // hand-off in xrEndFrame() and the completion of the submission.
+        bool m_useAsyncSubmission{false};
+
+        // Single-device submission. When enabled, the D3D11 application device is also the submission device, and
+        // the runtime swaps in its own pipeline state around the precomposition work in xrEndFrame().
+        bool m_useSingleDeviceSubmission{false};
+        std::thread m_submissionThread;
+        std::mutex m_submissionLock;
+        std::condition_variable m_submissionCondVar;
+        bool m_submissionPending{false};
+        bool m_stopSubmissionThread{false};
+        std::exception_ptr m_submissionError;
+        struct {
+            long long frameId{0};
+            size_t measuredFps{0};
+            uint64_t lastPrecompositionTime{0};
+        } m_pendingSubmission;
+
+        // Guardian state. The texture is decoded and uploaded on a worker thread, then the frame loop copies it to a
+        // PVR swapchain once ready.
+        std::thread m_guardianThread;
+        std::atomic<bool> m_guardianReady{false};
+        ComPtr<ID3D11Texture2D> m_guardianTexture;
         pvrTextureSwapChain m_guardianSwapchain{nullptr};
         XrSpace m_guardianSpace{XR_NULL_HANDLE};
         XrExtent2Di m_guardianExtent{};
-        float m_guardianThreshold{1.1f};
-        float m_guardianRadius{1.6f};
 
         // Graphics API interop.
         ComPtr<ID3D11Device5> m_d3d11Device;
         ComPtr<ID3D11DeviceContext4> m_d3d11Context;
         ComPtr<ID3D12Device> m_d3d12Device;
         ComPtr<ID3D12CommandQueue> m_d3d12CommandQueue;
-        ComPtr<ID3D12CommandAllocator> m_d3d12CommandAllocator[2];
-        ComPtr<ID3D12GraphicsCommandList> m_d3d12CommandList[2];
-        uint32_t m_currentAllocatorIndex{0};
+        std::vector<ID3D12CommandList*> m_d3d12PendingTransitions;
         VkInstance m_vkBootstrapInstance{VK_NULL_HANDLE};
         VkPhysicalDevice m_vkBootstrapPhysicalDevice{VK_NULL_HANDLE};
         VkInstance m_vkInstance{VK_NULL_HANDLE};
@@ -598,6 +1031,11 @@ namespace pimax_openxr {
             PFN_vkImportSemaphoreWin32HandleKHR vkImportSemaphoreWin32HandleKHR{nullptr};
             PFN_vkWaitSemaphoresKHR vkWaitSemaphoresKHR{nullptr};
             PFN_vkDeviceWaitIdle vkDeviceWaitIdle{nullptr};
+            PFN_vkCreateQueryPool vkCreateQueryPool{nullptr};
+            PFN_vkDestroyQueryPool vkDestroyQueryPool{nullptr};
+            PFN_vkCmdResetQueryPool vkCmdResetQueryPool{nullptr};
+            PFN_vkCmdWriteTimestamp vkCmdWriteTimestamp{nullptr};
+            PFN_vkGetQueryPoolResults vkGetQueryPoolResults{nullptr};
         } m_vkDispatch;
         const VkAllocationCallbacks* m_vkAllocator{nullptr};
         VkPhysicalDevice m_vkPhysicalDevice{VK_NULL_HANDLE};
@@ -620,26 +1058,141 @@ namespace pimax_openxr {
             PFNGLSIGNALSEMAPHOREEXTPROC glSignalSemaphoreEXT{nullptr};
             PFNGLIMPORTMEMORYWIN32HANDLEEXTPROC glImportMemoryWin32HandleEXT{nullptr};
             PFNGLIMPORTSEMAPHOREWIN32HANDLEEXTPROC glImportSemaphoreWin32HandleEXT{nullptr};
+            PFNGLGENQUERIESPROC glGenQueries{nullptr};
+            PFNGLDELETEQUERIESPROC glDeleteQueries{nullptr};
+            PFNGLQUERYCOUNTERPROC glQueryCounter{nullptr};
+            PFNGLGETQUERYOBJECTIVPROC glGetQueryObjectiv{nullptr};
+            PFNGLGETQUERYOBJECTUI64VPROC glGetQueryObjectui64v{nullptr};
         } m_glDispatch;
 
         ComPtr<ID3D11Fence> m_d3d11Fence;
         ComPtr<ID3D12Fence> m_d3d12Fence;
         VkSemaphore m_vkTimelineSemaphore{VK_NULL_HANDLE};
+        std::vector<VkCommandBuffer> m_vkPendingTransitions;
         GLuint m_glSemaphore{0};
         UINT64 m_fenceValue{0};
+        wil::unique_handle m_fenceEvent;
 
         // Workaround: the AMD driver does not seem to like closing the handle for the shared fence when using
         // OpenGL. We keep it alive for the whole session.
         wil::shared_handle m_fenceHandleForAMDWorkaround;
 
         // Frame state.
-        std::condition_variable m_frameCondVar;
-        uint64_t m_frameWaited{0};
-        uint64_t m_frameBegun{0};
-        uint64_t m_frameCompleted{0};
+        // The frame counters implement the pacing between xrWaitFrame(), xrBeginFrame() and xrEndFrame().
+        FrameCounter m_frameWaited;
+        FrameCounter m_frameBegun;
+        FrameCounter m_frameCompleted;
         uint64_t m_lastCpuFrameTimeUs{0};
+        LARGE_INTEGER m_beginFrameTime{};
         uint64_t m_lastGpuFrameTimeUs{0};
+        FrameArena m_frameArena;
+
+        // Resolution recommendations, scaled down when the app GPU time exceeds the budget of the frame duration.
+        bool m_measureAppGpuTime{false};
+        float m_resolutionGpuBudget{0.9f};
+        float m_minResolutionScale{0.5f};
+        float m_resolutionScale{1.f};
+
+        // Application space warp.
+        bool m_useSpaceWarpHalfRate{false};
+        bool m_isSpaceWarpHalfRate{false};
+
+        // Whether the PVR configuration makes use of the depth buffers, polled periodically during xrBeginFrame().
+        bool m_isDepthConsumedByPvr{true};
+        double m_lastPvrConfigPollTime{0};
+        wil::unique_handle m_waitFrameTimer;
+
+        // Low-latency wake, delaying the return from xrWaitFrame() by the slack left by the app frame times in the
+        // previous frames, minus a safety margin that doubles upon every missed frame and slowly decays otherwise.
+        static constexpr double k_minWakeMargin = 0.002;
+        static constexpr size_t k_wakeFrameTimesLength = 10;
+        bool m_useLowLatencyWake{false};
+        double m_wakeMargin{k_minWakeMargin};
+        double m_lastFrameReadyTime{0};
+        std::deque<uint64_t> m_wakeFrameTimesUs;
+
+        // Pose cache, invalidated every frame.
+        struct CachedPoseState {
+            uint64_t generation{0};
+            XrTime time{0};
+            pvrPoseStatef state{};
+        };
+        static constexpr uint32_t k_poseCacheSize = 4;
+        mutable std::mutex m_poseCacheLock;
+        mutable CachedPoseState m_poseCache[3][k_poseCacheSize];
+        mutable uint32_t m_poseCacheNextEntry[3]{};
+        std::atomic<uint64_t> m_poseCacheGeneration{1};
+
+        // Eye gaze, sampled upon first use after each invalidation of the pose cache, so that all queries during a
+        // frame (action spaces and foveation) see the same and most recent sample.
+        static constexpr double k_eyeGazeMaxAge = 0.1;
+        bool m_isEyeTrackingAvailable{false};
+        bool m_useEyeTrackedFoveation{true};
+        mutable std::mutex m_eyeGazeLock;
+        mutable uint64_t m_eyeGazeGeneration{0};
+        mutable pvrEyeTrackingInfo m_eyeGazeInfo{};
+
+        // Views cache, sharing the invalidation of the pose cache.
+        struct CachedViews {
+            uint64_t generation{0};
+            XrSpace space{XR_NULL_HANDLE};
+            XrTime time{0};
+            XrViewStateFlags viewStateFlags{0};
+            XrPosef poses[xr::StereoView::Count];
+            XrFovf fovs[xr::StereoView::Count];
+        };
+        static constexpr uint32_t k_viewsCacheSize = 4;
+        std::mutex m_viewsCacheLock;
+        CachedViews m_viewsCache[k_viewsCacheSize];
+        uint32_t m_viewsCacheNextEntry{0};
+
+        // Visibility masks, indexed by view and by mask type, rebuilt when the eye info changes.
+        struct CachedVisibilityMask {
+            std::vector<XrVector2f> vertices;
+            std::vector<uint32_t> indices;
+        };
+        static constexpr uint32_t k_visibilityMaskSegments = 128;
+        std::mutex m_visibilityMaskLock;
+        CachedVisibilityMask m_visibilityMasks[xr::StereoView::Count][3];
+        bool m_visibilityMasksValid[xr::StereoView::Count]{};
+
+        // The hidden area mesh rasterized with one texel per 8x8 tile of the region of a view, so that our compute
+        // shaders can skip the tiles that are never visible. Both eyes share a texture array.
+        static constexpr uint32_t k_tileSize = 8; // Must match the thread group size of our compute shaders.
+        struct TileMask {
+            XrFovf fov{};
+            XrExtent2Di extent{};
+            std::vector<uint8_t> tiles;
+            bool hasHiddenTiles{false};
+            bool valid{false};
+        };
+        TileMask m_tileMasks[xr::StereoView::Count];
+        ComPtr<ID3D11Texture2D> m_tileMaskTexture;
+        ComPtr<ID3D11ShaderResourceView> m_tileMaskResourceView;
+        uint32_t m_visibilityMaskChangedViews{0};
+
+        // Pose history filled by the pose sampler thread. Each slot is guarded by a sequence counter, so that readers
+        // never block the sampler and simply retry with PVR when they observe a slot being written.
+        struct PoseHistorySlot {
+            std::atomic<uint32_t> sequence{0};
+            HistoricalPose pose;
+        };
+        static constexpr uint32_t k_poseHistorySize = 64;
+        static constexpr float k_maxPoseExtrapolation = 0.05f;
+        struct PoseHistory {
+            PoseHistorySlot samples[k_poseHistorySize];
+            std::atomic<uint64_t> count{0};
+        };
+        uint32_t m_poseSamplerRate{0};
+        std::thread m_poseSamplerThread;
+        std::atomic<bool> m_stopPoseSamplerThread{false};
+        PoseHistory m_poseHistory[3];
+        std::atomic<uint64_t> m_poseHistoryEpoch{0};
         pvrInputState m_cachedInputState;
+
+        // Copies of the input state shared by all the actionsets synced together. Entries are reused once neither an
+        // actionset nor a query from another thread (see InputSnapshotReader) references them. The entries never move.
+        std::vector<std::unique_ptr<InputSnapshot>> m_inputSnapshots;
         bool m_actionsSyncedThisFrame{false};
         XrTime m_lastPredictedDisplayTime{0};
 
@@ -648,10 +1201,25 @@ namespace pimax_openxr {
         double m_sessionStartTime{0.0};
         uint64_t m_sessionTotalFrameCount{0};
         std::deque<double> m_frameTimes;
+
+        // Timestamps of the frames in flight (in PVR time), indexed by frame ID, for the latency statistics. The first
+        // pose query is attributed to the frame last returned by xrWaitFrame().
+        struct FrameTimestamps {
+            double waitFrameReturn{0};
+            double firstPoseQuery{0};
+            double endFrameEntry{0};
+            double endFrameReturn{0};
+            double displayTime{0};
+            uint64_t precompositionGpuUs{0};
+        };
+        static constexpr uint32_t k_frameTimestampsCount = 4;
+        FrameTimestamps m_frameTimestamps[k_frameTimestampsCount];
+        mutable std::atomic<double> m_firstPoseQueryTime{0};
+        stats::LatencyDistribution m_frameLatencies[(uint32_t)stats::FrameLatency::Count];
         CpuTimer m_frameTimerApp;
         CpuTimer m_renderTimerApp;
         static constexpr uint32_t k_numGpuTimers = 3;
-        std::unique_ptr<GpuTimer> m_gpuTimerApp[k_numGpuTimers];
+        std::unique_ptr<ITimer> m_gpuTimerApp[k_numGpuTimers];
         std::unique_ptr<GpuTimer> m_gpuTimerPrecomposition[k_numGpuTimers];
         uint32_t m_currentTimerIndex{0};
 
@@ -23,6 +23,7 @@
 #include "pch.h"
 
 #include "log.h"
+#include "resource.h"
 #include "runtime.h"
 #include "utils.h"
 
@@ -135,11 +136,29 @@ namespace pimax_openxr {
 
         // Read configuration and set up the session accordingly.
         if (getSetting("recenter_on_startup").value_or(1)) {
-            CHECK_PVRCMD(pvr_recenterTrackingOrigin(m_pvrSession));
+            recenterTrackingOrigin();
         }
         refreshSettings();
+        // The application context cannot be used from the submission thread.
+        m_useAsyncSubmission = !m_useSingleDeviceSubmission && getSetting("async_submission").value_or(0);
+        m_poseSamplerRate = std::clamp(getSetting("pose_sampler_rate").value_or(0), 0, 2000);
+        m_swapchainPoolBudget =
+            (uint64_t)std::max(getSetting("swapchain_pool_budget_mb").value_or(256), 0) * 1024 * 1024;
+        m_resolutionGpuBudget = std::clamp(getSetting("resolution_gpu_budget_percent").value_or(90), 50, 100) / 100.f;
+        m_minResolutionScale = std::clamp(getSetting("resolution_min_percent").value_or(50), 10, 100) / 100.f;
+        m_resolutionScale = 1.f;
+        m_useLowLatencyWake = getSetting("low_latency_wake").value_or(0);
+        m_wakeMargin = k_minWakeMargin;
+        m_lastFrameReadyTime = 0;
+        m_wakeFrameTimesUs.clear();
+        m_measureAppGpuTime =
+            m_useFrameTimingOverride || has_XR_META_recommended_layer_resolution || m_useLowLatencyWake;
+        m_useSpaceWarpHalfRate = getSetting("space_warp_half_rate").value_or(0);
+        m_isSpaceWarpHalfRate = false;
+        m_useLayerFlattening = getSetting("layer_flattening").value_or(1);
 
         {
+            std::unique_lock pvrLock(m_pvrLock);
             const bool enableLighthouse = !!pvr_getIntConfig(m_pvrSession, "enable_lighthouse_tracking", 0);
             const int fovLevel = pvr_getIntConfig(m_pvrSession, "fov_level", 1);
 
@@ -152,6 +171,8 @@ namespace pimax_openxr {
                 TLArg(!!pvr_getIntConfig(m_pvrSession, "dbg_asw_enable", 0), "EnableSmartSmoothing"),
                 TLArg(pvr_getIntConfig(m_pvrSession, "dbg_force_framerate_divide_by", 1), "CompulsiveSmoothingRate"));
 
+            pvrLock.unlock();
+
             m_telemetry.logScenario(isD3D12Session()    ? "D3D12"
                                     : isVulkanSession() ? "Vulkan"
                                     : isOpenGLSession() ? "OpenGL"
@@ -167,20 +188,50 @@ namespace pimax_openxr {
         m_sessionState = XR_SESSION_STATE_IDLE;
         updateSessionState(true);
 
-        m_frameWaited = m_frameBegun = m_frameCompleted = 0;
+        m_frameWaited = 0;
+        m_frameBegun = 0;
+        m_frameCompleted = 0;
 
         m_frameTimes.clear();
+        for (auto& timestamps : m_frameTimestamps) {
+            timestamps = {};
+        }
+        m_firstPoseQueryTime = 0;
+        for (auto& latencies : m_frameLatencies) {
+            latencies.reset();
+        }
+        m_refreshRateDivisor = 1;
+        {
+            std::unique_lock lock(m_refreshRateChangedEventsLock);
+            m_refreshRateChangedEvents.clear();
+        }
 
         m_isControllerActive[0] = m_isControllerActive[1] = false;
         m_controllerAimPose[0] = m_controllerGripPose[0] = m_controllerHandPose[0] = m_controllerAimPose[1] =
             m_controllerGripPose[1] = m_controllerHandPose[1] = Pose::Identity();
         rebindControllerActions(0);
         rebindControllerActions(1);
+        m_eyeGazeInteractionProfile = XR_NULL_PATH;
+        for (const auto& action : m_actions) {
+            Action& xrAction = *m_actions.get(action);
+            xrAction.hasEyeGazePose = false;
+        }
         m_activeActionSets.clear();
 
         m_sessionStartTime = pvr_getTimeSeconds(m_pvr);
         m_sessionTotalFrameCount = 0;
 
+        if (m_useAsyncSubmission) {
+            LOG_TELEMETRY_ONCE(logFeature("AsyncSubmission"));
+            startSubmissionThread();
+        }
+        startControllerWatcherThread();
+        startHapticsThread();
+        if (m_poseSamplerRate) {
+            LOG_TELEMETRY_ONCE(logFeature("PoseSampler"));
+            startPoseSamplerThread();
+        }
+
         try {
             // Create a reference space with the origin and the HMD pose.
             {
@@ -196,6 +247,9 @@ namespace pimax_openxr {
                 CHECK_XRCMD(xrCreateReferenceSpace((XrSession)1, &spaceInfo, &m_viewSpace));
             }
         } catch (std::exception& exc) {
+            stopPoseSamplerThread();
+            stopHapticsThread();
+            stopControllerWatcherThread();
             m_sessionCreated = false;
             throw exc;
         }
@@ -215,6 +269,12 @@ namespace pimax_openxr {
             return XR_ERROR_HANDLE_INVALID;
         }
 
+        // Shutdown the submission thread before the resources it uses.
+        stopSubmissionThread();
+        stopControllerWatcherThread();
+        stopHapticsThread();
+        stopPoseSamplerThread();
+
         // Shutdown the mirror window.
         if (m_mirrorWindowThread.joinable()) {
             // Avoid race conditions where the window will not receive the message.
@@ -225,9 +285,22 @@ namespace pimax_openxr {
                 PostMessage(m_mirrorWindowHwnd, WM_CLOSE, 0, 0);
             }
             m_mirrorWindowThread.join();
+            m_mirrorWindowNewFrame.reset();
         }
+        destroyMirrorTexture();
 
         m_telemetry.logUsage(pvr_getTimeSeconds(m_pvr) - m_sessionStartTime, m_sessionTotalFrameCount);
+        for (uint32_t i = 0; i < (uint32_t)stats::FrameLatency::Count; i++) {
+            const auto& latencies = m_frameLatencies[i];
+            if (latencies.count()) {
+                Log("%s latency: mean %.1fms, median %.1fms, 99th percentile %.1fms, max %.1fms\n",
+                    stats::k_frameLatencyNames[i],
+                    latencies.meanUs() / 1e3,
+                    latencies.percentileUs(50) / 1e3,
+                    latencies.percentileUs(99) / 1e3,
+                    latencies.maxUs() / 1e3);
+            }
+        }
 
         // Destroy hand trackers (tied to session).
         while (m_handTrackers.size()) {
@@ -243,10 +316,16 @@ namespace pimax_openxr {
         while (m_swapchains.size()) {
             CHECK_XRCMD(xrDestroySwapchain(*m_swapchains.begin()));
         }
+        flushSwapchainPool();
+        collectRetiredSwapchains(true);
+        stopGuardianInitialization();
         if (m_guardianSwapchain) {
+            std::unique_lock pvrLock(m_pvrLock);
             pvr_destroyTextureSwapChain(m_pvrSession, m_guardianSwapchain);
             m_guardianSwapchain = nullptr;
         }
+        m_guardianSpace = XR_NULL_HANDLE;
+        destroyCompositionTargets();
 
         // We do not destroy actionsets and actions, since they are tied to the instance.
 
@@ -257,6 +336,10 @@ namespace pimax_openxr {
         cleanupD3D11();
         cleanupSubmissionDevice();
         m_handTrackers.clear();
+        {
+            std::unique_lock lock(m_visibilityMaskLock);
+            m_visibilityMaskChangedViews = 0;
+        }
         m_sessionState = XR_SESSION_STATE_UNKNOWN;
         m_sessionCreated = false;
         m_sessionBegun = false;
@@ -283,7 +366,7 @@ namespace pimax_openxr {
             return XR_ERROR_HANDLE_INVALID;
         }
 
-        if (beginInfo->primaryViewConfigurationType != XR_VIEW_CONFIGURATION_TYPE_PRIMARY_STEREO) {
+        if (!getViewConfigurationViewCount(beginInfo->primaryViewConfigurationType)) {
             return XR_ERROR_VIEW_CONFIGURATION_TYPE_UNSUPPORTED;
         }
 
@@ -295,6 +378,13 @@ namespace pimax_openxr {
             return XR_ERROR_SESSION_NOT_READY;
         }
 
+        m_primaryViewConfigurationType = beginInfo->primaryViewConfigurationType;
+        if (m_primaryViewConfigurationType == XR_VIEW_CONFIGURATION_TYPE_PRIMARY_QUAD_VARJO) {
+            LOG_TELEMETRY_ONCE(logFeature("QuadViews"));
+        }
+
+        startGuardianInitialization();
+
         m_sessionBegun = true;
         updateSessionState();
 
@@ -398,134 +488,99 @@ namespace pimax_openxr {
 
     // Read dynamic settings from the registry.
     void OpenXrRuntime::refreshSettings() {
+        // Read all the values in a single pass, rather than querying the registry for each setting.
+        const auto values = RegGetDwords(HKEY_LOCAL_MACHINE, RegPrefix);
+        const auto getValue = [&](const char* name, int defaultValue) {
+            const auto it = values.find(name);
+            return it != values.cend() ? it->second : defaultValue;
+        };
+
+        auto settings = std::make_unique<RuntimeSettings>();
+
         // Value is in unit of hundredth.
-        m_joystickDeadzone = getSetting("joystick_deadzone").value_or(2) / 100.f;
+        settings->joystickDeadzone = getValue("joystick_deadzone", 2) / 100.f;
 
-        m_swapGripAimPoses = getSetting("swap_grip_aim_poses").value_or(0);
-        const auto forcedInteractionProfile = getSetting("force_interaction_profile").value_or(0);
+        settings->swapGripAimPoses = getValue("swap_grip_aim_poses", 0);
+        const auto forcedInteractionProfile = getValue("force_interaction_profile", 0);
         if (forcedInteractionProfile == 1) {
-            m_forcedInteractionProfile = ForcedInteractionProfile::OculusTouchController;
+            settings->forcedInteractionProfile = ForcedInteractionProfile::OculusTouchController;
         } else if (forcedInteractionProfile == 2) {
-            m_forcedInteractionProfile = ForcedInteractionProfile::MicrosoftMotionController;
-        } else {
-            m_forcedInteractionProfile.reset();
+            settings->forcedInteractionProfile = ForcedInteractionProfile::MicrosoftMotionController;
         }
 
-        if (getSetting("guardian").value_or(1)) {
-            m_guardianThreshold = getSetting("guardian_threshold").value_or(1100) / 1e3f;
-            m_guardianRadius = getSetting("guardian_radius").value_or(1600) / 1e3f;
+        if (getValue("guardian", 1)) {
+            settings->guardianThreshold = getValue("guardian_threshold", 1100) / 1e3f;
+            settings->guardianRadius = getValue("guardian_radius", 1600) / 1e3f;
         } else {
-            m_guardianThreshold = INFINITY;
-        }
-
-        const auto oldControllerAimOffset = m_controllerAimOffset;
-        m_controllerAimOffset = Pose::MakePose(
-            Quaternion::RotationRollPitchYaw({PVR::DegreeToRad((float)getSetting("aim_pose_rot_x").value_or(0.f)),
-                                              PVR::DegreeToRad((float)getSetting("aim_pose_rot_y").value_or(0.f)),
-                                              PVR::DegreeToRad((float)getSetting("aim_pose_rot_z").value_or(0.f))}),
-            XrVector3f{getSetting("aim_pose_offset_x").value_or(0.f) / 1000.f,
-                       getSetting("aim_pose_offset_y").value_or(0.f) / 1000.f,
-                       getSetting("aim_pose_offset_z").value_or(0.f) / 1000.f});
-
-        const auto oldControllerGripOffset = m_controllerGripOffset;
-        m_controllerGripOffset = Pose::MakePose(
-            Quaternion::RotationRollPitchYaw({PVR::DegreeToRad((float)getSetting("grip_pose_rot_x").value_or(0.f)),
-                                              PVR::DegreeToRad((float)getSetting("grip_pose_rot_y").value_or(0.f)),
-                                              PVR::DegreeToRad((float)getSetting("grip_pose_rot_z").value_or(0.f))}),
-            XrVector3f{getSetting("grip_pose_offset_x").value_or(0) / 1000.f,
-                       getSetting("grip_pose_offset_y").value_or(0) / 1000.f,
-                       getSetting("grip_pose_offset_z").value_or(0) / 1000.f});
-
-        const auto oldControllerHandOffset = m_controllerHandOffset;
-        m_controllerHandOffset = Pose::MakePose(
-            Quaternion::RotationRollPitchYaw({PVR::DegreeToRad((float)getSetting("hand_pose_rot_x").value_or(0.f)),
-                                              PVR::DegreeToRad((float)getSetting("hand_pose_rot_y").value_or(0.f)),
-                                              PVR::DegreeToRad((float)getSetting("hand_pose_rot_z").value_or(0.f))}),
-            XrVector3f{getSetting("hand_pose_offset_x").value_or(0) / 1000.f,
-                       getSetting("hand_pose_offset_y").value_or(0) / 1000.f,
-                       getSetting("hand_pose_offset_z").value_or(0) / 1000.f});
-
-        // Force re-evaluating poses.
-        if (!Pose::Equals(oldControllerAimOffset, m_controllerAimOffset) ||
-            !Pose::Equals(oldControllerGripOffset, m_controllerGripOffset) ||
-            !Pose::Equals(oldControllerHandOffset, m_controllerHandOffset)) {
-            m_cachedControllerType[0].clear();
-            m_cachedControllerType[1].clear();
+            settings->guardianThreshold = INFINITY;
         }
 
+        const auto getPoseOffset = [&](const std::string& prefix) {
+            return Pose::MakePose(
+                Quaternion::RotationRollPitchYaw({PVR::DegreeToRad((float)getValue((prefix + "_rot_x").c_str(), 0)),
+                                                  PVR::DegreeToRad((float)getValue((prefix + "_rot_y").c_str(), 0)),
+                                                  PVR::DegreeToRad((float)getValue((prefix + "_rot_z").c_str(), 0))}),
+                XrVector3f{getValue((prefix + "_offset_x").c_str(), 0) / 1000.f,
+                           getValue((prefix + "_offset_y").c_str(), 0) / 1000.f,
+                           getValue((prefix + "_offset_z").c_str(), 0) / 1000.f});
+        };
+        settings->controllerAimOffset = getPoseOffset("aim_pose");
+        settings->controllerGripOffset = getPoseOffset("grip_pose");
+        settings->controllerHandOffset = getPoseOffset("hand_pose");
+
         // Value is already in microseconds.
-        m_frameTimeOverrideOffsetUs = getSetting("frame_time_override_offset").value_or(0);
+        settings->frameTimeOverrideOffsetUs = getValue("frame_time_override_offset", 0);
+        settings->frameTimeOverrideMultiplier = getValue("frame_time_override_multiplier", 0);
 
-        // Multiplier is a percentage. Convert to milliseconds (*10) then convert the whole expression (including frame
-        // duration) from milliseconds to microseconds.
-        m_frameTimeOverrideUs =
-            (uint64_t)(getSetting("frame_time_override_multiplier").value_or(0) * 10.f * m_frameDuration * 1000.f);
+        settings->frameTimeFilterLength =
+            std::clamp(getValue("frame_time_filter_length", 5), 1, (int)k_maxFrameTimeFilterLength);
+        settings->frameTimePredictorType = getValue("frame_time_predictor", 0) == 1 ? FrameTimePredictorType::Adaptive
+                                                                                     : FrameTimePredictorType::Median;
 
-        m_frameTimeFilterLength = getSetting("frame_time_filter_length").value_or(5);
+        settings->useMirrorWindow = getValue("mirror_window", 0);
+        settings->useMirrorTexture = getValue("mirror_texture", 0);
 
-        m_useMirrorWindow = getSetting("mirror_window").value_or(0);
+        const auto depthSubmission = getValue("depth_submission", 0);
+        settings->depthSubmission = depthSubmission == 1   ? DepthSubmission::Always
+                                    : depthSubmission == 2 ? DepthSubmission::Never
+                                                           : DepthSubmission::Auto;
 
         TraceLoggingWrite(
             g_traceProvider,
             "PXR_Config",
-            TLArg(m_joystickDeadzone, "JoystickDeadzone"),
-            TLArg(m_swapGripAimPoses, "SwapGripAimPoses"),
-            TLArg((int)m_forcedInteractionProfile.value_or((ForcedInteractionProfile)-1), "ForcedInteractionProfile"),
-            TLArg(m_guardianThreshold, "GuardianThreshold"),
-            TLArg(m_guardianRadius, "GuardianRadius"),
-            TLArg(m_frameTimeOverrideOffsetUs, "FrameTimeOverrideOffset"),
-            TLArg(m_frameTimeOverrideUs, "FrameTimeOverride"),
-            TLArg(m_frameTimeFilterLength, "FrameTimeFilterLength"),
-            TLArg(m_useMirrorWindow, "MirrorWindow"));
-    }
+            TLArg(settings->joystickDeadzone, "JoystickDeadzone"),
+            TLArg(settings->swapGripAimPoses, "SwapGripAimPoses"),
+            TLArg((int)settings->forcedInteractionProfile.value_or((ForcedInteractionProfile)-1),
+                  "ForcedInteractionProfile"),
+            TLArg(settings->guardianThreshold, "GuardianThreshold"),
+            TLArg(settings->guardianRadius, "GuardianRadius"),
+            TLArg(settings->frameTimeOverrideOffsetUs, "FrameTimeOverrideOffset"),
+            TLArg(settings->frameTimeOverrideMultiplier, "FrameTimeOverrideMultiplier"),
+            TLArg(settings->frameTimeFilterLength, "FrameTimeFilterLength"),
+            TLArg((int)settings->frameTimePredictorType, "FrameTimePredictor"),
+            TLArg(settings->useMirrorWindow, "MirrorWindow"),
+            TLArg(settings->useMirrorTexture, "MirrorTexture"),
+            TLArg((int)settings->depthSubmission, "DepthSubmission"));
+
+        // Publish the new snapshot. The registry watcher and the application thread may race here.
+        std::unique_lock lock(m_settingsLock);
+        const RuntimeSettings* previous = m_settings.load(std::memory_order_relaxed);
+        m_settings.store(settings.get(), std::memory_order_release);
 
-    // Create guardian resources.
-    void OpenXrRuntime::initializeGuardianResources() {
-        HRESULT hr;
+        // Force re-evaluating poses.
+        if (previous && (!Pose::Equals(previous->controllerAimOffset, settings->controllerAimOffset) ||
+                         !Pose::Equals(previous->controllerGripOffset, settings->controllerGripOffset) ||
+                         !Pose::Equals(previous->controllerHandOffset, settings->controllerHandOffset))) {
+            m_controllerRebindRequested[0] = m_controllerRebindRequested[1] = true;
+        }
 
-        // Load the guardian texture.
-        auto image = std::make_unique<DirectX::ScratchImage>();
-        CoInitializeEx(nullptr, COINIT_MULTITHREADED);
-        hr = DirectX::LoadFromWICFile((dllHome / L"guardian.png").c_str(), DirectX::WIC_FLAGS_NONE, nullptr, *image);
-
-        if (SUCCEEDED(hr)) {
-            ComPtr<ID3D11Resource> texture;
-            hr = DirectX::CreateTexture(m_pvrSubmissionDevice.Get(),
-                                        image->GetImages(),
-                                        1,
-                                        image->GetMetadata(),
-                                        texture.ReleaseAndGetAddressOf());
-
-            if (SUCCEEDED(hr)) {
-                // Create a PVR swapchain for the texture.
-                pvrTextureSwapChainDesc desc{};
-                desc.Type = pvrTexture_2D;
-                desc.StaticImage = true;
-                desc.ArraySize = 1;
-                desc.Width = m_guardianExtent.width = (int)image->GetMetadata().width;
-                desc.Height = m_guardianExtent.height = (int)image->GetMetadata().height;
-                desc.MipLevels = (int)image->GetMetadata().mipLevels;
-                desc.SampleCount = 1;
-                desc.Format = dxgiToPvrTextureFormat(image->GetMetadata().format);
-
-                CHECK_PVRCMD(pvr_createTextureSwapChainDX(
-                    m_pvrSession, m_pvrSubmissionDevice.Get(), &desc, &m_guardianSwapchain));
-
-                // Copy and commit the guardian texture to the swapchain.
-                int imageIndex = -1;
-                CHECK_PVRCMD(pvr_getTextureSwapChainCurrentIndex(m_pvrSession, m_guardianSwapchain, &imageIndex));
-                ID3D11Texture2D* swapchainTexture;
-                CHECK_PVRCMD(pvr_getTextureSwapChainBufferDX(
-                    m_pvrSession, m_guardianSwapchain, imageIndex, IID_PPV_ARGS(&swapchainTexture)));
-
-                m_pvrSubmissionContext->CopyResource(swapchainTexture, texture.Get());
-                m_pvrSubmissionContext->Flush();
-                CHECK_PVRCMD(pvr_commitTextureSwapChain(m_pvrSession, m_guardianSwapchain));
-            } else {
-                ErrorLog("Failed to create texture from guardian.png: %X\n");
-            }
-        } else {
-            ErrorLog("Failed to load guardian.png: %X\n");
+        m_settingsSnapshots.push_back(std::move(settings));
+    }
+
+    // Start the creation of the guardian resources on a worker thread, to avoid a hitch on the first frame.
+    void OpenXrRuntime::startGuardianInitialization() {
+        if (m_guardianSpace != XR_NULL_HANDLE) {
+            return;
         }
 
         // Create the guardian reference space, 1m below eyesight, flat on the floor.
@@ -534,10 +589,110 @@ namespace pimax_openxr {
         xrSpace.poseInSpace =
             Pose::MakePose(Quaternion::RotationRollPitchYaw({PVR::DegreeToRad(-90.f), 0.f, 0.f}), XrVector3f{0, -1, 0});
 
-        m_guardianSpace = (XrSpace)&xrSpace;
-
         // Maintain a list of known spaces for validation and cleanup.
-        m_spaces.insert(m_guardianSpace);
+        m_guardianSpace = m_spaces.insert(&xrSpace);
+
+        m_guardianReady = false;
+        m_guardianThread = std::thread([&]() {
+            TraceLocalActivity(local);
+            TraceLoggingWriteStart(local, "GuardianInitialization");
+            try {
+                initializeGuardianResources();
+            } catch (std::exception& exc) {
+                ErrorLog("Failed to initialize the guardian: %s\n", exc.what());
+                m_guardianTexture.Reset();
+            }
+            TraceLoggingWriteStop(local, "GuardianInitialization", TLArg(!!m_guardianTexture, "Success"));
+            m_guardianReady = true;
+        });
+    }
+
+    // Load the guardian texture. The texture is embedded as a compressed DDS resource, generated from guardian.png at
+    // build time. This runs on the guardian thread, which neither uses the submission context nor calls into PVR.
+    void OpenXrRuntime::initializeGuardianResources() {
+        HMODULE module;
+        CHECK_MSG(GetModuleHandleExW(GET_MODULE_HANDLE_EX_FLAG_FROM_ADDRESS |
+                                         GET_MODULE_HANDLE_EX_FLAG_UNCHANGED_REFCOUNT,
+                                     reinterpret_cast<LPCWSTR>(&dllHome),
+                                     &module),
+                  "Failed to get DLL handle");
+        const HRSRC resource = FindResource(module, MAKEINTRESOURCE(IDR_GUARDIAN), RT_RCDATA);
+        const HGLOBAL resourceData = resource ? LoadResource(module, resource) : nullptr;
+        const void* data = resourceData ? LockResource(resourceData) : nullptr;
+        if (!data) {
+            ErrorLog("Failed to find the guardian texture: %d\n", GetLastError());
+            return;
+        }
+
+        // Load the guardian texture.
+        DirectX::ScratchImage image;
+        HRESULT hr =
+            DirectX::LoadFromDDSMemory(data, SizeofResource(module, resource), DirectX::DDS_FLAGS_NONE, nullptr, image);
+        if (FAILED(hr)) {
+            ErrorLog("Failed to load guardian.dds: %X\n", hr);
+            return;
+        }
+
+        // The texture is created with its initial data, so the upload does not need the submission context.
+        ComPtr<ID3D11Resource> texture;
+        hr = DirectX::CreateTexture(m_pvrSubmissionDevice.Get(),
+                                    image.GetImages(),
+                                    image.GetImageCount(),
+                                    image.GetMetadata(),
+                                    texture.ReleaseAndGetAddressOf());
+        if (FAILED(hr)) {
+            ErrorLog("Failed to create texture from guardian.dds: %X\n", hr);
+            return;
+        }
+        CHECK_HRCMD(texture->QueryInterface(m_guardianTexture.ReleaseAndGetAddressOf()));
+    }
+
+    // Copy the guardian texture to a PVR swapchain. This runs on the frame loop, once the guardian thread is done.
+    void OpenXrRuntime::createGuardianSwapchain() {
+        D3D11_TEXTURE2D_DESC textureDesc;
+        m_guardianTexture->GetDesc(&textureDesc);
+
+        pvrTextureSwapChainDesc desc{};
+        desc.Type = pvrTexture_2D;
+        desc.StaticImage = true;
+        desc.ArraySize = 1;
+        desc.Width = m_guardianExtent.width = (int)textureDesc.Width;
+        desc.Height = m_guardianExtent.height = (int)textureDesc.Height;
+        desc.MipLevels = (int)textureDesc.MipLevels;
+        desc.SampleCount = 1;
+        desc.Format = dxgiToPvrTextureFormat(textureDesc.Format);
+
+        try {
+            std::unique_lock pvrLock(m_pvrLock);
+            CHECK_PVRCMD(
+                pvr_createTextureSwapChainDX(m_pvrSession, m_pvrSubmissionDevice.Get(), &desc, &m_guardianSwapchain));
+
+            int imageIndex = -1;
+            CHECK_PVRCMD(pvr_getTextureSwapChainCurrentIndex(m_pvrSession, m_guardianSwapchain, &imageIndex));
+            ID3D11Texture2D* swapchainTexture;
+            CHECK_PVRCMD(pvr_getTextureSwapChainBufferDX(
+                m_pvrSession, m_guardianSwapchain, imageIndex, IID_PPV_ARGS(&swapchainTexture)));
+
+            m_pvrSubmissionContext->CopyResource(swapchainTexture, m_guardianTexture.Get());
+            m_pvrSubmissionContext->Flush();
+            CHECK_PVRCMD(pvr_commitTextureSwapChain(m_pvrSession, m_guardianSwapchain));
+        } catch (std::exception& exc) {
+            ErrorLog("Failed to initialize the guardian: %s\n", exc.what());
+            if (m_guardianSwapchain) {
+                std::unique_lock pvrLock(m_pvrLock);
+                pvr_destroyTextureSwapChain(m_pvrSession, m_guardianSwapchain);
+                m_guardianSwapchain = nullptr;
+            }
+        }
+        m_guardianTexture.Reset();
+    }
+
+    void OpenXrRuntime::stopGuardianInitialization() {
+        if (m_guardianThread.joinable()) {
+            m_guardianThread.join();
+        }
+        m_guardianTexture.Reset();
+        m_guardianReady = false;
     }
 
 } // namespace pimax_openxr
@@ -100,10 +100,8 @@ namespace pimax_openxr {
         xrSpace.referenceType = createInfo->referenceSpaceType;
         xrSpace.poseInSpace = createInfo->poseInReferenceSpace;
 
-        *space = (XrSpace)&xrSpace;
-
         // Maintain a list of known spaces for validation and cleanup.
-        m_spaces.insert(*space);
+        *space = m_spaces.insert(&xrSpace);
 
         TraceLoggingWrite(g_traceProvider, "xrCreateReferenceSpace", TLXArg(*space, "Space"));
 
@@ -130,11 +128,11 @@ namespace pimax_openxr {
         }
 
         if (createInfo->action != XR_NULL_HANDLE) {
-            if (!m_actions.count(createInfo->action)) {
+            if (!m_actions.contains(createInfo->action)) {
                 return XR_ERROR_HANDLE_INVALID;
             }
 
-            Action& xrAction = *(Action*)createInfo->action;
+            Action& xrAction = *m_actions.get(createInfo->action);
 
             if (xrAction.type != XR_ACTION_TYPE_POSE_INPUT) {
                 return XR_ERROR_ACTION_TYPE_MISMATCH;
@@ -144,14 +142,16 @@ namespace pimax_openxr {
         // Create the internal struct.
         Space& xrSpace = *new Space;
         xrSpace.referenceType = XR_REFERENCE_SPACE_TYPE_MAX_ENUM;
-        xrSpace.action = createInfo->action;
+        xrSpace.action = m_actions.get(createInfo->action);
         xrSpace.subActionPath = createInfo->subactionPath;
         xrSpace.poseInSpace = createInfo->poseInActionSpace;
-
-        *space = (XrSpace)&xrSpace;
+        if (xrSpace.action) {
+            std::unique_lock lock(m_actionBindingsLock);
+            resolveActionSpace(xrSpace);
+        }
 
         // Maintain a list of known spaces for validation and cleanup.
-        m_spaces.insert(*space);
+        *space = m_spaces.insert(&xrSpace);
 
         TraceLoggingWrite(g_traceProvider, "xrCreateActionSpace", TLXArg(*space, "Space"));
 
@@ -195,7 +195,7 @@ namespace pimax_openxr {
 
         location->locationFlags = 0;
 
-        if (!m_spaces.count(space) || !m_spaces.count(baseSpace)) {
+        if (!m_spaces.contains(space) || !m_spaces.contains(baseSpace)) {
             return XR_ERROR_HANDLE_INVALID;
         }
 
@@ -211,8 +211,20 @@ namespace pimax_openxr {
             velocity = reinterpret_cast<XrSpaceVelocity*>(velocity->next);
         }
 
-        Space& xrSpace = *(Space*)space;
-        Space& xrBaseSpace = *(Space*)baseSpace;
+        XrEyeGazeSampleTimeEXT* eyeGazeSampleTime = reinterpret_cast<XrEyeGazeSampleTimeEXT*>(location->next);
+        if (has_XR_EXT_eye_gaze_interaction) {
+            while (eyeGazeSampleTime) {
+                if (eyeGazeSampleTime->type == XR_TYPE_EYE_GAZE_SAMPLE_TIME_EXT) {
+                    break;
+                }
+                eyeGazeSampleTime = reinterpret_cast<XrEyeGazeSampleTimeEXT*>(eyeGazeSampleTime->next);
+            }
+        } else {
+            eyeGazeSampleTime = nullptr;
+        }
+
+        Space& xrSpace = *m_spaces.get(space);
+        Space& xrBaseSpace = *m_spaces.get(baseSpace);
 
         XrPosef spaceToVirtual = Pose::Identity();
         XrSpaceVelocity spaceToVirtualVelocity{};
@@ -251,6 +263,13 @@ namespace pimax_openxr {
                     spaceToVirtualVelocity.linearVelocity - baseSpaceToVirtualVelocity.linearVelocity;
             }
         }
+        if (eyeGazeSampleTime) {
+            XrVector2f gazeTan;
+            eyeGazeSampleTime->time = 0;
+            if (xrSpace.action && xrSpace.binding.get().poseSide == 2) {
+                getEyeGaze(gazeTan, &eyeGazeSampleTime->time);
+            }
+        }
 
         if (!velocity) {
             TraceLoggingWrite(g_traceProvider,
@@ -270,6 +289,117 @@ namespace pimax_openxr {
         return XR_SUCCESS;
     }
 
+    // https://registry.khronos.org/OpenXR/specs/1.0/html/xrspec.html#xrLocateSpacesKHR
+    XrResult OpenXrRuntime::xrLocateSpacesKHR(XrSession session,
+                                              const XrSpacesLocateInfoKHR* locateInfo,
+                                              XrSpaceLocationsKHR* spaceLocations) {
+        if (locateInfo->type != XR_TYPE_SPACES_LOCATE_INFO_KHR || spaceLocations->type != XR_TYPE_SPACE_LOCATIONS_KHR) {
+            return XR_ERROR_VALIDATION_FAILURE;
+        }
+
+        TraceLoggingWrite(g_traceProvider,
+                          "xrLocateSpacesKHR",
+                          TLXArg(session, "Session"),
+                          TLXArg(locateInfo->baseSpace, "BaseSpace"),
+                          TLArg(locateInfo->time, "Time"),
+                          TLArg(locateInfo->spaceCount, "SpaceCount"));
+
+        if (!m_sessionCreated || session != (XrSession)1) {
+            return XR_ERROR_HANDLE_INVALID;
+        }
+
+        if (!m_spaces.contains(locateInfo->baseSpace)) {
+            return XR_ERROR_HANDLE_INVALID;
+        }
+        for (uint32_t i = 0; i < locateInfo->spaceCount; i++) {
+            if (!m_spaces.contains(locateInfo->spaces[i])) {
+                return XR_ERROR_HANDLE_INVALID;
+            }
+        }
+
+        if (locateInfo->time <= 0) {
+            return XR_ERROR_TIME_INVALID;
+        }
+
+        if (spaceLocations->locationCount != locateInfo->spaceCount) {
+            return XR_ERROR_VALIDATION_FAILURE;
+        }
+
+        XrSpaceVelocitiesKHR* velocities = reinterpret_cast<XrSpaceVelocitiesKHR*>(spaceLocations->next);
+        while (velocities) {
+            if (velocities->type == XR_TYPE_SPACE_VELOCITIES_KHR) {
+                break;
+            }
+            velocities = reinterpret_cast<XrSpaceVelocitiesKHR*>(velocities->next);
+        }
+        if (velocities && velocities->velocityCount != locateInfo->spaceCount) {
+            return XR_ERROR_VALIDATION_FAILURE;
+        }
+
+        // Locate the base space only once. The device poses are sampled at most once thanks to the pose cache.
+        XrPosef baseSpaceToVirtual = Pose::Identity();
+        XrSpaceVelocity baseSpaceToVirtualVelocity{};
+        const auto baseFlags = locateSpaceToOrigin(*m_spaces.get(locateInfo->baseSpace),
+                                                   locateInfo->time,
+                                                   baseSpaceToVirtual,
+                                                   velocities ? &baseSpaceToVirtualVelocity : nullptr);
+        const XrPosef virtualToBaseSpace = Pose::Invert(baseSpaceToVirtual);
+
+        for (uint32_t i = 0; i < locateInfo->spaceCount; i++) {
+            XrSpaceLocationDataKHR& location = spaceLocations->locations[i];
+            XrSpaceVelocityDataKHR* velocity = velocities ? &velocities->velocities[i] : nullptr;
+
+            location.locationFlags = 0;
+            if (velocity) {
+                velocity->velocityFlags = 0;
+            }
+
+            XrPosef spaceToVirtual = Pose::Identity();
+            XrSpaceVelocity spaceToVirtualVelocity{};
+            const auto flags = locateSpaceToOrigin(*m_spaces.get(locateInfo->spaces[i]),
+                                                   locateInfo->time,
+                                                   spaceToVirtual,
+                                                   velocity ? &spaceToVirtualVelocity : nullptr);
+
+            // If either pose is not valid, we cannot locate.
+            if (!(Pose::IsPoseValid(flags) && Pose::IsPoseValid(baseFlags))) {
+                continue;
+            }
+
+            location.locationFlags = XR_SPACE_LOCATION_ORIENTATION_VALID_BIT | XR_SPACE_LOCATION_POSITION_VALID_BIT;
+
+            // Both poses need to be tracked for the location to be tracked.
+            if (Pose::IsPoseTracked(flags) && Pose::IsPoseTracked(baseFlags)) {
+                location.locationFlags |=
+                    XR_SPACE_LOCATION_ORIENTATION_TRACKED_BIT | XR_SPACE_LOCATION_POSITION_TRACKED_BIT;
+            }
+
+            // Combine the poses.
+            location.pose = Pose::Multiply(spaceToVirtual, virtualToBaseSpace);
+            if (velocity) {
+                velocity->velocityFlags =
+                    spaceToVirtualVelocity.velocityFlags & baseSpaceToVirtualVelocity.velocityFlags;
+                if (velocity->velocityFlags & XR_SPACE_VELOCITY_ANGULAR_VALID_BIT) {
+                    velocity->angularVelocity =
+                        spaceToVirtualVelocity.angularVelocity - baseSpaceToVirtualVelocity.angularVelocity;
+                }
+                if (velocity->velocityFlags & XR_SPACE_VELOCITY_LINEAR_VALID_BIT) {
+                    // TODO: Does not account for centripetral forces.
+                    velocity->linearVelocity =
+                        spaceToVirtualVelocity.linearVelocity - baseSpaceToVirtualVelocity.linearVelocity;
+                }
+            }
+
+            TraceLoggingWrite(g_traceProvider,
+                              "xrLocateSpacesKHR",
+                              TLXArg(locateInfo->spaces[i], "Space"),
+                              TLArg(location.locationFlags, "LocationFlags"),
+                              TLArg(xr::ToString(location.pose).c_str(), "Pose"));
+        }
+
+        return XR_SUCCESS;
+    }
+
     // https://www.khronos.org/registry/OpenXR/specs/1.0/html/xrspec.html#xrLocateViews
     XrResult OpenXrRuntime::xrLocateViews(XrSession session,
                                           const XrViewLocateInfo* viewLocateInfo,
@@ -293,18 +423,89 @@ namespace pimax_openxr {
             return XR_ERROR_HANDLE_INVALID;
         }
 
-        if (viewLocateInfo->viewConfigurationType != XR_VIEW_CONFIGURATION_TYPE_PRIMARY_STEREO) {
+        const uint32_t viewCount = getViewConfigurationViewCount(viewLocateInfo->viewConfigurationType);
+        if (!viewCount) {
             return XR_ERROR_VIEW_CONFIGURATION_TYPE_UNSUPPORTED;
         }
 
-        if (viewCapacityInput && viewCapacityInput < xr::StereoView::Count) {
+        if (viewCapacityInput && viewCapacityInput < viewCount) {
             return XR_ERROR_SIZE_INSUFFICIENT;
         }
 
-        *viewCountOutput = xr::StereoView::Count;
+        *viewCountOutput = viewCount;
         TraceLoggingWrite(g_traceProvider, "xrLocateViews", TLArg(*viewCountOutput, "ViewCountOutput"));
 
         if (viewCapacityInput && views) {
+            for (uint32_t i = 0; i < *viewCountOutput; i++) {
+                if (views[i].type != XR_TYPE_VIEW) {
+                    return XR_ERROR_VALIDATION_FAILURE;
+                }
+            }
+
+            // The focus views of quad views share the pose of their context view.
+            const auto fillFocusViews = [&]() {
+                XrVector2f gazeTan{};
+                const bool hasGaze =
+                    *viewCountOutput > xr::StereoView::Count && m_useEyeTrackedFoveation && getEyeGaze(gazeTan);
+                for (uint32_t i = xr::StereoView::Count; i < *viewCountOutput; i++) {
+                    const uint32_t eye = i - xr::StereoView::Count;
+                    views[i].pose = views[eye].pose;
+                    views[i].fov = m_cachedFocusFov[eye];
+                    if (!hasGaze) {
+                        continue;
+                    }
+
+                    // Slide the focus window (keeping its size) to be centered on the gaze, within the eye FOV. The
+                    // gaze is relative to the HMD, while the eye views might be canted.
+                    const float viewYaw = m_useParallelProjection ? 0.f : (eye == 0 ? -m_cantingAngle : m_cantingAngle);
+                    const float centerX = std::atan(gazeTan.x) - viewYaw;
+                    const float centerY = std::atan(gazeTan.y);
+                    const float width = views[i].fov.angleRight - views[i].fov.angleLeft;
+                    const float height = views[i].fov.angleUp - views[i].fov.angleDown;
+                    views[i].fov.angleLeft = std::clamp(centerX - width / 2.f,
+                                                        m_cachedEyeFov[eye].angleLeft,
+                                                        std::max(m_cachedEyeFov[eye].angleLeft,
+                                                                 m_cachedEyeFov[eye].angleRight - width));
+                    views[i].fov.angleRight = views[i].fov.angleLeft + width;
+                    views[i].fov.angleDown = std::clamp(centerY - height / 2.f,
+                                                        m_cachedEyeFov[eye].angleDown,
+                                                        std::max(m_cachedEyeFov[eye].angleDown,
+                                                                 m_cachedEyeFov[eye].angleUp - height));
+                    views[i].fov.angleUp = views[i].fov.angleDown + height;
+                }
+            };
+
+            // Engines query the same views several times per frame, and they must be identical each time. The cache is
+            // only locked while copying entries, never across the pose queries.
+            const uint64_t generation = m_poseCacheGeneration;
+            const auto getCachedViews = [&]() {
+                for (const auto& entry : m_viewsCache) {
+                    if (entry.generation == generation && entry.space == viewLocateInfo->space &&
+                        entry.time == viewLocateInfo->displayTime) {
+                        viewState->viewStateFlags = entry.viewStateFlags;
+                        for (uint32_t i = 0; i < xr::StereoView::Count; i++) {
+                            views[i].pose = entry.poses[i];
+                            views[i].fov = entry.fovs[i];
+                        }
+                        return true;
+                    }
+                }
+                return false;
+            };
+            bool isCached;
+            {
+                std::unique_lock lock(m_viewsCacheLock);
+                isCached = getCachedViews();
+            }
+            if (isCached) {
+                fillFocusViews();
+                TraceLoggingWrite(g_traceProvider,
+                                  "xrLocateViews",
+                                  TLArg(viewState->viewStateFlags, "ViewStateFlags"),
+                                  TLArg(true, "Cached"));
+                return XR_SUCCESS;
+            }
+
             // Get the HMD pose in the base space.
             XrSpaceLocation location{XR_TYPE_SPACE_LOCATION};
             const auto result =
@@ -323,11 +524,7 @@ namespace pimax_openxr {
                 pvrPosef eyePoses[xr::StereoView::Count]{{}, {}};
                 pvr_calcEyePoses(m_pvr, xrPoseToPvrPose(location.pose), hmdToEyePose, eyePoses);
 
-                for (uint32_t i = 0; i < *viewCountOutput; i++) {
-                    if (views[i].type != XR_TYPE_VIEW) {
-                        return XR_ERROR_VALIDATION_FAILURE;
-                    }
-
+                for (uint32_t i = 0; i < xr::StereoView::Count; i++) {
                     views[i].pose = pvrPoseToXrPose(eyePoses[i]);
                     views[i].fov = m_cachedEyeFov[i];
 
@@ -343,6 +540,25 @@ namespace pimax_openxr {
                 viewState->viewStateFlags = 0;
                 TraceLoggingWrite(g_traceProvider, "xrLocateViews", TLArg(viewState->viewStateFlags, "ViewStateFlags"));
             }
+
+            {
+                // Another thread might have located the same views in the meantime. Keep its result.
+                std::unique_lock lock(m_viewsCacheLock);
+                if (!getCachedViews()) {
+                    auto& entry = m_viewsCache[m_viewsCacheNextEntry];
+                    entry.generation = generation;
+                    entry.space = viewLocateInfo->space;
+                    entry.time = viewLocateInfo->displayTime;
+                    entry.viewStateFlags = viewState->viewStateFlags;
+                    for (uint32_t i = 0; i < xr::StereoView::Count; i++) {
+                        entry.poses[i] = views[i].pose;
+                        entry.fovs[i] = views[i].fov;
+                    }
+                    m_viewsCacheNextEntry = (m_viewsCacheNextEntry + 1) % k_viewsCacheSize;
+                }
+            }
+
+            fillFocusViews();
         }
 
         return XR_SUCCESS;
@@ -352,11 +568,11 @@ namespace pimax_openxr {
     XrResult OpenXrRuntime::xrDestroySpace(XrSpace space) {
         TraceLoggingWrite(g_traceProvider, "xrDestroySpace", TLXArg(space, "Space"));
 
-        if (!m_spaces.count(space)) {
+        if (!m_spaces.contains(space)) {
             return XR_ERROR_HANDLE_INVALID;
         }
 
-        Space* xrSpace = (Space*)space;
+        Space* xrSpace = m_spaces.get(space);
 
         delete xrSpace;
         m_spaces.erase(space);
@@ -394,49 +610,84 @@ namespace pimax_openxr {
             if (velocity) {
                 velocity->velocityFlags = XR_SPACE_VELOCITY_ANGULAR_VALID_BIT | XR_SPACE_VELOCITY_LINEAR_VALID_BIT;
             }
-        } else if (xrSpace.action != XR_NULL_HANDLE) {
-            // Action spaces for motion controllers.
-            Action& xrAction = *(Action*)xrSpace.action;
+        } else if (xrSpace.action) {
+            // Action spaces for motion controllers and eye gaze.
+            const Space::Binding& binding = xrSpace.binding.get();
+            if (binding.poseSide == 2) {
+                result = getEyeGazePose(time, pose, velocity);
+                pose = Pose::Multiply(binding.poseOffset, pose);
+            } else if (binding.poseSide >= 0) {
+                result = getControllerPose(binding.poseSide, time, pose, velocity);
+                pose = Pose::Multiply(binding.poseOffset, pose);
+            }
 
-            const std::string& subActionPath = getXrPath(xrSpace.subActionPath);
-            for (const auto& source : xrAction.actionSources) {
-                if (!startsWith(source.first, subActionPath)) {
-                    continue;
-                }
+            return result;
+        }
 
-                const std::string& fullPath = source.first;
-                TraceLoggingWrite(g_traceProvider, "xrLocateSpace", TLArg(fullPath.c_str(), "ActionSourcePath"));
+        // Apply the offset transform.
+        pose = Pose::Multiply(xrSpace.poseInSpace, pose);
 
+        return result;
+    }
+
+    // Pick the pose source of an action space and pre-multiply its offsets. The caller must hold m_actionBindingsLock.
+    void OpenXrRuntime::resolveActionSpace(Space& xrSpace) const {
+        const Action& xrAction = *xrSpace.action;
+        const Action::Bindings& bindings = xrAction.bindings.get();
+
+        Space::Binding binding;
+        binding.poseOffset = xrSpace.poseInSpace;
+
+        // Only publish a new resolution when it changed.
+        const auto publish = [&] {
+            const Space::Binding& current = xrSpace.binding.get();
+            if (current.poseSide != binding.poseSide || !Pose::Equals(current.poseOffset, binding.poseOffset)) {
+                xrSpace.binding.publish(std::make_unique<Space::Binding>(binding));
+            }
+        };
+
+        const auto [firstSide, lastSide] = getSubactionSideRange(xrSpace.subActionPath);
+        for (int side = firstSide; side < lastSide; side++) {
+            for (const auto& source : bindings.boundSources[side]) {
+                const std::string& fullPath = *source.path;
                 const bool isGripPose = endsWith(fullPath, "/input/grip/pose");
                 const bool isAimPose = endsWith(fullPath, "/input/aim/pose");
-                const int side = getActionSide(fullPath);
-                if ((isGripPose || isAimPose) && side >= 0) {
-                    result = getControllerPose(side, time, pose, velocity);
-
-                    // Apply the pose offsets.
-                    const bool useAimPose = m_swapGripAimPoses ? isGripPose : isAimPose;
-                    if (useAimPose) {
-                        pose = Pose::Multiply(m_controllerAimPose[side], pose);
-                    } else {
-                        pose = Pose::Multiply(m_controllerGripPose[side], pose);
-                    }
-
-                    // Per spec we must consistently pick one source. We pick the first one.
-                    break;
+                if (!isGripPose && !isAimPose) {
+                    continue;
                 }
+
+                TraceLoggingWrite(g_traceProvider,
+                                  "ResolveActionSpace",
+                                  TLXArg(&xrSpace, "Space"),
+                                  TLArg(fullPath.c_str(), "ActionSourcePath"));
+
+                const bool useAimPose = currentSettings().swapGripAimPoses ? isGripPose : isAimPose;
+                binding.poseSide = side;
+                binding.poseOffset = Pose::Multiply(
+                    xrSpace.poseInSpace, useAimPose ? m_controllerAimPose[side] : m_controllerGripPose[side]);
+
+                // Per spec we must consistently pick one source. We pick the first one.
+                publish();
+                return;
             }
         }
 
-        // Apply the offset transform.
-        pose = Pose::Multiply(xrSpace.poseInSpace, pose);
+        if (xrAction.hasEyeGazePose &&
+            (xrSpace.subActionPath == XR_NULL_PATH || xrSpace.subActionPath == m_eyesPath)) {
+            TraceLoggingWrite(g_traceProvider,
+                              "ResolveActionSpace",
+                              TLXArg(&xrSpace, "Space"),
+                              TLArg("/user/eyes_ext/input/gaze_ext/pose", "ActionSourcePath"));
 
-        return result;
+            binding.poseSide = 2;
+        }
+        publish();
     }
 
     XrSpaceLocationFlags OpenXrRuntime::getHmdPose(XrTime time, XrPosef& pose, XrSpaceVelocity* velocity) const {
         XrSpaceLocationFlags locationFlags = 0;
         pvrPoseStatef state{};
-        CHECK_PVRCMD(pvr_getTrackedDevicePoseState(m_pvrSession, pvrTrackedDevice_HMD, xrTimeToPvrTime(time), &state));
+        getTrackedDevicePoseState(pvrTrackedDevice_HMD, time, state);
         TraceLoggingWrite(g_traceProvider,
                           "PVR_HmdPoseState",
                           TLArg(state.StatusFlags, "StatusFlags"),
@@ -477,11 +728,8 @@ namespace pimax_openxr {
     OpenXrRuntime::getControllerPose(int side, XrTime time, XrPosef& pose, XrSpaceVelocity* velocity) const {
         XrSpaceLocationFlags locationFlags = 0;
         pvrPoseStatef state{};
-        CHECK_PVRCMD(pvr_getTrackedDevicePoseState(m_pvrSession,
-                                                   side == 0 ? pvrTrackedDevice_LeftController
-                                                             : pvrTrackedDevice_RightController,
-                                                   xrTimeToPvrTime(time),
-                                                   &state));
+        getTrackedDevicePoseState(
+            side == 0 ? pvrTrackedDevice_LeftController : pvrTrackedDevice_RightController, time, state);
         TraceLoggingWrite(g_traceProvider,
                           "PVR_ControllerPoseState",
                           TLArg(side == 0 ? "Left" : "Right", "Side"),
@@ -518,4 +766,327 @@ namespace pimax_openxr {
         return locationFlags;
     }
 
+    // The gaze pose is the HMD pose rotated towards the averaged gaze direction of both eyes.
+    XrSpaceLocationFlags OpenXrRuntime::getEyeGazePose(XrTime time, XrPosef& pose, XrSpaceVelocity* velocity) const {
+        XrVector2f gazeTan;
+        if (!getEyeGaze(gazeTan)) {
+            pose = Pose::Identity();
+            return 0;
+        }
+
+        XrPosef hmdPose;
+        const auto locationFlags = getHmdPose(time, hmdPose, nullptr);
+        if (!Pose::IsPoseValid(locationFlags)) {
+            pose = Pose::Identity();
+            return 0;
+        }
+
+        // The gaze is not predicted, so we do not report velocities.
+        if (velocity) {
+            velocity->velocityFlags = 0;
+        }
+
+        const float yaw = -std::atan(gazeTan.x);
+        const float pitch = std::atan(gazeTan.y / std::sqrt(1.f + gazeTan.x * gazeTan.x));
+        pose = Pose::Multiply(Pose::MakePose(Quaternion::RotationRollPitchYaw({pitch, yaw, 0}), XrVector3f{0, 0, 0}),
+                              hmdPose);
+
+        return locationFlags;
+    }
+
+    // Retrieve the gaze direction (as tangents in the HMD space) from the sample of the current frame.
+    bool OpenXrRuntime::getEyeGaze(XrVector2f& gazeTan, XrTime* sampleTime) const {
+        if (!m_isEyeTrackingAvailable) {
+            return false;
+        }
+
+        const uint64_t generation = m_poseCacheGeneration;
+
+        // Sample with the current time rather than the requested time: the eye tracker cannot predict, and any
+        // latency added here is latency added to foveation.
+        const double now = pvr_getTimeSeconds(m_pvr);
+
+        pvrEyeTrackingInfo info{};
+        bool isCached;
+        {
+            std::unique_lock lock(m_eyeGazeLock);
+            isCached = m_eyeGazeGeneration == generation;
+            if (isCached) {
+                info = m_eyeGazeInfo;
+            }
+        }
+
+        // The sample is not locked during the query, so that queries from other threads are not held up by the RPC.
+        if (!isCached) {
+            {
+                std::unique_lock pvrLock(m_pvrLock);
+                if (pvr_getEyeTrackingInfo(m_pvrSession, now, &info) != pvr_success) {
+                    info = {};
+                }
+            }
+
+            TraceLoggingWrite(g_traceProvider,
+                              "PVR_EyeTrackingInfo",
+                              TLArg(info.TimeInSeconds, "TimeInSeconds"),
+                              TLArg(xr::ToString(info.GazeTan[0]).c_str(), "LeftGazeTan"),
+                              TLArg(xr::ToString(info.GazeTan[1]).c_str(), "RightGazeTan"));
+
+            // Another thread might have sampled the gaze in the meantime. Keep its result, so that all callers see the
+            // same gaze.
+            std::unique_lock lock(m_eyeGazeLock);
+            if (m_eyeGazeGeneration == generation) {
+                info = m_eyeGazeInfo;
+            } else {
+                m_eyeGazeInfo = info;
+                m_eyeGazeGeneration = generation;
+            }
+        }
+
+        // A missing or stale sample means that the tracker lost the eyes.
+        if (!info.TimeInSeconds || now - info.TimeInSeconds > k_eyeGazeMaxAge) {
+            return false;
+        }
+
+        gazeTan.x = (info.GazeTan[0].x + info.GazeTan[1].x) / 2.f;
+        gazeTan.y = (info.GazeTan[0].y + info.GazeTan[1].y) / 2.f;
+        if (sampleTime) {
+            *sampleTime = pvrTimeToXrTime(info.TimeInSeconds);
+        }
+
+        return true;
+    }
+
+    // Query the pose of a device, reusing the result of any previous query for the same time during this frame.
+    void OpenXrRuntime::getTrackedDevicePoseState(pvrTrackedDeviceType device,
+                                                  XrTime time,
+                                                  pvrPoseStatef& state) const {
+        // The first pose query of the frame, for the latency statistics.
+        if (m_firstPoseQueryTime.load(std::memory_order_relaxed) == 0) {
+            m_firstPoseQueryTime.store(pvr_getTimeSeconds(m_pvr), std::memory_order_relaxed);
+        }
+
+        const uint32_t deviceIndex = device == pvrTrackedDevice_HMD              ? 0
+                                     : device == pvrTrackedDevice_LeftController ? 1
+                                                                                 : 2;
+        const uint64_t generation = m_poseCacheGeneration;
+
+        const auto getCachedPose = [&]() {
+            for (const auto& entry : m_poseCache[deviceIndex]) {
+                if (entry.generation == generation && entry.time == time) {
+                    state = entry.state;
+                    return true;
+                }
+            }
+            return false;
+        };
+
+        {
+            std::unique_lock lock(m_poseCacheLock);
+            if (getCachedPose()) {
+                return;
+            }
+        }
+
+        // The cache is not locked during the query, so that queries from other threads are not held up by the RPC.
+        if (!m_poseSamplerRate || !getPoseFromHistory(deviceIndex, xrTimeToPvrTime(time), state)) {
+            std::unique_lock pvrLock(m_pvrLock);
+            CHECK_PVRCMD(pvr_getTrackedDevicePoseState(m_pvrSession, device, xrTimeToPvrTime(time), &state));
+        }
+
+        // Another thread might have queried the same pose in the meantime. Keep its result, so that all callers see the
+        // same pose.
+        std::unique_lock lock(m_poseCacheLock);
+        if (getCachedPose()) {
+            return;
+        }
+
+        auto& entry = m_poseCache[deviceIndex][m_poseCacheNextEntry[deviceIndex]];
+        entry.generation = generation;
+        entry.time = time;
+        entry.state = state;
+        m_poseCacheNextEntry[deviceIndex] = (m_poseCacheNextEntry[deviceIndex] + 1) % k_poseCacheSize;
+    }
+
+    // Discard all cached poses, eg: upon new frame or recentering.
+    void OpenXrRuntime::invalidatePoseCache() {
+        m_poseCacheGeneration++;
+    }
+
+    void OpenXrRuntime::recenterTrackingOrigin() {
+        {
+            std::unique_lock pvrLock(m_pvrLock);
+            CHECK_PVRCMD(pvr_recenterTrackingOrigin(m_pvrSession));
+        }
+        invalidatePoseCache();
+
+        // Poses sampled before recentering are in a different origin.
+        m_poseHistoryEpoch++;
+    }
+
+    // Poll the device poses at a fixed rate into a history, so that pose queries can be answered without a round trip
+    // to the PVR service.
+    void OpenXrRuntime::startPoseSamplerThread() {
+        if (!m_poseSamplerRate) {
+            return;
+        }
+
+        for (auto& history : m_poseHistory) {
+            history.count = 0;
+        }
+        m_stopPoseSamplerThread = false;
+
+        m_poseSamplerThread = std::thread([&]() {
+            TraceLoggingWrite(g_traceProvider, "PoseSamplerThread", TLArg("Started", "State"));
+
+            // The default timer resolution is too coarse for our sampling rates.
+            wil::unique_handle timer;
+            *timer.put() = CreateWaitableTimerEx(
+                nullptr, nullptr, CREATE_WAITABLE_TIMER_HIGH_RESOLUTION, TIMER_MODIFY_STATE | SYNCHRONIZE);
+            const LONGLONG period = 10'000'000 / m_poseSamplerRate;
+
+            while (!m_stopPoseSamplerThread) {
+                const double now = pvr_getTimeSeconds(m_pvr);
+                const uint64_t epoch = m_poseHistoryEpoch;
+                for (uint32_t deviceIndex = 0; deviceIndex < 3; deviceIndex++) {
+                    const pvrTrackedDeviceType device = deviceIndex == 0   ? pvrTrackedDevice_HMD
+                                                        : deviceIndex == 1 ? pvrTrackedDevice_LeftController
+                                                                           : pvrTrackedDevice_RightController;
+                    HistoricalPose sample;
+                    pvrResult result;
+                    {
+                        std::unique_lock pvrLock(m_pvrLock);
+                        result = pvr_getTrackedDevicePoseState(m_pvrSession, device, now, &sample.state);
+                    }
+                    if (result != pvr_success) {
+                        continue;
+                    }
+                    sample.epoch = epoch;
+                    sample.time = now;
+
+                    // Single writer: bump the sequence to odd while the slot is being written.
+                    auto& history = m_poseHistory[deviceIndex];
+                    sample.index = history.count.load(std::memory_order_relaxed);
+                    auto& slot = history.samples[sample.index % k_poseHistorySize];
+                    const uint32_t sequence = slot.sequence.load(std::memory_order_relaxed);
+                    slot.sequence.store(sequence + 1, std::memory_order_relaxed);
+                    std::atomic_thread_fence(std::memory_order_release);
+                    slot.pose = sample;
+                    slot.sequence.store(sequence + 2, std::memory_order_release);
+                    history.count.store(sample.index + 1, std::memory_order_release);
+                }
+
+                if (timer) {
+                    LARGE_INTEGER dueTime;
+                    dueTime.QuadPart = -period;
+                    SetWaitableTimer(timer.get(), &dueTime, 0, nullptr, nullptr, FALSE);
+                    WaitForSingleObject(timer.get(), INFINITE);
+                } else {
+                    std::this_thread::sleep_for(std::chrono::microseconds(period / 10));
+                }
+            }
+
+            TraceLoggingWrite(g_traceProvider, "PoseSamplerThread", TLArg("Stopped", "State"));
+        });
+    }
+
+    void OpenXrRuntime::stopPoseSamplerThread() {
+        if (!m_poseSamplerThread.joinable()) {
+            return;
+        }
+
+        m_stopPoseSamplerThread = true;
+        m_poseSamplerThread.join();
+    }
+
+    bool OpenXrRuntime::readPoseHistory(uint32_t deviceIndex, uint64_t index, HistoricalPose& sample) const {
+        const auto& slot = m_poseHistory[deviceIndex].samples[index % k_poseHistorySize];
+        const uint32_t sequence = slot.sequence.load(std::memory_order_acquire);
+        if (sequence & 1) {
+            return false;
+        }
+        sample = slot.pose;
+        std::atomic_thread_fence(std::memory_order_acquire);
+
+        // Reject torn reads, overwritten slots and samples from before recentering.
+        return slot.sequence.load(std::memory_order_relaxed) == sequence && sample.index == index &&
+               sample.epoch == m_poseHistoryEpoch;
+    }
+
+    // Answer a pose query from the sampled history: past times are interpolated between the samples surrounding them,
+    // and near-future times are extrapolated from the velocities of the latest sample.
+    bool OpenXrRuntime::getPoseFromHistory(uint32_t deviceIndex, double time, pvrPoseStatef& state) const {
+        using namespace DirectX;
+
+        const uint64_t count = m_poseHistory[deviceIndex].count.load(std::memory_order_acquire);
+        HistoricalPose newer;
+        if (!count || !readPoseHistory(deviceIndex, count - 1, newer)) {
+            return false;
+        }
+
+        if (time >= newer.time) {
+            const float dt = (float)(time - newer.time);
+            if (dt > k_maxPoseExtrapolation) {
+                return false;
+            }
+
+            state = newer.state;
+            const XMVECTOR position = XMLoadFloat3(reinterpret_cast<const XMFLOAT3*>(&newer.state.ThePose.Position));
+            const XMVECTOR linearVelocity =
+                XMLoadFloat3(reinterpret_cast<const XMFLOAT3*>(&newer.state.LinearVelocity));
+            XMStoreFloat3(reinterpret_cast<XMFLOAT3*>(&state.ThePose.Position),
+                          XMVectorMultiplyAdd(linearVelocity, XMVectorReplicate(dt), position));
+
+            const XMVECTOR angularVelocity =
+                XMLoadFloat3(reinterpret_cast<const XMFLOAT3*>(&newer.state.AngularVelocity));
+            const float angularSpeed = XMVectorGetX(XMVector3Length(angularVelocity));
+            if (angularSpeed > 1e-6f) {
+                // The angular velocity is in world space, so the delta rotation applies after the current one.
+                const XMVECTOR delta =
+                    XMQuaternionRotationNormal(XMVectorScale(angularVelocity, 1.f / angularSpeed), angularSpeed * dt);
+                const XMVECTOR orientation =
+                    XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&newer.state.ThePose.Orientation));
+                XMStoreFloat4(reinterpret_cast<XMFLOAT4*>(&state.ThePose.Orientation),
+                              XMQuaternionNormalize(XMQuaternionMultiply(orientation, delta)));
+            }
+
+            return true;
+        }
+
+        // Leave one slot of margin, since the oldest one might be overwritten while we read it.
+        for (uint64_t index = count - 1; index > 0 && count - index < k_poseHistorySize - 1; index--) {
+            HistoricalPose older;
+            if (!readPoseHistory(deviceIndex, index - 1, older)) {
+                return false;
+            }
+
+            if (older.time <= time) {
+                const float t = (float)((time - older.time) / std::max(newer.time - older.time, 1e-9));
+                const auto lerp = [&](const pvrVector3f& a, const pvrVector3f& b, pvrVector3f& result) {
+                    XMStoreFloat3(reinterpret_cast<XMFLOAT3*>(&result),
+                                  XMVectorLerp(XMLoadFloat3(reinterpret_cast<const XMFLOAT3*>(&a)),
+                                               XMLoadFloat3(reinterpret_cast<const XMFLOAT3*>(&b)),
+                                               t));
+                };
+
+                state = newer.state;
+                state.StatusFlags = older.state.StatusFlags & newer.state.StatusFlags;
+                lerp(older.state.ThePose.Position, newer.state.ThePose.Position, state.ThePose.Position);
+                lerp(older.state.LinearVelocity, newer.state.LinearVelocity, state.LinearVelocity);
+                lerp(older.state.AngularVelocity, newer.state.AngularVelocity, state.AngularVelocity);
+                XMStoreFloat4(
+                    reinterpret_cast<XMFLOAT4*>(&state.ThePose.Orientation),
+                    XMQuaternionSlerp(XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&older.state.ThePose.Orientation)),
+                                      XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&newer.state.ThePose.Orientation)),
+                                      t));
+
+                return true;
+            }
+
+            newer = older;
+        }
+
+        // Too far in the past.
+        return false;
+    }
+
 } // namespace pimax_openxr
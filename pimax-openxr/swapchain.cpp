@@ -37,8 +37,10 @@ namespace pimax_openxr {
                                                           uint32_t viewConfigurationTypeCapacityInput,
                                                           uint32_t* viewConfigurationTypeCountOutput,
                                                           XrViewConfigurationType* viewConfigurationTypes) {
-        // We only support Stereo 3D.
-        static const XrViewConfigurationType types[] = {XR_VIEW_CONFIGURATION_TYPE_PRIMARY_STEREO};
+        // We support Stereo 3D, and quad views when the extension is enabled.
+        static const XrViewConfigurationType types[] = {XR_VIEW_CONFIGURATION_TYPE_PRIMARY_STEREO,
+                                                        XR_VIEW_CONFIGURATION_TYPE_PRIMARY_QUAD_VARJO};
+        const uint32_t typesCount = has_XR_VARJO_quad_views ? ARRAYSIZE(types) : 1;
 
         TraceLoggingWrite(g_traceProvider,
                           "xrEnumerateViewConfigurations",
@@ -54,11 +56,11 @@ namespace pimax_openxr {
             return XR_ERROR_SYSTEM_INVALID;
         }
 
-        if (viewConfigurationTypeCapacityInput && viewConfigurationTypeCapacityInput < ARRAYSIZE(types)) {
+        if (viewConfigurationTypeCapacityInput && viewConfigurationTypeCapacityInput < typesCount) {
             return XR_ERROR_SIZE_INSUFFICIENT;
         }
 
-        *viewConfigurationTypeCountOutput = ARRAYSIZE(types);
+        *viewConfigurationTypeCountOutput = typesCount;
         TraceLoggingWrite(g_traceProvider,
                           "xrEnumerateViewConfigurations",
                           TLArg(*viewConfigurationTypeCountOutput, "ViewConfigurationTypeCountOutput"));
@@ -98,11 +100,11 @@ namespace pimax_openxr {
             return XR_ERROR_SYSTEM_INVALID;
         }
 
-        if (viewConfigurationType != XR_VIEW_CONFIGURATION_TYPE_PRIMARY_STEREO) {
+        if (!getViewConfigurationViewCount(viewConfigurationType)) {
             return XR_ERROR_VIEW_CONFIGURATION_TYPE_UNSUPPORTED;
         }
 
-        configurationProperties->viewConfigurationType = XR_VIEW_CONFIGURATION_TYPE_PRIMARY_STEREO;
+        configurationProperties->viewConfigurationType = viewConfigurationType;
         configurationProperties->fovMutable = XR_TRUE;
 
         TraceLoggingWrite(g_traceProvider,
@@ -135,30 +137,37 @@ namespace pimax_openxr {
             return XR_ERROR_SYSTEM_INVALID;
         }
 
-        if (viewConfigurationType != XR_VIEW_CONFIGURATION_TYPE_PRIMARY_STEREO) {
+        const uint32_t viewCount = getViewConfigurationViewCount(viewConfigurationType);
+        if (!viewCount) {
             return XR_ERROR_VIEW_CONFIGURATION_TYPE_UNSUPPORTED;
         }
 
-        if (viewCapacityInput && viewCapacityInput < xr::StereoView::Count) {
+        if (viewCapacityInput && viewCapacityInput < viewCount) {
             return XR_ERROR_SIZE_INSUFFICIENT;
         }
 
-        *viewCountOutput = xr::StereoView::Count;
+        *viewCountOutput = viewCount;
         TraceLoggingWrite(
             g_traceProvider, "xrEnumerateViewConfigurationViews", TLArg(*viewCountOutput, "ViewCountOutput"));
 
         // update cached information
         pvrEyeRenderInfo newEyeInfo[xr::StereoView::Count];
-        if (!pvr_getEyeRenderInfo(m_pvrSession, pvrEye_Left, &newEyeInfo[0])) {
-            bool useParallelProjection = !pvr_getIntConfig(m_pvrSession, "steamvr_use_native_fov", 0);
-            if (m_useParallelProjection != useParallelProjection ||
-                memcmp(&m_cachedEyeInfo[0], &newEyeInfo[0], sizeof(pvrEyeRenderInfo) - 4)) // sans trailing padding
-                if (!pvr_getEyeRenderInfo(m_pvrSession, pvrEye_Right, &newEyeInfo[1])) {
-                    m_useParallelProjection = useParallelProjection;
-                    m_cachedEyeInfo[0] = newEyeInfo[0];
-                    m_cachedEyeInfo[1] = newEyeInfo[1];
-                    updateEyeInfo();
-                }
+        bool hasNewEyeInfo = false;
+        bool useParallelProjection = m_useParallelProjection;
+        {
+            std::unique_lock pvrLock(m_pvrLock);
+            if (!pvr_getEyeRenderInfo(m_pvrSession, pvrEye_Left, &newEyeInfo[0])) {
+                useParallelProjection = !pvr_getIntConfig(m_pvrSession, "steamvr_use_native_fov", 0);
+                if (m_useParallelProjection != useParallelProjection ||
+                    memcmp(&m_cachedEyeInfo[0], &newEyeInfo[0], sizeof(pvrEyeRenderInfo) - 4)) // sans trailing padding
+                    hasNewEyeInfo = !pvr_getEyeRenderInfo(m_pvrSession, pvrEye_Right, &newEyeInfo[1]);
+            }
+        }
+        if (hasNewEyeInfo) {
+            m_useParallelProjection = useParallelProjection;
+            m_cachedEyeInfo[0] = newEyeInfo[0];
+            m_cachedEyeInfo[1] = newEyeInfo[1];
+            updateEyeInfo();
         }
 
         if (viewCapacityInput && views) {
@@ -174,23 +183,10 @@ namespace pimax_openxr {
                 // 8x MSAA for all render target formats except R32G32B32A32 formats.".
                 // We could go and check every supported render target formats to find a possibly higher count, but we
                 // do not bother.
-                // TODO: We do not support MSAA swapchains today, as they are incompatible with our depth conversion and
-                // alpha correction shaders.
-                views[i].maxSwapchainSampleCount = 1;
+                views[i].maxSwapchainSampleCount = 8;
                 views[i].recommendedSwapchainSampleCount = 1;
 
-                // Recommend the resolution with distortion accounted for.
-                // There is a DistortedViewport in the EyeInfo struct, but it does not account for additional transforms
-                // such as parallel projection, so we recompute the resolution based on the actual FOV information.
-                pvrFovPort fov;
-                fov.UpTan = tan(m_cachedEyeFov[i].angleUp);
-                fov.DownTan = tan(-m_cachedEyeFov[i].angleDown);
-                fov.LeftTan = tan(-m_cachedEyeFov[i].angleLeft);
-                fov.RightTan = tan(m_cachedEyeFov[i].angleRight);
-
-                pvrSizei viewportSize;
-                CHECK_PVRCMD(
-                    pvr_getFovTextureSize(m_pvrSession, !i ? pvrEye_Left : pvrEye_Right, fov, 1.f, &viewportSize));
+                const pvrSizei viewportSize = getRecommendedViewSize(i, viewCount);
                 views[i].recommendedImageRectWidth = viewportSize.w;
                 views[i].recommendedImageRectHeight = viewportSize.h;
 
@@ -215,6 +211,70 @@ namespace pimax_openxr {
         return XR_SUCCESS;
     }
 
+    // https://registry.khronos.org/OpenXR/specs/1.0/html/xrspec.html#xrGetRecommendedLayerResolutionMETA
+    XrResult OpenXrRuntime::xrGetRecommendedLayerResolutionMETA(XrSession session,
+                                                                const XrRecommendedLayerResolutionGetInfoMETA* info,
+                                                                XrRecommendedLayerResolutionMETA* resolution) {
+        if (info->type != XR_TYPE_RECOMMENDED_LAYER_RESOLUTION_GET_INFO_META ||
+            resolution->type != XR_TYPE_RECOMMENDED_LAYER_RESOLUTION_META) {
+            return XR_ERROR_VALIDATION_FAILURE;
+        }
+
+        TraceLoggingWrite(g_traceProvider,
+                          "xrGetRecommendedLayerResolutionMETA",
+                          TLXArg(session, "Session"),
+                          TLArg(info->predictedDisplayTime, "PredictedDisplayTime"));
+
+        if (!m_sessionCreated || session != (XrSession)1) {
+            return XR_ERROR_HANDLE_INVALID;
+        }
+
+        if (!info->layer) {
+            return XR_ERROR_VALIDATION_FAILURE;
+        }
+
+        if (info->predictedDisplayTime <= 0) {
+            return XR_ERROR_TIME_INVALID;
+        }
+
+        resolution->isValid = XR_FALSE;
+        resolution->recommendedImageDimensions = {0, 0};
+
+        // We only make recommendations for projection layers, where the app resolution drives the GPU load.
+        if (info->layer->type == XR_TYPE_COMPOSITION_LAYER_PROJECTION) {
+            const auto* proj = reinterpret_cast<const XrCompositionLayerProjection*>(info->layer);
+            if (!proj->viewCount || !proj->views) {
+                return XR_ERROR_VALIDATION_FAILURE;
+            }
+
+            const XrSwapchain swapchain = proj->views[0].subImage.swapchain;
+            if (!m_swapchains.contains(swapchain)) {
+                return XR_ERROR_HANDLE_INVALID;
+            }
+
+            // The recommendation is a fraction of the per-view resolution, clamped to the swapchain, so the app can
+            // keep its swapchain and only adjust the imageRect each frame.
+            const uint32_t viewCount = proj->viewCount == k_quadViewCount && has_XR_VARJO_quad_views
+                                           ? k_quadViewCount
+                                           : xr::StereoView::Count;
+            const pvrSizei viewSize = getRecommendedViewSize(0, viewCount);
+            const Swapchain& xrSwapchain = *m_swapchains.get(swapchain);
+            resolution->recommendedImageDimensions.width =
+                std::clamp((int32_t)(viewSize.w * m_resolutionScale), 1, (int32_t)xrSwapchain.xrDesc.width);
+            resolution->recommendedImageDimensions.height =
+                std::clamp((int32_t)(viewSize.h * m_resolutionScale), 1, (int32_t)xrSwapchain.xrDesc.height);
+            resolution->isValid = XR_TRUE;
+        }
+
+        TraceLoggingWrite(g_traceProvider,
+                          "xrGetRecommendedLayerResolutionMETA",
+                          TLArg(!!resolution->isValid, "IsValid"),
+                          TLArg(resolution->recommendedImageDimensions.width, "RecommendedImageWidth"),
+                          TLArg(resolution->recommendedImageDimensions.height, "RecommendedImageHeight"));
+
+        return XR_SUCCESS;
+    }
+
     // https://www.khronos.org/registry/OpenXR/specs/1.0/html/xrspec.html#xrEnumerateSwapchainFormats
     XrResult OpenXrRuntime::xrEnumerateSwapchainFormats(XrSession session,
                                                         uint32_t formatCapacityInput,
@@ -338,6 +398,16 @@ namespace pimax_openxr {
             LOG_TELEMETRY_ONCE(logFeature("TextureArray"));
         }
 
+        // Serve identical re-creations from the pool of previously destroyed swapchains.
+        if (Swapchain* pooledSwapchain = reusePooledSwapchain(*createInfo)) {
+            *swapchain = m_swapchains.insert(pooledSwapchain);
+
+            TraceLoggingWrite(
+                g_traceProvider, "xrCreateSwapchain", TLXArg(*swapchain, "Swapchain"), TLArg(true, "Recycled"));
+
+            return XR_SUCCESS;
+        }
+
         pvrTextureSwapChainDesc desc{};
 
         desc.Format = isVulkanSession()   ? vkToPvrTextureFormat((VkFormat)createInfo->format)
@@ -378,42 +448,87 @@ namespace pimax_openxr {
         //
         // - PVR does not like the D32_FLOAT_S8X24 format.
         //   To mitigate this, we will create a D32_FLOAT swapchain and perform a conversion during xrEndFrame().
+        //
+        // In addition, we do not let PVR handle multisampled textures: the application renders to multisampled
+        // textures of our own, that we resolve into single-sampled PVR textures during xrEndFrame(). Depth resolve
+        // is done by the conversion shader, so it is only possible for the formats we can convert.
 
         pvrTextureSwapChain pvrSwapchain{};
+        const bool isDepth = createInfo->usageFlags & XR_SWAPCHAIN_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT;
+        const bool needDownsample = createInfo->sampleCount > 1 && (!isDepth || desc.Format == PVR_FORMAT_D32_FLOAT ||
+                                                                    desc.Format == PVR_FORMAT_D32_FLOAT_S8X24_UINT);
         bool needDepthConvert = false;
-        if (desc.Format == PVR_FORMAT_D32_FLOAT_S8X24_UINT) {
+        bool canWriteDirectly = false;
+        if (needDownsample) {
+            desc.SampleCount = 1;
+        }
+        if (desc.Format == PVR_FORMAT_D32_FLOAT_S8X24_UINT || (needDownsample && isDepth)) {
             desc.Format = PVR_FORMAT_D32_FLOAT;
             needDepthConvert = true;
+
+            // The application renders to an intermediate texture, so the PVR texture is only written by our conversion
+            // shader.
+            if (isUnorderedAccessSupported(DXGI_FORMAT_R32_FLOAT)) {
+                desc.BindFlags &= ~pvrTextureBind_DX_DepthStencil;
+                desc.BindFlags |= pvrTextureBind_DX_UnorderedAccess;
+                canWriteDirectly = true;
+            }
+        } else if (!isDepth) {
+            // The PVR textures for the other slices of an array are only written by the runtime.
+            canWriteDirectly = createInfo->arraySize > 1 && isUnorderedAccessSupported(dxgiFormatForSubmission);
+        }
+        int pvrSwapchainLength;
+        {
+            std::unique_lock pvrLock(m_pvrLock);
+            CHECK_PVRCMD(
+                pvr_createTextureSwapChainDX(m_pvrSession, m_pvrSubmissionDevice.Get(), &desc, &pvrSwapchain));
+            CHECK_PVRCMD(pvr_getTextureSwapChainLength(m_pvrSession, pvrSwapchain, &pvrSwapchainLength));
         }
-        CHECK_PVRCMD(pvr_createTextureSwapChainDX(m_pvrSession, m_pvrSubmissionDevice.Get(), &desc, &pvrSwapchain));
 
         // Create the internal struct.
         Swapchain& xrSwapchain = *new Swapchain;
         xrSwapchain.pvrSwapchain.push_back(pvrSwapchain);
-        CHECK_PVRCMD(pvr_getTextureSwapChainLength(m_pvrSession, pvrSwapchain, &xrSwapchain.pvrSwapchainLength));
+        xrSwapchain.pvrSwapchainLength = pvrSwapchainLength;
         xrSwapchain.slices.push_back({});
         xrSwapchain.imagesResourceView.push_back({});
         xrSwapchain.pvrDesc = desc;
         xrSwapchain.xrDesc = *createInfo;
         xrSwapchain.dxgiFormatForSubmission = dxgiFormatForSubmission;
         xrSwapchain.needDepthConvert = needDepthConvert;
+        xrSwapchain.needDownsample = needDownsample;
+        xrSwapchain.canWriteDirectly = canWriteDirectly;
+        xrSwapchain.slicesAccessView.push_back({});
+        xrSwapchain.memorySize = (uint64_t)desc.Width * desc.Height * desc.ArraySize * desc.SampleCount *
+                                 getBytesPerPixel(dxgiFormatForSubmission) * xrSwapchain.pvrSwapchainLength;
+        if (desc.MipLevels > 1) {
+            xrSwapchain.memorySize = xrSwapchain.memorySize * 4 / 3;
+        }
+        if (needDepthConvert) {
+            // Account for the intermediate textures.
+            xrSwapchain.memorySize *= 3;
+        }
+        if (needDownsample) {
+            // Account for the multisampled textures.
+            xrSwapchain.memorySize *= 1 + createInfo->sampleCount;
+        }
 
         // Lazily-filled state.
         for (int i = 1; i < desc.ArraySize; i++) {
             xrSwapchain.pvrSwapchain.push_back(nullptr);
             xrSwapchain.slices.push_back({});
             xrSwapchain.imagesResourceView.push_back({});
+            xrSwapchain.slicesAccessView.push_back({});
         }
 
-        *swapchain = (XrSwapchain)&xrSwapchain;
-
         // Maintain a list of known swapchains for validation and cleanup.
-        m_swapchains.insert(*swapchain);
+        *swapchain = m_swapchains.insert(&xrSwapchain);
 
         TraceLoggingWrite(g_traceProvider,
                           "xrCreateSwapchain",
                           TLXArg(*swapchain, "Swapchain"),
-                          TLArg(needDepthConvert, "needDepthConvert"));
+                          TLArg(needDepthConvert, "needDepthConvert"),
+                          TLArg(needDownsample, "NeedDownsample"),
+                          TLArg(canWriteDirectly, "CanWriteDirectly"));
 
         return XR_SUCCESS;
     }
@@ -424,65 +539,20 @@ namespace pimax_openxr {
 
         TraceLoggingWrite(g_traceProvider, "xrDestroySwapchain", TLXArg(swapchain, "Swapchain"));
 
-        if (!m_swapchains.count(swapchain)) {
+        if (!m_swapchains.contains(swapchain)) {
             return XR_ERROR_HANDLE_INVALID;
         }
 
-        // Make sure there are no pending operations.
-        if (isD3D12Session()) {
-            flushD3D12CommandQueue();
-        } else if (isVulkanSession()) {
-            flushVulkanCommandQueue();
-        } else if (isOpenGLSession()) {
-            flushOpenGLContext();
-        } else {
-            flushD3D11Context();
-        }
-        flushSubmissionContext();
-
-        Swapchain& xrSwapchain = *(Swapchain*)swapchain;
-
-        while (!xrSwapchain.pvrSwapchain.empty()) {
-            auto pvrSwapchain = xrSwapchain.pvrSwapchain.back();
-            if (pvrSwapchain) {
-                pvr_destroyTextureSwapChain(m_pvrSession, pvrSwapchain);
-            }
-            xrSwapchain.pvrSwapchain.pop_back();
-        }
-
-        if (xrSwapchain.vkCmdBuffer != VK_NULL_HANDLE) {
-            m_vkDispatch.vkResetCommandBuffer(xrSwapchain.vkCmdBuffer, VK_COMMAND_BUFFER_RESET_RELEASE_RESOURCES_BIT);
-            m_vkDispatch.vkFreeCommandBuffers(m_vkDevice, m_vkCmdPool, 1, &xrSwapchain.vkCmdBuffer);
-        }
-
-        while (!xrSwapchain.vkImages.empty()) {
-            m_vkDispatch.vkDestroyImage(m_vkDevice, xrSwapchain.vkImages.back(), m_vkAllocator);
-            xrSwapchain.vkImages.pop_back();
-        }
-
-        while (!xrSwapchain.vkDeviceMemory.empty()) {
-            m_vkDispatch.vkFreeMemory(m_vkDevice, xrSwapchain.vkDeviceMemory.back(), m_vkAllocator);
-            xrSwapchain.vkDeviceMemory.pop_back();
-        }
-
-        // This will be a no-op if OpenGL is not used.
-        GlContextSwitch context(m_glContext);
-
-        while (!xrSwapchain.glImages.empty()) {
-            GLuint image = xrSwapchain.glImages.back();
-            glDeleteTextures(1, &image);
-            xrSwapchain.glImages.pop_back();
-        }
+        Swapchain& xrSwapchain = *m_swapchains.get(swapchain);
 
-        while (!xrSwapchain.glMemory.empty()) {
-            GLuint memory = xrSwapchain.glMemory.back();
-            m_glDispatch.glDeleteMemoryObjectsEXT(1, &memory);
-            xrSwapchain.glMemory.pop_back();
+        if (!recycleSwapchain(xrSwapchain)) {
+            retireSwapchain(xrSwapchain);
         }
-
-        delete &xrSwapchain;
         m_swapchains.erase(swapchain);
 
+        // Opportunistically release the swapchains that the GPU is done with.
+        collectRetiredSwapchains();
+
         return XR_SUCCESS;
     }
 
@@ -498,11 +568,11 @@ namespace pimax_openxr {
                           TLXArg(swapchain, "Swapchain"),
                           TLArg(imageCapacityInput, "ImageCapacityInput"));
 
-        if (!m_swapchains.count(swapchain)) {
+        if (!m_swapchains.contains(swapchain)) {
             return XR_ERROR_HANDLE_INVALID;
         }
 
-        Swapchain& xrSwapchain = *(Swapchain*)swapchain;
+        Swapchain& xrSwapchain = *m_swapchains.get(swapchain);
 
         int count = !xrSwapchain.pvrDesc.StaticImage ? xrSwapchain.pvrSwapchainLength : 1;
 
@@ -544,11 +614,11 @@ namespace pimax_openxr {
 
         TraceLoggingWrite(g_traceProvider, "xrAcquireSwapchainImage", TLXArg(swapchain, "Swapchain"));
 
-        if (!m_swapchains.count(swapchain)) {
+        if (!m_swapchains.contains(swapchain)) {
             return XR_ERROR_HANDLE_INVALID;
         }
 
-        Swapchain& xrSwapchain = *(Swapchain*)swapchain;
+        Swapchain& xrSwapchain = *m_swapchains.get(swapchain);
 
         // Check that we can acquire an image.
         if (xrSwapchain.frozen || xrSwapchain.acquiredIndices.size() == xrSwapchain.pvrSwapchainLength) {
@@ -557,9 +627,10 @@ namespace pimax_openxr {
 
         // Query the image index from PVR.
         int imageIndex = xrSwapchain.nextIndex;
-        if (!xrSwapchain.needDepthConvert && xrSwapchain.acquiredIndices.empty()) {
+        if (!xrSwapchain.needDepthConvert && !xrSwapchain.needDownsample && xrSwapchain.acquiredIndices.empty()) {
             // "Re-synchronize" to the underlying swapchain. This should not be needed, but add robustness in case of a
             // bug.
+            std::unique_lock pvrLock(m_pvrLock);
             CHECK_PVRCMD(pvr_getTextureSwapChainCurrentIndex(m_pvrSession, xrSwapchain.pvrSwapchain[0], &imageIndex));
         }
 
@@ -572,6 +643,11 @@ namespace pimax_openxr {
             }
         }
 
+        // Without intermediate textures, the application renders directly to the PVR image.
+        if (!xrSwapchain.needDepthConvert && !xrSwapchain.needDownsample && !xrSwapchain.slicesVersion.empty()) {
+            xrSwapchain.slicesVersion[0][imageIndex] = 0;
+        }
+
         xrSwapchain.acquiredIndices.push_back(imageIndex);
         xrSwapchain.frozen = xrSwapchain.pvrDesc.StaticImage;
         xrSwapchain.nextIndex = imageIndex + 1;
@@ -598,11 +674,11 @@ namespace pimax_openxr {
                           TLXArg(swapchain, "Swapchain"),
                           TLArg(waitInfo->timeout, "Timeout"));
 
-        if (!m_swapchains.count(swapchain)) {
+        if (!m_swapchains.contains(swapchain)) {
             return XR_ERROR_HANDLE_INVALID;
         }
 
-        Swapchain& xrSwapchain = *(Swapchain*)swapchain;
+        Swapchain& xrSwapchain = *m_swapchains.get(swapchain);
 
         // Check an image is acquired but not waited.
         if (xrSwapchain.acquiredIndices.empty() || xrSwapchain.acquiredIndices.front() == xrSwapchain.lastWaitedIndex) {
@@ -626,11 +702,11 @@ namespace pimax_openxr {
 
         TraceLoggingWrite(g_traceProvider, "xrReleaseSwapchainImage", TLXArg(swapchain, "Swapchain"));
 
-        if (!m_swapchains.count(swapchain)) {
+        if (!m_swapchains.contains(swapchain)) {
             return XR_ERROR_HANDLE_INVALID;
         }
 
-        Swapchain& xrSwapchain = *(Swapchain*)swapchain;
+        Swapchain& xrSwapchain = *m_swapchains.get(swapchain);
 
         // Check an image is acquired and waited.
         if (xrSwapchain.acquiredIndices.empty() || xrSwapchain.acquiredIndices.front() != xrSwapchain.lastWaitedIndex) {
@@ -648,10 +724,228 @@ namespace pimax_openxr {
 
         // We will commit the texture to PVR during xrEndFrame() in order to handle texture arrays properly.
         xrSwapchain.lastReleasedIndex = xrSwapchain.lastWaitedIndex;
+        xrSwapchain.releasedVersion++;
         xrSwapchain.lastWaitedIndex = -1;
         xrSwapchain.acquiredIndices.pop_front();
 
         return XR_SUCCESS;
     }
 
+    // Returns the number of views for the view configuration, or 0 if it is not supported.
+    uint32_t OpenXrRuntime::getViewConfigurationViewCount(XrViewConfigurationType viewConfigurationType) const {
+        if (viewConfigurationType == XR_VIEW_CONFIGURATION_TYPE_PRIMARY_STEREO) {
+            return xr::StereoView::Count;
+        } else if (viewConfigurationType == XR_VIEW_CONFIGURATION_TYPE_PRIMARY_QUAD_VARJO && has_XR_VARJO_quad_views) {
+            return k_quadViewCount;
+        }
+        return 0;
+    }
+
+    // Recommend the resolution with distortion accounted for.
+    // There is a DistortedViewport in the EyeInfo struct, but it does not account for additional transforms such as
+    // parallel projection, so we recompute the resolution based on the actual FOV information.
+    // With quad views, the context views are rendered at a lower pixel density than the focus views.
+    pvrSizei OpenXrRuntime::getRecommendedViewSize(uint32_t viewIndex, uint32_t viewCount) const {
+        const uint32_t eye = viewIndex % xr::StereoView::Count;
+        const bool isFocusView = viewIndex >= xr::StereoView::Count;
+        const XrFovf& viewFov = isFocusView ? m_cachedFocusFov[eye] : m_cachedEyeFov[eye];
+        const float density = viewCount == k_quadViewCount && !isFocusView ? m_peripheralDensity : 1.f;
+        pvrFovPort fov;
+        fov.UpTan = tan(viewFov.angleUp);
+        fov.DownTan = tan(-viewFov.angleDown);
+        fov.LeftTan = tan(-viewFov.angleLeft);
+        fov.RightTan = tan(viewFov.angleRight);
+        if (viewCount == xr::StereoView::Count && isCantedReprojectionEnabled()) {
+            // The parallel views are reprojected onto the canted views before submission, so only the native canted
+            // resolution is needed.
+            fov = m_cachedEyeInfo[eye].Fov;
+        }
+
+        std::unique_lock pvrLock(m_pvrLock);
+        pvrSizei viewportSize;
+        CHECK_PVRCMD(
+            pvr_getFovTextureSize(m_pvrSession, !eye ? pvrEye_Left : pvrEye_Right, fov, density, &viewportSize));
+        return viewportSize;
+    }
+
+    // Release all the resources of a swapchain.
+    // The GPU must be done with the swapchain, see retireSwapchain().
+    void OpenXrRuntime::destroySwapchainResources(Swapchain& xrSwapchain) {
+        while (!xrSwapchain.pvrSwapchain.empty()) {
+            auto pvrSwapchain = xrSwapchain.pvrSwapchain.back();
+            if (pvrSwapchain) {
+                std::unique_lock pvrLock(m_pvrLock);
+                pvr_destroyTextureSwapChain(m_pvrSession, pvrSwapchain);
+            }
+            xrSwapchain.pvrSwapchain.pop_back();
+        }
+
+        for (auto cmdBuffers : {&xrSwapchain.vkAcquireCmdBuffers, &xrSwapchain.vkReleaseCmdBuffers}) {
+            if (!cmdBuffers->empty()) {
+                m_vkDispatch.vkFreeCommandBuffers(
+                    m_vkDevice, m_vkCmdPool, (uint32_t)cmdBuffers->size(), cmdBuffers->data());
+                cmdBuffers->clear();
+            }
+        }
+
+        while (!xrSwapchain.vkImages.empty()) {
+            m_vkDispatch.vkDestroyImage(m_vkDevice, xrSwapchain.vkImages.back(), m_vkAllocator);
+            xrSwapchain.vkImages.pop_back();
+        }
+
+        while (!xrSwapchain.vkDeviceMemory.empty()) {
+            m_vkDispatch.vkFreeMemory(m_vkDevice, xrSwapchain.vkDeviceMemory.back(), m_vkAllocator);
+            xrSwapchain.vkDeviceMemory.pop_back();
+        }
+
+        // This will be a no-op if OpenGL is not used.
+        GlContextSwitch context(m_glContext);
+
+        while (!xrSwapchain.glImages.empty()) {
+            GLuint image = xrSwapchain.glImages.back();
+            glDeleteTextures(1, &image);
+            xrSwapchain.glImages.pop_back();
+        }
+
+        while (!xrSwapchain.glMemory.empty()) {
+            GLuint memory = xrSwapchain.glMemory.back();
+            m_glDispatch.glDeleteMemoryObjectsEXT(1, &memory);
+            xrSwapchain.glMemory.pop_back();
+        }
+    }
+
+    // Queue the destruction of a swapchain until the GPU is done with it. Rather than draining the application and
+    // submission pipelines, we fence the work submitted so far and let collectRetiredSwapchains() check the fence.
+    void OpenXrRuntime::retireSwapchain(Swapchain& xrSwapchain) {
+        // The submission thread might still reference the swapchain.
+        waitForPendingSubmission();
+
+        // Make the submission context wait for the work submitted by the application, then fence them both.
+        if (isD3D12Session()) {
+            serializeD3D12Frame();
+        } else if (isVulkanSession()) {
+            serializeVulkanFrame();
+        } else if (isOpenGLSession()) {
+            serializeOpenGLFrame();
+        } else {
+            serializeD3D11Frame();
+        }
+        m_fenceValue++;
+        CHECK_HRCMD(m_pvrSubmissionContext->Signal(m_pvrSubmissionFence.Get(), m_fenceValue));
+
+        TraceLoggingWrite(g_traceProvider,
+                          "RetireSwapchain",
+                          TLPArg(&xrSwapchain, "Swapchain"),
+                          TLArg(m_fenceValue, "FenceValue"));
+
+        m_retiredSwapchains.push_back({m_fenceValue, &xrSwapchain});
+    }
+
+    void OpenXrRuntime::collectRetiredSwapchains(bool waitForAll) {
+        if (m_retiredSwapchains.empty()) {
+            return;
+        }
+
+        if (waitForAll) {
+            if (isD3D12Session()) {
+                flushD3D12CommandQueue();
+            } else if (isVulkanSession()) {
+                flushVulkanCommandQueue();
+            } else if (isOpenGLSession()) {
+                flushOpenGLContext();
+            } else {
+                flushD3D11Context();
+            }
+            flushSubmissionContext();
+        }
+
+        // Fence values are increasing, so the queue is ordered.
+        const UINT64 completedValue = m_pvrSubmissionFence->GetCompletedValue();
+        while (!m_retiredSwapchains.empty() && m_retiredSwapchains.front().first <= completedValue) {
+            Swapchain& xrSwapchain = *m_retiredSwapchains.front().second;
+            m_retiredSwapchains.pop_front();
+
+            TraceLoggingWrite(g_traceProvider, "DestroySwapchain", TLPArg(&xrSwapchain, "Swapchain"));
+            destroySwapchainResources(xrSwapchain);
+            delete &xrSwapchain;
+        }
+    }
+
+    // Look for a swapchain in the pool that is identical to the requested one.
+    OpenXrRuntime::Swapchain* OpenXrRuntime::reusePooledSwapchain(const XrSwapchainCreateInfo& createInfo) {
+        for (auto it = m_swapchainPool.begin(); it != m_swapchainPool.end(); it++) {
+            Swapchain& xrSwapchain = **it;
+            const auto& xrDesc = xrSwapchain.xrDesc;
+            if (xrDesc.createFlags != createInfo.createFlags || xrDesc.usageFlags != createInfo.usageFlags ||
+                xrDesc.format != createInfo.format || xrDesc.sampleCount != createInfo.sampleCount ||
+                xrDesc.width != createInfo.width || xrDesc.height != createInfo.height ||
+                xrDesc.faceCount != createInfo.faceCount || xrDesc.arraySize != createInfo.arraySize ||
+                xrDesc.mipCount != createInfo.mipCount) {
+                continue;
+            }
+
+            m_swapchainPool.erase(it);
+            m_swapchainPoolSize -= xrSwapchain.memorySize;
+
+            // Reset the state as if the swapchain was freshly created. The images were all released by the app.
+            xrSwapchain.acquiredIndices.clear();
+            xrSwapchain.lastWaitedIndex = -1;
+            xrSwapchain.lastReleasedIndex = -1;
+            xrSwapchain.frozen = false;
+            xrSwapchain.nextIndex = 0;
+            xrSwapchain.lastProcessedIndex = -1;
+            xrSwapchain.xrDesc = createInfo;
+            xrSwapchain.xrDesc.next = nullptr;
+
+            TraceLoggingWrite(g_traceProvider,
+                              "SwapchainPool_Reuse",
+                              TLPArg(&xrSwapchain, "Swapchain"),
+                              TLArg(m_swapchainPoolSize, "PoolSize"));
+
+            return &xrSwapchain;
+        }
+
+        return nullptr;
+    }
+
+    // Keep a destroyed swapchain for re-use, within the memory budget. Returns false if the swapchain must be
+    // destroyed.
+    bool OpenXrRuntime::recycleSwapchain(Swapchain& xrSwapchain) {
+        // Static images can only be committed once, and images still acquired would leave the resources in an
+        // unknown state.
+        if (xrSwapchain.memorySize > m_swapchainPoolBudget || xrSwapchain.pvrDesc.StaticImage ||
+            !xrSwapchain.acquiredIndices.empty()) {
+            return false;
+        }
+
+        m_swapchainPool.push_back(&xrSwapchain);
+        m_swapchainPoolSize += xrSwapchain.memorySize;
+
+        // Evict the oldest entries.
+        while (m_swapchainPoolSize > m_swapchainPoolBudget) {
+            Swapchain& evicted = *m_swapchainPool.front();
+            m_swapchainPool.pop_front();
+            m_swapchainPoolSize -= evicted.memorySize;
+
+            TraceLoggingWrite(g_traceProvider, "SwapchainPool_Evict", TLPArg(&evicted, "Swapchain"));
+            retireSwapchain(evicted);
+        }
+
+        TraceLoggingWrite(g_traceProvider,
+                          "SwapchainPool_Recycle",
+                          TLPArg(&xrSwapchain, "Swapchain"),
+                          TLArg(m_swapchainPoolSize, "PoolSize"));
+
+        return true;
+    }
+
+    void OpenXrRuntime::flushSwapchainPool() {
+        while (!m_swapchainPool.empty()) {
+            Swapchain& xrSwapchain = *m_swapchainPool.front();
+            m_swapchainPool.pop_front();
+            retireSwapchain(xrSwapchain);
+        }
+        m_swapchainPoolSize = 0;
+    }
+
 } // namespace pimax_openxr
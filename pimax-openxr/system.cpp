@@ -64,7 +64,10 @@ namespace pimax_openxr {
 
         // Check for HMD presence.
         pvrHmdStatus status{};
-        CHECK_PVRCMD(pvr_getHmdStatus(m_pvrSession, &status));
+        {
+            std::unique_lock pvrLock(m_pvrLock);
+            CHECK_PVRCMD(pvr_getHmdStatus(m_pvrSession, &status));
+        }
         TraceLoggingWrite(g_traceProvider,
                           "PVR_HmdStatus",
                           TLArg(!!status.ServiceReady, "ServiceReady"),
@@ -78,7 +81,10 @@ namespace pimax_openxr {
         }
 
         // Query HMD properties.
-        CHECK_PVRCMD(pvr_getHmdInfo(m_pvrSession, &m_cachedHmdInfo));
+        {
+            std::unique_lock pvrLock(m_pvrLock);
+            CHECK_PVRCMD(pvr_getHmdInfo(m_pvrSession, &m_cachedHmdInfo));
+        }
         TraceLoggingWrite(g_traceProvider,
                           "PVR_HmdInfo",
                           TLArg(m_cachedHmdInfo.VendorId, "VendorId"),
@@ -97,21 +103,54 @@ namespace pimax_openxr {
         }
 
         // Cache common information.
-        m_floorHeight = pvr_getFloatConfig(m_pvrSession, CONFIG_KEY_EYE_HEIGHT, 0.f);
+        {
+            std::unique_lock pvrLock(m_pvrLock);
+            m_floorHeight = pvr_getFloatConfig(m_pvrSession, CONFIG_KEY_EYE_HEIGHT, 0.f);
+        }
         TraceLoggingWrite(g_traceProvider,
                           "PVR_GetConfig",
                           TLArg(CONFIG_KEY_EYE_HEIGHT, "Config"),
                           TLArg(m_floorHeight, "EyeHeight"));
 
-        CHECK_PVRCMD(pvr_getEyeRenderInfo(m_pvrSession, pvrEye_Left, &m_cachedEyeInfo[0]));
-        CHECK_PVRCMD(pvr_getEyeRenderInfo(m_pvrSession, pvrEye_Right, &m_cachedEyeInfo[1]));
+        // Quad views: the focus views cover a fraction of the eye FOV, and the context views are rendered at a reduced
+        // pixel density.
+        m_focusFovScale = std::clamp(getSetting("focus_fov_percent").value_or(50), 10, 100) / 100.f;
+        m_peripheralDensity = std::clamp(getSetting("peripheral_density_percent").value_or(50), 10, 100) / 100.f;
+
+        // Eye tracking is only reported by the PVR service when an eye tracker module is present.
+        {
+            pvrEyeTrackingInfo info{};
+            {
+                std::unique_lock pvrLock(m_pvrLock);
+                m_isEyeTrackingAvailable =
+                    pvr_getEyeTrackingInfo(m_pvrSession, pvr_getTimeSeconds(m_pvr), &info) == pvr_success;
+            }
+            TraceLoggingWrite(g_traceProvider,
+                              "PVR_EyeTrackingInfo",
+                              TLArg(m_isEyeTrackingAvailable, "Available"),
+                              TLArg(info.TimeInSeconds, "TimeInSeconds"));
+        }
+        m_useEyeTrackedFoveation = getSetting("eye_tracked_foveation").value_or(1);
+        m_useCantedReprojection = getSetting("canted_reprojection").value_or(0);
+
+        {
+            std::unique_lock pvrLock(m_pvrLock);
+            CHECK_PVRCMD(pvr_getEyeRenderInfo(m_pvrSession, pvrEye_Left, &m_cachedEyeInfo[0]));
+            CHECK_PVRCMD(pvr_getEyeRenderInfo(m_pvrSession, pvrEye_Right, &m_cachedEyeInfo[1]));
+        }
         updateEyeInfo();
         if (m_useParallelProjection && m_cantingAngle) {
             Log("Parallel projection is enabled\n");
+            if (m_useCantedReprojection) {
+                Log("Canted reprojection is enabled\n");
+            }
         }
 
         // Setup common parameters.
-        CHECK_PVRCMD(pvr_setTrackingOriginType(m_pvrSession, pvrTrackingOrigin_EyeLevel));
+        {
+            std::unique_lock pvrLock(m_pvrLock);
+            CHECK_PVRCMD(pvr_setTrackingOriginType(m_pvrSession, pvrTrackingOrigin_EyeLevel));
+        }
 
         m_systemCreated = true;
         *systemId = (XrSystemId)1;
@@ -152,6 +191,29 @@ namespace pimax_openxr {
             }
         }
 
+        XrSystemEyeGazeInteractionPropertiesEXT* eyeGazeInteractionProperties =
+            reinterpret_cast<XrSystemEyeGazeInteractionPropertiesEXT*>(properties->next);
+        if (has_XR_EXT_eye_gaze_interaction) {
+            while (eyeGazeInteractionProperties) {
+                if (eyeGazeInteractionProperties->type == XR_TYPE_SYSTEM_EYE_GAZE_INTERACTION_PROPERTIES_EXT) {
+                    break;
+                }
+                eyeGazeInteractionProperties =
+                    reinterpret_cast<XrSystemEyeGazeInteractionPropertiesEXT*>(eyeGazeInteractionProperties->next);
+            }
+        }
+
+        XrSystemSpaceWarpPropertiesFB* spaceWarpProperties =
+            reinterpret_cast<XrSystemSpaceWarpPropertiesFB*>(properties->next);
+        if (has_XR_FB_space_warp) {
+            while (spaceWarpProperties) {
+                if (spaceWarpProperties->type == XR_TYPE_SYSTEM_SPACE_WARP_PROPERTIES_FB) {
+                    break;
+                }
+                spaceWarpProperties = reinterpret_cast<XrSystemSpaceWarpPropertiesFB*>(spaceWarpProperties->next);
+            }
+        }
+
         properties->vendorId = m_cachedHmdInfo.VendorId;
 
         // We include the "aapvr" string because some applications like OpenXR Toolkit rely on this string to
@@ -187,6 +249,38 @@ namespace pimax_openxr {
                               TLArg(!!handTrackingProperties->supportsHandTracking, "SupportsHandTracking"));
         }
 
+        if (spaceWarpProperties) {
+            // Motion vectors do not need the full resolution.
+            pvrFovPort fov;
+            fov.UpTan = tan(m_cachedEyeFov[0].angleUp);
+            fov.DownTan = tan(-m_cachedEyeFov[0].angleDown);
+            fov.LeftTan = tan(-m_cachedEyeFov[0].angleLeft);
+            fov.RightTan = tan(m_cachedEyeFov[0].angleRight);
+            pvrSizei size;
+            std::unique_lock pvrLock(m_pvrLock);
+            CHECK_PVRCMD(pvr_getFovTextureSize(m_pvrSession, pvrEye_Left, fov, 0.5f, &size));
+            spaceWarpProperties->recommendedMotionVectorImageRectWidth = size.w;
+            spaceWarpProperties->recommendedMotionVectorImageRectHeight = size.h;
+
+            TraceLoggingWrite(g_traceProvider,
+                              "xrGetSystemProperties",
+                              TLArg((int)properties->systemId, "SystemId"),
+                              TLArg(spaceWarpProperties->recommendedMotionVectorImageRectWidth,
+                                    "RecommendedMotionVectorImageRectWidth"),
+                              TLArg(spaceWarpProperties->recommendedMotionVectorImageRectHeight,
+                                    "RecommendedMotionVectorImageRectHeight"));
+        }
+
+        if (eyeGazeInteractionProperties) {
+            eyeGazeInteractionProperties->supportsEyeGazeInteraction = m_isEyeTrackingAvailable ? XR_TRUE : XR_FALSE;
+
+            TraceLoggingWrite(
+                g_traceProvider,
+                "xrGetSystemProperties",
+                TLArg((int)properties->systemId, "SystemId"),
+                TLArg(!!eyeGazeInteractionProperties->supportsEyeGazeInteraction, "SupportsEyeGazeInteraction"));
+        }
+
         return XR_SUCCESS;
     }
 
@@ -215,7 +309,7 @@ namespace pimax_openxr {
             return XR_ERROR_SYSTEM_INVALID;
         }
 
-        if (viewConfigurationType != XR_VIEW_CONFIGURATION_TYPE_PRIMARY_STEREO) {
+        if (!getViewConfigurationViewCount(viewConfigurationType)) {
             return XR_ERROR_VIEW_CONFIGURATION_TYPE_UNSUPPORTED;
         }
 
@@ -263,13 +357,50 @@ namespace pimax_openxr {
                 m_cachedEyeFov[i].angleUp += PVR::DegreeToRad(6.f);
                 m_cachedEyeFov[i].angleDown -= PVR::DegreeToRad(6.f);
             }
+
+            // The focus views are centered on the optical axis of the lens, which is shifted by the canting angle with
+            // parallel projection.
+            const float shift = m_useParallelProjection && m_cantingAngle ? (i == 0 ? -m_cantingAngle : m_cantingAngle)
+                                                                          : 0.f;
+            m_cachedFocusFov[i].angleDown =
+                std::max(m_cachedEyeFov[i].angleDown, -atan(m_cachedEyeInfo[i].Fov.DownTan * m_focusFovScale));
+            m_cachedFocusFov[i].angleUp =
+                std::min(m_cachedEyeFov[i].angleUp, atan(m_cachedEyeInfo[i].Fov.UpTan * m_focusFovScale));
+            m_cachedFocusFov[i].angleLeft =
+                std::max(m_cachedEyeFov[i].angleLeft, shift - atan(m_cachedEyeInfo[i].Fov.LeftTan * m_focusFovScale));
+            m_cachedFocusFov[i].angleRight =
+                std::min(m_cachedEyeFov[i].angleRight, shift + atan(m_cachedEyeInfo[i].Fov.RightTan * m_focusFovScale));
         }
+
+        // Views located with the previous eye info are now stale.
+        invalidatePoseCache();
+
+        // So are the visibility masks.
+        {
+            std::unique_lock lock(m_visibilityMaskLock);
+            for (uint32_t i = 0; i < xr::StereoView::Count; i++) {
+                m_visibilityMasksValid[i] = false;
+                m_tileMasks[i].valid = false;
+            }
+            if (m_sessionCreated && has_XR_KHR_visibility_mask) {
+                m_visibilityMaskChangedViews = (1u << xr::StereoView::Count) - 1;
+            }
+        }
+    }
+
+    // Whether the stereo views rendered with parallel projection are reprojected onto the canted views of the panels
+    // before submission.
+    bool OpenXrRuntime::isCantedReprojectionEnabled() const {
+        return m_useCantedReprojection && m_useParallelProjection && m_cantingAngle;
     }
 
     // Retrieve some information from PVR needed for graphic/frame management.
     void OpenXrRuntime::fillDisplayDeviceInfo() {
         pvrDisplayInfo info{};
-        CHECK_PVRCMD(pvr_getEyeDisplayInfo(m_pvrSession, pvrEye_Left, &info));
+        {
+            std::unique_lock pvrLock(m_pvrLock);
+            CHECK_PVRCMD(pvr_getEyeDisplayInfo(m_pvrSession, pvrEye_Left, &info));
+        }
         TraceLoggingWrite(g_traceProvider,
                           "PVR_EyeDisplayInfo",
                           TraceLoggingCharArray((char*)&info.luid, sizeof(LUID), "Luid"),
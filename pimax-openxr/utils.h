@@ -65,6 +65,10 @@ namespace xr {
                            pose.orientation.w);
     }
 
+    static inline std::string ToString(pvrVector2f vec) {
+        return fmt::format("({:.3f}, {:.3f})", vec.x, vec.y);
+    }
+
     static inline std::string ToString(pvrVector3f vec) {
         return fmt::format("({:.3f}, {:.3f}, {:.3f})", vec.x, vec.y, vec.z);
     }
@@ -265,6 +269,688 @@ namespace pimax_openxr::utils {
         mutable bool m_valid{false};
     };
 
+    // A GPU asynchronous timer for a D3D12 queue. The command lists are recorded once and replayed every frame.
+    struct D3D12GpuTimer : public ITimer {
+        D3D12GpuTimer(ID3D12Device* device, ID3D12CommandQueue* queue) : m_queue(queue) {
+            D3D12_QUERY_HEAP_DESC heapDesc{};
+            heapDesc.Type = D3D12_QUERY_HEAP_TYPE_TIMESTAMP;
+            heapDesc.Count = 2;
+            CHECK_HRCMD(device->CreateQueryHeap(&heapDesc, IID_PPV_ARGS(m_queryHeap.ReleaseAndGetAddressOf())));
+
+            D3D12_HEAP_PROPERTIES heapProperties{};
+            heapProperties.Type = D3D12_HEAP_TYPE_READBACK;
+            D3D12_RESOURCE_DESC bufferDesc{};
+            bufferDesc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
+            bufferDesc.Width = 2 * sizeof(UINT64);
+            bufferDesc.Height = bufferDesc.DepthOrArraySize = bufferDesc.MipLevels = 1;
+            bufferDesc.SampleDesc.Count = 1;
+            bufferDesc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
+            CHECK_HRCMD(device->CreateCommittedResource(&heapProperties,
+                                                        D3D12_HEAP_FLAG_NONE,
+                                                        &bufferDesc,
+                                                        D3D12_RESOURCE_STATE_COPY_DEST,
+                                                        nullptr,
+                                                        IID_PPV_ARGS(m_readbackBuffer.ReleaseAndGetAddressOf())));
+            CHECK_HRCMD(device->CreateFence(0, D3D12_FENCE_FLAG_NONE, IID_PPV_ARGS(m_fence.ReleaseAndGetAddressOf())));
+
+            const auto type = queue->GetDesc().Type;
+            CHECK_HRCMD(
+                device->CreateCommandAllocator(type, IID_PPV_ARGS(m_commandAllocator.ReleaseAndGetAddressOf())));
+            CHECK_HRCMD(device->CreateCommandList(0,
+                                                  type,
+                                                  m_commandAllocator.Get(),
+                                                  nullptr,
+                                                  IID_PPV_ARGS(m_startCommandList.ReleaseAndGetAddressOf())));
+            m_startCommandList->EndQuery(m_queryHeap.Get(), D3D12_QUERY_TYPE_TIMESTAMP, 0);
+            CHECK_HRCMD(m_startCommandList->Close());
+            CHECK_HRCMD(device->CreateCommandList(0,
+                                                  type,
+                                                  m_commandAllocator.Get(),
+                                                  nullptr,
+                                                  IID_PPV_ARGS(m_stopCommandList.ReleaseAndGetAddressOf())));
+            m_stopCommandList->EndQuery(m_queryHeap.Get(), D3D12_QUERY_TYPE_TIMESTAMP, 1);
+            m_stopCommandList->ResolveQueryData(
+                m_queryHeap.Get(), D3D12_QUERY_TYPE_TIMESTAMP, 0, 2, m_readbackBuffer.Get(), 0);
+            CHECK_HRCMD(m_stopCommandList->Close());
+
+            CHECK_HRCMD(queue->GetTimestampFrequency(&m_frequency));
+        }
+
+        void start() override {
+            ID3D12CommandList* const lists[] = {m_startCommandList.Get()};
+            m_queue->ExecuteCommandLists(1, lists);
+        }
+
+        void stop() override {
+            ID3D12CommandList* const lists[] = {m_stopCommandList.Get()};
+            m_queue->ExecuteCommandLists(1, lists);
+            CHECK_HRCMD(m_queue->Signal(m_fence.Get(), ++m_fenceValue));
+            m_valid = true;
+        }
+
+        uint64_t query(bool reset = true) const override {
+            uint64_t duration = 0;
+            if (m_valid) {
+                // Never block: if the GPU is not done yet, we just report no measurement.
+                if (m_fence->GetCompletedValue() >= m_fenceValue && m_frequency) {
+                    const D3D12_RANGE readRange{0, 2 * sizeof(UINT64)};
+                    UINT64* timestamps = nullptr;
+                    if (SUCCEEDED(m_readbackBuffer->Map(0, &readRange, reinterpret_cast<void**>(&timestamps)))) {
+                        if (timestamps[1] > timestamps[0]) {
+                            duration = static_cast<uint64_t>(((timestamps[1] - timestamps[0]) * 1e6) / m_frequency);
+                        }
+                        const D3D12_RANGE writeRange{0, 0};
+                        m_readbackBuffer->Unmap(0, &writeRange);
+                    }
+                }
+                m_valid = !reset;
+            }
+            return duration;
+        }
+
+      private:
+        const ComPtr<ID3D12CommandQueue> m_queue;
+        ComPtr<ID3D12QueryHeap> m_queryHeap;
+        ComPtr<ID3D12Resource> m_readbackBuffer;
+        ComPtr<ID3D12CommandAllocator> m_commandAllocator;
+        ComPtr<ID3D12GraphicsCommandList> m_startCommandList;
+        ComPtr<ID3D12GraphicsCommandList> m_stopCommandList;
+        ComPtr<ID3D12Fence> m_fence;
+        UINT64 m_fenceValue{0};
+        UINT64 m_frequency{0};
+
+        // Can the timer be queried (it might still only read 0).
+        mutable bool m_valid{false};
+    };
+
+    // A frame counter that threads can wait on without holding a lock.
+    class FrameCounter {
+      public:
+        FrameCounter& operator=(const FrameCounter& other) {
+            return *this = (uint64_t)other;
+        }
+
+        FrameCounter& operator=(uint64_t value) {
+            m_value.store(value);
+            WakeByAddressAll(&m_value);
+            return *this;
+        }
+
+        // Like std::atomic, returns the value before the increment.
+        uint64_t operator++(int) {
+            const uint64_t previous = m_value.fetch_add(1);
+            WakeByAddressAll(&m_value);
+            return previous;
+        }
+
+        operator uint64_t() const {
+            return m_value.load();
+        }
+
+        // Block until the value of the counter matches the predicate.
+        template <typename Predicate>
+        void waitFor(Predicate predicate) const {
+            uint64_t value = m_value.load();
+            while (!predicate(value)) {
+                WaitOnAddress((volatile void*)&m_value, &value, sizeof(value), INFINITE);
+                value = m_value.load();
+            }
+        }
+
+      private:
+        std::atomic<uint64_t> m_value{0};
+        static_assert(sizeof(m_value) == sizeof(uint64_t));
+    };
+
+    // An adaptive predictor for the frame time, based on an exponentially-weighted moving average and variance.
+    // Isolated outliers are rejected, while persistent changes of load are adopted immediately.
+    class FrameTimePredictor {
+      public:
+        void reset() {
+            m_initialized = false;
+            m_outlierCount = 0;
+        }
+
+        // Add a new measurement and return the predicted frame time.
+        uint64_t update(double sampleUs) {
+            if (!m_initialized) {
+                m_mean = sampleUs;
+                m_variance = 0;
+                m_initialized = true;
+                return predict();
+            }
+
+            const double deviation = sampleUs - m_mean;
+            const double stddev = std::max(std::sqrt(m_variance), k_minStddevUs);
+            // Only unusually short frames are rejected as outliers. Longer frames are adopted immediately, since
+            // underestimating a load spike causes missed frames.
+            if (-deviation > k_outlierThreshold * stddev) {
+                if (++m_outlierCount < k_maxConsecutiveOutliers) {
+                    return predict();
+                }
+
+                // The load changed: restart from the latest measurement.
+                m_mean = sampleUs;
+                m_variance = 0;
+                m_outlierCount = 0;
+                return predict();
+            }
+            m_outlierCount = 0;
+
+            // React faster to increases than to decreases, since underestimating causes missed frames.
+            const double alpha = deviation > 0 ? k_alphaUp : k_alphaDown;
+            m_mean += alpha * deviation;
+            m_variance = (1 - alpha) * (m_variance + alpha * deviation * deviation);
+
+            return predict();
+        }
+
+        uint64_t predict() const {
+            return (uint64_t)std::max(0.0, m_mean + k_varianceMargin * std::sqrt(m_variance));
+        }
+
+      private:
+        static constexpr double k_alphaUp = 0.5;
+        static constexpr double k_alphaDown = 0.1;
+        static constexpr double k_outlierThreshold = 4.0;
+        static constexpr double k_minStddevUs = 250.0;
+        static constexpr uint32_t k_maxConsecutiveOutliers = 3;
+        static constexpr double k_varianceMargin = 1.0;
+
+        bool m_initialized{false};
+        double m_mean{0};
+        double m_variance{0};
+        uint32_t m_outlierCount{0};
+    };
+
+    // A vector with inline storage that never allocates.
+    template <typename T, size_t Capacity>
+    class FixedVector {
+      public:
+        void push_back(const T& value) {
+            CHECK_MSG(m_size < Capacity, "FixedVector capacity exceeded");
+            m_storage[m_size++] = value;
+        }
+
+        void clear() {
+            m_size = 0;
+        }
+
+        size_t size() const {
+            return m_size;
+        }
+
+        bool empty() const {
+            return !m_size;
+        }
+
+        T* data() {
+            return m_storage.data();
+        }
+
+        T* begin() {
+            return m_storage.data();
+        }
+
+        T* end() {
+            return m_storage.data() + m_size;
+        }
+
+        const T* begin() const {
+            return m_storage.data();
+        }
+
+        const T* end() const {
+            return m_storage.data() + m_size;
+        }
+
+        T& operator[](size_t index) {
+            return m_storage[index];
+        }
+
+      private:
+        std::array<T, Capacity> m_storage{};
+        size_t m_size{0};
+    };
+
+    // A set with inline storage that never allocates. Lookups are linear, which is best for very small sets.
+    template <typename T, size_t Capacity>
+    class FixedSet {
+      public:
+        size_t count(const T& value) const {
+            return std::find(m_values.begin(), m_values.end(), value) != m_values.end() ? 1 : 0;
+        }
+
+        void insert(const T& value) {
+            if (!count(value)) {
+                m_values.push_back(value);
+            }
+        }
+
+        void clear() {
+            m_values.clear();
+        }
+
+      private:
+        FixedVector<T, Capacity> m_values;
+    };
+
+    // An interned string table for XrPath values. Paths are allocated densely starting from 1, so the reverse lookup
+    // is a direct index. The forward lookup is an open-addressing hash table with linear probing. Lookups are
+    // lock-free and may run concurrently with insertions: the strings live in chunks that never move, and a grown hash
+    // table is published as a new array, with the superseded arrays retained (their total size is bounded by the size
+    // of the current one).
+    class PathTable {
+      public:
+        ~PathTable() {
+            for (auto& chunk : m_chunks) {
+                delete[] chunk.load(std::memory_order_relaxed);
+            }
+        }
+
+        // Returns XR_NULL_PATH when the string was never interned.
+        XrPath find(std::string_view str) const {
+            const SlotArray* slots = m_slots.load(std::memory_order_acquire);
+            if (!slots) {
+                return XR_NULL_PATH;
+            }
+
+            const size_t hash = std::hash<std::string_view>{}(str);
+            const size_t mask = slots->capacity - 1;
+            for (size_t i = hash & mask;; i = (i + 1) & mask) {
+                const auto& slot = slots->slots[i];
+                const XrPath path = slot.path.load(std::memory_order_acquire);
+                if (path == XR_NULL_PATH) {
+                    return XR_NULL_PATH;
+                }
+                if (slot.hash == hash && *getString(path) == str) {
+                    return path;
+                }
+            }
+        }
+
+        // Returns the existing path when the string was interned in the meantime by another thread.
+        XrPath insert(std::string_view str) {
+            std::unique_lock lock(m_writeLock);
+
+            const XrPath existing = find(str);
+            if (existing != XR_NULL_PATH) {
+                return existing;
+            }
+
+            const size_t count = m_count.load(std::memory_order_relaxed);
+            const SlotArray* slots = m_slots.load(std::memory_order_relaxed);
+            if (!slots || (count + 1) * 2 > slots->capacity) {
+                rehash(std::max(slots ? slots->capacity * 2 : 0, size_t(256)));
+            }
+
+            const size_t chunkIndex = count / k_chunkSize;
+            CHECK_MSG(chunkIndex < k_maxChunks, "PathTable capacity exceeded");
+            std::string* chunk = m_chunks[chunkIndex].load(std::memory_order_relaxed);
+            if (!chunk) {
+                chunk = new std::string[k_chunkSize];
+                m_chunks[chunkIndex].store(chunk, std::memory_order_release);
+            }
+            chunk[count % k_chunkSize] = str;
+
+            const XrPath path = (XrPath)(count + 1);
+            m_count.store(count + 1, std::memory_order_release);
+            place(*m_slots.load(std::memory_order_relaxed), std::hash<std::string_view>{}(str), path);
+
+            return path;
+        }
+
+        // The returned string remains valid for the lifetime of the table.
+        const std::string* get(XrPath path) const {
+            if (path == XR_NULL_PATH || path > m_count.load(std::memory_order_acquire)) {
+                return nullptr;
+            }
+            return getString(path);
+        }
+
+        bool contains(XrPath path) const {
+            return get(path) != nullptr;
+        }
+
+      private:
+        static constexpr size_t k_chunkSize = 1024;
+        static constexpr size_t k_maxChunks = 1024;
+
+        // The hash is only written before the path is published.
+        struct Slot {
+            size_t hash{0};
+            std::atomic<XrPath> path{XR_NULL_PATH};
+        };
+
+        struct SlotArray {
+            explicit SlotArray(size_t capacity) : capacity(capacity), slots(new Slot[capacity]) {
+            }
+
+            const size_t capacity;
+            const std::unique_ptr<Slot[]> slots;
+        };
+
+        const std::string* getString(XrPath path) const {
+            const size_t index = (size_t)path - 1;
+            return &m_chunks[index / k_chunkSize].load(std::memory_order_acquire)[index % k_chunkSize];
+        }
+
+        static void place(SlotArray& slots, size_t hash, XrPath path) {
+            const size_t mask = slots.capacity - 1;
+            size_t i = hash & mask;
+            while (slots.slots[i].path.load(std::memory_order_relaxed) != XR_NULL_PATH) {
+                i = (i + 1) & mask;
+            }
+            slots.slots[i].hash = hash;
+            slots.slots[i].path.store(path, std::memory_order_release);
+        }
+
+        void rehash(size_t capacity) {
+            auto slots = std::make_unique<SlotArray>(capacity);
+            if (const SlotArray* previous = m_slots.load(std::memory_order_relaxed)) {
+                for (size_t i = 0; i < previous->capacity; i++) {
+                    const auto& slot = previous->slots[i];
+                    const XrPath path = slot.path.load(std::memory_order_relaxed);
+                    if (path != XR_NULL_PATH) {
+                        place(*slots, slot.hash, path);
+                    }
+                }
+            }
+
+            m_slots.store(slots.get(), std::memory_order_release);
+            m_slotArrays.push_back(std::move(slots));
+        }
+
+        std::atomic<std::string*> m_chunks[k_maxChunks]{};
+        std::atomic<size_t> m_count{0};
+        std::atomic<SlotArray*> m_slots{nullptr};
+        std::vector<std::unique_ptr<SlotArray>> m_slotArrays;
+        std::mutex m_writeLock;
+    };
+
+    // A table of handles encoding a slot index (low 32 bits) and a generation (high 32 bits). Validating a handle is a
+    // bounds check and a compare, and the handle of a destroyed object never becomes valid again, even when its slot
+    // is reused. The table does not own the objects. Iterating the table yields the live handles.
+    // Lookups and iterations are lock-free and may run concurrently with insertions and removals, which are serialized
+    // internally. The slots live in chunks that never move.
+    template <typename Handle, typename T>
+    class HandleTable {
+        struct Slot {
+            std::atomic<T*> object{nullptr};
+            std::atomic<uint32_t> generation{1};
+        };
+
+        static constexpr uint32_t k_chunkSize = 256;
+        static constexpr uint32_t k_maxChunks = 1024;
+
+      public:
+        class Iterator {
+          public:
+            Iterator(const HandleTable& table, uint32_t index, uint32_t count)
+                : m_table(table), m_index(index), m_count(count) {
+                skipFreeSlots();
+            }
+
+            Handle operator*() const {
+                return makeHandle(m_index, m_table.slot(m_index).generation.load(std::memory_order_acquire));
+            }
+
+            Iterator& operator++() {
+                m_index++;
+                skipFreeSlots();
+                return *this;
+            }
+
+            bool operator!=(const Iterator& other) const {
+                return m_index != other.m_index;
+            }
+
+          private:
+            void skipFreeSlots() {
+                while (m_index < m_count && !m_table.slot(m_index).object.load(std::memory_order_acquire)) {
+                    m_index++;
+                }
+            }
+
+            const HandleTable& m_table;
+            uint32_t m_index;
+            const uint32_t m_count;
+        };
+
+        HandleTable() = default;
+        HandleTable(const HandleTable&) = delete;
+        HandleTable& operator=(const HandleTable&) = delete;
+
+        ~HandleTable() {
+            for (auto& chunk : m_chunks) {
+                delete[] chunk.load(std::memory_order_relaxed);
+            }
+        }
+
+        Handle insert(T* object) {
+            std::unique_lock lock(m_writeLock);
+
+            uint32_t index;
+            if (m_freeSlots.empty()) {
+                index = m_slotCount.load(std::memory_order_relaxed);
+                const uint32_t chunkIndex = index / k_chunkSize;
+                CHECK_MSG(chunkIndex < k_maxChunks, "HandleTable capacity exceeded");
+                if (!m_chunks[chunkIndex].load(std::memory_order_relaxed)) {
+                    m_chunks[chunkIndex].store(new Slot[k_chunkSize], std::memory_order_release);
+                }
+                m_slotCount.store(index + 1, std::memory_order_release);
+            } else {
+                index = m_freeSlots.back();
+                m_freeSlots.pop_back();
+            }
+
+            // The generation was already advanced when the slot was released.
+            Slot& slot = this->slot(index);
+            slot.object.store(object, std::memory_order_release);
+            m_size++;
+
+            return makeHandle(index, slot.generation.load(std::memory_order_relaxed));
+        }
+
+        // Returns nullptr when the handle is not valid (or not valid anymore).
+        T* get(Handle handle) const {
+            const uint64_t value = (uint64_t)handle;
+            const uint32_t index = (uint32_t)value;
+            if (index >= m_slotCount.load(std::memory_order_acquire)) {
+                return nullptr;
+            }
+
+            // Read the object before the generation: a slot being reused is published with its new generation.
+            const Slot& slot = this->slot(index);
+            T* const object = slot.object.load(std::memory_order_acquire);
+            if (slot.generation.load(std::memory_order_acquire) != (uint32_t)(value >> 32)) {
+                return nullptr;
+            }
+            return object;
+        }
+
+        bool contains(Handle handle) const {
+            return get(handle) != nullptr;
+        }
+
+        void erase(Handle handle) {
+            std::unique_lock lock(m_writeLock);
+
+            if (!contains(handle)) {
+                return;
+            }
+
+            const uint32_t index = (uint32_t)(uint64_t)handle;
+            releaseSlot(index);
+        }
+
+        // Invalidates all the handles, but keeps the generations so that they remain invalid.
+        void clear() {
+            std::unique_lock lock(m_writeLock);
+
+            const uint32_t count = m_slotCount.load(std::memory_order_relaxed);
+            for (uint32_t i = 0; i < count; i++) {
+                if (slot(i).object.load(std::memory_order_relaxed)) {
+                    releaseSlot(i);
+                }
+            }
+        }
+
+        size_t size() const {
+            return m_size;
+        }
+
+        bool empty() const {
+            return !m_size;
+        }
+
+        Iterator begin() const {
+            const uint32_t count = m_slotCount.load(std::memory_order_acquire);
+            return Iterator(*this, 0, count);
+        }
+
+        Iterator end() const {
+            const uint32_t count = m_slotCount.load(std::memory_order_acquire);
+            return Iterator(*this, count, count);
+        }
+
+      private:
+        static Handle makeHandle(uint32_t index, uint32_t generation) {
+            // The generation is never 0, so neither is the handle.
+            return (Handle)(((uint64_t)generation << 32) | index);
+        }
+
+        Slot& slot(uint32_t index) const {
+            return m_chunks[index / k_chunkSize].load(std::memory_order_acquire)[index % k_chunkSize];
+        }
+
+        void releaseSlot(uint32_t index) {
+            // Invalidate the handle before clearing the object, see get().
+            Slot& slot = this->slot(index);
+            const uint32_t generation = slot.generation.load(std::memory_order_relaxed);
+            slot.generation.store(generation == UINT32_MAX ? 1 : generation + 1, std::memory_order_release);
+            slot.object.store(nullptr, std::memory_order_release);
+            m_freeSlots.push_back(index);
+            m_size--;
+        }
+
+        std::atomic<Slot*> m_chunks[k_maxChunks]{};
+        std::atomic<uint32_t> m_slotCount{0};
+        std::vector<uint32_t> m_freeSlots;
+        std::atomic<size_t> m_size{0};
+        std::mutex m_writeLock;
+    };
+
+    // A value published as immutable snapshots, so that readers never block nor observe a partial update. Like the
+    // runtime settings, the superseded snapshots are retained for the lifetime of the owner, which suits values that
+    // are rarely updated. Publishers must be serialized by the caller.
+    template <typename T>
+    class Published {
+      public:
+        Published() {
+            publish(std::make_unique<T>());
+        }
+
+        const T& get() const {
+            return *m_current.load(std::memory_order_acquire);
+        }
+
+        void publish(std::unique_ptr<const T> value) {
+            m_current.store(value.get(), std::memory_order_release);
+            m_snapshots.push_back(std::move(value));
+        }
+
+      private:
+        std::atomic<const T*> m_current{nullptr};
+        std::vector<std::unique_ptr<const T>> m_snapshots;
+    };
+
+    // An array of poses stored as structure-of-arrays, so that they can be transformed 4 at a time with SIMD.
+    template <uint32_t Count>
+    class PoseArraySoA {
+      public:
+        void set(uint32_t index, const XrPosef& pose) {
+            m_positionX[index] = pose.position.x;
+            m_positionY[index] = pose.position.y;
+            m_positionZ[index] = pose.position.z;
+            m_orientationX[index] = pose.orientation.x;
+            m_orientationY[index] = pose.orientation.y;
+            m_orientationZ[index] = pose.orientation.z;
+            m_orientationW[index] = pose.orientation.w;
+        }
+
+        XrPosef get(uint32_t index) const {
+            return {{m_orientationX[index], m_orientationY[index], m_orientationZ[index], m_orientationW[index]},
+                    {m_positionX[index], m_positionY[index], m_positionZ[index]}};
+        }
+
+        // Equivalent to Pose::Multiply(pose, transform) for every pose.
+        void transform(const XrPosef& transform, PoseArraySoA& result) const {
+            using namespace DirectX;
+
+            const XMVECTOR tx = XMVectorReplicate(transform.orientation.x);
+            const XMVECTOR ty = XMVectorReplicate(transform.orientation.y);
+            const XMVECTOR tz = XMVectorReplicate(transform.orientation.z);
+            const XMVECTOR tw = XMVectorReplicate(transform.orientation.w);
+            const XMVECTOR two = XMVectorReplicate(2.f);
+
+            for (uint32_t i = 0; i < Groups * 4; i += 4) {
+                const XMVECTOR px = XMLoadFloat4A(reinterpret_cast<const XMFLOAT4A*>(&m_positionX[i]));
+                const XMVECTOR py = XMLoadFloat4A(reinterpret_cast<const XMFLOAT4A*>(&m_positionY[i]));
+                const XMVECTOR pz = XMLoadFloat4A(reinterpret_cast<const XMFLOAT4A*>(&m_positionZ[i]));
+                const XMVECTOR qx = XMLoadFloat4A(reinterpret_cast<const XMFLOAT4A*>(&m_orientationX[i]));
+                const XMVECTOR qy = XMLoadFloat4A(reinterpret_cast<const XMFLOAT4A*>(&m_orientationY[i]));
+                const XMVECTOR qz = XMLoadFloat4A(reinterpret_cast<const XMFLOAT4A*>(&m_orientationZ[i]));
+                const XMVECTOR qw = XMLoadFloat4A(reinterpret_cast<const XMFLOAT4A*>(&m_orientationW[i]));
+
+                // Rotate the positions: v' = v + w * t + u x t, with t = 2 * (u x v).
+                const XMVECTOR cx =
+                    XMVectorMultiply(two, XMVectorSubtract(XMVectorMultiply(ty, pz), XMVectorMultiply(tz, py)));
+                const XMVECTOR cy =
+                    XMVectorMultiply(two, XMVectorSubtract(XMVectorMultiply(tz, px), XMVectorMultiply(tx, pz)));
+                const XMVECTOR cz =
+                    XMVectorMultiply(two, XMVectorSubtract(XMVectorMultiply(tx, py), XMVectorMultiply(ty, px)));
+                const XMVECTOR rx = XMVectorAdd(XMVectorMultiplyAdd(tw, cx, px),
+                                                XMVectorSubtract(XMVectorMultiply(ty, cz), XMVectorMultiply(tz, cy)));
+                const XMVECTOR ry = XMVectorAdd(XMVectorMultiplyAdd(tw, cy, py),
+                                                XMVectorSubtract(XMVectorMultiply(tz, cx), XMVectorMultiply(tx, cz)));
+                const XMVECTOR rz = XMVectorAdd(XMVectorMultiplyAdd(tw, cz, pz),
+                                                XMVectorSubtract(XMVectorMultiply(tx, cy), XMVectorMultiply(ty, cx)));
+                XMStoreFloat4A(reinterpret_cast<XMFLOAT4A*>(&result.m_positionX[i]),
+                               XMVectorAdd(rx, XMVectorReplicate(transform.position.x)));
+                XMStoreFloat4A(reinterpret_cast<XMFLOAT4A*>(&result.m_positionY[i]),
+                               XMVectorAdd(ry, XMVectorReplicate(transform.position.y)));
+                XMStoreFloat4A(reinterpret_cast<XMFLOAT4A*>(&result.m_positionZ[i]),
+                               XMVectorAdd(rz, XMVectorReplicate(transform.position.z)));
+
+                // Compose the orientations: transform * q (Hamilton product).
+                XMStoreFloat4A(reinterpret_cast<XMFLOAT4A*>(&result.m_orientationW[i]),
+                               XMVectorSubtract(XMVectorSubtract(XMVectorMultiply(tw, qw), XMVectorMultiply(tx, qx)),
+                                                XMVectorAdd(XMVectorMultiply(ty, qy), XMVectorMultiply(tz, qz))));
+                XMStoreFloat4A(reinterpret_cast<XMFLOAT4A*>(&result.m_orientationX[i]),
+                               XMVectorAdd(XMVectorAdd(XMVectorMultiply(tw, qx), XMVectorMultiply(tx, qw)),
+                                           XMVectorSubtract(XMVectorMultiply(ty, qz), XMVectorMultiply(tz, qy))));
+                XMStoreFloat4A(reinterpret_cast<XMFLOAT4A*>(&result.m_orientationY[i]),
+                               XMVectorAdd(XMVectorSubtract(XMVectorMultiply(tw, qy), XMVectorMultiply(tx, qz)),
+                                           XMVectorAdd(XMVectorMultiply(ty, qw), XMVectorMultiply(tz, qx))));
+                XMStoreFloat4A(reinterpret_cast<XMFLOAT4A*>(&result.m_orientationZ[i]),
+                               XMVectorAdd(XMVectorAdd(XMVectorMultiply(tw, qz), XMVectorMultiply(tx, qy)),
+                                           XMVectorSubtract(XMVectorMultiply(tz, qw), XMVectorMultiply(ty, qx))));
+            }
+        }
+
+      private:
+        static constexpr uint32_t Groups = (Count + 3) / 4;
+
+        alignas(16) float m_positionX[Groups * 4]{};
+        alignas(16) float m_positionY[Groups * 4]{};
+        alignas(16) float m_positionZ[Groups * 4]{};
+        alignas(16) float m_orientationX[Groups * 4]{};
+        alignas(16) float m_orientationY[Groups * 4]{};
+        alignas(16) float m_orientationZ[Groups * 4]{};
+        alignas(16) float m_orientationW[Groups * 4]{};
+    };
+
     struct GlContext {
         HDC glDC;
         HGLRC glRC;
@@ -320,6 +1006,38 @@ namespace pimax_openxr::utils {
         return data;
     }
 
+    // Read all the DWORD values of a key at once.
+    static std::unordered_map<std::string, int> RegGetDwords(HKEY hKey, const std::string& subKey) {
+        std::unordered_map<std::string, int> values;
+
+        wil::unique_hkey key;
+        if (::RegOpenKeyEx(hKey, std::wstring(subKey.begin(), subKey.end()).c_str(), 0, KEY_READ, key.put()) !=
+            ERROR_SUCCESS) {
+            return values;
+        }
+
+        for (DWORD i = 0;; i++) {
+            wchar_t name[256];
+            DWORD nameLength = (DWORD)std::size(name);
+            DWORD type;
+            DWORD data{};
+            DWORD dataSize = sizeof(data);
+            const LONG retCode =
+                ::RegEnumValue(key.get(), i, name, &nameLength, nullptr, &type, (LPBYTE)&data, &dataSize);
+            if (retCode == ERROR_NO_MORE_ITEMS) {
+                break;
+            }
+
+            // Values that are not DWORD (and may not fit) are skipped.
+            if (retCode == ERROR_SUCCESS && type == REG_DWORD) {
+                const std::wstring wideName(name, nameLength);
+                values[std::string(wideName.begin(), wideName.end())] = data;
+            }
+        }
+
+        return values;
+    }
+
     static std::vector<const char*> ParseExtensionString(char* names) {
         std::vector<const char*> list;
         while (*names != 0) {
@@ -335,7 +1053,7 @@ namespace pimax_openxr::utils {
     }
 
     static inline XrTime pvrTimeToXrTime(double pvrTime) {
-        return (XrTime)(pvrTime * 1e9);
+        return (XrTime)std::llround(pvrTime * 1e9);
     }
 
     static inline double xrTimeToPvrTime(XrTime xrTime) {
@@ -401,6 +1119,8 @@ namespace pimax_openxr::utils {
             return PVR_FORMAT_D32_FLOAT;
         case DXGI_FORMAT_D32_FLOAT_S8X24_UINT:
             return PVR_FORMAT_D32_FLOAT_S8X24_UINT;
+        case DXGI_FORMAT_BC1_UNORM:
+            return PVR_FORMAT_BC1_UNORM;
         default:
             return PVR_FORMAT_UNKNOWN;
         }
@@ -435,6 +1155,18 @@ namespace pimax_openxr::utils {
         }
     }
 
+    static uint32_t getBytesPerPixel(DXGI_FORMAT format) {
+        switch (format) {
+        case DXGI_FORMAT_D16_UNORM:
+            return 2;
+        case DXGI_FORMAT_R16G16B16A16_FLOAT:
+        case DXGI_FORMAT_D32_FLOAT_S8X24_UINT:
+            return 8;
+        default:
+            return 4;
+        }
+    }
+
     static pvrTextureFormat vkToPvrTextureFormat(VkFormat format) {
         switch (format) {
         case VK_FORMAT_R8G8B8A8_UNORM:
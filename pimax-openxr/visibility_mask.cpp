@@ -63,56 +63,355 @@ namespace pimax_openxr {
             return XR_ERROR_HANDLE_INVALID;
         }
 
-        if (viewConfigurationType != XR_VIEW_CONFIGURATION_TYPE_PRIMARY_STEREO) {
+        const uint32_t viewCount = getViewConfigurationViewCount(viewConfigurationType);
+        if (!viewCount) {
             return XR_ERROR_VIEW_CONFIGURATION_TYPE_UNSUPPORTED;
         }
 
-        if (viewIndex >= xr::StereoView::Count) {
+        if (viewIndex >= viewCount) {
             return XR_ERROR_VALIDATION_FAILURE;
         }
 
-        // We only support the hidden area mesh and we don't return a mask with parallel projection.
-        if (visibilityMaskType != XR_VISIBILITY_MASK_TYPE_HIDDEN_TRIANGLE_MESH_KHR || m_useParallelProjection && m_cantingAngle) {
-            if (visibilityMaskType != XR_VISIBILITY_MASK_TYPE_HIDDEN_TRIANGLE_MESH_KHR) {
-                LOG_TELEMETRY_ONCE(logUnimplemented("VisibilityMaskTypeNotSupported"));
-            }
+        if (visibilityMaskType != XR_VISIBILITY_MASK_TYPE_HIDDEN_TRIANGLE_MESH_KHR &&
+            visibilityMaskType != XR_VISIBILITY_MASK_TYPE_VISIBLE_TRIANGLE_MESH_KHR &&
+            visibilityMaskType != XR_VISIBILITY_MASK_TYPE_LINE_LOOP_KHR) {
+            return XR_ERROR_VALIDATION_FAILURE;
+        }
 
+        // The focus views of quad views are entirely visible.
+        if (viewIndex >= xr::StereoView::Count) {
             visibilityMask->vertexCountOutput = 0;
             visibilityMask->indexCountOutput = 0;
             return XR_SUCCESS;
         }
 
-        const auto verticesCount =
-            pvr_getEyeHiddenAreaMesh(m_pvrSession, !viewIndex ? pvrEye_Left : pvrEye_Right, nullptr, 0);
-        TraceLoggingWrite(g_traceProvider, "PVR_EyeHiddenAreaMesh", TLArg(verticesCount, "VerticesCount"));
+        std::unique_lock lock(m_visibilityMaskLock);
 
-        // The hidden area mesh is disabled by the platform.
-        if (!verticesCount) {
-            visibilityMask->vertexCountOutput = 0;
-            visibilityMask->indexCountOutput = 0;
-            return XR_SUCCESS;
+        // The meshes only change along with the eye info.
+        if (!m_visibilityMasksValid[viewIndex]) {
+            buildVisibilityMasks(viewIndex);
         }
 
+        const CachedVisibilityMask& mask = m_visibilityMasks[viewIndex][visibilityMaskType - 1];
+        const uint32_t vertexCount = (uint32_t)mask.vertices.size();
+        const uint32_t indexCount = (uint32_t)mask.indices.size();
+
         if (visibilityMask->vertexCapacityInput == 0) {
-            visibilityMask->vertexCountOutput = verticesCount;
-            visibilityMask->indexCountOutput = verticesCount;
+            visibilityMask->vertexCountOutput = vertexCount;
+            visibilityMask->indexCountOutput = indexCount;
         } else if (visibilityMask->vertices && visibilityMask->indices) {
-            if (visibilityMask->vertexCapacityInput < verticesCount ||
-                visibilityMask->indexCapacityInput < verticesCount) {
+            if (visibilityMask->vertexCapacityInput < vertexCount || visibilityMask->indexCapacityInput < indexCount) {
                 return XR_ERROR_SIZE_INSUFFICIENT;
             }
 
-            static_assert(sizeof(XrVector2f) == sizeof(pvrVector2f));
+            std::copy(mask.vertices.cbegin(), mask.vertices.cend(), visibilityMask->vertices);
+            std::copy(mask.indices.cbegin(), mask.indices.cend(), visibilityMask->indices);
+            visibilityMask->vertexCountOutput = vertexCount;
+            visibilityMask->indexCountOutput = indexCount;
+        }
+
+        TraceLoggingWrite(g_traceProvider,
+                          "xrGetVisibilityMaskKHR",
+                          TLArg(visibilityMask->vertexCountOutput, "VertexCountOutput"),
+                          TLArg(visibilityMask->indexCountOutput, "IndexCountOutput"));
+
+        return XR_SUCCESS;
+    }
+
+    // Must be called with m_visibilityMaskLock held.
+    void OpenXrRuntime::buildVisibilityMasks(uint32_t viewIndex) {
+        auto& hidden = m_visibilityMasks[viewIndex][XR_VISIBILITY_MASK_TYPE_HIDDEN_TRIANGLE_MESH_KHR - 1];
+        auto& visible = m_visibilityMasks[viewIndex][XR_VISIBILITY_MASK_TYPE_VISIBLE_TRIANGLE_MESH_KHR - 1];
+        auto& lineLoop = m_visibilityMasks[viewIndex][XR_VISIBILITY_MASK_TYPE_LINE_LOOP_KHR - 1];
+        for (auto& mask : m_visibilityMasks[viewIndex]) {
+            mask.vertices.clear();
+            mask.indices.clear();
+        }
+        m_visibilityMasksValid[viewIndex] = true;
+
+        int verticesCount;
+        {
+            std::unique_lock pvrLock(m_pvrLock);
+            verticesCount = pvr_getEyeHiddenAreaMesh(m_pvrSession, !viewIndex ? pvrEye_Left : pvrEye_Right, nullptr, 0);
+        }
+        TraceLoggingWrite(g_traceProvider, "PVR_EyeHiddenAreaMesh", TLArg(verticesCount, "VerticesCount"));
+
+        // The hidden area mesh is disabled by the platform.
+        if (verticesCount <= 0) {
+            return;
+        }
+
+        hidden.vertices.resize(verticesCount);
+        hidden.indices.resize(verticesCount);
+        static_assert(sizeof(XrVector2f) == sizeof(pvrVector2f));
+        {
+            std::unique_lock pvrLock(m_pvrLock);
             pvr_getEyeHiddenAreaMesh(m_pvrSession,
                                      !viewIndex ? pvrEye_Left : pvrEye_Right,
-                                     (pvrVector2f*)visibilityMask->vertices,
+                                     (pvrVector2f*)hidden.vertices.data(),
                                      verticesCount);
+        }
+
+        const pvrFovPort& fov = m_cachedEyeInfo[viewIndex].Fov;
+        convertSteamVRToOpenXRHiddenMesh(fov, hidden.vertices.data(), hidden.indices.data(), verticesCount);
+
+        // Find the boundary of the visible area by casting rays from the center of the view against the edges of the
+        // hidden triangles, bounded by the edges of the frame.
+        const auto cross = [](const XrVector2f& a, const XrVector2f& b) { return a.x * b.y - a.y * b.x; };
+        lineLoop.vertices.resize(k_visibilityMaskSegments);
+        for (uint32_t i = 0; i < k_visibilityMaskSegments; i++) {
+            const float angle = XM_2PI * i / k_visibilityMaskSegments;
+            const XrVector2f direction{cos(angle), sin(angle)};
 
-            convertSteamVRToOpenXRHiddenMesh(
-                m_cachedEyeInfo[viewIndex].Fov, visibilityMask->vertices, visibilityMask->indices, verticesCount);
+            float distance = std::numeric_limits<float>::infinity();
+            if (direction.x > FLT_EPSILON) {
+                distance = std::min(distance, fov.RightTan / direction.x);
+            } else if (direction.x < -FLT_EPSILON) {
+                distance = std::min(distance, -fov.LeftTan / direction.x);
+            }
+            if (direction.y > FLT_EPSILON) {
+                distance = std::min(distance, fov.UpTan / direction.y);
+            } else if (direction.y < -FLT_EPSILON) {
+                distance = std::min(distance, -fov.DownTan / direction.y);
+            }
+
+            for (uint32_t j = 0; j + 2 < hidden.vertices.size(); j += 3) {
+                for (uint32_t k = 0; k < 3; k++) {
+                    const XrVector2f& a = hidden.vertices[j + k];
+                    const XrVector2f& b = hidden.vertices[j + (k + 1) % 3];
+                    const XrVector2f edge{b.x - a.x, b.y - a.y};
+                    const float denom = cross(direction, edge);
+                    if (std::abs(denom) < FLT_EPSILON) {
+                        continue;
+                    }
+
+                    const float t = cross(a, edge) / denom;
+                    const float u = cross(a, direction) / denom;
+                    if (t > 0.f && u >= 0.f && u <= 1.f) {
+                        distance = std::min(distance, t);
+                    }
+                }
+            }
+
+            lineLoop.vertices[i] = {direction.x * distance, direction.y * distance};
+            lineLoop.indices.push_back(i);
         }
 
-        return XR_SUCCESS;
+        // The visible area is a fan around the center of the view.
+        visible.vertices.push_back({0.f, 0.f});
+        visible.vertices.insert(visible.vertices.end(), lineLoop.vertices.cbegin(), lineLoop.vertices.cend());
+        for (uint32_t i = 0; i < k_visibilityMaskSegments; i++) {
+            visible.indices.push_back(0);
+            visible.indices.push_back(1 + i);
+            visible.indices.push_back(1 + (i + 1) % k_visibilityMaskSegments);
+        }
+
+        if (m_useParallelProjection && m_cantingAngle) {
+            // Rotate the canted view onto the parallel view. This is a homography, so that edges remain straight.
+            const float angle = !viewIndex ? m_cantingAngle : -m_cantingAngle;
+            const float sinAngle = sin(angle);
+            const float cosAngle = cos(angle);
+            const auto reproject = [&](const XrVector2f& v) -> XrVector2f {
+                const float w = v.x * sinAngle + cosAngle;
+                return {(v.x * cosAngle - sinAngle) / w, v.y / w};
+            };
+
+            // The parallel view is wider than the canted view: hide the top and bottom bands that the panel does not
+            // cover. The left and right edges of the canted view project exactly onto the edges of the parallel view.
+            const XrFovf& parallelFov = m_cachedEyeFov[viewIndex];
+            const float top = tan(parallelFov.angleUp);
+            const float bottom = tan(parallelFov.angleDown);
+            const XrVector2f topLeft = reproject({-fov.LeftTan, fov.UpTan});
+            const XrVector2f topRight = reproject({fov.RightTan, fov.UpTan});
+            const XrVector2f bottomLeft = reproject({-fov.LeftTan, -fov.DownTan});
+            const XrVector2f bottomRight = reproject({fov.RightTan, -fov.DownTan});
+
+            for (auto& mask : m_visibilityMasks[viewIndex]) {
+                for (auto& vertex : mask.vertices) {
+                    vertex = reproject(vertex);
+                }
+            }
+
+            const XrVector2f band[] = {
+                // Top band.
+                {topLeft.x, std::min(topLeft.y, top)},
+                {topRight.x, std::min(topRight.y, top)},
+                {topRight.x, top},
+                {topLeft.x, std::min(topLeft.y, top)},
+                {topRight.x, top},
+                {topLeft.x, top},
+                // Bottom band.
+                {bottomLeft.x, bottom},
+                {bottomRight.x, bottom},
+                {bottomRight.x, std::max(bottomRight.y, bottom)},
+                {bottomLeft.x, bottom},
+                {bottomRight.x, std::max(bottomRight.y, bottom)},
+                {bottomLeft.x, std::max(bottomLeft.y, bottom)},
+            };
+            for (const auto& vertex : band) {
+                hidden.indices.push_back((uint32_t)hidden.vertices.size());
+                hidden.vertices.push_back(vertex);
+            }
+        }
+
+        TraceLoggingWrite(g_traceProvider,
+                          "VisibilityMask",
+                          TLArg(viewIndex, "ViewIndex"),
+                          TLArg(hidden.vertices.size(), "HiddenVerticesCount"),
+                          TLArg(visible.vertices.size(), "VisibleVerticesCount"),
+                          TLArg(lineLoop.vertices.size(), "LineLoopVerticesCount"));
+    }
+
+    // Rasterize the hidden area mesh for a view rendered with the given FOV into the given extent. Returns whether
+    // any tile is hidden, in which case m_tileMaskResourceView holds the mask for the eye.
+    bool OpenXrRuntime::updateTileMask(uint32_t eye, const XrFovf& fov, const XrExtent2Di& extent) {
+        std::unique_lock lock(m_visibilityMaskLock);
+
+        TileMask& mask = m_tileMasks[eye];
+        if (mask.valid && !memcmp(&mask.fov, &fov, sizeof(fov)) && mask.extent.width == extent.width &&
+            mask.extent.height == extent.height) {
+            return mask.hasHiddenTiles;
+        }
+
+        if (!m_visibilityMasksValid[eye]) {
+            buildVisibilityMasks(eye);
+        }
+        const auto& hidden = m_visibilityMasks[eye][XR_VISIBILITY_MASK_TYPE_HIDDEN_TRIANGLE_MESH_KHR - 1].vertices;
+
+        mask.fov = fov;
+        mask.extent = extent;
+        mask.valid = true;
+        mask.hasHiddenTiles = false;
+
+        const uint32_t tilesX = (extent.width + k_tileSize - 1) / k_tileSize;
+        const uint32_t tilesY = (extent.height + k_tileSize - 1) / k_tileSize;
+        mask.tiles.assign((size_t)tilesX * tilesY, 1);
+        if (hidden.empty() || !tilesX || !tilesY) {
+            return false;
+        }
+
+        // Sample each tile at its corners, the middle of its edges and its center. A point is covered if it is within
+        // any of the hidden triangles.
+        const uint32_t pointsX = 2 * tilesX + 1;
+        const uint32_t pointsY = 2 * tilesY + 1;
+        const float left = tan(fov.angleLeft);
+        const float right = tan(fov.angleRight);
+        const float up = tan(fov.angleUp);
+        const float down = tan(fov.angleDown);
+        const float pointSpanX = (right - left) * (k_tileSize / 2.f) / extent.width;
+        const float pointSpanY = (up - down) * (k_tileSize / 2.f) / extent.height;
+        const auto pointToView = [&](uint32_t x, uint32_t y) -> XrVector2f {
+            return {std::min(left + x * pointSpanX, right), std::max(up - y * pointSpanY, down)};
+        };
+
+        std::vector<uint8_t> covered((size_t)pointsX * pointsY, 0);
+        const auto cross = [](const XrVector2f& o, const XrVector2f& a, const XrVector2f& b) {
+            return (a.x - o.x) * (b.y - o.y) - (a.y - o.y) * (b.x - o.x);
+        };
+        for (size_t i = 0; i + 2 < hidden.size(); i += 3) {
+            const XrVector2f& a = hidden[i];
+            const XrVector2f& b = hidden[i + 1];
+            const XrVector2f& c = hidden[i + 2];
+
+            // Only visit the points within the bounding box of the triangle.
+            const float minX = std::min({a.x, b.x, c.x});
+            const float maxX = std::max({a.x, b.x, c.x});
+            const float minY = std::min({a.y, b.y, c.y});
+            const float maxY = std::max({a.y, b.y, c.y});
+            const int x0 = std::max((int)std::ceil((minX - left) / pointSpanX), 0);
+            const int x1 = std::min((int)std::floor((maxX - left) / pointSpanX), (int)pointsX - 1);
+            const int y0 = std::max((int)std::ceil((up - maxY) / pointSpanY), 0);
+            const int y1 = std::min((int)std::floor((up - minY) / pointSpanY), (int)pointsY - 1);
+
+            for (int y = y0; y <= y1; y++) {
+                for (int x = x0; x <= x1; x++) {
+                    const XrVector2f p = pointToView(x, y);
+                    const float w0 = cross(a, b, p);
+                    const float w1 = cross(b, c, p);
+                    const float w2 = cross(c, a, p);
+                    if ((w0 >= 0.f && w1 >= 0.f && w2 >= 0.f) || (w0 <= 0.f && w1 <= 0.f && w2 <= 0.f)) {
+                        covered[(size_t)y * pointsX + x] = 1;
+                    }
+                }
+            }
+        }
+
+        // A tile is hidden when all its sample points are covered. We stay conservative and keep a margin of one tile
+        // around the visible area.
+        std::vector<uint8_t> tileHidden((size_t)tilesX * tilesY, 0);
+        for (uint32_t y = 0; y < tilesY; y++) {
+            for (uint32_t x = 0; x < tilesX; x++) {
+                bool isHidden = true;
+                for (uint32_t j = 0; j < 3 && isHidden; j++) {
+                    for (uint32_t i = 0; i < 3 && isHidden; i++) {
+                        isHidden = covered[(size_t)(2 * y + j) * pointsX + 2 * x + i];
+                    }
+                }
+                tileHidden[(size_t)y * tilesX + x] = isHidden;
+            }
+        }
+        for (uint32_t y = 0; y < tilesY; y++) {
+            for (uint32_t x = 0; x < tilesX; x++) {
+                bool isHidden = true;
+                for (uint32_t j = y ? y - 1 : 0; j <= std::min(y + 1, tilesY - 1) && isHidden; j++) {
+                    for (uint32_t i = x ? x - 1 : 0; i <= std::min(x + 1, tilesX - 1) && isHidden; i++) {
+                        isHidden = tileHidden[(size_t)j * tilesX + i];
+                    }
+                }
+                if (isHidden) {
+                    mask.tiles[(size_t)y * tilesX + x] = 0;
+                    mask.hasHiddenTiles = true;
+                }
+            }
+        }
+
+        TraceLoggingWrite(g_traceProvider,
+                          "TileMask",
+                          TLArg(eye, "Eye"),
+                          TLArg(tilesX, "TilesX"),
+                          TLArg(tilesY, "TilesY"),
+                          TLArg(std::count(mask.tiles.cbegin(), mask.tiles.cend(), 0), "HiddenTiles"));
+
+        if (!mask.hasHiddenTiles) {
+            return false;
+        }
+
+        // (Re)create the texture array if it is too small, and upload the masks of both eyes.
+        D3D11_TEXTURE2D_DESC desc{};
+        if (m_tileMaskTexture) {
+            m_tileMaskTexture->GetDesc(&desc);
+        }
+        const bool needUploadAll = desc.Width < tilesX || desc.Height < tilesY;
+        if (needUploadAll) {
+            desc.Width = std::max(desc.Width, tilesX);
+            desc.Height = std::max(desc.Height, tilesY);
+            desc.ArraySize = xr::StereoView::Count;
+            desc.MipLevels = 1;
+            desc.Format = DXGI_FORMAT_R8_UINT;
+            desc.SampleDesc.Count = 1;
+            desc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
+
+            CHECK_HRCMD(
+                m_pvrSubmissionDevice->CreateTexture2D(&desc, nullptr, m_tileMaskTexture.ReleaseAndGetAddressOf()));
+            setDebugName(m_tileMaskTexture.Get(), "Tile Mask Texture");
+            CHECK_HRCMD(m_pvrSubmissionDevice->CreateShaderResourceView(
+                m_tileMaskTexture.Get(), nullptr, m_tileMaskResourceView.ReleaseAndGetAddressOf()));
+            setDebugName(m_tileMaskResourceView.Get(), "Tile Mask SRV");
+        }
+        for (uint32_t i = 0; i < xr::StereoView::Count; i++) {
+            const TileMask& other = m_tileMasks[i];
+            if (i != eye && (!needUploadAll || !other.valid || !other.hasHiddenTiles)) {
+                continue;
+            }
+
+            const uint32_t width = (other.extent.width + k_tileSize - 1) / k_tileSize;
+            const uint32_t height = (other.extent.height + k_tileSize - 1) / k_tileSize;
+            const D3D11_BOX box{0, 0, 0, width, height, 1};
+            m_pvrSubmissionContext->UpdateSubresource(
+                m_tileMaskTexture.Get(), D3D11CalcSubresource(0, i, 1), &box, other.tiles.data(), width, 0);
+        }
+
+        return true;
     }
 
     void OpenXrRuntime::convertSteamVRToOpenXRHiddenMesh(const pvrFovPort& fov,
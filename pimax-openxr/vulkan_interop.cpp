@@ -35,6 +35,95 @@ namespace pimax_openxr {
     using namespace pimax_openxr::log;
     using namespace pimax_openxr::utils;
 
+    // A GPU asynchronous timer for the app's Vulkan queue. The command buffers are recorded once and replayed every
+    // frame.
+    class OpenXrRuntime::VulkanGpuTimer : public ITimer {
+      public:
+        VulkanGpuTimer(const OpenXrRuntime& runtime, float timestampPeriod)
+            : m_runtime(runtime), m_timestampPeriod(timestampPeriod) {
+            const auto& vk = m_runtime.m_vkDispatch;
+
+            VkQueryPoolCreateInfo poolCreateInfo{VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO};
+            poolCreateInfo.queryType = VK_QUERY_TYPE_TIMESTAMP;
+            poolCreateInfo.queryCount = 2;
+            CHECK_VKCMD(
+                vk.vkCreateQueryPool(m_runtime.m_vkDevice, &poolCreateInfo, m_runtime.m_vkAllocator, &m_queryPool));
+
+            VkCommandBufferAllocateInfo allocateInfo{VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO};
+            allocateInfo.commandPool = m_runtime.m_vkCmdPool;
+            allocateInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+            allocateInfo.commandBufferCount = 2;
+            VkCommandBuffer cmdBuffers[2];
+            CHECK_VKCMD(vk.vkAllocateCommandBuffers(m_runtime.m_vkDevice, &allocateInfo, cmdBuffers));
+            m_startCmdBuffer = cmdBuffers[0];
+            m_stopCmdBuffer = cmdBuffers[1];
+
+            VkCommandBufferBeginInfo beginInfo{VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO};
+            beginInfo.flags = VK_COMMAND_BUFFER_USAGE_SIMULTANEOUS_USE_BIT;
+            CHECK_VKCMD(vk.vkBeginCommandBuffer(m_startCmdBuffer, &beginInfo));
+            vk.vkCmdResetQueryPool(m_startCmdBuffer, m_queryPool, 0, 2);
+            vk.vkCmdWriteTimestamp(m_startCmdBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, m_queryPool, 0);
+            CHECK_VKCMD(vk.vkEndCommandBuffer(m_startCmdBuffer));
+            CHECK_VKCMD(vk.vkBeginCommandBuffer(m_stopCmdBuffer, &beginInfo));
+            vk.vkCmdWriteTimestamp(m_stopCmdBuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, m_queryPool, 1);
+            CHECK_VKCMD(vk.vkEndCommandBuffer(m_stopCmdBuffer));
+        }
+
+        ~VulkanGpuTimer() override {
+            const auto& vk = m_runtime.m_vkDispatch;
+            const VkCommandBuffer cmdBuffers[] = {m_startCmdBuffer, m_stopCmdBuffer};
+            vk.vkFreeCommandBuffers(m_runtime.m_vkDevice, m_runtime.m_vkCmdPool, 2, cmdBuffers);
+            vk.vkDestroyQueryPool(m_runtime.m_vkDevice, m_queryPool, m_runtime.m_vkAllocator);
+        }
+
+        void start() override {
+            submit(m_startCmdBuffer);
+        }
+
+        void stop() override {
+            submit(m_stopCmdBuffer);
+            m_valid = true;
+        }
+
+        uint64_t query(bool reset = true) const override {
+            uint64_t duration = 0;
+            if (m_valid) {
+                // Never block: if the GPU is not done yet, we just report no measurement.
+                uint64_t timestamps[2]{};
+                if (m_runtime.m_vkDispatch.vkGetQueryPoolResults(m_runtime.m_vkDevice,
+                                                                 m_queryPool,
+                                                                 0,
+                                                                 2,
+                                                                 sizeof(timestamps),
+                                                                 timestamps,
+                                                                 sizeof(uint64_t),
+                                                                 VK_QUERY_RESULT_64_BIT) == VK_SUCCESS &&
+                    timestamps[1] > timestamps[0]) {
+                    duration = static_cast<uint64_t>(((timestamps[1] - timestamps[0]) * m_timestampPeriod) / 1e3);
+                }
+                m_valid = !reset;
+            }
+            return duration;
+        }
+
+      private:
+        void submit(VkCommandBuffer cmdBuffer) const {
+            VkSubmitInfo submitInfo{VK_STRUCTURE_TYPE_SUBMIT_INFO};
+            submitInfo.commandBufferCount = 1;
+            submitInfo.pCommandBuffers = &cmdBuffer;
+            CHECK_VKCMD(m_runtime.m_vkDispatch.vkQueueSubmit(m_runtime.m_vkQueue, 1, &submitInfo, VK_NULL_HANDLE));
+        }
+
+        const OpenXrRuntime& m_runtime;
+        const float m_timestampPeriod;
+        VkQueryPool m_queryPool{VK_NULL_HANDLE};
+        VkCommandBuffer m_startCmdBuffer{VK_NULL_HANDLE};
+        VkCommandBuffer m_stopCmdBuffer{VK_NULL_HANDLE};
+
+        // Can the timer be queried (it might still only read 0).
+        mutable bool m_valid{false};
+    };
+
     // https://www.khronos.org/registry/OpenXR/specs/1.0/html/xrspec.html#xrGetVulkanInstanceExtensionsKHR
     XrResult OpenXrRuntime::xrGetVulkanInstanceExtensionsKHR(XrInstance instance,
                                                              XrSystemId systemId,
@@ -497,7 +586,7 @@ namespace pimax_openxr {
 
         // Frame timers.
         for (uint32_t i = 0; i < k_numGpuTimers; i++) {
-            // TODO: m_gpuTimerApp[i] = std::make_unique<GpuTimer>(...);
+            m_gpuTimerApp[i] = std::make_unique<VulkanGpuTimer>(*this, properties.properties.limits.timestampPeriod);
         }
 
         return XR_SUCCESS;
@@ -534,6 +623,11 @@ namespace pimax_openxr {
         VK_GET_PTR(vkImportSemaphoreWin32HandleKHR);
         VK_GET_PTR(vkWaitSemaphoresKHR);
         VK_GET_PTR(vkDeviceWaitIdle);
+        VK_GET_PTR(vkCreateQueryPool);
+        VK_GET_PTR(vkDestroyQueryPool);
+        VK_GET_PTR(vkCmdResetQueryPool);
+        VK_GET_PTR(vkCmdWriteTimestamp);
+        VK_GET_PTR(vkGetQueryPoolResults);
 
 #undef VK_GET_PTR
     }
@@ -550,6 +644,7 @@ namespace pimax_openxr {
             m_vkDispatch.vkDestroySemaphore(m_vkDevice, m_vkTimelineSemaphore, m_vkAllocator);
             m_vkTimelineSemaphore = VK_NULL_HANDLE;
         }
+        m_vkPendingTransitions.clear();
         if (m_vkDispatch.vkDestroyCommandPool) {
             m_vkDispatch.vkDestroyCommandPool(m_vkDevice, m_vkCmdPool, m_vkAllocator);
             m_vkCmdPool = VK_NULL_HANDLE;
@@ -581,14 +676,6 @@ namespace pimax_openxr {
         if (!initialized) {
             // Query the swapchain textures.
             textureHandles = getSwapchainImages(xrSwapchain);
-
-            // Create the command list needed for transitioning the resources.
-            VkCommandBufferAllocateInfo allocateInfo{VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO};
-            allocateInfo.commandPool = m_vkCmdPool;
-            allocateInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
-            allocateInfo.commandBufferCount = 1;
-
-            CHECK_VKCMD(m_vkDispatch.vkAllocateCommandBuffers(m_vkDevice, &allocateInfo, &xrSwapchain.vkCmdBuffer));
         }
 
         // Helper to select the memory type.
@@ -706,55 +793,118 @@ namespace pimax_openxr {
                               TLXArg(vkImages[i].image, "Texture"));
         }
 
+        if (!initialized) {
+            recordTransitionsVulkan(xrSwapchain);
+        }
+
         return XR_SUCCESS;
     }
 
+    // Record the transitions for acquire and release of each image once, so that we only need to submit them later.
+    void OpenXrRuntime::recordTransitionsVulkan(Swapchain& xrSwapchain) {
+        const bool isColor = xrSwapchain.xrDesc.usageFlags & XR_SWAPCHAIN_USAGE_COLOR_ATTACHMENT_BIT;
+        const bool isDepth = xrSwapchain.xrDesc.usageFlags & XR_SWAPCHAIN_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT;
+        if (!isColor && !isDepth) {
+            return;
+        }
+
+        const uint32_t count = (uint32_t)xrSwapchain.vkImages.size();
+        xrSwapchain.vkAcquireCmdBuffers.resize(count);
+        xrSwapchain.vkReleaseCmdBuffers.resize(count);
+
+        VkCommandBufferAllocateInfo allocateInfo{VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO};
+        allocateInfo.commandPool = m_vkCmdPool;
+        allocateInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+        allocateInfo.commandBufferCount = count;
+        CHECK_VKCMD(m_vkDispatch.vkAllocateCommandBuffers(
+            m_vkDevice, &allocateInfo, xrSwapchain.vkAcquireCmdBuffers.data()));
+        CHECK_VKCMD(m_vkDispatch.vkAllocateCommandBuffers(
+            m_vkDevice, &allocateInfo, xrSwapchain.vkReleaseCmdBuffers.data()));
+
+        const VkFormat format = (VkFormat)xrSwapchain.xrDesc.format;
+        const bool hasStencil = format == VK_FORMAT_D24_UNORM_S8_UINT || format == VK_FORMAT_D32_SFLOAT_S8_UINT;
+        const VkImageLayout appLayout =
+            isColor ? VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL : VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+        const VkAccessFlags appAccess =
+            isColor ? VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT : VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+
+        for (uint32_t i = 0; i < count; i++) {
+            for (const bool acquire : {true, false}) {
+                const VkCommandBuffer cmdBuffer =
+                    acquire ? xrSwapchain.vkAcquireCmdBuffers[i] : xrSwapchain.vkReleaseCmdBuffers[i];
+
+                VkImageMemoryBarrier barrier{VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER};
+                barrier.oldLayout = acquire ? VK_IMAGE_LAYOUT_UNDEFINED : appLayout;
+                barrier.newLayout = acquire ? appLayout : VK_IMAGE_LAYOUT_GENERAL;
+                barrier.srcAccessMask = acquire ? 0 : appAccess;
+                barrier.dstAccessMask = acquire ? appAccess : 0;
+                barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+                barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+                barrier.image = xrSwapchain.vkImages[i];
+                barrier.subresourceRange.aspectMask =
+                    isColor ? VK_IMAGE_ASPECT_COLOR_BIT
+                            : VK_IMAGE_ASPECT_DEPTH_BIT | (hasStencil ? VK_IMAGE_ASPECT_STENCIL_BIT : 0);
+                barrier.subresourceRange.baseMipLevel = 0;
+                barrier.subresourceRange.levelCount = VK_REMAINING_MIP_LEVELS;
+                barrier.subresourceRange.baseArrayLayer = 0;
+                barrier.subresourceRange.layerCount = VK_REMAINING_ARRAY_LAYERS;
+
+                // The same command buffer may be resubmitted before its previous execution completed.
+                VkCommandBufferBeginInfo beginInfo{VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO};
+                beginInfo.flags = VK_COMMAND_BUFFER_USAGE_SIMULTANEOUS_USE_BIT;
+
+                CHECK_VKCMD(m_vkDispatch.vkBeginCommandBuffer(cmdBuffer, &beginInfo));
+
+                m_vkDispatch.vkCmdPipelineBarrier(cmdBuffer,
+                                                  acquire ? VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT
+                                                          : VK_PIPELINE_STAGE_ALL_GRAPHICS_BIT,
+                                                  acquire ? VK_PIPELINE_STAGE_ALL_GRAPHICS_BIT
+                                                          : VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+                                                  0,
+                                                  0,
+                                                  (VkMemoryBarrier*)nullptr,
+                                                  0,
+                                                  (VkBufferMemoryBarrier*)nullptr,
+                                                  1,
+                                                  &barrier);
+
+                CHECK_VKCMD(m_vkDispatch.vkEndCommandBuffer(cmdBuffer));
+            }
+        }
+    }
+
     // Transition a swapchain image to the appropriate layout.
     void OpenXrRuntime::transitionImageVulkan(Swapchain& xrSwapchain, uint32_t index, bool acquire) {
-        if (!(xrSwapchain.xrDesc.usageFlags &
-              (XR_SWAPCHAIN_USAGE_COLOR_ATTACHMENT_BIT | XR_SWAPCHAIN_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT))) {
+        if (xrSwapchain.vkAcquireCmdBuffers.empty()) {
+            return;
+        }
+
+        if (acquire) {
+            // The application is about to render: submit now, along with any release transition still pending.
+            m_vkPendingTransitions.push_back(xrSwapchain.vkAcquireCmdBuffers[index]);
+            submitVulkanCommands();
+        } else {
+            // Defer until the next submission.
+            m_vkPendingTransitions.push_back(xrSwapchain.vkReleaseCmdBuffers[index]);
+        }
+    }
+
+    // Submit the pending transitions and optionally signal the timeline semaphore, all with a single submission.
+    void OpenXrRuntime::submitVulkanCommands(const uint64_t* signalValue) {
+        if (m_vkPendingTransitions.empty() && !signalValue) {
             return;
         }
 
-        VkImageMemoryBarrier barrier{VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER};
-        barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-        if (xrSwapchain.xrDesc.usageFlags & XR_SWAPCHAIN_USAGE_COLOR_ATTACHMENT_BIT) {
-            barrier.newLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
-        }
-        if (xrSwapchain.xrDesc.usageFlags & XR_SWAPCHAIN_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT) {
-            barrier.newLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
-        }
-        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-        barrier.image = xrSwapchain.vkImages[index];
-        barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-        barrier.subresourceRange.baseMipLevel = 0;
-        barrier.subresourceRange.levelCount = VK_REMAINING_MIP_LEVELS;
-        barrier.subresourceRange.baseArrayLayer = 0;
-        barrier.subresourceRange.layerCount = VK_REMAINING_ARRAY_LAYERS;
-
-        VkCommandBufferBeginInfo beginInfo{VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO};
-        beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
-
-        CHECK_VKCMD(m_vkDispatch.vkBeginCommandBuffer(xrSwapchain.vkCmdBuffer, &beginInfo));
-
-        m_vkDispatch.vkCmdPipelineBarrier(xrSwapchain.vkCmdBuffer,
-                                          VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
-                                          VK_PIPELINE_STAGE_ALL_GRAPHICS_BIT,
-                                          0,
-                                          0,
-                                          (VkMemoryBarrier*)nullptr,
-                                          0,
-                                          (VkBufferMemoryBarrier*)nullptr,
-                                          1,
-                                          &barrier);
-
-        m_vkDispatch.vkEndCommandBuffer(xrSwapchain.vkCmdBuffer);
-
-        VkSubmitInfo submitInfo{VK_STRUCTURE_TYPE_SUBMIT_INFO};
-        submitInfo.commandBufferCount = 1;
-        submitInfo.pCommandBuffers = &xrSwapchain.vkCmdBuffer;
+        VkTimelineSemaphoreSubmitInfo timelineInfo{VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO};
+        timelineInfo.signalSemaphoreValueCount = signalValue ? 1 : 0;
+        timelineInfo.pSignalSemaphoreValues = signalValue;
+        VkSubmitInfo submitInfo{VK_STRUCTURE_TYPE_SUBMIT_INFO, signalValue ? &timelineInfo : nullptr};
+        submitInfo.commandBufferCount = (uint32_t)m_vkPendingTransitions.size();
+        submitInfo.pCommandBuffers = m_vkPendingTransitions.data();
+        submitInfo.signalSemaphoreCount = signalValue ? 1 : 0;
+        submitInfo.pSignalSemaphores = &m_vkTimelineSemaphore;
         CHECK_VKCMD(m_vkDispatch.vkQueueSubmit(m_vkQueue, 1, &submitInfo, VK_NULL_HANDLE));
+        m_vkPendingTransitions.clear();
     }
 
     // Wait for all pending commands to finish.
@@ -763,13 +913,7 @@ namespace pimax_openxr {
             m_fenceValue++;
             TraceLoggingWrite(
                 g_traceProvider, "FlushContext_Wait", TLArg("Vulkan", "Api"), TLArg(m_fenceValue, "FenceValue"));
-            VkTimelineSemaphoreSubmitInfo timelineInfo{VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO};
-            timelineInfo.signalSemaphoreValueCount = 1;
-            timelineInfo.pSignalSemaphoreValues = &m_fenceValue;
-            VkSubmitInfo submitInfo{VK_STRUCTURE_TYPE_SUBMIT_INFO, &timelineInfo};
-            submitInfo.signalSemaphoreCount = 1;
-            submitInfo.pSignalSemaphores = &m_vkTimelineSemaphore;
-            CHECK_VKCMD(m_vkDispatch.vkQueueSubmit(m_vkQueue, 1, &submitInfo, VK_NULL_HANDLE));
+            submitVulkanCommands(&m_fenceValue);
             VkSemaphoreWaitInfo waitInfo{VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO};
             waitInfo.semaphoreCount = 1;
             waitInfo.pSemaphores = &m_vkTimelineSemaphore;
@@ -783,13 +927,9 @@ namespace pimax_openxr {
         m_fenceValue++;
         TraceLoggingWrite(
             g_traceProvider, "xrEndFrame_Sync", TLArg("Vulkan", "Api"), TLArg(m_fenceValue, "FenceValue"));
-        VkTimelineSemaphoreSubmitInfo timelineInfo{VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO};
-        timelineInfo.signalSemaphoreValueCount = 1;
-        timelineInfo.pSignalSemaphoreValues = &m_fenceValue;
-        VkSubmitInfo submitInfo{VK_STRUCTURE_TYPE_SUBMIT_INFO, &timelineInfo};
-        submitInfo.signalSemaphoreCount = 1;
-        submitInfo.pSignalSemaphores = &m_vkTimelineSemaphore;
-        CHECK_VKCMD(m_vkDispatch.vkQueueSubmit(m_vkQueue, 1, &submitInfo, VK_NULL_HANDLE));
+
+        // Deferred release transitions are submitted together with the signal.
+        submitVulkanCommands(&m_fenceValue);
 
         waitOnSubmissionDevice();
     }
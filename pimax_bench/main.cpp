@@ -0,0 +1,958 @@
+// MIT License
+//
+// Copyright(c) 2022 Matthieu Bucchianeri
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this softwareand associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright noticeand this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "pch.h"
+
+// A headless benchmark of the runtime's hot paths. The runtime DLL is loaded directly (bypassing the OpenXR loader),
+// on top of the mock PVR client from pvr-mock, and driven through a scripted frame loop for each graphics API. The
+// CPU cost of the per-frame OpenXR calls is reported at the end of each scenario.
+//
+// The mock library must be in the "mock" sub-folder next to this executable, and the runtime DLL next to this
+// executable, which is where the solution builds them. See pvr-mock/dllmain.cpp for the knobs to tune its behavior.
+// Use PVR_MOCK_REFRESH_RATE=0 to run the frame loop unthrottled and measure the runtime overhead alone.
+
+namespace {
+
+    // All the entry points we use, resolved through xrGetInstanceProcAddr().
+#define BENCH_FUNCTIONS(X)                                                                                             \
+    X(xrEnumerateInstanceExtensionProperties)                                                                          \
+    X(xrCreateInstance)                                                                                                \
+    X(xrDestroyInstance)                                                                                               \
+    X(xrGetSystem)                                                                                                     \
+    X(xrPollEvent)                                                                                                     \
+    X(xrStringToPath)                                                                                                  \
+    X(xrCreateSession)                                                                                                 \
+    X(xrDestroySession)                                                                                                \
+    X(xrBeginSession)                                                                                                  \
+    X(xrEndSession)                                                                                                    \
+    X(xrRequestExitSession)                                                                                            \
+    X(xrCreateReferenceSpace)                                                                                          \
+    X(xrCreateActionSpace)                                                                                             \
+    X(xrDestroySpace)                                                                                                  \
+    X(xrLocateSpace)                                                                                                   \
+    X(xrLocateViews)                                                                                                   \
+    X(xrCreateSwapchain)                                                                                               \
+    X(xrDestroySwapchain)                                                                                              \
+    X(xrEnumerateSwapchainImages)                                                                                      \
+    X(xrAcquireSwapchainImage)                                                                                         \
+    X(xrWaitSwapchainImage)                                                                                            \
+    X(xrReleaseSwapchainImage)                                                                                         \
+    X(xrWaitFrame)                                                                                                     \
+    X(xrBeginFrame)                                                                                                    \
+    X(xrEndFrame)                                                                                                      \
+    X(xrCreateActionSet)                                                                                               \
+    X(xrDestroyActionSet)                                                                                              \
+    X(xrCreateAction)                                                                                                  \
+    X(xrSuggestInteractionProfileBindings)                                                                             \
+    X(xrAttachSessionActionSets)                                                                                       \
+    X(xrSyncActions)                                                                                                   \
+    X(xrGetActionStateBoolean)                                                                                         \
+    X(xrGetActionStateFloat)                                                                                           \
+    X(xrGetActionStateVector2f)                                                                                        \
+    X(xrGetActionStatePose)                                                                                            \
+    X(xrGetD3D11GraphicsRequirementsKHR)                                                                               \
+    X(xrGetD3D12GraphicsRequirementsKHR)                                                                               \
+    X(xrGetVulkanGraphicsRequirements2KHR)                                                                             \
+    X(xrCreateVulkanInstanceKHR)                                                                                       \
+    X(xrGetVulkanGraphicsDevice2KHR)                                                                                   \
+    X(xrCreateVulkanDeviceKHR)                                                                                         \
+    X(xrGetOpenGLGraphicsRequirementsKHR)
+
+#define DECLARE_FUNCTION(name) PFN_##name name = nullptr;
+    BENCH_FUNCTIONS(DECLARE_FUNCTION)
+#undef DECLARE_FUNCTION
+
+    PFN_xrGetInstanceProcAddr xrGetInstanceProcAddr = nullptr;
+
+    void loadFunctions(XrInstance instance) {
+#define LOAD_FUNCTION(name)                                                                                            \
+    if (XR_FAILED(xrGetInstanceProcAddr(instance, #name, reinterpret_cast<PFN_xrVoidFunction*>(&name)))) {             \
+        name = nullptr;                                                                                                \
+    }
+        BENCH_FUNCTIONS(LOAD_FUNCTION)
+#undef LOAD_FUNCTION
+    }
+
+    struct Options {
+        std::vector<std::string> apis{"d3d11", "d3d12", "vulkan", "opengl"};
+        uint32_t frames{1000};
+        uint32_t quadLayers{0};
+        uint32_t actions{8};
+        bool useDepth{false};
+        bool useTextureArray{false};
+        bool allScenarios{true};
+    };
+
+    struct Scenario {
+        std::string name;
+        uint32_t quadLayers;
+        uint32_t actions;
+        bool useDepth;
+        bool useTextureArray;
+    };
+
+    // Timing of one OpenXR entry point over a scenario. Wall time includes any blocking (eg: frame pacing), while
+    // the thread cycles only count the time actually spent executing on the calling thread.
+    class CallStats {
+      public:
+        CallStats(std::string_view name) : m_name(name) {
+        }
+
+        template <typename F>
+        XrResult measure(F&& call) {
+            LARGE_INTEGER start, end;
+            ULONG64 startCycles, endCycles;
+            QueryThreadCycleTime(GetCurrentThread(), &startCycles);
+            QueryPerformanceCounter(&start);
+            const XrResult result = call();
+            QueryPerformanceCounter(&end);
+            QueryThreadCycleTime(GetCurrentThread(), &endCycles);
+
+            m_wallTimes.push_back(end.QuadPart - start.QuadPart);
+            m_cycles.push_back(endCycles - startCycles);
+            return result;
+        }
+
+        void print(const LARGE_INTEGER& qpcFrequency) {
+            if (m_wallTimes.empty()) {
+                return;
+            }
+
+            const auto toUs = [&](LONGLONG ticks) { return ticks * 1e6 / qpcFrequency.QuadPart; };
+            std::sort(m_wallTimes.begin(), m_wallTimes.end());
+            std::sort(m_cycles.begin(), m_cycles.end());
+            const auto percentile = [](const auto& values, double p) {
+                return values[std::min(values.size() - 1, (size_t)(p * values.size()))];
+            };
+            double meanWall = 0, meanCycles = 0;
+            for (size_t i = 0; i < m_wallTimes.size(); i++) {
+                meanWall += toUs(m_wallTimes[i]);
+                meanCycles += m_cycles[i] / 1e3;
+            }
+            meanWall /= m_wallTimes.size();
+            meanCycles /= m_cycles.size();
+
+            fmt::print("  {:<28} {:>8} {:>10.1f} {:>10.1f} {:>10.1f} {:>10.1f} {:>12.1f} {:>12.1f}\n",
+                       m_name,
+                       m_wallTimes.size(),
+                       meanWall,
+                       toUs(percentile(m_wallTimes, 0.5)),
+                       toUs(percentile(m_wallTimes, 0.99)),
+                       toUs(m_wallTimes.back()),
+                       meanCycles,
+                       percentile(m_cycles, 0.99) / 1e3);
+        }
+
+        static void printHeader() {
+            fmt::print("  {:<28} {:>8} {:>10} {:>10} {:>10} {:>10} {:>12} {:>12}\n",
+                       "Call",
+                       "Count",
+                       "Mean(us)",
+                       "P50(us)",
+                       "P99(us)",
+                       "Max(us)",
+                       "Mean(kcyc)",
+                       "P99(kcyc)");
+        }
+
+      private:
+        const std::string m_name;
+        std::vector<LONGLONG> m_wallTimes;
+        std::vector<ULONG64> m_cycles;
+    };
+
+    // The graphics API-specific bits: device creation, session binding, swapchain formats and images.
+    struct GraphicsBackend {
+        virtual ~GraphicsBackend() = default;
+
+        virtual const char* getExtensionName() const = 0;
+        virtual void initialize(XrInstance instance, XrSystemId systemId) = 0;
+        virtual const void* getGraphicsBinding() const = 0;
+        virtual int64_t getColorFormat() const = 0;
+        virtual int64_t getDepthFormat() const = 0;
+        virtual uint32_t enumerateSwapchainImages(XrSwapchain swapchain) = 0;
+    };
+
+    struct D3D11Backend : GraphicsBackend {
+        const char* getExtensionName() const override {
+            return XR_KHR_D3D11_ENABLE_EXTENSION_NAME;
+        }
+
+        void initialize(XrInstance instance, XrSystemId systemId) override {
+            XrGraphicsRequirementsD3D11KHR requirements{XR_TYPE_GRAPHICS_REQUIREMENTS_D3D11_KHR};
+            CHECK_XRCMD(xrGetD3D11GraphicsRequirementsKHR(instance, systemId, &requirements));
+
+            ComPtr<IDXGIFactory4> factory;
+            CHECK_HRCMD(CreateDXGIFactory1(IID_PPV_ARGS(factory.ReleaseAndGetAddressOf())));
+            ComPtr<IDXGIAdapter1> adapter;
+            CHECK_HRCMD(factory->EnumAdapterByLuid(requirements.adapterLuid,
+                                                   IID_PPV_ARGS(adapter.ReleaseAndGetAddressOf())));
+
+            const D3D_FEATURE_LEVEL featureLevel = requirements.minFeatureLevel;
+            CHECK_HRCMD(D3D11CreateDevice(adapter.Get(),
+                                          D3D_DRIVER_TYPE_UNKNOWN,
+                                          nullptr,
+                                          0,
+                                          &featureLevel,
+                                          1,
+                                          D3D11_SDK_VERSION,
+                                          m_device.ReleaseAndGetAddressOf(),
+                                          nullptr,
+                                          nullptr));
+            m_binding.device = m_device.Get();
+        }
+
+        const void* getGraphicsBinding() const override {
+            return &m_binding;
+        }
+
+        int64_t getColorFormat() const override {
+            return DXGI_FORMAT_R8G8B8A8_UNORM_SRGB;
+        }
+
+        int64_t getDepthFormat() const override {
+            return DXGI_FORMAT_D32_FLOAT;
+        }
+
+        uint32_t enumerateSwapchainImages(XrSwapchain swapchain) override {
+            uint32_t count = 0;
+            CHECK_XRCMD(xrEnumerateSwapchainImages(swapchain, 0, &count, nullptr));
+            std::vector<XrSwapchainImageD3D11KHR> images(count, {XR_TYPE_SWAPCHAIN_IMAGE_D3D11_KHR});
+            CHECK_XRCMD(xrEnumerateSwapchainImages(
+                swapchain, count, &count, reinterpret_cast<XrSwapchainImageBaseHeader*>(images.data())));
+            return count;
+        }
+
+        ComPtr<ID3D11Device> m_device;
+        XrGraphicsBindingD3D11KHR m_binding{XR_TYPE_GRAPHICS_BINDING_D3D11_KHR};
+    };
+
+    struct D3D12Backend : GraphicsBackend {
+        const char* getExtensionName() const override {
+            return XR_KHR_D3D12_ENABLE_EXTENSION_NAME;
+        }
+
+        void initialize(XrInstance instance, XrSystemId systemId) override {
+            XrGraphicsRequirementsD3D12KHR requirements{XR_TYPE_GRAPHICS_REQUIREMENTS_D3D12_KHR};
+            CHECK_XRCMD(xrGetD3D12GraphicsRequirementsKHR(instance, systemId, &requirements));
+
+            ComPtr<IDXGIFactory4> factory;
+            CHECK_HRCMD(CreateDXGIFactory1(IID_PPV_ARGS(factory.ReleaseAndGetAddressOf())));
+            ComPtr<IDXGIAdapter1> adapter;
+            CHECK_HRCMD(factory->EnumAdapterByLuid(requirements.adapterLuid,
+                                                   IID_PPV_ARGS(adapter.ReleaseAndGetAddressOf())));
+
+            CHECK_HRCMD(D3D12CreateDevice(
+                adapter.Get(), requirements.minFeatureLevel, IID_PPV_ARGS(m_device.ReleaseAndGetAddressOf())));
+
+            D3D12_COMMAND_QUEUE_DESC queueDesc{};
+            queueDesc.Type = D3D12_COMMAND_LIST_TYPE_DIRECT;
+            CHECK_HRCMD(m_device->CreateCommandQueue(&queueDesc, IID_PPV_ARGS(m_queue.ReleaseAndGetAddressOf())));
+
+            m_binding.device = m_device.Get();
+            m_binding.queue = m_queue.Get();
+        }
+
+        const void* getGraphicsBinding() const override {
+            return &m_binding;
+        }
+
+        int64_t getColorFormat() const override {
+            return DXGI_FORMAT_R8G8B8A8_UNORM_SRGB;
+        }
+
+        int64_t getDepthFormat() const override {
+            return DXGI_FORMAT_D32_FLOAT;
+        }
+
+        uint32_t enumerateSwapchainImages(XrSwapchain swapchain) override {
+            uint32_t count = 0;
+            CHECK_XRCMD(xrEnumerateSwapchainImages(swapchain, 0, &count, nullptr));
+            std::vector<XrSwapchainImageD3D12KHR> images(count, {XR_TYPE_SWAPCHAIN_IMAGE_D3D12_KHR});
+            CHECK_XRCMD(xrEnumerateSwapchainImages(
+                swapchain, count, &count, reinterpret_cast<XrSwapchainImageBaseHeader*>(images.data())));
+            return count;
+        }
+
+        ComPtr<ID3D12Device> m_device;
+        ComPtr<ID3D12CommandQueue> m_queue;
+        XrGraphicsBindingD3D12KHR m_binding{XR_TYPE_GRAPHICS_BINDING_D3D12_KHR};
+    };
+
+    struct VulkanBackend : GraphicsBackend {
+        ~VulkanBackend() override {
+            if (m_device != VK_NULL_HANDLE) {
+                vkDestroyDevice(m_device, nullptr);
+            }
+            if (m_instance != VK_NULL_HANDLE) {
+                vkDestroyInstance(m_instance, nullptr);
+            }
+        }
+
+        const char* getExtensionName() const override {
+            return XR_KHR_VULKAN_ENABLE2_EXTENSION_NAME;
+        }
+
+        void initialize(XrInstance instance, XrSystemId systemId) override {
+            XrGraphicsRequirementsVulkan2KHR requirements{XR_TYPE_GRAPHICS_REQUIREMENTS_VULKAN2_KHR};
+            CHECK_XRCMD(xrGetVulkanGraphicsRequirements2KHR(instance, systemId, &requirements));
+
+            VkApplicationInfo appInfo{VK_STRUCTURE_TYPE_APPLICATION_INFO};
+            appInfo.pApplicationName = "pimax_bench";
+            appInfo.apiVersion = VK_MAKE_VERSION(XR_VERSION_MAJOR(requirements.minApiVersionSupported),
+                                                 XR_VERSION_MINOR(requirements.minApiVersionSupported),
+                                                 0);
+            VkInstanceCreateInfo instanceInfo{VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO};
+            instanceInfo.pApplicationInfo = &appInfo;
+
+            XrVulkanInstanceCreateInfoKHR xrInstanceInfo{XR_TYPE_VULKAN_INSTANCE_CREATE_INFO_KHR};
+            xrInstanceInfo.systemId = systemId;
+            xrInstanceInfo.pfnGetInstanceProcAddr = vkGetInstanceProcAddr;
+            xrInstanceInfo.vulkanCreateInfo = &instanceInfo;
+            VkResult vkResult = VK_SUCCESS;
+            CHECK_XRCMD(xrCreateVulkanInstanceKHR(instance, &xrInstanceInfo, &m_instance, &vkResult));
+            checkVkResult(vkResult, "vkCreateInstance");
+
+            XrVulkanGraphicsDeviceGetInfoKHR deviceGetInfo{XR_TYPE_VULKAN_GRAPHICS_DEVICE_GET_INFO_KHR};
+            deviceGetInfo.systemId = systemId;
+            deviceGetInfo.vulkanInstance = m_instance;
+            CHECK_XRCMD(xrGetVulkanGraphicsDevice2KHR(instance, &deviceGetInfo, &m_physicalDevice));
+
+            uint32_t queueFamilyCount = 0;
+            vkGetPhysicalDeviceQueueFamilyProperties(m_physicalDevice, &queueFamilyCount, nullptr);
+            std::vector<VkQueueFamilyProperties> queueFamilies(queueFamilyCount);
+            vkGetPhysicalDeviceQueueFamilyProperties(m_physicalDevice, &queueFamilyCount, queueFamilies.data());
+            m_queueFamilyIndex = 0;
+            while (m_queueFamilyIndex < queueFamilyCount &&
+                   !(queueFamilies[m_queueFamilyIndex].queueFlags & VK_QUEUE_GRAPHICS_BIT)) {
+                m_queueFamilyIndex++;
+            }
+            if (m_queueFamilyIndex == queueFamilyCount) {
+                throw std::runtime_error("No graphics queue");
+            }
+
+            const float queuePriority = 1.f;
+            VkDeviceQueueCreateInfo queueInfo{VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO};
+            queueInfo.queueFamilyIndex = m_queueFamilyIndex;
+            queueInfo.queueCount = 1;
+            queueInfo.pQueuePriorities = &queuePriority;
+            VkDeviceCreateInfo deviceInfo{VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO};
+            deviceInfo.queueCreateInfoCount = 1;
+            deviceInfo.pQueueCreateInfos = &queueInfo;
+
+            XrVulkanDeviceCreateInfoKHR xrDeviceInfo{XR_TYPE_VULKAN_DEVICE_CREATE_INFO_KHR};
+            xrDeviceInfo.systemId = systemId;
+            xrDeviceInfo.pfnGetInstanceProcAddr = vkGetInstanceProcAddr;
+            xrDeviceInfo.vulkanPhysicalDevice = m_physicalDevice;
+            xrDeviceInfo.vulkanCreateInfo = &deviceInfo;
+            CHECK_XRCMD(xrCreateVulkanDeviceKHR(instance, &xrDeviceInfo, &m_device, &vkResult));
+            checkVkResult(vkResult, "vkCreateDevice");
+
+            m_binding.instance = m_instance;
+            m_binding.physicalDevice = m_physicalDevice;
+            m_binding.device = m_device;
+            m_binding.queueFamilyIndex = m_queueFamilyIndex;
+            m_binding.queueIndex = 0;
+        }
+
+        const void* getGraphicsBinding() const override {
+            return &m_binding;
+        }
+
+        static void checkVkResult(VkResult result, const char* call) {
+            if (result != VK_SUCCESS) {
+                throw std::runtime_error(fmt::format("{} failed with: {}", call, (int)result));
+            }
+        }
+
+        int64_t getColorFormat() const override {
+            return VK_FORMAT_R8G8B8A8_SRGB;
+        }
+
+        int64_t getDepthFormat() const override {
+            return VK_FORMAT_D32_SFLOAT;
+        }
+
+        uint32_t enumerateSwapchainImages(XrSwapchain swapchain) override {
+            uint32_t count = 0;
+            CHECK_XRCMD(xrEnumerateSwapchainImages(swapchain, 0, &count, nullptr));
+            std::vector<XrSwapchainImageVulkanKHR> images(count, {XR_TYPE_SWAPCHAIN_IMAGE_VULKAN_KHR});
+            CHECK_XRCMD(xrEnumerateSwapchainImages(
+                swapchain, count, &count, reinterpret_cast<XrSwapchainImageBaseHeader*>(images.data())));
+            return count;
+        }
+
+        VkInstance m_instance{VK_NULL_HANDLE};
+        VkPhysicalDevice m_physicalDevice{VK_NULL_HANDLE};
+        VkDevice m_device{VK_NULL_HANDLE};
+        uint32_t m_queueFamilyIndex{0};
+        XrGraphicsBindingVulkanKHR m_binding{XR_TYPE_GRAPHICS_BINDING_VULKAN_KHR};
+    };
+
+    struct OpenGLBackend : GraphicsBackend {
+        ~OpenGLBackend() override {
+            if (m_glrc) {
+                wglMakeCurrent(nullptr, nullptr);
+                wglDeleteContext(m_glrc);
+            }
+            if (m_dc) {
+                ReleaseDC(m_window, m_dc);
+            }
+            if (m_window) {
+                DestroyWindow(m_window);
+            }
+        }
+
+        const char* getExtensionName() const override {
+            return XR_KHR_OPENGL_ENABLE_EXTENSION_NAME;
+        }
+
+        void initialize(XrInstance instance, XrSystemId systemId) override {
+            XrGraphicsRequirementsOpenGLKHR requirements{XR_TYPE_GRAPHICS_REQUIREMENTS_OPENGL_KHR};
+            CHECK_XRCMD(xrGetOpenGLGraphicsRequirementsKHR(instance, systemId, &requirements));
+
+            // A hidden window is needed to get a device context. The context we get from the driver is a
+            // compatibility profile of the highest version supported, which exposes the interop extensions.
+            WNDCLASSEXW windowClass{sizeof(windowClass)};
+            windowClass.style = CS_OWNDC;
+            windowClass.lpfnWndProc = DefWindowProcW;
+            windowClass.hInstance = GetModuleHandle(nullptr);
+            windowClass.lpszClassName = L"PimaxBenchGL";
+            RegisterClassExW(&windowClass);
+            m_window = CreateWindowW(windowClass.lpszClassName,
+                                     L"pimax_bench",
+                                     WS_OVERLAPPEDWINDOW,
+                                     0,
+                                     0,
+                                     64,
+                                     64,
+                                     nullptr,
+                                     nullptr,
+                                     windowClass.hInstance,
+                                     nullptr);
+            if (!m_window) {
+                throw std::runtime_error("Failed to create window");
+            }
+            m_dc = GetDC(m_window);
+
+            PIXELFORMATDESCRIPTOR pfd{sizeof(pfd), 1};
+            pfd.dwFlags = PFD_DRAW_TO_WINDOW | PFD_SUPPORT_OPENGL | PFD_DOUBLEBUFFER;
+            pfd.iPixelType = PFD_TYPE_RGBA;
+            pfd.cColorBits = 32;
+            pfd.cDepthBits = 24;
+            if (!SetPixelFormat(m_dc, ChoosePixelFormat(m_dc, &pfd), &pfd)) {
+                throw std::runtime_error("Failed to set pixel format");
+            }
+            m_glrc = wglCreateContext(m_dc);
+            if (!m_glrc || !wglMakeCurrent(m_dc, m_glrc)) {
+                throw std::runtime_error("Failed to create OpenGL context");
+            }
+
+            m_binding.hDC = m_dc;
+            m_binding.hGLRC = m_glrc;
+        }
+
+        const void* getGraphicsBinding() const override {
+            return &m_binding;
+        }
+
+        int64_t getColorFormat() const override {
+            return GL_SRGB8_ALPHA8;
+        }
+
+        int64_t getDepthFormat() const override {
+            return GL_DEPTH_COMPONENT32F;
+        }
+
+        uint32_t enumerateSwapchainImages(XrSwapchain swapchain) override {
+            uint32_t count = 0;
+            CHECK_XRCMD(xrEnumerateSwapchainImages(swapchain, 0, &count, nullptr));
+            std::vector<XrSwapchainImageOpenGLKHR> images(count, {XR_TYPE_SWAPCHAIN_IMAGE_OPENGL_KHR});
+            CHECK_XRCMD(xrEnumerateSwapchainImages(
+                swapchain, count, &count, reinterpret_cast<XrSwapchainImageBaseHeader*>(images.data())));
+            return count;
+        }
+
+        HWND m_window{nullptr};
+        HDC m_dc{nullptr};
+        HGLRC m_glrc{nullptr};
+        XrGraphicsBindingOpenGLWin32KHR m_binding{XR_TYPE_GRAPHICS_BINDING_OPENGL_WIN32_KHR};
+    };
+
+    std::unique_ptr<GraphicsBackend> createBackend(std::string_view api) {
+        if (api == "d3d11") {
+            return std::make_unique<D3D11Backend>();
+        } else if (api == "d3d12") {
+            return std::make_unique<D3D12Backend>();
+        } else if (api == "vulkan") {
+            return std::make_unique<VulkanBackend>();
+        } else if (api == "opengl") {
+            return std::make_unique<OpenGLBackend>();
+        }
+        throw std::runtime_error(fmt::format("Unknown graphics API: {}", api));
+    }
+
+    XrPath getPath(XrInstance instance, const char* path) {
+        XrPath xrPath = XR_NULL_PATH;
+        CHECK_XRCMD(xrStringToPath(instance, path, &xrPath));
+        return xrPath;
+    }
+
+    // Returns once the session reached the requested state, or throws if the runtime never gets there.
+    void waitForSessionState(XrInstance instance, XrSessionState state) {
+        const auto deadline = GetTickCount64() + 5000;
+        while (GetTickCount64() < deadline) {
+            XrEventDataBuffer event{XR_TYPE_EVENT_DATA_BUFFER};
+            while (xrPollEvent(instance, &event) == XR_SUCCESS) {
+                if (event.type == XR_TYPE_EVENT_DATA_SESSION_STATE_CHANGED &&
+                    reinterpret_cast<XrEventDataSessionStateChanged*>(&event)->state == state) {
+                    return;
+                }
+                event = {XR_TYPE_EVENT_DATA_BUFFER};
+            }
+            Sleep(1);
+        }
+        throw std::runtime_error(fmt::format("Timed out waiting for session state {}", xr::ToCString(state)));
+    }
+
+    void runScenario(const std::string& api, const Scenario& scenario, uint32_t frames) {
+        fmt::print("\n[{}] {}\n", api, scenario.name);
+
+        auto backend = createBackend(api);
+
+        std::vector<const char*> extensions{backend->getExtensionName()};
+        if (scenario.useDepth) {
+            extensions.push_back(XR_KHR_COMPOSITION_LAYER_DEPTH_EXTENSION_NAME);
+        }
+
+        XrInstanceCreateInfo instanceInfo{XR_TYPE_INSTANCE_CREATE_INFO};
+        strcpy_s(instanceInfo.applicationInfo.applicationName, "pimax_bench");
+        instanceInfo.applicationInfo.apiVersion = XR_CURRENT_API_VERSION;
+        instanceInfo.enabledExtensionCount = (uint32_t)extensions.size();
+        instanceInfo.enabledExtensionNames = extensions.data();
+        XrInstance instance = XR_NULL_HANDLE;
+        CHECK_XRCMD(xrCreateInstance(&instanceInfo, &instance));
+        loadFunctions(instance);
+
+        XrSystemGetInfo systemInfo{XR_TYPE_SYSTEM_GET_INFO};
+        systemInfo.formFactor = XR_FORM_FACTOR_HEAD_MOUNTED_DISPLAY;
+        XrSystemId systemId = XR_NULL_SYSTEM_ID;
+        CHECK_XRCMD(xrGetSystem(instance, &systemInfo, &systemId));
+
+        backend->initialize(instance, systemId);
+
+        XrSessionCreateInfo sessionInfo{XR_TYPE_SESSION_CREATE_INFO};
+        sessionInfo.next = backend->getGraphicsBinding();
+        sessionInfo.systemId = systemId;
+        XrSession session = XR_NULL_HANDLE;
+        CHECK_XRCMD(xrCreateSession(instance, &sessionInfo, &session));
+
+        XrReferenceSpaceCreateInfo spaceInfo{XR_TYPE_REFERENCE_SPACE_CREATE_INFO};
+        spaceInfo.poseInReferenceSpace.orientation.w = 1.f;
+        spaceInfo.referenceSpaceType = XR_REFERENCE_SPACE_TYPE_LOCAL;
+        XrSpace localSpace = XR_NULL_HANDLE;
+        CHECK_XRCMD(xrCreateReferenceSpace(session, &spaceInfo, &localSpace));
+        spaceInfo.referenceSpaceType = XR_REFERENCE_SPACE_TYPE_VIEW;
+        XrSpace viewSpace = XR_NULL_HANDLE;
+        CHECK_XRCMD(xrCreateReferenceSpace(session, &spaceInfo, &viewSpace));
+
+        // Actions, cycling through the types of inputs that take different paths in the runtime.
+        struct ActionTemplate {
+            XrActionType type;
+            const char* component;
+        };
+        const ActionTemplate actionTemplates[] = {
+            {XR_ACTION_TYPE_BOOLEAN_INPUT, "input/trigger/click"},
+            {XR_ACTION_TYPE_FLOAT_INPUT, "input/trigger/value"},
+            {XR_ACTION_TYPE_VECTOR2F_INPUT, "input/thumbstick"},
+            {XR_ACTION_TYPE_BOOLEAN_INPUT, "input/a/click"},
+            {XR_ACTION_TYPE_FLOAT_INPUT, "input/squeeze/value"},
+            {XR_ACTION_TYPE_VECTOR2F_INPUT, "input/trackpad"},
+            {XR_ACTION_TYPE_BOOLEAN_INPUT, "input/b/click"},
+            {XR_ACTION_TYPE_FLOAT_INPUT, "input/squeeze/force"},
+        };
+        const XrPath handPaths[] = {getPath(instance, "/user/hand/left"), getPath(instance, "/user/hand/right")};
+        const char* const handNames[] = {"left", "right"};
+
+        XrActionSetCreateInfo actionSetInfo{XR_TYPE_ACTION_SET_CREATE_INFO};
+        strcpy_s(actionSetInfo.actionSetName, "bench");
+        strcpy_s(actionSetInfo.localizedActionSetName, "Bench");
+        XrActionSet actionSet = XR_NULL_HANDLE;
+        CHECK_XRCMD(xrCreateActionSet(instance, &actionSetInfo, &actionSet));
+
+        std::vector<std::pair<XrAction, XrActionType>> actions;
+        std::vector<XrActionSuggestedBinding> bindings;
+        const auto createAction = [&](const std::string& name, XrActionType type) {
+            XrActionCreateInfo actionInfo{XR_TYPE_ACTION_CREATE_INFO};
+            strcpy_s(actionInfo.actionName, name.c_str());
+            strcpy_s(actionInfo.localizedActionName, name.c_str());
+            actionInfo.actionType = type;
+            actionInfo.countSubactionPaths = 2;
+            actionInfo.subactionPaths = handPaths;
+            XrAction action = XR_NULL_HANDLE;
+            CHECK_XRCMD(xrCreateAction(actionSet, &actionInfo, &action));
+            return action;
+        };
+        for (uint32_t i = 0; i < scenario.actions; i++) {
+            const auto& actionTemplate = actionTemplates[i % std::size(actionTemplates)];
+            const XrAction action = createAction(fmt::format("action_{}", i), actionTemplate.type);
+            actions.push_back({action, actionTemplate.type});
+            for (const char* hand : handNames) {
+                bindings.push_back(
+                    {action,
+                     getPath(instance, fmt::format("/user/hand/{}/{}", hand, actionTemplate.component).c_str())});
+            }
+        }
+        const XrAction poseAction = createAction("grip_pose", XR_ACTION_TYPE_POSE_INPUT);
+        for (const char* hand : handNames) {
+            bindings.push_back(
+                {poseAction, getPath(instance, fmt::format("/user/hand/{}/input/grip/pose", hand).c_str())});
+        }
+
+        XrInteractionProfileSuggestedBinding suggestedBindings{XR_TYPE_INTERACTION_PROFILE_SUGGESTED_BINDING};
+        suggestedBindings.interactionProfile = getPath(instance, "/interaction_profiles/valve/index_controller");
+        suggestedBindings.countSuggestedBindings = (uint32_t)bindings.size();
+        suggestedBindings.suggestedBindings = bindings.data();
+        CHECK_XRCMD(xrSuggestInteractionProfileBindings(instance, &suggestedBindings));
+
+        XrSessionActionSetsAttachInfo attachInfo{XR_TYPE_SESSION_ACTION_SETS_ATTACH_INFO};
+        attachInfo.countActionSets = 1;
+        attachInfo.actionSets = &actionSet;
+        CHECK_XRCMD(xrAttachSessionActionSets(session, &attachInfo));
+
+        XrSpace handSpaces[2]{};
+        for (uint32_t side = 0; side < 2; side++) {
+            XrActionSpaceCreateInfo actionSpaceInfo{XR_TYPE_ACTION_SPACE_CREATE_INFO};
+            actionSpaceInfo.action = poseAction;
+            actionSpaceInfo.subactionPath = handPaths[side];
+            actionSpaceInfo.poseInActionSpace.orientation.w = 1.f;
+            CHECK_XRCMD(xrCreateActionSpace(session, &actionSpaceInfo, &handSpaces[side]));
+        }
+
+        // Swapchains: either one per eye or a single texture array, with matching depth swapchains if requested.
+        std::vector<XrSwapchain> swapchains;
+        const auto createSwapchain = [&](uint32_t width, uint32_t height, uint32_t arraySize, bool isDepth) {
+            XrSwapchainCreateInfo swapchainInfo{XR_TYPE_SWAPCHAIN_CREATE_INFO};
+            swapchainInfo.usageFlags = isDepth ? XR_SWAPCHAIN_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT
+                                               : XR_SWAPCHAIN_USAGE_COLOR_ATTACHMENT_BIT;
+            swapchainInfo.format = isDepth ? backend->getDepthFormat() : backend->getColorFormat();
+            swapchainInfo.sampleCount = 1;
+            swapchainInfo.width = width;
+            swapchainInfo.height = height;
+            swapchainInfo.faceCount = 1;
+            swapchainInfo.arraySize = arraySize;
+            swapchainInfo.mipCount = 1;
+            XrSwapchain swapchain = XR_NULL_HANDLE;
+            CHECK_XRCMD(xrCreateSwapchain(session, &swapchainInfo, &swapchain));
+            backend->enumerateSwapchainImages(swapchain);
+            swapchains.push_back(swapchain);
+            return swapchain;
+        };
+
+        constexpr uint32_t eyeWidth = 1920, eyeHeight = 2160;
+        XrSwapchain colorSwapchains[2]{}, depthSwapchains[2]{};
+        for (uint32_t eye = 0; eye < (scenario.useTextureArray ? 1u : 2u); eye++) {
+            const uint32_t arraySize = scenario.useTextureArray ? 2 : 1;
+            colorSwapchains[eye] = createSwapchain(eyeWidth, eyeHeight, arraySize, false);
+            if (scenario.useDepth) {
+                depthSwapchains[eye] = createSwapchain(eyeWidth, eyeHeight, arraySize, true);
+            }
+        }
+        if (scenario.useTextureArray) {
+            colorSwapchains[1] = colorSwapchains[0];
+            depthSwapchains[1] = depthSwapchains[0];
+        }
+        std::vector<XrSwapchain> quadSwapchains;
+        for (uint32_t i = 0; i < scenario.quadLayers; i++) {
+            quadSwapchains.push_back(createSwapchain(512, 512, 1, false));
+        }
+
+        XrSessionBeginInfo beginInfo{XR_TYPE_SESSION_BEGIN_INFO};
+        beginInfo.primaryViewConfigurationType = XR_VIEW_CONFIGURATION_TYPE_PRIMARY_STEREO;
+        waitForSessionState(instance, XR_SESSION_STATE_READY);
+        CHECK_XRCMD(xrBeginSession(session, &beginInfo));
+
+        CallStats waitFrameStats("xrWaitFrame");
+        CallStats beginFrameStats("xrBeginFrame");
+        CallStats endFrameStats("xrEndFrame");
+        CallStats swapchainStats("xr*SwapchainImage");
+        CallStats syncActionsStats("xrSyncActions");
+        CallStats getActionStateStats("xrGetActionState*");
+        CallStats locateSpaceStats("xrLocateSpace");
+        CallStats locateViewsStats("xrLocateViews");
+
+        const XrActiveActionSet activeActionSet{actionSet, XR_NULL_PATH};
+        XrActionsSyncInfo syncInfo{XR_TYPE_ACTIONS_SYNC_INFO};
+        syncInfo.countActiveActionSets = 1;
+        syncInfo.activeActionSets = &activeActionSet;
+
+        for (uint32_t frame = 0; frame < frames; frame++) {
+            XrFrameState frameState{XR_TYPE_FRAME_STATE};
+            CHECK_XRCMD(waitFrameStats.measure([&] { return xrWaitFrame(session, nullptr, &frameState); }));
+            CHECK_XRCMD(beginFrameStats.measure([&] { return xrBeginFrame(session, nullptr); }));
+
+            CHECK_XRCMD(syncActionsStats.measure([&] { return xrSyncActions(session, &syncInfo); }));
+            for (const auto& [action, type] : actions) {
+                XrActionStateGetInfo getInfo{XR_TYPE_ACTION_STATE_GET_INFO};
+                getInfo.action = action;
+                CHECK_XRCMD(getActionStateStats.measure([&] {
+                    switch (type) {
+                    case XR_ACTION_TYPE_BOOLEAN_INPUT: {
+                        XrActionStateBoolean state{XR_TYPE_ACTION_STATE_BOOLEAN};
+                        return xrGetActionStateBoolean(session, &getInfo, &state);
+                    }
+                    case XR_ACTION_TYPE_FLOAT_INPUT: {
+                        XrActionStateFloat state{XR_TYPE_ACTION_STATE_FLOAT};
+                        return xrGetActionStateFloat(session, &getInfo, &state);
+                    }
+                    default: {
+                        XrActionStateVector2f state{XR_TYPE_ACTION_STATE_VECTOR2F};
+                        return xrGetActionStateVector2f(session, &getInfo, &state);
+                    }
+                    }
+                }));
+            }
+
+            for (XrSpace space : {viewSpace, handSpaces[0], handSpaces[1]}) {
+                XrSpaceLocation location{XR_TYPE_SPACE_LOCATION};
+                CHECK_XRCMD(locateSpaceStats.measure([&] {
+                    return xrLocateSpace(space, localSpace, frameState.predictedDisplayTime, &location);
+                }));
+            }
+
+            XrViewLocateInfo viewLocateInfo{XR_TYPE_VIEW_LOCATE_INFO};
+            viewLocateInfo.viewConfigurationType = XR_VIEW_CONFIGURATION_TYPE_PRIMARY_STEREO;
+            viewLocateInfo.displayTime = frameState.predictedDisplayTime;
+            viewLocateInfo.space = localSpace;
+            XrViewState viewState{XR_TYPE_VIEW_STATE};
+            XrView views[2]{{XR_TYPE_VIEW}, {XR_TYPE_VIEW}};
+            uint32_t viewCount = 0;
+            CHECK_XRCMD(locateViewsStats.measure(
+                [&] { return xrLocateViews(session, &viewLocateInfo, &viewState, 2, &viewCount, views); }));
+
+            std::vector<const XrCompositionLayerBaseHeader*> layers;
+            XrCompositionLayerProjectionView projectionViews[2]{{XR_TYPE_COMPOSITION_LAYER_PROJECTION_VIEW},
+                                                                {XR_TYPE_COMPOSITION_LAYER_PROJECTION_VIEW}};
+            XrCompositionLayerDepthInfoKHR depthInfo[2]{{XR_TYPE_COMPOSITION_LAYER_DEPTH_INFO_KHR},
+                                                        {XR_TYPE_COMPOSITION_LAYER_DEPTH_INFO_KHR}};
+            XrCompositionLayerProjection projectionLayer{XR_TYPE_COMPOSITION_LAYER_PROJECTION};
+            std::vector<XrCompositionLayerQuad> quadLayers(scenario.quadLayers, {XR_TYPE_COMPOSITION_LAYER_QUAD});
+            if (frameState.shouldRender) {
+                for (XrSwapchain swapchain : swapchains) {
+                    CHECK_XRCMD(swapchainStats.measure([&] {
+                        uint32_t index;
+                        XrResult result = xrAcquireSwapchainImage(swapchain, nullptr, &index);
+                        if (XR_SUCCEEDED(result)) {
+                            XrSwapchainImageWaitInfo waitInfo{XR_TYPE_SWAPCHAIN_IMAGE_WAIT_INFO};
+                            waitInfo.timeout = XR_INFINITE_DURATION;
+                            result = xrWaitSwapchainImage(swapchain, &waitInfo);
+                        }
+                        if (XR_SUCCEEDED(result)) {
+                            result = xrReleaseSwapchainImage(swapchain, nullptr);
+                        }
+                        return result;
+                    }));
+                }
+
+                for (uint32_t eye = 0; eye < 2; eye++) {
+                    const uint32_t arrayIndex = scenario.useTextureArray ? eye : 0;
+                    projectionViews[eye].pose = views[eye].pose;
+                    projectionViews[eye].fov = views[eye].fov;
+                    projectionViews[eye].subImage.swapchain = colorSwapchains[eye];
+                    projectionViews[eye].subImage.imageRect.extent = {(int32_t)eyeWidth, (int32_t)eyeHeight};
+                    projectionViews[eye].subImage.imageArrayIndex = arrayIndex;
+                    if (scenario.useDepth) {
+                        depthInfo[eye].subImage = projectionViews[eye].subImage;
+                        depthInfo[eye].subImage.swapchain = depthSwapchains[eye];
+                        depthInfo[eye].minDepth = 0.f;
+                        depthInfo[eye].maxDepth = 1.f;
+                        depthInfo[eye].nearZ = 0.1f;
+                        depthInfo[eye].farZ = 100.f;
+                        projectionViews[eye].next = &depthInfo[eye];
+                    }
+                }
+                projectionLayer.space = localSpace;
+                projectionLayer.viewCount = 2;
+                projectionLayer.views = projectionViews;
+                layers.push_back(reinterpret_cast<const XrCompositionLayerBaseHeader*>(&projectionLayer));
+
+                for (uint32_t i = 0; i < scenario.quadLayers; i++) {
+                    auto& quad = quadLayers[i];
+                    quad.layerFlags = XR_COMPOSITION_LAYER_BLEND_TEXTURE_SOURCE_ALPHA_BIT;
+                    quad.space = localSpace;
+                    quad.eyeVisibility = XR_EYE_VISIBILITY_BOTH;
+                    quad.subImage.swapchain = quadSwapchains[i];
+                    quad.subImage.imageRect.extent = {512, 512};
+                    quad.pose.orientation.w = 1.f;
+                    quad.pose.position = {-0.5f + 0.25f * i, 1.5f, -1.f};
+                    quad.size = {0.2f, 0.2f};
+                    layers.push_back(reinterpret_cast<const XrCompositionLayerBaseHeader*>(&quad));
+                }
+            }
+
+            XrFrameEndInfo endInfo{XR_TYPE_FRAME_END_INFO};
+            endInfo.displayTime = frameState.predictedDisplayTime;
+            endInfo.environmentBlendMode = XR_ENVIRONMENT_BLEND_MODE_OPAQUE;
+            endInfo.layerCount = (uint32_t)layers.size();
+            endInfo.layers = layers.data();
+            CHECK_XRCMD(endFrameStats.measure([&] { return xrEndFrame(session, &endInfo); }));
+        }
+
+        LARGE_INTEGER qpcFrequency;
+        QueryPerformanceFrequency(&qpcFrequency);
+        CallStats::printHeader();
+        for (CallStats* stats : {&waitFrameStats,
+                                 &beginFrameStats,
+                                 &endFrameStats,
+                                 &swapchainStats,
+                                 &syncActionsStats,
+                                 &getActionStateStats,
+                                 &locateSpaceStats,
+                                 &locateViewsStats}) {
+            stats->print(qpcFrequency);
+        }
+
+        CHECK_XRCMD(xrRequestExitSession(session));
+        waitForSessionState(instance, XR_SESSION_STATE_STOPPING);
+        CHECK_XRCMD(xrEndSession(session));
+
+        for (XrSwapchain swapchain : swapchains) {
+            xrDestroySwapchain(swapchain);
+        }
+        for (XrSpace space : {localSpace, viewSpace, handSpaces[0], handSpaces[1]}) {
+            xrDestroySpace(space);
+        }
+        xrDestroyActionSet(actionSet);
+        xrDestroySession(session);
+
+        // The backend must outlive the session, since the runtime holds references to the application's device.
+        xrDestroyInstance(instance);
+        backend.reset();
+    }
+
+    std::wstring getModuleDirectory() {
+        wchar_t path[_MAX_PATH]{};
+        GetModuleFileNameW(nullptr, path, (DWORD)std::size(path));
+        std::wstring directory(path);
+        return directory.substr(0, directory.find_last_of(L"\\/") + 1);
+    }
+
+    // Load the mock PVR client first, so that the runtime's lookup of the client library by name resolves to the
+    // already loaded module. Then negotiate with the runtime like the OpenXR loader would.
+    void loadRuntime() {
+        const auto directory = getModuleDirectory();
+        if (!LoadLibraryW((directory + L"mock\\libPVRClient64.dll").c_str())) {
+            throw std::runtime_error("Failed to load the mock PVR client library");
+        }
+        const HMODULE runtime = LoadLibraryW((directory + L"pimax-openxr.dll").c_str());
+        if (!runtime) {
+            throw std::runtime_error("Failed to load the runtime");
+        }
+
+        const auto xrNegotiateLoaderRuntimeInterface = reinterpret_cast<PFN_xrNegotiateLoaderRuntimeInterface>(
+            GetProcAddress(runtime, "xrNegotiateLoaderRuntimeInterface"));
+        if (!xrNegotiateLoaderRuntimeInterface) {
+            throw std::runtime_error("The runtime does not export xrNegotiateLoaderRuntimeInterface()");
+        }
+
+        XrNegotiateLoaderInfo loaderInfo{XR_LOADER_INTERFACE_STRUCT_LOADER_INFO,
+                                         XR_LOADER_INFO_STRUCT_VERSION,
+                                         sizeof(XrNegotiateLoaderInfo)};
+        loaderInfo.minInterfaceVersion = 1;
+        loaderInfo.maxInterfaceVersion = XR_CURRENT_LOADER_RUNTIME_VERSION;
+        loaderInfo.minApiVersion = XR_MAKE_VERSION(1, 0, 0);
+        loaderInfo.maxApiVersion = XR_CURRENT_API_VERSION;
+        XrNegotiateRuntimeRequest runtimeRequest{XR_LOADER_INTERFACE_STRUCT_RUNTIME_REQUEST,
+                                                 XR_RUNTIME_INFO_STRUCT_VERSION,
+                                                 sizeof(XrNegotiateRuntimeRequest)};
+        CHECK_XRCMD(xrNegotiateLoaderRuntimeInterface(&loaderInfo, &runtimeRequest));
+        xrGetInstanceProcAddr = runtimeRequest.getInstanceProcAddr;
+        loadFunctions(XR_NULL_HANDLE);
+    }
+
+    Options parseOptions(int argc, char** argv) {
+        Options options;
+        for (int i = 1; i < argc; i++) {
+            const std::string_view arg(argv[i]);
+            const bool hasValue = i + 1 < argc;
+            if (arg == "-api" && hasValue) {
+                options.apis = {argv[++i]};
+            } else if (arg == "-frames" && hasValue) {
+                options.frames = std::max(1, std::atoi(argv[++i]));
+            } else if (arg == "-quads" && hasValue) {
+                options.quadLayers = std::max(0, std::atoi(argv[++i]));
+                options.allScenarios = false;
+            } else if (arg == "-actions" && hasValue) {
+                options.actions = std::max(0, std::atoi(argv[++i]));
+                options.allScenarios = false;
+            } else if (arg == "-depth") {
+                options.useDepth = true;
+                options.allScenarios = false;
+            } else if (arg == "-array") {
+                options.useTextureArray = true;
+                options.allScenarios = false;
+            } else {
+                throw std::runtime_error(
+                    fmt::format("usage: {} [-api <d3d11|d3d12|vulkan|opengl>] [-frames <count>] [-quads <count>] "
+                                "[-actions <count>] [-depth] [-array]",
+                                argv[0]));
+            }
+        }
+        return options;
+    }
+
+} // namespace
+
+int main(int argc, char** argv) {
+    try {
+        const auto options = parseOptions(argc, argv);
+
+        std::vector<Scenario> scenarios;
+        if (options.allScenarios) {
+            scenarios.push_back({"Projection only, no actions", 0, 0, false, false});
+            scenarios.push_back({"Projection + depth, 8 actions", 0, 8, true, false});
+            scenarios.push_back({"Projection array + depth, 4 quads, 32 actions", 4, 32, true, true});
+        } else {
+            scenarios.push_back({fmt::format("Projection{}{}, {} quads, {} actions",
+                                             options.useTextureArray ? " array" : "",
+                                             options.useDepth ? " + depth" : "",
+                                             options.quadLayers,
+                                             options.actions),
+                                 options.quadLayers,
+                                 options.actions,
+                                 options.useDepth,
+                                 options.useTextureArray});
+        }
+
+        loadRuntime();
+        for (const auto& api : options.apis) {
+            for (const auto& scenario : scenarios) {
+                runScenario(api, scenario, options.frames);
+            }
+        }
+    } catch (std::exception& exc) {
+        fmt::print(stderr, "{}\n", exc.what());
+        return 1;
+    }
+
+    return 0;
+}
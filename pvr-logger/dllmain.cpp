@@ -22,6 +22,8 @@
 
 #include "pch.h"
 
+#include "pvr_capture.h"
+
 // {cbf3adcd-42b1-4c38-830b-91980af201f6}
 TRACELOGGING_DEFINE_PROVIDER(g_traceProvider,
                              "PimaxOpenXR",
@@ -179,6 +181,212 @@ namespace util {
 
 namespace {
     using namespace util;
+    using namespace pvr_capture;
+
+    // Binary capture of the calls into a memory-mapped ring file. This is enabled by setting PVR_LOGGER_CAPTURE to the
+    // path of the file. The size of the ring can be set with PVR_LOGGER_CAPTURE_SIZE_MB (default: 64). See
+    // pvr_capture.h for the format.
+    class CaptureWriter {
+      public:
+        void open(double pvrTime) {
+            wchar_t path[_MAX_PATH]{};
+            if (m_isOpen || !GetEnvironmentVariableW(L"PVR_LOGGER_CAPTURE", path, (DWORD)std::size(path))) {
+                return;
+            }
+
+            wchar_t sizeMb[16]{};
+            uint64_t capacity = 64;
+            if (GetEnvironmentVariableW(L"PVR_LOGGER_CAPTURE_SIZE_MB", sizeMb, (DWORD)std::size(sizeMb))) {
+                capacity = std::clamp(_wcstoui64(sizeMb, nullptr, 10), 1ull, 4096ull);
+            }
+            capacity *= 1024 * 1024;
+
+            constexpr uint64_t dataOffset = 256;
+            static_assert(sizeof(FileHeader) <= dataOffset);
+            const uint64_t totalSize = dataOffset + capacity;
+
+            m_file.reset(CreateFileW(path,
+                                     GENERIC_READ | GENERIC_WRITE,
+                                     FILE_SHARE_READ,
+                                     nullptr,
+                                     CREATE_ALWAYS,
+                                     FILE_ATTRIBUTE_NORMAL,
+                                     nullptr));
+            if (!m_file) {
+                return;
+            }
+            m_mapping.reset(CreateFileMappingW(
+                m_file.get(), nullptr, PAGE_READWRITE, (DWORD)(totalSize >> 32), (DWORD)totalSize, nullptr));
+            if (!m_mapping) {
+                m_file.reset();
+                return;
+            }
+            m_header = reinterpret_cast<FileHeader*>(MapViewOfFile(m_mapping.get(), FILE_MAP_WRITE, 0, 0, totalSize));
+            if (!m_header) {
+                m_mapping.reset();
+                m_file.reset();
+                return;
+            }
+            m_data = reinterpret_cast<uint8_t*>(m_header) + dataOffset;
+
+            LARGE_INTEGER qpcFrequency, qpcNow;
+            QueryPerformanceFrequency(&qpcFrequency);
+            QueryPerformanceCounter(&qpcNow);
+
+            *m_header = {};
+            m_header->magic = k_magic;
+            m_header->version = k_version;
+            m_header->qpcFrequency = qpcFrequency.QuadPart;
+            m_header->qpcAtOpen = qpcNow.QuadPart;
+            m_header->pvrTimeAtOpen = pvrTime;
+            m_header->capacity = capacity;
+            m_header->dataOffset = dataOffset;
+
+            m_isOpen = true;
+        }
+
+        void flush() {
+            std::unique_lock lock(m_lock);
+
+            if (m_header) {
+                FlushViewOfFile(m_header, 0);
+            }
+        }
+
+        void close() {
+            std::unique_lock lock(m_lock);
+
+            m_isOpen = false;
+            if (m_header) {
+                FlushViewOfFile(m_header, 0);
+                UnmapViewOfFile(m_header);
+                m_header = nullptr;
+                m_data = nullptr;
+            }
+            m_mapping.reset();
+            m_file.reset();
+        }
+
+        bool isOpen() const {
+            return m_isOpen;
+        }
+
+        void write(CallId call,
+                   int32_t result,
+                   LONGLONG qpcStart,
+                   const void* payload,
+                   size_t payloadSize,
+                   const void* extra = nullptr,
+                   size_t extraSize = 0) {
+            LARGE_INTEGER qpcEnd;
+            QueryPerformanceCounter(&qpcEnd);
+
+            const uint64_t size = (sizeof(RecordHeader) + payloadSize + extraSize + 7) & ~7ull;
+
+            std::unique_lock lock(m_lock);
+
+            if (!m_header || size > m_header->capacity) {
+                return;
+            }
+            auto& header = *m_header;
+
+            // Records never straddle the end of the ring.
+            if (header.capacity - header.head < size) {
+                const uint64_t padding = header.capacity - header.head;
+                while (header.capacity - header.used < padding) {
+                    evict();
+                }
+                if (padding >= sizeof(RecordHeader)) {
+                    RecordHeader paddingRecord{};
+                    paddingRecord.size = (uint32_t)padding;
+                    paddingRecord.call = CallId::Padding;
+                    memcpy(m_data + header.head, &paddingRecord, sizeof(paddingRecord));
+                }
+                header.used += padding;
+                header.head = 0;
+            }
+            while (header.capacity - header.used < size) {
+                evict();
+            }
+
+            RecordHeader record{};
+            record.size = (uint32_t)size;
+            record.call = call;
+            record.result = result;
+            record.threadId = GetCurrentThreadId();
+            record.sequence = header.recordCount;
+            record.qpcStart = qpcStart;
+            record.qpcEnd = qpcEnd.QuadPart;
+
+            uint8_t* const destination = m_data + header.head;
+            memcpy(destination, &record, sizeof(record));
+            memcpy(destination + sizeof(record), payload, payloadSize);
+            if (extraSize) {
+                memcpy(destination + sizeof(record) + payloadSize, extra, extraSize);
+            }
+            memset(destination + sizeof(record) + payloadSize + extraSize,
+                   0,
+                   size - (sizeof(record) + payloadSize + extraSize));
+
+            // Publish the record only once it is fully written.
+            header.head = (header.head + size) % header.capacity;
+            header.used += size;
+            header.recordCount++;
+        }
+
+      private:
+        // Drop the oldest record (or padding) from the ring.
+        void evict() {
+            auto& header = *m_header;
+
+            uint64_t size = header.capacity - header.tail;
+            if (size >= sizeof(RecordHeader)) {
+                const auto& record = *reinterpret_cast<const RecordHeader*>(m_data + header.tail);
+                size = record.size;
+                if (record.call != CallId::Padding) {
+                    header.evictedCount++;
+                }
+            }
+            header.tail = (header.tail + size) % header.capacity;
+            header.used -= size;
+        }
+
+        std::mutex m_lock;
+        std::atomic<bool> m_isOpen{false};
+        wil::unique_hfile m_file;
+        wil::unique_handle m_mapping;
+        FileHeader* m_header{nullptr};
+        uint8_t* m_data{nullptr};
+    };
+
+    CaptureWriter g_capture;
+
+    LONGLONG captureTimestamp() {
+        LARGE_INTEGER now;
+        QueryPerformanceCounter(&now);
+        return now.QuadPart;
+    }
+
+    template <typename T>
+    void capture(CallId call, int32_t result, LONGLONG qpcStart, const T& payload) {
+        if (g_capture.isOpen()) {
+            g_capture.write(call, result, qpcStart, &payload, sizeof(payload));
+        }
+    }
+
+    void capture(CallId call, int32_t result, LONGLONG qpcStart) {
+        if (g_capture.isOpen()) {
+            g_capture.write(call, result, qpcStart, nullptr, 0);
+        }
+    }
+
+    ConfigCall makeConfigCall(const char* key, int intValue, float floatValue) {
+        ConfigCall call{};
+        strncpy_s(call.key, key, _TRUNCATE);
+        call.intValue = intValue;
+        call.floatValue = floatValue;
+        return call;
+    }
 
     std::mutex g_globalLock;
     wil::unique_hmodule g_realPvrLibrary;
@@ -192,7 +400,12 @@ namespace {
         TraceLocalActivity(local);
 
         TraceLoggingWriteStart(local, "PVR_initialize");
+        const auto start = captureTimestamp();
         const auto& result = g_realPvrInterface.initialise();
+        if (result == pvr_success) {
+            g_capture.open(g_realPvrInterface.getTimeSeconds());
+        }
+        capture(CallId::Initialise, result, start);
         TraceLoggingWriteStop(local, "PVR_initialize", TLArg(ToString(result).c_str(), "result"));
 
         return result;
@@ -202,7 +415,10 @@ namespace {
         TraceLocalActivity(local);
 
         TraceLoggingWriteStart(local, "PVR_shutdown");
+        const auto start = captureTimestamp();
         g_realPvrInterface.shutdown();
+        capture(CallId::Shutdown, pvr_success, start);
+        g_capture.flush();
         TraceLoggingWriteStop(local, "PVR_shutdown");
     }
 
@@ -220,7 +436,9 @@ namespace {
         TraceLocalActivity(local);
 
         TraceLoggingWriteStart(local, "PVR_getTimeSeconds");
+        const auto start = captureTimestamp();
         const auto& result = g_realPvrInterface.getTimeSeconds();
+        capture(CallId::GetTimeSeconds, pvr_success, start, TimeCall{result});
         TraceLoggingWriteStop(local, "PVR_getTimeSeconds", TLArg(result));
 
         return result;
@@ -230,7 +448,9 @@ namespace {
         TraceLocalActivity(local);
 
         TraceLoggingWriteStart(local, "PVR_getTrackingState", TLArg(absTime));
+        const auto start = captureTimestamp();
         const auto& result = g_realPvrInterface.getTrackingState(hmdh, absTime, state);
+        capture(CallId::GetTrackingState, result, start, TrackingStateCall{absTime, *state});
         TraceLoggingWriteStop(local,
                               "PVR_getTrackingState",
                               TLArg(ToString(result).c_str(), "result"),
@@ -249,7 +469,12 @@ namespace {
 
         TraceLoggingWriteStart(
             local, "PVR_getTrackedDevicePoseState", TLArg(ToString(device).c_str(), "device"), TLArg(absTime));
+        const auto start = captureTimestamp();
         const auto& result = g_realPvrInterface.getTrackedDevicePoseState(hmdh, device, absTime, state);
+        capture(CallId::GetTrackedDevicePoseState,
+                result,
+                start,
+                TrackedDevicePoseStateCall{(int32_t)device, absTime, *state});
         TraceLoggingWriteStop(local,
                               "PVR_getTrackedDevicePoseState",
                               TLArg(ToString(result).c_str(), "result"),
@@ -279,7 +504,12 @@ namespace {
                                TLArg(!!desc->StaticImage, "Desc.StaticImage"),
                                TLArg(desc->MiscFlags, "Desc.MiscFlags"),
                                TLArg(desc->BindFlags, "Desc.BindFlags"));
+        const auto start = captureTimestamp();
         const auto& result = g_realPvrInterfaceD3D.createTextureSwapChainDX(hmdh, d3dPtr, desc, out_TextureSwapChain);
+        capture(CallId::CreateTextureSwapChain,
+                result,
+                start,
+                SwapChainCall{result == pvr_success ? (uint64_t)*out_TextureSwapChain : 0, 0, *desc});
         TraceLoggingWriteStop(local,
                               "PVR_createTextureSwapChainDX",
                               TLArg(ToString(result).c_str(), "result"),
@@ -292,7 +522,9 @@ namespace {
         TraceLocalActivity(local);
 
         TraceLoggingWriteStart(local, "PVR_destroyTextureSwapChain", TLPArg(chain));
+        const auto start = captureTimestamp();
         g_realPvrInterface.destroyTextureSwapChain(hmdh, chain);
+        capture(CallId::DestroyTextureSwapChain, pvr_success, start, SwapChainCall{(uint64_t)chain});
         TraceLoggingWriteStop(local, "PVR_destroyTextureSwapChain");
     }
 
@@ -300,7 +532,9 @@ namespace {
         TraceLocalActivity(local);
 
         TraceLoggingWriteStart(local, "PVR_getTextureSwapChainCurrentIndex", TLPArg(chain));
+        const auto start = captureTimestamp();
         const auto& result = g_realPvrInterface.getTextureSwapChainCurrentIndex(hmdh, chain, out_Index);
+        capture(CallId::GetTextureSwapChainCurrentIndex, result, start, SwapChainCall{(uint64_t)chain, *out_Index});
         TraceLoggingWriteStop(local,
                               "PVR_getTextureSwapChainCurrentIndex",
                               TLArg(ToString(result).c_str(), "result"),
@@ -313,7 +547,9 @@ namespace {
         TraceLocalActivity(local);
 
         TraceLoggingWriteStart(local, "PVR_commitTextureSwapChain", TLPArg(chain));
+        const auto start = captureTimestamp();
         const auto& result = g_realPvrInterface.commitTextureSwapChain(hmdh, chain);
+        capture(CallId::CommitTextureSwapChain, result, start, SwapChainCall{(uint64_t)chain});
         TraceLoggingWriteStop(local, "PVR_commitTextureSwapChain", TLArg(ToString(result).c_str(), "result"));
 
         return result;
@@ -323,7 +559,9 @@ namespace {
         TraceLocalActivity(local);
 
         TraceLoggingWriteStart(local, "PVR_getPredictedDisplayTime", TLArg(frameIndex));
+        const auto start = captureTimestamp();
         const auto& result = g_realPvrInterface.getPredictedDisplayTime(hmdh, frameIndex);
+        capture(CallId::GetPredictedDisplayTime, pvr_success, start, PredictedDisplayTimeCall{frameIndex, result});
         TraceLoggingWriteStop(local, "PVR_getPredictedDisplayTime", TLArg(result));
 
         return result;
@@ -333,7 +571,9 @@ namespace {
         TraceLocalActivity(local);
 
         TraceLoggingWriteStart(local, "PVR_beginFrame", TLArg(frameIndex));
+        const auto start = captureTimestamp();
         const auto& result = g_realPvrInterface.beginFrame(hmdh, frameIndex);
+        capture(CallId::BeginFrame, result, start, FrameCall{frameIndex});
         TraceLoggingWriteStop(local, "PVR_beginFrame", TLArg(ToString(result).c_str(), "result"));
 
         TraceLoggingWriteTagged(
@@ -363,7 +603,7 @@ namespace {
 
         TraceLoggingWriteStart(
             local, "PVR_endFrame", TLArg(frameIndex), TLArg(layerCount), TLArg(frameTimes.size(), "Fps"));
-        for (uint32_t i = 0; i < layerCount; i++) {
+        for (uint32_t i = 0; i < layerCount && TraceLoggingProviderEnabled(g_traceProvider, 0, 0); i++) {
             const auto* const eyeFov = (pvrLayerEyeFov*)layerPtrList[i];
             const auto* const quad = (pvrLayerQuad*)layerPtrList[i];
             const auto* const eyeFovDepth = (pvrLayerEyeFovDepth*)layerPtrList[i];
@@ -420,17 +660,91 @@ namespace {
                 break;
             }
         }
+        const auto start = captureTimestamp();
         const auto& result = g_realPvrInterface.endFrame(hmdh, frameIndex, layerPtrList, layerCount);
+        if (g_capture.isOpen()) {
+            EndFrameCall call{frameIndex, std::min(layerCount, k_maxLayers), layerCount};
+            Layer layers[k_maxLayers]{};
+            for (uint32_t i = 0; i < call.layerCount; i++) {
+                switch (layerPtrList[i]->Type) {
+                case pvrLayerType_EyeFov:
+                    layers[i].eyeFov = *(const pvrLayerEyeFov*)layerPtrList[i];
+                    break;
+                case pvrLayerType_EyeFovDepth:
+                    layers[i].eyeFovDepth = *(const pvrLayerEyeFovDepth*)layerPtrList[i];
+                    break;
+                case pvrLayerType_Quad:
+                    layers[i].quad = *(const pvrLayerQuad*)layerPtrList[i];
+                    break;
+                default:
+                    layers[i].header = *layerPtrList[i];
+                    break;
+                }
+            }
+            g_capture.write(
+                CallId::EndFrame, result, start, &call, sizeof(call), layers, call.layerCount * sizeof(Layer));
+        }
         TraceLoggingWriteStop(local, "PVR_endFrame", TLArg(ToString(result).c_str(), "result"));
 
         return result;
     }
 
+    pvrResult wrapper_waitToBeginFrame(pvrHmdHandle hmdh, long long frameIndex) {
+        TraceLocalActivity(local);
+
+        TraceLoggingWriteStart(local, "PVR_waitToBeginFrame", TLArg(frameIndex));
+        const auto start = captureTimestamp();
+        const auto& result = g_realPvrInterface.waitToBeginFrame(hmdh, frameIndex);
+        capture(CallId::WaitToBeginFrame, result, start, FrameCall{frameIndex});
+        TraceLoggingWriteStop(local, "PVR_waitToBeginFrame", TLArg(ToString(result).c_str(), "result"));
+
+        return result;
+    }
+
+    pvrResult wrapper_getInputState(pvrHmdHandle hmdh, pvrInputState* inputState) {
+        TraceLocalActivity(local);
+
+        TraceLoggingWriteStart(local, "PVR_getInputState");
+        const auto start = captureTimestamp();
+        const auto& result = g_realPvrInterface.getInputState(hmdh, inputState);
+        capture(CallId::GetInputState, result, start, InputStateCall{*inputState});
+        TraceLoggingWriteStop(local,
+                              "PVR_getInputState",
+                              TLArg(ToString(result).c_str(), "result"),
+                              TLArg(inputState->HandButtons[0], "LeftButtons"),
+                              TLArg(inputState->HandButtons[1], "RightButtons"),
+                              TLArg(inputState->TimeInSeconds, "Time"));
+
+        return result;
+    }
+
+    pvrResult wrapper_getHmdStatus(pvrHmdHandle hmdh, pvrHmdStatus* outStatus) {
+        TraceLocalActivity(local);
+
+        TraceLoggingWriteStart(local, "PVR_getHmdStatus");
+        const auto start = captureTimestamp();
+        const auto& result = g_realPvrInterface.getHmdStatus(hmdh, outStatus);
+        capture(CallId::GetHmdStatus, result, start, HmdStatusCall{*outStatus});
+        TraceLoggingWriteStop(local,
+                              "PVR_getHmdStatus",
+                              TLArg(ToString(result).c_str(), "result"),
+                              TLArg(!!outStatus->ServiceReady, "ServiceReady"),
+                              TLArg(!!outStatus->HmdPresent, "HmdPresent"),
+                              TLArg(!!outStatus->HmdMounted, "HmdMounted"),
+                              TLArg(!!outStatus->IsVisible, "IsVisible"),
+                              TLArg(!!outStatus->DisplayLost, "DisplayLost"),
+                              TLArg(!!outStatus->ShouldQuit, "ShouldQuit"));
+
+        return result;
+    }
+
     float wrapper_getFloatConfig(pvrHmdHandle hmdh, const char* key, float def_val) {
         TraceLocalActivity(local);
 
         TraceLoggingWriteStart(local, "PVR_getFloatConfig", TLArg(key), TLArg(def_val));
+        const auto start = captureTimestamp();
         const auto& result = g_realPvrInterface.getFloatConfig(hmdh, key, def_val);
+        capture(CallId::GetFloatConfig, pvr_success, start, makeConfigCall(key, 0, result));
         TraceLoggingWriteStop(local, "PVR_getFloatConfig", TLArg(result));
 
         return result;
@@ -440,7 +754,9 @@ namespace {
         TraceLocalActivity(local);
 
         TraceLoggingWriteStart(local, "PVR_setFloatConfig", TLArg(key), TLArg(val));
+        const auto start = captureTimestamp();
         const auto& result = g_realPvrInterface.setFloatConfig(hmdh, key, val);
+        capture(CallId::SetFloatConfig, result, start, makeConfigCall(key, 0, val));
         TraceLoggingWriteStop(local, "PVR_setFloatConfig", TLArg(ToString(result).c_str(), "result"));
 
         return result;
@@ -450,7 +766,9 @@ namespace {
         TraceLocalActivity(local);
 
         TraceLoggingWriteStart(local, "PVR_getIntConfig", TLArg(key), TLArg(def_val));
+        const auto start = captureTimestamp();
         const auto& result = g_realPvrInterface.getIntConfig(hmdh, key, def_val);
+        capture(CallId::GetIntConfig, result, start, makeConfigCall(key, result, 0.f));
         TraceLoggingWriteStop(local, "PVR_getIntConfig", TLArg(result));
 
         return result;
@@ -460,7 +778,9 @@ namespace {
         TraceLocalActivity(local);
 
         TraceLoggingWriteStart(local, "PVR_setIntConfig", TLArg(key), TLArg(val));
+        const auto start = captureTimestamp();
         const auto& result = g_realPvrInterface.setIntConfig(hmdh, key, val);
+        capture(CallId::SetIntConfig, result, start, makeConfigCall(key, val, 0.f));
         TraceLoggingWriteStop(local, "PVR_setIntConfig", TLArg(ToString(result).c_str(), "result"));
 
         return result;
@@ -718,8 +1038,11 @@ namespace {
                     result->getTextureSwapChainCurrentIndex = wrapper_getTextureSwapChainCurrentIndex;
                     result->commitTextureSwapChain = wrapper_commitTextureSwapChain;
                     result->getPredictedDisplayTime = wrapper_getPredictedDisplayTime;
+                    result->waitToBeginFrame = wrapper_waitToBeginFrame;
                     result->beginFrame = wrapper_beginFrame;
                     result->endFrame = wrapper_endFrame;
+                    result->getInputState = wrapper_getInputState;
+                    result->getHmdStatus = wrapper_getHmdStatus;
                     result->getFloatConfig = wrapper_getFloatConfig;
                     result->setFloatConfig = wrapper_setFloatConfig;
                     result->getIntConfig = wrapper_getIntConfig;
@@ -771,9 +1094,6 @@ namespace {
     pvrResult wrapper_getEyeRenderInfo(pvrHmdHandle hmdh, pvrEyeType eye, pvrEyeRenderInfo* outInfo) {
     }
 
-    pvrResult wrapper_getHmdStatus(pvrHmdHandle hmdh, pvrHmdStatus* outStatus) {
-    }
-
     pvrResult wrapper_setTrackingOriginType(pvrHmdHandle hmdh, pvrTrackingOrigin origin) {
     }
 
@@ -786,9 +1106,6 @@ namespace {
     pvrResult wrapper_getTrackedDeviceCaps(pvrHmdHandle hmdh, pvrTrackedDeviceType device, uint32_t* pcap) {
     }
 
-    pvrResult wrapper_getInputState(pvrHmdHandle hmdh, pvrInputState* inputState) {
-    }
-
     pvrResult wrapper_getFovTextureSize(
         pvrHmdHandle hmdh, pvrEyeType eye, pvrFovPort fov, float pixelsPerDisplayPixel, pvrSizei* size) {
     }
@@ -892,9 +1209,12 @@ BOOL APIENTRY DllMain(HMODULE hModule, DWORD ul_reason_for_call, LPVOID lpReserv
         TraceLoggingRegister(g_traceProvider);
         break;
 
+    case DLL_PROCESS_DETACH:
+        g_capture.close();
+        break;
+
     case DLL_THREAD_ATTACH:
     case DLL_THREAD_DETACH:
-    case DLL_PROCESS_DETACH:
         break;
     }
 
@@ -23,6 +23,8 @@
 #pragma once
 
 // Standard library.
+#include <algorithm>
+#include <atomic>
 #include <deque>
 #include <mutex>
 #include <string>
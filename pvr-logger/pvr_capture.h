@@ -0,0 +1,155 @@
+// MIT License
+//
+// Copyright(c) 2022 Matthieu Bucchianeri
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this softwareand associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright noticeand this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+// Binary capture format of the PVR calls, shared between pvr-logger (writer) and pvr-mock (replayer).
+//
+// The file is a FileHeader followed by a ring of records. Each record is a RecordHeader followed by the call-specific
+// payload below, padded to 8 bytes. The writer evicts the oldest records to make room, so the file always holds the
+// last records of the session, even after a crash. The live records span 'used' bytes starting at 'tail', in order.
+// A record that would straddle the end of the ring is instead written at the start, after a Padding record (or after
+// nothing, if there is no room for a header).
+//
+// Timestamps are QPC values. The PVR time (getTimeSeconds()) and QPC value taken when the capture was opened are
+// stored in the header, so that PVR timestamps in the payloads can be rebased by the replayer.
+
+namespace pvr_capture {
+
+    constexpr uint32_t k_magic = 0x43525650; // 'PVRC'
+    constexpr uint32_t k_version = 1;
+    constexpr uint32_t k_maxLayers = 16;
+    constexpr uint32_t k_maxKeyLength = 48;
+
+    enum class CallId : uint16_t {
+        Padding = 0,
+        Initialise,
+        Shutdown,
+        GetTimeSeconds,
+        GetTrackingState,
+        GetTrackedDevicePoseState,
+        GetInputState,
+        GetHmdStatus,
+        WaitToBeginFrame,
+        BeginFrame,
+        EndFrame,
+        GetPredictedDisplayTime,
+        CreateTextureSwapChain,
+        DestroyTextureSwapChain,
+        GetTextureSwapChainCurrentIndex,
+        CommitTextureSwapChain,
+        GetIntConfig,
+        SetIntConfig,
+        GetFloatConfig,
+        SetFloatConfig,
+
+        Count
+    };
+
+    struct FileHeader {
+        uint32_t magic;
+        uint32_t version;
+        int64_t qpcFrequency;
+        int64_t qpcAtOpen;
+        double pvrTimeAtOpen;
+        uint64_t capacity;
+        uint64_t dataOffset;
+
+        // Ring state, only updated once a record is fully written.
+        uint64_t head;
+        uint64_t tail;
+        uint64_t used;
+        uint64_t recordCount;
+        uint64_t evictedCount;
+    };
+
+    struct RecordHeader {
+        uint32_t size; // Including this header and the padding.
+        CallId call;
+        uint16_t reserved;
+        int32_t result; // pvrResult, or the value returned by the call for integer functions.
+        uint32_t threadId;
+        uint64_t sequence;
+        int64_t qpcStart;
+        int64_t qpcEnd;
+    };
+    static_assert(sizeof(RecordHeader) % 8 == 0);
+
+    struct TimeCall {
+        double result;
+    };
+
+    struct TrackingStateCall {
+        double absTime;
+        pvrTrackingState state;
+    };
+
+    struct TrackedDevicePoseStateCall {
+        int32_t device;
+        double absTime;
+        pvrPoseStatef state;
+    };
+
+    struct InputStateCall {
+        pvrInputState state;
+    };
+
+    struct HmdStatusCall {
+        pvrHmdStatus status;
+    };
+
+    struct FrameCall {
+        int64_t frameIndex;
+    };
+
+    struct PredictedDisplayTimeCall {
+        int64_t frameIndex;
+        double result;
+    };
+
+    union Layer {
+        pvrLayerHeader header;
+        pvrLayerEyeFov eyeFov;
+        pvrLayerEyeFovDepth eyeFovDepth;
+        pvrLayerQuad quad;
+    };
+
+    // Followed by layerCount (at most k_maxLayers) Layer entries.
+    struct EndFrameCall {
+        int64_t frameIndex;
+        uint32_t layerCount;
+        uint32_t submittedLayerCount;
+    };
+
+    struct SwapChainCall {
+        uint64_t swapchain;
+        int32_t index;
+        pvrTextureSwapChainDesc desc;
+    };
+
+    struct ConfigCall {
+        char key[k_maxKeyLength];
+        int32_t intValue;
+        float floatValue;
+    };
+
+} // namespace pvr_capture
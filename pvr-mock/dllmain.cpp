@@ -0,0 +1,944 @@
+// MIT License
+//
+// Copyright(c) 2022 Matthieu Bucchianeri
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this softwareand associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright noticeand this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "pch.h"
+
+// A stand-in for the Pimax client library, used to exercise the runtime without a headset or pi_server. Every call
+// returns deterministic data derived from the query time, so that two runs of the same scripted frame loop follow the
+// same code paths in the runtime.
+//
+// The behavior can be tuned through the following environment variables:
+// - PVR_MOCK_REFRESH_RATE: the refresh rate (Hz) that waitToBeginFrame() paces to, or 0 to not pace (default: 90).
+// - PVR_MOCK_WAIT_LATENCY_US: extra time spent in waitToBeginFrame(), after the frame slot is reached (default: 0).
+// - PVR_MOCK_CALL_LATENCY_US: time spent in each pose/input query, to mimic the RPC to pi_server (default: 0).
+// - PVR_MOCK_SUBMIT_LATENCY_US: time spent in endFrame(), to mimic the compositor handoff (default: 0).
+// - PVR_MOCK_REPLAY: path to a capture from pvr-logger (see pvr_capture.h) to replay instead of the synthetic data.
+//
+// When replaying, waitToBeginFrame() returns at the same time as in the capture (relative to the beginning of the
+// capture), while the other calls last as long as they did in the capture. Poses, inputs, HMD status and results are
+// returned in the order they were captured. Calls past the end of the capture fall back to the synthetic data.
+
+using Microsoft::WRL::ComPtr;
+
+namespace {
+
+    constexpr float k_pi = 3.14159265358979323846f;
+
+    // Frame slots remembered for getPredictedDisplayTime().
+    constexpr size_t k_frameSlotsCount = 16;
+
+    struct MockConfig {
+        double refreshRate{90.0};
+        double waitLatency{0.0};
+        double callLatency{0.0};
+        double submitLatency{0.0};
+    };
+
+    struct MockSwapchain {
+        pvrTextureSwapChainDesc desc{};
+        std::vector<ComPtr<ID3D11Texture2D>> images;
+        int currentIndex{0};
+    };
+
+    struct MockMirrorTexture {
+        ComPtr<ID3D11Texture2D> texture;
+    };
+
+    // Playback of the calls captured by pvr-logger.
+    class CaptureReplayer {
+      public:
+        struct Call {
+            pvr_capture::RecordHeader header;
+            std::vector<uint8_t> payload;
+
+            template <typename T>
+            const T* as() const {
+                return payload.size() >= sizeof(T) ? reinterpret_cast<const T*>(payload.data()) : nullptr;
+            }
+        };
+
+        bool load(const char* path, double origin) {
+            using namespace pvr_capture;
+
+            std::unique_lock lock(m_lock);
+
+            wil::unique_hfile file(CreateFileA(
+                path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr));
+            LARGE_INTEGER fileSize{};
+            if (!file || !GetFileSizeEx(file.get(), &fileSize) || (uint64_t)fileSize.QuadPart < sizeof(FileHeader)) {
+                return false;
+            }
+            std::vector<uint8_t> content((size_t)fileSize.QuadPart);
+            DWORD bytesRead = 0;
+            if (!ReadFile(file.get(), content.data(), (DWORD)content.size(), &bytesRead, nullptr) ||
+                bytesRead != content.size()) {
+                return false;
+            }
+
+            const auto& header = *reinterpret_cast<const FileHeader*>(content.data());
+            if (header.magic != k_magic || header.version != k_version || !header.qpcFrequency ||
+                header.dataOffset < sizeof(FileHeader) || header.dataOffset + header.capacity > content.size() ||
+                header.used > header.capacity || header.tail >= header.capacity) {
+                return false;
+            }
+            m_header = header;
+            m_origin = origin;
+
+            for (auto& calls : m_calls) {
+                calls.clear();
+            }
+            m_poses.clear();
+
+            // Walk the ring from the oldest record.
+            const uint8_t* const data = content.data() + header.dataOffset;
+            uint64_t offset = header.tail;
+            uint64_t remaining = header.used;
+            while (remaining) {
+                uint64_t size = header.capacity - offset;
+                if (size >= sizeof(RecordHeader)) {
+                    const auto& record = *reinterpret_cast<const RecordHeader*>(data + offset);
+                    if (record.size < sizeof(RecordHeader) || record.size > size || record.size > remaining) {
+                        break;
+                    }
+                    size = record.size;
+
+                    if (record.call != CallId::Padding && record.call < CallId::Count) {
+                        Call call{record};
+                        call.payload.assign(data + offset + sizeof(RecordHeader), data + offset + record.size);
+                        if (record.call == CallId::GetTrackedDevicePoseState) {
+                            if (const auto* pose = call.as<TrackedDevicePoseStateCall>()) {
+                                m_poses[pose->device].push_back(std::move(call));
+                            }
+                        } else {
+                            m_calls[(size_t)record.call].push_back(std::move(call));
+                        }
+                    }
+                }
+                offset = (offset + size) % header.capacity;
+                remaining -= size;
+            }
+
+            m_isActive = true;
+            return true;
+        }
+
+        bool isActive() const {
+            return m_isActive;
+        }
+
+        std::optional<Call> next(pvr_capture::CallId call) {
+            std::unique_lock lock(m_lock);
+
+            return pop(m_calls[(size_t)call]);
+        }
+
+        std::optional<Call> nextPose(pvrTrackedDeviceType device) {
+            std::unique_lock lock(m_lock);
+
+            const auto it = m_poses.find(device);
+            if (it == m_poses.end()) {
+                return {};
+            }
+            return pop(it->second);
+        }
+
+        // Convert a captured QPC value or PVR time to our clock.
+        double fromQpc(int64_t qpc) const {
+            return m_origin + (double)(qpc - m_header.qpcAtOpen) / m_header.qpcFrequency;
+        }
+
+        double fromPvrTime(double pvrTime) const {
+            return pvrTime ? m_origin + (pvrTime - m_header.pvrTimeAtOpen) : 0.0;
+        }
+
+        double getDuration(const Call& call) const {
+            return (double)(call.header.qpcEnd - call.header.qpcStart) / m_header.qpcFrequency;
+        }
+
+      private:
+        std::optional<Call> pop(std::deque<Call>& calls) {
+            if (calls.empty()) {
+                return {};
+            }
+            auto call = std::move(calls.front());
+            calls.pop_front();
+            return call;
+        }
+
+        std::mutex m_lock;
+        bool m_isActive{false};
+        pvr_capture::FileHeader m_header{};
+        double m_origin{0.0};
+        std::deque<Call> m_calls[(size_t)pvr_capture::CallId::Count];
+        std::unordered_map<int32_t, std::deque<Call>> m_poses;
+    };
+
+    std::mutex g_globalLock;
+
+    MockConfig g_config;
+    LARGE_INTEGER g_qpcFrequency{};
+    LARGE_INTEGER g_qpcStart{};
+
+    // The HMD handle is never dereferenced by the runtime, we only need a unique non-null value.
+    int g_hmd;
+
+    std::unordered_map<std::string, int> g_intConfigs;
+    std::unordered_map<std::string, float> g_floatConfigs;
+    std::unordered_map<std::string, std::string> g_stringConfigs;
+
+    double g_lastFrameSlot = 0.0;
+    double g_predictedDisplayTime[k_frameSlotsCount]{};
+    wil::unique_handle g_waitTimer;
+
+    CaptureReplayer g_replay;
+
+    pvrInterface g_pvrInterface{};
+    pvrD3DInterface g_pvrInterfaceD3D{};
+    bool g_pvrInterfaceValid = false;
+
+    double getEnvironmentDouble(const char* name, double defaultValue) {
+        char value[64]{};
+        size_t length = 0;
+        if (getenv_s(&length, value, sizeof(value), name) || !length) {
+            return defaultValue;
+        }
+        return std::strtod(value, nullptr);
+    }
+
+    double now() {
+        LARGE_INTEGER qpc;
+        QueryPerformanceCounter(&qpc);
+        return (double)(qpc.QuadPart - g_qpcStart.QuadPart) / g_qpcFrequency.QuadPart;
+    }
+
+    // Wait until an absolute time, using a high resolution timer for the bulk of the wait and spinning for the rest
+    // so that the pacing does not depend on the scheduler quantum.
+    void waitUntil(double time) {
+        const double duration = time - now();
+        if (duration <= 0.0) {
+            return;
+        }
+
+        if (duration > 0.002) {
+            if (!g_waitTimer) {
+                g_waitTimer.reset(CreateWaitableTimerEx(
+                    nullptr, nullptr, CREATE_WAITABLE_TIMER_HIGH_RESOLUTION, TIMER_MODIFY_STATE | SYNCHRONIZE));
+            }
+            if (g_waitTimer) {
+                LARGE_INTEGER dueTime;
+                dueTime.QuadPart = -(LONGLONG)((duration - 0.001) * 1e7);
+                SetWaitableTimer(g_waitTimer.get(), &dueTime, 0, nullptr, nullptr, FALSE);
+                WaitForSingleObject(g_waitTimer.get(), INFINITE);
+            }
+        }
+        while (now() < time) {
+            YieldProcessor();
+        }
+    }
+
+    void simulateLatency(double latency) {
+        if (latency > 0.0) {
+            waitUntil(now() + latency);
+        }
+    }
+
+    double framePeriod() {
+        return g_config.refreshRate > 0.0 ? 1.0 / g_config.refreshRate : 1.0 / 90.0;
+    }
+
+    pvrQuatf quaternionFromYawPitch(float yaw, float pitch) {
+        const float cy = std::cos(yaw / 2), sy = std::sin(yaw / 2);
+        const float cp = std::cos(pitch / 2), sp = std::sin(pitch / 2);
+        return {cy * sp, sy * cp, -sy * sp, cy * cp};
+    }
+
+    pvrQuatf multiply(const pvrQuatf& a, const pvrQuatf& b) {
+        return {a.w * b.x + a.x * b.w + a.y * b.z - a.z * b.y,
+                a.w * b.y - a.x * b.z + a.y * b.w + a.z * b.x,
+                a.w * b.z + a.x * b.y - a.y * b.x + a.z * b.w,
+                a.w * b.w - a.x * b.x - a.y * b.y - a.z * b.z};
+    }
+
+    pvrVector3f rotate(const pvrQuatf& q, const pvrVector3f& v) {
+        // v' = v + 2w(q x v) + 2q x (q x v)
+        const pvrVector3f t{2 * (q.y * v.z - q.z * v.y), 2 * (q.z * v.x - q.x * v.z), 2 * (q.x * v.y - q.y * v.x)};
+        return {v.x + q.w * t.x + (q.y * t.z - q.z * t.y),
+                v.y + q.w * t.y + (q.z * t.x - q.x * t.z),
+                v.z + q.w * t.z + (q.x * t.y - q.y * t.x)};
+    }
+
+    // Slow head and hand motion, so that the runtime's prediction and smoothing code sees non-trivial velocities.
+    pvrPoseStatef getDevicePose(pvrTrackedDeviceType device, double absTime) {
+        const float t = (float)absTime;
+
+        pvrPoseStatef state{};
+        state.TimeInSeconds = absTime;
+        state.StatusFlags = pvrStatus_OrientationTracked | pvrStatus_PositionTracked;
+        if (device == pvrTrackedDevice_HMD) {
+            state.ThePose.Orientation = quaternionFromYawPitch(0.3f * std::sin(t), 0.1f * std::sin(0.7f * t));
+            state.ThePose.Position = {0.02f * std::sin(t), 1.6f + 0.01f * std::sin(2 * t), 0.f};
+            state.AngularVelocity = {0.07f * std::cos(0.7f * t), 0.3f * std::cos(t), 0.f};
+            state.LinearVelocity = {0.02f * std::cos(t), 0.02f * std::cos(2 * t), 0.f};
+        } else {
+            const float side = device == pvrTrackedDevice_LeftController ? -1.f : 1.f;
+            state.ThePose.Orientation = quaternionFromYawPitch(side * 0.2f * std::sin(1.3f * t), -0.5f);
+            state.ThePose.Position = {side * 0.2f + 0.05f * std::sin(1.3f * t), 1.2f, -0.3f + 0.05f * std::cos(t)};
+            state.AngularVelocity = {0.f, side * 0.26f * std::cos(1.3f * t), 0.f};
+            state.LinearVelocity = {0.065f * std::cos(1.3f * t), 0.f, -0.05f * std::sin(t)};
+        }
+        return state;
+    }
+
+    DXGI_FORMAT pvrToDxgiTypelessFormat(pvrTextureFormat format) {
+        switch (format) {
+        case PVR_FORMAT_R8G8B8A8_UNORM:
+        case PVR_FORMAT_R8G8B8A8_UNORM_SRGB:
+            return DXGI_FORMAT_R8G8B8A8_TYPELESS;
+        case PVR_FORMAT_B8G8R8A8_UNORM:
+        case PVR_FORMAT_B8G8R8A8_UNORM_SRGB:
+            return DXGI_FORMAT_B8G8R8A8_TYPELESS;
+        case PVR_FORMAT_B8G8R8X8_UNORM:
+        case PVR_FORMAT_B8G8R8X8_UNORM_SRGB:
+            return DXGI_FORMAT_B8G8R8X8_TYPELESS;
+        case PVR_FORMAT_R16G16B16A16_FLOAT:
+            return DXGI_FORMAT_R16G16B16A16_TYPELESS;
+        case PVR_FORMAT_D16_UNORM:
+            return DXGI_FORMAT_R16_TYPELESS;
+        case PVR_FORMAT_D24_UNORM_S8_UINT:
+            return DXGI_FORMAT_R24G8_TYPELESS;
+        case PVR_FORMAT_D32_FLOAT:
+            return DXGI_FORMAT_R32_TYPELESS;
+        case PVR_FORMAT_D32_FLOAT_S8X24_UINT:
+            return DXGI_FORMAT_R32G8X24_TYPELESS;
+        case PVR_FORMAT_BC1_UNORM:
+            return DXGI_FORMAT_BC1_TYPELESS;
+        default:
+            return DXGI_FORMAT_UNKNOWN;
+        }
+    }
+
+    pvrResult mock_initialise() {
+        std::unique_lock lock(g_globalLock);
+
+        QueryPerformanceFrequency(&g_qpcFrequency);
+        QueryPerformanceCounter(&g_qpcStart);
+
+        g_config.refreshRate = getEnvironmentDouble("PVR_MOCK_REFRESH_RATE", 90.0);
+        g_config.waitLatency = getEnvironmentDouble("PVR_MOCK_WAIT_LATENCY_US", 0.0) / 1e6;
+        g_config.callLatency = getEnvironmentDouble("PVR_MOCK_CALL_LATENCY_US", 0.0) / 1e6;
+        g_config.submitLatency = getEnvironmentDouble("PVR_MOCK_SUBMIT_LATENCY_US", 0.0) / 1e6;
+
+        char replayPath[_MAX_PATH]{};
+        size_t length = 0;
+        if (!getenv_s(&length, replayPath, sizeof(replayPath), "PVR_MOCK_REPLAY") && length) {
+            if (!g_replay.load(replayPath, now())) {
+                OutputDebugStringA("PVR mock: failed to load the capture for replay\n");
+                return pvr_failed;
+            }
+        }
+
+        g_lastFrameSlot = 0.0;
+        std::fill(std::begin(g_predictedDisplayTime), std::end(g_predictedDisplayTime), 0.0);
+
+        return pvr_success;
+    }
+
+    void mock_shutdown() {
+        std::unique_lock lock(g_globalLock);
+
+        g_waitTimer.reset();
+        g_intConfigs.clear();
+        g_floatConfigs.clear();
+        g_stringConfigs.clear();
+    }
+
+    const char* mock_getVersionString() {
+        return "PVR mock";
+    }
+
+    double mock_getTimeSeconds() {
+        return now();
+    }
+
+    pvrResult mock_createHmd(pvrHmdHandle* phmdh) {
+        *phmdh = reinterpret_cast<pvrHmdHandle>(&g_hmd);
+        return pvr_success;
+    }
+
+    void mock_destroyHmd(pvrHmdHandle hmdh) {
+    }
+
+    pvrResult mock_getHmdInfo(pvrHmdHandle hmdh, pvrHmdInfo* outInfo) {
+        *outInfo = {};
+        strcpy_s(outInfo->ProductName, "Pimax Mock");
+        strcpy_s(outInfo->Manufacturer, "Pimax");
+        strcpy_s(outInfo->SerialNumber, "MOCK0000");
+        outInfo->VendorId = 0x34a4;
+        outInfo->ProductId = 0x0012;
+        outInfo->FirmwareMajor = 1;
+        outInfo->FirmwareMinor = 0;
+        outInfo->Resolution = {3840, 2160};
+        return pvr_success;
+    }
+
+    pvrResult mock_getEyeDisplayInfo(pvrHmdHandle hmdh, pvrEyeType eye, pvrDisplayInfo* outInfo) {
+        *outInfo = {};
+        outInfo->edid_vid = 0x34a4;
+        outInfo->edid_pid = 0x0012;
+        outInfo->width = 3840;
+        outInfo->height = 2160;
+        outInfo->refresh_rate = (float)(1.0 / framePeriod());
+
+        // Report the first adapter, so that the application and the runtime agree on the device.
+        ComPtr<IDXGIFactory1> factory;
+        ComPtr<IDXGIAdapter1> adapter;
+        DXGI_ADAPTER_DESC1 desc{};
+        if (SUCCEEDED(CreateDXGIFactory1(IID_PPV_ARGS(factory.ReleaseAndGetAddressOf()))) &&
+            SUCCEEDED(factory->EnumAdapters1(0, adapter.ReleaseAndGetAddressOf())) &&
+            SUCCEEDED(adapter->GetDesc1(&desc))) {
+            static_assert(sizeof(outInfo->luid) == sizeof(LUID));
+            memcpy(&outInfo->luid, &desc.AdapterLuid, sizeof(LUID));
+        }
+        return pvr_success;
+    }
+
+    pvrResult mock_getEyeRenderInfo(pvrHmdHandle hmdh, pvrEyeType eye, pvrEyeRenderInfo* outInfo) {
+        // Canted displays with an asymmetric FOV, similar to the wide headsets.
+        const float side = eye == pvrEye_Left ? -1.f : 1.f;
+
+        *outInfo = {};
+        outInfo->Eye = eye;
+        outInfo->Fov.UpTan = 1.2f;
+        outInfo->Fov.DownTan = 1.2f;
+        outInfo->Fov.LeftTan = eye == pvrEye_Left ? 1.7f : 1.1f;
+        outInfo->Fov.RightTan = eye == pvrEye_Left ? 1.1f : 1.7f;
+        outInfo->DistortedViewport.Size = {1920, 2160};
+        outInfo->HmdToEyePose.Orientation = quaternionFromYawPitch(-side * 10.f * k_pi / 180.f, 0.f);
+        outInfo->HmdToEyePose.Position = {side * 0.0315f, 0.f, 0.f};
+        return pvr_success;
+    }
+
+    pvrResult mock_getHmdStatus(pvrHmdHandle hmdh, pvrHmdStatus* outStatus) {
+        if (g_replay.isActive()) {
+            if (const auto call = g_replay.next(pvr_capture::CallId::GetHmdStatus)) {
+                if (const auto* status = call->as<pvr_capture::HmdStatusCall>()) {
+                    *outStatus = status->status;
+                    return (pvrResult)call->header.result;
+                }
+            }
+        }
+
+        *outStatus = {};
+        outStatus->ServiceReady = true;
+        outStatus->HmdPresent = true;
+        outStatus->HmdMounted = true;
+        outStatus->IsVisible = true;
+        return pvr_success;
+    }
+
+    pvrResult mock_setTrackingOriginType(pvrHmdHandle hmdh, pvrTrackingOrigin origin) {
+        return pvr_success;
+    }
+
+    pvrResult mock_getTrackingOriginType(pvrHmdHandle hmdh, pvrTrackingOrigin* origin) {
+        *origin = pvrTrackingOrigin_EyeLevel;
+        return pvr_success;
+    }
+
+    pvrResult mock_recenterTrackingOrigin(pvrHmdHandle hmdh) {
+        return pvr_success;
+    }
+
+    pvrResult mock_getTrackedDeviceCaps(pvrHmdHandle hmdh, pvrTrackedDeviceType device, uint32_t* pcap) {
+        *pcap = 0;
+        return pvr_success;
+    }
+
+    pvrResult mock_getTrackingState(pvrHmdHandle hmdh, double absTime, pvrTrackingState* state) {
+        if (g_replay.isActive()) {
+            if (const auto call = g_replay.next(pvr_capture::CallId::GetTrackingState)) {
+                if (const auto* tracking = call->as<pvr_capture::TrackingStateCall>()) {
+                    simulateLatency(g_replay.getDuration(*call));
+                    *state = tracking->state;
+                    state->HeadPose.TimeInSeconds = g_replay.fromPvrTime(state->HeadPose.TimeInSeconds);
+                    for (auto& handPose : state->HandPoses) {
+                        handPose.TimeInSeconds = g_replay.fromPvrTime(handPose.TimeInSeconds);
+                    }
+                    return (pvrResult)call->header.result;
+                }
+            }
+        }
+
+        simulateLatency(g_config.callLatency);
+
+        *state = {};
+        state->HeadPose = getDevicePose(pvrTrackedDevice_HMD, absTime);
+        state->HandPoses[0] = getDevicePose(pvrTrackedDevice_LeftController, absTime);
+        state->HandPoses[1] = getDevicePose(pvrTrackedDevice_RightController, absTime);
+        return pvr_success;
+    }
+
+    pvrResult mock_getTrackedDevicePoseState(pvrHmdHandle hmdh,
+                                             pvrTrackedDeviceType device,
+                                             double absTime,
+                                             pvrPoseStatef* state) {
+        if (g_replay.isActive()) {
+            if (const auto call = g_replay.nextPose(device)) {
+                if (const auto* pose = call->as<pvr_capture::TrackedDevicePoseStateCall>()) {
+                    simulateLatency(g_replay.getDuration(*call));
+                    *state = pose->state;
+                    state->TimeInSeconds = g_replay.fromPvrTime(state->TimeInSeconds);
+                    return (pvrResult)call->header.result;
+                }
+            }
+        }
+
+        simulateLatency(g_config.callLatency);
+
+        *state = getDevicePose(device, absTime);
+        return pvr_success;
+    }
+
+    pvrResult mock_getInputState(pvrHmdHandle hmdh, pvrInputState* inputState) {
+        if (g_replay.isActive()) {
+            if (const auto call = g_replay.next(pvr_capture::CallId::GetInputState)) {
+                if (const auto* input = call->as<pvr_capture::InputStateCall>()) {
+                    simulateLatency(g_replay.getDuration(*call));
+                    *inputState = input->state;
+                    inputState->TimeInSeconds = g_replay.fromPvrTime(inputState->TimeInSeconds);
+                    return (pvrResult)call->header.result;
+                }
+            }
+        }
+
+        simulateLatency(g_config.callLatency);
+
+        // Buttons toggle every second, analog values sweep their whole range. We never press the recentering
+        // combination (system + trigger buttons).
+        const double time = now();
+        const bool toggle = ((int64_t)time) % 2;
+
+        *inputState = {};
+        inputState->TimeInSeconds = time;
+        for (int side = 0; side < 2; side++) {
+            const float t = (float)time + side * k_pi / 2;
+            inputState->HandButtons[side] = toggle ? (pvrButton_Trigger | pvrButton_Grip) : pvrButton_ApplicationMenu;
+            inputState->HandTouches[side] = toggle ? pvrButton_Trigger : 0;
+            inputState->Trigger[side] = 0.5f + 0.5f * std::sin(t);
+            inputState->Grip[side] = 0.5f + 0.5f * std::cos(t);
+            inputState->GripForce[side] = inputState->Grip[side];
+            inputState->JoyStick[side] = {std::sin(t), std::cos(t)};
+            inputState->TouchPad[side] = {std::cos(t), std::sin(t)};
+            inputState->TouchPadForce[side] = 0.f;
+            inputState->fingerIndex[side] = inputState->Trigger[side];
+            inputState->fingerMiddle[side] = inputState->Grip[side];
+            inputState->fingerRing[side] = inputState->Grip[side];
+            inputState->fingerPinky[side] = inputState->Grip[side];
+        }
+        return pvr_success;
+    }
+
+    pvrResult mock_getFovTextureSize(
+        pvrHmdHandle hmdh, pvrEyeType eye, pvrFovPort fov, float pixelsPerDisplayPixel, pvrSizei* size) {
+        // One display pixel per tangent unit at the center of the 1920 pixels-wide panel.
+        constexpr float pixelsPerTan = 1920.f / 2.8f;
+        size->w = (int)std::ceil((fov.LeftTan + fov.RightTan) * pixelsPerTan * pixelsPerDisplayPixel);
+        size->h = (int)std::ceil((fov.UpTan + fov.DownTan) * pixelsPerTan * pixelsPerDisplayPixel);
+        return pvr_success;
+    }
+
+    pvrResult mock_getTextureSwapChainLength(pvrHmdHandle hmdh, pvrTextureSwapChain chain, int* out_Length) {
+        *out_Length = (int)reinterpret_cast<MockSwapchain*>(chain)->images.size();
+        return pvr_success;
+    }
+
+    pvrResult mock_getTextureSwapChainCurrentIndex(pvrHmdHandle hmdh, pvrTextureSwapChain chain, int* out_Index) {
+        *out_Index = reinterpret_cast<MockSwapchain*>(chain)->currentIndex;
+        return pvr_success;
+    }
+
+    pvrResult mock_getTextureSwapChainDesc(pvrHmdHandle hmdh,
+                                           pvrTextureSwapChain chain,
+                                           pvrTextureSwapChainDesc* out_Desc) {
+        *out_Desc = reinterpret_cast<MockSwapchain*>(chain)->desc;
+        return pvr_success;
+    }
+
+    pvrResult mock_commitTextureSwapChain(pvrHmdHandle hmdh, pvrTextureSwapChain chain) {
+        auto& swapchain = *reinterpret_cast<MockSwapchain*>(chain);
+        if (!swapchain.desc.StaticImage) {
+            swapchain.currentIndex = (swapchain.currentIndex + 1) % (int)swapchain.images.size();
+        }
+        return pvr_success;
+    }
+
+    void mock_destroyTextureSwapChain(pvrHmdHandle hmdh, pvrTextureSwapChain chain) {
+        delete reinterpret_cast<MockSwapchain*>(chain);
+    }
+
+    void mock_destroyMirrorTexture(pvrHmdHandle hmdh, pvrMirrorTexture mirrorTexture) {
+        delete reinterpret_cast<MockMirrorTexture*>(mirrorTexture);
+    }
+
+    void mock_calcEyePoses(pvrPosef headPose, const pvrPosef hmdToEyePose[2], pvrPosef outEyePoses[2]) {
+        for (int i = 0; i < 2; i++) {
+            const auto offset = rotate(headPose.Orientation, hmdToEyePose[i].Position);
+            outEyePoses[i].Orientation = multiply(headPose.Orientation, hmdToEyePose[i].Orientation);
+            outEyePoses[i].Position = {
+                headPose.Position.x + offset.x, headPose.Position.y + offset.y, headPose.Position.z + offset.z};
+        }
+    }
+
+    pvrResult mock_waitToBeginFrame(pvrHmdHandle hmdh, long long frameIndex) {
+        const double period = framePeriod();
+
+        if (g_replay.isActive()) {
+            if (const auto call = g_replay.next(pvr_capture::CallId::WaitToBeginFrame)) {
+                const double slot = g_replay.fromQpc(call->header.qpcEnd);
+                waitUntil(slot);
+                g_lastFrameSlot = slot;
+                g_predictedDisplayTime[frameIndex % k_frameSlotsCount] = slot + 2 * period;
+                return (pvrResult)call->header.result;
+            }
+        }
+
+        // Align to the next frame slot after the previous one, like a compositor throttling on vsync.
+        double slot = now();
+        if (g_config.refreshRate > 0.0) {
+            slot = std::max(std::ceil(slot / period), std::floor(g_lastFrameSlot / period + 0.5) + 1) * period;
+            waitUntil(slot);
+        }
+        g_lastFrameSlot = slot;
+        simulateLatency(g_config.waitLatency);
+
+        g_predictedDisplayTime[frameIndex % k_frameSlotsCount] = slot + 2 * period;
+        return pvr_success;
+    }
+
+    double mock_getPredictedDisplayTime(pvrHmdHandle hmdh, long long frameIndex) {
+        if (g_replay.isActive()) {
+            if (const auto call = g_replay.next(pvr_capture::CallId::GetPredictedDisplayTime)) {
+                if (const auto* predicted = call->as<pvr_capture::PredictedDisplayTimeCall>()) {
+                    return g_replay.fromPvrTime(predicted->result);
+                }
+            }
+        }
+
+        const double predicted = g_predictedDisplayTime[frameIndex % k_frameSlotsCount];
+        return predicted > 0.0 ? predicted : now() + 2 * framePeriod();
+    }
+
+    pvrResult mock_beginFrame(pvrHmdHandle hmdh, long long frameIndex) {
+        return pvr_success;
+    }
+
+    pvrResult mock_endFrame(pvrHmdHandle hmdh,
+                            long long frameIndex,
+                            pvrLayerHeader const* const* layerPtrList,
+                            unsigned int layerCount) {
+        if (g_replay.isActive()) {
+            if (const auto call = g_replay.next(pvr_capture::CallId::EndFrame)) {
+                simulateLatency(g_replay.getDuration(*call));
+                return (pvrResult)call->header.result;
+            }
+        }
+
+        simulateLatency(g_config.submitLatency);
+        return pvr_success;
+    }
+
+    template <typename T>
+    T getConfig(const std::unordered_map<std::string, T>& store, const char* key, T def_val) {
+        std::unique_lock lock(g_globalLock);
+
+        const auto it = store.find(key);
+        return it != store.cend() ? it->second : def_val;
+    }
+
+    template <typename T>
+    pvrResult setConfig(std::unordered_map<std::string, T>& store, const char* key, T val) {
+        std::unique_lock lock(g_globalLock);
+
+        store[key] = val;
+        return pvr_success;
+    }
+
+    float mock_getFloatConfig(pvrHmdHandle hmdh, const char* key, float def_val) {
+        return getConfig(g_floatConfigs, key, def_val);
+    }
+
+    pvrResult mock_setFloatConfig(pvrHmdHandle hmdh, const char* key, float val) {
+        return setConfig(g_floatConfigs, key, val);
+    }
+
+    int mock_getIntConfig(pvrHmdHandle hmdh, const char* key, int def_val) {
+        return getConfig(g_intConfigs, key, def_val);
+    }
+
+    pvrResult mock_setIntConfig(pvrHmdHandle hmdh, const char* key, int val) {
+        return setConfig(g_intConfigs, key, val);
+    }
+
+    int mock_getStringConfig(pvrHmdHandle hmdh, const char* key, char* val, int size) {
+        const auto value = getConfig(g_stringConfigs, key, std::string());
+        if (val && size > 0) {
+            strncpy_s(val, size, value.c_str(), _TRUNCATE);
+        }
+        return (int)value.size() + 1;
+    }
+
+    pvrResult mock_setStringConfig(pvrHmdHandle hmdh, const char* key, const char* val) {
+        return setConfig(g_stringConfigs, key, std::string(val));
+    }
+
+    float mock_getTrackedDeviceFloatProperty(pvrHmdHandle hmdh,
+                                             pvrTrackedDeviceType device,
+                                             pvrTrackedDeviceProp prop,
+                                             float def_val) {
+        return def_val;
+    }
+
+    int mock_getTrackedDeviceIntProperty(pvrHmdHandle hmdh,
+                                         pvrTrackedDeviceType device,
+                                         pvrTrackedDeviceProp prop,
+                                         int def_val) {
+        return def_val;
+    }
+
+    int mock_getTrackedDeviceStringProperty(
+        pvrHmdHandle hmdh, pvrTrackedDeviceType device, pvrTrackedDeviceProp prop, char* val, int size) {
+        // Pretend Index controllers are connected, since they expose every kind of input.
+        std::string_view value;
+        if (device != pvrTrackedDevice_HMD && prop == pvrTrackedDeviceProp_ControllerType_String) {
+            value = "knuckles";
+        }
+        if (value.empty()) {
+            return 0;
+        }
+        if (val && size > 0) {
+            strncpy_s(val, size, value.data(), _TRUNCATE);
+        }
+        return (int)value.size() + 1;
+    }
+
+    pvrResult mock_triggerHapticPulse(pvrHmdHandle hmdh, pvrTrackedDeviceType device, float intensity) {
+        return pvr_success;
+    }
+
+    unsigned int mock_getEyeHiddenAreaMesh(pvrHmdHandle hmdh,
+                                           pvrEyeType eye,
+                                           pvrVector2f* outVertexBuffer,
+                                           unsigned int bufferCount) {
+        return 0;
+    }
+
+    pvrResult mock_getSkeletalData(pvrHmdHandle hmdh,
+                                   pvrTrackedDeviceType device,
+                                   pvrSkeletalMotionRange range,
+                                   pvrSkeletalData* data) {
+        return pvr_not_support;
+    }
+
+    pvrResult mock_getEyeTrackingInfo(pvrHmdHandle hmdh, double absTime, pvrEyeTrackingInfo* outInfo) {
+        return pvr_not_support;
+    }
+
+    void mock_logMessage(pvrLogLevel level, const char* message) {
+        OutputDebugStringA(message);
+    }
+
+    pvrResult mock_createTextureSwapChainDX(pvrHmdHandle hmdh,
+                                            IUnknown* d3dPtr,
+                                            const pvrTextureSwapChainDesc* desc,
+                                            pvrTextureSwapChain* out_TextureSwapChain) {
+        ComPtr<ID3D11Device> device;
+        if (!d3dPtr || FAILED(d3dPtr->QueryInterface(IID_PPV_ARGS(device.ReleaseAndGetAddressOf())))) {
+            return pvr_invalid_param;
+        }
+
+        D3D11_TEXTURE2D_DESC textureDesc{};
+        textureDesc.Width = desc->Width;
+        textureDesc.Height = desc->Height;
+        textureDesc.MipLevels = desc->MipLevels;
+        textureDesc.ArraySize = desc->ArraySize;
+        textureDesc.Format = pvrToDxgiTypelessFormat(desc->Format);
+        textureDesc.SampleDesc.Count = desc->SampleCount;
+        textureDesc.Usage = D3D11_USAGE_DEFAULT;
+        if (desc->BindFlags & pvrTextureBind_DX_RenderTarget) {
+            textureDesc.BindFlags |= D3D11_BIND_RENDER_TARGET;
+        }
+        if (desc->BindFlags & pvrTextureBind_DX_DepthStencil) {
+            textureDesc.BindFlags |= D3D11_BIND_DEPTH_STENCIL;
+        }
+        if (desc->BindFlags & pvrTextureBind_DX_UnorderedAccess) {
+            textureDesc.BindFlags |= D3D11_BIND_UNORDERED_ACCESS;
+        }
+        textureDesc.BindFlags |= D3D11_BIND_SHADER_RESOURCE;
+        if (desc->MiscFlags & pvrTextureMisc_AllowGenerateMips) {
+            textureDesc.MiscFlags |= D3D11_RESOURCE_MISC_GENERATE_MIPS;
+        }
+        if (textureDesc.Format == DXGI_FORMAT_UNKNOWN) {
+            return pvr_invalid_param;
+        }
+
+        auto swapchain = std::make_unique<MockSwapchain>();
+        swapchain->desc = *desc;
+        swapchain->images.resize(desc->StaticImage ? 1 : 3);
+        for (auto& image : swapchain->images) {
+            if (FAILED(device->CreateTexture2D(&textureDesc, nullptr, image.ReleaseAndGetAddressOf()))) {
+                return pvr_failed;
+            }
+        }
+
+        *out_TextureSwapChain = reinterpret_cast<pvrTextureSwapChain>(swapchain.release());
+        return pvr_success;
+    }
+
+    pvrResult mock_getTextureSwapChainBufferDX(
+        pvrHmdHandle hmdh, pvrTextureSwapChain chain, int index, IID iid, void** out_Buffer) {
+        const auto& swapchain = *reinterpret_cast<MockSwapchain*>(chain);
+        if (index < 0 || index >= (int)swapchain.images.size()) {
+            return pvr_invalid_param;
+        }
+        return SUCCEEDED(swapchain.images[index]->QueryInterface(iid, out_Buffer)) ? pvr_success : pvr_failed;
+    }
+
+    pvrResult mock_createMirrorTextureDX(pvrHmdHandle hmdh,
+                                         IUnknown* d3dPtr,
+                                         const pvrMirrorTextureDesc* desc,
+                                         pvrMirrorTexture* out_MirrorTexture) {
+        ComPtr<ID3D11Device> device;
+        if (!d3dPtr || FAILED(d3dPtr->QueryInterface(IID_PPV_ARGS(device.ReleaseAndGetAddressOf())))) {
+            return pvr_invalid_param;
+        }
+
+        D3D11_TEXTURE2D_DESC textureDesc{};
+        textureDesc.Width = desc->Width;
+        textureDesc.Height = desc->Height;
+        textureDesc.MipLevels = 1;
+        textureDesc.ArraySize = 1;
+        textureDesc.Format = pvrToDxgiTypelessFormat(desc->Format);
+        textureDesc.SampleDesc.Count = 1;
+        textureDesc.Usage = D3D11_USAGE_DEFAULT;
+        textureDesc.BindFlags = D3D11_BIND_SHADER_RESOURCE | D3D11_BIND_RENDER_TARGET;
+
+        auto mirror = std::make_unique<MockMirrorTexture>();
+        if (FAILED(device->CreateTexture2D(&textureDesc, nullptr, mirror->texture.ReleaseAndGetAddressOf()))) {
+            return pvr_failed;
+        }
+
+        *out_MirrorTexture = reinterpret_cast<pvrMirrorTexture>(mirror.release());
+        return pvr_success;
+    }
+
+    pvrResult
+    mock_getMirrorTextureBufferDX(pvrHmdHandle hmdh, pvrMirrorTexture mirrorTexture, IID iid, void** out_Buffer) {
+        const auto& mirror = *reinterpret_cast<MockMirrorTexture*>(mirrorTexture);
+        return SUCCEEDED(mirror.texture->QueryInterface(iid, out_Buffer)) ? pvr_success : pvr_failed;
+    }
+
+    void* mock_getDxGlInterface(const char* api) {
+        if (std::string_view(api) == "dx") {
+            return &g_pvrInterfaceD3D;
+        }
+        return nullptr;
+    }
+
+    pvrInterface* mock_getPvrInterface(uint32_t major_ver, uint32_t minor_ver) {
+        std::unique_lock lock(g_globalLock);
+
+        if (!g_pvrInterfaceValid) {
+            // Entries the runtime never calls are left null on purpose, so that a new dependency shows up as a crash
+            // in the benchmark rather than as silently wrong data.
+            g_pvrInterface.initialise = mock_initialise;
+            g_pvrInterface.shutdown = mock_shutdown;
+            g_pvrInterface.getVersionString = mock_getVersionString;
+            g_pvrInterface.getTimeSeconds = mock_getTimeSeconds;
+            g_pvrInterface.createHmd = mock_createHmd;
+            g_pvrInterface.destroyHmd = mock_destroyHmd;
+            g_pvrInterface.getHmdInfo = mock_getHmdInfo;
+            g_pvrInterface.getEyeDisplayInfo = mock_getEyeDisplayInfo;
+            g_pvrInterface.getEyeRenderInfo = mock_getEyeRenderInfo;
+            g_pvrInterface.getHmdStatus = mock_getHmdStatus;
+            g_pvrInterface.setTrackingOriginType = mock_setTrackingOriginType;
+            g_pvrInterface.getTrackingOriginType = mock_getTrackingOriginType;
+            g_pvrInterface.recenterTrackingOrigin = mock_recenterTrackingOrigin;
+            g_pvrInterface.getTrackedDeviceCaps = mock_getTrackedDeviceCaps;
+            g_pvrInterface.getTrackingState = mock_getTrackingState;
+            g_pvrInterface.getTrackedDevicePoseState = mock_getTrackedDevicePoseState;
+            g_pvrInterface.getInputState = mock_getInputState;
+            g_pvrInterface.getFovTextureSize = mock_getFovTextureSize;
+            g_pvrInterface.getTextureSwapChainLength = mock_getTextureSwapChainLength;
+            g_pvrInterface.getTextureSwapChainCurrentIndex = mock_getTextureSwapChainCurrentIndex;
+            g_pvrInterface.getTextureSwapChainDesc = mock_getTextureSwapChainDesc;
+            g_pvrInterface.commitTextureSwapChain = mock_commitTextureSwapChain;
+            g_pvrInterface.destroyTextureSwapChain = mock_destroyTextureSwapChain;
+            g_pvrInterface.destroyMirrorTexture = mock_destroyMirrorTexture;
+            g_pvrInterface.calcEyePoses = mock_calcEyePoses;
+            g_pvrInterface.waitToBeginFrame = mock_waitToBeginFrame;
+            g_pvrInterface.getPredictedDisplayTime = mock_getPredictedDisplayTime;
+            g_pvrInterface.beginFrame = mock_beginFrame;
+            g_pvrInterface.endFrame = mock_endFrame;
+            g_pvrInterface.getFloatConfig = mock_getFloatConfig;
+            g_pvrInterface.setFloatConfig = mock_setFloatConfig;
+            g_pvrInterface.getIntConfig = mock_getIntConfig;
+            g_pvrInterface.setIntConfig = mock_setIntConfig;
+            g_pvrInterface.getStringConfig = mock_getStringConfig;
+            g_pvrInterface.setStringConfig = mock_setStringConfig;
+            g_pvrInterface.getTrackedDeviceFloatProperty = mock_getTrackedDeviceFloatProperty;
+            g_pvrInterface.getTrackedDeviceIntProperty = mock_getTrackedDeviceIntProperty;
+            g_pvrInterface.getTrackedDeviceStringProperty = mock_getTrackedDeviceStringProperty;
+            g_pvrInterface.triggerHapticPulse = mock_triggerHapticPulse;
+            g_pvrInterface.getEyeHiddenAreaMesh = mock_getEyeHiddenAreaMesh;
+            g_pvrInterface.getSkeletalData = mock_getSkeletalData;
+            g_pvrInterface.getEyeTrackingInfo = mock_getEyeTrackingInfo;
+            g_pvrInterface.logMessage = mock_logMessage;
+            g_pvrInterface.getDxGlInterface = mock_getDxGlInterface;
+
+            g_pvrInterfaceD3D.createTextureSwapChainDX = mock_createTextureSwapChainDX;
+            g_pvrInterfaceD3D.getTextureSwapChainBufferDX = mock_getTextureSwapChainBufferDX;
+            g_pvrInterfaceD3D.createMirrorTextureDX = mock_createMirrorTextureDX;
+            g_pvrInterfaceD3D.getMirrorTextureBufferDX = mock_getMirrorTextureBufferDX;
+
+            g_pvrInterfaceValid = true;
+        }
+
+        return &g_pvrInterface;
+    }
+
+} // namespace
+
+extern "C" __declspec(dllexport) pvrInterface* getPvrInterface(uint32_t major_ver, uint32_t minor_ver) {
+    return mock_getPvrInterface(major_ver, minor_ver);
+}
+
+BOOL APIENTRY DllMain(HMODULE hModule, DWORD ul_reason_for_call, LPVOID lpReserved) {
+    switch (ul_reason_for_call) {
+    case DLL_PROCESS_ATTACH:
+    case DLL_THREAD_ATTACH:
+    case DLL_THREAD_DETACH:
+    case DLL_PROCESS_DETACH:
+        break;
+    }
+
+    return TRUE;
+}
@@ -0,0 +1,135 @@
+# Compress an image with alpha to a BC1 DDS texture (1-bit alpha, no mipmaps), for embedding in the runtime.
+param(
+	[Parameter(Mandatory = $true)][string]$Source,
+	[Parameter(Mandatory = $true)][string]$Destination
+)
+
+$ErrorActionPreference = "Stop"
+
+Add-Type -AssemblyName System.Drawing
+Add-Type -TypeDefinition @"
+using System;
+using System.IO;
+
+public static class Bc1Encoder {
+    static int Quantize(byte b, byte g, byte r) {
+        return ((r * 31 + 127) / 255 << 11) | ((g * 63 + 127) / 255 << 5) | ((b * 31 + 127) / 255);
+    }
+
+    static int[] Expand(int c) {
+        return new int[] { ((c >> 11 & 31) * 255 + 15) / 31, ((c >> 5 & 63) * 255 + 31) / 63, ((c & 31) * 255 + 15) / 31 };
+    }
+
+    // Encode 32bpp BGRA pixels, prefixed with a DDS header.
+    public static byte[] Encode(byte[] bgra, int width, int height) {
+        if (width % 4 != 0 || height % 4 != 0) {
+            throw new ArgumentException("The image dimensions must be multiples of 4");
+        }
+
+        var stream = new MemoryStream();
+        var writer = new BinaryWriter(stream);
+        writer.Write(0x20534444); // "DDS "
+        writer.Write(124);
+        writer.Write(0x81007); // CAPS | HEIGHT | WIDTH | PIXELFORMAT | LINEARSIZE
+        writer.Write(height);
+        writer.Write(width);
+        writer.Write(width * height / 2);
+        writer.Write(0);
+        writer.Write(1);
+        for (int i = 0; i < 11; i++) {
+            writer.Write(0);
+        }
+        writer.Write(32);
+        writer.Write(0x4); // FOURCC
+        writer.Write(0x31545844); // "DXT1"
+        for (int i = 0; i < 5; i++) {
+            writer.Write(0);
+        }
+        writer.Write(0x1000); // TEXTURE
+        for (int i = 0; i < 4; i++) {
+            writer.Write(0);
+        }
+
+        var colors = new int[16];
+        var opaque = new bool[16];
+        for (int by = 0; by < height; by += 4) {
+            for (int bx = 0; bx < width; bx += 4) {
+                int lo = int.MaxValue, hi = -1, opaqueCount = 0;
+                for (int i = 0; i < 16; i++) {
+                    int p = ((by + i / 4) * width + bx + i % 4) * 4;
+                    opaque[i] = bgra[p + 3] >= 128;
+                    if (opaque[i]) {
+                        colors[i] = Quantize(bgra[p], bgra[p + 1], bgra[p + 2]);
+                        lo = Math.Min(lo, colors[i]);
+                        hi = Math.Max(hi, colors[i]);
+                        opaqueCount++;
+                    }
+                }
+                if (opaqueCount == 0) {
+                    writer.Write((ushort)0);
+                    writer.Write((ushort)0);
+                    writer.Write(0xffffffff);
+                    continue;
+                }
+
+                // The 3-color mode (c0 <= c1) reserves index 3 for transparent pixels.
+                bool threeColors = opaqueCount < 16 || lo == hi;
+                int c0 = threeColors ? lo : hi, c1 = threeColors ? hi : lo;
+                int[] e0 = Expand(c0), e1 = Expand(c1);
+                var palette = new int[threeColors ? 3 : 4][];
+                palette[0] = e0;
+                palette[1] = e1;
+                palette[2] = new int[3];
+                if (!threeColors) {
+                    palette[3] = new int[3];
+                }
+                for (int c = 0; c < 3; c++) {
+                    if (threeColors) {
+                        palette[2][c] = (e0[c] + e1[c]) / 2;
+                    } else {
+                        palette[2][c] = (2 * e0[c] + e1[c]) / 3;
+                        palette[3][c] = (e0[c] + 2 * e1[c]) / 3;
+                    }
+                }
+
+                uint indices = 0;
+                for (int i = 0; i < 16; i++) {
+                    int best = 3;
+                    if (opaque[i]) {
+                        int p = ((by + i / 4) * width + bx + i % 4) * 4;
+                        int bestDistance = int.MaxValue;
+                        for (int j = 0; j < palette.Length; j++) {
+                            int dr = bgra[p + 2] - palette[j][0], dg = bgra[p + 1] - palette[j][1],
+                                db = bgra[p] - palette[j][2];
+                            int distance = dr * dr + dg * dg + db * db;
+                            if (distance < bestDistance) {
+                                bestDistance = distance;
+                                best = j;
+                            }
+                        }
+                    }
+                    indices |= (uint)best << (2 * i);
+                }
+                writer.Write((ushort)c0);
+                writer.Write((ushort)c1);
+                writer.Write(indices);
+            }
+        }
+        writer.Flush();
+        return stream.ToArray();
+    }
+}
+"@
+
+$bitmap = New-Object System.Drawing.Bitmap $Source
+try {
+	$rect = New-Object System.Drawing.Rectangle 0, 0, $bitmap.Width, $bitmap.Height
+	$data = $bitmap.LockBits($rect, [System.Drawing.Imaging.ImageLockMode]::ReadOnly,
+		[System.Drawing.Imaging.PixelFormat]::Format32bppArgb)
+	$pixels = New-Object byte[] ($bitmap.Width * $bitmap.Height * 4)
+	[System.Runtime.InteropServices.Marshal]::Copy($data.Scan0, $pixels, 0, $pixels.Length)
+	$bitmap.UnlockBits($data)
+	[System.IO.File]::WriteAllBytes($Destination, [Bc1Encoder]::Encode($pixels, $bitmap.Width, $bitmap.Height))
+} finally {
+	$bitmap.Dispose()
+}